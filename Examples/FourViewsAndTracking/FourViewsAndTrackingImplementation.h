@@ -50,6 +50,7 @@
 #include "igstkAuroraTracker.h"
 #include "igstkView2D.h"
 #include "igstkView3D.h"
+#include "igstkFrameScheduler.h"
 // EndCodeSnippet
 
 #include "igstkSerialCommunication.h"
@@ -136,19 +137,25 @@ public:
     // Set up the four quadrant views
     this->m_Display3D->RequestResetCamera();
     this->Display3DWidget->RequestEnableInteractions();
-    this->m_Display3D->SetRefreshRate( 60 ); // 60 Hz
 
     this->m_DisplayAxial->RequestResetCamera();
     this->DisplayAxialWidget->RequestEnableInteractions();
-    this->m_DisplayAxial->SetRefreshRate( 60 ); // 60 Hz
 
     this->m_DisplayCoronal->RequestResetCamera();
     this->DisplayCoronalWidget->RequestEnableInteractions();
-    this->m_DisplayCoronal->SetRefreshRate( 60 ); // 60 Hz
 
     this->m_DisplaySagittal->RequestResetCamera();
     this->DisplaySagittalWidget->RequestEnableInteractions();
-    this->m_DisplaySagittal->SetRefreshRate( 60 ); // 60 Hz
+
+    // The four views are refreshed together, and the transforms of the
+    // frames are prepared in a separate thread from snapshots of the scene
+    this->m_FrameScheduler = FrameScheduler::New();
+    this->m_FrameScheduler->RequestAddView( this->m_Display3D );
+    this->m_FrameScheduler->RequestAddView( this->m_DisplayAxial );
+    this->m_FrameScheduler->RequestAddView( this->m_DisplayCoronal );
+    this->m_FrameScheduler->RequestAddView( this->m_DisplaySagittal );
+    this->m_FrameScheduler->SetRefreshRate( 60 ); // 60 Hz
+    this->m_FrameScheduler->SetThreadedFramePreparation( true );
       
     m_Tracking = false;
     }
@@ -212,10 +219,12 @@ public:
     this->m_DisplayAxial->RequestStart();
     this->m_DisplayCoronal->RequestStart();
     this->m_DisplaySagittal->RequestStart();
+    this->m_FrameScheduler->RequestStart();
     }
 
   void StopViews()
     {
+    this->m_FrameScheduler->RequestStop();
     this->m_Display3D->RequestStop();
     this->m_DisplayAxial->RequestStop();
     this->m_DisplayCoronal->RequestStop();
@@ -253,6 +262,8 @@ private:
   ViewType2D::Pointer m_DisplayCoronal;
   ViewType2D::Pointer m_DisplaySagittal;
   ViewType3D::Pointer m_Display3D;
+
+  FrameScheduler::Pointer m_FrameScheduler;
 };
 
 } // end namespace igstk
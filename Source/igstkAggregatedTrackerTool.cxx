@@ -0,0 +1,100 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkAggregatedTrackerTool.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkAggregatedTrackerTool.h"
+
+namespace igstk
+{
+
+/** Constructor */
+AggregatedTrackerTool::AggregatedTrackerTool():m_StateMachine(this)
+{
+  m_TrackerToolConfigured = false;
+}
+
+/** Destructor */
+AggregatedTrackerTool::~AggregatedTrackerTool()
+{
+}
+
+/** Request set tool name */
+void AggregatedTrackerTool::RequestSetToolName( const ToolNameType & toolName )
+{
+  this->m_ToolName = toolName;
+  m_TrackerToolConfigured = m_SourceTrackerTool.IsNotNull();
+
+  this->SetTrackerToolIdentifier( m_ToolName );
+}
+
+/** Request set the source tracker and tracker tool */
+void AggregatedTrackerTool::RequestSetSourceTrackerTool(
+                                        const Tracker * tracker,
+                                        const TrackerTool * trackerTool )
+{
+  if( !tracker || !trackerTool )
+    {
+    igstkLogMacro( CRITICAL, "igstk::AggregatedTrackerTool::"
+                   "RequestSetSourceTrackerTool: NULL source tracker "
+                   "or tracker tool\n" );
+    return;
+    }
+
+  this->m_SourceTracker = tracker;
+  this->m_SourceTrackerTool = trackerTool;
+  m_TrackerToolConfigured = !m_ToolName.empty();
+}
+
+const Tracker * AggregatedTrackerTool::GetSourceTracker() const
+{
+  return this->m_SourceTracker;
+}
+
+const TrackerTool * AggregatedTrackerTool::GetSourceTrackerTool() const
+{
+  return this->m_SourceTrackerTool;
+}
+
+/** The "CheckIfTrackerToolIsConfigured" method returns true if
+ *  the tracker tool is configured */
+bool
+AggregatedTrackerTool::CheckIfTrackerToolIsConfigured( ) const
+{
+  igstkLogMacro( DEBUG, "igstk::AggregatedTrackerTool::"
+                 "CheckIfTrackerToolIsConfigured called...\n");
+  return m_TrackerToolConfigured;
+}
+
+/** Print Self function */
+void AggregatedTrackerTool::PrintSelf( std::ostream& os,
+                                       itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Tool name: " << m_ToolName << std::endl;
+  os << indent << "Source tracker: "
+     << m_SourceTracker.GetPointer() << std::endl;
+  os << indent << "Source tracker tool: "
+     << m_SourceTrackerTool.GetPointer() << std::endl;
+}
+
+} //igstk namespace
@@ -0,0 +1,98 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkAggregatedTrackerTool.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkAggregatedTrackerTool_h
+#define __igstkAggregatedTrackerTool_h
+
+#include "igstkTrackerTool.h"
+#include "igstkTracker.h"
+
+namespace igstk
+{
+
+class TrackerAggregator;
+
+/** \class AggregatedTrackerTool
+  * \brief A TrackerAggregator-specific TrackerTool class.
+  *
+  * An AggregatedTrackerTool republishes, through a TrackerAggregator, the
+  * transforms of a tool attached to one of the trackers of the aggregator.
+  * The source tool must be attached to the source tracker, and the source
+  * tracker must be added to the aggregator, before this tool is attached
+  * to the aggregator.
+  *
+  * \sa TrackerAggregator
+  *
+  * \ingroup Tracker
+  *
+  */
+
+class AggregatedTrackerTool : public TrackerTool
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( AggregatedTrackerTool, TrackerTool )
+
+  typedef std::string       ToolNameType;
+
+  /** Get the name of the tool */
+  igstkGetStringMacro( ToolName );
+
+  /** Set the name of the tool. It is used as the unique identifier of the
+   *  tool in the aggregator, since the source tools of different trackers
+   *  may have the same identifier. */
+  void RequestSetToolName( const ToolNameType & toolName );
+
+  /** Set the tracker and the tool whose transforms are republished */
+  void RequestSetSourceTrackerTool( const Tracker * tracker,
+                                    const TrackerTool * trackerTool );
+
+  /** Get the source tracker and the source tool */
+  const Tracker * GetSourceTracker() const;
+  const TrackerTool * GetSourceTrackerTool() const;
+
+protected:
+
+  AggregatedTrackerTool();
+  ~AggregatedTrackerTool();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, ::itk::Indent indent ) const;
+
+private:
+
+  /** Get boolean variable to check if the tracker tool is
+   * configured or not */
+  virtual bool CheckIfTrackerToolIsConfigured() const;
+
+  AggregatedTrackerTool(const Self&);   //purposely not implemented
+  void operator=(const Self&);          //purposely not implemented
+
+  ToolNameType              m_ToolName;
+
+  Tracker::ConstPointer     m_SourceTracker;
+  TrackerTool::ConstPointer m_SourceTrackerTool;
+
+  bool m_TrackerToolConfigured;
+
+};
+
+} // namespace igstk
+
+
+#endif  // __igstk_AggregatedTrackerTool_h_
@@ -27,11 +27,13 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <algorithm>
 
 #include <vnl/vnl_quaternion.h>
 #include "itkRealTimeClock.h"
 
 #include "igstkArucoTracker.h"
+#include "igstkPulseGenerator.h"
 #include "iostream"
 #include "fstream"
 
@@ -48,11 +50,30 @@ m_StateMachine( this )
   m_CameraCalibrationFileSet = false;
   m_MarkerSizeSet = false;
   m_SimulationVideo = "";
+
+  m_FrameQueueCapacity = 2;
+  m_FrameAvailable = itk::ConditionVariable::New();
+  m_SlotAvailable = itk::ConditionVariable::New();
+  m_CaptureThreader = itk::MultiThreader::New();
+  m_CaptureThreadID = -1;
+  m_CaptureRunning = false;
+  m_StopCapture = false;
+
+  m_RegionOfInterestTracking = true;
+  m_RegionOfInterestMargin = 0.5;
+  m_FullFrameSearchInterval = 10;
+  m_FramesSinceFullFrameSearch = 0;
+
+  m_NumberOfCapturedFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_NumberOfProcessedFrames = 0;
+  m_NumberOfFullFrameSearches = 0;
 }
 
 /** Desctructor */
 ArucoTracker::~ArucoTracker ( void )
 {
+  this->StopCaptureThread();
 }
 
 bool ArucoTracker::SetCameraParametersFromYAMLFile(std::string file)
@@ -142,6 +163,29 @@ ArucoTracker::ResultType ArucoTracker::InternalReset( void )
 */
 ArucoTracker::ResultType ArucoTracker::InternalStartTracking( void )
 {
+  igstkLogMacro( DEBUG,
+    "igstk::ArucoTracker::InternalStartTracking called ...\n" )
+
+  this->StopCaptureThread();
+
+  m_QueueLock.Lock();
+  m_FrameQueue.clear();
+  m_LatestFrame = cv::Mat();
+  m_NumberOfCapturedFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_NumberOfProcessedFrames = 0;
+  m_NumberOfFullFrameSearches = 0;
+  m_StopCapture = false;
+  m_CaptureRunning = true;
+  m_QueueLock.Unlock();
+
+  // the first frame is searched entirely
+  m_PreviousMarkers.clear();
+  m_FramesSinceFullFrameSearch = 0;
+
+  m_CaptureThreadID =
+    m_CaptureThreader->SpawnThread( CaptureThreadFunction, this );
+
   return SUCCESS;
 }
 
@@ -155,9 +199,103 @@ ArucoTracker::ResultType ArucoTracker::InternalStopTracking( void )
 {
   igstkLogMacro( DEBUG,
     "igstk::ArucoTracker::InternalStopTracking called ...\n" )
+
+  this->StopCaptureThread();
+
   return SUCCESS;
 }
 
+/**----------------------------------------------------------------------------
+*   StopCaptureThread
+*  ----------------------------------------------------------------------------
+*  Stop the capture thread and wait for it to exit.
+*  ----------------------------------------------------------------------------
+*/
+void ArucoTracker::StopCaptureThread( void )
+{
+  if( m_CaptureThreadID < 0 )
+    return;
+
+  m_QueueLock.Lock();
+  m_StopCapture = true;
+  m_SlotAvailable->Broadcast();
+  m_QueueLock.Unlock();
+
+  m_CaptureThreader->TerminateThread( m_CaptureThreadID );
+  m_CaptureThreadID = -1;
+}
+
+/**----------------------------------------------------------------------------
+*   CaptureThreadFunction
+*  ----------------------------------------------------------------------------
+*  Grab the frames into the queue until the capture is stopped or the
+*  video ends.
+*  ----------------------------------------------------------------------------
+*/
+ITK_THREAD_RETURN_TYPE ArucoTracker::CaptureThreadFunction( void * info )
+{
+  itk::MultiThreader::ThreadInfoStruct * threadInfo =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( info );
+  ArucoTracker * self = static_cast< ArucoTracker * >( threadInfo->UserData );
+
+  // a camera does not wait for the detection, a video does
+  const bool dropFrames = self->m_SimulationVideo.empty();
+  const unsigned int capacity =
+    self->m_FrameQueueCapacity > 0 ? self->m_FrameQueueCapacity : 1;
+
+  while( true )
+  {
+    cv::Mat frame;
+    bool grabbed = false;
+    try
+    {
+      grabbed = self->m_VideoCapturer.grab() &&
+                self->m_VideoCapturer.retrieve( frame ) && !frame.empty();
+    }
+    catch( std::exception &ex )
+    {
+      igstkLogMacroStatic( self, CRITICAL,
+        "igstk::ArucoTracker::CaptureThreadFunction Exception:"
+        << ex.what() << "\n" )
+    }
+
+    self->m_QueueLock.Lock();
+
+    if( !dropFrames )
+    {
+      while( self->m_FrameQueue.size() >= capacity && !self->m_StopCapture )
+        self->m_SlotAvailable->Wait( &self->m_QueueLock );
+    }
+
+    if( !grabbed || self->m_StopCapture )
+    {
+      m_QueueLock.Unlock();
+      break;
+    }
+
+    while( self->m_FrameQueue.size() >= capacity )
+    {
+      self->m_FrameQueue.pop_front();
+      self->m_NumberOfDroppedFrames++;
+    }
+
+    self->m_FrameQueue.push_back( frame );
+    self->m_LatestFrame = frame;
+    self->m_NumberOfCapturedFrames++;
+    self->m_FrameAvailable->Signal();
+
+    m_QueueLock.Unlock();
+  }
+
+  // wake up the detection, which would otherwise wait for a frame forever
+  self->m_QueueLock.Lock();
+  self->m_CaptureRunning = false;
+  self->m_FrameAvailable->Broadcast();
+  m_QueueLock.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 /**----------------------------------------------------------------------------
 *   InternalUpdateStatus
 *  ----------------------------------------------------------------------------
@@ -168,28 +306,28 @@ ArucoTracker::ResultType ArucoTracker::InternalUpdateStatus( void )
 {
   igstkLogMacro( DEBUG,
          "igstk::ArucoTracker::InternalUpdateStatus called ...\n" )
-  TrackerToolsContainerType trackerToolContainer = GetTrackerToolContainer();
-
-  TrackerToolsContainerType::iterator inputItr = trackerToolContainer.begin();
-  TrackerToolsContainerType::iterator inputEnd = trackerToolContainer.end();
+  const TrackerToolSlotType numberOfSlots =
+    static_cast< TrackerToolSlotType >( this->m_MarkerIDContainer.size() );
 
   // set all tracker to not yet updated
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
   {
-    this->SetTrackerToolTransformUpdate( trackerToolContainer[inputItr->first], false );
-    ++inputItr;
+    if( this->m_MarkerIDContainer[slot] >= 0 )
+      this->SetTrackerToolTransformUpdate( slot, false );
   }
 
   this->m_BufferLock->Lock();
 
   // iterate over initialized tracker tools and update
-  inputItr = trackerToolContainer.begin();
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
   {
+    const int markerID = this->m_MarkerIDContainer[slot];
+    if( markerID < 0 )
+      continue;
+
     for( unsigned int i=0; i < this->m_Markers.size(); i++ )
     {
-      std::string toolStringID = inputItr->first;
-      if( m_Markers[i].id == atoi(toolStringID.c_str()) )
+      if( m_Markers[i].id == markerID )
       {
         try
         {
@@ -232,10 +370,10 @@ ArucoTracker::ResultType ArucoTracker::InternalUpdateStatus( void )
                              lTime );
 
           // set the raw transform
-          this->SetTrackerToolRawTransform( trackerToolContainer [toolStringID], transform );
-          this->SetTrackerToolTransformUpdate( trackerToolContainer [toolStringID], true );
+          this->SetTrackerToolRawTransform( slot, transform );
+          this->SetTrackerToolTransformUpdate( slot, true );
           // report to the tracker tool that the tracker is Visible
-          this->ReportTrackingToolVisible(trackerToolContainer[toolStringID]);
+          this->ReportTrackingToolVisible( slot );
         }
         catch( std::exception &ex )
         {
@@ -245,21 +383,16 @@ ArucoTracker::ResultType ArucoTracker::InternalUpdateStatus( void )
         }
       }
     }
-    ++inputItr;
   }
 
   this->m_BufferLock->Unlock ();
 
-  inputItr = trackerToolContainer.begin();
-  inputEnd = trackerToolContainer.end();
-
   // set all tracker not updated to invisible
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
   {
-  if(!trackerToolContainer[inputItr->first]->GetUpdated())
-    this->ReportTrackingToolNotAvailable(
-      trackerToolContainer[inputItr->first]);
-  ++inputItr;
+  const TrackerToolType * trackerTool = this->GetTrackerToolInSlot( slot );
+  if( trackerTool && !trackerTool->GetUpdated() )
+    this->ReportTrackingToolNotAvailable( slot );
   }
   return SUCCESS;
 }
@@ -276,28 +409,147 @@ ArucoTracker::InternalThreadedUpdateStatus( void )
   igstkLogMacro( DEBUG,
   "igstk::ArucoTracker::InternalThreadedUpdateStatus called ...\n" )
 
-  try
+  // take a frame from the capture stage
+  this->m_QueueLock.Lock();
+  while( this->m_FrameQueue.empty() && this->m_CaptureRunning )
+    this->m_FrameAvailable->Wait( &this->m_QueueLock );
+
+  if( this->m_FrameQueue.empty() )
   {
-    this->m_VideoCapturer.grab();
-    this->m_VideoCapturer.retrieve( this->m_InputImage );
+    // the capture has stopped, do not spin on the tracking thread
+    this->m_QueueLock.Unlock();
+    igstk::PulseGenerator::Sleep( 10 );
+    return FAILURE;
+  }
 
-    this->m_BufferLock->Lock();
-    this->m_MDetector.detect( this->m_InputImage,
-                              this->m_Markers,
-                              this->m_CameraParameters,
-                              m_MarkerSize );
-    this->m_BufferLock->Unlock();
+  if( this->m_SimulationVideo.empty() )
+  {
+    // detect in the newest frame of the camera
+    this->m_InputImage = this->m_FrameQueue.back();
+    this->m_NumberOfDroppedFrames += this->m_FrameQueue.size() - 1;
+    this->m_FrameQueue.clear();
+  }
+  else
+  {
+    // detect in every frame of the video
+    this->m_InputImage = this->m_FrameQueue.front();
+    this->m_FrameQueue.pop_front();
+  }
+  this->m_NumberOfProcessedFrames++;
+  this->m_SlotAvailable->Signal();
+  this->m_QueueLock.Unlock();
+
+  std::vector< aruco::Marker > markers;
+  try
+  {
+    this->DetectMarkers( this->m_InputImage, markers );
   }
   catch( std::exception &ex )
   {
     igstkLogMacro( CRITICAL,
-      "igstk::ArucoTracker::InternalThreadedUpdateStatus Exception:" << ex.what() )
+      "igstk::ArucoTracker::InternalThreadedUpdateStatus Exception:"
+      << ex.what() )
     return FAILURE;
   }
 
+  this->m_PreviousMarkers = markers;
+
+  // publish the markers
+  this->m_BufferLock->Lock();
+  this->m_Markers.swap( markers );
+  this->m_BufferLock->Unlock();
+
   return SUCCESS;
 }
 
+/**----------------------------------------------------------------------------
+*   DetectMarkers
+*  ----------------------------------------------------------------------------
+*  Detect the markers around their previous positions, or in the whole
+*  frame.
+*  ----------------------------------------------------------------------------
+*/
+void ArucoTracker::DetectMarkers( const cv::Mat & frame,
+                                  std::vector< aruco::Marker > & markers )
+{
+  markers.clear();
+
+  bool fullFrame = !this->m_RegionOfInterestTracking ||
+                   this->m_PreviousMarkers.empty() ||
+                   this->m_FramesSinceFullFrameSearch + 1 >=
+                   this->m_FullFrameSearchInterval;
+
+  if( !fullFrame )
+  {
+    this->m_FramesSinceFullFrameSearch++;
+
+    for( unsigned int i = 0; i < this->m_PreviousMarkers.size(); i++ )
+    {
+      const aruco::Marker & previous = this->m_PreviousMarkers[i];
+
+      // bounding box of the corners, enlarged by the margin
+      float minX = previous[0].x;
+      float maxX = previous[0].x;
+      float minY = previous[0].y;
+      float maxY = previous[0].y;
+      for( unsigned int c = 1; c < previous.size(); c++ )
+      {
+        minX = std::min( minX, previous[c].x );
+        maxX = std::max( maxX, previous[c].x );
+        minY = std::min( minY, previous[c].y );
+        maxY = std::max( maxY, previous[c].y );
+      }
+      const int margin = static_cast< int >( this->m_RegionOfInterestMargin *
+                                   std::max( maxX - minX, maxY - minY ) ) + 1;
+      cv::Rect roi( static_cast< int >( minX ) - margin,
+                    static_cast< int >( minY ) - margin,
+                    static_cast< int >( maxX - minX ) + 2 * margin + 1,
+                    static_cast< int >( maxY - minY ) + 2 * margin + 1 );
+      roi &= cv::Rect( 0, 0, frame.cols, frame.rows );
+      if( roi.width <= 0 || roi.height <= 0 )
+        continue;
+
+      // the pose is computed in the coordinates of the whole frame
+      std::vector< aruco::Marker > found;
+      this->m_MDetector.detect( frame( roi ), found );
+      for( unsigned int j = 0; j < found.size(); j++ )
+      {
+        if( found[j].id != previous.id )
+          continue;
+        for( unsigned int c = 0; c < found[j].size(); c++ )
+        {
+          found[j][c].x += roi.x;
+          found[j][c].y += roi.y;
+        }
+        found[j].calculateExtrinsics( static_cast< float >( m_MarkerSize ),
+                                      this->m_CameraParameters );
+        markers.push_back( found[j] );
+        break;
+      }
+    }
+
+    // a marker was lost, it is searched in the whole frame
+    if( markers.size() < this->m_PreviousMarkers.size() )
+    {
+      markers.clear();
+      fullFrame = true;
+    }
+  }
+
+  if( fullFrame )
+  {
+    this->m_MDetector.detect( frame,
+                              markers,
+                              this->m_CameraParameters,
+                              m_MarkerSize );
+    this->m_FramesSinceFullFrameSearch = 0;
+
+    this->m_QueueLock.Lock();
+    this->m_NumberOfFullFrameSearches++;
+    this->m_QueueLock.Unlock();
+  }
+}
+
 /**
  * Set marker size in mm.
  */
@@ -321,11 +573,57 @@ void ArucoTracker::SetMarkerSize(unsigned int size)
 cv::Mat ArucoTracker::GetCurrentVideoFrame()
 {
   cv::Mat tmpImage;
-  this->m_VideoCapturer.grab();
-  this->m_VideoCapturer.retrieve( tmpImage );
+
+  // the capture thread owns the video stream while it runs
+  this->m_QueueLock.Lock();
+  const bool captureRunning = this->m_CaptureRunning;
+  if( captureRunning )
+    tmpImage = this->m_LatestFrame.clone();
+  this->m_QueueLock.Unlock();
+
+  if( !captureRunning )
+  {
+    this->m_VideoCapturer.grab();
+    this->m_VideoCapturer.retrieve( tmpImage );
+  }
   return tmpImage;
 }
 
+/**
+ * Statistics of the capture and detection pipeline.
+ */
+unsigned long ArucoTracker::GetNumberOfCapturedFrames() const
+{
+  m_QueueLock.Lock();
+  const unsigned long number = m_NumberOfCapturedFrames;
+  m_QueueLock.Unlock();
+  return number;
+}
+
+unsigned long ArucoTracker::GetNumberOfDroppedFrames() const
+{
+  m_QueueLock.Lock();
+  const unsigned long number = m_NumberOfDroppedFrames;
+  m_QueueLock.Unlock();
+  return number;
+}
+
+unsigned long ArucoTracker::GetNumberOfProcessedFrames() const
+{
+  m_QueueLock.Lock();
+  const unsigned long number = m_NumberOfProcessedFrames;
+  m_QueueLock.Unlock();
+  return number;
+}
+
+unsigned long ArucoTracker::GetNumberOfFullFrameSearches() const
+{
+  m_QueueLock.Lock();
+  const unsigned long number = m_NumberOfFullFrameSearches;
+  m_QueueLock.Unlock();
+  return number;
+}
+
 /**----------------------------------------------------------------------------
 *   PrintSelf
 *  ----------------------------------------------------------------------------
@@ -338,6 +636,23 @@ void ArucoTracker::PrintSelf( std::ostream& os, itk::Indent indent ) const
          "igstk::ArucoTracker::PrintSelf called ...\n" )
 
   Superclass::PrintSelf( os, indent );
+
+  os << indent << "Frame queue capacity: " << m_FrameQueueCapacity
+     << std::endl;
+  os << indent << "Region of interest tracking: "
+     << m_RegionOfInterestTracking << std::endl;
+  os << indent << "Region of interest margin: " << m_RegionOfInterestMargin
+     << std::endl;
+  os << indent << "Full frame search interval: "
+     << m_FullFrameSearchInterval << std::endl;
+  os << indent << "Captured frames: " << this->GetNumberOfCapturedFrames()
+     << std::endl;
+  os << indent << "Dropped frames: " << this->GetNumberOfDroppedFrames()
+     << std::endl;
+  os << indent << "Processed frames: " << this->GetNumberOfProcessedFrames()
+     << std::endl;
+  os << indent << "Full frame searches: "
+     << this->GetNumberOfFullFrameSearches() << std::endl;
 }
 
 /**----------------------------------------------------------------------------
@@ -359,23 +674,12 @@ ArucoTracker::VerifyTrackerToolInformation (
     return FAILURE;
   }
 
-  TrackerToolsContainerType trackerToolContainer = GetTrackerToolContainer();
-
-  TrackerToolsContainerType::iterator inputItr = trackerToolContainer.begin();
-  TrackerToolsContainerType::iterator inputEnd = trackerToolContainer.end();
-
-  // check if marker name already set
-  while( inputItr != inputEnd )
-  {
-    // if new tool marker name is already in the tool container
-    // return failure
-    if(std::strcmp(trackerTool->GetTrackerToolIdentifier().c_str(),
-                   (inputItr->first).c_str()) == 0)
+  // if new tool marker name is already in the tool container
+  // return failure
+  if( this->GetTrackerToolSlot( trackerTool->GetTrackerToolIdentifier() ) !=
+      InvalidTrackerToolSlot )
     return FAILURE;
 
-    ++inputItr;
-  }
-
   return SUCCESS;
 }
 
@@ -428,6 +732,16 @@ ArucoTracker::RemoveTrackerToolFromInternalDataContainers(
       return FAILURE;
     }
 
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if ( slot < this->m_MarkerIDContainer.size() )
+    {
+      this->m_BufferLock->Lock();
+      // free the slot
+      this->m_MarkerIDContainer[ slot ] = -1;
+      this->m_BufferLock->Unlock();
+    }
+
   return SUCCESS;
 }
 
@@ -450,6 +764,26 @@ ArucoTracker::AddTrackerToolToInternalDataContainers (
       return FAILURE;
     }
 
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if ( slot == InvalidTrackerToolSlot )
+    {
+      return FAILURE;
+    }
+
+  this->m_BufferLock->Lock();
+
+  if ( slot >= this->m_MarkerIDContainer.size() )
+    {
+      this->m_MarkerIDContainer.resize( slot + 1, -1 );
+    }
+
+  // the tracker tool identifier is the id of the marker
+  this->m_MarkerIDContainer[ slot ] =
+    atoi( trackerTool->GetTrackerToolIdentifier().c_str() );
+
+  this->m_BufferLock->Unlock();
+
   return SUCCESS;
 }
 
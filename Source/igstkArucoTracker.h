@@ -32,6 +32,10 @@
 #include "igstkArucoTrackerTool.h"
 
 #include "vector"
+#include "deque"
+
+#include "itkMultiThreader.h"
+#include "itkConditionVariable.h"
 
 namespace igstk {
 
@@ -63,6 +67,20 @@ namespace igstk {
  *  All the settings above has to be done before calling
  *  RequestOpen();
  *
+ *  Capture and detection are pipelined. While tracking, a capture thread
+ *  grabs the frames into a bounded queue, and the tracking thread detects
+ *  the markers in the latest frame. With a camera the oldest frame is
+ *  dropped when the queue is full, so the detection always works on a
+ *  recent frame. With a simulation video the capture waits instead, so
+ *  every frame of the video is processed.
+ *
+ *  The markers are searched only in regions of interest around their
+ *  previous positions, enlarged by RegionOfInterestMargin times their
+ *  size. The whole frame is searched when no marker was found, when a
+ *  marker was lost, and every FullFrameSearchInterval frames, so that new
+ *  markers are found. The detected markers are published to the main
+ *  thread with a pointer swap under the buffer lock.
+ *
  *  \ingroup Tracker
  */
 
@@ -81,8 +99,36 @@ public:
 
   void SetMarkerSize(unsigned int size);
 
+  /** While tracking, return a copy of the last captured frame. Otherwise
+   *  grab a new frame from the video stream. */
   cv::Mat GetCurrentVideoFrame();
 
+  /** Number of frames kept between the capture and the detection. 2 by
+   *  default. */
+  igstkSetMacro( FrameQueueCapacity, unsigned int );
+  igstkGetMacro( FrameQueueCapacity, unsigned int );
+
+  /** Search the markers only around their previous positions. True by
+   *  default. */
+  igstkSetMacro( RegionOfInterestTracking, bool );
+  igstkGetMacro( RegionOfInterestTracking, bool );
+
+  /** Margin added around a marker to get its region of interest, as a
+   *  fraction of the marker size in the image. 0.5 by default. */
+  igstkSetMacro( RegionOfInterestMargin, double );
+  igstkGetMacro( RegionOfInterestMargin, double );
+
+  /** The whole frame is searched at least every FullFrameSearchInterval
+   *  frames. 10 by default. */
+  igstkSetMacro( FullFrameSearchInterval, unsigned int );
+  igstkGetMacro( FullFrameSearchInterval, unsigned int );
+
+  /** Statistics of the pipeline since tracking started */
+  unsigned long GetNumberOfCapturedFrames() const;
+  unsigned long GetNumberOfDroppedFrames() const;
+  unsigned long GetNumberOfProcessedFrames() const;
+  unsigned long GetNumberOfFullFrameSearches() const;
+
 protected:
 
   /** Constructor */
@@ -143,6 +189,17 @@ protected:
 
 private:
 
+  /** Capture thread */
+  static ITK_THREAD_RETURN_TYPE CaptureThreadFunction( void * info );
+
+  /** Stop the capture thread and wait for it to exit */
+  void StopCaptureThread();
+
+  /** Detect the markers in a frame, around their previous positions or in
+   *  the whole frame */
+  void DetectMarkers( const cv::Mat & frame,
+                      std::vector< aruco::Marker > & markers );
+
   cv::VideoCapture        m_VideoCapturer;
   cv::Mat                 m_InputImage;
   aruco::CameraParameters m_CameraParameters;
@@ -156,6 +213,36 @@ private:
   /** A mutex for multithreaded access to the buffer arrays */
   itk::MutexLock::Pointer  m_BufferLock;
 
+  /** Marker id of each slot, parsed once from the tracker tool identifier.
+   *  -1 for a free slot. */
+  std::vector< int >       m_MarkerIDContainer;
+
+  /** Frames between the capture and the detection */
+  std::deque< cv::Mat >          m_FrameQueue;
+  cv::Mat                        m_LatestFrame;
+  unsigned int                   m_FrameQueueCapacity;
+  mutable itk::SimpleMutexLock   m_QueueLock;
+  itk::ConditionVariable::Pointer m_FrameAvailable;
+  itk::ConditionVariable::Pointer m_SlotAvailable;
+  itk::MultiThreader::Pointer    m_CaptureThreader;
+  int                            m_CaptureThreadID;
+  bool                           m_CaptureRunning;
+  bool                           m_StopCapture;
+
+  /** Regions of interest */
+  bool                           m_RegionOfInterestTracking;
+  double                         m_RegionOfInterestMargin;
+  unsigned int                   m_FullFrameSearchInterval;
+  unsigned int                   m_FramesSinceFullFrameSearch;
+
+  /** Markers of the last frame, only used by the detection */
+  std::vector< aruco::Marker >   m_PreviousMarkers;
+
+  unsigned long                  m_NumberOfCapturedFrames;
+  unsigned long                  m_NumberOfDroppedFrames;
+  unsigned long                  m_NumberOfProcessedFrames;
+  unsigned long                  m_NumberOfFullFrameSearches;
+
 }; // end of class ArucoTracker
 
 } // end of namespace igstk
@@ -318,33 +318,35 @@ Ascension3DGTracker::ResultType Ascension3DGTracker::InternalUpdateStatus()
   // accessing it.
   m_BufferLock->Lock();
 
-  typedef TrackerToolTransformContainerType::const_iterator  InputConstIterator;
+  const TrackerToolSlotType numberOfSlots =
+    static_cast< TrackerToolSlotType >( this->m_SensorIDContainer.size() );
 
-  InputConstIterator inputItr = this->m_ToolTransformBuffer.begin();
-  InputConstIterator inputEnd = this->m_ToolTransformBuffer.end();
-
-  TrackerToolsContainerType trackerToolContainer =
-      this->GetTrackerToolContainer();
-
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
+    if ( this->m_SensorIDContainer[slot] < 0 )
+      {
+      continue;
+      }
+
     // decide "tool visibility"
-    if (this->m_ToolStatusContainer[inputItr->first] != TOOL_AVAILABLE)
+    if (this->m_ToolStatusContainer[slot] != TOOL_AVAILABLE)
       {
       igstkLogMacro( INFO, 
             "igstk::Ascension3DGTracker::InternalUpdateStatus: " <<
-            "tool " << inputItr->first << " is not in view\n");
+            "sensor " << this->m_SensorIDContainer[slot] <<
+            " is not in view\n");
 
        // report to the tracker tool that the tracker is not available
-       this->ReportTrackingToolNotAvailable(
-            trackerToolContainer[inputItr->first]);
+       this->ReportTrackingToolNotAvailable( slot );
 
-       ++inputItr;
        continue;
       }
 
     // report to the tracker tool that the tracker is Visible
-    this->ReportTrackingToolVisible(trackerToolContainer[inputItr->first]);
+    this->ReportTrackingToolVisible( slot );
+
+    const double * toolTransform =
+      &this->m_ToolTransformBuffer[ slot * TransformSize ];
 
     // create the transform
     TransformType transform;
@@ -352,18 +354,18 @@ Ascension3DGTracker::ResultType Ascension3DGTracker::InternalUpdateStatus()
     typedef TransformType::VectorType TranslationType;
     TranslationType translation;
 
-    translation[0] = (inputItr->second)[0];
-    translation[1] = (inputItr->second)[1];
-    translation[2] = (inputItr->second)[2];
+    translation[0] = toolTransform[0];
+    translation[1] = toolTransform[1];
+    translation[2] = toolTransform[2];
 
     typedef TransformType::VersorType RotationType;
     RotationType rotation;
 
     const double normsquared =
-        (inputItr->second)[3]*(inputItr->second)[3] +
-        (inputItr->second)[4]*(inputItr->second)[4] +
-        (inputItr->second)[5]*(inputItr->second)[5] +
-        (inputItr->second)[6]*(inputItr->second)[6];
+        toolTransform[3]*toolTransform[3] +
+        toolTransform[4]*toolTransform[4] +
+        toolTransform[5]*toolTransform[5] +
+        toolTransform[6]*toolTransform[6];
 
     // don't allow null quaternions
     if (normsquared < 1e-6)
@@ -375,10 +377,10 @@ Ascension3DGTracker::ResultType Ascension3DGTracker::InternalUpdateStatus()
       }
     else
       {
-        rotation.Set((inputItr->second)[3],
-                     (inputItr->second)[4],
-                     (inputItr->second)[5],
-                     (inputItr->second)[6]);
+        rotation.Set(toolTransform[3],
+                     toolTransform[4],
+                     toolTransform[5],
+                     toolTransform[6]);
       }
 
     typedef TransformType::ErrorType  ErrorType;
@@ -388,13 +390,9 @@ Ascension3DGTracker::ResultType Ascension3DGTracker::InternalUpdateStatus()
         this->GetValidityTime());
 
     // set the raw transform
-    this->SetTrackerToolRawTransform(
-        trackerToolContainer[inputItr->first], transform );
-
-    this->SetTrackerToolTransformUpdate(
-        trackerToolContainer[inputItr->first], true );
+    this->SetTrackerToolRawTransform( slot, transform );
 
-    ++inputItr;
+    this->SetTrackerToolTransformUpdate( slot, true );
     }
 
   m_BufferLock->Unlock();
@@ -411,10 +409,6 @@ Ascension3DGTracker::InternalThreadedUpdateStatus( void )
 
   m_BufferLock->Lock();
 
-  typedef TrackerToolTransformContainerType::const_iterator  InputConstIterator;
-  InputConstIterator inputItr = this->m_ToolTransformBuffer.begin();
-  InputConstIterator inputEnd = this->m_ToolTransformBuffer.end();
-
   //The correct way to get data from all sensors is to call GetSyncronousRecord and
   //pass a sensorID of ALL_SENSORS (defined in ATC3DG.h). This requires passing a
   //buffer n times as large as the data format requires, where n is the number of
@@ -427,13 +421,27 @@ Ascension3DGTracker::InternalThreadedUpdateStatus( void )
   this->CheckAPIReturnStatus(atc::GetSynchronousRecord(ALL_SENSORS, record,
     sysConfig.numberSensors * sizeof(RecordType)));
 
-  int sensorIndex = 0;
-  while( inputItr != inputEnd )
+  const TrackerToolSlotType numberOfSlots =
+    static_cast< TrackerToolSlotType >( this->m_SensorIDContainer.size() );
+
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
   {
+    if ( this->m_SensorIDContainer[slot] < 0 )
+      {
+      continue;
+      }
+
     //set the tool's flag to unavailable
-    this->m_ToolStatusContainer[inputItr->first] = Ascension3DGTracker::TOOL_UNAVAILABLE;
-    //get the 0 based sensor id based on the tool's name
-    unsigned short sensorID = this->ConvertToolNameToSensorID(inputItr->first);
+    this->m_ToolStatusContainer[slot] = Ascension3DGTracker::TOOL_UNAVAILABLE;
+    //the 0 based sensor id, parsed from the tool's name when it was added
+    const unsigned short sensorID =
+      static_cast< unsigned short >( this->m_SensorIDContainer[slot] );
+
+    //the record of ALL_SENSORS is indexed by sensor id
+    if ( sensorID >= sysConfig.numberSensors )
+      {
+      continue;
+      }
 
     //For each sensor, we need to get its status. This will tell us if the sensor
     //is attached, if it is saturated from being too close to the magnetic transmitter,
@@ -450,31 +458,31 @@ Ascension3DGTracker::InternalThreadedUpdateStatus( void )
     transmitterAttached = !(status & NO_TRANSMITTER_ATTACHED);
     globalError = status & GLOBAL_ERROR;
 
-    std::vector< double > transform(7);  //3 positions, 4 quaternions
-    transform[0] = record[sensorIndex].x;
-    transform[1] = record[sensorIndex].y;
-    transform[2] = record[sensorIndex].z;
+    //3 positions, 4 quaternions
+    double * transform = &this->m_ToolTransformBuffer[ slot * TransformSize ];
+    transform[0] = record[sensorID].x;
+    transform[1] = record[sensorID].y;
+    transform[2] = record[sensorID].z;
 
     // Ascension quaternion: q0, q1, q2, and q3 where q0
     // is the scaler component
     // itk versor: void Set( T x, T y, T z, T w );
-    transform[3] = record[sensorIndex].q[1];
-    transform[4] = record[sensorIndex].q[2];
-    transform[5] = record[sensorIndex].q[3];
-    transform[6] = -record[sensorIndex].q[0];
+    transform[3] = record[sensorID].q[1];
+    transform[4] = record[sensorID].q[2];
+    transform[5] = record[sensorID].q[3];
+    transform[6] = -record[sensorID].q[0];
 
-    this->m_ToolTransformBuffer[ inputItr->first ] = transform;
     //The tool will only be considered available if a transmitter is attached
     //and running, the sensor is attached, it is within the motion box, and it
     //is not saturated.
     if((!transmitterAttached) || (!transmitterRunning) || (!attached) ||
       (!inMotionBox) || saturated)
       {
-      this->m_ToolStatusContainer[ inputItr->first ] = TOOL_UNAVAILABLE;
+      this->m_ToolStatusContainer[ slot ] = TOOL_UNAVAILABLE;
       }
     else
       {
-      this->m_ToolStatusContainer[ inputItr->first ] = TOOL_AVAILABLE;
+      this->m_ToolStatusContainer[ slot ] = TOOL_AVAILABLE;
       }
 
     /*Invoke events based on what the sensor status is now and what it was last time.
@@ -484,49 +492,57 @@ Ascension3DGTracker::InternalThreadedUpdateStatus( void )
     if(saturated && (!this->m_SensorSaturated[sensorID]))
       {
       //sensor just became saturated
-      this->InvokeSensorToolEvent(inputItr->first, sensorID,
+      this->InvokeSensorToolEvent(ConvertSensorIDToToolName(sensorID),
+        sensorID,
         Ascension3DGToolEventStruct::TOOL_SATURATED);
       }
     else if((!saturated) && this->m_SensorSaturated[sensorID])
       {
       //sensor just came out of saturation
-      this->InvokeSensorToolEvent(inputItr->first, sensorID,
+      this->InvokeSensorToolEvent(ConvertSensorIDToToolName(sensorID),
+        sensorID,
         Ascension3DGToolEventStruct::TOOL_OUT_OF_SATURATION);
       }
     if((!attached) && this->m_SensorAttached[sensorID])
       {
       //sensor just became disconnected
-      this->InvokeSensorToolEvent(inputItr->first, sensorID,
+      this->InvokeSensorToolEvent(ConvertSensorIDToToolName(sensorID),
+        sensorID,
         Ascension3DGToolEventStruct::TOOL_DISCONNECTED);
       }
     else if(attached && (!this->m_SensorAttached[sensorID]))
       {
       //sensor just became attached
-      this->InvokeSensorToolEvent(inputItr->first, sensorID,
+      this->InvokeSensorToolEvent(ConvertSensorIDToToolName(sensorID),
+        sensorID,
         Ascension3DGToolEventStruct::TOOL_CONNECTED);
       }
     if((!inMotionBox) && (this->m_SensorInMotionBox[sensorID]))
       {
       //sensor just moved out of the motion box
-      this->InvokeSensorToolEvent(inputItr->first, sensorID,
+      this->InvokeSensorToolEvent(ConvertSensorIDToToolName(sensorID),
+        sensorID,
         Ascension3DGToolEventStruct::TOOL_OUT_OF_MOTION_BOX);
       } 
     else if(inMotionBox && (!this->m_SensorInMotionBox[sensorID]))
       {
       //sensor just moved back into the motion box
-      this->InvokeSensorToolEvent(inputItr->first, sensorID,
+      this->InvokeSensorToolEvent(ConvertSensorIDToToolName(sensorID),
+        sensorID,
         Ascension3DGToolEventStruct::TOOL_IN_MOTION_BOX);
       }
     if((!transmitterAttached) && this->m_TransmitterAttached)
       {
       //transmitter was just detached
-      this->InvokeSensorToolEvent(inputItr->first, sensorID,
+      this->InvokeSensorToolEvent(ConvertSensorIDToToolName(sensorID),
+        sensorID,
         Ascension3DGToolEventStruct::TRANSMITTER_DETACHED);
       }
     else if(transmitterAttached && (!this->m_TransmitterAttached))
       {
       //transmitter was just attached
-      this->InvokeSensorToolEvent(inputItr->first, sensorID,
+      this->InvokeSensorToolEvent(ConvertSensorIDToToolName(sensorID),
+        sensorID,
         Ascension3DGToolEventStruct::TRANSMITTER_ATTACHED);
       }
     //assign the current states to the member variables
@@ -534,9 +550,6 @@ Ascension3DGTracker::InternalThreadedUpdateStatus( void )
     this->m_SensorAttached[sensorID] = attached;
     this->m_SensorInMotionBox[sensorID] = inMotionBox;
     this->m_TransmitterAttached = transmitterAttached;
-
-    ++inputItr;
-    ++sensorIndex;
   } 
 
   delete [] record;
@@ -600,15 +613,16 @@ Ascension3DGTracker
     "Ascension3DGTracker::RemoveTrackerToolFromInternalDataContainers"
     " called...\n");
 
-  //GetTrackerToolIdentifier is actually returning a const std:string, not
-  //a const std::string&. This can be assigned to a const std::string&.
-  //If ToolTracker is changed, our temporary will go away.
-  const std::string &trackerToolIdentifier = 
-    trackerTool->GetTrackerToolIdentifier();
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
 
-  // remove the tool from the Transform buffer container
-  this->m_ToolTransformBuffer.erase( trackerToolIdentifier );
-  this->m_ToolStatusContainer.erase( trackerToolIdentifier );
+  if ( slot < this->m_SensorIDContainer.size() )
+    {
+    m_BufferLock->Lock();
+    // free the slot
+    this->m_SensorIDContainer[ slot ] = -1;
+    this->m_ToolStatusContainer[ slot ] = TOOL_UNAVAILABLE;
+    m_BufferLock->Unlock();
+    }
 
   return SUCCESS;
 }
@@ -626,23 +640,36 @@ AddTrackerToolToInternalDataContainers( const TrackerToolType * trackerTool )
     return FAILURE;
     }
 
-  //GetTrackerToolIdentifier is actually returning a const std:string, not
-  //a const std::string&. This can be assigned to a const std::string&.
-  //If ToolTracker is changed, our temporary will go away.
-  const std::string &trackerToolIdentifier =
-      trackerTool->GetTrackerToolIdentifier();
-
-  std::vector< double > transform;
-  transform.push_back( 1.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-
-  this->m_ToolTransformBuffer[ trackerToolIdentifier ] = transform;
-  this->m_ToolStatusContainer[ trackerToolIdentifier ] = TOOL_UNAVAILABLE;
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if ( slot == InvalidTrackerToolSlot )
+    {
+    return FAILURE;
+    }
+
+  const int sensorID =
+    ConvertToolNameToSensorID( trackerTool->GetTrackerToolIdentifier() );
+
+  m_BufferLock->Lock();
+
+  if ( slot >= this->m_SensorIDContainer.size() )
+    {
+    this->m_SensorIDContainer.resize( slot + 1, -1 );
+    this->m_ToolStatusContainer.resize( slot + 1, TOOL_UNAVAILABLE );
+    this->m_ToolTransformBuffer.resize( ( slot + 1 ) * TransformSize, 0.0 );
+    }
+
+  double * transform = &this->m_ToolTransformBuffer[ slot * TransformSize ];
+  transform[0] = 1.0;
+  for ( unsigned int i = 1; i < TransformSize; i++ )
+    {
+    transform[i] = 0.0;
+    }
+
+  this->m_SensorIDContainer[ slot ] = sensorID;
+  this->m_ToolStatusContainer[ slot ] = TOOL_UNAVAILABLE;
+
+  m_BufferLock->Unlock();
 
   m_NumberOfTools ++;
 
@@ -204,18 +204,26 @@ private:
   /** A mutex for multithreaded access to the transform buffer */
   itk::MutexLock::Pointer                          m_BufferLock;
   
-  typedef std::map< std::string, std::vector < double > >
-      TrackerToolTransformContainerType;
-  /** A buffer to hold tool transforms */
+  /** A buffer to hold tool transforms, indexed by the slot of the tracker
+   *  tools. The transform of a slot is stored in the seven values starting
+   *  at 7 * slot: the position, then the quaternion in x, y, z, w order. */
+  typedef std::vector< double >  TrackerToolTransformContainerType;
   TrackerToolTransformContainerType                m_ToolTransformBuffer;
+
+  /** Number of values of a transform in the buffer */
+  itkStaticConstMacro( TransformSize, unsigned int, 7 );
+
+  /** 0 based sensor id of each slot, parsed once from the tracker tool
+   *  identifier. -1 for a free slot. */
+  std::vector< int >                               m_SensorIDContainer;
   
   typedef std::map< unsigned int, std::string>  ErrorCodeContainerType;
   /** Error map container */
   static ErrorCodeContainerType                    m_ErrorCodeContainer;
 
   enum ToolAvailabilityStatus {TOOL_UNAVAILABLE, TOOL_AVAILABLE};
-  /** Container holding status of the tools. Key is the tool's name. */
-  std::map< std::string, ToolAvailabilityStatus >  m_ToolStatusContainer;
+  /** Container holding status of the tools, indexed by slot. */
+  std::vector< ToolAvailabilityStatus >            m_ToolStatusContainer;
 
   /** Retrieve the 0 based sensor id value given the tool's name. */
   static unsigned short ConvertToolNameToSensorID(const std::string &name);
@@ -52,6 +52,7 @@ POSSIBILITY OF SUCH DAMAGES.
 #include <string.h>
 
 #include "igstkAscensionCommandInterpreter.h"
+#include "igstkRealTimeClock.h"
 
 namespace igstk
 {
@@ -104,6 +105,10 @@ AscensionCommandInterpreter::AscensionCommandInterpreter()
   m_PositionScale[1] = FB_STANDARD; 
   m_FBBAddress = 1;
   m_PhaseErrorLeftoverBytes = 0;
+  m_StreamBufferLength = 0;
+  m_StreamBird = 1;
+  m_RecordTimeStamp = 0.0;
+  m_NumberOfPhaseErrors = 0;
   m_Communication = 0;
   m_MaxParameter = FB_POSITION_SCALING;
 }
@@ -422,6 +427,9 @@ void AscensionCommandInterpreter::Stream()
 {
   m_StreamData = 1;
   m_CurrentBird = 1;
+  m_StreamBird = 1;
+  m_StreamBufferLength = 0;
+  m_NumberOfPhaseErrors = 0;
 
   this->SendRaw("@",1);
 }
@@ -430,6 +438,7 @@ void AscensionCommandInterpreter::Stream()
 void AscensionCommandInterpreter::EndStream()
 {
   m_StreamData = 0;
+  m_StreamBufferLength = 0;
   this->SendRaw("B",1);
 
   /* Insert code to purge the serial port buffers to
@@ -547,6 +556,110 @@ void AscensionCommandInterpreter::Update()
 
 }
 
+/** In stream mode, UpdateStream() can be used instead of Update().
+ *  It does not wait for a whole record: whatever part of the record
+ *  has arrived is kept until the rest is received, and the record is
+ *  time stamped when its last byte arrives.
+ *  
+ *  Records are delimited by their phasing bit.  When a byte with the
+ *  phasing bit set is received before the current record is complete,
+ *  the bytes already received are discarded and the new byte is taken
+ *  as the start of a record.  Bytes received while no record is started
+ *  are discarded as well. */
+bool AscensionCommandInterpreter::UpdateStream()
+{
+  if (!m_StreamData)
+    {
+    this->SetErrorAndMessage(FB_ILLEGAL_ERROR,
+                             "UpdateStream() called while not streaming");
+    return false;
+    }
+
+  const unsigned int len = 2*ComputeRecordSize(m_DataFormat[m_StreamBird]) \
+    + m_ButtonMode[m_StreamBird] + m_GroupMode;
+
+  /* read the rest of the record, a timeout only means that the record
+   * is not complete yet */
+  unsigned int bytesRead = 0;
+  igstk::Communication::ResultType result =
+    m_Communication->Read(&m_StreamBuffer[m_StreamBufferLength],
+                          len - m_StreamBufferLength, bytesRead);
+
+  if (result == igstk::Communication::FAILURE)
+    {
+    this->SetErrorAndMessage(FB_IO_ERROR,
+                             "I/O error on serial port read");
+    return false;
+    }
+  if (bytesRead == 0)
+    {
+    this->SetErrorAndMessage(FB_TIMEOUT_ERROR,
+                             "timeout while waiting for bird data");
+    return false;
+    }
+
+  /* the record starts at the last phasing byte, everything before it
+   * belongs to a record that was corrupted */
+  const unsigned int n = m_StreamBufferLength + bytesRead;
+  unsigned int start = n;
+  for (unsigned int i = n; i > 0; i--)
+    {
+    if (m_StreamBuffer[i-1] & 0x80)
+      {
+      start = i-1;
+      break;
+      }
+    }
+
+  if (start > 0)
+    {
+    m_NumberOfPhaseErrors++;
+    memmove(m_StreamBuffer,&m_StreamBuffer[start],n-start);
+    }
+  m_StreamBufferLength = n - start;
+
+  if (m_StreamBufferLength < len)
+    {
+    return false;
+    }
+
+  m_RecordTimeStamp = RealTimeClock::GetTimeStamp();
+  memcpy(m_DataBuffer,m_StreamBuffer,len);
+  m_StreamBufferLength = 0;
+
+  m_CurrentBird = m_StreamBird;
+  const unsigned int bird = this->GetBird();
+  if (bird == 0)
+    {
+    m_NumberOfPhaseErrors++;
+    this->SetErrorAndMessage(FB_PHASE_ERROR,
+                             "received malformed data record");
+    return false;
+    }
+
+  /* in group mode the birds send their records in turn */
+  m_CurrentBird = bird;
+  m_StreamBird = 1;
+  if (m_GroupMode && bird < m_NumberOfBirds)
+    {
+    m_StreamBird = bird + 1;
+    }
+
+  return true;
+}
+
+/** Get the time stamp of the last UpdateStream() data record. */
+double AscensionCommandInterpreter::GetRecordTimeStamp()
+{
+  return m_RecordTimeStamp;
+}
+
+/** Get the number of resynchronizations of the stream. */
+unsigned long AscensionCommandInterpreter::GetNumberOfPhaseErrors()
+{
+  return m_NumberOfPhaseErrors;
+}
+
 /** Get the position returned in the last Update() data record.
  *  
  *  \param xyz        storage space for the position to be returned in
@@ -1445,6 +1558,10 @@ void AscensionCommandInterpreter::PrintSelf(std::ostream& os,
   os << indent << "PhaseErrorLeftoverBytes: "
      << m_PhaseErrorLeftoverBytes << std::endl;
   os << indent << "FBBAddress: " << m_FBBAddress << std::endl;
+  os << indent << "StreamBufferLength: " << m_StreamBufferLength
+     << std::endl;
+  os << indent << "NumberOfPhaseErrors: " << m_NumberOfPhaseErrors
+     << std::endl;
 }
 
 
@@ -358,6 +358,29 @@ public:
    */
   void Update();
 
+  /** Parse the data records sent by the flock in stream mode.
+   *
+   * The bytes received since the previous call are appended to the
+   * record being assembled, so that a record split over several reads
+   * is parsed incrementally. Returns true when a complete record is
+   * available through GetBird(), GetPosition() and the other GetXX()
+   * methods, and false while the record is incomplete or on error.
+   *
+   * The first byte of a record is the only one with its phasing bit set.
+   * Bytes that do not belong to a record starting with a phasing byte
+   * are discarded, which resynchronizes the stream after dropped or
+   * corrupted bytes.
+   */
+  bool UpdateStream();
+
+  /** Get the time at which the most recent record from UpdateStream()
+   *  was completed, in milliseconds of the RealTimeClock. */
+  double GetRecordTimeStamp();
+
+  /** Get the number of times the stream was resynchronized since the
+   *  last call to Stream(). */
+  unsigned long GetNumberOfPhaseErrors();
+
   /** Get the bird that the most recent data record is for. 
    *
    * It is very important to check this value to make sure that
@@ -540,6 +563,21 @@ private:
   /* leftover chars after a phase error */
   unsigned int m_PhaseErrorLeftoverBytes;
 
+  /* record being assembled by UpdateStream() */
+  char m_StreamBuffer[256];
+
+  /* number of chars of the record being assembled */
+  unsigned int m_StreamBufferLength;
+
+  /* bird expected for the next streamed record */
+  unsigned int m_StreamBird;
+
+  /* arrival time of the last streamed record */
+  double m_RecordTimeStamp;
+
+  /* number of resynchronizations of the stream */
+  unsigned long m_NumberOfPhaseErrors;
+
   /** Serial communication */
   CommunicationType::Pointer m_Communication;
 };
@@ -22,6 +22,7 @@
 #endif
 
 #include "igstkAscensionTracker.h"
+#include "igstkRealTimeClock.h"
 
 
 namespace igstk
@@ -37,6 +38,8 @@ AscensionTracker::AscensionTracker(void):m_StateMachine(this)
   m_Communication = 0;
   m_CommandInterpreter = CommandInterpreterType::New();
   m_NumberOfTools = 0;
+  m_StreamingMode = false;
+  m_Streaming = false;
 }
 
 /** Destructor */
@@ -108,6 +111,17 @@ AscensionTracker::InternalStartTracking( void )
 
   m_CommandInterpreter->Run();
 
+  m_Streaming = m_StreamingMode;
+  if ( m_Streaming )
+    {
+    // with several birds, each one sends its record in turn
+    if ( m_NumberOfTools > 1 )
+      {
+      m_CommandInterpreter->ChangeValue(FB_GROUP_MODE,1);
+      }
+    m_CommandInterpreter->Stream();
+    }
+
   return SUCCESS;
 }
 
@@ -118,6 +132,16 @@ AscensionTracker::InternalStopTracking( void )
   igstkLogMacro( DEBUG,
                 "AscensionTracker::InternalStopTracking called ...\n");
 
+  if ( m_Streaming )
+    {
+    m_CommandInterpreter->EndStream();
+    if ( m_NumberOfTools > 1 )
+      {
+      m_CommandInterpreter->ChangeValue(FB_GROUP_MODE,0);
+      }
+    m_Streaming = false;
+    }
+
   m_CommandInterpreter->Stop();
 
   return SUCCESS;
@@ -145,16 +169,15 @@ AscensionTracker::ResultType AscensionTracker::InternalUpdateStatus()
   // accessing it.
   m_BufferLock->Lock();
 
-  typedef TrackerToolTransformContainerType::const_iterator  InputConstIterator;
+  const TrackerToolSlotType numberOfSlots =
+    static_cast< TrackerToolSlotType >( this->m_BirdAddressContainer.size() );
 
-  InputConstIterator inputItr = this->m_ToolTransformBuffer.begin();
-  InputConstIterator inputEnd = this->m_ToolTransformBuffer.end();
-
-  TrackerToolsContainerType trackerToolContainer =
-      this->GetTrackerToolContainer();
-
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
+    if ( this->m_BirdAddressContainer[slot] < 0 )
+      {
+      continue;
+      }
 
     // only report tools that are in view
     // this is actually not working because the ascension system is always
@@ -163,22 +186,23 @@ AscensionTracker::ResultType AscensionTracker::InternalUpdateStatus()
     // decide "tool visibility" in terms of signal fidelity. There should be
     // some parameter that gives that value. I saw it in the pciCubes 
     // application
-    if (! this->m_ToolStatusContainer[inputItr->first])
+    if (! this->m_ToolStatusContainer[slot])
       {
       igstkLogMacro( INFO, 
             "igstk::FlockOfBirdTracker::InternalUpdateStatus: " <<
-            "tool " << inputItr->first << " is not in view\n");
+            "tool in slot " << slot << " is not in view\n");
 
        // report to the tracker tool that the tracker is not available
-       this->ReportTrackingToolNotAvailable(
-            trackerToolContainer[inputItr->first]);
+       this->ReportTrackingToolNotAvailable( slot );
 
-       ++inputItr;
        continue;
       }
 
     // report to the tracker tool that the tracker is Visible
-    this->ReportTrackingToolVisible(trackerToolContainer[inputItr->first]);
+    this->ReportTrackingToolVisible( slot );
+
+    const double * toolTransform = 
+      &this->m_ToolTransformBuffer[ slot * TransformSize ];
 
     // create the transform
     TransformType transform;
@@ -186,18 +210,18 @@ AscensionTracker::ResultType AscensionTracker::InternalUpdateStatus()
     typedef TransformType::VectorType TranslationType;
     TranslationType translation;
 
-    translation[0] = (inputItr->second)[0];
-    translation[1] = (inputItr->second)[1];
-    translation[2] = (inputItr->second)[2];
+    translation[0] = toolTransform[0];
+    translation[1] = toolTransform[1];
+    translation[2] = toolTransform[2];
 
     typedef TransformType::VersorType RotationType;
     RotationType rotation;
 
     const double normsquared =
-        (inputItr->second)[3]*(inputItr->second)[3] +
-        (inputItr->second)[4]*(inputItr->second)[4] +
-        (inputItr->second)[5]*(inputItr->second)[5] +
-        (inputItr->second)[6]*(inputItr->second)[6];
+        toolTransform[3]*toolTransform[3] +
+        toolTransform[4]*toolTransform[4] +
+        toolTransform[5]*toolTransform[5] +
+        toolTransform[6]*toolTransform[6];
 
     // don't allow null quaternions
     if (normsquared < 1e-6)
@@ -209,10 +233,10 @@ AscensionTracker::ResultType AscensionTracker::InternalUpdateStatus()
       }
     else
       {
-        rotation.Set((inputItr->second)[3],
-                     (inputItr->second)[4],
-                     (inputItr->second)[5],
-                     (inputItr->second)[6]);
+        rotation.Set(toolTransform[3],
+                     toolTransform[4],
+                     toolTransform[5],
+                     toolTransform[6]);
       }
 
     // report error value
@@ -220,19 +244,15 @@ AscensionTracker::ResultType AscensionTracker::InternalUpdateStatus()
     typedef TransformType::ErrorType  ErrorType;
     ErrorType errorValue = 0.0;
 
-    transform.SetToIdentity(this->GetValidityTime());
+    // the transform is valid from the arrival of its record
+    const double timeStamp = this->m_ToolTimeStampContainer[slot];
     transform.SetTranslationAndRotation(translation, rotation, errorValue,
-        this->GetValidityTime());
+        timeStamp, timeStamp + this->GetValidityTime());
 
     // set the raw transform
-    this->SetTrackerToolRawTransform(
-        trackerToolContainer[inputItr->first], transform );
-
-    this->SetTrackerToolTransformUpdate(
-        trackerToolContainer[inputItr->first], true );
-
-    ++inputItr;
+    this->SetTrackerToolRawTransform( slot, transform );
 
+    this->SetTrackerToolTransformUpdate( slot, true );
     }
 
   m_BufferLock->Unlock();
@@ -255,60 +275,126 @@ AscensionTracker::InternalThreadedUpdateStatus( void )
   // not loosing samples (after the delay, the sensor movement is 
   // reproduced without jumps). It's like the serial port buffer is not flushed
 
+  if ( m_Streaming )
+    {
+    return this->InternalThreadedUpdateStream();
+    }
+
   m_BufferLock->Lock();
 
-  typedef TrackerToolTransformContainerType::const_iterator  InputConstIterator;
-  InputConstIterator inputItr = this->m_ToolTransformBuffer.begin();
-  InputConstIterator inputEnd = this->m_ToolTransformBuffer.end();
+  const TrackerToolSlotType numberOfSlots =
+    static_cast< TrackerToolSlotType >( this->m_BirdAddressContainer.size() );
 
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
   {
-    this->m_ToolStatusContainer[inputItr->first] = 0;
+    const int birdAddress = this->m_BirdAddressContainer[slot];
 
-    if ( inputItr->first == "1" )
-       m_CommandInterpreter->RS232ToFBB(1);
-    if ( inputItr->first == "2" )
-       m_CommandInterpreter->RS232ToFBB(2);
-    if ( inputItr->first == "3" )
-       m_CommandInterpreter->RS232ToFBB(3);
-    if ( inputItr->first == "4" )
-       m_CommandInterpreter->RS232ToFBB(4);
+    if ( birdAddress < 0 )
+      {
+      continue;
+      }
+
+    this->m_ToolStatusContainer[slot] = 0;
+
+    if ( birdAddress > 0 )
+       m_CommandInterpreter->RS232ToFBB( birdAddress );
 
     m_CommandInterpreter->Point();
     m_CommandInterpreter->Update();
 
-    float offset[3];
-    m_CommandInterpreter->GetPosition(offset);
+    this->StoreRecord( slot, RealTimeClock::GetTimeStamp() );
+    } 
 
-    float quaternion[4];
-    m_CommandInterpreter->GetQuaternion(quaternion);
+  m_BufferLock->Unlock();
 
-    std::vector< double > transform;
+  return SUCCESS;
+}
 
-    transform.push_back( offset[0] ); 
-    transform.push_back( offset[1] );
-    transform.push_back( offset[2] );
+/** Parse the records streamed by the flock. The serial port is read
+ *  without holding the buffer lock, so that InternalUpdateStatus is not
+ *  blocked while a record arrives. */
+AscensionTracker::ResultType 
+AscensionTracker::InternalThreadedUpdateStream( void )
+{
+  // a record may arrive in several reads
+  while ( !m_CommandInterpreter->UpdateStream() )
+    {
+    const AscensionErrorCode error = m_CommandInterpreter->GetError();
+    if ( error == FB_TIMEOUT_ERROR && m_Communication->GetReactorMode() )
+      {
+      // the reactor passes the rest of the record when it arrives
+      return FAILURE;
+      }
+    if ( error != FB_NO_ERROR )
+      {
+      igstkLogMacro( WARNING, "AscensionTracker::InternalThreadedUpdateStream"
+                     ": " << m_CommandInterpreter->GetErrorMessage() << "\n");
+      return FAILURE;
+      }
+    }
 
-    // fob quaternion q0, q1, q2, and q3 where q0
-    // is the scaler component
-    // itk versor: void Set( T x, T y, T z, T w );
-    transform.push_back( quaternion[0] );
-    transform.push_back( quaternion[3] );
-    transform.push_back( quaternion[2] );
-    transform.push_back( quaternion[1] );
+  const double timeStamp = m_CommandInterpreter->GetRecordTimeStamp();
+  const int bird = m_CommandInterpreter->GetBird();
 
-    
-    this->m_ToolTransformBuffer[ inputItr->first ] = transform;
-    this->m_ToolStatusContainer[ inputItr->first ] = 1;
+  m_BufferLock->Lock();
 
-    inputItr++;
-    } 
+  const TrackerToolSlotType numberOfSlots =
+    static_cast< TrackerToolSlotType >( this->m_BirdAddressContainer.size() );
+
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
+    {
+    // a tool without a bird address is the first bird
+    const int birdAddress = this->m_BirdAddressContainer[slot];
+    if ( birdAddress == bird || ( birdAddress == 0 && bird == 1 ) )
+      {
+      this->StoreRecord( slot, timeStamp );
+      }
+    }
 
   m_BufferLock->Unlock();
 
   return SUCCESS;
 }
 
+/** In stream mode, the records can be parsed by a CommunicationReactor
+ *  as they arrive, instead of by the tracking thread. */
+Communication * AscensionTracker::GetReactorCommunication( void )
+{
+  if ( m_Streaming )
+    {
+    return m_Communication;
+    }
+  return NULL;
+}
+
+/** Store the last record in the buffer of a slot. */
+void AscensionTracker::StoreRecord( TrackerToolSlotType slot,
+                                    double timeStamp )
+{
+  float offset[3];
+  m_CommandInterpreter->GetPosition(offset);
+
+  float quaternion[4];
+  m_CommandInterpreter->GetQuaternion(quaternion);
+
+  double * transform = &this->m_ToolTransformBuffer[ slot * TransformSize ];
+
+  transform[0] = offset[0]; 
+  transform[1] = offset[1];
+  transform[2] = offset[2];
+
+  // fob quaternion q0, q1, q2, and q3 where q0
+  // is the scaler component
+  // itk versor: void Set( T x, T y, T z, T w );
+  transform[3] = quaternion[0];
+  transform[4] = quaternion[3];
+  transform[5] = quaternion[2];
+  transform[6] = quaternion[1];
+
+  this->m_ToolTimeStampContainer[ slot ] = timeStamp;
+  this->m_ToolStatusContainer[ slot ] = 1;
+}
+
 /** Enable all tool ports that are occupied. */
 void AscensionTracker::EnableToolPorts()
 {
@@ -341,12 +427,16 @@ AscensionTracker
     "AscensionTracker::RemoveTrackerToolFromInternalDataContainers"
     " called...\n");
 
-  const std::string trackerToolIdentifier =
-       trackerTool->GetTrackerToolIdentifier();
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
 
-  // remove the tool from the Transform buffer container
-  this->m_ToolTransformBuffer.erase( trackerToolIdentifier );
-  this->m_ToolStatusContainer.erase( trackerToolIdentifier );
+  if ( slot < this->m_BirdAddressContainer.size() )
+    {
+    m_BufferLock->Lock();
+    // free the slot
+    this->m_BirdAddressContainer[ slot ] = -1;
+    this->m_ToolStatusContainer[ slot ] = 0;
+    m_BufferLock->Unlock();
+    }
 
   return SUCCESS;
 }
@@ -364,20 +454,45 @@ AddTrackerToolToInternalDataContainers( const TrackerToolType * trackerTool )
     return FAILURE;
     }
 
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if ( slot == InvalidTrackerToolSlot )
+    {
+    return FAILURE;
+    }
+
+  // the birds are addressed by the identifiers "1" to "4"
   const std::string trackerToolIdentifier =
       trackerTool->GetTrackerToolIdentifier();
 
-  std::vector< double > transform;
-  transform.push_back( 1.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
+  int birdAddress = 0;
+  if ( trackerToolIdentifier.size() == 1 &&
+       trackerToolIdentifier[0] >= '1' && trackerToolIdentifier[0] <= '4' )
+    {
+    birdAddress = trackerToolIdentifier[0] - '0';
+    }
+
+  m_BufferLock->Lock();
 
-  this->m_ToolTransformBuffer[ trackerToolIdentifier ] = transform;
-  this->m_ToolStatusContainer[ trackerToolIdentifier ] = 0;
+  if ( slot >= this->m_BirdAddressContainer.size() )
+    {
+    this->m_BirdAddressContainer.resize( slot + 1, -1 );
+    this->m_ToolStatusContainer.resize( slot + 1, 0 );
+    this->m_ToolTimeStampContainer.resize( slot + 1, 0.0 );
+    this->m_ToolTransformBuffer.resize( ( slot + 1 ) * TransformSize, 0.0 );
+    }
+
+  double * transform = &this->m_ToolTransformBuffer[ slot * TransformSize ];
+  transform[0] = 1.0;
+  for ( unsigned int i = 1; i < TransformSize; i++ )
+    {
+    transform[i] = 0.0;
+    }
+
+  this->m_BirdAddressContainer[ slot ] = birdAddress;
+  this->m_ToolStatusContainer[ slot ] = 0;
+
+  m_BufferLock->Unlock();
 
   m_NumberOfTools ++;
 
@@ -389,6 +504,15 @@ void AscensionTracker::PrintSelf( std::ostream& os,
                                      itk::Indent indent ) const
 {
   Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfTools: " << m_NumberOfTools << std::endl;
+  os << indent << "StreamingMode: " << m_StreamingMode << std::endl;
+  os << indent << "Streaming: " << m_Streaming << std::endl;
+  if ( m_CommandInterpreter )
+    {
+    os << indent << "NumberOfPhaseErrors: "
+       << m_CommandInterpreter->GetNumberOfPhaseErrors() << std::endl;
+    }
 }
 
 } // end of namespace igstk
@@ -31,6 +31,14 @@ namespace igstk
  * This class provides an interface to Ascension Technology 
  * Corporation magnetic trackers.
  *
+ * By default every sample is requested with a point command, so each
+ * sample costs a full request and response on the serial port. In
+ * streaming mode the flock sends its records continuously, in group
+ * mode when several birds are attached, and the tracking thread parses
+ * them as they arrive. Each record is time stamped when it is received,
+ * and the stream is resynchronized on the phasing bit of the records
+ * after dropped or corrupted bytes.
+ *
  * \ingroup Tracker
  *
  */
@@ -57,6 +65,11 @@ public:
   /** Get the number of tools that have been detected. */
   igstkGetMacro( NumberOfTools, unsigned int );
 
+  /** Use the stream mode of the flock instead of requesting every
+   *  sample. Takes effect at the next start of tracking. Off by default. */
+  igstkSetMacro( StreamingMode, bool );
+  igstkGetMacro( StreamingMode, bool );
+
 protected:
 
   AscensionTracker(void);
@@ -106,6 +119,9 @@ protected:
   /** Reset the tracking device to put it back to its original state. */
   virtual ResultType InternalReset( void );
 
+  /** The communication streaming the records, when streaming */
+  virtual Communication * GetReactorCommunication( void );
+
   /** Print object information */
   virtual void PrintSelf( std::ostream& os, ::itk::Indent indent ) const; 
 
@@ -127,9 +143,22 @@ private:
   /** Disable all enabled tool ports. */
   void DisableToolPorts( void );
 
+  /** Update the transforms from the records streamed by the flock. */
+  ResultType InternalThreadedUpdateStream( void );
+
+  /** Store the last record of the command interpreter in the buffer of
+   *  a slot. The buffer must be locked. */
+  void StoreRecord( TrackerToolSlotType slot, double timeStamp );
+
   /** Total number of tools detected. */
   unsigned int   m_NumberOfTools;
 
+  /** Whether the next tracking uses the stream mode */
+  bool           m_StreamingMode;
+
+  /** Whether the flock is streaming for the current tracking */
+  bool           m_Streaming;
+
   /** The "Communication" instance */
   CommunicationType::Pointer       m_Communication;
 
@@ -142,12 +171,24 @@ private:
   /** The buffers for holding tool transforms */
   //TransformType m_TransformBuffer[NumberOfPorts];
 
-  /** A buffer to hold tool transforms */
-  typedef std::map< std::string, std::vector < double > >
-      TrackerToolTransformContainerType;
+  /** A buffer to hold tool transforms, indexed by the slot of the tracker
+   *  tools. The transform of a slot is stored in the seven values starting
+   *  at 7 * slot: the position, then the quaternion in x, y, z, w order. */
+  typedef std::vector< double >         TrackerToolTransformContainerType;
 
   TrackerToolTransformContainerType     m_ToolTransformBuffer;
 
+  /** Arrival time of the record in the buffer of each slot */
+  std::vector< double >                 m_ToolTimeStampContainer;
+
+  /** Number of values of a transform in the buffer */
+  itkStaticConstMacro( TransformSize, unsigned int, 7 );
+
+  /** Address of the bird of each slot on the Fast Bird Bus, parsed once
+   *  from the tracker tool identifier. Zero if the identifier is not a bird
+   *  address, and -1 for a free slot. */
+  std::vector< int >                    m_BirdAddressContainer;
+
   /** Error map container */
   typedef std::map< unsigned int, std::string>  ErrorCodeContainerType;
   static ErrorCodeContainerType   m_ErrorCodeContainer;
@@ -155,8 +196,8 @@ private:
   /** boolean to indicate if error code list is created */
   static bool m_ErrorCodeListCreated;
 
-  /** Container holding status of the tools */
-  std::map< std::string, int >  m_ToolStatusContainer;
+  /** Container holding status of the tools, indexed by slot */
+  std::vector< int >            m_ToolStatusContainer;
 
 };
 
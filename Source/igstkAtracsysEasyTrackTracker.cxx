@@ -24,6 +24,7 @@
 #include <sstream>
 #include <iostream>
 #include <fstream>
+#include <stdlib.h>
 
 #include "vtkMatrix4x4.h"
 
@@ -213,33 +214,32 @@ AtracsysEasyTrackTracker::ResultType AtracsysEasyTrackTracker::InternalUpdateSta
   // accessing it.
   m_BufferLock->Lock();
 
-  typedef TrackerToolTransformContainerType::const_iterator  InputConstIterator;
+  const TrackerToolSlotType numberOfSlots =
+    static_cast< TrackerToolSlotType >( this->m_ToolStatusContainer.size() );
 
-  InputConstIterator inputItr = this->m_ToolTransformBuffer.begin();
-  InputConstIterator inputEnd = this->m_ToolTransformBuffer.end();
-
-
-  TrackerToolsContainerType trackerToolContainer =
-    this->GetTrackerToolContainer();
-
-
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
+    if ( this->GetTrackerToolInSlot( slot ) == NULL )
+      {
+      continue;
+      }
+
     // only report tools that are in view
-    if (! this->m_ToolStatusContainer[inputItr->first])
+    if (! this->m_ToolStatusContainer[slot])
       {
       igstkLogMacro( DEBUG, "igstk::CertusTracker::InternalUpdateStatus: " <<
-                     "tool " << inputItr->first << " is not in view\n");
+                     "tool in slot " << slot << " is not in view\n");
 
       // report to the tracker tool that the tracker is not available
-      this->ReportTrackingToolNotAvailable(
-        trackerToolContainer[inputItr->first]);
+      this->ReportTrackingToolNotAvailable( slot );
 
-      ++inputItr;
       continue;
       }
     // report to the tracker tool that the tracker is Visible
-    this->ReportTrackingToolVisible(trackerToolContainer[inputItr->first]);
+    this->ReportTrackingToolVisible( slot );
+
+    const double * toolTransform =
+      &this->m_ToolTransformBuffer[ slot * TransformSize ];
 
     // create the transform
     TransformType transform;
@@ -247,9 +247,9 @@ AtracsysEasyTrackTracker::ResultType AtracsysEasyTrackTracker::InternalUpdateSta
     typedef TransformType::VectorType TranslationType;
     TranslationType translation;
 
-    translation[0] = (inputItr->second)[9];
-    translation[1] = (inputItr->second)[10];
-    translation[2] = (inputItr->second)[11];
+    translation[0] = toolTransform[9];
+    translation[1] = toolTransform[10];
+    translation[2] = toolTransform[11];
 
 
     typedef TransformType::VersorType RotationType;
@@ -257,36 +257,31 @@ AtracsysEasyTrackTracker::ResultType AtracsysEasyTrackTracker::InternalUpdateSta
 
     itk::Matrix<double,3,3> m;
 
-    m(0,0) = (inputItr->second)[0];
-    m(0,1) = (inputItr->second)[1];
-    m(0,2) = (inputItr->second)[2];
-    m(1,0) = (inputItr->second)[3];
-    m(1,1) = (inputItr->second)[4];
-    m(1,2) = (inputItr->second)[5];
-    m(2,0) = (inputItr->second)[6];
-    m(2,1) = (inputItr->second)[7];
-    m(2,2) = (inputItr->second)[8];
+    m(0,0) = toolTransform[0];
+    m(0,1) = toolTransform[1];
+    m(0,2) = toolTransform[2];
+    m(1,0) = toolTransform[3];
+    m(1,1) = toolTransform[4];
+    m(1,2) = toolTransform[5];
+    m(2,0) = toolTransform[6];
+    m(2,1) = toolTransform[7];
+    m(2,2) = toolTransform[8];
 
     rotation.Set(m);
 
     // report error value
     typedef TransformType::ErrorType  ErrorType;
     const int transformationError = 12;
-    ErrorType errorValue = (inputItr->second)[transformationError];
+    ErrorType errorValue = toolTransform[transformationError];
 
     transform.SetToIdentity(this->GetValidityTime());
     transform.SetTranslationAndRotation(translation, rotation, errorValue,
                                         this->GetValidityTime());
     // set the raw transform
-    this->SetTrackerToolRawTransform(
-      trackerToolContainer[inputItr->first], transform );
-
-    this->SetTrackerToolTransformUpdate(
-      trackerToolContainer[inputItr->first], true );
-
-    ++inputItr;
+    this->SetTrackerToolRawTransform( slot, transform );
 
-    }// while
+    this->SetTrackerToolTransformUpdate( slot, true );
+    }
 
   m_BufferLock->Unlock();
 
@@ -332,27 +327,49 @@ AddTrackerToolToInternalDataContainers( const TrackerToolType * trackerTool )
     return FAILURE;
     }
 
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if ( slot == InvalidTrackerToolSlot )
+    {
+    return FAILURE;
+    }
+
+  // the markers are reported by the device under their decimal id
   const std::string trackerToolIdentifier =
                     trackerTool->GetTrackerToolIdentifier();
 
-  std::vector< double > transform;
-  transform.push_back( 1.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 1.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 1.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 1.0 );
-
-  this->m_ToolTransformBuffer[ trackerToolIdentifier ] = transform;
-
-  this->m_ToolStatusContainer[ trackerToolIdentifier ] = 0;
+  int markerID = atoi( trackerToolIdentifier.c_str() );
+  char strMarkerID[128];
+  sprintf( strMarkerID, "%d", markerID );
+  if ( markerID < 0 || trackerToolIdentifier != strMarkerID )
+    {
+    markerID = -1;
+    }
+
+  m_BufferLock->Lock();
+
+  if ( slot >= this->m_ToolStatusContainer.size() )
+    {
+    this->m_ToolStatusContainer.resize( slot + 1, 0 );
+    this->m_MarkerIDContainer.resize( slot + 1, -1 );
+    this->m_ToolTransformBuffer.resize( ( slot + 1 ) * TransformSize, 0.0 );
+    }
+
+  // identity rotation, null translation and an error of 1
+  double * transform = &this->m_ToolTransformBuffer[ slot * TransformSize ];
+  for ( unsigned int i = 0; i < TransformSize; i++ )
+    {
+    transform[i] = 0.0;
+    }
+  transform[0] = 1.0;
+  transform[4] = 1.0;
+  transform[8] = 1.0;
+  transform[12] = 1.0;
+
+  this->m_ToolStatusContainer[ slot ] = 0;
+  this->m_MarkerIDContainer[ slot ] = markerID;
+
+  m_BufferLock->Unlock();
 
   return SUCCESS;
 }
@@ -367,12 +384,16 @@ RemoveTrackerToolFromInternalDataContainers
     "igstk::AtracsysEasyTrackTracker::RemoveTrackerToolFromInternalDataContainers "
                  "called ...\n");
 
-  const std::string trackerToolIdentifier =
-                      trackerTool->GetTrackerToolIdentifier();
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
 
-  // remove the tool from the Transform buffer container
-  this->m_ToolTransformBuffer.erase( trackerToolIdentifier );
-  this->m_ToolStatusContainer.erase( trackerToolIdentifier );
+  if ( slot < this->m_ToolStatusContainer.size() )
+    {
+    m_BufferLock->Lock();
+    // free the slot
+    this->m_ToolStatusContainer[ slot ] = 0;
+    this->m_MarkerIDContainer[ slot ] = -1;
+    m_BufferLock->Unlock();
+    }
 
   return SUCCESS;
 }
@@ -426,38 +447,38 @@ void AtracsysEasyTrackTracker::ObjectMarkerCallback( unsigned uMarkerID,
                                   double *adVector3,
                                   double *pdError )
 {
-  char strMarkerID[128];
-  sprintf(strMarkerID, "%d", uMarkerID);
-
-  TrackerToolsContainerType trackerToolContainer =
-    this->GetTrackerToolContainer();
+  // this is called from apiProcess() in the tracking thread, which holds
+  // the buffer lock
+  const TrackerToolSlotType numberOfSlots =
+    static_cast< TrackerToolSlotType >( this->m_MarkerIDContainer.size() );
+
+  TrackerToolSlotType slot = 0;
+  while( slot < numberOfSlots &&
+         this->m_MarkerIDContainer[slot] != static_cast< int >( uMarkerID ) )
+    {
+    ++slot;
+    }
 
-  if( ! trackerToolContainer.count(strMarkerID) )
+  if( slot == numberOfSlots )
     return;
 
   if (adMatrix33 && adVector3 && pdError){
     // has valid measurement, set data in tool buffer
-    this->m_ToolStatusContainer[strMarkerID] = 1;
-    std::vector<double> transform;
-
-    transform.push_back( adMatrix33[0] );
-    transform.push_back( adMatrix33[1] );
-    transform.push_back( adMatrix33[2] );
-    transform.push_back( adMatrix33[3] );
-    transform.push_back( adMatrix33[4] );
-    transform.push_back( adMatrix33[5] );
-    transform.push_back( adMatrix33[6] );
-    transform.push_back( adMatrix33[7] );
-    transform.push_back( adMatrix33[8] );
-    transform.push_back( adVector3[0] );
-    transform.push_back( adVector3[1] );
-    transform.push_back( adVector3[2] );
-    transform.push_back( *pdError );
-
-    this->m_ToolTransformBuffer[strMarkerID] = transform;
+    this->m_ToolStatusContainer[slot] = 1;
+
+    double * transform = &this->m_ToolTransformBuffer[ slot * TransformSize ];
+
+    for ( unsigned int i = 0; i < 9; i++ )
+      {
+      transform[i] = adMatrix33[i];
+      }
+    transform[9] = adVector3[0];
+    transform[10] = adVector3[1];
+    transform[11] = adVector3[2];
+    transform[12] = *pdError;
     }
   else {
-    this->m_ToolStatusContainer[strMarkerID] = 0;
+    this->m_ToolStatusContainer[slot] = 0;
     }
 }
 
@@ -156,14 +156,23 @@ private:
   /** Total number of tools detected. */
   unsigned int   m_NumberOfTools;    //CONTROLLA
 
-  /** A buffer to hold tool transforms */
-  typedef std::map< std::string, std::vector < double > >
-                                TrackerToolTransformContainerType;
+  /** A buffer to hold tool transforms, indexed by the slot of the tracker
+   *  tools. The transform of a slot is stored in the thirteen values
+   *  starting at 13 * slot: the rotation matrix in row order, the
+   *  translation and the error. */
+  typedef std::vector< double >         TrackerToolTransformContainerType;
 
   TrackerToolTransformContainerType     m_ToolTransformBuffer;
 
-  /** Container holding status of the tools */
-  std::map< std::string, int >  m_ToolStatusContainer;
+  /** Number of values of a transform in the buffer */
+  itkStaticConstMacro( TransformSize, unsigned int, 13 );
+
+  /** Container holding status of the tools, indexed by slot */
+  std::vector< int >            m_ToolStatusContainer;
+
+  /** Marker id of each slot, parsed once from the tracker tool identifier.
+   *  -1 for a free slot or an identifier that is not a marker id. */
+  std::vector< int >            m_MarkerIDContainer;
 
   static AtracsysEasyTrackTracker *m_TrackerObject;
   static bool               m_BTrackingEnabled;
@@ -62,6 +62,11 @@ m_StateMachine(this), m_MetrologySystems(0), m_Metrology(0)
   m_BufferLock = itk::MutexLock::New();
   metro_lib::MetroUtils::AddReceiver(&m_Mwr);
 
+  // when threading is enabled, measure at the rate of the cameras
+  // rather than as fast as the measurements return
+  this->SetTrackingLoopPacing( FixedRateTrackingLoop );
+  this->SetTrackingLoopFrequency( 90 );
+
   CreateObject();
 }
 
@@ -1027,24 +1032,24 @@ Axios3DTracker::ResultType Axios3DTracker::InternalUpdateStatus( void )
 
   this->m_BufferLock->Lock ();
 
-  TrackerToolsContainerType trackerToolContainer = GetTrackerToolContainer();
   try{
     std::list<std::string>::const_iterator it = m_LoadedLocators.begin();
     for (; it!= m_LoadedLocators.end(); ++it)
       {
-      LocatorResult lockResult = m_LocatorResultsContainer[*(it)];
+      const LocatorResult & lockResult = m_LocatorResultsContainer[*(it)];
+
+      // the locators are named after the tracker tool they are attached to
+      const TrackerToolSlotType slot = this->GetTrackerToolSlot( *(it) );
 
-      if(lockResult.m_IsVisible && trackerToolContainer[*(it)])
+      if(lockResult.m_IsVisible && slot != InvalidTrackerToolSlot)
         {
         // report to the tracker tool that the tracker is Visible
-      this->ReportTrackingToolVisible(trackerToolContainer[*(it)]);
+        this->ReportTrackingToolVisible( slot );
 
         // set the raw transform
-        this->SetTrackerToolRawTransform(
-                          trackerToolContainer [*(it)], lockResult.m_Transform );
+        this->SetTrackerToolRawTransform( slot, lockResult.m_Transform );
 
-        this->SetTrackerToolTransformUpdate(
-                                          trackerToolContainer [*(it)], true );
+        this->SetTrackerToolTransformUpdate( slot, true );
         }
       }
 
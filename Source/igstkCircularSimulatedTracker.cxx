@@ -86,14 +86,6 @@ CircularSimulatedTracker::InternalUpdateStatus( void )
   igstkLogMacro( DEBUG,
     "CircularSimulatedTracker::InternalUpdateStatus called ...\n");
 
-  typedef TrackerToolsContainerType::const_iterator  ConstIteratorType;
-
-  TrackerToolsContainerType trackerToolContainer =
-    this->GetTrackerToolContainer();
-
-  ConstIteratorType inputItr = trackerToolContainer.begin();
-  ConstIteratorType inputEnd = trackerToolContainer.end();
-
   TransformType transform;
 
   transform.SetToIdentity( this->GetValidityTime() );
@@ -110,15 +102,14 @@ CircularSimulatedTracker::InternalUpdateStatus( void )
   transform.SetTranslation( position, errorValue, this->GetValidityTime() );
 
   // set the raw transform in all the tracker tools
-  while( inputItr != inputEnd )
+  const TrackerToolSlotType numberOfSlots = this->GetNumberOfTrackerToolSlots();
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
-    this->SetTrackerToolRawTransform(
-      trackerToolContainer[inputItr->first], transform );
-
-    this->SetTrackerToolTransformUpdate(
-      trackerToolContainer[inputItr->first], true );
-
-    ++inputItr;
+    if( this->GetTrackerToolInSlot( slot ) )
+      {
+      this->SetTrackerToolRawTransform( slot, transform );
+      this->SetTrackerToolTransformUpdate( slot, true );
+      }
     }
 
   const double MillisecondsToSeconds = 1.0 / 1000.0;
@@ -0,0 +1,226 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkColorMappedSliceCache.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkColorMappedSliceCache.h"
+#include "igstkSliceColorMapper.h"
+
+#include "vtkImageData.h"
+
+#include <map>
+
+namespace igstk
+{
+
+namespace
+{
+
+/** Colour mapped slice and the number of representations using it */
+struct SliceEntryType
+{
+  SliceColorMapper *     m_Mapper;
+  vtkImageData *         m_Slice;
+  unsigned long          m_ImageTime;
+  unsigned int           m_UseCount;
+};
+
+typedef std::map< ColorMappedSliceCache::KeyType, SliceEntryType >
+                                                           SliceMapType;
+
+/** The map is created on first use, to avoid depending on the order of
+ *  the static initializations */
+SliceMapType & GetSlices()
+{
+  static SliceMapType slices;
+  return slices;
+}
+
+/** Colour the slice of an entry with the parameters of its key */
+void ColorSlice( const ColorMappedSliceCache::KeyType & key,
+                 SliceEntryType & entry )
+{
+  entry.m_Mapper->SetWindowLevel( key.m_Window, key.m_Level );
+  entry.m_Mapper->SetColor( key.m_Hue, key.m_Saturation, key.m_Value,
+                            key.m_Opacity );
+  entry.m_ImageTime = key.m_Image->GetMTime();
+  entry.m_Mapper->MapSlice( key.m_Image, key.m_Extent, entry.m_Slice );
+}
+
+/** Delete the colour mapping of an entry */
+void DeleteEntry( SliceEntryType & entry )
+{
+  entry.m_Slice->Delete();
+  delete entry.m_Mapper;
+}
+
+}
+
+ColorMappedSliceCache::KeyType::KeyType()
+{
+  m_Image = NULL;
+  for( unsigned int i = 0; i < 6; i++ )
+    {
+    m_Extent[i] = 0;
+    }
+  m_Window = 0.0;
+  m_Level = 0.0;
+  m_Hue = 0.0;
+  m_Saturation = 0.0;
+  m_Value = 0.0;
+  m_Opacity = 0.0;
+}
+
+bool ColorMappedSliceCache::KeyType::operator<( const KeyType & key ) const
+{
+  if( m_Image != key.m_Image )
+    {
+    return m_Image < key.m_Image;
+    }
+  for( unsigned int i = 0; i < 6; i++ )
+    {
+    if( m_Extent[i] != key.m_Extent[i] )
+      {
+      return m_Extent[i] < key.m_Extent[i];
+      }
+    }
+  const double values[6] = { m_Window, m_Level, m_Hue, m_Saturation,
+                             m_Value, m_Opacity };
+  const double keyValues[6] = { key.m_Window, key.m_Level, key.m_Hue,
+                                key.m_Saturation, key.m_Value,
+                                key.m_Opacity };
+  for( unsigned int i = 0; i < 6; i++ )
+    {
+    if( values[i] != keyValues[i] )
+      {
+      return values[i] < keyValues[i];
+      }
+    }
+  return false;
+}
+
+bool ColorMappedSliceCache::KeyType::operator==( const KeyType & key ) const
+{
+  return !( *this < key ) && !( key < *this );
+}
+
+vtkImageData * ColorMappedSliceCache::Acquire( const KeyType & key )
+{
+  if( !key.m_Image )
+    {
+    return NULL;
+    }
+
+  SliceMapType & slices = GetSlices();
+  SliceMapType::iterator it = slices.find( key );
+  if( it == slices.end() )
+    {
+    SliceEntryType entry;
+    entry.m_Mapper = new SliceColorMapper;
+    entry.m_Slice = vtkImageData::New();
+    entry.m_UseCount = 0;
+    ColorSlice( key, entry );
+    it = slices.insert( SliceMapType::value_type( key, entry ) ).first;
+    }
+
+  it->second.m_UseCount++;
+  return it->second.m_Slice;
+}
+
+void ColorMappedSliceCache::Release( const KeyType & key )
+{
+  SliceMapType & slices = GetSlices();
+  SliceMapType::iterator it = slices.find( key );
+  if( it == slices.end() )
+    {
+    return;
+    }
+
+  if( --it->second.m_UseCount == 0 )
+    {
+    DeleteEntry( it->second );
+    slices.erase( it );
+    }
+}
+
+vtkImageData * ColorMappedSliceCache::Exchange( const KeyType & oldKey,
+                                                const KeyType & newKey )
+{
+  SliceMapType & slices = GetSlices();
+  SliceMapType::iterator oldIt = slices.find( oldKey );
+  if( oldIt == slices.end() || oldKey == newKey ||
+      oldIt->second.m_UseCount > 1 || !newKey.m_Image ||
+      slices.find( newKey ) != slices.end() )
+    {
+    vtkImageData * slice = Acquire( newKey );
+    Release( oldKey );
+    return slice;
+    }
+
+  // The slice is only used by the caller, it is coloured again in place
+  SliceEntryType entry = oldIt->second;
+  slices.erase( oldIt );
+  ColorSlice( newKey, entry );
+  slices.insert( SliceMapType::value_type( newKey, entry ) );
+  return entry.m_Slice;
+}
+
+void ColorMappedSliceCache::Update( const KeyType & key )
+{
+  SliceMapType & slices = GetSlices();
+  SliceMapType::iterator it = slices.find( key );
+  if( it == slices.end() )
+    {
+    return;
+    }
+
+  key.m_Image->Update();
+  if( key.m_Image->GetMTime() > it->second.m_ImageTime )
+    {
+    ColorSlice( key, it->second );
+    }
+}
+
+unsigned int ColorMappedSliceCache::GetNumberOfSlices()
+{
+  return GetSlices().size();
+}
+
+void ColorMappedSliceCache::Print( std::ostream & os )
+{
+  const SliceMapType & slices = GetSlices();
+  os << "ColorMappedSliceCache: " << slices.size() << " slices" << std::endl;
+
+  SliceMapType::const_iterator it = slices.begin();
+  while( it != slices.end() )
+    {
+    const KeyType & key = it->first;
+    os << "  Image " << key.m_Image << " extent ("
+       << key.m_Extent[0] << "," << key.m_Extent[1] << ","
+       << key.m_Extent[2] << "," << key.m_Extent[3] << ","
+       << key.m_Extent[4] << "," << key.m_Extent[5] << ") window "
+       << key.m_Window << " level " << key.m_Level << " used by "
+       << it->second.m_UseCount << std::endl;
+    ++it;
+    }
+}
+
+} // end namespace igstk
@@ -0,0 +1,104 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkColorMappedSliceCache.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkColorMappedSliceCache_h
+#define __igstkColorMappedSliceCache_h
+
+#include <iostream>
+
+class vtkImageData;
+
+namespace igstk
+{
+
+/** \class ColorMappedSliceCache
+ *
+ * \brief Colour mapped slices shared by the image representations.
+ *
+ * The vtkImageData reported by an ImageSpatialObject already shares the
+ * buffer of the ITK image. The colour mapping is the only copy made for
+ * display, and this class makes it once per slice and per window/level:
+ * representations of the same image, displayed in several Views with the
+ * same slice, window, level and colour, get the very same RGBA output.
+ *
+ * A slice is acquired with its parameters, exchanged for another one when
+ * any of them changes, and released when the representation is destroyed.
+ * The slices are coloured by a SliceColorMapper, only over their extent.
+ * When a representation exchanges a slice that no other representation
+ * uses, the slice is coloured again in place: its buffer is reused while
+ * the window/level is dragged or the slice number changes.
+ *
+ * The cache is not thread safe, it is meant to be used by the
+ * representations from the thread that renders the Views.
+ *
+ * \ingroup ObjectRepresentation
+ */
+class ColorMappedSliceCache
+{
+
+public:
+
+  /** Parameters of a colour mapped slice */
+  struct KeyType
+    {
+    vtkImageData *  m_Image;
+    int             m_Extent[6];
+    double          m_Window;
+    double          m_Level;
+    double          m_Hue;
+    double          m_Saturation;
+    double          m_Value;
+    double          m_Opacity;
+
+    KeyType();
+    bool operator<( const KeyType & key ) const;
+    bool operator==( const KeyType & key ) const;
+    };
+
+  /** Return the colour mapped slice for these parameters, creating it if
+   *  no representation uses it yet. Every call must be matched by a call
+   *  to Release(). Returns NULL if the key has no image. */
+  static vtkImageData * Acquire( const KeyType & key );
+
+  /** Release a slice obtained with Acquire() */
+  static void Release( const KeyType & key );
+
+  /** Release a slice and acquire another one. The released slice is
+   *  reused if it is not shared. */
+  static vtkImageData * Exchange( const KeyType & oldKey,
+                                  const KeyType & newKey );
+
+  /** Colour the slice again if its image was modified since */
+  static void Update( const KeyType & key );
+
+  /** Number of distinct slices in use */
+  static unsigned int GetNumberOfSlices();
+
+  /** Print the slices in use */
+  static void Print( std::ostream & os );
+
+private:
+
+  ColorMappedSliceCache();                        //purposely not implemented
+  ColorMappedSliceCache(const ColorMappedSliceCache &);
+                                                  //purposely not implemented
+  void operator=(const ColorMappedSliceCache &);  //purposely not implemented
+};
+
+} // end namespace igstk
+
+#endif // __igstkColorMappedSliceCache_h
@@ -32,6 +32,7 @@ Communication::Communication( void ):m_StateMachine(this)
   m_TimeoutPeriod = 5000;
   m_ReadTerminationCharacter = 255;
   m_UseReadTerminationCharacter = false;
+  m_ReactorMode = false;
 }
 
 Communication::~Communication( void )
@@ -54,6 +55,105 @@ Communication::ResultType Communication::CloseCommunication( void )
  return SUCCESS;
 }
 
+int Communication::GetReactorDescriptor( void ) const
+{
+  return -1;
+}
+
+bool Communication::GetReactorMode( void ) const
+{
+  m_ReactorLock.Lock();
+  const bool reactorMode = m_ReactorMode;
+  m_ReactorLock.Unlock();
+  return reactorMode;
+}
+
+void Communication::SetReactorMode( bool reactorMode )
+{
+  m_ReactorLock.Lock();
+  m_ReactorMode = reactorMode;
+  m_ReactorBuffer.clear();
+  m_ReactorLock.Unlock();
+}
+
+void Communication::ReceiveFromReactor( const char * data,
+                                        unsigned int numberOfBytes )
+{
+  // a device that nobody reads from should not fill the memory
+  const std::string::size_type maximumSize = 65536;
+
+  m_ReactorLock.Lock();
+  m_ReactorBuffer.append( data, numberOfBytes );
+  const std::string::size_type size = m_ReactorBuffer.size();
+  if( size > maximumSize )
+    {
+    m_ReactorBuffer.erase( 0, size - maximumSize );
+    }
+  m_ReactorLock.Unlock();
+
+  if( size > maximumSize )
+    {
+    igstkLogMacro( WARNING, "Communication::ReceiveFromReactor: "
+                   << size - maximumSize << " bytes discarded\n" );
+    }
+}
+
+bool Communication::HasReactorReply( void ) const
+{
+  m_ReactorLock.Lock();
+  const bool reply = !m_ReactorBuffer.empty() &&
+    ( !m_UseReadTerminationCharacter ||
+      m_ReactorBuffer.find( m_ReadTerminationCharacter ) !=
+      std::string::npos );
+  m_ReactorLock.Unlock();
+  return reply;
+}
+
+unsigned int Communication::GetReactorBufferSize( void ) const
+{
+  m_ReactorLock.Lock();
+  const unsigned int size =
+    static_cast< unsigned int >( m_ReactorBuffer.size() );
+  m_ReactorLock.Unlock();
+  return size;
+}
+
+Communication::ResultType
+Communication::ReadFromReactor( char * data, unsigned int numberOfBytes,
+                                unsigned int & bytesRead )
+{
+  bool complete = ( numberOfBytes == 0 );
+
+  m_ReactorLock.Lock();
+  unsigned int i = 0;
+  while( i < numberOfBytes && i < m_ReactorBuffer.size() )
+    {
+    data[i] = m_ReactorBuffer[i];
+    i++;
+    if( i == numberOfBytes ||
+        ( m_UseReadTerminationCharacter &&
+          data[i-1] == m_ReadTerminationCharacter ) )
+      {
+      complete = true;
+      break;
+      }
+    }
+  m_ReactorBuffer.erase( 0, i );
+  m_ReactorLock.Unlock();
+
+  bytesRead = i;
+  data[i] = '\0';
+
+  return complete ? SUCCESS : TIMEOUT;
+}
+
+void Communication::ClearReactorBuffer( void )
+{
+  m_ReactorLock.Lock();
+  m_ReactorBuffer.clear();
+  m_ReactorLock.Unlock();
+}
+
 void Communication::PrintSelf(std::ostream &os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os,indent);
@@ -66,6 +166,7 @@ void Communication::PrintSelf(std::ostream &os, itk::Indent indent) const
   os << indent << "UseReadTerminationCharacter: "
      << m_UseReadTerminationCharacter 
      << std::endl;
+  os << indent << "ReactorMode: " << this->GetReactorMode() << std::endl;
 }
 
 }
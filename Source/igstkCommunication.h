@@ -23,9 +23,16 @@
 #include "igstkMacros.h"
 #include "igstkStateMachine.h"
 
+#include "itkMutexLock.h"
+
+#include <string>
+
 
 namespace igstk
 {
+
+class CommunicationReactor;
+
 /** \class Communication
     \brief Class Communication is the base class for communication between
     the tracker class and the hardware tracking device. This communication
@@ -85,6 +92,14 @@ public:
                            unsigned int /* numberOfBytes */,
                            unsigned int & /* bytesRead */ ) { return SUCCESS; } 
 
+  /** Descriptor that a CommunicationReactor can wait on for the data of
+   *  this communication, or -1 if it cannot be added to a reactor. */
+  virtual int GetReactorDescriptor( void ) const;
+
+  /** Whether the communication is in a CommunicationReactor, and reads
+   *  from the buffer that the reactor fills. */
+  bool GetReactorMode( void ) const;
+
 protected:
 
   /** Constructor is protected in order to enforce 
@@ -96,13 +111,37 @@ protected:
   /** Print object information */
   virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const; 
 
+  /** Read from the buffer filled by the reactor, like a Read() of the
+   *  device that would not wait: the bytes are read up to numberOfBytes
+   *  or the termination character, and TIMEOUT is returned if there are
+   *  not enough of them yet. To be used by the InternalRead() of the
+   *  subclasses in reactor mode. */
+  ResultType ReadFromReactor( char * data, unsigned int numberOfBytes,
+                              unsigned int & bytesRead );
+
+  /** Discard the data received by the reactor */
+  void ClearReactorBuffer( void );
+
 private:
 
+  friend class CommunicationReactor;
+
+  /** Called by the reactor */
+  void SetReactorMode( bool reactorMode );
+  void ReceiveFromReactor( const char * data, unsigned int numberOfBytes );
+  bool HasReactorReply( void ) const;
+  unsigned int GetReactorBufferSize( void ) const;
+
   unsigned int m_TimeoutPeriod;
 
   char m_ReadTerminationCharacter;
 
   bool m_UseReadTerminationCharacter;
+
+  /** Data received by the reactor and not read yet */
+  bool                            m_ReactorMode;
+  std::string                     m_ReactorBuffer;
+  mutable itk::SimpleMutexLock    m_ReactorLock;
 };
 
 } // end of namespace igstk
@@ -0,0 +1,461 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkCommunicationReactor.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkCommunicationReactor.h"
+
+#if !defined(WIN32) && !defined(_WIN32)
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/select.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+#endif
+
+namespace igstk
+{
+
+CommunicationReactor::CommunicationReactor():m_StateMachine(this)
+{
+  m_Threader = itk::MultiThreader::New();
+  m_ThreadID = 0;
+  m_ThreadStarted = false;
+  m_PollDescriptor = -1;
+  m_WakeUpDescriptors[0] = -1;
+  m_WakeUpDescriptors[1] = -1;
+
+  m_NumberOfWakeUps = 0;
+  m_NumberOfBytesRead = 0;
+  m_NumberOfReplies = 0;
+}
+
+CommunicationReactor::~CommunicationReactor()
+{
+  // give the communications back their blocking reads
+  while( !m_Entries.empty() )
+    {
+    this->RemoveCommunication( m_Entries.begin()->second.CommunicationPointer );
+    }
+  this->StopThread();
+}
+
+CommunicationReactor::ResultType
+CommunicationReactor::AddCommunication( Communication * communication,
+                                        ReplyHandler * handler )
+{
+#if defined(WIN32) || defined(_WIN32)
+
+  igstkLogMacro( WARNING, "CommunicationReactor::AddCommunication: "
+                 "not supported on this platform\n" );
+  return Communication::FAILURE;
+
+#else
+
+  const int descriptor =
+    ( communication != NULL ) ? communication->GetReactorDescriptor() : -1;
+  if( descriptor < 0 || handler == NULL )
+    {
+    igstkLogMacro( WARNING, "CommunicationReactor::AddCommunication: "
+                   "the communication has no descriptor\n" );
+    return Communication::FAILURE;
+    }
+
+  if( !m_ThreadStarted && !this->StartThread() )
+    {
+    return Communication::FAILURE;
+    }
+
+  m_Lock.Lock();
+
+  if( m_Entries.find( descriptor ) != m_Entries.end() )
+    {
+    m_Lock.Unlock();
+    igstkLogMacro( WARNING, "CommunicationReactor::AddCommunication: "
+                   "the communication was already added\n" );
+    return Communication::FAILURE;
+    }
+
+  EntryType entry;
+  entry.CommunicationPointer = communication;
+  entry.Handler = handler;
+  entry.HungUp = false;
+  entry.Flags = fcntl( descriptor, F_GETFL, 0 );
+  if( entry.Flags == -1 ||
+      fcntl( descriptor, F_SETFL, entry.Flags | O_NONBLOCK ) == -1 )
+    {
+    m_Lock.Unlock();
+    igstkLogMacro( WARNING, "CommunicationReactor::AddCommunication: "
+                   "cannot make the descriptor non-blocking\n" );
+    return Communication::FAILURE;
+    }
+
+#if defined(__linux__)
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = descriptor;
+  if( epoll_ctl( m_PollDescriptor, EPOLL_CTL_ADD, descriptor, &event ) == -1 )
+    {
+    fcntl( descriptor, F_SETFL, entry.Flags );
+    m_Lock.Unlock();
+    igstkLogMacro( WARNING, "CommunicationReactor::AddCommunication: "
+                   "cannot wait on the descriptor\n" );
+    return Communication::FAILURE;
+    }
+#endif
+
+  communication->SetReactorMode( true );
+  m_Entries[descriptor] = entry;
+
+  m_Lock.Unlock();
+
+  // select waits on the descriptors it was given, it has to start again
+  this->WakeUp();
+
+  return Communication::SUCCESS;
+
+#endif
+}
+
+CommunicationReactor::ResultType
+CommunicationReactor::RemoveCommunication( Communication * communication )
+{
+  m_Lock.Lock();
+
+  EntryContainerType::iterator it = m_Entries.begin();
+  while( it != m_Entries.end() &&
+         it->second.CommunicationPointer != communication )
+    {
+    ++it;
+    }
+  if( it == m_Entries.end() )
+    {
+    m_Lock.Unlock();
+    return Communication::FAILURE;
+    }
+
+#if !defined(WIN32) && !defined(_WIN32)
+  const int descriptor = it->first;
+#if defined(__linux__)
+  if( !it->second.HungUp )
+    {
+    struct epoll_event event;
+    epoll_ctl( m_PollDescriptor, EPOLL_CTL_DEL, descriptor, &event );
+    }
+#endif
+  fcntl( descriptor, F_SETFL, it->second.Flags );
+#endif
+
+  communication->SetReactorMode( false );
+  m_Entries.erase( it );
+
+  m_Lock.Unlock();
+
+  return Communication::SUCCESS;
+}
+
+unsigned int CommunicationReactor::GetNumberOfCommunications() const
+{
+  m_Lock.Lock();
+  const unsigned int number = static_cast< unsigned int >( m_Entries.size() );
+  m_Lock.Unlock();
+  return number;
+}
+
+unsigned long CommunicationReactor::GetNumberOfWakeUps() const
+{
+  m_Lock.Lock();
+  const unsigned long number = m_NumberOfWakeUps;
+  m_Lock.Unlock();
+  return number;
+}
+
+unsigned long CommunicationReactor::GetNumberOfBytesRead() const
+{
+  m_Lock.Lock();
+  const unsigned long number = m_NumberOfBytesRead;
+  m_Lock.Unlock();
+  return number;
+}
+
+unsigned long CommunicationReactor::GetNumberOfReplies() const
+{
+  m_Lock.Lock();
+  const unsigned long number = m_NumberOfReplies;
+  m_Lock.Unlock();
+  return number;
+}
+
+bool CommunicationReactor::StartThread()
+{
+#if defined(WIN32) || defined(_WIN32)
+  return false;
+#else
+  if( pipe( m_WakeUpDescriptors ) == -1 )
+    {
+    igstkLogMacro( CRITICAL, "CommunicationReactor: cannot create a pipe\n" );
+    return false;
+    }
+  fcntl( m_WakeUpDescriptors[0], F_SETFL,
+         fcntl( m_WakeUpDescriptors[0], F_GETFL, 0 ) | O_NONBLOCK );
+  fcntl( m_WakeUpDescriptors[1], F_SETFL,
+         fcntl( m_WakeUpDescriptors[1], F_GETFL, 0 ) | O_NONBLOCK );
+
+#if defined(__linux__)
+  m_PollDescriptor = epoll_create( 16 );
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = m_WakeUpDescriptors[0];
+  if( m_PollDescriptor == -1 ||
+      epoll_ctl( m_PollDescriptor, EPOLL_CTL_ADD, m_WakeUpDescriptors[0],
+                 &event ) == -1 )
+    {
+    igstkLogMacro( CRITICAL, "CommunicationReactor: cannot create an "
+                   "epoll instance\n" );
+    if( m_PollDescriptor != -1 )
+      {
+      close( m_PollDescriptor );
+      m_PollDescriptor = -1;
+      }
+    close( m_WakeUpDescriptors[0] );
+    close( m_WakeUpDescriptors[1] );
+    m_WakeUpDescriptors[0] = -1;
+    m_WakeUpDescriptors[1] = -1;
+    return false;
+    }
+#endif
+
+  m_ThreadID = m_Threader->SpawnThread( ReactorThreadFunction, this );
+  m_ThreadStarted = true;
+  return true;
+#endif
+}
+
+void CommunicationReactor::StopThread()
+{
+  if( !m_ThreadStarted )
+    {
+    return;
+    }
+
+  // the thread checks its active flag after each wake up
+  m_Threader->TerminateThread( m_ThreadID );
+  m_ThreadStarted = false;
+
+#if !defined(WIN32) && !defined(_WIN32)
+  if( m_PollDescriptor != -1 )
+    {
+    close( m_PollDescriptor );
+    m_PollDescriptor = -1;
+    }
+  close( m_WakeUpDescriptors[0] );
+  close( m_WakeUpDescriptors[1] );
+  m_WakeUpDescriptors[0] = -1;
+  m_WakeUpDescriptors[1] = -1;
+#endif
+}
+
+void CommunicationReactor::WakeUp()
+{
+#if !defined(WIN32) && !defined(_WIN32)
+  if( m_WakeUpDescriptors[1] != -1 )
+    {
+    const char byte = 0;
+    // if the pipe is full, the thread has a wake up pending anyway
+    if( write( m_WakeUpDescriptors[1], &byte, 1 ) == -1 )
+      {
+      return;
+      }
+    }
+#endif
+}
+
+bool CommunicationReactor::WaitAndDispatch()
+{
+#if defined(WIN32) || defined(_WIN32)
+  return false;
+#else
+
+  // wake up regularly, to check whether the thread is to stop
+  const int timeout = 100;
+
+#if defined(__linux__)
+  struct epoll_event events[16];
+  const int n = epoll_wait( m_PollDescriptor, events, 16, timeout );
+  if( n == -1 )
+    {
+    return ( errno == EINTR );
+    }
+
+  m_Lock.Lock();
+  m_NumberOfWakeUps++;
+  for( int i = 0; i < n; i++ )
+    {
+    this->ReadAndDispatch( events[i].data.fd );
+    }
+  m_Lock.Unlock();
+#else
+  fd_set descriptors;
+  FD_ZERO( &descriptors );
+  FD_SET( m_WakeUpDescriptors[0], &descriptors );
+  int largest = m_WakeUpDescriptors[0];
+  m_Lock.Lock();
+  EntryContainerType::const_iterator it;
+  for( it = m_Entries.begin(); it != m_Entries.end(); ++it )
+    {
+    if( it->second.HungUp )
+      {
+      continue;
+      }
+    FD_SET( it->first, &descriptors );
+    largest = ( it->first > largest ) ? it->first : largest;
+    }
+  m_Lock.Unlock();
+
+  struct timeval tval;
+  tval.tv_sec = 0;
+  tval.tv_usec = timeout * 1000;
+  const int n = select( largest + 1, &descriptors, NULL, NULL, &tval );
+  if( n == -1 )
+    {
+    return ( errno == EINTR );
+    }
+
+  m_Lock.Lock();
+  m_NumberOfWakeUps++;
+  for( int descriptor = 0; descriptor <= largest; descriptor++ )
+    {
+    if( FD_ISSET( descriptor, &descriptors ) )
+      {
+      this->ReadAndDispatch( descriptor );
+      }
+    }
+  m_Lock.Unlock();
+#endif
+
+  return true;
+#endif
+}
+
+void CommunicationReactor::ReadAndDispatch( int descriptor )
+{
+#if !defined(WIN32) && !defined(_WIN32)
+  char buffer[4096];
+
+  if( descriptor == m_WakeUpDescriptors[0] )
+    {
+    while( read( descriptor, buffer, sizeof( buffer ) ) > 0 )
+      {
+      }
+    return;
+    }
+
+  // the communication may have been removed during the wait
+  EntryContainerType::iterator it = m_Entries.find( descriptor );
+  if( it == m_Entries.end() )
+    {
+    return;
+    }
+  Communication * communication = it->second.CommunicationPointer;
+
+  int n = read( descriptor, buffer, sizeof( buffer ) );
+  if( n == 0 )
+    {
+    // readable without data: the device hung up, stop waiting on it
+    // until it is removed
+    it->second.HungUp = true;
+#if defined(__linux__)
+    struct epoll_event event;
+    epoll_ctl( m_PollDescriptor, EPOLL_CTL_DEL, descriptor, &event );
+#endif
+    igstkLogMacro( WARNING, "CommunicationReactor: the device of "
+                   "descriptor " << descriptor << " hung up\n" );
+    }
+  while( n > 0 )
+    {
+    communication->ReceiveFromReactor( buffer, n );
+    m_NumberOfBytesRead += n;
+    n = read( descriptor, buffer, sizeof( buffer ) );
+    }
+
+  // the handler is called again as long as it makes progress
+  while( communication->HasReactorReply() )
+    {
+    const unsigned int size = communication->GetReactorBufferSize();
+    it->second.Handler->ProcessReply( communication );
+    m_NumberOfReplies++;
+    if( communication->GetReactorBufferSize() >= size )
+      {
+      break;
+      }
+    }
+#endif
+}
+
+ITK_THREAD_RETURN_TYPE
+CommunicationReactor::ReactorThreadFunction( void* pInfoStruct )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)pInfoStruct;
+
+  if( pInfo == NULL || pInfo->UserData == NULL )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  CommunicationReactor * reactor = (CommunicationReactor*)pInfo->UserData;
+
+  int activeFlag = 1;
+  while( activeFlag )
+    {
+    if( !reactor->WaitAndDispatch() )
+      {
+      igstkLogMacroStatic( reactor, CRITICAL, "CommunicationReactor: "
+                           "wait failed, the thread stops\n" );
+      break;
+      }
+
+    pInfo->ActiveFlagLock->Lock();
+    activeFlag = *pInfo->ActiveFlag;
+    pInfo->ActiveFlagLock->Unlock();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void CommunicationReactor::PrintSelf( std::ostream& os,
+                                      itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfCommunications: "
+     << this->GetNumberOfCommunications() << std::endl;
+  os << indent << "NumberOfWakeUps: " << this->GetNumberOfWakeUps()
+     << std::endl;
+  os << indent << "NumberOfBytesRead: " << this->GetNumberOfBytesRead()
+     << std::endl;
+  os << indent << "NumberOfReplies: " << this->GetNumberOfReplies()
+     << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkCommunicationReactor.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkCommunicationReactor_h
+#define __igstkCommunicationReactor_h
+
+#include "igstkObject.h"
+#include "igstkCommunication.h"
+
+#include "itkMultiThreader.h"
+#include "itkMutexLock.h"
+
+#include <map>
+
+namespace igstk
+{
+
+/** \class CommunicationReactor
+ *  \brief A single thread receiving the data of many communications.
+ *
+ *  Every tracker usually owns a thread that blocks in the Read() of its
+ *  communication. The reactor replaces these threads with a single one,
+ *  which waits on the descriptors of all the communications added to it
+ *  (with epoll on Linux, and select on the other POSIX systems), reads
+ *  whatever has arrived without blocking, and appends it to the receive
+ *  buffer of the communication. While a communication is in a reactor,
+ *  its Read() takes the data from this buffer and never blocks.
+ *
+ *  When the buffer of a communication holds a complete reply, that is
+ *  up to the read termination character if the communication uses one,
+ *  or any data otherwise, the reply handler of the communication is
+ *  called in the reactor thread. The handler parses the reply with the
+ *  usual Read() calls, and is called again as long as it consumes data
+ *  and a complete reply remains.
+ *
+ *  Only the communications that provide a descriptor can be added:
+ *  see Communication::GetReactorDescriptor(). On Windows, no
+ *  communication can be added.
+ *
+ *  \sa Communication
+ *  \sa Tracker
+ *
+ *  \ingroup Communication
+ */
+class CommunicationReactor : public Object
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( CommunicationReactor, Object )
+
+  typedef Communication::ResultType         ResultType;
+
+  /** Receiver of the replies of a communication */
+  class ReplyHandler
+  {
+  public:
+    virtual ~ReplyHandler() {}
+
+    /** Called in the reactor thread when a complete reply was received */
+    virtual void ProcessReply( Communication * communication ) = 0;
+  };
+
+  /** Add a communication, whose replies are passed to the handler. The
+   *  communication must be open, and stay open until it is removed. The
+   *  reactor thread is started with the first communication. */
+  ResultType AddCommunication( Communication * communication,
+                               ReplyHandler * handler );
+
+  /** Remove a communication. When this returns, the handler is not
+   *  being called and will not be called again, and the communication
+   *  reads from its device again. This must not be called from a
+   *  handler. */
+  ResultType RemoveCommunication( Communication * communication );
+
+  /** Number of communications in the reactor */
+  unsigned int GetNumberOfCommunications() const;
+
+  /** Counters of the reactor thread: the times it woke up, the bytes it
+   *  read, and the replies it passed to the handlers */
+  unsigned long GetNumberOfWakeUps() const;
+  unsigned long GetNumberOfBytesRead() const;
+  unsigned long GetNumberOfReplies() const;
+
+protected:
+
+  CommunicationReactor();
+  virtual ~CommunicationReactor();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  CommunicationReactor(const Self&);   //purposely not implemented
+  void operator=(const Self&);         //purposely not implemented
+
+  /** Start and stop the reactor thread */
+  bool StartThread();
+  void StopThread();
+
+  /** Wake the reactor thread up from its wait */
+  void WakeUp();
+
+  /** Wait for data, and read and dispatch it. Returns false when the
+   *  wait failed. */
+  bool WaitAndDispatch();
+
+  /** Read the data of a descriptor and dispatch the complete replies */
+  void ReadAndDispatch( int descriptor );
+
+  static ITK_THREAD_RETURN_TYPE ReactorThreadFunction( void* pInfoStruct );
+
+  /** A communication, held until it is removed, its handler, and the
+   *  flags of its descriptor before it was made non-blocking */
+  struct EntryType
+    {
+    Communication::Pointer    CommunicationPointer;
+    ReplyHandler *            Handler;
+    int                       Flags;
+    bool                      HungUp;
+    };
+
+  typedef std::map< int, EntryType >    EntryContainerType;
+
+  /** The communications, by descriptor. The lock is held while the
+   *  reactor thread reads and dispatches, so that a communication is
+   *  never removed while its handler is called. */
+  EntryContainerType              m_Entries;
+  mutable itk::SimpleMutexLock    m_Lock;
+
+  itk::MultiThreader::Pointer     m_Threader;
+  int                             m_ThreadID;
+  bool                            m_ThreadStarted;
+
+  /** Descriptor of the epoll instance, or -1 when select is used */
+  int                             m_PollDescriptor;
+
+  /** Pipe that wakes the reactor thread up */
+  int                             m_WakeUpDescriptors[2];
+
+  unsigned long                   m_NumberOfWakeUps;
+  unsigned long                   m_NumberOfBytesRead;
+  unsigned long                   m_NumberOfReplies;
+};
+
+} // end namespace igstk
+
+#endif // __igstkCommunicationReactor_h
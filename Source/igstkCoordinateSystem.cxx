@@ -19,6 +19,7 @@
 #include "igstkCoordinateSystemTransformToResult.h"
 #include "igstkCoordinateSystemTransformToErrorResult.h"
 #include "igstkCoordinateSystemSetTransformResult.h"
+#include "igstkRigidTransform.h"
 
 namespace igstk
 { 
@@ -37,6 +38,7 @@ CoordinateSystem
   // Default transform is identity.
   this->m_TransformToParent.SetToIdentity( 
                                     TimeStamp::GetLongestPossibleTime() );
+  this->m_RigidTransformToParent.ImportTransform( this->m_TransformToParent );
 
   //
   // State machine configuration
@@ -260,6 +262,20 @@ CoordinateSystem
 }
 
 
+const CoordinateSystem::TransformToChannelType &
+CoordinateSystem::GetTransformToChannel() const
+{
+  return m_TransformToChannel;
+}
+
+
+const CoordinateSystem::SetTransformChannelType &
+CoordinateSystem::GetSetTransformChannel() const
+{
+  return m_SetTransformChannel;
+}
+
+
 // Print object information
 void CoordinateSystem::PrintSelf( 
   std::ostream& os, itk::Indent indent ) const
@@ -372,6 +388,8 @@ void CoordinateSystem
   CoordinateSystemTransformToResult payload;
   payload.Initialize(transform, this, this);
 
+  m_TransformToChannel.Invoke( payload );
+
   CoordinateSystemTransformToEvent event;
   event.Set(payload);
 
@@ -423,16 +441,19 @@ void CoordinateSystem
                         << "] "
                         << "\n" );
 
-  Transform thisToAncestor   = 
-            this->ComputeTransformTo( m_LowestCommonAncestor );
+  RigidTransform thisToAncestor;
+  this->ComputeTransformTo( m_LowestCommonAncestor, thisToAncestor );
 
-  Transform targetToAncestor = 
-    m_TargetFromRequestComputeTransformTo
-                              ->ComputeTransformTo( m_LowestCommonAncestor );
+  RigidTransform ancestorToTarget;
+  m_TargetFromRequestComputeTransformTo->ComputeTransformTo( 
+                                    m_LowestCommonAncestor, ancestorToTarget );
+  RigidTransform::Invert( ancestorToTarget, ancestorToTarget );
 
-  Transform result = Transform::TransformCompose(
-                                              targetToAncestor.GetInverse(),
-                                              thisToAncestor);
+  RigidTransform thisToTarget;
+  RigidTransform::Compose( ancestorToTarget, thisToAncestor, thisToTarget );
+
+  Transform result;
+  thisToTarget.ExportTransform( result );
 
   // Create event
   CoordinateSystemTransformToResult payload;
@@ -441,28 +462,30 @@ void CoordinateSystem
                      m_TargetFromRequestComputeTransformTo,
                      m_LowestCommonAncestor);
 
+  m_TransformToChannel.Invoke( payload );
+
   CoordinateSystemTransformToEvent event;
   event.Set( payload );
 
   this->InvokeEvent( event );
 }
 
-Transform
+void
 CoordinateSystem::
-ComputeTransformTo(const CoordinateSystem* ancestor) const
+ComputeTransformTo(const CoordinateSystem* ancestor, 
+                   RigidTransform & result) const
 {
-  if ( ancestor == this )
-    {
-    Transform identity;
-    identity.SetToIdentity(igstk::TimeStamp::GetLongestPossibleTime());
-    return identity;
-    }
-  else
+  // Walk up to the ancestor, composing the transform to each parent on the
+  // left. The compact transforms avoid the itk::Versor arithmetic and the
+  // copies of igstk::Transform at every level. As in the recursive
+  // formulation, the identity of the ancestor takes part in the composition.
+  result.SetToIdentity( igstk::TimeStamp::GetLongestPossibleTime() );
+
+  const CoordinateSystem * node = this;
+  while( node != ancestor )
     {
-    Transform result = Transform::TransformCompose( 
-      this->m_Parent->ComputeTransformTo(ancestor),
-      this->m_TransformToParent);
-    return result;
+    RigidTransform::Compose( node->m_RigidTransformToParent, result, result );
+    node = node->m_Parent;
     }
 }
 
@@ -522,6 +545,7 @@ void CoordinateSystem
 {
   this->m_Parent = this->m_ParentFromRequestSetTransformAndParent;
   this->m_TransformToParent = this->m_TransformFromRequestSetTransformAndParent;
+  this->m_RigidTransformToParent.ImportTransform( this->m_TransformToParent );
   
   CoordinateSystemSetTransformResult payload;
   
@@ -532,6 +556,8 @@ void CoordinateSystem
                      this,
                      true);
 
+  m_SetTransformChannel.Invoke( payload );
+
   CoordinateSystemSetTransformEvent event;
   event.Set( payload );
 
@@ -550,6 +576,23 @@ void CoordinateSystem
 ::UpdateTransformToParentProcessing()
 {  
   this->m_TransformToParent = this->m_TransformFromRequestSetTransformAndParent;
+  this->m_RigidTransformToParent.ImportTransform( this->m_TransformToParent );
+
+  // The updates arrive at the tracking rate and send no event, but the
+  // observers of the channel, if any, are told about them.
+  if( m_SetTransformChannel.HasObservers() )
+    {
+    CoordinateSystemSetTransformResult payload;
+
+    const CoordinateSystem * parentCoordinateSystem =
+        Friends::CoordinateSystemHelper::GetCoordinateSystem( m_Parent );
+
+    payload.Initialize(this->m_TransformToParent, parentCoordinateSystem,
+                       this,
+                       true);
+
+    m_SetTransformChannel.Invoke( payload );
+    }
 }
 
 void CoordinateSystem
@@ -747,6 +790,8 @@ CoordinateSystem
   // Default transform is identity.
   this->m_TransformToParent.SetToIdentity( 
                                     TimeStamp::GetLongestPossibleTime() );
+  this->m_RigidTransformToParent.ImportTransform( this->m_TransformToParent );
+  m_SetTransformChannel.Invoke( payload );
   this->InvokeEvent( event );
 }
 
@@ -21,10 +21,15 @@
 #include "igstkObject.h"
 #include "igstkStateMachine.h"
 #include "igstkTransform.h"
+#include "igstkEventChannel.h"
+#include "igstkRigidTransform.h"
 
 namespace igstk
 {
 
+class CoordinateSystemTransformToResult;
+class CoordinateSystemSetTransformResult;
+
 /** \class CoordinateSystem
  * 
  * \brief This class represents the frame of a coordinate reference system.
@@ -130,6 +135,22 @@ public:
   igstkSetStringMacro( Type );
   igstkGetStringMacro( Type ); 
 
+  /** Channels carrying the same payloads as the
+   *  CoordinateSystemTransformToEvent and CoordinateSystemSetTransformEvent.
+   *  They are invoked just before the corresponding events and are meant
+   *  for the observers that are notified at every tracking sample, since
+   *  they are dispatched without run time type identification and without
+   *  copying the payload. The set transform channel is also invoked by
+   *  RequestUpdateTransformToParent(), which sends no event.
+   */
+  typedef EventChannel< CoordinateSystemTransformToResult >
+                                                    TransformToChannelType;
+  typedef EventChannel< CoordinateSystemSetTransformResult >
+                                                    SetTransformChannelType;
+
+  const TransformToChannelType & GetTransformToChannel() const;
+  const SetTransformChannelType & GetSetTransformChannel() const;
+
 protected:
 
   /** Constructor */
@@ -145,6 +166,10 @@ private:
   /** Copy constructor -- purposely not implemented. */
   CoordinateSystem(const Self&);
 
+  /** The publisher copies the parents and transforms of the coordinate
+   *  systems in its snapshots of the scene */
+  friend class SceneSnapshotPublisher;
+
   /** Assignment operator -- purposely not implemented. */
   void operator=(const Self&);
 
@@ -157,12 +182,19 @@ private:
    */
   Transform           m_TransformToParent;
 
+  /** Compact copy of m_TransformToParent used when composing transforms */
+  RigidTransform      m_RigidTransformToParent;
+
   /** Coordinate system name for diagram export. */
   std::string         m_Name;
 
   /** Coordinate system type for diagram export. */
   std::string      m_Type;
 
+  /** Typed channels invoked along with the transform events. */
+  TransformToChannelType           m_TransformToChannel;
+  SetTransformChannelType          m_SetTransformChannel;
+
   /** 
    * State machine declarations
    */
@@ -279,7 +311,8 @@ private:
    *  the lowest common ancestor. The argument should be the 
    *  ancestor found by FindLowestCommonAncestor.
    */
-  Transform ComputeTransformTo(const CoordinateSystem* ancestor) const;
+  void ComputeTransformTo(const CoordinateSystem* ancestor,
+                          RigidTransform & result) const;
 
   /** This method is used to ensure that we do not set a parent that 
    *  causes a cycle in the scene graph. CanReach returns true if 
@@ -178,6 +178,20 @@ CoordinateSystemDelegator
   return this->m_CoordinateSystem->GetType();
 }
 
+const CoordinateSystem::TransformToChannelType &
+CoordinateSystemDelegator
+::GetTransformToChannel() const
+{
+  return this->m_CoordinateSystem->GetTransformToChannel();
+}
+
+const CoordinateSystem::SetTransformChannelType &
+CoordinateSystemDelegator
+::GetSetTransformChannel() const
+{
+  return this->m_CoordinateSystem->GetSetTransformChannel();
+}
+
 bool
 CoordinateSystemDelegator
 ::IsCoordinateSystem( const CoordinateSystemType* inCS) const
@@ -150,6 +150,16 @@ public:
   void SetType( const char* type );
   void SetType( const std::string& type );
   const char* GetType() const;
+
+  /** Typed channels of the coordinate system. Observers registered on
+   *  them are called with the payloads of the
+   *  CoordinateSystemTransformToEvent and CoordinateSystemSetTransformEvent,
+   *  without going through the event forwarding of this class.
+   */
+  const CoordinateSystem::TransformToChannelType & 
+                                               GetTransformToChannel() const;
+  const CoordinateSystem::SetTransformChannelType & 
+                                              GetSetTransformChannel() const;
   
 protected:
   CoordinateSystemDelegator();
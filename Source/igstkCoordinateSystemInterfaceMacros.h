@@ -109,6 +109,16 @@ public: \
     { \
     return m_CoordinateSystemDelegator->GetName(); \
     } \
+  const ::igstk::CoordinateSystem::TransformToChannelType & \
+                                           GetTransformToChannel() const \
+    { \
+    return m_CoordinateSystemDelegator->GetTransformToChannel(); \
+    } \
+  const ::igstk::CoordinateSystem::SetTransformChannelType & \
+                                          GetSetTransformChannel() const \
+    { \
+    return m_CoordinateSystemDelegator->GetSetTransformChannel(); \
+    } \
 protected: \
   virtual bool IsInternalTransformRequired() \
     { \
@@ -203,6 +213,16 @@ public: \
     return m_CoordinateSystemDelegator-> \
     IsCoordinateSystem( inCS ); \
     } \
+    const ::igstk::CoordinateSystem::TransformToChannelType & \
+                                           GetTransformToChannel() const \
+    { \
+    return m_CoordinateSystemDelegator->GetTransformToChannel(); \
+    } \
+    const ::igstk::CoordinateSystem::SetTransformChannelType & \
+                                          GetSetTransformChannel() const \
+    { \
+    return m_CoordinateSystemDelegator->GetSetTransformChannel(); \
+    } \
 protected: \
   virtual bool IsInternalTransformRequired() \
     { \
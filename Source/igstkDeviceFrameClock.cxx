@@ -0,0 +1,208 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkDeviceFrameClock.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkDeviceFrameClock.h"
+
+namespace igstk
+{
+
+namespace
+{
+
+/** Difference between two 32 bit frame counters, taking the wrap around
+ *  into account */
+long FrameDifference( unsigned long frame, unsigned long reference )
+{
+  const unsigned long difference = ( frame - reference ) & 0xffffffffUL;
+  if( difference >= 0x80000000UL )
+    {
+    return -static_cast< long >( ( ~difference + 1 ) & 0xffffffffUL );
+    }
+  return static_cast< long >( difference );
+}
+
+}
+
+
+DeviceFrameClock::DeviceFrameClock():m_StateMachine(this)
+{
+  m_NumberOfFittedFrames = 120;
+
+  this->Reset();
+}
+
+DeviceFrameClock::~DeviceFrameClock()
+{
+}
+
+void DeviceFrameClock::Reset()
+{
+  m_LastFrame = 0;
+  m_LastUnwrappedFrame = 0.0;
+  m_Frames.clear();
+  m_ArrivalTimes.clear();
+  m_Offset = 0.0;
+  m_FramePeriod = 0.0;
+
+  m_NumberOfFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_NumberOfDuplicatedFrames = 0;
+  m_NumberOfOutOfOrderFrames = 0;
+}
+
+double DeviceFrameClock::UnwrapFrame( unsigned long frame ) const
+{
+  return m_LastUnwrappedFrame + FrameDifference( frame, m_LastFrame );
+}
+
+DeviceFrameClock::FrameStatusType
+DeviceFrameClock::AddFrame( unsigned long frame, TimePeriodType arrivalTime )
+{
+  m_NumberOfFrames++;
+
+  if( m_Frames.empty() )
+    {
+    m_LastFrame = frame;
+    m_LastUnwrappedFrame = 0.0;
+    }
+  else
+    {
+    const long difference = FrameDifference( frame, m_LastFrame );
+    if( difference == 0 )
+      {
+      m_NumberOfDuplicatedFrames++;
+      return DuplicatedFrame;
+      }
+    if( difference < 0 )
+      {
+      m_NumberOfOutOfOrderFrames++;
+      return OutOfOrderFrame;
+      }
+
+    m_NumberOfDroppedFrames += difference - 1;
+    m_LastFrame = frame;
+    m_LastUnwrappedFrame += difference;
+    }
+
+  m_Frames.push_back( m_LastUnwrappedFrame );
+  m_ArrivalTimes.push_back( arrivalTime );
+  while( m_Frames.size() > m_NumberOfFittedFrames && m_Frames.size() > 2 )
+    {
+    m_Frames.pop_front();
+    m_ArrivalTimes.pop_front();
+    }
+
+  this->FitMapping();
+
+  return NewFrame;
+}
+
+void DeviceFrameClock::FitMapping()
+{
+  const unsigned int n = m_Frames.size();
+  if( n < 2 )
+    {
+    m_FramePeriod = 0.0;
+    m_Offset = m_ArrivalTimes.back();
+    return;
+    }
+
+  // least squares line, relative to the newest frame for the accuracy
+  const double lastFrame = m_Frames.back();
+  const TimePeriodType lastTime = m_ArrivalTimes.back();
+  double sumX = 0.0;
+  double sumY = 0.0;
+  for( unsigned int i = 0; i < n; i++ )
+    {
+    sumX += m_Frames[i] - lastFrame;
+    sumY += m_ArrivalTimes[i] - lastTime;
+    }
+  const double meanX = sumX / n;
+  const double meanY = sumY / n;
+
+  double sumXX = 0.0;
+  double sumXY = 0.0;
+  for( unsigned int i = 0; i < n; i++ )
+    {
+    const double x = m_Frames[i] - lastFrame - meanX;
+    const double y = m_ArrivalTimes[i] - lastTime - meanY;
+    sumXX += x * x;
+    sumXY += x * y;
+    }
+  m_FramePeriod = ( sumXX > 0.0 ) ? sumXY / sumXX : 0.0;
+
+  // lower the line to the earliest arrival
+  const double intercept = meanY - m_FramePeriod * meanX;
+  double shortestDelay = 0.0;
+  for( unsigned int i = 0; i < n; i++ )
+    {
+    const double delay = ( m_ArrivalTimes[i] - lastTime ) - intercept -
+                         m_FramePeriod * ( m_Frames[i] - lastFrame );
+    if( i == 0 || delay < shortestDelay )
+      {
+      shortestDelay = delay;
+      }
+    }
+
+  m_Offset = lastTime + intercept + shortestDelay -
+             m_FramePeriod * lastFrame;
+}
+
+DeviceFrameClock::TimePeriodType
+DeviceFrameClock::GetFrameTime( unsigned long frame ) const
+{
+  if( m_Frames.empty() )
+    {
+    return 0.0;
+    }
+  return m_Offset + m_FramePeriod * this->UnwrapFrame( frame );
+}
+
+DeviceFrameClock::TimePeriodType
+DeviceFrameClock::GetNextFrameTime() const
+{
+  if( m_Frames.empty() )
+    {
+    return 0.0;
+    }
+  return m_Offset + m_FramePeriod * ( m_LastUnwrappedFrame + 1.0 );
+}
+
+void DeviceFrameClock::PrintSelf( std::ostream& os,
+                                  itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of fitted frames: " << m_NumberOfFittedFrames
+     << std::endl;
+  os << indent << "Frame period: " << m_FramePeriod << std::endl;
+  os << indent << "Number of frames: " << m_NumberOfFrames << std::endl;
+  os << indent << "Number of dropped frames: " << m_NumberOfDroppedFrames
+     << std::endl;
+  os << indent << "Number of duplicated frames: "
+     << m_NumberOfDuplicatedFrames << std::endl;
+  os << indent << "Number of out of order frames: "
+     << m_NumberOfOutOfOrderFrames << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkDeviceFrameClock.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkDeviceFrameClock_h
+#define __igstkDeviceFrameClock_h
+
+#include "igstkObject.h"
+#include "igstkTransform.h"
+#include "igstkMacros.h"
+
+#include <deque>
+
+namespace igstk
+{
+
+/** \class DeviceFrameClock
+ *  \brief Maps the frame counter of a tracking device to the host clock.
+ *
+ *  Most tracking devices number the frames they acquire. The host only
+ *  knows when a reply arrived, which is the acquisition time plus a
+ *  transmission and processing delay that varies from reply to reply.
+ *  This class fits the arrival times of the recent frames with a line,
+ *  whose slope is the frame period measured with the host clock, so that
+ *  the drift between the device and the host clocks is followed. The line
+ *  is then lowered to the earliest arrival among these frames, since no
+ *  frame can arrive before it is acquired: the time of a frame is its
+ *  acquisition time plus the shortest delay of the device.
+ *
+ *  The frame numbers are 32 bit counters that may wrap around. Every
+ *  frame is classified against the newest frame seen so far: a frame
+ *  number seen again is a duplicated frame, an older one is out of
+ *  order, and the frames skipped by a newer one are dropped.
+ *
+ *  The clock is not thread safe: the trackers update it in their tracking
+ *  thread, under the lock of their buffers.
+ *
+ *  \sa Tracker
+ *
+ *  \ingroup Tracker
+ */
+class DeviceFrameClock : public Object
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( DeviceFrameClock, Object )
+
+  typedef Transform::TimePeriodType         TimePeriodType;
+
+  /** Classification of a frame, relative to the newest frame */
+  typedef enum
+    {
+    NewFrame,
+    DuplicatedFrame,
+    OutOfOrderFrame
+    } FrameStatusType;
+
+  /** Number of recent frames used to fit the mapping, 120 by default */
+  igstkSetMacro( NumberOfFittedFrames, unsigned int );
+  igstkGetMacro( NumberOfFittedFrames, unsigned int );
+
+  /** Add a frame received from the device at the given host time, in
+   *  milliseconds, and update the mapping with it if it is new. */
+  FrameStatusType AddFrame( unsigned long frame, TimePeriodType arrivalTime );
+
+  /** Estimated time of a frame, in milliseconds of the host clock. Until
+   *  two frames were added, this is the arrival time of the newest one. */
+  TimePeriodType GetFrameTime( unsigned long frame ) const;
+
+  /** Estimated time of the frame following the newest one */
+  TimePeriodType GetNextFrameTime() const;
+
+  /** Frame period measured with the host clock, in milliseconds. Zero
+   *  until two frames were added. */
+  igstkGetMacro( FramePeriod, double );
+
+  /** Forget the frames and the mapping, e.g. when tracking restarts */
+  void Reset();
+
+  /** Counters of the frames since the last Reset() */
+  igstkGetMacro( NumberOfFrames, unsigned long );
+  igstkGetMacro( NumberOfDroppedFrames, unsigned long );
+  igstkGetMacro( NumberOfDuplicatedFrames, unsigned long );
+  igstkGetMacro( NumberOfOutOfOrderFrames, unsigned long );
+
+protected:
+
+  DeviceFrameClock();
+  virtual ~DeviceFrameClock();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  DeviceFrameClock(const Self&);   //purposely not implemented
+  void operator=(const Self&);     //purposely not implemented
+
+  /** Frame number relative to the first frame, unwrapped */
+  double UnwrapFrame( unsigned long frame ) const;
+
+  /** Fit the mapping to the recent frames */
+  void FitMapping();
+
+  unsigned int      m_NumberOfFittedFrames;
+
+  /** Newest frame, as received and unwrapped */
+  unsigned long     m_LastFrame;
+  double            m_LastUnwrappedFrame;
+
+  /** Recent new frames, unwrapped, and their arrival times */
+  std::deque< double >          m_Frames;
+  std::deque< TimePeriodType >  m_ArrivalTimes;
+
+  /** Time of the frame numbered zero, and frame period */
+  TimePeriodType    m_Offset;
+  double            m_FramePeriod;
+
+  unsigned long     m_NumberOfFrames;
+  unsigned long     m_NumberOfDroppedFrames;
+  unsigned long     m_NumberOfDuplicatedFrames;
+  unsigned long     m_NumberOfOutOfOrderFrames;
+};
+
+} // end namespace igstk
+
+#endif // __igstkDeviceFrameClock_h
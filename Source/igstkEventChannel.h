@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkEventChannel.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __igstkEventChannel_h
+#define __igstkEventChannel_h
+
+#include <cstddef>
+#include <vector>
+
+namespace igstk
+{
+
+/** \class EventChannel
+ *
+ * \brief Typed and statically dispatched notification channel.
+ *
+ * An EventChannel delivers a single kind of payload to the observers that
+ * registered on it. Contrary to the itk::Object event mechanism, the
+ * channel does not need to identify the type of the event at run time: the
+ * list of observers is specific to the payload type, observers are plain
+ * function pointers, and the payload is passed by const reference without
+ * being copied into an event object. Invoking a channel does not allocate
+ * memory, nor use RTTI.
+ *
+ * Channels are used for the events that are emitted at every tracking
+ * sample or at every render, such as the transforms computed by a
+ * CoordinateSystem. The corresponding itk events are still emitted, so
+ * that existing observers are not affected.
+ *
+ * Observers may be added or removed from within a callback. Observers that
+ * are added during an invocation are called from the next invocation on.
+ * The class is not thread safe, in the same way as the itk::Object
+ * observers.
+ *
+ * \ingroup Object
+ */
+template < class TPayload >
+class EventChannel
+{
+
+public:
+
+  typedef TPayload                 PayloadType;
+
+  /** Signature of the observer functions */
+  typedef void ( *CallbackType )( void * receiver,
+                                  const PayloadType & payload );
+
+  /** Constructor and destructor */
+  EventChannel();
+  ~EventChannel();
+
+  /** Register a function to be called with the receiver at every
+   * invocation. Returns a tag that identifies the observer. Registration
+   * does not modify the observable state of the owner of the channel, the
+   * method is therefore const as itk::Object::AddObserver(). */
+  unsigned long AddObserver( void * receiver, CallbackType callback ) const;
+
+  /** Register a member function of the receiver. The method is given as a
+   * template argument, so that it is called without any indirection through
+   * a command object:
+   *
+   *   channel.template AddMemberObserver< Self, &Self::Callback >( this );
+   */
+  template < class TReceiver,
+             void ( TReceiver::*TMethod )( const TPayload & ) >
+  unsigned long AddMemberObserver( TReceiver * receiver ) const
+    {
+    return this->AddObserver( receiver,
+                              &Self::template MemberCallback< TReceiver,
+                                                              TMethod > );
+    }
+
+  /** Remove the observer associated with the tag */
+  void RemoveObserver( unsigned long tag ) const;
+
+  /** Remove all the observers */
+  void RemoveAllObservers() const;
+
+  /** Return true if at least one observer is registered */
+  bool HasObservers() const;
+
+  /** Number of registered observers */
+  unsigned int GetNumberOfObservers() const;
+
+  /** Call every observer with the payload */
+  void Invoke( const PayloadType & payload ) const;
+
+private:
+
+  typedef EventChannel Self;
+
+  EventChannel( const Self & );    //purposely not implemented
+  void operator=( const Self & );  //purposely not implemented
+
+  /** Adaptor from the channel callback signature to a member function */
+  template < class TReceiver,
+             void ( TReceiver::*TMethod )( const TPayload & ) >
+  static void MemberCallback( void * receiver, const PayloadType & payload )
+    {
+    ( static_cast< TReceiver * >( receiver )->*TMethod )( payload );
+    }
+
+  /** Remove the entries that were disabled during an invocation */
+  void RemoveDisabledObservers() const;
+
+  struct ObserverType
+    {
+    void *          m_Receiver;
+    CallbackType    m_Callback;
+    unsigned long   m_Tag;
+    };
+
+  typedef std::vector< ObserverType >  ObserverListType;
+
+  mutable ObserverListType    m_Observers;
+  mutable unsigned long       m_NextTag;
+  mutable unsigned int        m_InvocationDepth;
+  mutable bool                m_HasDisabledObservers;
+};
+
+} // end namespace igstk
+
+#ifndef IGSTK_MANUAL_INSTANTIATION
+#include "igstkEventChannel.txx"
+#endif
+
+#endif // __igstkEventChannel_h
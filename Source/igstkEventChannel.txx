@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkEventChannel.txx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __igstkEventChannel_txx
+#define __igstkEventChannel_txx
+
+#include "igstkEventChannel.h"
+
+namespace igstk
+{
+
+/** Constructor */
+template < class TPayload >
+EventChannel< TPayload >::EventChannel()
+{
+  m_NextTag = 0;
+  m_InvocationDepth = 0;
+  m_HasDisabledObservers = false;
+}
+
+
+/** Destructor */
+template < class TPayload >
+EventChannel< TPayload >::~EventChannel()
+{
+}
+
+
+template < class TPayload >
+unsigned long
+EventChannel< TPayload >
+::AddObserver( void * receiver, CallbackType callback ) const
+{
+  ObserverType observer;
+  observer.m_Receiver = receiver;
+  observer.m_Callback = callback;
+  observer.m_Tag = m_NextTag++;
+
+  m_Observers.push_back( observer );
+
+  return observer.m_Tag;
+}
+
+
+template < class TPayload >
+void
+EventChannel< TPayload >::RemoveObserver( unsigned long tag ) const
+{
+  typename ObserverListType::iterator it = m_Observers.begin();
+  while( it != m_Observers.end() )
+    {
+    if( it->m_Tag == tag && it->m_Callback != NULL )
+      {
+      if( m_InvocationDepth > 0 )
+        {
+        // The list is being traversed, the entry is removed later
+        it->m_Callback = NULL;
+        m_HasDisabledObservers = true;
+        }
+      else
+        {
+        m_Observers.erase( it );
+        }
+      return;
+      }
+    ++it;
+    }
+}
+
+
+template < class TPayload >
+void
+EventChannel< TPayload >::RemoveAllObservers() const
+{
+  if( m_InvocationDepth > 0 )
+    {
+    typename ObserverListType::iterator it = m_Observers.begin();
+    while( it != m_Observers.end() )
+      {
+      it->m_Callback = NULL;
+      ++it;
+      }
+    m_HasDisabledObservers = true;
+    }
+  else
+    {
+    m_Observers.clear();
+    }
+}
+
+
+template < class TPayload >
+bool
+EventChannel< TPayload >::HasObservers() const
+{
+  return this->GetNumberOfObservers() > 0;
+}
+
+
+template < class TPayload >
+unsigned int
+EventChannel< TPayload >::GetNumberOfObservers() const
+{
+  unsigned int numberOfObservers = 0;
+  typename ObserverListType::const_iterator it = m_Observers.begin();
+  while( it != m_Observers.end() )
+    {
+    if( it->m_Callback != NULL )
+      {
+      numberOfObservers++;
+      }
+    ++it;
+    }
+  return numberOfObservers;
+}
+
+
+template < class TPayload >
+void
+EventChannel< TPayload >::Invoke( const PayloadType & payload ) const
+{
+  // Observers added by a callback are not called during this invocation.
+  // The list is indexed, since adding an observer may reallocate it.
+  const size_t numberOfObservers = m_Observers.size();
+  if( numberOfObservers == 0 )
+    {
+    return;
+    }
+
+  m_InvocationDepth++;
+  for( size_t i = 0; i < numberOfObservers; i++ )
+    {
+    const ObserverType & observer = m_Observers[i];
+    if( observer.m_Callback != NULL )
+      {
+      observer.m_Callback( observer.m_Receiver, payload );
+      }
+    }
+  m_InvocationDepth--;
+
+  if( m_InvocationDepth == 0 && m_HasDisabledObservers )
+    {
+    this->RemoveDisabledObservers();
+    }
+}
+
+
+template < class TPayload >
+void
+EventChannel< TPayload >::RemoveDisabledObservers() const
+{
+  typename ObserverListType::iterator it = m_Observers.begin();
+  while( it != m_Observers.end() )
+    {
+    if( it->m_Callback == NULL )
+      {
+      it = m_Observers.erase( it );
+      }
+    else
+      {
+      ++it;
+      }
+    }
+  m_HasDisabledObservers = false;
+}
+
+} // end namespace igstk
+
+#endif
@@ -0,0 +1,605 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkFrameScheduler.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkFrameScheduler.h"
+#include "igstkRealTimeClock.h"
+
+#include "vtkProp.h"
+
+#include <algorithm>
+
+namespace igstk
+{
+
+FrameScheduler::FrameScheduler():m_StateMachine(this)
+{
+  m_PulseGenerator = PulseGenerator::New();
+
+  m_PulseObserver = ObserverType::New();
+  m_PulseObserver->SetCallbackFunction( this, & FrameScheduler::RefreshFrame );
+
+  m_PulseGenerator->AddObserver( PulseEvent(), m_PulseObserver );
+
+  this->SetRefreshRate( 30 );
+
+  m_RequestedDestination = NULL;
+  m_TransformReceived = false;
+
+  m_ThreadedFramePreparation = false;
+
+  m_Publisher = SceneSnapshotPublisher::New();
+
+  m_SnapshotObserver = ObserverType::New();
+  m_SnapshotObserver->SetCallbackFunction( this,
+                                           & FrameScheduler::SnapshotCallback );
+
+  m_Publisher->AddObserver( SceneSnapshotEvent(), m_SnapshotObserver );
+
+  m_PreparationThreader = itk::MultiThreader::New();
+  m_PreparationThreadID = -1;
+  m_PreparationThreadStarted = false;
+  m_StopPreparation = false;
+  m_SnapshotPending = false;
+  m_SnapshotCondition = itk::ConditionVariable::New();
+  m_NumberOfPreparedFrames = 0;
+  m_LastPreparationTime = 0.0;
+
+  this->ResetFrameStatistics();
+}
+
+FrameScheduler::~FrameScheduler()
+{
+  m_PulseGenerator->RequestStop();
+
+  this->StopPreparationThread();
+
+  // the views that are refreshing go back to their own pulses
+  ViewContainerType::iterator it;
+  for( it = m_Views.begin(); it != m_Views.end(); ++it )
+    {
+    (*it)->m_FrameScheduled = false;
+    if( (*it)->m_Refreshing )
+      {
+      (*it)->m_PulseGenerator->RequestStart();
+      }
+    }
+}
+
+void FrameScheduler::RequestAddView( View * view )
+{
+  if( view == NULL || std::find( m_Views.begin(), m_Views.end(), view ) !=
+                      m_Views.end() )
+    {
+    igstkLogMacro( WARNING, "FrameScheduler::RequestAddView: "
+                   "null view or view already added\n" );
+    return;
+    }
+
+  // the view does not refresh on its own pulses anymore
+  view->m_FrameScheduled = true;
+  view->m_PulseGenerator->RequestStop();
+
+  m_Views.push_back( view );
+}
+
+void FrameScheduler::RequestRemoveView( View * view )
+{
+  ViewContainerType::iterator it =
+    std::find( m_Views.begin(), m_Views.end(), view );
+  if( it == m_Views.end() )
+    {
+    igstkLogMacro( WARNING, "FrameScheduler::RequestRemoveView: "
+                   "the view was not added\n" );
+    return;
+    }
+
+  // a view that is refreshing goes back to its own pulses
+  view->m_FrameScheduled = false;
+  if( view->m_Refreshing )
+    {
+    view->m_PulseGenerator->RequestStart();
+    }
+
+  m_Views.erase( it );
+}
+
+unsigned int FrameScheduler::GetNumberOfViews() const
+{
+  return static_cast< unsigned int >( m_Views.size() );
+}
+
+void FrameScheduler::SetRefreshRate( double frequency )
+{
+  m_PulseGenerator->RequestSetFrequency( frequency );
+}
+
+void FrameScheduler::RequestStart()
+{
+  m_PulseGenerator->RequestStart();
+}
+
+void FrameScheduler::RequestStop()
+{
+  m_PulseGenerator->RequestStop();
+}
+
+double FrameScheduler::GetMeanFrameTime() const
+{
+  if( m_NumberOfFrames == 0 )
+    {
+    return 0.0;
+    }
+  return m_TotalFrameTime / m_NumberOfFrames;
+}
+
+void FrameScheduler::ResetFrameStatistics()
+{
+  m_NumberOfFrames = 0;
+  m_LastFrameTime = 0.0;
+  m_TotalFrameTime = 0.0;
+  m_MaximumFrameTime = 0.0;
+  m_NumberOfComputedTransforms = 0;
+  m_NumberOfSharedTransforms = 0;
+  m_NumberOfPreparedTransforms = 0;
+}
+
+void FrameScheduler::SetThreadedFramePreparation( bool threaded )
+{
+  if( threaded == m_ThreadedFramePreparation )
+    {
+    return;
+    }
+
+  m_ThreadedFramePreparation = threaded;
+
+  if( threaded )
+    {
+    this->StartPreparationThread();
+    return;
+    }
+
+  this->StopPreparationThread();
+
+  // stop following the coordinate systems of the scene
+  const SceneSnapshotPublisher::RepresentationContainerType noRepresentation;
+  m_Publisher->RequestSetRepresentations( noRepresentation );
+
+  m_PreparationLock.Lock();
+  m_PreparedFrame = NULL;
+  m_PreparationLock.Unlock();
+}
+
+unsigned long FrameScheduler::GetNumberOfPreparedFrames() const
+{
+  m_PreparationLock.Lock();
+  const unsigned long numberOfPreparedFrames = m_NumberOfPreparedFrames;
+  m_PreparationLock.Unlock();
+  return numberOfPreparedFrames;
+}
+
+double FrameScheduler::GetLastPreparationTime() const
+{
+  m_PreparationLock.Lock();
+  const double lastPreparationTime = m_LastPreparationTime;
+  m_PreparationLock.Unlock();
+  return lastPreparationTime;
+}
+
+/** Refresh all the views for the same render time */
+void FrameScheduler::RefreshFrame()
+{
+  if( m_Views.empty() )
+    {
+    return;
+    }
+
+  const double frameStart = RealTimeClock::GetTimeStamp();
+
+  m_NumberOfComputedTransforms = 0;
+  m_NumberOfSharedTransforms = 0;
+  m_NumberOfPreparedTransforms = 0;
+
+  // the views only render while they are refreshing
+  ViewContainerType views;
+  ViewContainerType::const_iterator viewIt;
+  for( viewIt = m_Views.begin(); viewIt != m_Views.end(); ++viewIt )
+    {
+    if( (*viewIt)->m_Refreshing )
+      {
+      views.push_back( *viewIt );
+      }
+    }
+  if( views.empty() )
+    {
+    return;
+    }
+
+  // the same render time for all the views
+  TimeStamp renderTime;
+  renderTime.SetStartTimeNowAndExpireAfter(
+                                    1000.0 / m_PulseGenerator->GetFrequency() );
+
+  // the transforms prepared from the latest snapshot of the scene. A
+  // frame prepared from an older snapshot is not used: the scene changed
+  // since, and the transforms are computed as without the preparation.
+  PreparedFrame::ConstPointer preparedFrame;
+  if( m_ThreadedFramePreparation )
+    {
+    this->PublishRepresentations( views );
+    m_Publisher->RequestPublish();
+
+    m_PreparationLock.Lock();
+    preparedFrame = m_PreparedFrame;
+    m_PreparationLock.Unlock();
+
+    if( preparedFrame.IsNotNull() && preparedFrame->m_Version !=
+                                     m_Publisher->GetSnapshot()->GetVersion() )
+      {
+      preparedFrame = NULL;
+      }
+    }
+
+  typedef igstk::Friends::CoordinateSystemHelper  CoordinateSystemHelperType;
+
+  const CoordinateSystem * firstViewCS =
+    CoordinateSystemHelperType::GetCoordinateSystem( views[0].GetPointer() );
+
+  m_ObjectTransforms.clear();
+
+  for( viewIt = views.begin(); viewIt != views.end(); ++viewIt )
+    {
+    View * view = *viewIt;
+    const CoordinateSystem * viewCS =
+      CoordinateSystemHelperType::GetCoordinateSystem( view );
+
+    // the transform from the first view to this one
+    FrameTransformType firstViewToView;
+    if( viewIt == views.begin() )
+      {
+      firstViewToView.Available = true;
+      firstViewToView.Transform.SetToIdentity(
+        TimeStamp::GetLongestPossibleTime() );
+      }
+    else
+      {
+      RigidTransform viewToFirstView;
+      firstViewToView.Available =
+        this->ComputeTransformToFirstView( view, firstViewCS,
+                                           viewToFirstView );
+      RigidTransform::Invert( viewToFirstView, firstViewToView.Transform );
+      }
+
+    ObjectListType::const_iterator objectIt;
+    for( objectIt = view->m_Objects.begin();
+         objectIt != view->m_Objects.end(); ++objectIt )
+      {
+      ObjectRepresentation * representation = *objectIt;
+      SpatialObject * spatialObject = representation->m_SpatialObject;
+
+      if( spatialObject != NULL && preparedFrame.IsNotNull() )
+        {
+        PreparedFrame::EntryContainerType::const_iterator entryIt =
+          preparedFrame->m_Entries.find( representation );
+        if( entryIt != preparedFrame->m_Entries.end() &&
+            entryIt->second.Available &&
+            entryIt->second.View == viewCS &&
+            entryIt->second.Object ==
+              CoordinateSystemHelperType::GetCoordinateSystem( spatialObject ) )
+          {
+          this->UpdateRepresentation( representation, renderTime, viewCS,
+                                      entryIt->second.Transform );
+          m_NumberOfPreparedTransforms++;
+          continue;
+          }
+        }
+
+      if( !firstViewToView.Available || spatialObject == NULL )
+        {
+        representation->RequestUpdateRepresentation( renderTime, viewCS );
+        continue;
+        }
+
+      // the transform of the object to the first view, once per frame
+      ObjectTransformMapType::iterator transformIt =
+        m_ObjectTransforms.find( spatialObject );
+      if( transformIt == m_ObjectTransforms.end() )
+        {
+        FrameTransformType objectToFirstView;
+        objectToFirstView.Available =
+          this->ComputeTransformToFirstView( spatialObject, firstViewCS,
+                                             objectToFirstView.Transform );
+        transformIt = m_ObjectTransforms.insert(
+          ObjectTransformMapType::value_type( spatialObject,
+                                              objectToFirstView ) ).first;
+        }
+
+      if( !transformIt->second.Available )
+        {
+        representation->RequestUpdateRepresentation( renderTime, viewCS );
+        continue;
+        }
+
+      RigidTransform objectToView;
+      RigidTransform::Compose( firstViewToView.Transform,
+                               transformIt->second.Transform, objectToView );
+
+      this->UpdateRepresentation( representation, renderTime, viewCS,
+                                  objectToView );
+      m_NumberOfSharedTransforms++;
+      }
+    }
+
+  m_ObjectTransforms.clear();
+
+  // render the views back to back
+  for( viewIt = views.begin(); viewIt != views.end(); ++viewIt )
+    {
+    (*viewIt)->RenderScene();
+    }
+
+  m_LastFrameTime = RealTimeClock::GetTimeStamp() - frameStart;
+  m_TotalFrameTime += m_LastFrameTime;
+  if( m_LastFrameTime > m_MaximumFrameTime )
+    {
+    m_MaximumFrameTime = m_LastFrameTime;
+    }
+  m_NumberOfFrames++;
+}
+
+void FrameScheduler::UpdateRepresentation(
+                                     ObjectRepresentation * representation,
+                                     const TimeStamp & renderTime,
+                                     const CoordinateSystem * viewCS,
+                                     const RigidTransform & objectToView )
+{
+  Transform transform;
+  objectToView.ExportTransform( transform );
+
+  TransformToResultType payload;
+  payload.Initialize( transform,
+    igstk::Friends::CoordinateSystemHelper::GetCoordinateSystem(
+      representation->m_SpatialObject.GetPointer() ),
+    viewCS );
+
+  representation->RequestUpdateRepresentationWithTransform( renderTime,
+                                                            viewCS,
+                                                            payload );
+}
+
+template < class TSource >
+bool FrameScheduler::ComputeTransformToFirstView(
+                                     TSource * source,
+                                     const CoordinateSystem * destination,
+                                     RigidTransform & transform )
+{
+  m_RequestedDestination = destination;
+  m_TransformReceived = false;
+
+  const unsigned long tag = source->GetTransformToChannel().
+    template AddMemberObserver< Self, &Self::TransformToCallback >( this );
+  source->RequestComputeTransformTo( destination );
+  source->GetTransformToChannel().RemoveObserver( tag );
+
+  m_RequestedDestination = NULL;
+  m_NumberOfComputedTransforms++;
+
+  if( m_TransformReceived )
+    {
+    transform.ImportTransform( m_ReceivedTransform );
+    }
+  return m_TransformReceived;
+}
+
+void FrameScheduler::TransformToCallback(
+                                       const TransformToResultType & payload )
+{
+  if( payload.GetDestination() == m_RequestedDestination )
+    {
+    m_ReceivedTransform = payload.GetTransform();
+    m_TransformReceived = true;
+    }
+}
+
+void FrameScheduler::PublishRepresentations( const ViewContainerType & views )
+{
+  typedef igstk::Friends::CoordinateSystemHelper  CoordinateSystemHelperType;
+
+  SceneSnapshotPublisher::RepresentationContainerType representations;
+
+  ViewContainerType::const_iterator viewIt;
+  for( viewIt = views.begin(); viewIt != views.end(); ++viewIt )
+    {
+    const CoordinateSystem * viewCS =
+      CoordinateSystemHelperType::GetCoordinateSystem(
+                                                  viewIt->GetPointer() );
+
+    ObjectListType::const_iterator objectIt;
+    for( objectIt = (*viewIt)->m_Objects.begin();
+         objectIt != (*viewIt)->m_Objects.end(); ++objectIt )
+      {
+      const ObjectRepresentation * representation = *objectIt;
+      if( representation->m_SpatialObject.IsNull() )
+        {
+        continue;
+        }
+
+      SceneSnapshot::RepresentationType description;
+      description.Representation = representation;
+      description.Object = CoordinateSystemHelperType::GetCoordinateSystem(
+                             representation->m_SpatialObject.GetPointer() );
+      description.View = viewCS;
+      description.Color[0] = representation->GetRed();
+      description.Color[1] = representation->GetGreen();
+      description.Color[2] = representation->GetBlue();
+      description.Opacity = representation->GetOpacity();
+      description.Visible = false;
+
+      ObjectRepresentation::ActorsListType::const_iterator actorIt;
+      for( actorIt = representation->m_Actors.begin();
+           actorIt != representation->m_Actors.end(); ++actorIt )
+        {
+        if( (*actorIt)->GetVisibility() )
+          {
+          description.Visible = true;
+          break;
+          }
+        }
+
+      representations.push_back( description );
+      }
+    }
+
+  m_Publisher->RequestSetRepresentations( representations );
+}
+
+void FrameScheduler::SnapshotCallback()
+{
+  m_PreparationLock.Lock();
+  m_SnapshotPending = true;
+  m_SnapshotCondition->Signal();
+  m_PreparationLock.Unlock();
+}
+
+void FrameScheduler::StartPreparationThread()
+{
+  if( m_PreparationThreadStarted )
+    {
+    return;
+    }
+  m_StopPreparation = false;
+  m_PreparationThreadID =
+    m_PreparationThreader->SpawnThread( PreparationThreadFunction, this );
+  m_PreparationThreadStarted = true;
+}
+
+void FrameScheduler::StopPreparationThread()
+{
+  if( !m_PreparationThreadStarted )
+    {
+    return;
+    }
+
+  m_PreparationLock.Lock();
+  m_StopPreparation = true;
+  m_SnapshotCondition->Signal();
+  m_PreparationLock.Unlock();
+
+  m_PreparationThreader->TerminateThread( m_PreparationThreadID );
+  m_PreparationThreadStarted = false;
+}
+
+/** Resolve the transforms of the representations from the latest
+ *  snapshot, each time a new one is published. Snapshots published while
+ *  a frame is prepared are skipped but the last one. */
+ITK_THREAD_RETURN_TYPE FrameScheduler::PreparationThreadFunction( void * info )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)info;
+
+  if( pInfo == NULL || pInfo->UserData == NULL )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  FrameScheduler * scheduler =
+    static_cast< FrameScheduler * >( pInfo->UserData );
+
+  while( true )
+    {
+    scheduler->m_PreparationLock.Lock();
+    while( !scheduler->m_StopPreparation && !scheduler->m_SnapshotPending )
+      {
+      scheduler->m_SnapshotCondition->Wait( &scheduler->m_PreparationLock );
+      }
+
+    if( scheduler->m_StopPreparation )
+      {
+      scheduler->m_PreparationLock.Unlock();
+      break;
+      }
+
+    scheduler->m_SnapshotPending = false;
+    scheduler->m_PreparationLock.Unlock();
+
+    const double preparationStart = RealTimeClock::GetTimeStamp();
+
+    SceneSnapshot::ConstPointer snapshot =
+      scheduler->m_Publisher->GetSnapshot();
+
+    PreparedFrame::Pointer frame = PreparedFrame::New();
+    frame->m_Version = snapshot->GetVersion();
+
+    const SceneSnapshot::RepresentationContainerType & representations =
+      snapshot->GetRepresentations();
+
+    SceneSnapshot::RepresentationContainerType::const_iterator it;
+    for( it = representations.begin(); it != representations.end(); ++it )
+      {
+      PreparedFrame::EntryType entry;
+      entry.Object = it->Object;
+      entry.View = it->View;
+      entry.Available =
+        snapshot->ComputeTransform( it->Object, it->View, entry.Transform );
+      frame->m_Entries[it->Representation] = entry;
+      }
+
+    scheduler->m_PreparationLock.Lock();
+    if( !scheduler->m_StopPreparation )
+      {
+      scheduler->m_PreparedFrame = frame.GetPointer();
+      scheduler->m_NumberOfPreparedFrames++;
+      scheduler->m_LastPreparationTime =
+        RealTimeClock::GetTimeStamp() - preparationStart;
+      }
+    scheduler->m_PreparationLock.Unlock();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void FrameScheduler::PrintSelf( std::ostream& os, itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfViews: " << this->GetNumberOfViews() << std::endl;
+  os << indent << "NumberOfFrames: " << m_NumberOfFrames << std::endl;
+  os << indent << "LastFrameTime: " << m_LastFrameTime << std::endl;
+  os << indent << "MeanFrameTime: " << this->GetMeanFrameTime() << std::endl;
+  os << indent << "MaximumFrameTime: " << m_MaximumFrameTime << std::endl;
+  os << indent << "NumberOfComputedTransforms: "
+     << m_NumberOfComputedTransforms << std::endl;
+  os << indent << "NumberOfSharedTransforms: "
+     << m_NumberOfSharedTransforms << std::endl;
+  os << indent << "NumberOfPreparedTransforms: "
+     << m_NumberOfPreparedTransforms << std::endl;
+  os << indent << "ThreadedFramePreparation: "
+     << m_ThreadedFramePreparation << std::endl;
+  os << indent << "NumberOfPreparedFrames: "
+     << this->GetNumberOfPreparedFrames() << std::endl;
+  os << indent << "LastPreparationTime: "
+     << this->GetLastPreparationTime() << std::endl;
+  os << indent << "PulseGenerator: " << std::endl;
+  m_PulseGenerator->Print( os, indent.GetNextIndent() );
+}
+
+} // end namespace igstk
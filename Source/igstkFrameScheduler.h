@@ -0,0 +1,271 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkFrameScheduler.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkFrameScheduler_h
+#define __igstkFrameScheduler_h
+
+#include "igstkObject.h"
+#include "igstkView.h"
+#include "igstkPulseGenerator.h"
+#include "igstkRigidTransform.h"
+#include "igstkCoordinateSystemTransformToResult.h"
+#include "igstkSceneSnapshotPublisher.h"
+
+#include "itkCommand.h"
+#include "itkMultiThreader.h"
+#include "itkMutexLock.h"
+#include "itkConditionVariable.h"
+
+#include <vector>
+#include <map>
+
+namespace igstk
+{
+
+/** \class FrameScheduler
+ *  \brief Refreshes a group of views together, from a single pulse.
+ *
+ *  Each View refreshes on the pulses of its own PulseGenerator: with
+ *  several views showing the same scene, every view asks every spatial
+ *  object for its transform at its own time, and the views are rendered
+ *  at unrelated moments.
+ *
+ *  The scheduler owns the pulse of the views added to it, which stop
+ *  using their own. At each pulse, it computes the transform of each
+ *  spatial object to the first view once, and the transform from the
+ *  first view to each other view once. The transform of an object to any
+ *  view is then composed from these two, and passed to the
+ *  representations of the object, which do not query the scene graph
+ *  themselves. The views are rendered back to back, and the duration of
+ *  the frames is measured.
+ *
+ *  When an object or a view is not connected to the first view, its
+ *  representations ask for their transforms as the View does.
+ *
+ *  A view that is added must still be started with View::RequestStart()
+ *  to be refreshed. A view that is removed, or that is still in the
+ *  group when the scheduler is destroyed, refreshes again on its own
+ *  pulses if it was started.
+ *
+ *  With the threaded frame preparation, the scene is published as
+ *  immutable snapshots by a SceneSnapshotPublisher, at most once per
+ *  pulse, when one of its coordinate systems changed. A preparation
+ *  thread resolves the transform of every representation to its view
+ *  from the latest snapshot, while the main thread keeps processing the
+ *  trackers. At each pulse, the main thread only hands the prepared
+ *  transforms to the representations and renders the views: the VTK
+ *  actors and the OpenGL contexts of the views belong to the thread of
+ *  the GUI, and are never touched by the preparation thread. When the
+ *  frame was prepared from an older snapshot than the latest one, or a
+ *  representation has no prepared transform, the representations are
+ *  updated as without the threaded preparation.
+ *
+ *  \sa View
+ *  \sa SceneSnapshotPublisher
+ *
+ *  \ingroup View
+ */
+class FrameScheduler : public Object
+{
+
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( FrameScheduler, Object )
+
+  /** Add a view to the group refreshed by the scheduler. The first view
+   *  is the one the transforms are computed to. */
+  void RequestAddView( View * view );
+
+  /** Remove a view from the group */
+  void RequestRemoveView( View * view );
+
+  /** Number of views in the group */
+  unsigned int GetNumberOfViews() const;
+
+  /** Frequency of the frames, in Hz */
+  void SetRefreshRate( double frequency );
+
+  /** Start and stop refreshing the views */
+  void RequestStart();
+  void RequestStop();
+
+  /** Refresh the views once, as at a pulse */
+  void RefreshFrame();
+
+  /** Number of frames refreshed since the statistics were reset */
+  igstkGetMacro( NumberOfFrames, unsigned long );
+
+  /** Duration of the last frame, and mean and largest durations of the
+   *  frames, in milliseconds, from the start of the transform
+   *  computations to the end of the last render */
+  igstkGetMacro( LastFrameTime, double );
+  double GetMeanFrameTime() const;
+  igstkGetMacro( MaximumFrameTime, double );
+
+  /** Transforms computed from the scene graph in the last frame, and
+   *  transforms of representations composed from them */
+  igstkGetMacro( NumberOfComputedTransforms, unsigned int );
+  igstkGetMacro( NumberOfSharedTransforms, unsigned int );
+
+  /** Reset the frame statistics */
+  void ResetFrameStatistics();
+
+  /** Prepare the transforms of the frames in a separate thread, from
+   *  snapshots of the scene. Off by default. */
+  void SetThreadedFramePreparation( bool threaded );
+  igstkGetMacro( ThreadedFramePreparation, bool );
+
+  /** Number of frames prepared by the preparation thread, and duration
+   *  of the last preparation, in milliseconds */
+  unsigned long GetNumberOfPreparedFrames() const;
+  double GetLastPreparationTime() const;
+
+  /** Transforms of representations taken from a prepared frame in the
+   *  last frame */
+  igstkGetMacro( NumberOfPreparedTransforms, unsigned int );
+
+protected:
+
+  FrameScheduler( void );
+  virtual ~FrameScheduler( void );
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  FrameScheduler(const Self&);   //purposely not implemented
+  void operator=(const Self&);   //purposely not implemented
+
+  typedef itk::SimpleMemberCommand< Self >    ObserverType;
+  typedef View::ObjectListType                ObjectListType;
+  typedef CoordinateSystemTransformToResult   TransformToResultType;
+
+  /** Transform of a spatial object or a view, computed once per frame */
+  struct FrameTransformType
+    {
+    bool              Available;
+    RigidTransform    Transform;
+    };
+
+  typedef std::map< const SpatialObject *, FrameTransformType >
+                                                    ObjectTransformMapType;
+  typedef std::vector< View::Pointer >              ViewContainerType;
+
+  /** Transforms of the representations to their views, resolved from a
+   *  snapshot by the preparation thread. It is not modified once it
+   *  replaced the previous one. */
+  class PreparedFrame : public ::itk::LightObject
+    {
+  public:
+    typedef PreparedFrame                     Self;
+    typedef ::itk::LightObject                Superclass;
+    typedef ::itk::SmartPointer< Self >       Pointer;
+    typedef ::itk::SmartPointer< const Self > ConstPointer;
+    itkNewMacro( Self );
+
+    struct EntryType
+      {
+      const CoordinateSystem *    Object;
+      const CoordinateSystem *    View;
+      bool                        Available;
+      RigidTransform              Transform;
+      };
+
+    typedef std::map< const ObjectRepresentation *, EntryType >
+                                                          EntryContainerType;
+
+    unsigned long         m_Version;
+    EntryContainerType    m_Entries;
+
+  protected:
+    PreparedFrame() { m_Version = 0; }
+    ~PreparedFrame() {}
+
+  private:
+    PreparedFrame(const Self&);   //purposely not implemented
+    void operator=(const Self&);  //purposely not implemented
+    };
+
+  /** Compute the transform of a spatial object or a view to the first
+   *  view, through the scene graph */
+  template < class TSource >
+  bool ComputeTransformToFirstView( TSource * source,
+                                    const CoordinateSystem * destination,
+                                    RigidTransform & transform );
+
+  /** Receive the transforms computed from the scene graph */
+  void TransformToCallback( const TransformToResultType & payload );
+
+  /** Update a representation with its transform to its view */
+  void UpdateRepresentation( ObjectRepresentation * representation,
+                             const TimeStamp & renderTime,
+                             const CoordinateSystem * viewCS,
+                             const RigidTransform & objectToView );
+
+  /** Give the representations of the refreshing views to the publisher */
+  void PublishRepresentations( const ViewContainerType & views );
+
+  /** Wake up the preparation thread on a new snapshot */
+  void SnapshotCallback();
+
+  static ITK_THREAD_RETURN_TYPE PreparationThreadFunction( void * info );
+
+  void StartPreparationThread();
+  void StopPreparationThread();
+
+  ViewContainerType               m_Views;
+
+  PulseGenerator::Pointer         m_PulseGenerator;
+  ObserverType::Pointer           m_PulseObserver;
+
+  /** Transforms of the current frame */
+  ObjectTransformMapType          m_ObjectTransforms;
+
+  /** Transform being computed */
+  const CoordinateSystem *        m_RequestedDestination;
+  bool                            m_TransformReceived;
+  Transform                       m_ReceivedTransform;
+
+  unsigned long                   m_NumberOfFrames;
+  double                          m_LastFrameTime;
+  double                          m_TotalFrameTime;
+  double                          m_MaximumFrameTime;
+  unsigned int                    m_NumberOfComputedTransforms;
+  unsigned int                    m_NumberOfSharedTransforms;
+  unsigned int                    m_NumberOfPreparedTransforms;
+
+  /** Threaded frame preparation */
+  bool                            m_ThreadedFramePreparation;
+  SceneSnapshotPublisher::Pointer m_Publisher;
+  ObserverType::Pointer           m_SnapshotObserver;
+  itk::MultiThreader::Pointer     m_PreparationThreader;
+  int                             m_PreparationThreadID;
+  bool                            m_PreparationThreadStarted;
+  bool                            m_StopPreparation;
+  bool                            m_SnapshotPending;
+  itk::ConditionVariable::Pointer m_SnapshotCondition;
+  mutable itk::SimpleMutexLock    m_PreparationLock;
+  PreparedFrame::ConstPointer     m_PreparedFrame;
+  unsigned long                   m_NumberOfPreparedFrames;
+  double                          m_LastPreparationTime;
+};
+
+} // end namespace igstk
+
+#endif // __igstkFrameScheduler_h
@@ -0,0 +1,749 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkImageResliceEngine.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+//Warning about: identifier was truncated to '255' characters in the debug
+// information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkImageResliceEngine.h"
+#include "igstkRealTimeClock.h"
+#include "igstkObliqueResliceKernel.h"
+
+#include "itkNumericTraits.h"
+#include "vnl/vnl_math.h"
+#include "vtkType.h"
+
+#include <math.h>
+
+namespace igstk
+{
+
+namespace
+{
+
+/** Largest number of pixels along each side of a slice */
+const unsigned int MAXIMUM_SLICE_SIZE = 4096;
+
+/** Round to the nearest integer */
+inline long RoundToLong( double value )
+{
+  return static_cast< long >( floor( value + 0.5 ) );
+}
+
+} // end anonymous namespace
+
+
+bool
+ImageResliceEngine::KeyType
+::operator<( const KeyType & key ) const
+{
+  if( m_Offset != key.m_Offset )
+    {
+    return m_Offset < key.m_Offset;
+    }
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    if( m_Normal[i] != key.m_Normal[i] )
+      {
+      return m_Normal[i] < key.m_Normal[i];
+      }
+    }
+  return m_Interpolation < key.m_Interpolation;
+}
+
+
+bool
+ImageResliceEngine::KeyType
+::SamePlaneOrientation( const KeyType & key ) const
+{
+  return m_Normal[0] == key.m_Normal[0] &&
+         m_Normal[1] == key.m_Normal[1] &&
+         m_Normal[2] == key.m_Normal[2] &&
+         m_Interpolation == key.m_Interpolation;
+}
+
+
+/** Constructor */
+ImageResliceEngine::ImageResliceEngine()
+{
+  m_VolumeBuffer = NULL;
+  m_VolumeScalarType = VTK_VOID;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    m_VolumeDimensions[i] = 0;
+    m_VolumeSpacing[i] = 1.0;
+    m_VolumeOrigin[i] = 0.0;
+    }
+
+  m_PositionQuantum = 0.5;
+  m_PositionQuantumSetByUser = false;
+  m_AngleQuantum = 0.25 * vnl_math::pi / 180.0;
+  m_CacheCapacity = 16;
+  m_BackgroundValue = 0.0;
+  m_NumberOfPrefetchSlices = 0;
+
+  m_CacheHits = 0;
+  m_CacheMisses = 0;
+  m_PrefetchedSlices = 0;
+  m_LastComputationTime = 0.0;
+
+  m_HasPreviousPlane = false;
+
+  m_Threader = itk::MultiThreader::New();
+
+  m_PrefetchThreader = itk::MultiThreader::New();
+  m_PrefetchThreadID = -1;
+  m_PrefetchThreadStarted = false;
+  m_StopPrefetch = false;
+  m_PrefetchCondition = itk::ConditionVariable::New();
+  m_ParametersGeneration = 0;
+}
+
+
+/** Destructor */
+ImageResliceEngine::~ImageResliceEngine()
+{
+  this->StopPrefetchThread();
+}
+
+
+bool
+ImageResliceEngine
+::SetInputVolume( const void * buffer, int vtkScalarType,
+                  const int dimensions[3],
+                  const double spacing[3],
+                  const double origin[3] )
+{
+  if( !ObliqueResliceKernel::IsScalarTypeSupported( vtkScalarType ) )
+    {
+    return false;
+    }
+
+  // The prefetch thread may be reading the previous volume
+  this->StopPrefetchThread();
+
+  m_CacheLock.Lock();
+
+  m_VolumeBuffer = buffer;
+  m_VolumeScalarType = vtkScalarType;
+
+  double minimumSpacing = itk::NumericTraits< double >::max();
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    m_VolumeDimensions[i] = dimensions[i];
+    m_VolumeSpacing[i] = spacing[i];
+    m_VolumeOrigin[i] = origin[i];
+    if( fabs( spacing[i] ) < minimumSpacing )
+      {
+      minimumSpacing = fabs( spacing[i] );
+      }
+    }
+
+  if( !m_PositionQuantumSetByUser )
+    {
+    m_PositionQuantum = 0.5 * minimumSpacing;
+    }
+
+  this->ResetCache();
+
+  m_CacheLock.Unlock();
+
+  return true;
+}
+
+
+void
+ImageResliceEngine::SetPositionQuantum( double millimeters )
+{
+  if( millimeters <= 0.0 )
+    {
+    return;
+    }
+  m_CacheLock.Lock();
+  m_PositionQuantum = millimeters;
+  m_PositionQuantumSetByUser = true;
+  this->ResetCache();
+  m_CacheLock.Unlock();
+}
+
+
+double
+ImageResliceEngine::GetPositionQuantum() const
+{
+  return m_PositionQuantum;
+}
+
+
+void
+ImageResliceEngine::SetAngleQuantum( double degrees )
+{
+  if( degrees <= 0.0 )
+    {
+    return;
+    }
+  m_CacheLock.Lock();
+  m_AngleQuantum = degrees * vnl_math::pi / 180.0;
+  this->ResetCache();
+  m_CacheLock.Unlock();
+}
+
+
+double
+ImageResliceEngine::GetAngleQuantum() const
+{
+  return m_AngleQuantum * 180.0 / vnl_math::pi;
+}
+
+
+void
+ImageResliceEngine::SetCacheCapacity( unsigned int numberOfSlices )
+{
+  m_CacheLock.Lock();
+  m_CacheCapacity = ( numberOfSlices > 0 ) ? numberOfSlices : 1;
+  while( m_CacheList.size() > m_CacheCapacity )
+    {
+    m_CacheIndex.erase( m_CacheList.back().first );
+    m_CacheList.pop_back();
+    }
+  m_CacheLock.Unlock();
+}
+
+
+unsigned int
+ImageResliceEngine::GetCacheCapacity() const
+{
+  return m_CacheCapacity;
+}
+
+
+void
+ImageResliceEngine::SetNumberOfThreads( int numberOfThreads )
+{
+  m_Threader->SetNumberOfThreads( numberOfThreads );
+}
+
+
+void
+ImageResliceEngine::SetBackgroundValue( float value )
+{
+  m_CacheLock.Lock();
+  m_BackgroundValue = value;
+  this->ResetCache();
+  m_CacheLock.Unlock();
+}
+
+
+void
+ImageResliceEngine::SetNumberOfPrefetchSlices( unsigned int numberOfSlices )
+{
+  m_NumberOfPrefetchSlices = numberOfSlices;
+  if( numberOfSlices == 0 )
+    {
+    this->StopPrefetchThread();
+    }
+}
+
+
+unsigned int
+ImageResliceEngine::GetNumberOfPrefetchSlices() const
+{
+  return m_NumberOfPrefetchSlices;
+}
+
+
+void
+ImageResliceEngine::FlushCache()
+{
+  m_CacheLock.Lock();
+  this->ResetCache();
+  m_CacheLock.Unlock();
+}
+
+
+unsigned long
+ImageResliceEngine::GetNumberOfCacheHits() const
+{
+  return m_CacheHits;
+}
+
+
+unsigned long
+ImageResliceEngine::GetNumberOfCacheMisses() const
+{
+  return m_CacheMisses;
+}
+
+
+unsigned long
+ImageResliceEngine::GetNumberOfPrefetchedSlices() const
+{
+  m_CacheLock.Lock();
+  const unsigned long prefetchedSlices = m_PrefetchedSlices;
+  m_CacheLock.Unlock();
+  return prefetchedSlices;
+}
+
+
+double
+ImageResliceEngine::GetLastComputationTime() const
+{
+  return m_LastComputationTime;
+}
+
+
+ImageResliceEngine::KeyType
+ImageResliceEngine
+::QuantizePlane( const VectorType & center, const VectorType & normal,
+                 InterpolationType interpolation ) const
+{
+  KeyType key;
+
+  VectorType unitNormal = normal;
+  const double norm = unitNormal.GetNorm();
+  if( norm > 0.0 )
+    {
+    unitNormal /= norm;
+    }
+  else
+    {
+    unitNormal[0] = 0.0;
+    unitNormal[1] = 0.0;
+    unitNormal[2] = 1.0;
+    }
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    key.m_Normal[i] = RoundToLong( unitNormal[i] / m_AngleQuantum );
+    }
+
+  // The offset is measured along the quantized normal, so that the key
+  // describes a single plane.
+  VectorType quantizedNormal;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    quantizedNormal[i] = key.m_Normal[i] * m_AngleQuantum;
+    }
+  quantizedNormal /= quantizedNormal.GetNorm();
+
+  key.m_Offset = RoundToLong( ( center * quantizedNormal ) /
+                              m_PositionQuantum );
+
+  // Cubic requests are served by the linear kernel
+  key.m_Interpolation =
+    ( interpolation == NearestNeighbor ) ? NearestNeighbor : Linear;
+
+  return key;
+}
+
+
+void
+ImageResliceEngine
+::GetCanonicalPlane( const KeyType & key, VectorType & center,
+                     VectorType & normal ) const
+{
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    normal[i] = key.m_Normal[i] * m_AngleQuantum;
+    }
+  normal /= normal.GetNorm();
+  center = normal * ( key.m_Offset * m_PositionQuantum );
+}
+
+
+void
+ImageResliceEngine
+::ComputeSliceGeometry( const VectorType & center,
+                        const VectorType & normal,
+                        Slice * slice ) const
+{
+  VectorType axis1;
+  VectorType axis2;
+
+  // Planes aligned with the volume axes use the volume axes, so that the
+  // pixels of orthogonal slices coincide with the voxels.
+  const double alignedTolerance = 1e-9;
+  if( fabs( fabs( normal[2] ) - 1.0 ) < alignedTolerance )
+    {
+    axis1[0] = 1.0; axis1[1] = 0.0; axis1[2] = 0.0;
+    axis2[0] = 0.0; axis2[1] = 1.0; axis2[2] = 0.0;
+    }
+  else if( fabs( fabs( normal[0] ) - 1.0 ) < alignedTolerance )
+    {
+    axis1[0] = 0.0; axis1[1] = 1.0; axis1[2] = 0.0;
+    axis2[0] = 0.0; axis2[1] = 0.0; axis2[2] = 1.0;
+    }
+  else if( fabs( fabs( normal[1] ) - 1.0 ) < alignedTolerance )
+    {
+    axis1[0] = 1.0; axis1[1] = 0.0; axis1[2] = 0.0;
+    axis2[0] = 0.0; axis2[1] = 0.0; axis2[2] = 1.0;
+    }
+  else
+    {
+    VectorType reference;
+    reference.Fill( 0.0 );
+    if( fabs( normal[0] ) < 0.9 )
+      {
+      reference[0] = 1.0;
+      }
+    else
+      {
+      reference[1] = 1.0;
+      }
+    axis1 = reference - normal * ( reference * normal );
+    axis1 /= axis1.GetNorm();
+    axis2 = itk::CrossProduct( normal, axis1 );
+    axis2 /= axis2.GetNorm();
+    }
+
+  double spacing = itk::NumericTraits< double >::max();
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    if( fabs( m_VolumeSpacing[i] ) < spacing )
+      {
+      spacing = fabs( m_VolumeSpacing[i] );
+      }
+    }
+
+  // Project the corners of the volume on the plane axes
+  double minimum1 = itk::NumericTraits< double >::max();
+  double maximum1 = -itk::NumericTraits< double >::max();
+  double minimum2 = itk::NumericTraits< double >::max();
+  double maximum2 = -itk::NumericTraits< double >::max();
+  for( unsigned int corner = 0; corner < 8; corner++ )
+    {
+    VectorType point;
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      const unsigned int index =
+        ( corner & ( 1 << i ) ) ? m_VolumeDimensions[i] - 1 : 0;
+      point[i] = m_VolumeOrigin[i] + index * m_VolumeSpacing[i] - center[i];
+      }
+    const double p1 = point * axis1;
+    const double p2 = point * axis2;
+    minimum1 = ( p1 < minimum1 ) ? p1 : minimum1;
+    maximum1 = ( p1 > maximum1 ) ? p1 : maximum1;
+    minimum2 = ( p2 < minimum2 ) ? p2 : minimum2;
+    maximum2 = ( p2 > maximum2 ) ? p2 : maximum2;
+    }
+
+  unsigned int size1 =
+    static_cast< unsigned int >( floor( ( maximum1 - minimum1 ) / spacing ) )
+                                                                          + 1;
+  unsigned int size2 =
+    static_cast< unsigned int >( floor( ( maximum2 - minimum2 ) / spacing ) )
+                                                                          + 1;
+  size1 = ( size1 > MAXIMUM_SLICE_SIZE ) ? MAXIMUM_SLICE_SIZE : size1;
+  size2 = ( size2 > MAXIMUM_SLICE_SIZE ) ? MAXIMUM_SLICE_SIZE : size2;
+
+  slice->m_Size[0] = size1;
+  slice->m_Size[1] = size2;
+  slice->m_Spacing[0] = spacing;
+  slice->m_Spacing[1] = spacing;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    slice->m_Origin[i] = center[i] + minimum1 * axis1[i] +
+                                     minimum2 * axis2[i];
+    slice->m_Axis1[i] = axis1[i];
+    slice->m_Axis2[i] = axis2[i];
+    slice->m_Normal[i] = normal[i];
+    }
+
+  slice->m_Buffer.resize( static_cast<size_t>( size1 ) * size2 );
+}
+
+
+void
+ImageResliceEngine
+::ComputeSlice( Slice * slice, InterpolationType interpolation,
+                float backgroundValue, bool multithreaded )
+{
+  if( slice->m_Buffer.empty() )
+    {
+    return;
+    }
+
+  ObliqueResliceKernel kernel;
+  kernel.SetInputVolume( m_VolumeBuffer, m_VolumeScalarType,
+                         m_VolumeDimensions, m_VolumeSpacing,
+                         m_VolumeOrigin );
+  kernel.SetOutputGeometry( slice->m_Origin, slice->m_Axis1, slice->m_Axis2,
+                            slice->m_Spacing, slice->m_Size );
+  kernel.SetLinearInterpolation( interpolation != NearestNeighbor );
+  kernel.SetBackgroundValue( backgroundValue );
+
+  // The prefetch thread does not use the multithreader, in order to leave
+  // the other cores to the slices that are requested right now.
+  kernel.Reslice( &( slice->m_Buffer[0] ),
+                  multithreaded ? m_Threader.GetPointer() : NULL );
+}
+
+
+ImageResliceEngine::SlicePointer
+ImageResliceEngine::FindInCache( const KeyType & key )
+{
+  CacheIndexType::iterator found = m_CacheIndex.find( key );
+  if( found == m_CacheIndex.end() )
+    {
+    return NULL;
+    }
+
+  // Move the entry to the front of the list: most recently used
+  m_CacheList.splice( m_CacheList.begin(), m_CacheList, found->second );
+  return found->second->second;
+}
+
+
+void
+ImageResliceEngine::ResetCache()
+{
+  m_CacheList.clear();
+  m_CacheIndex.clear();
+  m_PrefetchQueue.clear();
+  m_HasPreviousPlane = false;
+  m_ParametersGeneration++;
+}
+
+
+void
+ImageResliceEngine::InsertInCache( const KeyType & key, Slice * slice )
+{
+  if( m_CacheIndex.find( key ) != m_CacheIndex.end() )
+    {
+    return;
+    }
+
+  m_CacheList.push_front( CacheEntryType( key, slice ) );
+  m_CacheIndex[ key ] = m_CacheList.begin();
+
+  while( m_CacheList.size() > m_CacheCapacity )
+    {
+    m_CacheIndex.erase( m_CacheList.back().first );
+    m_CacheList.pop_back();
+    }
+}
+
+
+ImageResliceEngine::SlicePointer
+ImageResliceEngine
+::RequestSlice( const VectorType & center,
+                const VectorType & normal,
+                InterpolationType interpolation )
+{
+  if( m_VolumeBuffer == NULL )
+    {
+    return NULL;
+    }
+
+  const KeyType key = this->QuantizePlane( center, normal, interpolation );
+
+  m_CacheLock.Lock();
+  SlicePointer slice = this->FindInCache( key );
+  m_CacheLock.Unlock();
+
+  if( slice.IsNotNull() )
+    {
+    m_CacheHits++;
+    }
+  else
+    {
+    m_CacheMisses++;
+
+    const RealTimeClock::TimeStampType startTime =
+                                           RealTimeClock::GetTimeStamp();
+
+    VectorType canonicalCenter;
+    VectorType canonicalNormal;
+    this->GetCanonicalPlane( key, canonicalCenter, canonicalNormal );
+
+    slice = Slice::New();
+    this->ComputeSliceGeometry( canonicalCenter, canonicalNormal, slice );
+    this->ComputeSlice( slice,
+                        static_cast< InterpolationType >( key.m_Interpolation ),
+                        m_BackgroundValue, true );
+
+    m_LastComputationTime = RealTimeClock::GetTimeStamp() - startTime;
+
+    m_CacheLock.Lock();
+    this->InsertInCache( key, slice );
+    m_CacheLock.Unlock();
+    }
+
+  // Estimate the direction of motion of the plane and precompute the
+  // planes that are likely to be requested next.
+  if( m_NumberOfPrefetchSlices > 0 && m_HasPreviousPlane &&
+      key.SamePlaneOrientation( m_PreviousKey ) &&
+      key.m_Offset != m_PreviousKey.m_Offset )
+    {
+    this->SchedulePrefetch( key, key.m_Offset - m_PreviousKey.m_Offset );
+    }
+
+  m_PreviousKey = key;
+  m_HasPreviousPlane = true;
+
+  return slice;
+}
+
+
+void
+ImageResliceEngine
+::SchedulePrefetch( const KeyType & key, long offsetStep )
+{
+  this->StartPrefetchThread();
+
+  m_CacheLock.Lock();
+
+  // Requests that were not served yet are obsolete
+  m_PrefetchQueue.clear();
+
+  for( unsigned int k = 1; k <= m_NumberOfPrefetchSlices; k++ )
+    {
+    KeyType prefetchKey = key;
+    prefetchKey.m_Offset = key.m_Offset + static_cast< long >( k ) * offsetStep;
+    if( m_CacheIndex.find( prefetchKey ) == m_CacheIndex.end() )
+      {
+      m_PrefetchQueue.push_back( prefetchKey );
+      }
+    }
+
+  m_PrefetchCondition->Signal();
+  m_CacheLock.Unlock();
+}
+
+
+void
+ImageResliceEngine::StartPrefetchThread()
+{
+  if( m_PrefetchThreadStarted )
+    {
+    return;
+    }
+  m_StopPrefetch = false;
+  m_PrefetchThreadID =
+    m_PrefetchThreader->SpawnThread( PrefetchThreadFunction, this );
+  m_PrefetchThreadStarted = true;
+}
+
+
+void
+ImageResliceEngine::StopPrefetchThread()
+{
+  if( !m_PrefetchThreadStarted )
+    {
+    return;
+    }
+
+  m_CacheLock.Lock();
+  m_StopPrefetch = true;
+  m_PrefetchQueue.clear();
+  m_PrefetchCondition->Signal();
+  m_CacheLock.Unlock();
+
+  m_PrefetchThreader->TerminateThread( m_PrefetchThreadID );
+  m_PrefetchThreadStarted = false;
+}
+
+
+ITK_THREAD_RETURN_TYPE
+ImageResliceEngine::PrefetchThreadFunction( void * info )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)info;
+
+  if( pInfo == NULL || pInfo->UserData == NULL )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  ImageResliceEngine * engine =
+    static_cast< ImageResliceEngine * >( pInfo->UserData );
+
+  while( true )
+    {
+    engine->m_CacheLock.Lock();
+    while( !engine->m_StopPrefetch && engine->m_PrefetchQueue.empty() )
+      {
+      engine->m_PrefetchCondition->Wait( &engine->m_CacheLock );
+      }
+
+    if( engine->m_StopPrefetch )
+      {
+      engine->m_CacheLock.Unlock();
+      break;
+      }
+
+    const KeyType key = engine->m_PrefetchQueue.front();
+    engine->m_PrefetchQueue.pop_front();
+    if( engine->m_CacheIndex.find( key ) != engine->m_CacheIndex.end() )
+      {
+      engine->m_CacheLock.Unlock();
+      continue;
+      }
+
+    // The geometry depends on the quantization steps, which the setters
+    // may change while the pixels are computed. It is built, and the
+    // parameters are copied, before the lock is released.
+    VectorType center;
+    VectorType normal;
+    engine->GetCanonicalPlane( key, center, normal );
+
+    SlicePointer slice = Slice::New();
+    engine->ComputeSliceGeometry( center, normal, slice );
+    const float backgroundValue = engine->m_BackgroundValue;
+    const unsigned long generation = engine->m_ParametersGeneration;
+    engine->m_CacheLock.Unlock();
+
+    engine->ComputeSlice( slice,
+                        static_cast< InterpolationType >( key.m_Interpolation ),
+                        backgroundValue, false );
+
+    engine->m_CacheLock.Lock();
+    if( !engine->m_StopPrefetch &&
+        engine->m_ParametersGeneration == generation )
+      {
+      engine->InsertInCache( key, slice );
+      engine->m_PrefetchedSlices++;
+      }
+    engine->m_CacheLock.Unlock();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+
+void
+ImageResliceEngine::Print( std::ostream& os, itk::Indent indent ) const
+{
+  os << indent << "ImageResliceEngine (" << this << ")" << std::endl;
+  os << indent << "PositionQuantum: " << m_PositionQuantum << std::endl;
+  os << indent << "AngleQuantum: " << this->GetAngleQuantum() << std::endl;
+  os << indent << "CacheCapacity: " << m_CacheCapacity << std::endl;
+  m_CacheLock.Lock();
+  os << indent << "CacheSize: " << m_CacheList.size() << std::endl;
+  m_CacheLock.Unlock();
+  os << indent << "CacheHits: " << m_CacheHits << std::endl;
+  os << indent << "CacheMisses: " << m_CacheMisses << std::endl;
+  os << indent << "NumberOfPrefetchSlices: " << m_NumberOfPrefetchSlices
+     << std::endl;
+  os << indent << "PrefetchedSlices: " << this->GetNumberOfPrefetchedSlices()
+     << std::endl;
+  os << indent << "LastComputationTime: " << m_LastComputationTime
+     << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,277 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkImageResliceEngine.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __igstkImageResliceEngine_h
+#define __igstkImageResliceEngine_h
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "itkLightObject.h"
+#include "itkMultiThreader.h"
+#include "itkMutexLock.h"
+#include "itkConditionVariable.h"
+
+#include "igstkTransform.h"
+
+namespace igstk
+{
+
+/** \class ImageResliceEngine
+ *
+ * \brief CPU reslicing engine with a cache of recently computed slices.
+ *
+ * The engine extracts planar slices from a 3D volume. Requested planes are
+ * quantized, in position and in orientation, before any computation takes
+ * place. Two requests that fall in the same quantization cell are therefore
+ * answered with the very same slice, which is kept in a least recently used
+ * (LRU) cache keyed by the quantized plane and the interpolation mode. Tool
+ * motions below the quantization step do not trigger any new computation.
+ *
+ * Slices that are not found in the cache are computed with an
+ * ObliqueResliceKernel, trilinear or nearest neighbour, whose rows are
+ * split across the threads of an itk::MultiThreader.
+ *
+ * Optionally, the engine can speculatively precompute the slices that lie
+ * ahead of the plane along its last direction of motion. This work is done
+ * in a background thread and the results are stored in the same cache.
+ *
+ * This class does not depend on the VTK pipeline. The caller provides a
+ * pointer to the voxel buffer together with its geometry. The buffer must
+ * remain valid, and unmodified, until SetInputVolume() is invoked again.
+ *
+ * \ingroup ObjectRepresentation
+ */
+class ImageResliceEngine
+{
+
+public:
+
+  typedef Transform::VectorType      VectorType;
+
+  /** Interpolation modes. The numerical values match VTK_NEAREST_RESLICE
+   * and VTK_LINEAR_RESLICE, cubic interpolation requests are served with
+   * the linear kernel. */
+  typedef enum
+    {
+    NearestNeighbor = 0,
+    Linear = 1
+    } InterpolationType;
+
+  /** \class Slice
+   * \brief Result of a reslicing operation.
+   *
+   * The pixel buffer is stored row by row, the first pixel being located at
+   * the origin. Consecutive pixels are separated by Spacing[0] along Axis1
+   * and consecutive rows by Spacing[1] along Axis2. Slices are reference
+   * counted so that they can be held by the caller after they have been
+   * evicted from the cache. */
+  class Slice : public ::itk::LightObject
+    {
+  public:
+    typedef Slice                             Self;
+    typedef ::itk::LightObject                Superclass;
+    typedef ::itk::SmartPointer< Self >       Pointer;
+    typedef ::itk::SmartPointer< const Self > ConstPointer;
+    itkNewMacro( Self );
+
+    typedef std::vector< float >              BufferType;
+
+    BufferType      m_Buffer;
+    unsigned int    m_Size[2];
+    double          m_Spacing[2];
+    double          m_Origin[3];
+    double          m_Axis1[3];
+    double          m_Axis2[3];
+    double          m_Normal[3];
+
+  protected:
+    Slice() {}
+    ~Slice() {}
+
+  private:
+    Slice(const Self&);           //purposely not implemented
+    void operator=(const Self&);  //purposely not implemented
+    };
+
+  typedef Slice::Pointer                     SlicePointer;
+
+  /** Constructor and destructor */
+  ImageResliceEngine();
+  virtual ~ImageResliceEngine();
+
+  /** Set the volume to be resliced. The scalar type is given with the VTK
+   * type constants (VTK_SHORT, VTK_UNSIGNED_CHAR ...). Setting a new volume
+   * flushes the cache. Returns false if the scalar type is not supported. */
+  bool SetInputVolume( const void * buffer, int vtkScalarType,
+                       const int dimensions[3],
+                       const double spacing[3],
+                       const double origin[3] );
+
+  /** Return the slice for the plane going through center with the given
+   * normal. A NULL pointer is returned if no volume was set. */
+  SlicePointer RequestSlice( const VectorType & center,
+                             const VectorType & normal,
+                             InterpolationType interpolation );
+
+  /** Position quantization step in millimeters. The default value is half
+   * of the smallest voxel spacing. */
+  void SetPositionQuantum( double millimeters );
+  double GetPositionQuantum() const;
+
+  /** Orientation quantization step in degrees. The default is 0.25 deg. */
+  void SetAngleQuantum( double degrees );
+  double GetAngleQuantum() const;
+
+  /** Maximum number of slices kept in the cache. The default is 16. */
+  void SetCacheCapacity( unsigned int numberOfSlices );
+  unsigned int GetCacheCapacity() const;
+
+  /** Number of threads used for computing a slice. The default is the
+   * global default of the itk::MultiThreader. */
+  void SetNumberOfThreads( int numberOfThreads );
+
+  /** Value assigned to the pixels falling outside of the volume */
+  void SetBackgroundValue( float value );
+
+  /** Number of slices to precompute ahead of the plane along its direction
+   * of motion. Zero, the default, disables speculative precomputation. */
+  void SetNumberOfPrefetchSlices( unsigned int numberOfSlices );
+  unsigned int GetNumberOfPrefetchSlices() const;
+
+  /** Remove all the slices from the cache and forget the motion of the
+   * plane */
+  void FlushCache();
+
+  /** Cache statistics */
+  unsigned long GetNumberOfCacheHits() const;
+  unsigned long GetNumberOfCacheMisses() const;
+  unsigned long GetNumberOfPrefetchedSlices() const;
+
+  /** Time spent in the last slice computation, in milliseconds */
+  double GetLastComputationTime() const;
+
+  /** Print the object information in a stream. */
+  void Print( std::ostream& os, itk::Indent indent=0 ) const;
+
+private:
+
+  ImageResliceEngine(const ImageResliceEngine &); //purposely not implemented
+  void operator=(const ImageResliceEngine &);     //purposely not implemented
+
+  /** Key of the cache: quantized plane and interpolation mode */
+  struct KeyType
+    {
+    long m_Offset;
+    long m_Normal[3];
+    int  m_Interpolation;
+    bool operator<( const KeyType & key ) const;
+    bool SamePlaneOrientation( const KeyType & key ) const;
+    };
+
+  typedef std::pair< KeyType, SlicePointer >           CacheEntryType;
+  typedef std::list< CacheEntryType >                  CacheListType;
+  typedef std::map< KeyType, CacheListType::iterator > CacheIndexType;
+
+  /** Quantize a plane. Only the distance of the plane to the origin of
+   * the world coordinate system and the direction of its normal are
+   * retained. */
+  KeyType QuantizePlane( const VectorType & center, const VectorType & normal,
+                         InterpolationType interpolation ) const;
+
+  /** Compute the geometry of the slice for a canonical plane */
+  void ComputeSliceGeometry( const VectorType & center,
+                             const VectorType & normal,
+                             Slice * slice ) const;
+
+  /** Compute the pixels of a slice with an ObliqueResliceKernel, using
+   * the multithreader when multithreaded is true. */
+  void ComputeSlice( Slice * slice, InterpolationType interpolation,
+                     float backgroundValue, bool multithreaded );
+
+  /** Cache access. Must be called with m_CacheLock held */
+  SlicePointer FindInCache( const KeyType & key );
+  void InsertInCache( const KeyType & key, Slice * slice );
+
+  /** Empty the cache and the prefetch queue after a change of the
+   * parameters. Must be called with m_CacheLock held */
+  void ResetCache();
+
+  /** Queue the planes located ahead of the current plane */
+  void SchedulePrefetch( const KeyType & key, long offsetStep );
+
+  /** Build the canonical plane represented by a key */
+  void GetCanonicalPlane( const KeyType & key, VectorType & center,
+                          VectorType & normal ) const;
+
+  /** Thread function of the speculative precomputation */
+  static ITK_THREAD_RETURN_TYPE PrefetchThreadFunction( void * info );
+
+  void StartPrefetchThread();
+  void StopPrefetchThread();
+
+  /** Input volume */
+  const void *                     m_VolumeBuffer;
+  int                              m_VolumeScalarType;
+  int                              m_VolumeDimensions[3];
+  double                           m_VolumeSpacing[3];
+  double                           m_VolumeOrigin[3];
+
+  /** Parameters */
+  double                           m_PositionQuantum;
+  bool                             m_PositionQuantumSetByUser;
+  double                           m_AngleQuantum;
+  unsigned int                     m_CacheCapacity;
+  float                            m_BackgroundValue;
+  unsigned int                     m_NumberOfPrefetchSlices;
+
+  /** Cache */
+  CacheListType                    m_CacheList;
+  CacheIndexType                   m_CacheIndex;
+  mutable itk::SimpleMutexLock     m_CacheLock;
+
+  /** Statistics */
+  unsigned long                    m_CacheHits;
+  unsigned long                    m_CacheMisses;
+  unsigned long                    m_PrefetchedSlices;
+  double                           m_LastComputationTime;
+
+  /** Plane of the last request, used to estimate the motion direction */
+  bool                             m_HasPreviousPlane;
+  KeyType                          m_PreviousKey;
+
+  /** Multithreaded slice computation */
+  itk::MultiThreader::Pointer      m_Threader;
+
+  /** Speculative precomputation */
+  typedef std::list< KeyType >     PrefetchQueueType;
+
+  itk::MultiThreader::Pointer      m_PrefetchThreader;
+  int                              m_PrefetchThreadID;
+  bool                             m_PrefetchThreadStarted;
+  bool                             m_StopPrefetch;
+
+  /** Incremented under m_CacheLock whenever the parameters change, so that
+   * the prefetch thread drops the slices computed with the old ones */
+  unsigned long                    m_ParametersGeneration;
+  PrefetchQueueType                m_PrefetchQueue;
+  itk::ConditionVariable::Pointer  m_PrefetchCondition;
+};
+
+} // end namespace igstk
+
+#endif // __igstkImageResliceEngine_h
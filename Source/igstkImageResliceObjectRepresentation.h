@@ -22,6 +22,7 @@
 #include "igstkImageSpatialObject.h"
 #include "igstkStateMachine.h"
 #include "igstkReslicerPlaneSpatialObject.h"
+#include "igstkImageResliceEngine.h"
 
 class vtkImageMapToColors;
 class vtkPlaneSource;
@@ -29,6 +30,9 @@ class vtkPlane;
 class vtkImageSlice;
 class vtkImageResliceMapper;
 class vtkImageProperty;
+class vtkImageSliceMapper;
+class vtkFloatArray;
+class vtkMatrix4x4;
 
 namespace igstk
 {
@@ -87,6 +91,17 @@ public:
    * */
   void SetResliceInterpolate(int value);
 
+  /** Compute the slices on the CPU with an ImageResliceEngine instead of
+   * the vtkImageResliceMapper. Slices are cached, so that small motions of
+   * the reslicing plane do not trigger any computation. This option must
+   * be set before the representation is added to a View. Cubic
+   * interpolation is replaced by linear interpolation in this mode. */
+  void SetUseResliceEngine( bool value );
+  bool GetUseResliceEngine() const;
+
+  /** Give access to the reslice engine in order to tune its cache */
+  ImageResliceEngine * GetResliceEngine();
+
   /** Print the object information in a stream. */
   virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const; 
 
@@ -131,6 +146,16 @@ private:
 
   int    m_ResliceInterpolate;
 
+  /** Cached CPU reslicing. The slice buffer is shared with VTK, without
+   * copy, and m_CurrentSlice keeps it alive while it is displayed. */
+  bool                                   m_UseResliceEngine;
+  ImageResliceEngine                     m_ResliceEngine;
+  ImageResliceEngine::SlicePointer       m_CurrentSlice;
+  vtkImageData                          *m_SliceImageData;
+  vtkFloatArray                         *m_SliceArray;
+  vtkImageSliceMapper                   *m_ImageSliceMapper;
+  vtkMatrix4x4                          *m_SliceMatrix;
+
   /** Variables that store window and level values for 2D image display */
   double                                 m_Level;
   double                                 m_Window;
@@ -177,6 +202,10 @@ private:
   
   /** Connect VTK pipeline */
   void ConnectVTKPipelineProcessing();
+
+  /** Display the slice returned by the reslice engine for a plane */
+  void UpdateEngineSlice( const VectorType & center,
+                          const VectorType & normal );
     
   /** Declare the observer that will receive a VTK image from the
    * ImageSpatialObject */
@@ -31,6 +31,10 @@
 #include <vtkImageResliceMapper.h>
 #include <vtkImageProperty.h>
 #include <vtkImageSlice.h>
+#include <vtkImageSliceMapper.h>
+#include <vtkFloatArray.h>
+#include <vtkPointData.h>
+#include <vtkMatrix4x4.h>
 
 namespace igstk
 {
@@ -65,6 +69,14 @@ ImageResliceObjectRepresentation< TImageSpatialObject >
 
   m_ResliceInterpolate       = VTK_NEAREST_RESLICE;
 
+  m_ImageResliceMapper = NULL;
+
+  m_UseResliceEngine = false;
+  m_SliceImageData = NULL;
+  m_SliceArray = NULL;
+  m_ImageSliceMapper = NULL;
+  m_SliceMatrix = NULL;
+
   m_PlaneSource = vtkPlaneSource::New();
   m_PlaneSource->SetXResolution(1);
   m_PlaneSource->SetYResolution(1);
@@ -171,6 +183,30 @@ ImageResliceObjectRepresentation< TImageSpatialObject >
     {
     m_ImageData = NULL;
     }
+
+  if ( m_ImageSliceMapper != NULL )
+    {
+    m_ImageSliceMapper->Delete();
+    m_ImageSliceMapper = NULL;
+    }
+
+  if ( m_SliceImageData != NULL )
+    {
+    m_SliceImageData->Delete();
+    m_SliceImageData = NULL;
+    }
+
+  if ( m_SliceArray != NULL )
+    {
+    m_SliceArray->Delete();
+    m_SliceArray = NULL;
+    }
+
+  if ( m_SliceMatrix != NULL )
+    {
+    m_SliceMatrix->Delete();
+    m_SliceMatrix = NULL;
+    }
 }
 
 
@@ -562,9 +598,92 @@ ImageResliceObjectRepresentation< TImageSpatialObject >
   else
     return;
 
+  if( m_UseResliceEngine )
+    {
+    this->UpdateEngineSlice( reslicerPlaneCenter, reslicerPlaneNormal );
+    return;
+    }
+
   m_ImageResliceMapper->SetSlicePlane(m_Plane);
 }
 
+
+/** Display the slice computed by the reslice engine */
+template < class TImageSpatialObject >
+void
+ImageResliceObjectRepresentation< TImageSpatialObject >
+::UpdateEngineSlice( const VectorType & center, const VectorType & normal )
+{
+  igstkLogMacro( DEBUG, "igstk::ImageResliceObjectRepresentation::\
+                         UpdateEngineSlice called...\n");
+
+  if( m_SliceImageData == NULL )
+    {
+    return;
+    }
+
+  ImageResliceEngine::InterpolationType interpolation =
+    ( m_ResliceInterpolate == VTK_NEAREST_RESLICE ) ?
+      ImageResliceEngine::NearestNeighbor : ImageResliceEngine::Linear;
+
+  ImageResliceEngine::SlicePointer slice =
+    m_ResliceEngine.RequestSlice( center, normal, interpolation );
+
+  if( slice.IsNull() )
+    {
+    return;
+    }
+
+  // The plane did not move by more than the quantization step: the slice
+  // currently displayed is still valid and its data does not need any
+  // update.
+  if( slice.GetPointer() != m_CurrentSlice.GetPointer() )
+    {
+    m_CurrentSlice = slice;
+
+    const unsigned int * size = slice->m_Size;
+
+    // Share the buffer of the slice with VTK, the last argument prevents
+    // VTK from deleting it.
+    m_SliceArray->SetArray( &( slice->m_Buffer[0] ),
+                            static_cast< vtkIdType >( size[0] ) * size[1], 1 );
+    m_SliceArray->Modified();
+
+    m_SliceImageData->SetDimensions( size[0], size[1], 1 );
+    m_SliceImageData->SetWholeExtent( 0, size[0] - 1, 0, size[1] - 1, 0, 0 );
+    m_SliceImageData->SetSpacing( slice->m_Spacing[0],
+                                  slice->m_Spacing[1], 1.0 );
+    m_SliceImageData->SetOrigin( 0.0, 0.0, 0.0 );
+    m_SliceImageData->GetPointData()->SetScalars( m_SliceArray );
+    m_SliceImageData->Modified();
+
+    // Place the slice in the image with the axes of the plane
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      m_SliceMatrix->SetElement( i, 0, slice->m_Axis1[i] );
+      m_SliceMatrix->SetElement( i, 1, slice->m_Axis2[i] );
+      m_SliceMatrix->SetElement( i, 2, slice->m_Normal[i] );
+      m_SliceMatrix->SetElement( i, 3, slice->m_Origin[i] );
+      }
+    m_SliceMatrix->Modified();
+    }
+
+  // The superclass has just set the transform of the image spatial object
+  // in the user matrix of the actors. The slice is placed in the image, and
+  // then moved with it. A new matrix is set on every update, because the
+  // actor ignores a user matrix that it already has.
+  vtkMatrix4x4 * spatialObjectMatrix = vtkMatrix4x4::New();
+  this->GetSpatialObjectTransform().ExportTransform( *spatialObjectMatrix );
+
+  vtkMatrix4x4 * placementMatrix = vtkMatrix4x4::New();
+  vtkMatrix4x4::Multiply4x4( spatialObjectMatrix, m_SliceMatrix,
+                             placementMatrix );
+  m_ImageSlice->SetUserMatrix( placementMatrix );
+
+  placementMatrix->Delete();
+  spatialObjectMatrix->Delete();
+}
+
 /** Create the vtk Actors */
 template < class TImageSpatialObject >
 void
@@ -606,6 +725,52 @@ ImageResliceObjectRepresentation< TImageSpatialObject >
 {
   this->SetResliceInterpolate(m_ResliceInterpolate);
 
+  if( m_UseResliceEngine && m_ImageData )
+    {
+    m_ImageData->Update();
+
+    int dimensions[3];
+    double origin[3];
+    double spacing[3];
+    int extent[6];
+    m_ImageData->GetDimensions( dimensions );
+    m_ImageData->GetSpacing( spacing );
+    m_ImageData->GetOrigin( origin );
+    m_ImageData->GetExtent( extent );
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      origin[i] += extent[2*i] * spacing[i];
+      }
+
+    if( m_ImageData->GetNumberOfScalarComponents() == 1 &&
+        m_ResliceEngine.SetInputVolume( m_ImageData->GetScalarPointer(),
+                                        m_ImageData->GetScalarType(),
+                                        dimensions, spacing, origin ) )
+      {
+      if( m_SliceImageData == NULL )
+        {
+        m_SliceArray = vtkFloatArray::New();
+        m_SliceImageData = vtkImageData::New();
+        m_SliceImageData->SetScalarTypeToFloat();
+        m_SliceImageData->SetNumberOfScalarComponents( 1 );
+        m_ImageSliceMapper = vtkImageSliceMapper::New();
+        m_ImageSliceMapper->SetInput( m_SliceImageData );
+        m_ImageSliceMapper->BorderOn();
+        m_SliceMatrix = vtkMatrix4x4::New();
+        }
+      m_CurrentSlice = NULL;
+
+      m_ImageSlice->SetMapper( m_ImageSliceMapper );
+      m_ImageSlice->SetProperty( m_ImageProperty );
+      return;
+      }
+
+    igstkLogMacro( WARNING, "igstk::ImageResliceObjectRepresentation\
+                   ::ConnectVTKPipelineProcessing: image not supported by\
+                   the reslice engine, using vtkImageResliceMapper.\n");
+    m_UseResliceEngine = false;
+    }
+
   // Setting of vtkImageResliceMapper
 	m_ImageResliceMapper = vtkImageResliceMapper::New();
   m_ImageResliceMapper->SetInput(m_ImageData);
@@ -670,6 +835,31 @@ void ImageResliceObjectRepresentation< TImageSpatialObject >
     }
 }
 
+template < class TImageSpatialObject >
+void ImageResliceObjectRepresentation< TImageSpatialObject >
+::SetUseResliceEngine( bool value )
+{
+  igstkLogMacro( DEBUG, "igstk::ImageResliceObjectRepresentation\
+                        ::SetUseResliceEngine called...\n");
+
+  m_UseResliceEngine = value;
+}
+
+template < class TImageSpatialObject >
+bool ImageResliceObjectRepresentation< TImageSpatialObject >
+::GetUseResliceEngine() const
+{
+  return m_UseResliceEngine;
+}
+
+template < class TImageSpatialObject >
+ImageResliceEngine *
+ImageResliceObjectRepresentation< TImageSpatialObject >
+::GetResliceEngine()
+{
+  return &m_ResliceEngine;
+}
+
 /** Create a copy of the current object representation */
 template < class TImageSpatialObject >
 typename ImageResliceObjectRepresentation< TImageSpatialObject >::Pointer
@@ -682,6 +872,7 @@ ImageResliceObjectRepresentation< TImageSpatialObject >
   Pointer newOR = ImageResliceObjectRepresentation::New();
   newOR->SetColor( this->GetRed(),this->GetGreen(),this->GetBlue() );
   newOR->SetOpacity( this->GetOpacity() );
+  newOR->SetUseResliceEngine( m_UseResliceEngine );
   newOR->RequestSetImageSpatialObject( m_ImageSpatialObject );
   newOR->RequestSetReslicePlaneSpatialObject( m_ReslicePlaneSpatialObject );
 
@@ -34,6 +34,7 @@ namespace Friends
 {
 class ImageReaderToImageSpatialObject;
 class UltrasoundImageSimulatorToImageSpatialObject;
+class USVolumeReconstructorToImageSpatialObject;
 }
 
 
@@ -99,6 +100,11 @@ public:
   igstkFriendClassMacro( 
       igstk::Friends::UltrasoundImageSimulatorToImageSpatialObject );
 
+  /** The USVolumeReconstructorToImageSpatialObject class is declared as a
+   * friend in order to be able to set the reconstructed image */
+  igstkFriendClassMacro(
+      igstk::Friends::USVolumeReconstructorToImageSpatialObject );
+
   /** Request to get the ITK image as a const pointer payload into an event.
       Both the const and non-const versions are needed. */
   void RequestGetITKImage();
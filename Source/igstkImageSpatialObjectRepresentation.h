@@ -21,10 +21,9 @@
 #include "igstkObjectRepresentation.h"
 #include "igstkImageSpatialObject.h"
 #include "igstkStateMachine.h"
+#include "igstkColorMappedSliceCache.h"
 
 #include "vtkImageActor.h"
-#include "vtkLookupTable.h"
-#include "vtkImageMapToColors.h"
 
 namespace igstk
 {
@@ -38,6 +37,10 @@ namespace igstk
  * You can select the orientation of the slice to be Axial, Sagittal or Coronal.
  * The number of the slice to be rendered can also be selected, as well as 
  * values of opacity, window and level.
+ *
+ * The colour mapped slice is obtained from the ColorMappedSliceCache, so
+ * the representations of an image displayed in several Views share it as
+ * long as they show the same slice with the same window, level and colour.
  * 
  *\image html igstkImageSpatialObjectRepresentation.png "State Machine Diagram"
  *
@@ -138,8 +141,12 @@ private:
   /** VTK classes that support display of an image */
   vtkImageData                         * m_ImageData;
   vtkImageActor                        * m_ImageActor;
-  vtkLookupTable                       * m_LUT;
-  vtkImageMapToColors                  * m_MapColors;
+
+  /** Colour mapped slice displayed by the actor, and its parameters */
+  vtkImageData                         * m_ColorMappedSlice;
+  ColorMappedSliceCache::KeyType         m_SliceKey;
+  bool                                   m_SliceAcquired;
+  int                                    m_DisplayExtent[6];
 
   /** Variables that store window and level values for 2D image display */
   double                                 m_Level;
@@ -174,6 +181,10 @@ private:
 
   /** Connect VTK pipeline */
   void ConnectVTKPipelineProcessing();
+
+  /** Get the colour mapped slice for the current display extent, window,
+   *  level and colour from the cache, and give it to the actor */
+  void UpdateColorMappedSlice();
     
 private:
 
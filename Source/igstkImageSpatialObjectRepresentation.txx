@@ -49,10 +49,15 @@ ImageSpatialObjectRepresentation< TImageSpatialObject >
   m_ImageActor = vtkImageActor::New();
   this->AddActor( m_ImageActor );
 
-  m_MapColors  = vtkImageMapToColors::New();
-  m_LUT        = vtkLookupTable::New();
   m_ImageData  = NULL;
 
+  m_ColorMappedSlice = NULL;
+  m_SliceAcquired = false;
+  for( unsigned int i = 0; i < 6; i++ )
+    {
+    m_DisplayExtent[i] = 0;
+    }
+
   // Set default values for window and level
   m_Level = 0;
   m_Window = 2000;
@@ -183,20 +188,11 @@ ImageSpatialObjectRepresentation< TImageSpatialObject >
   // This deletes also the m_ImageActor
   this->DeleteActors();
 
-
-  if( m_MapColors )
-    {
-    m_MapColors->SetLookupTable( NULL );
-    m_MapColors->SetInput( NULL );
-    m_MapColors->Delete();
-    m_MapColors = NULL;
-    }
-
-    
-  if( m_LUT )
+  if( m_SliceAcquired )
     {
-    m_LUT->Delete();
-    m_LUT = NULL;
+    ColorMappedSliceCache::Release( m_SliceKey );
+    m_SliceAcquired = false;
+    m_ColorMappedSlice = NULL;
     }
 }
 
@@ -348,25 +344,25 @@ ImageSpatialObjectRepresentation< TImageSpatialObject >
 
   m_SliceNumber = m_SliceNumberToBeSet;
 
-  int ext[6];
-  m_ImageData->GetExtent( ext );
+  m_ImageData->GetExtent( m_DisplayExtent );
 
   switch( m_Orientation )
     {
     case Axial:
-      m_ImageActor->SetDisplayExtent( ext[0], ext[1], ext[2], 
-                                      ext[3], m_SliceNumber, m_SliceNumber );
+      m_DisplayExtent[4] = m_SliceNumber;
+      m_DisplayExtent[5] = m_SliceNumber;
       break;
     case Sagittal:
-      m_ImageActor->SetDisplayExtent( m_SliceNumber, m_SliceNumber, 
-                                      ext[2], ext[3], ext[4], ext[5] );
+      m_DisplayExtent[0] = m_SliceNumber;
+      m_DisplayExtent[1] = m_SliceNumber;
       break;
     case Coronal:
-      m_ImageActor->SetDisplayExtent( ext[0], ext[1], m_SliceNumber, 
-                                      m_SliceNumber, ext[4], ext[5] );
+      m_DisplayExtent[2] = m_SliceNumber;
+      m_DisplayExtent[3] = m_SliceNumber;
       break;
     }
 
+  this->UpdateColorMappedSlice();
 }
 
 
@@ -381,7 +377,7 @@ ImageSpatialObjectRepresentation< TImageSpatialObject >
   m_Window = window;
   m_Level = level;
 
-  m_LUT->SetTableRange ( (m_Level - m_Window/2.0), (m_Level + m_Window/2.0) );
+  this->UpdateColorMappedSlice();
 }
 
 /** Null Operation for a State Machine Transition */
@@ -427,8 +423,23 @@ ImageSpatialObjectRepresentation< TImageSpatialObject >
     if( this->m_ImageData )
       {
       this->m_ImageData->Update();
+
+      // Until a slice number is set, the first slice of the orientation
+      // is displayed. The whole volume is never colour mapped.
+      this->m_ImageData->GetExtent( this->m_DisplayExtent );
+      switch( this->m_Orientation )
+        {
+        case Axial:
+          this->m_DisplayExtent[5] = this->m_DisplayExtent[4];
+          break;
+        case Sagittal:
+          this->m_DisplayExtent[1] = this->m_DisplayExtent[0];
+          break;
+        case Coronal:
+          this->m_DisplayExtent[3] = this->m_DisplayExtent[2];
+          break;
+        }
       }
-    this->m_MapColors->SetInput( this->m_ImageData );
     }
 
   this->m_ImageTransformObserver->Reset();
@@ -452,7 +463,7 @@ ImageSpatialObjectRepresentation< TImageSpatialObject >
     imageTransformMatrix->Delete();
     }
 
-  this->m_ImageActor->SetInput( this->m_MapColors->GetOutput() );
+  this->UpdateColorMappedSlice();
 }
 
 
@@ -475,10 +486,7 @@ ImageSpatialObjectRepresentation< TImageSpatialObject >
 {
   igstkLogMacro( DEBUG, "igstk::ImageSpatialObjectRepresentation\
                        ::UpdateRepresentationProcessing called...\n");
-  if( m_ImageData )
-    {
-    m_MapColors->SetInput( m_ImageData );
-    }
+  this->UpdateColorMappedSlice();
 }
 
 
@@ -500,25 +508,6 @@ ImageSpatialObjectRepresentation< TImageSpatialObject >
     
   this->AddActor( m_ImageActor );
 
-  //convert RGB to HSV
-  double hue = 0.0;
-  double saturation = 0.0;
-  double value = 1.0;
-
-  vtkMath::RGBToHSV( this->GetRed(),
-                     this->GetGreen(),
-                     this->GetBlue(),
-                     &hue,&saturation,&value );
-
-  m_LUT->SetTableRange ( (m_Level - m_Window/2.0), (m_Level + m_Window/2.0) );
-  m_LUT->SetSaturationRange (saturation, saturation);
-  m_LUT->SetAlphaRange (m_Opacity, m_Opacity);
-  m_LUT->SetHueRange (hue, hue);
-  m_LUT->SetValueRange (0, value);
-  m_LUT->SetRampToLinear();
-
-  m_MapColors->SetLookupTable( m_LUT );
-
   igstkPushInputMacro( ConnectVTKPipeline );
   m_StateMachine.ProcessInputs(); 
 
@@ -614,11 +603,57 @@ void
 ImageSpatialObjectRepresentation< TImageSpatialObject >
 ::ConnectVTKPipelineProcessing() 
 {
-  m_MapColors->SetInput( m_ImageData );
-  m_ImageActor->SetInput( m_MapColors->GetOutput() );
+  this->UpdateColorMappedSlice();
   m_ImageActor->InterpolateOn();
 }
 
+template < class TImageSpatialObject >
+void
+ImageSpatialObjectRepresentation< TImageSpatialObject >
+::UpdateColorMappedSlice() 
+{
+  if( !m_ImageData || !m_ImageActor )
+    {
+    return;
+    }
+
+  ColorMappedSliceCache::KeyType key;
+  key.m_Image = m_ImageData;
+  for( unsigned int i = 0; i < 6; i++ )
+    {
+    key.m_Extent[i] = m_DisplayExtent[i];
+    }
+  key.m_Window = m_Window;
+  key.m_Level = m_Level;
+  key.m_Opacity = m_Opacity;
+
+  //convert RGB to HSV
+  vtkMath::RGBToHSV( this->GetRed(),
+                     this->GetGreen(),
+                     this->GetBlue(),
+                     &key.m_Hue, &key.m_Saturation, &key.m_Value );
+
+  m_ImageActor->SetDisplayExtent( m_DisplayExtent );
+
+  if( !m_SliceAcquired )
+    {
+    m_ColorMappedSlice = ColorMappedSliceCache::Acquire( key );
+    }
+  else if( key == m_SliceKey )
+    {
+    // Colour the slice again if the image was modified
+    ColorMappedSliceCache::Update( key );
+    }
+  else
+    {
+    m_ColorMappedSlice = ColorMappedSliceCache::Exchange( m_SliceKey, key );
+    }
+
+  m_SliceKey = key;
+  m_SliceAcquired = true;
+  m_ImageActor->SetInput( m_ColorMappedSlice );
+}
+
 /** Set the opacity */
 template < class TImageSpatialObject >
 void
@@ -201,30 +201,28 @@ InfiniTrackTracker::ResultType InfiniTrackTracker::InternalUpdateStatus( void )
     return FAILURE;
   }
 
-  TrackerToolsContainerType trackerToolContainer = GetTrackerToolContainer();
-
   for (size_t t = 0; t < this->m_pvecMarkerPos [m_iProcessed].size (); t++)
     {
     itkMarkerPos* pMarker = this->m_pvecMarkerPos [m_iProcessed] [t];
 
-    std::string tool = "";
+    TrackerToolSlotType slot = InvalidTrackerToolSlot;
 
     for (size_t u = 0; u < this->m_vecTrackerToolID.size (); u++)
       {
       if (this->m_vecTrackerToolID [u].m_u32GeometryID == 
               pMarker->mu32GeometryID)
         {
-        tool = this->m_vecTrackerToolID [u].m_TrackerToolName;
+        slot = this->m_vecTrackerToolID [u].m_TrackerToolSlot;
         }
       }
 
-    if (tool == "")
+    if (slot == InvalidTrackerToolSlot)
       {
       continue;
       }
 
     // report to the tracker tool that the tracker is Visible
-    this->ReportTrackingToolVisible(trackerToolContainer[tool]);
+    this->ReportTrackingToolVisible(slot);
 
     // create the transform
     TransformType transform;
@@ -267,9 +265,9 @@ InfiniTrackTracker::ResultType InfiniTrackTracker::InternalUpdateStatus( void )
                                         this->GetValidityTime());
 
     // set the raw transform
-    this->SetTrackerToolRawTransform(trackerToolContainer [tool], transform );
+    this->SetTrackerToolRawTransform(slot, transform );
 
-    this->SetTrackerToolTransformUpdate(trackerToolContainer [tool], true );
+    this->SetTrackerToolTransformUpdate(slot, true );
     }
 
   return SUCCESS;
@@ -518,6 +516,7 @@ InfiniTrackTracker::AddTrackerToolToInternalDataContainers (
 
   TrackerID.m_TrackerToolName = pInfiniTrackTrackerTool->GetMarkerName ();
   TrackerID.m_u32GeometryID   = marker.mu32GeometryID;
+  TrackerID.m_TrackerToolSlot = this->GetTrackerToolSlot (trackerTool);
 
   this->m_vecTrackerToolID.push_back (TrackerID);
 
@@ -185,7 +185,8 @@ private:
 
   /** The tracker tool <-> marker identification */
   struct TrackerToolIdentification 
-    {std::string m_TrackerToolName; unsigned long m_u32GeometryID;}; 
+    {std::string m_TrackerToolName; unsigned long m_u32GeometryID;
+     TrackerToolSlotType m_TrackerToolSlot;}; 
 
   std::vector <TrackerToolIdentification> m_vecTrackerToolID;
 
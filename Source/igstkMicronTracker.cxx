@@ -35,6 +35,7 @@
 
 
 #include <math.h>
+#include <algorithm>
 
 #include "igstkMicronTracker.h"
 #include "igstkMicronTrackerTool.h"
@@ -486,32 +487,31 @@ MicronTracker::ResultType MicronTracker::InternalUpdateStatus()
   // accessing it.
   m_BufferLock->Lock();
 
-  typedef TrackerToolTransformContainerType::const_iterator  InputConstIterator;
+  const TrackerToolSlotType numberOfSlots = 
+    static_cast< TrackerToolSlotType >( this->m_ToolStatusContainer.size() );
 
-  InputConstIterator inputItr = this->m_ToolTransformBuffer.begin();
-  InputConstIterator inputEnd = this->m_ToolTransformBuffer.end();
-
-  TrackerToolsContainerType trackerToolContainer =
-    this->GetTrackerToolContainer();
-
-  unsigned int toolId = 0;
-
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
+    if( !this->GetTrackerToolInSlot( slot ) )
+      {
+      continue;
+      }
+
     // only report tools that are in view
-    if (! this->m_ToolStatusContainer[inputItr->first])
+    if (! this->m_ToolStatusContainer[slot])
       {
       igstkLogMacro( DEBUG, "igstk::MicronTracker::InternalUpdateStatus: " <<
-                     "tool " << inputItr->first << " is not in view\n");
+                     "tool in slot " << slot << " is not in view\n");
       // report to the tracker tool that the tracker is not available
-      this->ReportTrackingToolNotAvailable(
-        trackerToolContainer[inputItr->first]);
+      this->ReportTrackingToolNotAvailable( slot );
 
-      ++inputItr;
       continue;
       }
     // report to the tracker tool that the tracker is Visible
-    this->ReportTrackingToolVisible(trackerToolContainer[inputItr->first]);
+    this->ReportTrackingToolVisible( slot );
+
+    const double * toolTransform = 
+      &this->m_ToolTransformBuffer[ slot * TransformSize ];
 
     // create the transform
     TransformType transform;
@@ -519,17 +519,17 @@ MicronTracker::ResultType MicronTracker::InternalUpdateStatus()
     typedef TransformType::VectorType TranslationType;
     TranslationType translation;
 
-    translation[0] = (inputItr->second)[0];
-    translation[1] = (inputItr->second)[1];
-    translation[2] = (inputItr->second)[2];
+    translation[0] = toolTransform[0];
+    translation[1] = toolTransform[1];
+    translation[2] = toolTransform[2];
 
     typedef TransformType::VersorType RotationType;
     RotationType rotation;
 
-    rotation.Set( (inputItr->second)[3],
-                   (inputItr->second)[4],
-                   (inputItr->second)[5],
-                   (inputItr->second)[6]);
+    rotation.Set( toolTransform[3],
+                  toolTransform[4],
+                  toolTransform[5],
+                  toolTransform[6]);
 
     // report error value
     // Get error value from the tracker. TODO
@@ -541,14 +541,9 @@ MicronTracker::ResultType MicronTracker::InternalUpdateStatus()
                                         this->GetValidityTime());
 
     // set the raw transform
-    this->SetTrackerToolRawTransform(
-      trackerToolContainer[inputItr->first], transform );
+    this->SetTrackerToolRawTransform( slot, transform );
 
-    this->SetTrackerToolTransformUpdate(
-      trackerToolContainer[inputItr->first], true );
-
-    ++inputItr;
-    ++toolId;
+    this->SetTrackerToolTransformUpdate( slot, true );
     }
 
   m_BufferLock->Unlock();
@@ -589,15 +584,8 @@ MicronTracker::ResultType MicronTracker::InternalThreadedUpdateStatus( void )
   m_BufferLock->Lock();
  
   // First, reset the status of all the tracker tools
-  typedef TrackerToolTransformContainerType::const_iterator  InputConstIterator;
-  InputConstIterator inputItr = this->m_ToolTransformBuffer.begin();
-  InputConstIterator inputEnd = this->m_ToolTransformBuffer.end();
-
-  while( inputItr != inputEnd )
-    {
-    this->m_ToolStatusContainer[inputItr->first] = 0;
-    ++inputItr;
-    }
+  std::fill( this->m_ToolStatusContainer.begin(), 
+             this->m_ToolStatusContainer.end(), 0 );
 
   Collection* markersCollection =
     new Collection(this->m_Markers->identifiedMarkers(this->m_SelectedCamera));
@@ -632,44 +620,34 @@ MicronTracker::ResultType MicronTracker::InternalThreadedUpdateStatus( void )
         // SetCalibrationTransform method in the trackertool and the Tracker
         // base class will computed the composition.
 
-        // Add the translation and rotation to the transform buffer
-        std::vector < double > transform;
-
-        double translation[3];
-        //the first three are translation
-        translation[0] = Marker2CurrCameraXf->getShift(0);
-        translation[1] = Marker2CurrCameraXf->getShift(1);
-        translation[2] = Marker2CurrCameraXf->getShift(2);
-
-        transform.push_back( translation[0] );
-        transform.push_back( translation[1] );
-        transform.push_back( translation[2] );
-
-        //the next four are quaternion
-        double quaternion[4];
-
-        quaternion[0] = -1.0 * Marker2CurrCameraXf->getQuaternion(0);
-        quaternion[1] = -1.0 * Marker2CurrCameraXf->getQuaternion(1);
-        quaternion[2] = -1.0 * Marker2CurrCameraXf->getQuaternion(2);
-        quaternion[3] = Marker2CurrCameraXf->getQuaternion(3);
-
-        transform.push_back( quaternion[0] );
-        transform.push_back( quaternion[1] );
-        transform.push_back( quaternion[2] );
-        transform.push_back( quaternion[3] );
-
         //
         // Check if a Tracker tool is added with this marker type
         //
-        typedef TrackerToolTransformContainerType::iterator InputIterator;
+        typedef MarkerSlotContainerType::const_iterator InputIterator;
 
         InputIterator markerItr =
-          m_ToolTransformBuffer.find( marker->getName() );
+          this->m_MarkerSlotContainer.find( marker->getName() );
 
-        if( markerItr != this->m_ToolTransformBuffer.end() )
+        if( markerItr != this->m_MarkerSlotContainer.end() )
           {
-          this->m_ToolTransformBuffer[ marker->getName() ] = transform;
-          this->m_ToolStatusContainer[ marker->getName() ] = 1;
+          const TrackerToolSlotType slot = markerItr->second;
+
+          // Add the translation and rotation to the transform buffer
+          double * transform = 
+            &this->m_ToolTransformBuffer[ slot * TransformSize ];
+
+          //the first three are translation
+          transform[0] = Marker2CurrCameraXf->getShift(0);
+          transform[1] = Marker2CurrCameraXf->getShift(1);
+          transform[2] = Marker2CurrCameraXf->getShift(2);
+
+          //the next four are quaternion
+          transform[3] = -1.0 * Marker2CurrCameraXf->getQuaternion(0);
+          transform[4] = -1.0 * Marker2CurrCameraXf->getQuaternion(1);
+          transform[5] = -1.0 * Marker2CurrCameraXf->getQuaternion(2);
+          transform[6] = Marker2CurrCameraXf->getQuaternion(3);
+
+          this->m_ToolStatusContainer[ slot ] = 1;
           }
         }
   
@@ -703,20 +681,31 @@ AddTrackerToolToInternalDataContainers( const TrackerToolType * trackerTool )
     return FAILURE;
     }
 
-  const std::string trackerToolIdentifier =
-                    trackerTool->GetTrackerToolIdentifier();
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if ( slot == InvalidTrackerToolSlot )
+    {
+    return FAILURE;
+    }
+
+  m_BufferLock->Lock();
+
+  if ( slot >= this->m_ToolStatusContainer.size() )
+    {
+    this->m_ToolStatusContainer.resize( slot + 1, 0 );
+    this->m_ToolTransformBuffer.resize( ( slot + 1 ) * TransformSize, 0.0 );
+    }
+
+  // identity transform
+  double * transform = &this->m_ToolTransformBuffer[ slot * TransformSize ];
+  std::fill( transform, transform + TransformSize, 0.0 );
+  transform[6] = 1.0;
 
-  std::vector< double > transform;
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 1.0 );
+  this->m_ToolStatusContainer[ slot ] = 0;
+  this->m_MarkerSlotContainer[ trackerTool->GetTrackerToolIdentifier() ] = 
+                                                                       slot;
 
-  this->m_ToolTransformBuffer[ trackerToolIdentifier ] = transform;
-  this->m_ToolStatusContainer[ trackerToolIdentifier ] = 0;
+  m_BufferLock->Unlock();
 
   return SUCCESS;
 }
@@ -731,12 +720,19 @@ RemoveTrackerToolFromInternalDataContainers
     "igstk::MicronTracker::RemoveTrackerToolFromInternalDataContainers "
                  "called ...\n");
 
-  const std::string trackerToolIdentifier =
-                      trackerTool->GetTrackerToolIdentifier();
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  m_BufferLock->Lock();
+
+  // the markers of this tool are not reported anymore
+  this->m_MarkerSlotContainer.erase( trackerTool->GetTrackerToolIdentifier() );
 
-  // remove the tool from the Transform buffer container
-  this->m_ToolTransformBuffer.erase( trackerToolIdentifier );
-  this->m_ToolStatusContainer.erase( trackerToolIdentifier );
+  if ( slot < this->m_ToolStatusContainer.size() )
+    {
+    this->m_ToolStatusContainer[ slot ] = 0;
+    }
+
+  m_BufferLock->Unlock();
 
   return SUCCESS;
 }
@@ -176,12 +176,21 @@ private:
   /** Camera light coolness value */
   double        m_CameraLightCoolness;
 
-  /** A buffer to hold tool transforms */
-  typedef std::map< std::string, std::vector < double > >
-                                TrackerToolTransformContainerType;
+  /** A buffer to hold tool transforms, indexed by the slot of the tracker
+   *  tools. The transform of a slot is stored in the seven values starting
+   *  at 7 * slot: the translation, then the quaternion. */
+  typedef std::vector< double >         TrackerToolTransformContainerType;
 
   TrackerToolTransformContainerType     m_ToolTransformBuffer;
 
+  /** Number of values of a transform in the buffer */
+  itkStaticConstMacro( TransformSize, unsigned int, 7 );
+
+  /** Slots of the tracker tools, indexed by the name of their marker. Only
+   *  used to find the tracker tool of a marker identified by the camera. */
+  typedef std::map< std::string, TrackerToolSlotType > MarkerSlotContainerType;
+  MarkerSlotContainerType               m_MarkerSlotContainer;
+
   /** Error map container */
   typedef std::map< unsigned int, std::string>  ErrorCodeContainerType;
   static ErrorCodeContainerType   m_ErrorCodeContainer;
@@ -189,8 +198,8 @@ private:
   /** boolean to indicate if error code list is created */
   static bool m_ErrorCodeListCreated;
 
-  /** Container holding status of the tools */
-  std::map< std::string, int >  m_ToolStatusContainer;
+  /** Container holding status of the tools, indexed by slot */
+  std::vector< int >            m_ToolStatusContainer;
 
 };
 
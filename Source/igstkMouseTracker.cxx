@@ -89,18 +89,17 @@ MouseTracker::ResultType MouseTracker::InternalUpdateStatus( void )
 {
   igstkLogMacro( DEBUG, "MouseTracker::InternalUpdateStatus called ...\n");
 
-  typedef TrackerToolsContainerType::const_iterator  ConstIteratorType;
-
-  TrackerToolsContainerType trackerToolContainer = 
-    this->GetTrackerToolContainer();
- 
-  ConstIteratorType inputItr = trackerToolContainer.begin();
-  ConstIteratorType inputEnd = trackerToolContainer.end();
+  const TrackerToolSlotType numberOfSlots = this->GetNumberOfTrackerToolSlots();
  
   TransformType transform;
 
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
+    if( !this->GetTrackerToolInSlot( slot ) )
+      {
+      continue;
+      }
+
     transform.SetToIdentity( this->GetValidityTime() );
 
     typedef TransformType::VectorType PositionType;
@@ -123,13 +122,9 @@ MouseTracker::ResultType MouseTracker::InternalUpdateStatus( void )
     transform.SetTranslation( position, errorValue, this->GetValidityTime() );
 
     // set the raw transform
-    this->SetTrackerToolRawTransform( 
-      trackerToolContainer[inputItr->first], transform );
-
-    this->SetTrackerToolTransformUpdate( 
-      trackerToolContainer[inputItr->first], true );
+    this->SetTrackerToolRawTransform( slot, transform );
 
-    ++inputItr;
+    this->SetTrackerToolTransformUpdate( slot, true );
     }
 
   return SUCCESS;
@@ -28,6 +28,7 @@
 
 #include "igstkNDICertusTracker.h"
 #include "igstkNDICertusTrackerTool.h"
+#include "igstkRealTimeClock.h"
 #include <itksys/SystemTools.hxx>
 
 #include <sstream>
@@ -47,11 +48,16 @@ NDICertusTracker::NDICertusTracker(void):m_StateMachine(this)
 {
   // Set the thread
   this->SetThreadingEnabled( true );
+
+  // DataGetLatestTransforms() returns at once, with the same frame until
+  // the next one is acquired: read when the next frame is expected
+  this->SetTrackingLoopPacing( DeviceRateTrackingLoop );
   
   // Lock for the data buffer that is used to transfer the
   // transformations from thread that is communicating
   // with the tracker to the main thread.
   m_BufferLock = itk::MutexLock::New();
+  m_FrameTimeStamp = 0.0;
 
   // Reset the system variables
   ResetSystemVariables();
@@ -397,33 +403,32 @@ NDICertusTracker::ResultType NDICertusTracker::InternalUpdateStatus()
   // accessing it.
   m_BufferLock->Lock();
 
-  typedef TrackerToolTransformContainerType::const_iterator  InputConstIterator;
-
-  InputConstIterator inputItr = this->m_ToolTransformBuffer.begin();
-  InputConstIterator inputEnd = this->m_ToolTransformBuffer.end();
-
-  TrackerToolsContainerType trackerToolContainer =
-    this->GetTrackerToolContainer();
+  const TrackerToolSlotType numberOfSlots =
+    static_cast< TrackerToolSlotType >( this->m_ToolStatusContainer.size() );
 
-
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
+    if ( this->GetTrackerToolInSlot( slot ) == NULL )
+      {
+      continue;
+      }
 
     // only report tools that are in view
-    if (! this->m_ToolStatusContainer[inputItr->first])
+    if (! this->m_ToolStatusContainer[slot])
       {
       igstkLogMacro( DEBUG, "igstk::CertusTracker::InternalUpdateStatus: " <<
-                     "tool " << inputItr->first << " is not in view\n");
+                     "tool in slot " << slot << " is not in view\n");
 
       // report to the tracker tool that the tracker is not available
-      this->ReportTrackingToolNotAvailable(
-        trackerToolContainer[inputItr->first]);
+      this->ReportTrackingToolNotAvailable( slot );
 
-      ++inputItr;
       continue;
       }
     // report to the tracker tool that the tracker is Visible
-    this->ReportTrackingToolVisible(trackerToolContainer[inputItr->first]);
+    this->ReportTrackingToolVisible( slot );
+
+    const double * toolTransform =
+      &this->m_ToolTransformBuffer[ slot * TransformSize ];
 
     // create the transform
     TransformType transform;
@@ -431,36 +436,32 @@ NDICertusTracker::ResultType NDICertusTracker::InternalUpdateStatus()
     typedef TransformType::VectorType TranslationType;
     TranslationType translation;
 
-    translation[0] = (inputItr->second)[0];
-    translation[1] = (inputItr->second)[1];
-    translation[2] = (inputItr->second)[2];
+    translation[0] = toolTransform[0];
+    translation[1] = toolTransform[1];
+    translation[2] = toolTransform[2];
 
     typedef TransformType::VersorType RotationType;
     RotationType rotation;
   
-    rotation.Set( (inputItr->second)[3],
-                   (inputItr->second)[4],
-                   (inputItr->second)[5],
-                   (inputItr->second)[6]);
+    rotation.Set( toolTransform[3],
+                   toolTransform[4],
+                   toolTransform[5],
+                   toolTransform[6]);
 
     // report error value
     // Get error value from the tracker. TODO
     typedef TransformType::ErrorType  ErrorType;
     ErrorType errorValue = 0.0;
 
-    transform.SetToIdentity(this->GetValidityTime());
+    // the transform is valid from the acquisition of its frame
     transform.SetTranslationAndRotation(translation, rotation, errorValue,
-                                        this->GetValidityTime());
+                          m_FrameTimeStamp,
+                          m_FrameTimeStamp + this->GetValidityTime());
     // set the raw transform
-    this->SetTrackerToolRawTransform(
-      trackerToolContainer[inputItr->first], transform );
-  
-    this->SetTrackerToolTransformUpdate(
-      trackerToolContainer[inputItr->first], true );
-
-    ++inputItr;
+    this->SetTrackerToolRawTransform( slot, transform );
   
-    }// while
+    this->SetTrackerToolTransformUpdate( slot, true );
+    }
 
   m_BufferLock->Unlock();
 
@@ -491,67 +492,55 @@ NDICertusTracker::ResultType NDICertusTracker::InternalThreadedUpdateStatus( voi
     return FAILURE;
   }
 
+  m_FrameTimeStamp = 
+    this->ReportDeviceFrame( m_UFrameNumber, RealTimeClock::GetTimeStamp() );
+
   for(int uRigidCnt = 0; uRigidCnt < m_UElements; ++uRigidCnt )
   {
-      std::vector < double > transform;
-
-      // Check if a Tracker tool is added with this rigidBody type
+    // Check if a Tracker tool is added with this rigidBody type
     //
-    typedef TrackerToolTransformContainerType::iterator InputIterator;
+    RigidBodySlotContainerType::const_iterator rigidBodyItr =
+      m_RigidBodySlotContainer.find( rigidBodyDescrArray[uRigidCnt].szName );
+
+    if( rigidBodyItr == m_RigidBodySlotContainer.end() )
+    {
+      continue;
+    }
 
-    InputIterator rigidBodyItr =
-      m_ToolTransformBuffer.find( rigidBodyDescrArray[uRigidCnt].szName );
+    const TrackerToolSlotType slot = rigidBodyItr->second;
+    double * transform = &this->m_ToolTransformBuffer[ slot * TransformSize ];
 
     //Check if tool is visible
     if( (RigidBodyData.pRigidData[uRigidCnt].flags != OPTOTRAK_UNDETERMINED_FLAG) && (RigidBodyData.pRigidData[uRigidCnt].flags != OPTOTRAK_RIGID_ERR_MKR_SPREAD) 
     &&( RigidBodyData.pRigidData[uRigidCnt].transformation.quaternion.translation.x>(-10000000) ) ) // This is terrible I know, but OPTOTRAK_UNDETERMINED_FLAG does not seem to work properly; basically when a tool is not visible Certus system returns a very negative constant...
     {
-      double translation[3];
-      //the first three are translation
-      translation[0] = RigidBodyData.pRigidData[uRigidCnt].transformation.quaternion.translation.x;
-      translation[1] = RigidBodyData.pRigidData[uRigidCnt].transformation.quaternion.translation.y;
-      translation[2] = RigidBodyData.pRigidData[uRigidCnt].transformation.quaternion.translation.z;
+      const struct OptotrakRigidStruct & rigidData =
+        RigidBodyData.pRigidData[uRigidCnt];
 
-      transform.push_back( translation[0] );
-      transform.push_back( translation[1] );
-      transform.push_back( translation[2] );
+      //the first three are translation
+      transform[0] = rigidData.transformation.quaternion.translation.x;
+      transform[1] = rigidData.transformation.quaternion.translation.y;
+      transform[2] = rigidData.transformation.quaternion.translation.z;
 
       //the next four are quaternion
-      double quaternion[4];
-      quaternion[0] = RigidBodyData.pRigidData[uRigidCnt].transformation.quaternion.rotation.qx;
-      quaternion[1] = RigidBodyData.pRigidData[uRigidCnt].transformation.quaternion.rotation.qy;
-      quaternion[2] = RigidBodyData.pRigidData[uRigidCnt].transformation.quaternion.rotation.qz;
-      quaternion[3] = RigidBodyData.pRigidData[uRigidCnt].transformation.quaternion.rotation.q0;
-      
-      transform.push_back( quaternion[0] );
-      transform.push_back( quaternion[1] );
-      transform.push_back( quaternion[2] );
-      transform.push_back( quaternion[3] );
-
-
-      if( rigidBodyItr != this->m_ToolTransformBuffer.end() )
-      {
-        this->m_ToolTransformBuffer[ rigidBodyDescrArray[uRigidCnt].szName ] = transform;
-        this->m_ToolStatusContainer[ rigidBodyDescrArray[uRigidCnt].szName ] = 1;
-      }
+      transform[3] = rigidData.transformation.quaternion.rotation.qx;
+      transform[4] = rigidData.transformation.quaternion.rotation.qy;
+      transform[5] = rigidData.transformation.quaternion.rotation.qz;
+      transform[6] = rigidData.transformation.quaternion.rotation.q0;
 
+      this->m_ToolStatusContainer[ slot ] = 1;
     }
     else //Tool not visible
     {
-        transform.push_back( 0.0 );
-        transform.push_back( 0.0 );
-        transform.push_back( 0.0 );
-        transform.push_back( 0.0 );
-        transform.push_back( 0.0 );
-        transform.push_back( 0.0 );
-        transform.push_back( 1.0 );
-
-      if( rigidBodyItr != this->m_ToolTransformBuffer.end() )
-      {
-        this->m_ToolTransformBuffer[ rigidBodyDescrArray[uRigidCnt].szName ] = transform;
-        this->m_ToolStatusContainer[ rigidBodyDescrArray[uRigidCnt].szName ] = 0;
-      }
-      
+      transform[0] = 0.0;
+      transform[1] = 0.0;
+      transform[2] = 0.0;
+      transform[3] = 0.0;
+      transform[4] = 0.0;
+      transform[5] = 0.0;
+      transform[6] = 1.0;
+
+      this->m_ToolStatusContainer[ slot ] = 0;
     }
   }
 
@@ -574,21 +563,35 @@ AddTrackerToolToInternalDataContainers( const TrackerToolType * trackerTool )
     return FAILURE;
     }
 
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if ( slot == InvalidTrackerToolSlot )
+    {
+    return FAILURE;
+    }
+
   const std::string trackerToolIdentifier =
                     trackerTool->GetTrackerToolIdentifier();
 
-  std::vector< double > transform;
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 0.0 );
-  transform.push_back( 1.0 );
+  m_BufferLock->Lock();
 
-  this->m_ToolTransformBuffer[ trackerToolIdentifier ] = transform;
-  
-  this->m_ToolStatusContainer[ trackerToolIdentifier ] = 0;
+  if ( slot >= this->m_ToolStatusContainer.size() )
+    {
+    this->m_ToolStatusContainer.resize( slot + 1, 0 );
+    this->m_ToolTransformBuffer.resize( ( slot + 1 ) * TransformSize, 0.0 );
+    }
+
+  double * transform = &this->m_ToolTransformBuffer[ slot * TransformSize ];
+  for ( unsigned int i = 0; i < TransformSize - 1; i++ )
+    {
+    transform[i] = 0.0;
+    }
+  transform[TransformSize - 1] = 1.0;
+
+  this->m_RigidBodySlotContainer[ trackerToolIdentifier ] = slot;
+  this->m_ToolStatusContainer[ slot ] = 0;
+
+  m_BufferLock->Unlock();
 
   return SUCCESS;
 }
@@ -606,9 +609,18 @@ RemoveTrackerToolFromInternalDataContainers
   const std::string trackerToolIdentifier =
                       trackerTool->GetTrackerToolIdentifier();
 
-  // remove the tool from the Transform buffer container
-  this->m_ToolTransformBuffer.erase( trackerToolIdentifier );
-  this->m_ToolStatusContainer.erase( trackerToolIdentifier );
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  m_BufferLock->Lock();
+
+  // free the slot
+  this->m_RigidBodySlotContainer.erase( trackerToolIdentifier );
+  if ( slot < this->m_ToolStatusContainer.size() )
+    {
+    this->m_ToolStatusContainer[ slot ] = 0;
+    }
+
+  m_BufferLock->Unlock();
 
   return SUCCESS;
 }
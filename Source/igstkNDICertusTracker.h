@@ -180,12 +180,23 @@ private:
   /** Total number of tools detected. */
   unsigned int   m_NumberOfTools;    //CONTROLLA
 
-  /** A buffer to hold tool transforms */
-  typedef std::map< std::string, std::vector < double > >
-                                TrackerToolTransformContainerType;
+  /** A buffer to hold tool transforms, indexed by the slot of the tracker
+   *  tools. The transform of a slot is stored in the seven values starting
+   *  at 7 * slot: the translation, then the quaternion in x, y, z, w order. */
+  typedef std::vector< double >         TrackerToolTransformContainerType;
 
   TrackerToolTransformContainerType     m_ToolTransformBuffer;
 
+  /** Number of values of a transform in the buffer */
+  itkStaticConstMacro( TransformSize, unsigned int, 7 );
+
+  /** Slots of the tracker tools, indexed by the name of their rigid body.
+   *  Only used to find the tracker tool of a rigid body reported by the
+   *  device. */
+  typedef std::map< std::string, TrackerToolSlotType >
+                                RigidBodySlotContainerType;
+  RigidBodySlotContainerType            m_RigidBodySlotContainer;
+
   /** Error map container */
   typedef std::map< unsigned int, std::string>  ErrorCodeContainerType;
   static ErrorCodeContainerType   m_ErrorCodeContainer;
@@ -193,8 +204,11 @@ private:
   /** boolean to indicate if error code list is created */
   static bool m_ErrorCodeListCreated;
 
-  /** Container holding status of the tools */
-  std::map< std::string, int >  m_ToolStatusContainer;
+  /** Container holding status of the tools, indexed by slot */
+  std::vector< int >            m_ToolStatusContainer;
+
+  /** Acquisition time of the latest frame, estimated from its number */
+  double                        m_FrameTimeStamp;
 
 };
 
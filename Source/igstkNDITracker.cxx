@@ -22,6 +22,7 @@
 #endif
 
 #include "igstkNDITracker.h"
+#include "igstkRealTimeClock.h"
 
 #include <iostream>
 #include <fstream>
@@ -235,64 +236,62 @@ NDITracker::ResultType NDITracker::InternalUpdateStatus()
                                 CommandInterpreterType::NDI_INITIALIZED |
                                 CommandInterpreterType::NDI_ENABLED);
 
-  typedef PortHandleContainerType::const_iterator  ConstIteratorType;
+  const TrackerToolSlotType numberOfSlots = 
+    static_cast< TrackerToolSlotType >( m_PortHandleContainer.size() );
 
-  ConstIteratorType inputItr = m_PortHandleContainer.begin();
-  ConstIteratorType inputEnd = m_PortHandleContainer.end();
-
-  TrackerToolsContainerType trackerToolContainer = 
-    this->GetTrackerToolContainer();
-
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
-    const int portStatus = m_ToolStatusContainer[inputItr->first];
+    if( m_PortHandleContainer[slot] == 0 )
+      {
+      continue;
+      }
+
+    const int portStatus = m_ToolStatusContainer[slot];
 
     // only report tools that are enabled
     if ((portStatus & mflags) != mflags) 
       {
       igstkLogMacro( DEBUG, "igstk::NDITracker::InternalUpdateStatus: " <<
-                     "tool " << inputItr->first << " is not available \n");
-      ++inputItr;
+                     "tool in slot " << slot << " is not available \n");
       continue;
       }
 
     // only report tools that are in view
-    if (m_ToolAbsentStatusContainer[inputItr->first])
+    if (m_ToolAbsentStatusContainer[slot])
       {
       // there should be a method to set that the tool is not in view
       igstkLogMacro( DEBUG, "igstk::NDITracker::InternalUpdateStatus: " <<
-                     "tool " << inputItr->first << " is not in view\n");
+                     "tool in slot " << slot << " is not in view\n");
 
       // report to the tracker tool that the tracker is not available 
-      this->ReportTrackingToolNotAvailable( 
-        trackerToolContainer[inputItr->first] );
+      this->ReportTrackingToolNotAvailable( slot );
 
-      ++inputItr;
       continue;
       }
 
-    const PortIdentifierType portId = inputItr->first;
-
     // report to the tracker tool that the tracker is Visible 
-    this->ReportTrackingToolVisible( trackerToolContainer[portId] );
+    this->ReportTrackingToolVisible( slot );
  
+    const double * toolTransform = &m_ToolTransformBuffer[ 
+                                                     slot * TransformSize ];
+
     // create the transform
     TransformType transform;
 
     typedef TransformType::VectorType TranslationType;
     TranslationType translation;
 
-    translation[0] = (m_ToolTransformBuffer[portId])[4];
-    translation[1] = (m_ToolTransformBuffer[portId])[5];
-    translation[2] = (m_ToolTransformBuffer[portId])[6];
+    translation[0] = toolTransform[4];
+    translation[1] = toolTransform[5];
+    translation[2] = toolTransform[6];
 
     typedef TransformType::VersorType RotationType;
     RotationType rotation;
     const double normsquared = 
-      m_ToolTransformBuffer[portId][0]*m_ToolTransformBuffer[portId][0] +
-      m_ToolTransformBuffer[portId][1]*m_ToolTransformBuffer[portId][1] +
-      m_ToolTransformBuffer[portId][2]*m_ToolTransformBuffer[portId][2] +
-      m_ToolTransformBuffer[portId][3]*m_ToolTransformBuffer[portId][3];
+      toolTransform[0]*toolTransform[0] +
+      toolTransform[1]*toolTransform[1] +
+      toolTransform[2]*toolTransform[2] +
+      toolTransform[3]*toolTransform[3];
 
     // don't allow null quaternions
     if (normsquared < 1e-6)
@@ -304,27 +303,27 @@ NDITracker::ResultType NDITracker::InternalUpdateStatus()
     else
       {
       // ITK quaternions are in xyzw order, not wxyz order
-      rotation.Set(m_ToolTransformBuffer[portId][1],
-                   m_ToolTransformBuffer[portId][2],
-                   m_ToolTransformBuffer[portId][3],
-                   m_ToolTransformBuffer[portId][0]);
+      rotation.Set(toolTransform[1],
+                   toolTransform[2],
+                   toolTransform[3],
+                   toolTransform[0]);
       }
 
     // retool NDI error value
     typedef TransformType::ErrorType  ErrorType;
-    ErrorType errorValue = m_ToolTransformBuffer[portId][7];
+    ErrorType errorValue = toolTransform[7];
 
-    transform.SetToIdentity(this->GetValidityTime());
+    // the transform is valid from the acquisition of its frame
+    const double timeStamp = m_ToolTimeStampContainer[slot];
     transform.SetTranslationAndRotation(translation, rotation, errorValue,
-                                        this->GetValidityTime());
+                                        timeStamp,
+                                        timeStamp + this->GetValidityTime());
   
     m_BufferLock->Lock();
     // set the raw transform
-    this->SetTrackerToolRawTransform( trackerToolContainer[portId], transform );
-    this->SetTrackerToolTransformUpdate( trackerToolContainer[portId], true );
+    this->SetTrackerToolRawTransform( slot, transform );
+    this->SetTrackerToolTransformUpdate( slot, true );
     m_BufferLock->Unlock();
-
-    ++inputItr;
     }
   
   return SUCCESS;
@@ -342,66 +341,76 @@ NDITracker::ResultType NDITracker::InternalThreadedUpdateStatus( void )
 
   ResultType result = this->CheckError(m_CommandInterpreter);
 
+  const double arrivalTime = RealTimeClock::GetTimeStamp();
+
   // lock the buffer
   m_BufferLock->Lock();
 
-  // Initialize transformations to identity.
-  // The NDI transform is 8 values:
-  // the first 4 values are a quaternion
-  // the next 3 values are an x,y,z position
-  // the final value is an error estimate in the range [0,1]
-  //
-  std::vector < double > transform;
-  transform.push_back ( 1.0 );
-  transform.push_back ( 0.0 );
-  transform.push_back ( 0.0 );
-  transform.push_back ( 0.0 );
-  transform.push_back ( 0.0 );
-  transform.push_back ( 0.0 );
-  transform.push_back ( 0.0 );
-  transform.push_back ( 0.0 );
-
   if (result == SUCCESS)
     {
+    const TrackerToolSlotType numberOfSlots = 
+      static_cast< TrackerToolSlotType >( m_PortHandleContainer.size() );
+
+    // The frame numbers of the tools in a reply may differ, the newest
+    // one is the frame of the reply
+    unsigned int replyFrame = 0;
+    bool hasFrame = false;
+    for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
+      {
+      const int ph = m_PortHandleContainer[slot];
+      const unsigned int frame = 
+        ( ph != 0 ) ? m_CommandInterpreter->GetTXFrame(ph) : 0;
+      if ( frame != 0 && 
+           ( !hasFrame || static_cast< int >( frame - replyFrame ) > 0 ) )
+        {
+        replyFrame = frame;
+        hasFrame = true;
+        }
+      }
+    if ( hasFrame )
+      {
+      this->ReportDeviceFrame( replyFrame, arrivalTime );
+      }
 
-    typedef PortHandleContainerType::iterator  IteratorType;
-
-    IteratorType inputItr = m_PortHandleContainer.begin();
-    IteratorType inputEnd = m_PortHandleContainer.end();
-
-    while( inputItr != inputEnd )
+    for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
       {
-      m_ToolAbsentStatusContainer[inputItr->first] = 0;
-      m_ToolStatusContainer[inputItr->first] = 0;
+      m_ToolAbsentStatusContainer[slot] = 0;
+      m_ToolStatusContainer[slot] = 0;
  
-      unsigned int ph = inputItr->second;
+      const int ph = m_PortHandleContainer[slot];
       if ( ph == 0 )
         {
-        ++inputItr;
         continue;
         }
 
-      double transformRecorded[8];
+      // The NDI transform is 8 values:
+      // the first 4 values are a quaternion
+      // the next 3 values are an x,y,z position
+      // the final value is an error estimate in the range [0,1]
+      // If the tool is absent, the transform is set to identity.
+      double * toolTransform = &m_ToolTransformBuffer[ slot * TransformSize ];
 
       const int tstatus = 
-        m_CommandInterpreter->GetTXTransform(ph, transformRecorded);
+        m_CommandInterpreter->GetTXTransform(ph, toolTransform);
 
       const int absent = (tstatus != CommandInterpreterType::NDI_VALID);
       const int status = m_CommandInterpreter->GetTXPortStatus(ph);
 
-      if (!absent)
+      if (absent)
         {
-        for( unsigned int i = 0; i < 8; i++ )
+        toolTransform[0] = 1.0;
+        for( unsigned int i = 1; i < TransformSize; i++ )
           {
-          transform[i] = transformRecorded[i];
+          toolTransform[i] = 0.0;
           }
         }
 
-      m_ToolAbsentStatusContainer[inputItr->first] = absent;
-      m_ToolStatusContainer[inputItr->first] = status;
-      m_ToolTransformBuffer[inputItr->first] = transform;
+      m_ToolAbsentStatusContainer[slot] = absent;
+      m_ToolStatusContainer[slot] = status;
 
-      ++inputItr;
+      const unsigned int frame = m_CommandInterpreter->GetTXFrame(ph);
+      m_ToolTimeStampContainer[slot] = 
+        ( frame != 0 ) ? this->GetDeviceFrameTime( frame ) : arrivalTime;
       }
     }
 
@@ -414,6 +423,17 @@ NDITracker::ResultType NDITracker::InternalThreadedUpdateStatus( void )
   return result;
 }
 
+/** Resize the per slot containers */
+void
+NDITracker::ResizeInternalDataContainers( TrackerToolSlotType numberOfSlots )
+{
+  m_PortHandleContainer.resize( numberOfSlots, 0 );
+  m_ToolAbsentStatusContainer.resize( numberOfSlots, 0 );
+  m_ToolStatusContainer.resize( numberOfSlots, 0 );
+  m_ToolTransformBuffer.resize( numberOfSlots * TransformSize, 0.0 );
+  m_ToolTimeStampContainer.resize( numberOfSlots, 0.0 );
+}
+
 NDITracker::ResultType 
 NDITracker::
 AddTrackerToolToInternalDataContainers( const TrackerToolType * trackerTool ) 
@@ -426,17 +446,30 @@ AddTrackerToolToInternalDataContainers( const TrackerToolType * trackerTool )
     return FAILURE;
     } 
 
-  std::string trackerToolIdentifier = 
-    trackerTool->GetTrackerToolIdentifier();
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if ( slot == InvalidTrackerToolSlot )
+    {
+    return FAILURE;
+    }
+
+  m_BufferLock->Lock();
+
+  if ( slot >= m_PortHandleContainer.size() )
+    {
+    this->ResizeInternalDataContainers( slot + 1 );
+    }
 
   // add it to the port handle container 
-  this->m_PortHandleContainer[ trackerToolIdentifier ] = m_PortHandleToBeAdded;
+  this->m_PortHandleContainer[ slot ] = m_PortHandleToBeAdded;
 
   // add it to the tool absent status 
-  this->m_ToolAbsentStatusContainer[ trackerToolIdentifier ] = 0;
+  this->m_ToolAbsentStatusContainer[ slot ] = 0;
 
   // add it to the tool status container
-  this->m_ToolStatusContainer[ trackerToolIdentifier ] = 0;
+  this->m_ToolStatusContainer[ slot ] = 0;
+
+  m_BufferLock->Unlock();
 
   return SUCCESS;
 }
@@ -455,28 +488,28 @@ RemoveTrackerToolFromInternalDataContainers
     return FAILURE;
     } 
 
-  std::string trackerToolIdentifier = 
-    trackerTool->GetTrackerToolIdentifier();
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if ( slot == InvalidTrackerToolSlot || 
+       slot >= m_PortHandleContainer.size() )
+    {
+    return FAILURE;
+    }
 
-  m_CommandInterpreter->PHF( m_PortHandleContainer[trackerToolIdentifier] );
+  m_CommandInterpreter->PHF( m_PortHandleContainer[ slot ] );
     
   // disable the port handle
-  m_CommandInterpreter->PDIS( m_PortHandleContainer[ trackerToolIdentifier] );  
+  m_CommandInterpreter->PDIS( m_PortHandleContainer[ slot ] );  
 
   // print warning if failed to disable
   this->CheckError(m_CommandInterpreter);
 
-  // remove the tool from port handle container
-  this->m_PortHandleContainer.erase( trackerToolIdentifier );
-
-  // remove the tool from absent status container 
-  this->m_ToolAbsentStatusContainer.erase( trackerToolIdentifier );
-
-  // remove the tool from  tool status container
-  this->m_ToolStatusContainer.erase( trackerToolIdentifier );
-
-  // remove the tool from the Transform buffer container
-  this->m_ToolTransformBuffer.erase( trackerToolIdentifier );
+  // free the slot: a zero port handle is skipped by the update loops
+  m_BufferLock->Lock();
+  this->m_PortHandleContainer[ slot ] = 0;
+  this->m_ToolAbsentStatusContainer[ slot ] = 0;
+  this->m_ToolStatusContainer[ slot ] = 0;
+  m_BufferLock->Unlock();
 
   return SUCCESS;
 }
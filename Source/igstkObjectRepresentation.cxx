@@ -18,6 +18,7 @@
 #include "igstkObjectRepresentation.h"
 #include "vtkMatrix4x4.h"
 #include "igstkEvents.h"
+#include "igstkCoordinateSystemTransformToResult.h"
 #include "vtkActor.h"
 #include "vtkProp3D.h"
 #include "vtkProperty.h"
@@ -51,6 +52,10 @@ ObjectRepresentation::ObjectRepresentation():
   this->m_Color[2] = 1.0;
   this->m_Opacity = 1.0;
   this->m_SpatialObject = NULL;
+  this->m_SpatialObjectTransformInputToBeSet = NULL;
+  this->m_TransformToBeUsed = NULL;
+  this->m_SpatialObjectTransformObserverTag = 0;
+  this->m_HasSpatialObjectTransformObserver = false;
 
   igstkAddInputMacro( ValidSpatialObject );
   igstkAddInputMacro( NullSpatialObject  );
@@ -184,6 +189,8 @@ ObjectRepresentation::ObjectRepresentation():
 /** Destructor */
 ObjectRepresentation::~ObjectRepresentation()
 {
+  this->RemoveSpatialObjectTransformObserver();
+
   // This must be invoked in order to prevent Memory Leaks.
   this->DeleteActors();
 }
@@ -257,8 +264,43 @@ void ObjectRepresentation
 /** Set the Spatial Object */
 void ObjectRepresentation::SetSpatialObjectProcessing()
 {
+  this->RemoveSpatialObjectTransformObserver();
+
   this->m_SpatialObject = this->m_SpatialObjectToAdd;
-  this->ObserveSpatialObjectTransformInput( this->m_SpatialObject );
+
+  this->m_SpatialObjectTransformObserverTag = 
+    this->m_SpatialObject->GetTransformToChannel().
+      AddMemberObserver< Self, &Self::SpatialObjectTransformCallback >( this );
+  this->m_HasSpatialObjectTransformObserver = true;
+}
+
+/** Stop observing the transforms of the current spatial object */
+void ObjectRepresentation::RemoveSpatialObjectTransformObserver()
+{
+  if( this->m_HasSpatialObjectTransformObserver )
+    {
+    this->m_SpatialObject->GetTransformToChannel().RemoveObserver( 
+                                 this->m_SpatialObjectTransformObserverTag );
+    this->m_HasSpatialObjectTransformObserver = false;
+    }
+}
+
+/** Receive the transforms computed by the spatial object */
+void ObjectRepresentation::SpatialObjectTransformCallback( 
+                           const CoordinateSystemTransformToResult & payload )
+{
+  // the spatial object may be shown by other representations, and its
+  // transforms to their views are of no use here
+  if( payload.GetDestination() !=
+      this->m_TargetCoordinateSystem.GetPointer() )
+    {
+    return;
+    }
+
+  this->m_SpatialObjectTransformInputToBeSet = &payload;
+  igstkPushInputMacro( SpatialObjectTransform );
+  this->m_StateMachine.ProcessInputs();
+  this->m_SpatialObjectTransformInputToBeSet = NULL;
 }
 
 /** Set the color */
@@ -326,6 +368,18 @@ void ObjectRepresentation::RequestUpdateRepresentation(
   this->m_TargetCoordinateSystem = NULL; // Break reference.
 }
 
+/** Request Update the object representation with a transform computed by
+ *  the caller. */
+void ObjectRepresentation::RequestUpdateRepresentationWithTransform( 
+                         const TimeStamp & time, 
+                         const CoordinateSystem* cs,
+                         const CoordinateSystemTransformToResult & transform )
+{
+  this->m_TransformToBeUsed = &transform;
+  this->RequestUpdateRepresentation( time, cs );
+  this->m_TransformToBeUsed = NULL;
+}
+
 /** Process the request for updating the transform from the SpatialObject. */
 void ObjectRepresentation::RequestGetTransformProcessing()
 {
@@ -334,6 +388,12 @@ void ObjectRepresentation::RequestGetTransformProcessing()
   // The response to this request is part of the internal dialog between the
   // ObjectRepresentation and the SpatialObject. There is no need to report the
   // answer outside of the ObjectRepresentation.
+  if( this->m_TransformToBeUsed != NULL )
+    {
+    this->SpatialObjectTransformCallback( *this->m_TransformToBeUsed );
+    return;
+    }
+
   this->m_SpatialObject->RequestComputeTransformTo( 
     this->m_TargetCoordinateSystem );
 
@@ -344,7 +404,7 @@ void ObjectRepresentation::RequestGetTransformProcessing()
 void ObjectRepresentation::ReceiveSpatialObjectTransformProcessing()
 {
   this->m_SpatialObjectTransform = 
-    this->m_SpatialObjectTransformInputToBeSet.GetTransform();
+    this->m_SpatialObjectTransformInputToBeSet->GetTransform();
 
   igstkLogMacro( DEBUG, 
     "Received SpatialObject Transform " << this->m_SpatialObjectTransform );
@@ -36,6 +36,8 @@ class vtkProp;
 namespace igstk
 {
 
+class FrameScheduler;
+
 /** \class ObjectRepresentation
  * 
  * \brief An abstract base class for all the igstk representation objects.
@@ -140,12 +142,30 @@ protected:
 
   /** Get Time stamp for the time at which the next rendering will take place */
   TimeStamp GetRenderTimeStamp() const;
+
+  /** Get the last transform received from the spatial object, which is
+   *  the transform that was set in the user matrix of the actors */
+  igstkGetMacro( SpatialObjectTransform, Transform );
   
 private:
 
   ObjectRepresentation(const Self&);   //purposely not implemented
   void operator=(const Self&);   //purposely not implemented
 
+  /** The FrameScheduler computes the transforms of the representations
+   *  of all its views in one pass, and passes them to the update */
+  friend class FrameScheduler;
+
+  /** Update the representation with a transform to the coordinate system
+   *  that was computed by the caller, instead of asking the spatial
+   *  object for it. */
+  void RequestUpdateRepresentationWithTransform( 
+    const TimeStamp & time, 
+    const CoordinateSystem* cs,
+    const CoordinateSystemTransformToResult & transform );
+
+  const CoordinateSystemTransformToResult * m_TransformToBeUsed;
+
   /** Update the visual representation with changes in the geometry. Only to be
    * called by the State Machine. This is an abstract method that MUST be
    * overloaded in every derived class. */
@@ -254,10 +274,21 @@ private:
     TransformNotAvailable,
     TransformNotAvailable); 
 
-  // The only event that brings a valid transform.
-  igstkLoadedEventTransductionMacro(  
-     CoordinateSystemTransformTo,
-     SpatialObjectTransform );
+  /** The only notification that brings a valid transform. It is received
+   *  through the typed channel of the spatial object coordinate system
+   *  instead of the CoordinateSystemTransformToEvent, since it arrives at
+   *  every render of every object. The payload is only referenced while the
+   *  input is processed. */
+  void SpatialObjectTransformCallback( 
+                         const CoordinateSystemTransformToResult & payload );
+
+  /** Stop observing the transforms of the current spatial object */
+  void RemoveSpatialObjectTransformObserver();
+
+  const CoordinateSystemTransformToResult * 
+                                  m_SpatialObjectTransformInputToBeSet;
+  unsigned long                   m_SpatialObjectTransformObserverTag;
+  bool                            m_HasSpatialObjectTransformObserver;
 
   /** Inputs to the Visibility State Machine */
   igstkDeclareInputMacro( ValidTimeStamp );
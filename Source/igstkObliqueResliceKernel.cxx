@@ -0,0 +1,203 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkObliqueResliceKernel.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+//Warning about: identifier was truncated to '255' characters in the debug
+// information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkObliqueResliceKernel.h"
+
+#include "itkNumericTraits.h"
+#include "vtkType.h"
+
+namespace igstk
+{
+
+/** Constructor */
+ObliqueResliceKernel::ObliqueResliceKernel()
+{
+  m_VolumeBuffer = NULL;
+  m_VolumeScalarType = VTK_VOID;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    m_VolumeDimensions[i] = 0;
+    m_VolumeSpacing[i] = 1.0;
+    m_VolumeOrigin[i] = 0.0;
+    m_OutputOrigin[i] = 0.0;
+    m_OutputAxis1[i] = ( i == 0 ) ? 1.0 : 0.0;
+    m_OutputAxis2[i] = ( i == 1 ) ? 1.0 : 0.0;
+    m_IndexOrigin[i] = 0.0;
+    m_IndexStep1[i] = 0.0;
+    m_IndexStep2[i] = 0.0;
+    }
+  m_OutputSpacing[0] = 1.0;
+  m_OutputSpacing[1] = 1.0;
+  m_OutputSize[0] = 0;
+  m_OutputSize[1] = 0;
+
+  m_LinearInterpolation = true;
+  m_Scale = 1.0;
+  m_Shift = 0.0;
+  m_OutputMinimum = -itk::NumericTraits< double >::max();
+  m_OutputMaximum = itk::NumericTraits< double >::max();
+  m_BackgroundValue = 0.0;
+}
+
+
+/** Destructor */
+ObliqueResliceKernel::~ObliqueResliceKernel()
+{
+}
+
+
+bool
+ObliqueResliceKernel::IsScalarTypeSupported( int vtkScalarType )
+{
+  switch( vtkScalarType )
+    {
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR:
+    case VTK_UNSIGNED_CHAR:
+    case VTK_SHORT:
+    case VTK_UNSIGNED_SHORT:
+    case VTK_INT:
+    case VTK_UNSIGNED_INT:
+    case VTK_FLOAT:
+    case VTK_DOUBLE:
+      return true;
+    default:
+      return false;
+    }
+}
+
+
+bool
+ObliqueResliceKernel
+::SetInputVolume( const void * buffer, int vtkScalarType,
+                  const int dimensions[3],
+                  const double spacing[3],
+                  const double origin[3] )
+{
+  if( !IsScalarTypeSupported( vtkScalarType ) )
+    {
+    return false;
+    }
+
+  m_VolumeBuffer = buffer;
+  m_VolumeScalarType = vtkScalarType;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    m_VolumeDimensions[i] = dimensions[i];
+    m_VolumeSpacing[i] = spacing[i];
+    m_VolumeOrigin[i] = origin[i];
+    }
+
+  this->ComputeIndexGeometry();
+  return true;
+}
+
+
+void
+ObliqueResliceKernel
+::SetOutputGeometry( const double origin[3],
+                     const double axis1[3],
+                     const double axis2[3],
+                     const double spacing[2],
+                     const unsigned int size[2] )
+{
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    m_OutputOrigin[i] = origin[i];
+    m_OutputAxis1[i] = axis1[i];
+    m_OutputAxis2[i] = axis2[i];
+    }
+  m_OutputSpacing[0] = spacing[0];
+  m_OutputSpacing[1] = spacing[1];
+  m_OutputSize[0] = size[0];
+  m_OutputSize[1] = size[1];
+
+  this->ComputeIndexGeometry();
+}
+
+
+void
+ObliqueResliceKernel::ComputeIndexGeometry()
+{
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    const double spacing = ( m_VolumeSpacing[i] != 0.0 ) ?
+                                                  m_VolumeSpacing[i] : 1.0;
+    m_IndexOrigin[i] = ( m_OutputOrigin[i] - m_VolumeOrigin[i] ) / spacing;
+    m_IndexStep1[i] = m_OutputAxis1[i] * m_OutputSpacing[0] / spacing;
+    m_IndexStep2[i] = m_OutputAxis2[i] * m_OutputSpacing[1] / spacing;
+    }
+}
+
+
+void
+ObliqueResliceKernel::SetLinearInterpolation( bool linear )
+{
+  m_LinearInterpolation = linear;
+}
+
+
+bool
+ObliqueResliceKernel::GetLinearInterpolation() const
+{
+  return m_LinearInterpolation;
+}
+
+
+void
+ObliqueResliceKernel::SetIntensityMapping( double scale, double shift )
+{
+  m_Scale = scale;
+  m_Shift = shift;
+}
+
+
+void
+ObliqueResliceKernel::SetOutputRange( double minimum, double maximum )
+{
+  m_OutputMinimum = minimum;
+  m_OutputMaximum = maximum;
+}
+
+
+void
+ObliqueResliceKernel::SetBackgroundValue( double value )
+{
+  m_BackgroundValue = value;
+}
+
+
+unsigned long
+ObliqueResliceKernel::GetNumberOfOutputPixels() const
+{
+  return static_cast< unsigned long >( m_OutputSize[0] ) * m_OutputSize[1];
+}
+
+
+const unsigned int *
+ObliqueResliceKernel::GetOutputSize() const
+{
+  return m_OutputSize;
+}
+
+} // end namespace igstk
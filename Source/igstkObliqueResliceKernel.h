@@ -0,0 +1,175 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkObliqueResliceKernel.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __igstkObliqueResliceKernel_h
+#define __igstkObliqueResliceKernel_h
+
+#include "itkMultiThreader.h"
+
+namespace igstk
+{
+
+/** \class ObliqueResliceKernel
+ *
+ * \brief Extract an oblique slice from a volume, map its intensities and
+ * cast them to the output pixel type in a single pass.
+ *
+ * The kernel samples the volume along a plane defined by an origin, two
+ * orthonormal axes, a pixel spacing and a size. Each sample is interpolated
+ * (nearest neighbor or trilinear), mapped with a linear function
+ * (scale * value + shift), clamped and written to a caller provided buffer.
+ * No intermediate image is created.
+ *
+ * Rows of the output are independent. Reslice() distributes them over the
+ * threads of an itk::MultiThreader, while ResliceRows() computes a range
+ * of rows in the calling thread. Each row is clipped analytically against
+ * the volume before the inner loop, which therefore runs without bound
+ * checks.
+ *
+ * The kernel does not own the volume nor the output buffer. It is a small
+ * value object that can be copied, and a const kernel can be shared by
+ * several threads.
+ *
+ * \sa ImageResliceEngine
+ * \sa UltrasoundImageSimulator
+ *
+ * \ingroup Simulators
+ */
+class ObliqueResliceKernel
+{
+
+public:
+
+  /** Constructor and destructor */
+  ObliqueResliceKernel();
+  ~ObliqueResliceKernel();
+
+  /** Set the volume to be resliced. The scalar type is given with the VTK
+   * type constants (VTK_SHORT, VTK_UNSIGNED_CHAR ...). The origin is the
+   * position of the first voxel of the buffer. Returns false if the
+   * scalar type is not supported. */
+  bool SetInputVolume( const void * buffer, int vtkScalarType,
+                       const int dimensions[3],
+                       const double spacing[3],
+                       const double origin[3] );
+
+  /** Set the geometry of the output slice. Pixel (i,j) is located at
+   * origin + i * spacing[0] * axis1 + j * spacing[1] * axis2. */
+  void SetOutputGeometry( const double origin[3],
+                          const double axis1[3],
+                          const double axis2[3],
+                          const double spacing[2],
+                          const unsigned int size[2] );
+
+  /** Use trilinear interpolation, otherwise nearest neighbor. The default
+   * is trilinear interpolation. */
+  void SetLinearInterpolation( bool linear );
+  bool GetLinearInterpolation() const;
+
+  /** Linear intensity mapping, applied before clamping to
+   * [minimum,maximum] and to the range of the output pixel type. The
+   * default is the identity. */
+  void SetIntensityMapping( double scale, double shift );
+  void SetOutputRange( double minimum, double maximum );
+
+  /** Value, in output units, of the pixels outside of the volume */
+  void SetBackgroundValue( double value );
+
+  /** Number of pixels of the output */
+  unsigned long GetNumberOfOutputPixels() const;
+  const unsigned int * GetOutputSize() const;
+
+  /** Return whether a VTK scalar type can be resliced */
+  static bool IsScalarTypeSupported( int vtkScalarType );
+
+  /** Compute the whole slice. Rows are split among the threads of the
+   * threader, or computed in the calling thread if threader is NULL. The
+   * output buffer must hold GetNumberOfOutputPixels() pixels. When
+   * rowRanges is not NULL, the minimum and the maximum of each row are
+   * stored in rowRanges[2*row] and rowRanges[2*row+1], while the row is
+   * still in cache. */
+  template < class TOutputPixel >
+  void Reslice( TOutputPixel * output,
+                itk::MultiThreader * threader,
+                TOutputPixel * rowRanges = NULL ) const;
+
+  /** Compute the rows [firstRow,lastRow) of the slice */
+  template < class TOutputPixel >
+  void ResliceRows( TOutputPixel * output,
+                    unsigned int firstRow,
+                    unsigned int lastRow,
+                    TOutputPixel * rowRanges = NULL ) const;
+
+private:
+
+  /** Compute the rows for a given input pixel type */
+  template < class TInputPixel, class TOutputPixel >
+  void ResliceRowsTemplate( const TInputPixel * volume,
+                            TOutputPixel * output,
+                            unsigned int firstRow,
+                            unsigned int lastRow,
+                            TOutputPixel * rowRanges ) const;
+
+  /** Update the geometry expressed in the index space of the volume */
+  void ComputeIndexGeometry();
+
+  /** Thread function used by Reslice() */
+  template < class TOutputPixel >
+  static ITK_THREAD_RETURN_TYPE ResliceThreadFunction( void * info );
+
+  template < class TOutputPixel >
+  struct ThreadJobType
+    {
+    const ObliqueResliceKernel *  m_Kernel;
+    TOutputPixel *                m_Output;
+    TOutputPixel *                m_RowRanges;
+    };
+
+  /** Input volume */
+  const void *     m_VolumeBuffer;
+  int              m_VolumeScalarType;
+  int              m_VolumeDimensions[3];
+  double           m_VolumeSpacing[3];
+  double           m_VolumeOrigin[3];
+
+  /** Output geometry, in world coordinates */
+  double           m_OutputOrigin[3];
+  double           m_OutputAxis1[3];
+  double           m_OutputAxis2[3];
+  double           m_OutputSpacing[2];
+  unsigned int     m_OutputSize[2];
+
+  /** Output geometry, in the continuous index space of the volume */
+  double           m_IndexOrigin[3];
+  double           m_IndexStep1[3];
+  double           m_IndexStep2[3];
+
+  /** Sampling and intensity mapping */
+  bool             m_LinearInterpolation;
+  double           m_Scale;
+  double           m_Shift;
+  double           m_OutputMinimum;
+  double           m_OutputMaximum;
+  double           m_BackgroundValue;
+};
+
+} // end namespace igstk
+
+#ifndef IGSTK_MANUAL_INSTANTIATION
+#include "igstkObliqueResliceKernel.txx"
+#endif
+
+#endif // __igstkObliqueResliceKernel_h
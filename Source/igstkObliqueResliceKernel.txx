@@ -0,0 +1,359 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkObliqueResliceKernel.txx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __igstkObliqueResliceKernel_txx
+#define __igstkObliqueResliceKernel_txx
+
+#include "igstkObliqueResliceKernel.h"
+
+#include "itkNumericTraits.h"
+#include "vtkType.h"
+
+#include <math.h>
+
+namespace igstk
+{
+
+namespace ObliqueResliceKernelHelpers
+{
+
+/** Compute the interval of pixel indices [first,last] of a row for which
+ *  start + i * step stays inside [lower,upper]. Returns false if the
+ *  interval is empty. */
+inline bool ClipRow( double start, double step, double lower, double upper,
+                     double & first, double & last )
+{
+  if( fabs( step ) < 1e-12 )
+    {
+    return ( start >= lower && start <= upper );
+    }
+
+  double t0 = ( lower - start ) / step;
+  double t1 = ( upper - start ) / step;
+  if( t0 > t1 )
+    {
+    double t = t0;
+    t0 = t1;
+    t1 = t;
+    }
+
+  if( t0 > first )
+    {
+    first = t0;
+    }
+  if( t1 < last )
+    {
+    last = t1;
+    }
+  return first <= last;
+}
+
+/** Convert a clamped value to the output pixel type, rounding to the
+ *  nearest integer for integral types. */
+template < class TOutputPixel >
+inline TOutputPixel ConvertPixel( float value )
+{
+  if( itk::NumericTraits< TOutputPixel >::is_integer )
+    {
+    return static_cast< TOutputPixel >(
+                          value >= 0.0f ? value + 0.5f : value - 0.5f );
+    }
+  return static_cast< TOutputPixel >( value );
+}
+
+} // end namespace ObliqueResliceKernelHelpers
+
+
+template < class TOutputPixel >
+void
+ObliqueResliceKernel
+::ResliceRows( TOutputPixel * output,
+               unsigned int firstRow, unsigned int lastRow,
+               TOutputPixel * rowRanges ) const
+{
+  if( lastRow > m_OutputSize[1] )
+    {
+    lastRow = m_OutputSize[1];
+    }
+
+  switch( m_VolumeScalarType )
+    {
+#define igstkObliqueResliceKernelCaseMacro( vtktype, ctype ) \
+    case vtktype: \
+      this->ResliceRowsTemplate( \
+        static_cast< const ctype * >( m_VolumeBuffer ), \
+        output, firstRow, lastRow, rowRanges ); \
+      break;
+    igstkObliqueResliceKernelCaseMacro( VTK_CHAR, char )
+    igstkObliqueResliceKernelCaseMacro( VTK_SIGNED_CHAR, signed char )
+    igstkObliqueResliceKernelCaseMacro( VTK_UNSIGNED_CHAR, unsigned char )
+    igstkObliqueResliceKernelCaseMacro( VTK_SHORT, short )
+    igstkObliqueResliceKernelCaseMacro( VTK_UNSIGNED_SHORT, unsigned short )
+    igstkObliqueResliceKernelCaseMacro( VTK_INT, int )
+    igstkObliqueResliceKernelCaseMacro( VTK_UNSIGNED_INT, unsigned int )
+    igstkObliqueResliceKernelCaseMacro( VTK_FLOAT, float )
+    igstkObliqueResliceKernelCaseMacro( VTK_DOUBLE, double )
+#undef igstkObliqueResliceKernelCaseMacro
+    default:
+      break;
+    }
+}
+
+
+template < class TOutputPixel >
+ITK_THREAD_RETURN_TYPE
+ObliqueResliceKernel::ResliceThreadFunction( void * info )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)info;
+
+  ThreadJobType< TOutputPixel > * job =
+    static_cast< ThreadJobType< TOutputPixel > * >( pInfo->UserData );
+
+  const unsigned long numberOfRows = job->m_Kernel->m_OutputSize[1];
+  const unsigned long threadId = pInfo->ThreadID;
+  const unsigned long numberOfThreads = pInfo->NumberOfThreads;
+
+  const unsigned int firstRow = static_cast< unsigned int >(
+                        ( numberOfRows * threadId ) / numberOfThreads );
+  const unsigned int lastRow = static_cast< unsigned int >(
+                        ( numberOfRows * ( threadId + 1 ) ) / numberOfThreads );
+
+  job->m_Kernel->ResliceRows( job->m_Output, firstRow, lastRow,
+                              job->m_RowRanges );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+
+template < class TOutputPixel >
+void
+ObliqueResliceKernel
+::Reslice( TOutputPixel * output, itk::MultiThreader * threader,
+           TOutputPixel * rowRanges ) const
+{
+  if( output == NULL || m_VolumeBuffer == NULL ||
+      this->GetNumberOfOutputPixels() == 0 )
+    {
+    return;
+    }
+
+  if( threader == NULL || threader->GetNumberOfThreads() < 2 )
+    {
+    this->ResliceRows( output, 0, m_OutputSize[1], rowRanges );
+    return;
+    }
+
+  ThreadJobType< TOutputPixel > job;
+  job.m_Kernel = this;
+  job.m_Output = output;
+  job.m_RowRanges = rowRanges;
+
+  threader->SetSingleMethod( ResliceThreadFunction< TOutputPixel >, &job );
+  threader->SingleMethodExecute();
+}
+
+
+template < class TInputPixel, class TOutputPixel >
+void
+ObliqueResliceKernel
+::ResliceRowsTemplate( const TInputPixel * volume, TOutputPixel * output,
+                       unsigned int firstRow, unsigned int lastRow,
+                       TOutputPixel * rowRanges ) const
+{
+  using ObliqueResliceKernelHelpers::ClipRow;
+  using ObliqueResliceKernelHelpers::ConvertPixel;
+
+  const int * dimensions = m_VolumeDimensions;
+  const long strideY = dimensions[0];
+  const long strideZ = static_cast<long>( dimensions[0] ) * dimensions[1];
+
+  // Offsets to the neighbors used by the trilinear kernel. Flat dimensions
+  // use a zero offset so that the kernel degenerates gracefully.
+  const long offsetX = ( dimensions[0] > 1 ) ? 1 : 0;
+  const long offsetY = ( dimensions[1] > 1 ) ? strideY : 0;
+  const long offsetZ = ( dimensions[2] > 1 ) ? strideZ : 0;
+
+  const int maxBaseX = ( dimensions[0] > 1 ) ? dimensions[0] - 2 : 0;
+  const int maxBaseY = ( dimensions[1] > 1 ) ? dimensions[1] - 2 : 0;
+  const int maxBaseZ = ( dimensions[2] > 1 ) ? dimensions[2] - 2 : 0;
+
+  // Intensity mapping, the clamping range is restricted to the range of
+  // the output pixel type.
+  double minimum = m_OutputMinimum;
+  double maximum = m_OutputMaximum;
+  const double typeMinimum = static_cast< double >(
+                    itk::NumericTraits< TOutputPixel >::NonpositiveMin() );
+  const double typeMaximum = static_cast< double >(
+                    itk::NumericTraits< TOutputPixel >::max() );
+  minimum = ( minimum < typeMinimum ) ? typeMinimum : minimum;
+  maximum = ( maximum > typeMaximum ) ? typeMaximum : maximum;
+
+  const float scale = static_cast< float >( m_Scale );
+  const float shift = static_cast< float >( m_Shift );
+  const float lowest = static_cast< float >( minimum );
+  const float highest = static_cast< float >( maximum );
+  const TOutputPixel background = ConvertPixel< TOutputPixel >(
+    static_cast< float >( m_BackgroundValue < minimum ? minimum :
+                        ( m_BackgroundValue > maximum ? maximum :
+                          m_BackgroundValue ) ) );
+
+  // Valid range of continuous indices
+  double lower[3];
+  double upper[3];
+  for( unsigned int d = 0; d < 3; d++ )
+    {
+    if( m_LinearInterpolation )
+      {
+      lower[d] = 0.0;
+      upper[d] = dimensions[d] - 1.0;
+      }
+    else
+      {
+      lower[d] = -0.5;
+      upper[d] = dimensions[d] - 0.5 - 1e-9;
+      }
+    }
+
+  const long rowSize = m_OutputSize[0];
+
+  for( unsigned int row = firstRow; row < lastRow; row++ )
+    {
+    TOutputPixel * out = output + static_cast< size_t >( row ) * rowSize;
+
+    double start[3];
+    start[0] = m_IndexOrigin[0] + row * m_IndexStep2[0];
+    start[1] = m_IndexOrigin[1] + row * m_IndexStep2[1];
+    start[2] = m_IndexOrigin[2] + row * m_IndexStep2[2];
+
+    // Clip the row against the volume, so that the inner loop does not
+    // need to check bounds.
+    double first = 0.0;
+    double last  = rowSize - 1.0;
+    bool inside = true;
+    for( unsigned int d = 0; d < 3 && inside; d++ )
+      {
+      inside = ClipRow( start[d], m_IndexStep1[d], lower[d], upper[d],
+                        first, last );
+      }
+
+    long begin = 0;
+    long end   = -1;
+    if( inside )
+      {
+      begin = static_cast< long >( ceil( first - 1e-9 ) );
+      end   = static_cast< long >( floor( last + 1e-9 ) );
+      begin = ( begin < 0 ) ? 0 : begin;
+      end   = ( end > rowSize - 1 ) ? rowSize - 1 : end;
+      }
+
+    long i = 0;
+    for( ; i < begin && i < rowSize; i++ )
+      {
+      out[i] = background;
+      }
+
+    double x = start[0] + begin * m_IndexStep1[0];
+    double y = start[1] + begin * m_IndexStep1[1];
+    double z = start[2] + begin * m_IndexStep1[2];
+
+    if( m_LinearInterpolation )
+      {
+      for( i = begin; i <= end; i++ )
+        {
+        int ix = static_cast< int >( x );
+        int iy = static_cast< int >( y );
+        int iz = static_cast< int >( z );
+        ix = ( ix > maxBaseX ) ? maxBaseX : ( ix < 0 ? 0 : ix );
+        iy = ( iy > maxBaseY ) ? maxBaseY : ( iy < 0 ? 0 : iy );
+        iz = ( iz > maxBaseZ ) ? maxBaseZ : ( iz < 0 ? 0 : iz );
+
+        const float fx = static_cast< float >( x - ix );
+        const float fy = static_cast< float >( y - iy );
+        const float fz = static_cast< float >( z - iz );
+
+        const TInputPixel * p = volume + ix + iy * strideY + iz * strideZ;
+
+        const float v000 = static_cast< float >( p[0] );
+        const float v100 = static_cast< float >( p[offsetX] );
+        const float v010 = static_cast< float >( p[offsetY] );
+        const float v110 = static_cast< float >( p[offsetX + offsetY] );
+        const float v001 = static_cast< float >( p[offsetZ] );
+        const float v101 = static_cast< float >( p[offsetX + offsetZ] );
+        const float v011 = static_cast< float >( p[offsetY + offsetZ] );
+        const float v111 =
+          static_cast< float >( p[offsetX + offsetY + offsetZ] );
+
+        const float v00 = v000 + fx * ( v100 - v000 );
+        const float v10 = v010 + fx * ( v110 - v010 );
+        const float v01 = v001 + fx * ( v101 - v001 );
+        const float v11 = v011 + fx * ( v111 - v011 );
+        const float v0  = v00 + fy * ( v10 - v00 );
+        const float v1  = v01 + fy * ( v11 - v01 );
+
+        float value = ( v0 + fz * ( v1 - v0 ) ) * scale + shift;
+        value = ( value < lowest ) ? lowest :
+                                     ( value > highest ? highest : value );
+        out[i] = ConvertPixel< TOutputPixel >( value );
+
+        x += m_IndexStep1[0];
+        y += m_IndexStep1[1];
+        z += m_IndexStep1[2];
+        }
+      }
+    else
+      {
+      for( i = begin; i <= end; i++ )
+        {
+        const long ix = static_cast< long >( x + 0.5 );
+        const long iy = static_cast< long >( y + 0.5 );
+        const long iz = static_cast< long >( z + 0.5 );
+
+        float value = static_cast< float >(
+                  volume[ ix + iy * strideY + iz * strideZ ] ) * scale + shift;
+        value = ( value < lowest ) ? lowest :
+                                     ( value > highest ? highest : value );
+        out[i] = ConvertPixel< TOutputPixel >( value );
+
+        x += m_IndexStep1[0];
+        y += m_IndexStep1[1];
+        z += m_IndexStep1[2];
+        }
+      }
+
+    for( i = ( end + 1 > begin ? end + 1 : begin ); i < rowSize; i++ )
+      {
+      out[i] = background;
+      }
+
+    if( rowRanges != NULL && rowSize > 0 )
+      {
+      TOutputPixel rowMinimum = out[0];
+      TOutputPixel rowMaximum = out[0];
+      for( i = 1; i < rowSize; i++ )
+        {
+        rowMinimum = ( out[i] < rowMinimum ) ? out[i] : rowMinimum;
+        rowMaximum = ( out[i] > rowMaximum ) ? out[i] : rowMaximum;
+        }
+      rowRanges[2 * row] = rowMinimum;
+      rowRanges[2 * row + 1] = rowMaximum;
+      }
+    }
+}
+
+} // end namespace igstk
+
+#endif
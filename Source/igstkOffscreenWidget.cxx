@@ -0,0 +1,280 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkOffscreenWidget.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+// Disabling warning C4355: 'this' : used in base member initializer list
+#if defined(_MSC_VER)
+#pragma warning ( disable : 4355 )
+#endif
+
+#include "igstkOffscreenWidget.h"
+#include "igstkEvents.h"
+#include "igstkRealTimeClock.h"
+
+#include "vtkRenderer.h"
+#include "vtkRenderWindow.h"
+
+namespace igstk
+{
+
+/** Constructor */
+OffscreenWidget::OffscreenWidget():m_StateMachine(this), m_ProxyView(this)
+{
+  this->m_Renderer = NULL;
+  this->m_RenderWindowInteractor = NULL;
+
+  this->m_RefreshCommand = RefreshCommandType::New();
+  this->m_RefreshCommand->SetCallbackFunction( this,
+                                            &OffscreenWidget::RefreshCallback );
+  this->m_RefreshObserverTag = 0;
+
+  this->m_Width = 512;
+  this->m_Height = 512;
+  this->m_WidthToBeSet = 512;
+  this->m_HeightToBeSet = 512;
+
+  this->m_CaptureFrames = true;
+
+  this->m_FrameWidth = 0;
+  this->m_FrameHeight = 0;
+  this->m_FrameTime = 0.0;
+  this->m_NumberOfFrames = 0;
+  this->m_LastCaptureTime = 0.0;
+
+  igstkAddInputMacro( ValidView );
+  igstkAddInputMacro( InValidView );
+  igstkAddInputMacro( ValidSize );
+  igstkAddInputMacro( InValidSize );
+
+  igstkAddStateMacro( Idle );
+  igstkAddStateMacro( ViewConnected );
+
+  igstkAddTransitionMacro( Idle, ValidView, ViewConnected, ConnectView );
+  igstkAddTransitionMacro( Idle, InValidView,
+                           Idle, ReportInvalidViewConnected );
+  igstkAddTransitionMacro( Idle, ValidSize, Idle, SetSize );
+  igstkAddTransitionMacro( Idle, InValidSize, Idle, ReportInvalidSize );
+
+  igstkAddTransitionMacro( ViewConnected, ValidView,
+                           ViewConnected, ReportInvalidRequest );
+  igstkAddTransitionMacro( ViewConnected, InValidView,
+                           ViewConnected, ReportInvalidViewConnected );
+  igstkAddTransitionMacro( ViewConnected, ValidSize,
+                           ViewConnected, ResizeView );
+  igstkAddTransitionMacro( ViewConnected, InValidSize,
+                           ViewConnected, ReportInvalidSize );
+
+  igstkSetInitialStateMacro( Idle );
+  m_StateMachine.SetReadyToRun();
+}
+
+/** Destructor */
+OffscreenWidget::~OffscreenWidget()
+{
+  if( this->m_View.IsNotNull() )
+    {
+    this->m_View->RemoveObserver( this->m_RefreshObserverTag );
+    }
+}
+
+/** Set VTK renderer */
+void OffscreenWidget::SetRenderer( vtkRenderer * renderer )
+{
+  this->m_Renderer = renderer;
+}
+
+/** Set VTK render window interactor */
+void
+OffscreenWidget::SetRenderWindowInteractor(
+                                      vtkRenderWindowInteractor * interactor )
+{
+  this->m_RenderWindowInteractor = interactor;
+}
+
+/** Request set size */
+void OffscreenWidget::RequestSetSize( int width, int height )
+{
+  igstkLogMacro( DEBUG, "igstkOffscreenWidget::RequestSetSize called ...\n");
+
+  if( width > 0 && height > 0 )
+    {
+    this->m_WidthToBeSet = width;
+    this->m_HeightToBeSet = height;
+    igstkPushInputMacro( ValidSize );
+    }
+  else
+    {
+    igstkPushInputMacro( InValidSize );
+    }
+
+  m_StateMachine.ProcessInputs();
+}
+
+/** Request set view */
+void OffscreenWidget::RequestSetView( ViewType * view )
+{
+  igstkLogMacro( DEBUG, "igstkOffscreenWidget::RequestSetView called ...\n");
+
+  if( view == NULL )
+    {
+    igstkPushInputMacro( InValidView );
+    }
+  else
+    {
+    this->m_View = view;
+    igstkPushInputMacro( ValidView );
+    }
+
+  m_StateMachine.ProcessInputs();
+}
+
+/** Connect the view. The size is set first, because the view only accepts
+ *  a new size before its interactor is initialized, or while it is
+ *  refreshing. */
+void OffscreenWidget::ConnectViewProcessing()
+{
+  igstkLogMacro( DEBUG,
+                 "igstkOffscreenWidget::ConnectViewProcessing called ...\n");
+
+  this->m_ProxyView.SetRenderWindowSize( this->m_View,
+                                         this->m_Width, this->m_Height );
+  this->m_ProxyView.Connect( this->m_View );
+
+  this->m_Renderer->GetRenderWindow()->SetOffScreenRendering( 1 );
+
+  this->m_NumberOfFrames = 0;
+  this->m_RefreshObserverTag =
+    this->m_View->AddObserver( RefreshEvent(), this->m_RefreshCommand );
+}
+
+/** Set the size before the view is connected */
+void OffscreenWidget::SetSizeProcessing()
+{
+  igstkLogMacro( DEBUG,
+                 "igstkOffscreenWidget::SetSizeProcessing called ...\n");
+
+  this->m_Width = this->m_WidthToBeSet;
+  this->m_Height = this->m_HeightToBeSet;
+}
+
+/** Resize the connected view */
+void OffscreenWidget::ResizeViewProcessing()
+{
+  igstkLogMacro( DEBUG,
+                 "igstkOffscreenWidget::ResizeViewProcessing called ...\n");
+
+  this->m_Width = this->m_WidthToBeSet;
+  this->m_Height = this->m_HeightToBeSet;
+  this->m_ProxyView.SetRenderWindowSize( this->m_View,
+                                         this->m_Width, this->m_Height );
+}
+
+/** Read the frame that the view just rendered */
+void OffscreenWidget::RefreshCallback()
+{
+  if( !this->m_CaptureFrames )
+    {
+    this->m_NumberOfFrames++;
+    return;
+    }
+
+  const double captureStart = RealTimeClock::GetTimeStamp();
+
+  vtkRenderWindow * renderWindow = this->m_Renderer->GetRenderWindow();
+  int * size = renderWindow->GetSize();
+  if( size[0] <= 0 || size[1] <= 0 )
+    {
+    return;
+    }
+
+  this->m_FrameWidth = size[0];
+  this->m_FrameHeight = size[1];
+  this->m_Pixels.resize( this->m_FrameWidth * this->m_FrameHeight * 3 );
+  renderWindow->GetPixelData( 0, 0, size[0] - 1, size[1] - 1, 1,
+                              &this->m_Pixels[0] );
+  this->m_FrameTime = RealTimeClock::GetTimeStamp();
+  this->m_NumberOfFrames++;
+
+  this->m_LastCaptureTime = this->m_FrameTime - captureStart;
+
+  this->InvokeEvent( OffscreenFrameEvent() );
+}
+
+const unsigned char * OffscreenWidget::GetFramePixels() const
+{
+  return this->m_Pixels.empty() ? NULL : &this->m_Pixels[0];
+}
+
+unsigned int OffscreenWidget::GetFrameWidth() const
+{
+  return this->m_FrameWidth;
+}
+
+unsigned int OffscreenWidget::GetFrameHeight() const
+{
+  return this->m_FrameHeight;
+}
+
+TimeStamp::TimePeriodType OffscreenWidget::GetFrameTime() const
+{
+  return this->m_FrameTime;
+}
+
+unsigned long OffscreenWidget::GetNumberOfFrames() const
+{
+  return this->m_NumberOfFrames;
+}
+
+double OffscreenWidget::GetLastCaptureTime() const
+{
+  return this->m_LastCaptureTime;
+}
+
+/** Report that an invalid or suspicious operation has been requested. This may
+ * mean that an error condition has arisen in one of the components that
+ * interact with this class. */
+void OffscreenWidget::ReportInvalidRequestProcessing()
+{
+  igstkLogMacro( WARNING, "ReportInvalidRequestProcessing() called ...\n");
+}
+
+/** Report that an invalid view component is specified */
+void OffscreenWidget::ReportInvalidViewConnectedProcessing()
+{
+  igstkLogMacro( WARNING,
+                "ReportInvalidViewConnectedProcessing() called ...\n");
+}
+
+/** Report that an invalid size is specified */
+void OffscreenWidget::ReportInvalidSizeProcessing()
+{
+  igstkLogMacro( WARNING, "ReportInvalidSizeProcessing() called ...\n");
+}
+
+/** Print object information */
+void OffscreenWidget::PrintSelf( std::ostream& os, itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Size: " << this->m_Width << " x " << this->m_Height
+     << std::endl;
+  os << indent << "CaptureFrames: " << this->m_CaptureFrames << std::endl;
+  os << indent << "NumberOfFrames: " << this->m_NumberOfFrames << std::endl;
+  os << indent << "LastCaptureTime: " << this->m_LastCaptureTime
+     << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkOffscreenWidget.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkOffscreenWidget_h
+#define __igstkOffscreenWidget_h
+
+#include "igstkObject.h"
+#include "igstkMacros.h"
+#include "igstkStateMachine.h"
+#include "igstkView.h"
+#include "igstkViewProxy.h"
+
+#include "itkCommand.h"
+
+#include <vector>
+
+namespace igstk
+{
+
+igstkEventMacro( OffscreenFrameEvent, IGSTKEvent );
+
+/** \class OffscreenWidget
+ *
+ *  \brief Renders a view without a display and publishes its frames.
+ *
+ *  This widget takes the place of the FLTK and Qt widgets for the
+ *  applications and the tests that have no display. The render window of
+ *  the view is switched to offscreen rendering, and the interactor is
+ *  initialized without a window system. VTK must be able to create an
+ *  offscreen context, for instance when it is built with OSMesa.
+ *
+ *  The view renders at the rate of its pulse generator, or of the
+ *  FrameScheduler that refreshes it, as long as
+ *  PulseGenerator::CheckTimeouts() is called. After every refresh, the
+ *  widget reads the pixels of the frame in a buffer that is reused from one
+ *  frame to the next, and invokes an OffscreenFrameEvent. The frame is RGB,
+ *  from the bottom row to the top one, and it is valid until the next
+ *  refresh.
+ *
+ *  \sa View
+ *  \sa FrameScheduler
+ *
+ *  \ingroup View
+ */
+class OffscreenWidget : public Object
+{
+
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( OffscreenWidget, Object )
+
+  typedef View                        ViewType;
+  typedef ViewProxy< OffscreenWidget > ProxyType;
+
+  friend class ViewProxy< OffscreenWidget >;
+
+  /** Set the size of the frames. The default is 512 x 512. */
+  void RequestSetSize( int width, int height );
+
+  /** Connect the view, and make it render offscreen */
+  void RequestSetView( ViewType * view );
+
+  /** Read the frames rendered by the view. On by default. Turn it off to
+   *  measure the rendering alone. */
+  igstkSetMacro( CaptureFrames, bool );
+  igstkGetMacro( CaptureFrames, bool );
+
+  /** Last frame read from the view. The pixels are NULL before the first
+   *  frame. */
+  const unsigned char * GetFramePixels() const;
+  unsigned int GetFrameWidth() const;
+  unsigned int GetFrameHeight() const;
+  TimeStamp::TimePeriodType GetFrameTime() const;
+
+  /** Number of frames rendered and read since the view was connected */
+  unsigned long GetNumberOfFrames() const;
+
+  /** Time spent reading the last frame, in milliseconds */
+  double GetLastCaptureTime() const;
+
+protected:
+
+  OffscreenWidget();
+  virtual ~OffscreenWidget();
+
+  /** Print the object information in a stream. */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  OffscreenWidget(const Self&);   //purposely not implemented
+  void operator=(const Self&);    //purposely not implemented
+
+  /** Set VTK renderer. This method is used in
+   *  Connect() method in ViewProxy */
+  void SetRenderer( vtkRenderer * renderer );
+
+  /** Set VTK render window interactor. this method
+    * is used in connect() method in ViewProxy class */
+  void SetRenderWindowInteractor( vtkRenderWindowInteractor * interactor );
+
+  /** Read the frame after a refresh of the view */
+  void RefreshCallback();
+
+  /** Methods invoked by the state machine */
+  void ReportInvalidRequestProcessing();
+  void ReportInvalidViewConnectedProcessing();
+  void ReportInvalidSizeProcessing();
+  void ConnectViewProcessing();
+  void SetSizeProcessing();
+  void ResizeViewProcessing();
+
+  ViewType::Pointer             m_View;
+  ProxyType                     m_ProxyView;
+  vtkRenderer                 * m_Renderer;
+  vtkRenderWindowInteractor   * m_RenderWindowInteractor;
+
+  typedef itk::SimpleMemberCommand< Self >  RefreshCommandType;
+  RefreshCommandType::Pointer   m_RefreshCommand;
+  unsigned long                 m_RefreshObserverTag;
+
+  int                           m_Width;
+  int                           m_Height;
+  int                           m_WidthToBeSet;
+  int                           m_HeightToBeSet;
+
+  bool                          m_CaptureFrames;
+
+  /** The pixels are only reallocated when the size of the frames changes */
+  std::vector< unsigned char >  m_Pixels;
+  unsigned int                  m_FrameWidth;
+  unsigned int                  m_FrameHeight;
+  TimeStamp::TimePeriodType     m_FrameTime;
+  unsigned long                 m_NumberOfFrames;
+  double                        m_LastCaptureTime;
+
+  /** States for the State Machine */
+  igstkDeclareStateMacro( Idle );
+  igstkDeclareStateMacro( ViewConnected );
+
+  /** Inputs to the State machine */
+  igstkDeclareInputMacro( ValidView );
+  igstkDeclareInputMacro( InValidView );
+  igstkDeclareInputMacro( ValidSize );
+  igstkDeclareInputMacro( InValidSize );
+};
+
+} // end namespace igstk
+
+#endif // __igstkOffscreenWidget_h
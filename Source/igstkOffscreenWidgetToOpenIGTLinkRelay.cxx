@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkOffscreenWidgetToOpenIGTLinkRelay.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+// Disabling warning C4355: 'this' : used in base member initializer list
+#if defined(_MSC_VER)
+#pragma warning ( disable : 4355 )
+#endif
+
+#include "igstkOffscreenWidgetToOpenIGTLinkRelay.h"
+
+#include <string.h>
+
+namespace igstk
+{
+
+/** Constructor */
+OffscreenWidgetToOpenIGTLinkRelay::
+OffscreenWidgetToOpenIGTLinkRelay():m_StateMachine(this)
+{
+  this->m_Observer = ObserverType::New();
+  this->m_Observer->SetCallbackFunction( this,
+                                         &Self::ResendFrameThroughOpenIGTLink );
+
+  this->m_Tag = 0;
+  this->m_Port = 18944;
+  this->m_Connected = false;
+  this->m_NumberOfSentFrames = 0;
+
+  this->m_Socket = igtl::ClientSocket::New();
+  this->m_ImageMessage = igtl::ImageMessage::New();
+  this->m_ImageMessage->SetDeviceName("View");
+  this->m_TimeStamp = igtl::TimeStamp::New();
+}
+
+OffscreenWidgetToOpenIGTLinkRelay::~OffscreenWidgetToOpenIGTLinkRelay()
+{
+  if( this->m_Widget.IsNotNull() )
+    {
+    this->m_Widget->RemoveObserver( this->m_Tag );
+    }
+
+  this->m_Socket->CloseSocket();
+}
+
+
+void
+OffscreenWidgetToOpenIGTLinkRelay::RequestSetPort( int port )
+{
+  this->m_Port = port;
+}
+
+
+void
+OffscreenWidgetToOpenIGTLinkRelay::RequestSetHostName( const char * hostname )
+{
+  this->m_HostName = hostname;
+}
+
+void
+OffscreenWidgetToOpenIGTLinkRelay::RequestSetDeviceName(
+                                                      const char * devicename )
+{
+  this->m_ImageMessage->SetDeviceName( devicename );
+}
+
+void
+OffscreenWidgetToOpenIGTLinkRelay::RequestSetOffscreenWidget(
+                                                const OffscreenWidget * widget )
+{
+  if( this->m_Widget.IsNotNull() )
+    {
+    this->m_Widget->RemoveObserver( this->m_Tag );
+    }
+
+  this->m_Widget = widget;
+
+  if( this->m_Widget.IsNotNull() )
+    {
+    this->m_Tag = this->m_Widget->AddObserver( OffscreenFrameEvent(),
+                                               this->m_Observer );
+    }
+}
+
+
+void
+OffscreenWidgetToOpenIGTLinkRelay::RequestStart()
+{
+  char * hostname = const_cast< char * >( this->m_HostName.c_str() );
+
+  int r = this->m_Socket->ConnectToServer( hostname, this->m_Port );
+  if( r != 0 )
+    {
+    igstkLogMacro( CRITICAL, "igstk::OffscreenWidgetToOpenIGTLinkRelay: "
+                   "cannot connect to the server\n" );
+    this->m_Connected = false;
+    return;
+    }
+
+  this->m_Connected = true;
+}
+
+unsigned long
+OffscreenWidgetToOpenIGTLinkRelay::GetNumberOfSentFrames() const
+{
+  return this->m_NumberOfSentFrames;
+}
+
+void
+OffscreenWidgetToOpenIGTLinkRelay::ResendFrameThroughOpenIGTLink(
+                                   itk::Object * itkNotUsed(caller),
+                                   const itk::EventObject & itkNotUsed(event) )
+{
+  const unsigned char * pixels = this->m_Widget->GetFramePixels();
+  if( !this->m_Connected || pixels == NULL )
+    {
+    return;
+    }
+
+  const int width = this->m_Widget->GetFrameWidth();
+  const int height = this->m_Widget->GetFrameHeight();
+
+  // The scalars are only reallocated when the size of the frames changes
+  int dimensions[3];
+  this->m_ImageMessage->GetDimensions( dimensions );
+  if( dimensions[0] != width || dimensions[1] != height ||
+      this->m_ImageMessage->GetScalarPointer() == NULL )
+    {
+    this->m_ImageMessage->SetDimensions( width, height, 1 );
+    this->m_ImageMessage->SetSpacing( 1.0f, 1.0f, 1.0f );
+    this->m_ImageMessage->SetScalarTypeToUint8();
+    this->m_ImageMessage->SetNumComponents( 3 );
+    this->m_ImageMessage->AllocateScalars();
+    }
+
+  memcpy( this->m_ImageMessage->GetScalarPointer(), pixels,
+          static_cast< size_t >( width ) * height * 3 );
+
+  // igstk time stamps are in milliseconds, OpenIGTLink ones in seconds
+  this->m_TimeStamp->SetTime( this->m_Widget->GetFrameTime() / 1000.0 );
+  this->m_ImageMessage->SetTimeStamp( this->m_TimeStamp );
+  this->m_ImageMessage->Pack();
+
+  if( this->m_Socket->Send( this->m_ImageMessage->GetPackPointer(),
+                            this->m_ImageMessage->GetPackSize() ) == 0 )
+    {
+    igstkLogMacro( CRITICAL, "igstk::OffscreenWidgetToOpenIGTLinkRelay: "
+                   "the connection was lost\n" );
+    this->m_Connected = false;
+    return;
+    }
+
+  this->m_NumberOfSentFrames++;
+}
+
+
+/** Print Self function */
+void OffscreenWidgetToOpenIGTLinkRelay::PrintSelf(
+                                   std::ostream& os, itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Port: " << this->m_Port << std::endl;
+  os << indent << "Hostname: " << this->m_HostName << std::endl;
+  os << indent << "Connected: " << this->m_Connected << std::endl;
+  os << indent << "NumberOfSentFrames: " << this->m_NumberOfSentFrames
+     << std::endl;
+}
+
+}
@@ -0,0 +1,113 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkOffscreenWidgetToOpenIGTLinkRelay.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkOffscreenWidgetToOpenIGTLinkRelay_h
+#define __igstkOffscreenWidgetToOpenIGTLinkRelay_h
+
+#include "igstkObject.h"
+#include "igstkMacros.h"
+#include "igstkStateMachine.h"
+#include "igstkOffscreenWidget.h"
+
+#include "igtlOSUtil.h"
+#include "igtlImageMessage.h"
+#include "igtlClientSocket.h"
+
+
+namespace igstk
+{
+/** \class OffscreenWidgetToOpenIGTLinkRelay
+ *
+ *  \brief This class observes the frames of an OffscreenWidget and relays
+ *  them to a socket connection as OpenIGTLink IMAGE messages.
+ *
+ *  The frames are sent as RGB images of unsigned chars. The message and
+ *  its pixels are reused from one frame to the next, and only reallocated
+ *  when the size of the frames changes.
+ *
+ *  \sa OffscreenWidget
+ */
+
+class OffscreenWidgetToOpenIGTLinkRelay  : public Object
+{
+
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( OffscreenWidgetToOpenIGTLinkRelay, Object )
+
+public:
+
+  void RequestSetPort( int port );
+
+  void RequestSetHostName( const char * hostname );
+
+  void RequestSetDeviceName( const char * devicename );
+
+  void RequestSetOffscreenWidget( const OffscreenWidget * widget );
+
+  /** Connect to the server. The frames are sent once connected. */
+  void RequestStart();
+
+  /** Number of frames sent */
+  unsigned long GetNumberOfSentFrames() const;
+
+protected:
+
+  /** Constructor is protected in order to enforce
+   *  the use of the New() operator */
+  OffscreenWidgetToOpenIGTLinkRelay(void);
+
+  virtual ~OffscreenWidgetToOpenIGTLinkRelay(void);
+
+  /** Print the object information. */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+  void ResendFrameThroughOpenIGTLink(
+    itk::Object * caller, const itk::EventObject & event );
+
+  typedef itk::MemberCommand< OffscreenWidgetToOpenIGTLinkRelay >
+                                                                   ObserverType;
+
+
+private:
+
+  ObserverType::Pointer           m_Observer;
+
+  OffscreenWidget::ConstPointer   m_Widget;
+
+  unsigned long                   m_Tag;
+
+  int                             m_Port;
+
+  std::string                     m_HostName;
+
+  bool                            m_Connected;
+
+  unsigned long                   m_NumberOfSentFrames;
+
+  igtl::ClientSocket::Pointer     m_Socket;
+
+  igtl::ImageMessage::Pointer     m_ImageMessage;
+
+  igtl::TimeStamp::Pointer        m_TimeStamp;
+
+};
+
+} // end of namespace igstk
+
+#endif //__igstkOffscreenWidgetToOpenIGTLinkRelay_h
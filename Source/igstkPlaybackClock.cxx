@@ -0,0 +1,79 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkPlaybackClock.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkPlaybackClock.h"
+#include "igstkRealTimeClock.h"
+
+namespace igstk
+{
+
+PlaybackClock::PlaybackClock():m_StateMachine(this)
+{
+  m_Started = false;
+  m_PlaybackSpeed = 1.0;
+  m_ReferenceRealTime = 0.0;
+  m_ReferenceRecordingTime = 0.0;
+}
+
+PlaybackClock::~PlaybackClock()
+{
+}
+
+void PlaybackClock::SeekToTime( TimePeriodType recordingTime )
+{
+  m_ReferenceRealTime = RealTimeClock::GetTimeStamp();
+  m_ReferenceRecordingTime = recordingTime;
+  m_Started = true;
+  this->Modified();
+}
+
+PlaybackClock::TimePeriodType PlaybackClock::GetRecordingTime() const
+{
+  if( !m_Started )
+    {
+    return m_ReferenceRecordingTime;
+    }
+  return m_ReferenceRecordingTime + m_PlaybackSpeed *
+         ( RealTimeClock::GetTimeStamp() - m_ReferenceRealTime );
+}
+
+void PlaybackClock::SetPlaybackSpeed( double speed )
+{
+  // Changing the speed must not move the recording time
+  const TimePeriodType recordingTime = this->GetRecordingTime();
+  m_ReferenceRealTime = RealTimeClock::GetTimeStamp();
+  m_ReferenceRecordingTime = recordingTime;
+  m_PlaybackSpeed = ( speed > 0.0 ) ? speed : 0.0;
+}
+
+/** Print Self function */
+void PlaybackClock::PrintSelf( std::ostream& os, itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Started: " << m_Started << std::endl;
+  os << indent << "Playback speed: " << m_PlaybackSpeed << std::endl;
+  os << indent << "Recording time: " << this->GetRecordingTime() << std::endl;
+}
+
+} // end namespace igstk
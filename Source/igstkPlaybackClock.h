@@ -0,0 +1,85 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkPlaybackClock.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkPlaybackClock_h
+#define __igstkPlaybackClock_h
+
+#include "igstkObject.h"
+#include "igstkTransform.h"
+
+namespace igstk
+{
+
+/** \class PlaybackClock
+ *  \brief Maps the RealTimeClock to the time of a recording.
+ *
+ *  A playback clock is shared by the players of the streams of a
+ *  recording, e.g. a PlaybackTracker and a PlaybackVideoImager, so that
+ *  they replay the samples recorded at the same time together. The clock
+ *  starts at the recording time given to SeekToTime(), and then advances
+ *  with the RealTimeClock, multiplied by the playback speed.
+ *
+ *  Every call to SeekToTime() modifies the clock, so that the players can
+ *  detect the jumps in the recording by comparing its MTime.
+ *
+ *  \ingroup Tracker
+ */
+class PlaybackClock : public Object
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( PlaybackClock, Object )
+
+  typedef Transform::TimePeriodType           TimePeriodType;
+
+  /** Move the clock to the given recording time, now */
+  void SeekToTime( TimePeriodType recordingTime );
+
+  /** Whether SeekToTime() has been called */
+  igstkGetMacro( Started, bool );
+
+  /** Current recording time */
+  TimePeriodType GetRecordingTime() const;
+
+  /** Playback speed, 1 by default. The recording time does not advance
+   *  with a zero speed. */
+  void SetPlaybackSpeed( double speed );
+  igstkGetMacro( PlaybackSpeed, double );
+
+protected:
+
+  PlaybackClock();
+  virtual ~PlaybackClock();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  PlaybackClock(const Self&);    //purposely not implemented
+  void operator=(const Self&);   //purposely not implemented
+
+  bool              m_Started;
+  double            m_PlaybackSpeed;
+  TimePeriodType    m_ReferenceRealTime;
+  TimePeriodType    m_ReferenceRecordingTime;
+};
+
+} // end namespace igstk
+
+#endif // __igstkPlaybackClock_h
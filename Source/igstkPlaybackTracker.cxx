@@ -0,0 +1,553 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkPlaybackTracker.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkPlaybackTracker.h"
+#include "igstkRealTimeClock.h"
+#include "igstkRigidTransform.h"
+
+#include <string.h>
+
+namespace igstk
+{
+
+PlaybackTracker::PlaybackTracker():m_StateMachine(this)
+{
+  // Reading the next records is cheap, it is done in the thread of the
+  // pulse generators.
+  this->SetThreadingEnabled( false );
+
+  m_PlaybackSpeed = 1.0;
+  m_Loop = false;
+
+  m_File = NULL;
+  m_DataOffset = 0;
+  m_NumberOfRecords = 0;
+  m_FileRecord = 0;
+  m_RecordingStartTime = 0.0;
+  m_RecordingEndTime = 0.0;
+
+  m_NextRecord = 0;
+  m_PlaybackTime = 0.0;
+  m_PaceValid = false;
+  m_PaceRealTime = 0.0;
+  m_PaceRecordingTime = 0.0;
+
+  m_PlaybackClockSeekTime = 0;
+}
+
+PlaybackTracker::~PlaybackTracker()
+{
+  this->CloseFile();
+}
+
+void PlaybackTracker::CloseFile()
+{
+  if( m_File )
+    {
+    fclose( m_File );
+    m_File = NULL;
+    }
+  m_NumberOfRecords = 0;
+  m_RecordedToolNames.clear();
+  m_Index.clear();
+}
+
+void PlaybackTracker::SetPlaybackClock( PlaybackClock * clock )
+{
+  m_PlaybackClock = clock;
+  m_PlaybackClockSeekTime = 0;
+}
+
+PlaybackClock * PlaybackTracker::GetPlaybackClock() const
+{
+  return m_PlaybackClock;
+}
+
+bool PlaybackTracker::SeekToTime( TimePeriodType time )
+{
+  if( !m_File )
+    {
+    igstkLogMacro( WARNING, "igstk::PlaybackTracker::SeekToTime: "
+                   "no recording is open\n" );
+    return false;
+    }
+
+  m_NextRecord = this->FindRecord( time );
+  m_PlaybackTime = time;
+  m_PaceValid = false;
+
+  return true;
+}
+
+bool PlaybackTracker::IsAtEnd() const
+{
+  return ( m_NextRecord >= m_NumberOfRecords );
+}
+
+unsigned int PlaybackTracker::GetNumberOfRecordedTools() const
+{
+  return m_RecordedToolNames.size();
+}
+
+std::string
+PlaybackTracker::GetRecordedToolName( unsigned int toolIndex ) const
+{
+  if( toolIndex >= m_RecordedToolNames.size() )
+    {
+    return std::string();
+    }
+  return m_RecordedToolNames[toolIndex];
+}
+
+unsigned int
+PlaybackTracker::FindRecordedTool( const std::string & name ) const
+{
+  unsigned int index = 0;
+  while( index < m_RecordedToolNames.size() &&
+         m_RecordedToolNames[index] != name )
+    {
+    index++;
+    }
+  return index;
+}
+
+bool PlaybackTracker::ReadRecord( unsigned long record, RecordType & data )
+{
+  if( record >= m_NumberOfRecords )
+    {
+    return false;
+    }
+
+  if( record != m_FileRecord )
+    {
+    const long offset = m_DataOffset +
+                        static_cast< long >( record * sizeof( RecordType ) );
+    if( fseek( m_File, offset, SEEK_SET ) != 0 )
+      {
+      return false;
+      }
+    m_FileRecord = record;
+    }
+
+  if( fread( &data, sizeof( RecordType ), 1, m_File ) != 1 )
+    {
+    // The position in the file is unknown
+    m_FileRecord = m_NumberOfRecords;
+    return false;
+    }
+  m_FileRecord++;
+
+  return true;
+}
+
+unsigned long PlaybackTracker::FindRecord( TimePeriodType time )
+{
+  // The index narrows the search to the records between two entries: the
+  // last entry before the time and the next one.
+  unsigned long first = 0;
+  unsigned long last = m_NumberOfRecords;
+
+  unsigned long lowEntry = 0;
+  unsigned long highEntry = m_Index.size();
+  while( lowEntry < highEntry )
+    {
+    const unsigned long entry = ( lowEntry + highEntry ) / 2;
+    if( m_Index[entry].m_Time < time )
+      {
+      lowEntry = entry + 1;
+      }
+    else
+      {
+      highEntry = entry;
+      }
+    }
+  if( lowEntry > 0 )
+    {
+    first = m_Index[lowEntry - 1].m_Record;
+    }
+  if( lowEntry < m_Index.size() )
+    {
+    last = m_Index[lowEntry].m_Record;
+    }
+
+  // First record of [first, last) whose time is at least the given time,
+  // or last
+  RecordType data;
+  while( first < last )
+    {
+    const unsigned long record = first + ( last - first ) / 2;
+    if( !this->ReadRecord( record, data ) )
+      {
+      return m_NumberOfRecords;
+      }
+    if( data.m_Time < time )
+      {
+      first = record + 1;
+      }
+    else
+      {
+      last = record;
+      }
+    }
+
+  return first;
+}
+
+PlaybackTracker::ResultType PlaybackTracker::InternalOpen( void )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackTracker::InternalOpen called ...\n");
+
+  this->CloseFile();
+
+  m_File = fopen( m_FileName.c_str(), "rb" );
+  if( !m_File )
+    {
+    igstkLogMacro( CRITICAL, "igstk::PlaybackTracker::InternalOpen: "
+                   "can not open " << m_FileName << "\n" );
+    return FAILURE;
+    }
+
+  TrackerRecorder::FileHeaderType header;
+  if( fread( &header, sizeof( header ), 1, m_File ) != 1 ||
+      memcmp( header.m_Signature, TrackerRecorder::GetFileSignature(),
+              sizeof( header.m_Signature ) ) != 0 ||
+      header.m_Version != TrackerRecorder::FileVersion ||
+      header.m_RecordSize != sizeof( RecordType ) )
+    {
+    igstkLogMacro( CRITICAL, "igstk::PlaybackTracker::InternalOpen: "
+                   << m_FileName << " is not a tracker recording\n" );
+    this->CloseFile();
+    return FAILURE;
+    }
+
+  char name[TrackerRecorder::NameLength];
+  for( unsigned int i = 0; i < header.m_NumberOfTools; i++ )
+    {
+    if( fread( name, TrackerRecorder::NameLength, 1, m_File ) != 1 )
+      {
+      igstkLogMacro( CRITICAL, "igstk::PlaybackTracker::InternalOpen: "
+                     << m_FileName << " is truncated\n" );
+      this->CloseFile();
+      return FAILURE;
+      }
+    name[TrackerRecorder::NameLength - 1] = '\0';
+    m_RecordedToolNames.push_back( name );
+    }
+
+  // A record that was being written when the recording stopped is ignored
+  m_DataOffset = ftell( m_File );
+  fseek( m_File, 0, SEEK_END );
+  m_NumberOfRecords = ( ftell( m_File ) - m_DataOffset ) / sizeof( RecordType );
+  fseek( m_File, m_DataOffset, SEEK_SET );
+  m_FileRecord = 0;
+
+  // Without its index, the recording is searched as a single block
+  FILE * indexFile = fopen(
+    TrackerRecorder::GetIndexFileName( m_FileName ).c_str(), "rb" );
+  if( indexFile )
+    {
+    IndexEntryType entry;
+    while( fread( &entry, sizeof( entry ), 1, indexFile ) == 1 &&
+           entry.m_Record < m_NumberOfRecords )
+      {
+      m_Index.push_back( entry );
+      }
+    fclose( indexFile );
+    }
+  else
+    {
+    igstkLogMacro( WARNING, "igstk::PlaybackTracker::InternalOpen: "
+                   "the recording has no index\n" );
+    }
+
+  RecordType data;
+  m_RecordingStartTime = 0.0;
+  m_RecordingEndTime = 0.0;
+  if( this->ReadRecord( m_NumberOfRecords - 1, data ) )
+    {
+    m_RecordingEndTime = data.m_Time;
+    }
+  if( this->ReadRecord( 0, data ) )
+    {
+    m_RecordingStartTime = data.m_Time;
+    }
+
+  m_RecordedToolSlots.assign( m_RecordedToolNames.size(),
+                              InvalidTrackerToolSlot );
+  m_LatestRecords.resize( m_RecordedToolNames.size() );
+  m_PendingRecords.assign( m_RecordedToolNames.size(), false );
+
+  m_NextRecord = 0;
+  m_PlaybackTime = m_RecordingStartTime;
+  m_PaceValid = false;
+
+  return SUCCESS;
+}
+
+PlaybackTracker::ResultType PlaybackTracker::InternalStartTracking( void )
+{
+  igstkLogMacro( DEBUG,
+    "igstk::PlaybackTracker::InternalStartTracking called ...\n");
+
+  m_PaceValid = false;
+  m_PendingRecords.assign( m_PendingRecords.size(), false );
+
+  return SUCCESS;
+}
+
+PlaybackTracker::ResultType PlaybackTracker::InternalReset( void )
+{
+  igstkLogMacro( DEBUG,
+    "igstk::PlaybackTracker::InternalReset called ...\n");
+
+  m_NextRecord = 0;
+  m_PlaybackTime = m_RecordingStartTime;
+  m_PaceValid = false;
+  m_PendingRecords.assign( m_PendingRecords.size(), false );
+
+  return SUCCESS;
+}
+
+PlaybackTracker::ResultType PlaybackTracker::InternalStopTracking( void )
+{
+  igstkLogMacro( DEBUG,
+    "igstk::PlaybackTracker::InternalStopTracking called ...\n");
+  return SUCCESS;
+}
+
+PlaybackTracker::ResultType PlaybackTracker::InternalClose( void )
+{
+  igstkLogMacro( DEBUG,
+    "igstk::PlaybackTracker::InternalClose called ...\n");
+
+  this->CloseFile();
+  return SUCCESS;
+}
+
+PlaybackTracker::ResultType PlaybackTracker
+::VerifyTrackerToolInformation( const TrackerToolType * trackerTool )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackTracker::"
+                 "VerifyTrackerToolInformation called ...\n");
+
+  if( !dynamic_cast< const PlaybackTrackerTool * >( trackerTool ) )
+    {
+    igstkLogMacro( CRITICAL, "igstk::PlaybackTracker::"
+                   "VerifyTrackerToolInformation: only PlaybackTrackerTool "
+                   "objects can be attached\n" );
+    return FAILURE;
+    }
+
+  const std::string name = trackerTool->GetTrackerToolIdentifier();
+  if( this->FindRecordedTool( name ) == m_RecordedToolNames.size() )
+    {
+    igstkLogMacro( CRITICAL, "igstk::PlaybackTracker::"
+                   "VerifyTrackerToolInformation: " << name
+                   << " is not in the recording\n" );
+    return FAILURE;
+    }
+
+  return SUCCESS;
+}
+
+PlaybackTracker::ResultType PlaybackTracker
+::AddTrackerToolToInternalDataContainers( const TrackerToolType * trackerTool )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackTracker::"
+                 "AddTrackerToolToInternalDataContainers called ...\n");
+
+  const unsigned int toolIndex =
+    this->FindRecordedTool( trackerTool->GetTrackerToolIdentifier() );
+  if( toolIndex == m_RecordedToolNames.size() )
+    {
+    return FAILURE;
+    }
+
+  m_RecordedToolSlots[toolIndex] = this->GetTrackerToolSlot( trackerTool );
+  return SUCCESS;
+}
+
+PlaybackTracker::ResultType PlaybackTracker
+::RemoveTrackerToolFromInternalDataContainers(
+                                         const TrackerToolType * trackerTool )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackTracker::"
+                 "RemoveTrackerToolFromInternalDataContainers called ...\n");
+
+  const unsigned int toolIndex =
+    this->FindRecordedTool( trackerTool->GetTrackerToolIdentifier() );
+  if( toolIndex == m_RecordedToolNames.size() )
+    {
+    return FAILURE;
+    }
+
+  m_RecordedToolSlots[toolIndex] = InvalidTrackerToolSlot;
+  m_PendingRecords[toolIndex] = false;
+  return SUCCESS;
+}
+
+void PlaybackTracker::ReplayRecord( const RecordType & record )
+{
+  if( record.m_ToolIndex < m_LatestRecords.size() )
+    {
+    m_LatestRecords[record.m_ToolIndex] = record;
+    m_PendingRecords[record.m_ToolIndex] = true;
+    }
+  m_PlaybackTime = record.m_Time;
+}
+
+PlaybackTracker::ResultType PlaybackTracker::InternalUpdateStatus( void )
+{
+  igstkLogMacro( DEBUG,
+    "igstk::PlaybackTracker::InternalUpdateStatus called ...\n");
+
+  const TimePeriodType now = RealTimeClock::GetTimeStamp();
+
+  if( m_PlaybackClock.IsNotNull() )
+    {
+    // The first player of a recording starts the shared clock
+    if( !m_PlaybackClock->GetStarted() )
+      {
+      RecordType first;
+      m_PlaybackClock->SeekToTime( this->ReadRecord( m_NextRecord, first ) ?
+                                   first.m_Time : m_PlaybackTime );
+      }
+    if( m_PlaybackClock->GetMTime() != m_PlaybackClockSeekTime )
+      {
+      m_NextRecord = this->FindRecord( m_PlaybackClock->GetRecordingTime() );
+      m_PlaybackClockSeekTime = m_PlaybackClock->GetMTime();
+      }
+    }
+  else if( m_NextRecord >= m_NumberOfRecords && m_Loop )
+    {
+    m_NextRecord = 0;
+    m_PaceValid = false;
+    }
+
+  RecordType record;
+  if( this->ReadRecord( m_NextRecord, record ) )
+    {
+    // Recording time up to which the records are due
+    TimePeriodType dueTime = record.m_Time;
+    if( m_PlaybackClock.IsNotNull() )
+      {
+      dueTime = m_PlaybackClock->GetRecordingTime();
+      }
+    else if( m_PlaybackSpeed > 0.0 )
+      {
+      if( !m_PaceValid )
+        {
+        m_PaceRealTime = now;
+        m_PaceRecordingTime = record.m_Time;
+        m_PaceValid = true;
+        }
+      dueTime = m_PaceRecordingTime +
+                ( now - m_PaceRealTime ) * m_PlaybackSpeed;
+      }
+
+    while( record.m_Time <= dueTime )
+      {
+      this->ReplayRecord( record );
+      m_NextRecord++;
+      if( !this->ReadRecord( m_NextRecord, record ) )
+        {
+        break;
+        }
+      }
+    }
+
+  RigidTransform sample;
+  TransformType transform;
+
+  for( unsigned int toolIndex = 0; toolIndex < m_LatestRecords.size();
+       toolIndex++ )
+    {
+    const TrackerToolSlotType slot = m_RecordedToolSlots[toolIndex];
+    if( !m_PendingRecords[toolIndex] || slot == InvalidTrackerToolSlot )
+      {
+      continue;
+      }
+    m_PendingRecords[toolIndex] = false;
+
+    const RecordType & latest = m_LatestRecords[toolIndex];
+    if( latest.m_Status != TrackerRecorder::ToolVisible )
+      {
+      this->ReportTrackingToolNotAvailable( slot );
+      continue;
+      }
+
+    for( unsigned int i = 0; i < 4; i++ )
+      {
+      sample.m_Rotation[i] = latest.m_Rotation[i];
+      }
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      sample.m_Translation[i] = latest.m_Translation[i];
+      }
+    sample.m_Translation[3] = 0.0;
+    sample.m_Error = latest.m_Error;
+    sample.m_StartTime = now;
+    sample.m_ExpirationTime = now + this->GetValidityTime();
+    sample.ExportTransform( transform );
+
+    this->ReportTrackingToolVisible( slot );
+    this->SetTrackerToolRawTransform( slot, transform );
+    this->SetTrackerToolTransformUpdate( slot, true );
+    }
+
+  return SUCCESS;
+}
+
+PlaybackTracker::ResultType
+PlaybackTracker::InternalThreadedUpdateStatus( void )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackTracker::"
+                 "InternalThreadedUpdateStatus called ...\n");
+  return SUCCESS;
+}
+
+/** Print Self function */
+void PlaybackTracker::PrintSelf( std::ostream& os, itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "File name: " << m_FileName << std::endl;
+  os << indent << "Playback speed: " << m_PlaybackSpeed << std::endl;
+  os << indent << "Loop: " << m_Loop << std::endl;
+  os << indent << "Playback clock: " << m_PlaybackClock.GetPointer()
+     << std::endl;
+  os << indent << "Number of records: " << m_NumberOfRecords << std::endl;
+  os << indent << "Number of index entries: " << m_Index.size() << std::endl;
+  os << indent << "Recording start time: " << m_RecordingStartTime
+     << std::endl;
+  os << indent << "Recording end time: " << m_RecordingEndTime << std::endl;
+  os << indent << "Playback time: " << m_PlaybackTime << std::endl;
+
+  for( unsigned int i = 0; i < m_RecordedToolNames.size(); i++ )
+    {
+    os << indent << "Recorded tool " << i << ": " << m_RecordedToolNames[i]
+       << std::endl;
+    }
+}
+
+} // end namespace igstk
@@ -0,0 +1,202 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkPlaybackTracker.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkPlaybackTracker_h
+#define __igstkPlaybackTracker_h
+
+#include "igstkTracker.h"
+#include "igstkPlaybackTrackerTool.h"
+#include "igstkTrackerRecorder.h"
+#include "igstkPlaybackClock.h"
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+
+namespace igstk
+{
+
+/** \class PlaybackTracker
+ *  \brief Tracker replaying a recording of a TrackerRecorder.
+ *
+ *  The file is set with SetFileName() before RequestOpen(). The
+ *  PlaybackTrackerTool objects attached to the tracker are matched by name
+ *  with the recorded tools. The recorded transforms are reported as raw
+ *  transforms, with a validity period starting at the time they are
+ *  replayed.
+ *
+ *  With a positive PlaybackSpeed, the records are replayed at the pace at
+ *  which they were recorded, multiplied by the speed. With a zero speed,
+ *  every update of the tracker replays the next group of records that share
+ *  the same time, i.e. the recording is replayed as fast as the frequency
+ *  of the tracker allows.
+ *
+ *  When a PlaybackClock is set, the tracker replays the records up to the
+ *  time of the clock instead, and follows the seeks of the clock. The
+ *  clock is shared with the players of the other streams of the recording,
+ *  e.g. a PlaybackVideoImager, to replay them synchronized.
+ *
+ *  SeekToTime() moves the playback to any time of the recording with a
+ *  binary search in the index of the recording and in the records, without
+ *  reading the records in between.
+ *
+ *  The records are read in the thread of the pulse generators, so the
+ *  tracker does not use a tracking thread.
+ *
+ *  \sa TrackerRecorder
+ *
+ *  \ingroup Tracker
+ */
+class PlaybackTracker : public Tracker
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( PlaybackTracker, Tracker )
+
+  typedef Superclass::TransformType           TransformType;
+  typedef Transform::TimePeriodType           TimePeriodType;
+  typedef TrackerRecorder::RecordType         RecordType;
+
+  /** Name of the recording, set before RequestOpen() */
+  igstkSetStringMacro( FileName );
+  igstkGetStringMacro( FileName );
+
+  /** Playback speed, 1 by default. Zero replays the recording as fast as
+   *  the frequency of the tracker allows. */
+  igstkSetMacro( PlaybackSpeed, double );
+  igstkGetMacro( PlaybackSpeed, double );
+
+  /** Restart at the beginning of the recording once it has been replayed.
+   *  False by default. */
+  igstkSetMacro( Loop, bool );
+  igstkGetMacro( Loop, bool );
+
+  /** Clock followed by the playback, instead of the playback speed. NULL
+   *  by default. */
+  void SetPlaybackClock( PlaybackClock * clock );
+  PlaybackClock * GetPlaybackClock() const;
+
+  /** Move the playback to the first record whose time is at least the
+   *  given recording time. Returns false if no recording is open. */
+  bool SeekToTime( TimePeriodType time );
+
+  /** Time, in the recording, of the last replayed records */
+  igstkGetMacro( PlaybackTime, TimePeriodType );
+
+  /** Times of the first and of the last records */
+  igstkGetMacro( RecordingStartTime, TimePeriodType );
+  igstkGetMacro( RecordingEndTime, TimePeriodType );
+
+  /** Number of records in the recording */
+  igstkGetMacro( NumberOfRecords, unsigned long );
+
+  /** Whether all the records have been replayed */
+  bool IsAtEnd() const;
+
+  /** Names of the recorded tools */
+  unsigned int GetNumberOfRecordedTools() const;
+  std::string GetRecordedToolName( unsigned int toolIndex ) const;
+
+protected:
+
+  PlaybackTracker();
+  virtual ~PlaybackTracker();
+
+  typedef Tracker::ResultType                 ResultType;
+
+  virtual ResultType InternalOpen( void );
+  virtual ResultType InternalStartTracking( void );
+  virtual ResultType InternalReset( void );
+  virtual ResultType InternalStopTracking( void );
+  virtual ResultType InternalClose( void );
+
+  /** Verify tracker tool information */
+  virtual ResultType VerifyTrackerToolInformation( const TrackerToolType * );
+
+  virtual ResultType RemoveTrackerToolFromInternalDataContainers(
+                                                   const TrackerToolType * );
+
+  virtual ResultType AddTrackerToolToInternalDataContainers(
+                                                   const TrackerToolType * );
+
+  /** Replay the records that are due and set the transforms of the tools */
+  virtual ResultType InternalUpdateStatus( void );
+  virtual ResultType InternalThreadedUpdateStatus( void );
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  PlaybackTracker(const Self&);  //purposely not implemented
+  void operator=(const Self&);   //purposely not implemented
+
+  typedef TrackerRecorder::IndexEntryType     IndexEntryType;
+
+  /** Read a record. Sequential reads do not move the file position. */
+  bool ReadRecord( unsigned long record, RecordType & data );
+
+  /** Number of the first record whose time is at least the given time */
+  unsigned long FindRecord( TimePeriodType time );
+
+  /** Index of a recorded tool, or the number of recorded tools */
+  unsigned int FindRecordedTool( const std::string & name ) const;
+
+  /** Remember the latest record of its tool, to be reported */
+  void ReplayRecord( const RecordType & record );
+
+  void CloseFile();
+
+  std::string                     m_FileName;
+  double                          m_PlaybackSpeed;
+  bool                            m_Loop;
+
+  FILE *                          m_File;
+  long                            m_DataOffset;
+  unsigned long                   m_NumberOfRecords;
+  unsigned long                   m_FileRecord;
+  std::vector< std::string >      m_RecordedToolNames;
+  std::vector< IndexEntryType >   m_Index;
+  TimePeriodType                  m_RecordingStartTime;
+  TimePeriodType                  m_RecordingEndTime;
+
+  /** Tracker tool slot of every recorded tool, an invalid slot if the tool
+   *  is not attached */
+  std::vector< TrackerToolSlotType >  m_RecordedToolSlots;
+
+  /** Latest replayed record of every recorded tool, and whether it has not
+   *  been reported yet */
+  std::vector< RecordType >       m_LatestRecords;
+  std::vector< bool >             m_PendingRecords;
+
+  /** Playback position, and the recording time played at a given real
+   *  time, from which the due records are computed */
+  unsigned long                   m_NextRecord;
+  TimePeriodType                  m_PlaybackTime;
+  bool                            m_PaceValid;
+  TimePeriodType                  m_PaceRealTime;
+  TimePeriodType                  m_PaceRecordingTime;
+
+  /** Shared clock, and its modification time at the last seek */
+  PlaybackClock::Pointer          m_PlaybackClock;
+  unsigned long                   m_PlaybackClockSeekTime;
+};
+
+} // end namespace igstk
+
+#endif // __igstkPlaybackTracker_h
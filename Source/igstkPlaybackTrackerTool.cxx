@@ -0,0 +1,76 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkPlaybackTrackerTool.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkPlaybackTrackerTool.h"
+
+namespace igstk
+{
+
+/** Constructor */
+PlaybackTrackerTool::PlaybackTrackerTool():m_StateMachine(this)
+{
+  m_TrackerToolConfigured = false;
+}
+
+/** Destructor */
+PlaybackTrackerTool::~PlaybackTrackerTool()
+{
+}
+
+/** Request set tool name */
+void PlaybackTrackerTool::RequestSetToolName( const ToolNameType & toolName )
+{
+  if( toolName.empty() )
+    {
+    igstkLogMacro( CRITICAL, "igstk::PlaybackTrackerTool::"
+                   "RequestSetToolName: empty tool name\n" );
+    return;
+    }
+
+  this->m_ToolName = toolName;
+  m_TrackerToolConfigured = true;
+
+  // The recorded identifier of the tool is its identifier in playback
+  this->SetTrackerToolIdentifier( m_ToolName );
+}
+
+/** The "CheckIfTrackerToolIsConfigured" method returns true if
+ *  the tracker tool is configured */
+bool
+PlaybackTrackerTool::CheckIfTrackerToolIsConfigured( ) const
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackTrackerTool::"
+                 "CheckIfTrackerToolIsConfigured called...\n");
+  return m_TrackerToolConfigured;
+}
+
+/** Print Self function */
+void PlaybackTrackerTool::PrintSelf( std::ostream& os,
+                                     itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Tool name: " << m_ToolName << std::endl;
+}
+
+} //igstk namespace
@@ -0,0 +1,81 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkPlaybackTrackerTool.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkPlaybackTrackerTool_h
+#define __igstkPlaybackTrackerTool_h
+
+#include "igstkTrackerTool.h"
+
+namespace igstk
+{
+
+class PlaybackTracker;
+
+/** \class PlaybackTrackerTool
+  * \brief A PlaybackTracker-specific TrackerTool class.
+  *
+  * A PlaybackTrackerTool replays the transforms of a recorded tool. The tool
+  * name must be the identifier that the tool had when it was recorded.
+  *
+  * \sa PlaybackTracker
+  *
+  * \ingroup Tracker
+  *
+  */
+
+class PlaybackTrackerTool : public TrackerTool
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( PlaybackTrackerTool, TrackerTool )
+
+  typedef std::string       ToolNameType;
+
+  /** Get the name of the tool */
+  igstkGetStringMacro( ToolName );
+
+  /** Set the name of the recorded tool */
+  void RequestSetToolName( const ToolNameType & toolName );
+
+protected:
+
+  PlaybackTrackerTool();
+  ~PlaybackTrackerTool();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, ::itk::Indent indent ) const;
+
+private:
+
+  /** Get boolean variable to check if the tracker tool is
+   * configured or not */
+  virtual bool CheckIfTrackerToolIsConfigured() const;
+
+  PlaybackTrackerTool(const Self&);   //purposely not implemented
+  void operator=(const Self&);        //purposely not implemented
+
+  ToolNameType              m_ToolName;
+
+  bool m_TrackerToolConfigured;
+
+};
+
+} // namespace igstk
+
+
+#endif  // __igstk_PlaybackTrackerTool_h_
@@ -0,0 +1,461 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkPlaybackVideoImager.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkPlaybackVideoImager.h"
+#include "itk_zlib.h"
+
+#include <string.h>
+#include <algorithm>
+
+namespace igstk
+{
+
+namespace
+{
+/** Orders the frames of an index by time */
+bool FrameTimeLess( double time,
+                    const VideoTrackingRecorder::FrameIndexEntryType & entry )
+{
+  return time < entry.m_Time;
+}
+}
+
+PlaybackVideoImager::PlaybackVideoImager():m_StateMachine(this)
+{
+  // Reading a frame is only done when it is due, in the thread of the
+  // pulse generators.
+  this->SetThreadingEnabled( false );
+
+  m_PlaybackClock = PlaybackClock::New();
+}
+
+PlaybackVideoImager::~PlaybackVideoImager()
+{
+  this->CloseChunkFiles();
+}
+
+void PlaybackVideoImager::SetPlaybackClock( PlaybackClock * clock )
+{
+  if( clock )
+    {
+    m_PlaybackClock = clock;
+    }
+}
+
+PlaybackClock * PlaybackVideoImager::GetPlaybackClock() const
+{
+  return m_PlaybackClock;
+}
+
+void PlaybackVideoImager::CloseChunkFiles()
+{
+  for( unsigned int i = 0; i < m_PlaybackTools.size(); i++ )
+    {
+    if( m_PlaybackTools[i].m_ChunkFile )
+      {
+      fclose( m_PlaybackTools[i].m_ChunkFile );
+      m_PlaybackTools[i].m_ChunkFile = NULL;
+      }
+    m_PlaybackTools[i].m_CurrentFrame = -1;
+    }
+}
+
+bool PlaybackVideoImager::ReadFrameIndexHeader( const std::string & toolName,
+                                       FrameIndexHeaderType & header ) const
+{
+  const std::string indexFileName =
+    VideoTrackingRecorder::GetFrameIndexFileName( m_DirectoryName, toolName );
+
+  FILE * indexFile = fopen( indexFileName.c_str(), "rb" );
+  if( !indexFile )
+    {
+    return false;
+    }
+
+  const bool valid =
+    fread( &header, sizeof( header ), 1, indexFile ) == 1 &&
+    memcmp( header.m_Signature, VideoTrackingRecorder::GetFrameIndexSignature(),
+            sizeof( header.m_Signature ) ) == 0 &&
+    header.m_Version == VideoTrackingRecorder::FrameIndexVersion;
+
+  fclose( indexFile );
+  return valid;
+}
+
+bool PlaybackVideoImager::GetRecordedFrameDimensions(
+                                    const std::string & toolName,
+                                    unsigned int dimensions[3] ) const
+{
+  FrameIndexHeaderType header;
+  if( !this->ReadFrameIndexHeader( toolName, header ) )
+    {
+    return false;
+    }
+
+  dimensions[0] = header.m_FrameDimensions[0];
+  dimensions[1] = header.m_FrameDimensions[1];
+  dimensions[2] = header.m_FrameDimensions[2];
+  return true;
+}
+
+unsigned int
+PlaybackVideoImager::FindPlaybackTool( const std::string & name ) const
+{
+  unsigned int toolIndex = 0;
+  while( toolIndex < m_PlaybackTools.size() &&
+         m_PlaybackTools[toolIndex].m_Name != name )
+    {
+    toolIndex++;
+    }
+  return toolIndex;
+}
+
+PlaybackVideoImager::ResultType PlaybackVideoImager::InternalOpen( void )
+{
+  igstkLogMacro( DEBUG,
+                 "igstk::PlaybackVideoImager::InternalOpen called ...\n");
+
+  // The frame indexes are read when the tools are attached
+  const std::string trackingFileName =
+    VideoTrackingRecorder::GetTrackingFileName( m_DirectoryName );
+  FILE * trackingFile = fopen( trackingFileName.c_str(), "rb" );
+  if( !trackingFile )
+    {
+    igstkLogMacro( CRITICAL, "igstk::PlaybackVideoImager::InternalOpen: "
+                   << m_DirectoryName << " is not a recording\n" );
+    return FAILURE;
+    }
+  fclose( trackingFile );
+
+  return SUCCESS;
+}
+
+PlaybackVideoImager::ResultType PlaybackVideoImager::InternalClose( void )
+{
+  igstkLogMacro( DEBUG,
+                 "igstk::PlaybackVideoImager::InternalClose called ...\n");
+
+  this->CloseChunkFiles();
+  return SUCCESS;
+}
+
+PlaybackVideoImager::ResultType
+PlaybackVideoImager::InternalStartImaging( void )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackVideoImager::"
+                 "InternalStartImaging called ...\n");
+
+  for( unsigned int i = 0; i < m_PlaybackTools.size(); i++ )
+    {
+    m_PlaybackTools[i].m_CurrentFrame = -1;
+    }
+  return SUCCESS;
+}
+
+PlaybackVideoImager::ResultType PlaybackVideoImager::InternalStopImaging( void )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackVideoImager::"
+                 "InternalStopImaging called ...\n");
+
+  return SUCCESS;
+}
+
+PlaybackVideoImager::ResultType PlaybackVideoImager::InternalReset( void )
+{
+  igstkLogMacro( DEBUG,
+                 "igstk::PlaybackVideoImager::InternalReset called ...\n");
+
+  this->CloseChunkFiles();
+  return SUCCESS;
+}
+
+bool PlaybackVideoImager::ReadFrame( PlaybackToolType & tool,
+                                     unsigned long frame,
+                                     FrameType * destination )
+{
+  const FrameIndexEntryType & entry = tool.m_Frames[frame];
+
+  if( !tool.m_ChunkFile || tool.m_Chunk != entry.m_Chunk )
+    {
+    if( tool.m_ChunkFile )
+      {
+      fclose( tool.m_ChunkFile );
+      }
+    const std::string chunkFileName = VideoTrackingRecorder::GetChunkFileName(
+                                m_DirectoryName, tool.m_Name, entry.m_Chunk );
+    tool.m_ChunkFile = fopen( chunkFileName.c_str(), "rb" );
+    tool.m_Chunk = entry.m_Chunk;
+    if( !tool.m_ChunkFile )
+      {
+      igstkLogMacro( CRITICAL, "igstk::PlaybackVideoImager::ReadFrame: "
+                     "can not open " << chunkFileName << "\n" );
+      return false;
+      }
+    }
+
+  if( fseek( tool.m_ChunkFile, entry.m_Offset, SEEK_SET ) != 0 )
+    {
+    return false;
+    }
+
+  unsigned char * image =
+    static_cast< unsigned char * >( destination->GetImagePtr() );
+
+  if( entry.m_Encoding == VideoTrackingRecorder::RawEncoding )
+    {
+    return entry.m_DataSize == tool.m_FrameSize &&
+           fread( image, 1, entry.m_DataSize, tool.m_ChunkFile ) ==
+           entry.m_DataSize;
+    }
+
+  if( m_CompressedImage.size() < entry.m_DataSize )
+    {
+    m_CompressedImage.resize( entry.m_DataSize );
+    }
+  if( fread( &m_CompressedImage[0], 1, entry.m_DataSize, tool.m_ChunkFile ) !=
+      entry.m_DataSize )
+    {
+    return false;
+    }
+
+  uLongf imageSize = tool.m_FrameSize;
+  return uncompress( image, &imageSize,
+                     &m_CompressedImage[0], entry.m_DataSize ) == Z_OK &&
+         imageSize == tool.m_FrameSize;
+}
+
+PlaybackVideoImager::ResultType PlaybackVideoImager::InternalUpdateStatus()
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackVideoImager::"
+                 "InternalUpdateStatus called ...\n");
+
+  if( !m_PlaybackClock->GetStarted() )
+    {
+    bool found = false;
+    TimePeriodType startTime = 0.0;
+    for( unsigned int i = 0; i < m_PlaybackTools.size(); i++ )
+      {
+      const PlaybackToolType & tool = m_PlaybackTools[i];
+      if( !tool.m_Frames.empty() &&
+          ( !found || tool.m_Frames[0].m_Time < startTime ) )
+        {
+        startTime = tool.m_Frames[0].m_Time;
+        found = true;
+        }
+      }
+    if( !found )
+      {
+      return SUCCESS;
+      }
+    m_PlaybackClock->SeekToTime( startTime );
+    }
+
+  const TimePeriodType clockTime = m_PlaybackClock->GetRecordingTime();
+  const VideoImagerToolsContainerType & imagerTools =
+                                          this->GetVideoImagerToolContainer();
+
+  for( unsigned int i = 0; i < m_PlaybackTools.size(); i++ )
+    {
+    PlaybackToolType & tool = m_PlaybackTools[i];
+
+    // Last frame recorded before the time of the clock
+    const std::vector< FrameIndexEntryType >::const_iterator next =
+      std::upper_bound( tool.m_Frames.begin(), tool.m_Frames.end(),
+                        clockTime, FrameTimeLess );
+    const long frame = static_cast< long >( next - tool.m_Frames.begin() ) - 1;
+    if( frame < 0 || frame == tool.m_CurrentFrame )
+      {
+      continue;
+      }
+
+    VideoImagerToolsContainerType::const_iterator imagerTool =
+                                               imagerTools.find( tool.m_Name );
+    if( imagerTool == imagerTools.end() )
+      {
+      continue;
+      }
+
+    FrameType * destination = this->GetVideoImagerToolFrame(
+                                                         imagerTool->second );
+    if( !destination || !this->ReadFrame( tool, frame, destination ) )
+      {
+      this->ReportImagingToolNotAvailable( imagerTool->second );
+      continue;
+      }
+    tool.m_CurrentFrame = frame;
+
+    // Like the replayed transforms, the frame is valid from now on
+    destination->SetTimeToExpiration( this->GetValidityTime() );
+
+    this->ReportImagingToolStreaming( imagerTool->second );
+    this->SetVideoImagerToolFrame( imagerTool->second, destination );
+    this->SetVideoImagerToolUpdate( imagerTool->second, true );
+    }
+
+  return SUCCESS;
+}
+
+PlaybackVideoImager::ResultType
+PlaybackVideoImager::InternalThreadedUpdateStatus( void )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackVideoImager::"
+                 "InternalThreadedUpdateStatus called ...\n");
+
+  return SUCCESS;
+}
+
+PlaybackVideoImager::ResultType
+PlaybackVideoImager::VerifyVideoImagerToolInformation(
+                                   const VideoImagerToolType * imagerTool )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackVideoImager::"
+                 "VerifyVideoImagerToolInformation called ...\n");
+
+  if( !dynamic_cast< const PlaybackVideoImagerTool * >( imagerTool ) )
+    {
+    igstkLogMacro( CRITICAL, "igstk::PlaybackVideoImager::"
+                   "VerifyVideoImagerToolInformation: only "
+                   "PlaybackVideoImagerTool objects can be attached\n" );
+    return FAILURE;
+    }
+
+  const std::string name = imagerTool->GetVideoImagerToolIdentifier();
+  unsigned int recordedDimensions[3];
+  if( !this->GetRecordedFrameDimensions( name, recordedDimensions ) )
+    {
+    igstkLogMacro( CRITICAL, "igstk::PlaybackVideoImager::"
+                   "VerifyVideoImagerToolInformation: " << name
+                   << " is not in the recording\n" );
+    return FAILURE;
+    }
+
+  unsigned int dimensions[3];
+  const_cast< VideoImagerToolType * >( imagerTool )->GetFrameDimensions(
+                                                                dimensions );
+  if( dimensions[0] != recordedDimensions[0] ||
+      dimensions[1] != recordedDimensions[1] ||
+      dimensions[2] != recordedDimensions[2] )
+    {
+    igstkLogMacro( CRITICAL, "igstk::PlaybackVideoImager::"
+                   "VerifyVideoImagerToolInformation: the frame dimensions of "
+                   << name << " are not the recorded ones\n" );
+    return FAILURE;
+    }
+
+  return SUCCESS;
+}
+
+PlaybackVideoImager::ResultType
+PlaybackVideoImager::AddVideoImagerToolToInternalDataContainers(
+                                   const VideoImagerToolType * imagerTool )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackVideoImager::"
+                 "AddVideoImagerToolToInternalDataContainers called ...\n");
+
+  PlaybackToolType tool;
+  tool.m_Name = imagerTool->GetVideoImagerToolIdentifier();
+  tool.m_ChunkFile = NULL;
+  tool.m_Chunk = 0;
+  tool.m_CurrentFrame = -1;
+
+  const std::string indexFileName =
+    VideoTrackingRecorder::GetFrameIndexFileName( m_DirectoryName,
+                                                  tool.m_Name );
+  FILE * indexFile = fopen( indexFileName.c_str(), "rb" );
+  if( !indexFile )
+    {
+    return FAILURE;
+    }
+
+  // The whole index is loaded, a frame is then found without reading
+  FrameIndexHeaderType header;
+  bool valid = fread( &header, sizeof( header ), 1, indexFile ) == 1;
+  FrameIndexEntryType entry;
+  while( valid && fread( &entry, sizeof( entry ), 1, indexFile ) == 1 )
+    {
+    tool.m_Frames.push_back( entry );
+    }
+  fclose( indexFile );
+  if( !valid )
+    {
+    return FAILURE;
+    }
+
+  tool.m_FrameSize = header.m_FrameDimensions[0] *
+                     header.m_FrameDimensions[1] *
+                     header.m_FrameDimensions[2];
+
+  const unsigned int toolIndex = this->FindPlaybackTool( tool.m_Name );
+  if( toolIndex < m_PlaybackTools.size() )
+    {
+    if( m_PlaybackTools[toolIndex].m_ChunkFile )
+      {
+      fclose( m_PlaybackTools[toolIndex].m_ChunkFile );
+      }
+    m_PlaybackTools[toolIndex] = tool;
+    }
+  else
+    {
+    m_PlaybackTools.push_back( tool );
+    }
+
+  return SUCCESS;
+}
+
+PlaybackVideoImager::ResultType
+PlaybackVideoImager::RemoveVideoImagerToolFromInternalDataContainers(
+                                   const VideoImagerToolType * imagerTool )
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackVideoImager::"
+                 "RemoveVideoImagerToolFromInternalDataContainers "
+                 "called ...\n");
+
+  const unsigned int toolIndex =
+    this->FindPlaybackTool( imagerTool->GetVideoImagerToolIdentifier() );
+  if( toolIndex == m_PlaybackTools.size() )
+    {
+    return FAILURE;
+    }
+
+  if( m_PlaybackTools[toolIndex].m_ChunkFile )
+    {
+    fclose( m_PlaybackTools[toolIndex].m_ChunkFile );
+    }
+  m_PlaybackTools.erase( m_PlaybackTools.begin() + toolIndex );
+  return SUCCESS;
+}
+
+/** Print Self function */
+void PlaybackVideoImager::PrintSelf( std::ostream& os,
+                                     itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Directory name: " << m_DirectoryName << std::endl;
+  os << indent << "Number of replayed tools: " << m_PlaybackTools.size()
+     << std::endl;
+  os << indent << "Playback clock: " << m_PlaybackClock.GetPointer()
+     << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,153 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkPlaybackVideoImager.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkPlaybackVideoImager_h
+#define __igstkPlaybackVideoImager_h
+
+#include "igstkVideoImager.h"
+#include "igstkPlaybackVideoImagerTool.h"
+#include "igstkVideoTrackingRecorder.h"
+#include "igstkPlaybackClock.h"
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+
+namespace igstk
+{
+
+/** \class PlaybackVideoImager
+ *  \brief VideoImager replaying the frames of a VideoTrackingRecorder.
+ *
+ *  The recording directory is set with SetDirectoryName() before
+ *  RequestOpen(). The PlaybackVideoImagerTool objects attached to the imager
+ *  are matched by name with the recorded tools, and must have the recorded
+ *  frame dimensions.
+ *
+ *  Every update shows, for each tool, the last frame recorded before the
+ *  time of the PlaybackClock. Frames are only read and decompressed when
+ *  the clock reaches them, so seeking the clock is immediate. The clock is
+ *  started at the first frame of the recording if it has not been started.
+ *  Sharing the clock with a PlaybackTracker replays the frames and the
+ *  transforms of the recording synchronized.
+ *
+ *  The frames are read in the thread of the pulse generators, so the imager
+ *  does not use an imaging thread.
+ *
+ *  \sa VideoTrackingRecorder
+ *  \sa PlaybackTracker
+ *
+ *  \ingroup VideoImager
+ */
+class PlaybackVideoImager : public VideoImager
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( PlaybackVideoImager, VideoImager )
+
+  typedef VideoTrackingRecorder::FrameIndexHeaderType FrameIndexHeaderType;
+  typedef VideoTrackingRecorder::FrameIndexEntryType  FrameIndexEntryType;
+
+  /** Directory of the recording, set before RequestOpen() */
+  igstkSetStringMacro( DirectoryName );
+  igstkGetStringMacro( DirectoryName );
+
+  /** Clock followed by the playback. The imager creates its own clock, to
+   *  be replaced by the clock shared with the other players. */
+  void SetPlaybackClock( PlaybackClock * clock );
+  PlaybackClock * GetPlaybackClock() const;
+
+  /** Read the frame dimensions of a recorded tool. Returns false if the
+   *  tool is not in the recording. */
+  bool GetRecordedFrameDimensions( const std::string & toolName,
+                                   unsigned int dimensions[3] ) const;
+
+protected:
+
+  PlaybackVideoImager();
+  virtual ~PlaybackVideoImager();
+
+  /** Typedef for internal boolean return type. */
+  typedef VideoImager::ResultType   ResultType;
+
+  virtual ResultType InternalOpen( void );
+  virtual ResultType InternalClose( void );
+  virtual ResultType InternalStartImaging( void );
+  virtual ResultType InternalStopImaging( void );
+  virtual ResultType InternalReset( void );
+
+  /** Show the frames that are due at the time of the clock */
+  virtual ResultType InternalUpdateStatus( void );
+  virtual ResultType InternalThreadedUpdateStatus( void );
+
+  /** Verify imager tool information */
+  virtual ResultType VerifyVideoImagerToolInformation(
+                                                  const VideoImagerToolType * );
+
+  /** Remove imager tool entry from internal containers */
+  virtual ResultType RemoveVideoImagerToolFromInternalDataContainers( const
+                                     VideoImagerToolType * imagerTool );
+
+  /** Add imager tool entry to internal containers */
+  virtual ResultType AddVideoImagerToolToInternalDataContainers( const
+                                     VideoImagerToolType * imagerTool );
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  PlaybackVideoImager(const Self&);   //purposely not implemented
+  void operator=(const Self&);        //purposely not implemented
+
+  /** Replayed tool, with its frame index and its open chunk file */
+  struct PlaybackToolType
+    {
+    std::string                         m_Name;
+    VideoImagerToolType *               m_VideoImagerTool;
+    std::vector< FrameIndexEntryType >  m_Frames;
+    unsigned int                        m_FrameSize;
+    FILE *                              m_ChunkFile;
+    unsigned int                        m_Chunk;
+    long                                m_CurrentFrame;
+    };
+
+  /** Read the header of the frame index of a tool */
+  bool ReadFrameIndexHeader( const std::string & toolName,
+                             FrameIndexHeaderType & header ) const;
+
+  /** Read a frame of a tool in the image of the given frame */
+  bool ReadFrame( PlaybackToolType & tool, unsigned long frame,
+                  FrameType * destination );
+
+  /** Index of a replayed tool, or the number of replayed tools */
+  unsigned int FindPlaybackTool( const std::string & name ) const;
+
+  void CloseChunkFiles();
+
+  std::string                       m_DirectoryName;
+  PlaybackClock::Pointer            m_PlaybackClock;
+  std::vector< PlaybackToolType >   m_PlaybackTools;
+
+  /** Decompression buffer */
+  std::vector< unsigned char >      m_CompressedImage;
+};
+
+} // end namespace igstk
+
+#endif // __igstkPlaybackVideoImager_h
@@ -0,0 +1,77 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkPlaybackVideoImagerTool.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkPlaybackVideoImagerTool.h"
+
+namespace igstk
+{
+
+/** Constructor */
+PlaybackVideoImagerTool::PlaybackVideoImagerTool():m_StateMachine(this)
+{
+  m_VideoImagerToolConfigured = false;
+}
+
+/** Destructor */
+PlaybackVideoImagerTool::~PlaybackVideoImagerTool()
+{
+}
+
+/** Request set tool name */
+void
+PlaybackVideoImagerTool::RequestSetToolName( const ToolNameType & toolName )
+{
+  if( toolName.empty() )
+    {
+    igstkLogMacro( CRITICAL, "igstk::PlaybackVideoImagerTool::"
+                   "RequestSetToolName: empty tool name\n" );
+    return;
+    }
+
+  this->m_ToolName = toolName;
+  m_VideoImagerToolConfigured = true;
+
+  // The recorded identifier of the tool is its identifier in playback
+  this->SetVideoImagerToolIdentifier( m_ToolName );
+}
+
+/** The "CheckIfVideoImagerToolIsConfigured" method returns true if
+ *  the VideoImager tool is configured */
+bool
+PlaybackVideoImagerTool::CheckIfVideoImagerToolIsConfigured( ) const
+{
+  igstkLogMacro( DEBUG, "igstk::PlaybackVideoImagerTool::"
+                 "CheckIfVideoImagerToolIsConfigured called...\n");
+  return m_VideoImagerToolConfigured;
+}
+
+/** Print Self function */
+void PlaybackVideoImagerTool::PrintSelf( std::ostream& os,
+                                     itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Tool name: " << m_ToolName << std::endl;
+}
+
+} //igstk namespace
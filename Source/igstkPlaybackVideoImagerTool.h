@@ -0,0 +1,82 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkPlaybackVideoImagerTool.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkPlaybackVideoImagerTool_h
+#define __igstkPlaybackVideoImagerTool_h
+
+#include "igstkVideoImagerTool.h"
+
+namespace igstk
+{
+
+class PlaybackVideoImager;
+
+/** \class PlaybackVideoImagerTool
+  * \brief A PlaybackVideoImager-specific VideoImagerTool class.
+  *
+  * A PlaybackVideoImagerTool replays the frames of a recorded tool. The tool
+  * name must be the identifier that the tool had when it was recorded, and
+  * its frame dimensions must be the recorded ones.
+  *
+  * \sa PlaybackVideoImager
+  *
+  * \ingroup VideoImager
+  *
+  */
+
+class PlaybackVideoImagerTool : public VideoImagerTool
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( PlaybackVideoImagerTool, VideoImagerTool )
+
+  typedef std::string       ToolNameType;
+
+  /** Get the name of the tool */
+  igstkGetStringMacro( ToolName );
+
+  /** Set the name of the recorded tool */
+  void RequestSetToolName( const ToolNameType & toolName );
+
+protected:
+
+  PlaybackVideoImagerTool();
+  ~PlaybackVideoImagerTool();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, ::itk::Indent indent ) const;
+
+private:
+
+  /** Get boolean variable to check if the VideoImager tool is
+   * configured or not */
+  virtual bool CheckIfVideoImagerToolIsConfigured() const;
+
+  PlaybackVideoImagerTool(const Self&);   //purposely not implemented
+  void operator=(const Self&);            //purposely not implemented
+
+  ToolNameType              m_ToolName;
+
+  bool m_VideoImagerToolConfigured;
+
+};
+
+} // namespace igstk
+
+
+#endif  // __igstk_PlaybackVideoImagerTool_h_
@@ -124,27 +124,30 @@ private:
   /** The command interpreter */
   CommandInterpreterType::Pointer  m_CommandInterpreter;
 
-  /** Port handle container indexed by the tracker tool unique
-   * identifier */
-  typedef std::string                           PortIdentifierType;
-  typedef std::map< PortIdentifierType, int >   PortHandleContainerType;
-  PortHandleContainerType                       m_PortHandleContainer;
+  /** Port handles, indexed by the slot of the tracker tools. The port
+   * handle of a free slot is zero. */
+  typedef std::vector< int >       PortHandleContainerType;
+  PortHandleContainerType          m_PortHandleContainer;
 
   /** Container holding absent status of tools */
-  typedef std::map< std::string, int >   ToolAbsentStatusContainerType;
-  ToolAbsentStatusContainerType          m_ToolAbsentStatusContainer;
+  typedef std::vector< int >       ToolAbsentStatusContainerType;
+  ToolAbsentStatusContainerType    m_ToolAbsentStatusContainer;
 
   /** Container holding status of the tools */
-  typedef std::map< std::string, int >   ToolStatusContainerType;
+  typedef std::vector< int >       ToolStatusContainerType;
   ToolStatusContainerType          m_ToolStatusContainer;
 
-  /** A buffer to hold tool transforms */
-  typedef std::vector < double >   InternalTransformType;
-  typedef std::map< std::string , InternalTransformType >
-                                TrackerToolTransformContainerType;
-
+  /** A buffer to hold tool transforms. The NDI transform of a slot is
+   * stored in the eight values starting at 8 * slot. */
+  typedef std::vector< double >    TrackerToolTransformContainerType;
   TrackerToolTransformContainerType     m_ToolTransformBuffer;
 
+  /** Number of values of an NDI transform */
+  itkStaticConstMacro( TransformSize, unsigned int, 8 );
+
+  /** Resize the per slot containers to hold the given slot */
+  void ResizeInternalDataContainers( TrackerToolSlotType numberOfSlots );
+
   /** Port handle of tracker tool to be added */
   int m_PortHandleToBeAdded;
 };
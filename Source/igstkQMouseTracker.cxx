@@ -96,19 +96,18 @@ QMouseTracker::ResultType QMouseTracker::InternalUpdateStatus( void )
 {
   igstkLogMacro( DEBUG, "QMouseTracker::InternalUpdateStatus called ...\n");
 
-  typedef TrackerToolsContainerType::const_iterator  ConstIteratorType;
-
-  TrackerToolsContainerType trackerToolContainer =
-    this->GetTrackerToolContainer();
-
-  ConstIteratorType inputItr = trackerToolContainer.begin();
-  ConstIteratorType inputEnd = trackerToolContainer.end();
+  const TrackerToolSlotType numberOfSlots = this->GetNumberOfTrackerToolSlots();
 
   typedef igstk::Transform   TransformType;
   TransformType transform;
 
-  while( inputItr != inputEnd )
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
+    if( !this->GetTrackerToolInSlot( slot ) )
+      {
+      continue;
+      }
+
     transform.SetToIdentity( this->GetValidityTime() );
 
     QPoint mousePosition = QCursor::pos();
@@ -125,13 +124,9 @@ QMouseTracker::ResultType QMouseTracker::InternalUpdateStatus( void )
     transform.SetTranslation( position, errorValue, this->GetValidityTime() );
 
     // set the raw transform
-    this->SetTrackerToolRawTransform(
-      trackerToolContainer[inputItr->first], transform );
-
-    this->SetTrackerToolTransformUpdate(
-       trackerToolContainer[inputItr->first], true );
+    this->SetTrackerToolRawTransform( slot, transform );
 
-    ++inputItr;
+    this->SetTrackerToolTransformUpdate( slot, true );
     }
 
   return SUCCESS;
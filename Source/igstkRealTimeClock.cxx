@@ -22,6 +22,7 @@
 #include <windows.h>
 #else
 #include <sys/time.h>
+#include <time.h>
 #endif  // defined(WIN32) || defined(_WIN32)
 
 namespace igstk
@@ -129,6 +130,50 @@ RealTimeClock::GetTimeStamp()
 #endif  // defined(WIN32) || defined(_WIN32)
 }
 
+/** Returns the processor time of the calling thread */
+RealTimeClock::TimeStampType
+RealTimeClock::GetThreadCPUTime()
+{
+#if defined(WIN32) || defined(_WIN32)
+
+  FILETIME creation;
+  FILETIME exit;
+  FILETIME kernel;
+  FILETIME user;
+  if( !::GetThreadTimes( ::GetCurrentThread(), &creation, &exit,
+                         &kernel, &user ) )
+    {
+    return 0.0;
+    }
+
+  // in units of 100 nanoseconds
+  const TimeStampType value =
+    ( static_cast< TimeStampType >( kernel.dwHighDateTime ) +
+      static_cast< TimeStampType >( user.dwHighDateTime ) ) * 4294967296.0 +
+    static_cast< TimeStampType >( kernel.dwLowDateTime ) +
+    static_cast< TimeStampType >( user.dwLowDateTime );
+
+  return value / 10000.0; // in milliseconds
+
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+
+  struct timespec tspec;
+
+  if( ::clock_gettime( CLOCK_THREAD_CPUTIME_ID, &tspec ) != 0 )
+    {
+    return 0.0;
+    }
+
+  return static_cast< TimeStampType >( tspec.tv_sec ) * 1000.0 +
+         static_cast< TimeStampType >( tspec.tv_nsec ) / 1e6;
+
+#else
+
+  return 0.0;
+
+#endif  // defined(WIN32) || defined(_WIN32)
+}
+
 /** Print the object */
 void RealTimeClock::Print(std::ostream& os, itk::Indent indent)
 {
@@ -44,6 +44,10 @@ public:
   /** Returns a timestamp in milliseconds   e.g. 52.341243 milliseconds */
   static TimeStampType  GetTimeStamp();
 
+  /** Returns the processor time used by the calling thread, in
+   *  milliseconds, or 0 where it is not available */
+  static TimeStampType  GetThreadCPUTime();
+
   /** Initialize internal variables on the Clock service.
    *  This method must be called at the begining of every
    *  IGSTK application. */
@@ -0,0 +1,350 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkRigidTransform.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#include "igstkRigidTransform.h"
+#include "igstkRealTimeClock.h"
+
+#include "itkNumericTraits.h"
+
+#include <math.h>
+
+namespace igstk
+{
+
+void
+RigidTransform
+::SetToIdentity( TimePeriodType millisecondsToExpiration )
+{
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    m_Rotation[i] = 0.0;
+    m_Translation[i] = 0.0;
+    }
+  m_Rotation[3] = 1.0;
+  m_Error = itk::NumericTraits< ErrorType >::min();
+  m_StartTime = RealTimeClock::GetTimeStamp();
+  m_ExpirationTime = m_StartTime + millisecondsToExpiration;
+}
+
+
+void
+RigidTransform
+::ImportTransform( const Transform & transform )
+{
+  const Transform::VersorType & rotation = transform.GetRotation();
+  const Transform::VectorType & translation = transform.GetTranslation();
+
+  m_Rotation[0] = rotation.GetX();
+  m_Rotation[1] = rotation.GetY();
+  m_Rotation[2] = rotation.GetZ();
+  m_Rotation[3] = rotation.GetW();
+
+  m_Translation[0] = translation[0];
+  m_Translation[1] = translation[1];
+  m_Translation[2] = translation[2];
+  m_Translation[3] = 0.0;
+
+  m_Error = transform.GetError();
+  m_StartTime = transform.GetStartTime();
+  m_ExpirationTime = transform.GetExpirationTime();
+}
+
+
+void
+RigidTransform
+::ExportTransform( Transform & transform ) const
+{
+  Transform::VersorType rotation;
+  rotation.Set( m_Rotation[0], m_Rotation[1], m_Rotation[2], m_Rotation[3] );
+
+  Transform::VectorType translation;
+  translation[0] = m_Translation[0];
+  translation[1] = m_Translation[1];
+  translation[2] = m_Translation[2];
+
+  transform.SetTranslationAndRotation( translation, rotation, m_Error,
+                                       m_StartTime, m_ExpirationTime );
+}
+
+
+void
+RigidTransform
+::Compose( const RigidTransform & left,
+           const RigidTransform & right,
+           RigidTransform & result )
+{
+  const ValueType * a = left.m_Rotation;
+  const ValueType * b = right.m_Rotation;
+
+  // Hamilton product, as itk::Versor::operator*()
+  ValueType rotation[4];
+  rotation[0] = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+  rotation[1] = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+  rotation[2] = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+  rotation[3] = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+
+  // Rotate the right translation and add the left one
+  ValueType translation[4];
+  left.TransformPoint( right.m_Translation, translation );
+  translation[3] = 0.0;
+
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    result.m_Rotation[i] = rotation[i];
+    result.m_Translation[i] = translation[i];
+    }
+
+  result.m_Error = left.m_Error + right.m_Error;
+
+  // Overlap of the validity periods
+  result.m_StartTime = ( left.m_StartTime > right.m_StartTime ) ?
+                         left.m_StartTime : right.m_StartTime;
+  result.m_ExpirationTime =
+                  ( left.m_ExpirationTime < right.m_ExpirationTime ) ?
+                    left.m_ExpirationTime : right.m_ExpirationTime;
+}
+
+
+void
+RigidTransform
+::Invert( const RigidTransform & input, RigidTransform & result )
+{
+  RigidTransform conjugate = input;
+  conjugate.m_Rotation[0] = -input.m_Rotation[0];
+  conjugate.m_Rotation[1] = -input.m_Rotation[1];
+  conjugate.m_Rotation[2] = -input.m_Rotation[2];
+
+  const ValueType negatedTranslation[3] = { -input.m_Translation[0],
+                                            -input.m_Translation[1],
+                                            -input.m_Translation[2] };
+  conjugate.m_Translation[0] = 0.0;
+  conjugate.m_Translation[1] = 0.0;
+  conjugate.m_Translation[2] = 0.0;
+
+  ValueType translation[3];
+  conjugate.TransformPoint( negatedTranslation, translation );
+
+  result = conjugate;
+  result.m_Translation[0] = translation[0];
+  result.m_Translation[1] = translation[1];
+  result.m_Translation[2] = translation[2];
+  result.m_Translation[3] = 0.0;
+}
+
+
+void
+RigidTransform
+::ComputeMatrix( ValueType matrix[12] ) const
+{
+  const ValueType x = m_Rotation[0];
+  const ValueType y = m_Rotation[1];
+  const ValueType z = m_Rotation[2];
+  const ValueType w = m_Rotation[3];
+
+  const ValueType xx = x * x;
+  const ValueType yy = y * y;
+  const ValueType zz = z * z;
+  const ValueType xy = x * y;
+  const ValueType xz = x * z;
+  const ValueType xw = x * w;
+  const ValueType yz = y * z;
+  const ValueType yw = y * w;
+  const ValueType zw = z * w;
+
+  matrix[0]  = 1.0 - 2.0 * ( yy + zz );
+  matrix[1]  = 2.0 * ( xy - zw );
+  matrix[2]  = 2.0 * ( xz + yw );
+  matrix[3]  = m_Translation[0];
+
+  matrix[4]  = 2.0 * ( xy + zw );
+  matrix[5]  = 1.0 - 2.0 * ( xx + zz );
+  matrix[6]  = 2.0 * ( yz - xw );
+  matrix[7]  = m_Translation[1];
+
+  matrix[8]  = 2.0 * ( xz - yw );
+  matrix[9]  = 2.0 * ( yz + xw );
+  matrix[10] = 1.0 - 2.0 * ( xx + yy );
+  matrix[11] = m_Translation[2];
+}
+
+
+void
+RigidTransform
+::InterpolateRotation( const ValueType first[4],
+                       const ValueType second[4],
+                       double weight,
+                       ValueType result[4] )
+{
+  ValueType q1[4] = { second[0], second[1], second[2], second[3] };
+
+  ValueType cosine = first[0] * q1[0] + first[1] * q1[1] +
+                     first[2] * q1[2] + first[3] * q1[3];
+
+  // q and -q are the same rotation, take the shortest path
+  if( cosine < 0.0 )
+    {
+    cosine = -cosine;
+    for( unsigned int i = 0; i < 4; i++ )
+      {
+      q1[i] = -q1[i];
+      }
+    }
+
+  double weight0 = 1.0 - weight;
+  double weight1 = weight;
+
+  // Linear interpolation is accurate enough, and stable, for close rotations
+  if( cosine < 0.9995 )
+    {
+    const double angle = acos( cosine );
+    const double sine = sin( angle );
+    weight0 = sin( weight0 * angle ) / sine;
+    weight1 = sin( weight1 * angle ) / sine;
+    }
+
+  ValueType rotation[4];
+  ValueType norm = 0.0;
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    rotation[i] = weight0 * first[i] + weight1 * q1[i];
+    norm += rotation[i] * rotation[i];
+    }
+  norm = sqrt( norm );
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    result[i] = rotation[i] / norm;
+    }
+}
+
+
+void
+RigidTransform
+::Interpolate( const RigidTransform & first,
+               const RigidTransform & second,
+               double weight,
+               RigidTransform & result )
+{
+  InterpolateRotation( first.m_Rotation, second.m_Rotation, weight,
+                       result.m_Rotation );
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    result.m_Translation[i] = ( 1.0 - weight ) * first.m_Translation[i] +
+                              weight * second.m_Translation[i];
+    }
+  result.m_Translation[3] = 0.0;
+
+  result.m_Error = ( 1.0 - weight ) * first.m_Error + weight * second.m_Error;
+}
+
+
+void
+RigidTransform
+::GetMatrix( ValueType matrix[16] ) const
+{
+  this->ComputeMatrix( matrix );
+  matrix[12] = 0.0;
+  matrix[13] = 0.0;
+  matrix[14] = 0.0;
+  matrix[15] = 1.0;
+}
+
+
+void
+RigidTransform
+::TransformPoint( const ValueType input[3], ValueType output[3] ) const
+{
+  ValueType matrix[12];
+  this->ComputeMatrix( matrix );
+
+  const ValueType x = input[0];
+  const ValueType y = input[1];
+  const ValueType z = input[2];
+  output[0] = matrix[0] * x + matrix[1] * y + matrix[2]  * z + matrix[3];
+  output[1] = matrix[4] * x + matrix[5] * y + matrix[6]  * z + matrix[7];
+  output[2] = matrix[8] * x + matrix[9] * y + matrix[10] * z + matrix[11];
+}
+
+
+template < class TValue >
+void
+RigidTransform
+::TransformPointsTemplate( const TValue * input, TValue * output,
+                           unsigned long numberOfPoints ) const
+{
+  ValueType matrix[12];
+  this->ComputeMatrix( matrix );
+
+  // The loop body has no branch nor aliasing between the matrix and the
+  // points, which lets the compiler vectorize it.
+  for( unsigned long i = 0; i < numberOfPoints; i++ )
+    {
+    const ValueType x = input[0];
+    const ValueType y = input[1];
+    const ValueType z = input[2];
+    output[0] = static_cast< TValue >(
+                  matrix[0] * x + matrix[1] * y + matrix[2]  * z + matrix[3] );
+    output[1] = static_cast< TValue >(
+                  matrix[4] * x + matrix[5] * y + matrix[6]  * z + matrix[7] );
+    output[2] = static_cast< TValue >(
+                  matrix[8] * x + matrix[9] * y + matrix[10] * z + matrix[11] );
+    input += 3;
+    output += 3;
+    }
+}
+
+
+void
+RigidTransform
+::TransformPoints( const double * input, double * output,
+                   unsigned long numberOfPoints ) const
+{
+  this->TransformPointsTemplate( input, output, numberOfPoints );
+}
+
+
+void
+RigidTransform
+::TransformPoints( const float * input, float * output,
+                   unsigned long numberOfPoints ) const
+{
+  this->TransformPointsTemplate( input, output, numberOfPoints );
+}
+
+
+bool
+RigidTransform
+::IsValidAtTime( TimePeriodType timeToTestInMilliseconds ) const
+{
+  return ( timeToTestInMilliseconds >= m_StartTime &&
+           timeToTestInMilliseconds <= m_ExpirationTime );
+}
+
+
+std::ostream& operator<<( std::ostream& os, const RigidTransform& o )
+{
+  os << "Rotation: (" << o.m_Rotation[0] << ", " << o.m_Rotation[1] << ", "
+     << o.m_Rotation[2] << ", " << o.m_Rotation[3] << ")" << std::endl;
+  os << "Translation: (" << o.m_Translation[0] << ", "
+     << o.m_Translation[1] << ", " << o.m_Translation[2] << ")" << std::endl;
+  os << "Error: " << o.m_Error << std::endl;
+  os << "Validity: [" << o.m_StartTime << ", " << o.m_ExpirationTime << "]"
+     << std::endl;
+  return os;
+}
+
+}
@@ -0,0 +1,143 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkRigidTransform.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __igstkRigidTransform_h
+#define __igstkRigidTransform_h
+
+#include "igstkTransform.h"
+
+/** Alignment of the arrays of RigidTransform, so that the four components of
+ * the rotation and of the translation can be loaded in vector registers. */
+#if defined(_MSC_VER)
+#define igstkRigidTransformAlignMacro __declspec(align(16))
+#elif defined(__GNUC__)
+#define igstkRigidTransformAlignMacro __attribute__((aligned(16)))
+#else
+#define igstkRigidTransformAlignMacro
+#endif
+
+namespace igstk
+{
+
+/** \class RigidTransform
+ *  \brief Compact representation of a 3D rigid transform.
+ *
+ * RigidTransform holds the same information as igstk::Transform: a unit
+ * quaternion, a translation, an error value and a validity period. It is a
+ * plain data structure without virtual methods nor constructors, so that it
+ * can be stored in arrays, copied with memcpy and composed without going
+ * through itk::Versor and itk::Vector.
+ *
+ * It is intended for the code that composes transforms at the tracking rate,
+ * such as the Tracker -> TrackerTool -> calibration -> reference chain of a
+ * CoordinateSystem graph. The composition, inversion and validity rules are
+ * the ones of igstk::Transform: errors add up and the validity period of a
+ * composition is the overlap of the validity periods.
+ *
+ * The conversion from and to igstk::Transform copies the translation, the
+ * error and the time stamp exactly. The rotation is copied component by
+ * component, through itk::Versor::Set() when exporting.
+ *
+ * \sa Transform
+ *
+ * */
+class RigidTransform
+{
+public:
+
+  typedef double                      ValueType;
+  typedef TransformBase::ErrorType    ErrorType;
+  typedef TimeStamp::TimePeriodType   TimePeriodType;
+
+  /** Set the transform to an identity that is valid from now on for the
+   * given period, as Transform::SetToIdentity() does. */
+  void SetToIdentity( TimePeriodType millisecondsToExpiration );
+
+  /** Copy the content of an igstk::Transform */
+  void ImportTransform( const Transform & transform );
+
+  /** Copy the content to an igstk::Transform */
+  void ExportTransform( Transform & transform ) const;
+
+  /** Compute left * right, i.e. the transform that applies right first and
+   * then left. The result may be one of the operands. */
+  static void Compose( const RigidTransform & left,
+                       const RigidTransform & right,
+                       RigidTransform & result );
+
+  /** Compute the inverse transform. The result may be the input. */
+  static void Invert( const RigidTransform & input,
+                      RigidTransform & result );
+
+  /** Spherical linear interpolation between two unit quaternions, along the
+   * shortest path. A weight of 0 gives the first rotation and a weight of 1
+   * the second one. The result may be one of the operands. */
+  static void InterpolateRotation( const ValueType first[4],
+                                   const ValueType second[4],
+                                   double weight,
+                                   ValueType result[4] );
+
+  /** Interpolate between two transforms: spherical linear for the rotation,
+   * linear for the translation and the error. The validity period of the
+   * result is not modified. The result may be one of the operands. */
+  static void Interpolate( const RigidTransform & first,
+                           const RigidTransform & second,
+                           double weight,
+                           RigidTransform & result );
+
+  /** Export the transform as a row major 4x4 matrix, in the layout expected
+   * by vtkMatrix4x4::DeepCopy(). */
+  void GetMatrix( ValueType matrix[16] ) const;
+
+  /** Transform a single point */
+  void TransformPoint( const ValueType input[3], ValueType output[3] ) const;
+
+  /** Transform an array of points stored as consecutive x, y, z triplets.
+   * The rotation matrix is computed once for the whole array. The output
+   * array may be the input array. */
+  void TransformPoints( const double * input, double * output,
+                        unsigned long numberOfPoints ) const;
+  void TransformPoints( const float * input, float * output,
+                        unsigned long numberOfPoints ) const;
+
+  /** Validity of the transform at the given time, in milliseconds */
+  bool IsValidAtTime( TimePeriodType timeToTestInMilliseconds ) const;
+
+  /** Rotation as a unit quaternion in the order x, y, z, w */
+  igstkRigidTransformAlignMacro ValueType  m_Rotation[4];
+
+  /** Translation. The fourth component is kept to zero. */
+  igstkRigidTransformAlignMacro ValueType  m_Translation[4];
+
+  ErrorType                                m_Error;
+  TimePeriodType                           m_StartTime;
+  TimePeriodType                           m_ExpirationTime;
+
+private:
+
+  /** Row major 3x4 matrix of the transform */
+  void ComputeMatrix( ValueType matrix[12] ) const;
+
+  template < class TValue >
+  void TransformPointsTemplate( const TValue * input, TValue * output,
+                                unsigned long numberOfPoints ) const;
+};
+
+std::ostream& operator<<( std::ostream& os, const igstk::RigidTransform& o );
+
+}
+
+#endif
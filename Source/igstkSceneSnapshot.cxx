@@ -0,0 +1,121 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkSceneSnapshot.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkSceneSnapshot.h"
+#include "igstkTimeStamp.h"
+
+namespace igstk
+{
+
+SceneSnapshot::SceneSnapshot()
+{
+  m_Version = 0;
+  m_TimeStamp = 0.0;
+}
+
+SceneSnapshot::~SceneSnapshot()
+{
+}
+
+unsigned long SceneSnapshot::GetVersion() const
+{
+  return m_Version;
+}
+
+double SceneSnapshot::GetTimeStamp() const
+{
+  return m_TimeStamp;
+}
+
+const SceneSnapshot::NodeContainerType & SceneSnapshot::GetNodes() const
+{
+  return m_Nodes;
+}
+
+const SceneSnapshot::RepresentationContainerType &
+SceneSnapshot::GetRepresentations() const
+{
+  return m_Representations;
+}
+
+/** Walk the source up to the root, keeping the transform to each of its
+ *  ancestors, then walk the destination up to the first of them: it is
+ *  the lowest common ancestor. The cycles are prevented by the coordinate
+ *  systems when their parents are set. */
+bool SceneSnapshot::ComputeTransform( const CoordinateSystem * source,
+                                      const CoordinateSystem * destination,
+                                      RigidTransform & transform ) const
+{
+  if( source == NULL || destination == NULL )
+    {
+    return false;
+    }
+
+  typedef std::pair< const CoordinateSystem *, RigidTransform >  StepType;
+  std::vector< StepType > sourcePath;
+
+  RigidTransform toNode;
+  toNode.SetToIdentity( TimeStamp::GetLongestPossibleTime() );
+  const CoordinateSystem * node = source;
+  while( node != NULL )
+    {
+    sourcePath.push_back( StepType( node, toNode ) );
+    NodeContainerType::const_iterator it = m_Nodes.find( node );
+    if( it == m_Nodes.end() )
+      {
+      break;
+      }
+    RigidTransform::Compose( it->second.TransformToParent, toNode, toNode );
+    node = it->second.Parent;
+    }
+
+  RigidTransform destinationToNode;
+  destinationToNode.SetToIdentity( TimeStamp::GetLongestPossibleTime() );
+  node = destination;
+  while( node != NULL )
+    {
+    for( unsigned int i = 0; i < sourcePath.size(); i++ )
+      {
+      if( sourcePath[i].first == node )
+        {
+        RigidTransform nodeToDestination;
+        RigidTransform::Invert( destinationToNode, nodeToDestination );
+        RigidTransform::Compose( nodeToDestination, sourcePath[i].second,
+                                 transform );
+        return true;
+        }
+      }
+    NodeContainerType::const_iterator it = m_Nodes.find( node );
+    if( it == m_Nodes.end() )
+      {
+      break;
+      }
+    RigidTransform::Compose( it->second.TransformToParent, destinationToNode,
+                             destinationToNode );
+    node = it->second.Parent;
+    }
+
+  return false;
+}
+
+} // end namespace igstk
@@ -0,0 +1,121 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkSceneSnapshot.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkSceneSnapshot_h
+#define __igstkSceneSnapshot_h
+
+#include <map>
+#include <vector>
+
+#include "itkLightObject.h"
+
+#include "igstkRigidTransform.h"
+
+namespace igstk
+{
+
+class CoordinateSystem;
+class ObjectRepresentation;
+
+/** \class SceneSnapshot
+ *
+ * \brief Immutable copy of the state of a scene at a given time.
+ *
+ * A snapshot holds the parent and the transform to the parent of the
+ * coordinate systems of a scene, and the colour, opacity and visibility
+ * of its representations, each one with the coordinate systems of its
+ * spatial object and of its view. It is created by a
+ * SceneSnapshotPublisher and never modified afterwards, so that any
+ * thread holding a pointer to it can read it without locking, while the
+ * main thread keeps updating the scene and publishing newer snapshots.
+ *
+ * The coordinate systems and the representations are only used as keys:
+ * they must not be dereferenced by the readers, since the objects may be
+ * destroyed while the snapshot exists.
+ *
+ * \sa SceneSnapshotPublisher
+ */
+class SceneSnapshot : public ::itk::LightObject
+{
+public:
+
+  typedef SceneSnapshot                     Self;
+  typedef ::itk::LightObject                Superclass;
+  typedef ::itk::SmartPointer< Self >       Pointer;
+  typedef ::itk::SmartPointer< const Self > ConstPointer;
+  itkNewMacro( Self );
+
+  /** A coordinate system, with the transform to its parent */
+  struct NodeType
+    {
+    const CoordinateSystem *    Parent;
+    RigidTransform              TransformToParent;
+    };
+
+  typedef std::map< const CoordinateSystem *, NodeType >  NodeContainerType;
+
+  /** A representation, as shown in a view */
+  struct RepresentationType
+    {
+    const ObjectRepresentation *    Representation;
+    const CoordinateSystem *        Object;
+    const CoordinateSystem *        View;
+    double                          Color[3];
+    double                          Opacity;
+    bool                            Visible;
+    };
+
+  typedef std::vector< RepresentationType >   RepresentationContainerType;
+
+  /** Version of the snapshot, incremented at each publication */
+  unsigned long GetVersion() const;
+
+  /** Time at which the snapshot was published, in milliseconds */
+  double GetTimeStamp() const;
+
+  const NodeContainerType & GetNodes() const;
+  const RepresentationContainerType & GetRepresentations() const;
+
+  /** Compute the transform from a coordinate system to another one, as
+   *  CoordinateSystem::RequestComputeTransformTo() does on the live
+   *  scene. Returns false if they are not connected in the snapshot. */
+  bool ComputeTransform( const CoordinateSystem * source,
+                         const CoordinateSystem * destination,
+                         RigidTransform & transform ) const;
+
+protected:
+
+  SceneSnapshot();
+  ~SceneSnapshot();
+
+private:
+
+  SceneSnapshot(const Self&);     //purposely not implemented
+  void operator=(const Self&);    //purposely not implemented
+
+  /** Only the publisher fills the snapshots */
+  friend class SceneSnapshotPublisher;
+
+  unsigned long                   m_Version;
+  double                          m_TimeStamp;
+  NodeContainerType               m_Nodes;
+  RepresentationContainerType     m_Representations;
+};
+
+} // end namespace igstk
+
+#endif // __igstkSceneSnapshot_h
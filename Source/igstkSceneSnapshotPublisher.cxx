@@ -0,0 +1,206 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkSceneSnapshotPublisher.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkSceneSnapshotPublisher.h"
+#include "igstkRealTimeClock.h"
+
+namespace igstk
+{
+
+namespace
+{
+
+bool SameRepresentations(
+  const SceneSnapshot::RepresentationContainerType & a,
+  const SceneSnapshot::RepresentationContainerType & b )
+{
+  if( a.size() != b.size() )
+    {
+    return false;
+    }
+  for( unsigned int i = 0; i < a.size(); i++ )
+    {
+    if( a[i].Representation != b[i].Representation ||
+        a[i].Object != b[i].Object ||
+        a[i].View != b[i].View ||
+        a[i].Color[0] != b[i].Color[0] ||
+        a[i].Color[1] != b[i].Color[1] ||
+        a[i].Color[2] != b[i].Color[2] ||
+        a[i].Opacity != b[i].Opacity ||
+        a[i].Visible != b[i].Visible )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+SceneSnapshotPublisher::SceneSnapshotPublisher():m_StateMachine(this)
+{
+  m_NumberOfPublishedSnapshots = 0;
+  m_SceneModified = false;
+  m_Snapshot = SceneSnapshot::New();
+}
+
+SceneSnapshotPublisher::~SceneSnapshotPublisher()
+{
+  FollowedContainerType::iterator it;
+  for( it = m_Followed.begin(); it != m_Followed.end(); ++it )
+    {
+    it->second.CoordinateSystemPointer->GetSetTransformChannel().
+      RemoveObserver( it->second.Tag );
+    }
+}
+
+void SceneSnapshotPublisher::RequestSetRepresentations(
+                          const RepresentationContainerType & representations )
+{
+  if( SameRepresentations( representations, m_Representations ) )
+    {
+    return;
+    }
+  m_Representations = representations;
+  this->Publish();
+}
+
+void SceneSnapshotPublisher::RequestPublish()
+{
+  if( m_SceneModified )
+    {
+    this->Publish();
+    }
+}
+
+SceneSnapshot::ConstPointer SceneSnapshotPublisher::GetSnapshot() const
+{
+  m_SnapshotLock.Lock();
+  SceneSnapshot::ConstPointer snapshot = m_Snapshot;
+  m_SnapshotLock.Unlock();
+  return snapshot;
+}
+
+unsigned long SceneSnapshotPublisher::GetNumberOfPublishedSnapshots() const
+{
+  return m_NumberOfPublishedSnapshots;
+}
+
+unsigned int SceneSnapshotPublisher::GetNumberOfCoordinateSystems() const
+{
+  return static_cast< unsigned int >( m_Followed.size() );
+}
+
+void SceneSnapshotPublisher::AddNodes(
+                              const CoordinateSystem * coordinateSystem,
+                              SceneSnapshot::NodeContainerType & nodes ) const
+{
+  const CoordinateSystem * node = coordinateSystem;
+  while( node != NULL && nodes.find( node ) == nodes.end() )
+    {
+    SceneSnapshot::NodeType copy;
+    copy.Parent = node->m_Parent.GetPointer();
+    copy.TransformToParent = node->m_RigidTransformToParent;
+    nodes[node] = copy;
+    node = copy.Parent;
+    }
+}
+
+void SceneSnapshotPublisher::Publish()
+{
+  SceneSnapshot::Pointer snapshot = SceneSnapshot::New();
+  snapshot->m_Version = m_NumberOfPublishedSnapshots + 1;
+  snapshot->m_TimeStamp = RealTimeClock::GetTimeStamp();
+  snapshot->m_Representations = m_Representations;
+
+  RepresentationContainerType::const_iterator representationIt;
+  for( representationIt = m_Representations.begin();
+       representationIt != m_Representations.end(); ++representationIt )
+    {
+    this->AddNodes( representationIt->Object, snapshot->m_Nodes );
+    this->AddNodes( representationIt->View, snapshot->m_Nodes );
+    }
+
+  // follow the new coordinate systems, and release the ones that left
+  // the scene
+  SceneSnapshot::NodeContainerType::const_iterator nodeIt;
+  for( nodeIt = snapshot->m_Nodes.begin();
+       nodeIt != snapshot->m_Nodes.end(); ++nodeIt )
+    {
+    if( m_Followed.find( nodeIt->first ) == m_Followed.end() )
+      {
+      FollowedType followed;
+      followed.CoordinateSystemPointer = nodeIt->first;
+      followed.Tag = nodeIt->first->GetSetTransformChannel().
+        AddMemberObserver< Self, &Self::SetTransformCallback >( this );
+      m_Followed[nodeIt->first] = followed;
+      }
+    }
+  FollowedContainerType::iterator followedIt = m_Followed.begin();
+  while( followedIt != m_Followed.end() )
+    {
+    if( snapshot->m_Nodes.find( followedIt->first ) ==
+        snapshot->m_Nodes.end() )
+      {
+      followedIt->second.CoordinateSystemPointer->GetSetTransformChannel().
+        RemoveObserver( followedIt->second.Tag );
+      m_Followed.erase( followedIt++ );
+      }
+    else
+      {
+      ++followedIt;
+      }
+    }
+
+  m_SnapshotLock.Lock();
+  m_Snapshot = snapshot.GetPointer();
+  m_SnapshotLock.Unlock();
+
+  m_NumberOfPublishedSnapshots++;
+  m_SceneModified = false;
+
+  this->InvokeEvent( SceneSnapshotEvent() );
+}
+
+void SceneSnapshotPublisher::SetTransformCallback(
+               const CoordinateSystemSetTransformResult & itkNotUsed(payload) )
+{
+  // published at the next pulse
+  m_SceneModified = true;
+}
+
+void SceneSnapshotPublisher::PrintSelf( std::ostream& os,
+                                        itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfRepresentations: " << m_Representations.size()
+     << std::endl;
+  os << indent << "NumberOfCoordinateSystems: "
+     << this->GetNumberOfCoordinateSystems() << std::endl;
+  os << indent << "NumberOfPublishedSnapshots: "
+     << m_NumberOfPublishedSnapshots << std::endl;
+  os << indent << "SceneModified: " << m_SceneModified << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,142 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkSceneSnapshotPublisher.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkSceneSnapshotPublisher_h
+#define __igstkSceneSnapshotPublisher_h
+
+#include "igstkObject.h"
+#include "igstkEvents.h"
+#include "igstkSceneSnapshot.h"
+#include "igstkCoordinateSystem.h"
+#include "igstkCoordinateSystemSetTransformResult.h"
+
+#include "itkMutexLock.h"
+
+#include <map>
+
+namespace igstk
+{
+
+/** Event invoked, in the main thread, after a snapshot was published */
+igstkEventMacro( SceneSnapshotEvent,        IGSTKEvent );
+
+/** \class SceneSnapshotPublisher
+ *
+ * \brief Publishes the state of a scene as immutable snapshots.
+ *
+ * The publisher is given the representations of a scene, with the
+ * coordinate systems of their spatial objects and views. It follows
+ * these coordinate systems and all their ancestors, and notes when one of
+ * them is set, updated by a tracker, or detached. RequestPublish(),
+ * called once per pulse, then copies the scene in a new SceneSnapshot
+ * and publishes it in place of the previous one (read-copy-update), so
+ * that trackers updating at several times the pulse rate publish a
+ * single snapshot per pulse. A snapshot is never modified once
+ * published.
+ *
+ * The scene is modified, and the snapshots are published, in the main
+ * thread. GetSnapshot() may be called from any thread: it only holds a
+ * lock while it copies the pointer to the latest snapshot, which can
+ * then be read without locking for as long as it is held, whatever the
+ * main thread publishes meanwhile.
+ *
+ * \sa SceneSnapshot
+ * \sa FrameScheduler
+ */
+class SceneSnapshotPublisher : public Object
+{
+
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( SceneSnapshotPublisher, Object )
+
+  typedef SceneSnapshot::RepresentationContainerType
+                                                RepresentationContainerType;
+
+  /** Set the representations of the scene. A snapshot is published if
+   *  they changed. To be called from the main thread. */
+  void RequestSetRepresentations(
+                         const RepresentationContainerType & representations );
+
+  /** Publish a snapshot if one of the coordinate systems changed since
+   *  the latest one. To be called from the main thread, once per
+   *  pulse. */
+  void RequestPublish();
+
+  /** Latest snapshot. May be called from any thread. */
+  SceneSnapshot::ConstPointer GetSnapshot() const;
+
+  /** Number of snapshots published */
+  unsigned long GetNumberOfPublishedSnapshots() const;
+
+  /** Number of coordinate systems followed */
+  unsigned int GetNumberOfCoordinateSystems() const;
+
+protected:
+
+  SceneSnapshotPublisher( void );
+  virtual ~SceneSnapshotPublisher( void );
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  SceneSnapshotPublisher(const Self&);   //purposely not implemented
+  void operator=(const Self&);           //purposely not implemented
+
+  /** Copy the scene in a new snapshot and publish it */
+  void Publish();
+
+  /** Copy a coordinate system and its ancestors in the nodes of a
+   *  snapshot */
+  void AddNodes( const CoordinateSystem * coordinateSystem,
+                 SceneSnapshot::NodeContainerType & nodes ) const;
+
+  /** Receive the changes of the coordinate systems */
+  void SetTransformCallback(
+                         const CoordinateSystemSetTransformResult & payload );
+
+  /** A coordinate system that is followed. It is held until it is not
+   *  part of the scene anymore, so that the coordinate systems of the
+   *  representations can be walked even if their objects were released
+   *  since the representations were set. */
+  struct FollowedType
+    {
+    CoordinateSystem::ConstPointer    CoordinateSystemPointer;
+    unsigned long                     Tag;
+    };
+
+  typedef std::map< const CoordinateSystem *, FollowedType >
+                                                      FollowedContainerType;
+
+  RepresentationContainerType     m_Representations;
+  FollowedContainerType           m_Followed;
+
+  /** Whether a coordinate system changed since the latest snapshot */
+  bool                            m_SceneModified;
+
+  SceneSnapshot::ConstPointer     m_Snapshot;
+  mutable itk::SimpleMutexLock    m_SnapshotLock;
+
+  unsigned long                   m_NumberOfPublishedSnapshots;
+};
+
+} // end namespace igstk
+
+#endif // __igstkSceneSnapshotPublisher_h
@@ -322,6 +322,9 @@ SerialCommunicationForPosix::InternalPurgeBuffers( void )
     result = SUCCESS;
     }
 
+  // the data already received by a reactor is purged as well
+  this->ClearReactorBuffer();
+
   return result;
 }
 
@@ -372,6 +375,12 @@ SerialCommunicationForPosix::InternalRead( char *data,
   bool useTerminationCharacter = this->GetUseReadTerminationCharacter();
   unsigned int timeoutPeriod = this->GetTimeoutPeriod();
 
+  // in a reactor, the data was already read from the port
+  if (this->GetReactorMode())
+    {
+    return this->ReadFromReactor(data, n, bytesRead);
+    }
+
   unsigned int i = 0;
   int m;
   ResultType readError = SUCCESS;
@@ -436,6 +445,12 @@ SerialCommunicationForPosix::InternalRead( char *data,
 }
 
 
+int SerialCommunicationForPosix::GetReactorDescriptor( void ) const
+{
+  return m_PortHandle;
+}
+
+
 void SerialCommunicationForPosix::PrintSelf( std::ostream& os,
                                              itk::Indent indent ) const
 {
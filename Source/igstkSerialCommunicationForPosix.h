@@ -51,6 +51,9 @@ public:
   /** Return value type for interface functions */ 
   typedef SerialCommunication::ResultType ResultType;
 
+  /** The port handle, which a CommunicationReactor can wait on */
+  virtual int GetReactorDescriptor( void ) const;
+
 protected:
 
   /** Constructor */
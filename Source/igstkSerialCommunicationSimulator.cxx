@@ -39,6 +39,7 @@ SerialCommunicationSimulator::SerialCommunicationSimulator()
   m_ResponseTable.clear();
   m_CounterTable.clear();
   m_TimeTable.clear();
+  m_SimulateResponseTime = true;
 } 
 
 
@@ -264,7 +265,10 @@ SerialCommunicationSimulator::InternalRead( char *data,
        bytesRead < bytesToRead))
     {
     // to be realistic, sleep for the timeout period before returning
-    this->InternalSleep(this->GetTimeoutPeriod());
+    if( m_SimulateResponseTime )
+      {
+      this->InternalSleep(this->GetTimeoutPeriod());
+      }
     igstkLogMacro( DEBUG, "InternalRead failed with timeout...\n");
     return TIMEOUT;
     }
@@ -276,7 +280,10 @@ SerialCommunicationSimulator::InternalRead( char *data,
     // convert responseTime to milliseconds, and add 1 millisecond
     sleepTime = (unsigned int)(responseTime * 1000) + 1;
     }
-  this->InternalSleep(sleepTime);
+  if( m_SimulateResponseTime )
+    {
+    this->InternalSleep(sleepTime);
+    }
 
   igstkLogMacro( DEBUG, "Read number of bytes = " << bytesRead << "\n" );
 
@@ -291,6 +298,8 @@ void SerialCommunicationSimulator::PrintSelf( std::ostream& os,
   Superclass::PrintSelf(os, indent);
 
   os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "SimulateResponseTime: " << m_SimulateResponseTime 
+     << std::endl;
 }
 
 } // end namespace igstk
@@ -55,6 +55,12 @@ public:
   /** Get the file name for the recorded data */
   const char *GetFileName() const;
 
+  /** Enable or disable the simulation of the response times recorded in the
+   *  file. It is enabled by default. Disabling it allows measuring the
+   *  processing cost of the replies without the device latency. */
+  igstkSetMacro( SimulateResponseTime, bool );
+  igstkGetMacro( SimulateResponseTime, bool );
+
 protected:
 
   typedef SerialCommunication::ResultType ResultType;
@@ -125,6 +131,9 @@ private:
   /** The most recently sent command */
   BinaryData  m_Command;
 
+  /** Whether to sleep as the recorded device did */
+  bool  m_SimulateResponseTime;
+
 };
 
 } // end namespace igstk
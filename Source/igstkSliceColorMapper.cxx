@@ -0,0 +1,304 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkSliceColorMapper.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkSliceColorMapper.h"
+
+#include "vtkImageData.h"
+#include "vtkLookupTable.h"
+#include "vtkPointData.h"
+
+#include <limits>
+#include <string.h>
+
+namespace igstk
+{
+
+namespace
+{
+
+const int NumberOfColors = 256;
+
+/** Index of the colour of a value, as computed by vtkLookupTable */
+inline int ColorIndex( double value, double shift, double scale )
+{
+  const double index = ( value + shift ) * scale;
+  if( index < 0.0 )
+    {
+    return 0;
+    }
+  if( index > NumberOfColors - 1 )
+    {
+    return NumberOfColors - 1;
+    }
+  return static_cast< int >( index );
+}
+
+/** Map a row with the colour of every possible value */
+template < class T >
+void MapRowWithValueTable( const T * input, int stride, int length,
+                           const unsigned int * table, int firstValue,
+                           unsigned char * output )
+{
+  for( int i = 0; i < length; i++ )
+    {
+    const unsigned int color =
+      table[ static_cast< int >( input[i * stride] ) - firstValue ];
+    memcpy( output + 4 * i, &color, 4 );
+    }
+}
+
+/** Map a row through the 256 colours */
+template < class T >
+void MapRowWithColorTable( const T * input, int stride, int length,
+                           const unsigned int * table,
+                           double shift, double scale,
+                           unsigned char * output )
+{
+  for( int i = 0; i < length; i++ )
+    {
+    const unsigned int color =
+      table[ ColorIndex( static_cast< double >( input[i * stride] ),
+                         shift, scale ) ];
+    memcpy( output + 4 * i, &color, 4 );
+    }
+}
+
+/** Range of the values of the 8 and 16 bit types. Returns false for the
+ *  other types. */
+bool GetValueRange( int scalarType, int & firstValue, int & numberOfValues )
+{
+  switch( scalarType )
+    {
+    case VTK_CHAR:
+      firstValue = std::numeric_limits< char >::min();
+      numberOfValues = 256;
+      return true;
+    case VTK_SIGNED_CHAR:
+      firstValue = -128;
+      numberOfValues = 256;
+      return true;
+    case VTK_UNSIGNED_CHAR:
+      firstValue = 0;
+      numberOfValues = 256;
+      return true;
+    case VTK_SHORT:
+      firstValue = -32768;
+      numberOfValues = 65536;
+      return true;
+    case VTK_UNSIGNED_SHORT:
+      firstValue = 0;
+      numberOfValues = 65536;
+      return true;
+    default:
+      return false;
+    }
+}
+
+}
+
+/** Constructor */
+SliceColorMapper::SliceColorMapper()
+{
+  m_Window = 2000.0;
+  m_Level = 0.0;
+  m_Hue = 0.0;
+  m_Saturation = 0.0;
+  m_Value = 1.0;
+  m_Opacity = 1.0;
+  m_ValueTableType = 0;
+  m_NumberOfTableBuilds = 0;
+}
+
+/** Destructor */
+SliceColorMapper::~SliceColorMapper()
+{
+}
+
+void SliceColorMapper::SetWindowLevel( double window, double level )
+{
+  if( window != m_Window || level != m_Level )
+    {
+    m_Window = window;
+    m_Level = level;
+    m_ValueTableType = 0;
+    }
+}
+
+void SliceColorMapper::SetColor( double hue, double saturation,
+                                 double value, double opacity )
+{
+  if( hue != m_Hue || saturation != m_Saturation || value != m_Value ||
+      opacity != m_Opacity )
+    {
+    m_Hue = hue;
+    m_Saturation = saturation;
+    m_Value = value;
+    m_Opacity = opacity;
+    m_ColorTable.clear();
+    m_ValueTableType = 0;
+    }
+}
+
+unsigned long SliceColorMapper::GetNumberOfTableBuilds() const
+{
+  return m_NumberOfTableBuilds;
+}
+
+void SliceColorMapper::BuildColorTable()
+{
+  vtkLookupTable * lut = vtkLookupTable::New();
+  lut->SetNumberOfTableValues( NumberOfColors );
+  lut->SetSaturationRange( m_Saturation, m_Saturation );
+  lut->SetAlphaRange( m_Opacity, m_Opacity );
+  lut->SetHueRange( m_Hue, m_Hue );
+  lut->SetValueRange( 0, m_Value );
+  lut->SetRampToLinear();
+  lut->Build();
+
+  m_ColorTable.resize( NumberOfColors );
+  for( int i = 0; i < NumberOfColors; i++ )
+    {
+    memcpy( &m_ColorTable[i], lut->GetPointer( i ), 4 );
+    }
+
+  lut->Delete();
+}
+
+void SliceColorMapper::BuildValueTable( int scalarType )
+{
+  int firstValue = 0;
+  int numberOfValues = 0;
+  if( !GetValueRange( scalarType, firstValue, numberOfValues ) )
+    {
+    return;
+    }
+
+  const double shift = -( m_Level - m_Window / 2.0 );
+  const double scale = m_Window > 0.0 ? NumberOfColors / m_Window
+                                      : std::numeric_limits< double >::max();
+
+  m_ValueTable.resize( numberOfValues );
+  for( int i = 0; i < numberOfValues; i++ )
+    {
+    m_ValueTable[i] = m_ColorTable[ ColorIndex( firstValue + i,
+                                                shift, scale ) ];
+    }
+
+  m_ValueTableType = scalarType;
+  m_NumberOfTableBuilds++;
+}
+
+bool SliceColorMapper::MapSlice( vtkImageData * input, const int extent[6],
+                                 vtkImageData * output )
+{
+  if( !input || !output || !input->GetPointData()->GetScalars() )
+    {
+    return false;
+    }
+
+  int inputExtent[6];
+  input->GetExtent( inputExtent );
+  for( unsigned int i = 0; i < 6; i += 2 )
+    {
+    if( extent[i] > extent[i + 1] || extent[i] < inputExtent[i] ||
+        extent[i + 1] > inputExtent[i + 1] )
+      {
+      return false;
+      }
+    }
+
+  if( m_ColorTable.empty() )
+    {
+    this->BuildColorTable();
+    }
+
+  const int scalarType = input->GetScalarType();
+  int firstValue = 0;
+  int numberOfValues = 0;
+  const bool useValueTable =
+    GetValueRange( scalarType, firstValue, numberOfValues );
+  if( useValueTable && m_ValueTableType != scalarType )
+    {
+    this->BuildValueTable( scalarType );
+    }
+
+  // The buffer of the output is kept as long as the number of pixels does
+  // not change
+  int outputExtent[6];
+  output->GetExtent( outputExtent );
+  output->SetSpacing( input->GetSpacing() );
+  output->SetOrigin( input->GetOrigin() );
+  if( memcmp( outputExtent, extent, sizeof( outputExtent ) ) != 0 ||
+      output->GetScalarType() != VTK_UNSIGNED_CHAR ||
+      output->GetNumberOfScalarComponents() != 4 ||
+      !output->GetPointData()->GetScalars() )
+    {
+    output->SetExtent( const_cast< int * >( extent ) );
+    output->SetWholeExtent( const_cast< int * >( extent ) );
+    output->SetScalarTypeToUnsignedChar();
+    output->SetNumberOfScalarComponents( 4 );
+    output->AllocateScalars();
+    }
+
+  const int stride = input->GetNumberOfScalarComponents();
+  const int length = extent[1] - extent[0] + 1;
+  const double shift = -( m_Level - m_Window / 2.0 );
+  const double scale = m_Window > 0.0 ? NumberOfColors / m_Window
+                                      : std::numeric_limits< double >::max();
+
+  for( int z = extent[4]; z <= extent[5]; z++ )
+    {
+    for( int y = extent[2]; y <= extent[3]; y++ )
+      {
+      void * row = input->GetScalarPointer( extent[0], y, z );
+      unsigned char * outputRow = static_cast< unsigned char * >(
+                                 output->GetScalarPointer( extent[0], y, z ) );
+
+      if( useValueTable )
+        {
+        switch( scalarType )
+          {
+          vtkTemplateMacro(
+            MapRowWithValueTable( static_cast< const VTK_TT * >( row ),
+                                  stride, length, &m_ValueTable[0],
+                                  firstValue, outputRow ) );
+          }
+        }
+      else
+        {
+        switch( scalarType )
+          {
+          vtkTemplateMacro(
+            MapRowWithColorTable( static_cast< const VTK_TT * >( row ),
+                                  stride, length, &m_ColorTable[0],
+                                  shift, scale, outputRow ) );
+          }
+        }
+      }
+    }
+
+  output->Modified();
+  return true;
+}
+
+} // end namespace igstk
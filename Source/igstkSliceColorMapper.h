@@ -0,0 +1,103 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkSliceColorMapper.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkSliceColorMapper_h
+#define __igstkSliceColorMapper_h
+
+#include <vector>
+
+class vtkImageData;
+
+namespace igstk
+{
+
+/** \class SliceColorMapper
+ *
+ * \brief Maps a slice of a scalar image to RGBA with a window and a level.
+ *
+ * The colours are those of a linear vtkLookupTable of 256 entries, with a
+ * constant hue, saturation and opacity, a value ramping from 0 to Value,
+ * and a table range of [level - window/2, level + window/2].
+ *
+ * For 8 and 16 bit images, the colour of every possible pixel value is
+ * precomputed when the window, level or colour change. Mapping a slice is
+ * then a single table lookup per pixel, without any arithmetic or branch,
+ * in a loop that the compiler can vectorize. Other scalar types are mapped
+ * through the 256 colours with a clamped linear index.
+ *
+ * Only the extent of the slice is mapped. The output image is allocated
+ * again only when the size of the extent changes, so that scrolling
+ * through the slices or dragging the window/level reuses its buffer.
+ *
+ * \ingroup ObjectRepresentation
+ */
+class SliceColorMapper
+{
+
+public:
+
+  SliceColorMapper();
+  virtual ~SliceColorMapper();
+
+  /** Window and level. The window is 2000 and the level 0 by default. */
+  void SetWindowLevel( double window, double level );
+
+  /** Constant hue, saturation and opacity, and value at the top of the
+   *  window. White and opaque by default. */
+  void SetColor( double hue, double saturation, double value,
+                 double opacity );
+
+  /** Map the extent of the first component of the input to an RGBA
+   *  unsigned char output with the same extent, spacing and origin.
+   *  Returns false if the extent is not inside the input. */
+  bool MapSlice( vtkImageData * input, const int extent[6],
+                 vtkImageData * output );
+
+  /** Number of times the per value table was computed */
+  unsigned long GetNumberOfTableBuilds() const;
+
+private:
+
+  SliceColorMapper(const SliceColorMapper &); //purposely not implemented
+  void operator=(const SliceColorMapper &);   //purposely not implemented
+
+  /** Compute the 256 colours */
+  void BuildColorTable();
+
+  /** Compute the colour of every value of an 8 or 16 bit type */
+  void BuildValueTable( int scalarType );
+
+  double                        m_Window;
+  double                        m_Level;
+  double                        m_Hue;
+  double                        m_Saturation;
+  double                        m_Value;
+  double                        m_Opacity;
+
+  /** 256 RGBA colours, packed in the byte order of the output */
+  std::vector< unsigned int >   m_ColorTable;
+
+  /** RGBA colour of every value of m_ValueTableType, from its smallest
+   *  value. The type is 0 when the table is not up to date. */
+  std::vector< unsigned int >   m_ValueTable;
+  int                           m_ValueTableType;
+  unsigned long                 m_NumberOfTableBuilds;
+};
+
+} // end namespace igstk
+
+#endif // __igstkSliceColorMapper_h
@@ -0,0 +1,257 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkThreadPolicy.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkThreadPolicy.h"
+
+#include <sstream>
+#include <string.h>
+
+#if defined(WIN32) || defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <sys/mman.h>
+#endif
+
+namespace igstk
+{
+
+namespace
+{
+
+/** Touch a page worth of stack, and recurse for the rest of the size.
+ *  The buffer is read after the recursion so that it is not optimized
+ *  into a loop reusing the same frame. */
+unsigned long PrefaultStack( unsigned long size )
+{
+  volatile unsigned char page[4096];
+  for( unsigned int i = 0; i < sizeof( page ); i += 256 )
+    {
+    page[i] = 0;
+    }
+
+  unsigned long touched = sizeof( page );
+  if( size > sizeof( page ) )
+    {
+    touched += PrefaultStack( size - sizeof( page ) );
+    }
+  return touched + page[0];
+}
+
+ThreadPolicy::SettingResultType
+MakeResult( const std::string & description, bool succeeded,
+            const std::string & reason )
+{
+  ThreadPolicy::SettingResultType result;
+  result.Description = description;
+  result.Succeeded = succeeded;
+  if( !succeeded )
+    {
+    result.Description += " failed: " + reason;
+    }
+  return result;
+}
+
+#if defined(WIN32) || defined(_WIN32)
+std::string LastErrorString()
+{
+  std::ostringstream reason;
+  reason << "error " << GetLastError();
+  return reason.str();
+}
+#endif
+
+}
+
+
+ThreadPolicy::ThreadPolicy()
+{
+  m_Scheduling = DefaultScheduling;
+  m_Priority = 0;
+  m_CPUAffinityMask = 0;
+  m_LockMemory = false;
+  m_PrefaultStackSize = 0;
+}
+
+ThreadPolicy::~ThreadPolicy()
+{
+}
+
+void ThreadPolicy::SetScheduling( SchedulingType scheduling, int priority )
+{
+  m_Scheduling = scheduling;
+  m_Priority = priority;
+}
+
+ThreadPolicy::SchedulingType ThreadPolicy::GetScheduling() const
+{
+  return m_Scheduling;
+}
+
+int ThreadPolicy::GetPriority() const
+{
+  return m_Priority;
+}
+
+void ThreadPolicy::SetCPUAffinityMask( unsigned long mask )
+{
+  m_CPUAffinityMask = mask;
+}
+
+unsigned long ThreadPolicy::GetCPUAffinityMask() const
+{
+  return m_CPUAffinityMask;
+}
+
+void ThreadPolicy::SetLockMemory( bool lock )
+{
+  m_LockMemory = lock;
+}
+
+bool ThreadPolicy::GetLockMemory() const
+{
+  return m_LockMemory;
+}
+
+void ThreadPolicy::SetPrefaultStackSize( unsigned long size )
+{
+  m_PrefaultStackSize = size;
+}
+
+unsigned long ThreadPolicy::GetPrefaultStackSize() const
+{
+  return m_PrefaultStackSize;
+}
+
+ThreadPolicy::SettingResultContainerType
+ThreadPolicy::ApplyToCurrentThread() const
+{
+  SettingResultContainerType results;
+
+  if( m_Scheduling != DefaultScheduling )
+    {
+#if defined(WIN32) || defined(_WIN32)
+    const bool succeeded = ( SetThreadPriority( GetCurrentThread(),
+                             THREAD_PRIORITY_TIME_CRITICAL ) != 0 );
+    results.push_back( MakeResult( "Time critical priority", succeeded,
+                                   succeeded ? "" : LastErrorString() ) );
+#else
+    const int policy =
+      ( m_Scheduling == FifoScheduling ) ? SCHED_FIFO : SCHED_RR;
+    sched_param parameters;
+    memset( &parameters, 0, sizeof( parameters ) );
+    parameters.sched_priority = m_Priority;
+    if( parameters.sched_priority < sched_get_priority_min( policy ) )
+      {
+      parameters.sched_priority = sched_get_priority_min( policy );
+      }
+    if( parameters.sched_priority > sched_get_priority_max( policy ) )
+      {
+      parameters.sched_priority = sched_get_priority_max( policy );
+      }
+
+    std::ostringstream description;
+    description << ( ( policy == SCHED_FIFO ) ? "SCHED_FIFO" : "SCHED_RR" )
+                << " priority " << parameters.sched_priority;
+    const int error =
+      pthread_setschedparam( pthread_self(), policy, &parameters );
+    results.push_back( MakeResult( description.str(), error == 0,
+                                   strerror( error ) ) );
+#endif
+    }
+
+  if( m_CPUAffinityMask != 0 )
+    {
+    std::ostringstream description;
+    description << "CPU affinity mask 0x" << std::hex << m_CPUAffinityMask;
+#if defined(WIN32) || defined(_WIN32)
+    const bool succeeded = ( SetThreadAffinityMask( GetCurrentThread(),
+                             m_CPUAffinityMask ) != 0 );
+    results.push_back( MakeResult( description.str(), succeeded,
+                                   succeeded ? "" : LastErrorString() ) );
+#elif defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO( &cpus );
+    for( unsigned int cpu = 0; cpu < 8 * sizeof( m_CPUAffinityMask ); cpu++ )
+      {
+      if( m_CPUAffinityMask & ( 1UL << cpu ) )
+        {
+        CPU_SET( cpu, &cpus );
+        }
+      }
+    const int error =
+      pthread_setaffinity_np( pthread_self(), sizeof( cpus ), &cpus );
+    results.push_back( MakeResult( description.str(), error == 0,
+                                   strerror( error ) ) );
+#else
+    results.push_back( MakeResult( description.str(), false,
+                                   "not supported on this platform" ) );
+#endif
+    }
+
+  if( m_LockMemory )
+    {
+#if defined(WIN32) || defined(_WIN32)
+    results.push_back( MakeResult( "Memory locking", false,
+                                   "not supported on this platform" ) );
+#else
+    const bool succeeded = ( mlockall( MCL_CURRENT | MCL_FUTURE ) == 0 );
+    const int error = errno;
+    results.push_back( MakeResult( "Memory locking", succeeded,
+                                   strerror( error ) ) );
+#endif
+    }
+
+  if( m_PrefaultStackSize > 0 )
+    {
+    std::ostringstream description;
+    description << PrefaultStack( m_PrefaultStackSize )
+                << " bytes of stack prefaulted";
+    results.push_back( MakeResult( description.str(), true, "" ) );
+    }
+
+  return results;
+}
+
+void ThreadPolicy::Print( std::ostream & os ) const
+{
+  const char * schedulingNames[] = { "default", "FIFO", "round robin" };
+  os << "Scheduling: " << schedulingNames[m_Scheduling];
+  if( m_Scheduling != DefaultScheduling )
+    {
+    os << ", priority " << m_Priority;
+    }
+  os << ", CPU affinity mask: 0x" << std::hex << m_CPUAffinityMask
+     << std::dec << ", lock memory: " << m_LockMemory
+     << ", prefaulted stack: " << m_PrefaultStackSize;
+}
+
+std::ostream& operator<<( std::ostream& os, const ThreadPolicy& policy )
+{
+  policy.Print( os );
+  return os;
+}
+
+} // end namespace igstk
@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkThreadPolicy.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkThreadPolicy_h
+#define __igstkThreadPolicy_h
+
+#include "igstkEvents.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace igstk
+{
+
+/** Events reporting a setting of a thread policy that was applied, or
+ *  that could not be applied. The string describes the setting. */
+igstkEventMacro( ThreadPolicyEvent,          StringEvent );
+igstkEventMacro( ThreadPolicyErrorEvent,     IGSTKErrorWithStringEvent );
+
+/** \class ThreadPolicy
+ *
+ * \brief Scheduling, placement and memory settings of an acquisition
+ * thread.
+ *
+ * An acquisition thread scheduled with the default policy competes with
+ * the rendering and the rest of the workstation, and may be delayed by
+ * several milliseconds. The policy can give it a real time priority
+ * (SCHED_FIFO or SCHED_RR), bind it to a set of processors, lock the
+ * memory of the process so that it is never paged out, and touch the
+ * first bytes of its stack so that it does not fault on them later.
+ *
+ * The settings are applied by the thread itself, when it starts, with
+ * ApplyToCurrentThread(). Each setting that is not the default is
+ * reported as succeeded or failed: real time priorities and memory
+ * locking usually require privileges, and a failure leaves the thread
+ * with its default settings. Locking the memory applies to the whole
+ * process. On Windows, both real time policies map to the time critical
+ * priority, and the memory cannot be locked.
+ *
+ * By default, nothing is changed.
+ *
+ * \sa Tracker
+ * \sa VideoImager
+ */
+class ThreadPolicy
+{
+
+public:
+
+  typedef enum
+    {
+    DefaultScheduling,
+    FifoScheduling,
+    RoundRobinScheduling
+    } SchedulingType;
+
+  /** Outcome of a setting */
+  struct SettingResultType
+    {
+    std::string   Description;
+    bool          Succeeded;
+    };
+
+  typedef std::vector< SettingResultType >   SettingResultContainerType;
+
+  ThreadPolicy();
+  virtual ~ThreadPolicy();
+
+  /** Scheduling policy and priority. The priority is clamped to the range
+   *  of the policy, and is ignored by the default scheduling. */
+  void SetScheduling( SchedulingType scheduling, int priority );
+  SchedulingType GetScheduling() const;
+  int GetPriority() const;
+
+  /** Processors the thread may run on, one bit per processor. Zero, the
+   *  default, leaves the affinity unchanged. */
+  void SetCPUAffinityMask( unsigned long mask );
+  unsigned long GetCPUAffinityMask() const;
+
+  /** Lock the current and future memory of the process */
+  void SetLockMemory( bool lock );
+  bool GetLockMemory() const;
+
+  /** Number of bytes of stack touched when the thread starts */
+  void SetPrefaultStackSize( unsigned long size );
+  unsigned long GetPrefaultStackSize() const;
+
+  /** Apply the settings to the calling thread */
+  SettingResultContainerType ApplyToCurrentThread() const;
+
+  /** Print the settings */
+  void Print( std::ostream & os ) const;
+
+private:
+
+  SchedulingType      m_Scheduling;
+  int                 m_Priority;
+  unsigned long       m_CPUAffinityMask;
+  bool                m_LockMemory;
+  unsigned long       m_PrefaultStackSize;
+};
+
+std::ostream& operator<<( std::ostream& os, const ThreadPolicy& policy );
+
+} // end namespace igstk
+
+#endif // __igstkThreadPolicy_h
@@ -84,6 +84,15 @@ TimeStamp
 }
 
 
+void
+TimeStamp
+::SetStartTimeAndExpirationTime( double startTime, double expirationTime ) 
+{
+  this->m_StartTime      = startTime;
+  this->m_ExpirationTime = expirationTime;
+}
+
+
 double 
 TimeStamp
 ::GetStartTime() const 
@@ -82,6 +82,13 @@ public:
    * number of millisecondsToExpire argument provided by the user */
   void SetStartTimeNowAndExpireAfter( TimePeriodType millisecondsToExpire);
 
+  /** This method sets both the Start time and the Expiration time of the
+   * TimeStamp to explicit values in milliseconds. It is intended for restoring
+   * time stamps that were recorded earlier, for example by a compact copy of
+   * a transform. */
+  void SetStartTimeAndExpirationTime( TimePeriodType startTime,
+                                      TimePeriodType expirationTime );
+
   
   /** Returns the time in milliseconds at which this stamp started to be valid.
    * This is the time at which the SetStartTimeNowAndExpireAfter() was invoked
@@ -22,12 +22,34 @@
 #endif
 
 #include "igstkTracker.h"
+#include "igstkRealTimeClock.h"
+
+#include <sstream>
 
 #define NON_FLICKERING_CONSTANT 20
 
 namespace igstk
 {
 
+const Tracker::TrackerToolSlotType Tracker::InvalidTrackerToolSlot = 
+  static_cast< Tracker::TrackerToolSlotType >( -1 );
+
+/** Updates the status of a tracker, in the thread of its reactor, when
+ *  its communication received a reply */
+class Tracker::ReactorHandler : public CommunicationReactor::ReplyHandler
+{
+public:
+  ReactorHandler( Tracker * tracker ) : m_Tracker( tracker ) {}
+
+  virtual void ProcessReply( Communication * itkNotUsed(communication) )
+    {
+    m_Tracker->InternalThreadedUpdateStatus();
+    m_Tracker->m_ConditionNextTransformReceived->Signal();
+    }
+
+private:
+  Tracker * m_Tracker;
+};
 
 /** Constructor */
 Tracker::Tracker(void) :  m_StateMachine( this ) 
@@ -313,16 +335,39 @@ Tracker::Tracker(void) :  m_StateMachine( this )
 
   // By default, the reference is not used
   m_ApplyingReferenceTool = false;
+  m_ReferenceToolSlot = InvalidTrackerToolSlot;
 
   m_ConditionNextTransformReceived = itk::ConditionVariable::New();
   m_Threader = itk::MultiThreader::New();
   m_ThreadingEnabled = false;
   m_TrackingThreadStarted = false;
+
+  m_ThreadPolicyApplied = false;
+  m_ConditionThreadPolicyApplied = itk::ConditionVariable::New();
+
+  m_ReactorCommunication = NULL;
+  m_ReactorHandler = new ReactorHandler( this );
+
+  m_TrackingLoopPacing = UnpacedTrackingLoop;
+  m_TrackingLoopFrequency = 100.0;
+  m_NumberOfTrackingLoopReads = 0;
+  m_NumberOfAvoidedReads = 0.0;
+  m_TrackingLoopReadDuration = 0.0;
+  m_TrackingLoopCPUTime = 0.0;
+  m_NextReadTime = 0.0;
+  m_LastReadTime = 0.0;
+
+  m_DeviceFrameClock = DeviceFrameClock::New();
+  m_ReportedDroppedFrames = 0;
+  m_ReportedDuplicatedFrames = 0;
+  m_ReportedOutOfOrderFrames = 0;
 }
 
 /** Destructor */
 Tracker::~Tracker(void)
 {
+  this->DetachFromCommunicationReactor();
+  delete m_ReactorHandler;
 }
 
 /** This method sets the reference tool. */
@@ -345,6 +390,7 @@ void Tracker::RequestSetReferenceTool( TrackerToolType * trackerTool )
       {
       m_ApplyingReferenceTool = true;
       m_ReferenceTool = trackerTool;
+      m_ReferenceToolSlot = this->GetTrackerToolSlot( trackerTool );
       m_ReferenceTool->RequestDetachFromParent();
 
       //VERY IMPORTANT: Make the reference tracker tool the parent of the 
@@ -489,15 +535,13 @@ void Tracker::ResetFromTrackingStateProcessing( void )
 
   // Report to all the tracker tools that the tracking state is reset and
   // tracking should be stopped
-  typedef TrackerToolsContainerType::iterator  InputConstIterator;
-
-  InputConstIterator inputItr = m_TrackerTools.begin();
-  InputConstIterator inputEnd = m_TrackerTools.end();
-
-  while( inputItr != inputEnd )
+  const TrackerToolSlotType numberOfSlots = this->GetNumberOfTrackerToolSlots();
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
-    (inputItr->second)->RequestReportTrackingStopped();
-    ++inputItr;
+    if( m_TrackerToolSlots[slot] )
+      {
+      m_TrackerToolSlots[slot]->RequestReportTrackingStopped();
+      }
     }
 
   this->InvokeEvent( TrackerStopTrackingEvent() );  
@@ -552,6 +596,21 @@ void Tracker::AttemptToStartTrackingProcessing( void )
   igstkLogMacro( DEBUG, "igstk::Tracker::AttemptToStartTrackingProcessing  "
                  "called ...\n");
 
+  // the frame numbers of the device may restart with the tracking
+  m_DeviceFrameClockLock.Lock();
+  m_DeviceFrameClock->Reset();
+  m_ReportedDroppedFrames = 0;
+  m_ReportedDuplicatedFrames = 0;
+  m_ReportedOutOfOrderFrames = 0;
+  m_DeviceFrameClockLock.Unlock();
+
+  m_TrackingLoopLock.Lock();
+  m_NumberOfTrackingLoopReads = 0;
+  m_NumberOfAvoidedReads = 0.0;
+  m_TrackingLoopReadDuration = 0.0;
+  m_TrackingLoopCPUTime = 0.0;
+  m_TrackingLoopLock.Unlock();
+
   ResultType result = this->InternalStartTracking();
   
   m_StateMachine.PushInputBoolean( (bool)result,
@@ -566,15 +625,13 @@ void Tracker::StartTrackingSuccessProcessing( void )
                  "called ...\n");
 
   // Report to all the tracker tools that tracking has been started
-  typedef TrackerToolsContainerType::iterator  InputConstIterator;
-
-  InputConstIterator inputItr = m_TrackerTools.begin();
-  InputConstIterator inputEnd = m_TrackerTools.end();
-
-  while( inputItr != inputEnd )
+  const TrackerToolSlotType numberOfSlots = this->GetNumberOfTrackerToolSlots();
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
-    (inputItr->second)->RequestReportTrackingStarted();
-    ++inputItr;
+    if( m_TrackerToolSlots[slot] )
+      {
+      m_TrackerToolSlots[slot]->RequestReportTrackingStarted();
+      }
     }
 
 
@@ -600,6 +657,10 @@ void Tracker::AttachingTrackerToolSuccessProcessing( void )
   igstkLogMacro( DEBUG, "igstk::Tracker::AttachingTrackerToolSuccessProcessing "
                  "called ...\n");
 
+  // assign a slot before updating the container, so that a tool replacing
+  // another tool with the same identifier takes over its slot
+  this->AddTrackerToolToSlots( m_TrackerToolToBeAttached );
+
   m_TrackerTools[ m_TrackerToolToBeAttached->GetTrackerToolIdentifier() ] 
                                    = m_TrackerToolToBeAttached; 
 
@@ -657,15 +718,13 @@ void Tracker::StopTrackingSuccessProcessing( void )
                  "called ...\n");
 
   // Report to all the tracker tools that tracking has been stopped
-  typedef TrackerToolsContainerType::iterator  InputConstIterator;
-
-  InputConstIterator inputItr = m_TrackerTools.begin();
-  InputConstIterator inputEnd = m_TrackerTools.end();
-
-  while( inputItr != inputEnd )
+  const TrackerToolSlotType numberOfSlots = this->GetNumberOfTrackerToolSlots();
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
-    (inputItr->second)->RequestReportTrackingStopped();
-    ++inputItr;
+    if( m_TrackerToolSlots[slot] )
+      {
+      m_TrackerToolSlots[slot]->RequestReportTrackingStopped();
+      }
     }
 
   this->InvokeEvent( TrackerStopTrackingEvent() );  
@@ -688,10 +747,17 @@ void Tracker::EnterTrackingStateProcessing( void )
   igstkLogMacro( DEBUG, "igstk::Tracker::EnterTrackingStateProcessing "
                  "called ...\n");
 
-  if ( ! m_TrackingThreadStarted && this->GetThreadingEnabled() )
+  if ( ! m_TrackingThreadStarted && this->GetThreadingEnabled() &&
+       ! this->AttachToCommunicationReactor() )
     {
+    m_LockForThreadPolicy.Lock();
+    m_ThreadPolicyApplied = false;
+    m_LockForThreadPolicy.Unlock();
+
     m_ThreadID = m_Threader->SpawnThread( TrackingThreadFunction, this );
     m_TrackingThreadStarted= true;
+
+    this->WaitForThreadPolicy();
     }
 
   m_PulseGenerator->RequestStart();
@@ -715,6 +781,8 @@ void Tracker::ExitTrackingWithoutTerminatingTrackingThread( void )
     "called ...\n");
 
   m_PulseGenerator->RequestStop();
+
+  this->DetachFromCommunicationReactor();
 }
 
 /** Exit tracking by terminating tracking thread */ 
@@ -725,14 +793,301 @@ void Tracker::ExitTrackingTerminatingTrackingThread( void )
 
   m_PulseGenerator->RequestStop();
 
+  this->DetachFromCommunicationReactor();
+
   // Terminating the TrackingThread.
-  if ( this->GetThreadingEnabled() )
+  if ( m_TrackingThreadStarted && this->GetThreadingEnabled() )
     {
     m_Threader->TerminateThread( m_ThreadID );
     m_TrackingThreadStarted = false;
     }
 }
 
+/** Reactor used instead of the tracking thread */
+void Tracker::SetCommunicationReactor( CommunicationReactor * reactor )
+{
+  if( m_ReactorCommunication != NULL )
+    {
+    igstkLogMacro( WARNING, "igstk::Tracker::SetCommunicationReactor: "
+                   "cannot change the reactor while tracking through it\n" );
+    return;
+    }
+  m_CommunicationReactor = reactor;
+}
+
+bool Tracker::GetTrackingThroughReactor() const
+{
+  return ( m_ReactorCommunication != NULL );
+}
+
+/** By default, the replies are read by the tracking thread */
+Communication * Tracker::GetReactorCommunication( void )
+{
+  return NULL;
+}
+
+/** Add the communication of the tracker to the reactor */
+bool Tracker::AttachToCommunicationReactor( void )
+{
+  if( m_ReactorCommunication != NULL )
+    {
+    return true;
+    }
+  if( m_CommunicationReactor.IsNull() )
+    {
+    return false;
+    }
+
+  Communication * communication = this->GetReactorCommunication();
+  if( communication == NULL )
+    {
+    igstkLogMacro( INFO, "igstk::Tracker: the tracker cannot use a "
+                   "reactor, it uses a tracking thread\n" );
+    return false;
+    }
+
+  if( m_CommunicationReactor->AddCommunication( communication,
+                                                m_ReactorHandler ) !=
+      Communication::SUCCESS )
+    {
+    igstkLogMacro( WARNING, "igstk::Tracker: the communication could not "
+                   "be added to the reactor, a tracking thread is used\n" );
+    return false;
+    }
+
+  m_ReactorCommunication = communication;
+  return true;
+}
+
+/** Remove the communication of the tracker from the reactor */
+void Tracker::DetachFromCommunicationReactor( void )
+{
+  if( m_ReactorCommunication == NULL )
+    {
+    return;
+    }
+
+  m_CommunicationReactor->RemoveCommunication( m_ReactorCommunication );
+  m_ReactorCommunication = NULL;
+}
+
+/** Pacing of the tracking loop */
+void Tracker::SetTrackingLoopPacing( TrackingLoopPacingType pacing )
+{
+  m_TrackingLoopLock.Lock();
+  m_TrackingLoopPacing = pacing;
+  m_TrackingLoopLock.Unlock();
+}
+
+Tracker::TrackingLoopPacingType Tracker::GetTrackingLoopPacing() const
+{
+  m_TrackingLoopLock.Lock();
+  const TrackingLoopPacingType pacing = m_TrackingLoopPacing;
+  m_TrackingLoopLock.Unlock();
+  return pacing;
+}
+
+void Tracker::SetTrackingLoopFrequency( double frequencyInHz )
+{
+  if( frequencyInHz <= 0.0 )
+    {
+    igstkLogMacro( WARNING, "igstk::Tracker::SetTrackingLoopFrequency: "
+                   "invalid frequency " << frequencyInHz << "\n" );
+    return;
+    }
+  m_TrackingLoopLock.Lock();
+  m_TrackingLoopFrequency = frequencyInHz;
+  m_TrackingLoopLock.Unlock();
+}
+
+double Tracker::GetTrackingLoopFrequency() const
+{
+  m_TrackingLoopLock.Lock();
+  const double frequency = m_TrackingLoopFrequency;
+  m_TrackingLoopLock.Unlock();
+  return frequency;
+}
+
+/** Counters of the tracking loop */
+unsigned long Tracker::GetNumberOfTrackingLoopReads() const
+{
+  m_TrackingLoopLock.Lock();
+  const unsigned long number = m_NumberOfTrackingLoopReads;
+  m_TrackingLoopLock.Unlock();
+  return number;
+}
+
+unsigned long Tracker::GetNumberOfAvoidedReads() const
+{
+  m_TrackingLoopLock.Lock();
+  const unsigned long number =
+    static_cast< unsigned long >( m_NumberOfAvoidedReads );
+  m_TrackingLoopLock.Unlock();
+  return number;
+}
+
+double Tracker::GetCPUTimePerRead() const
+{
+  m_TrackingLoopLock.Lock();
+  const double cpuTime = ( m_NumberOfTrackingLoopReads > 0 ) ?
+    m_TrackingLoopCPUTime / m_NumberOfTrackingLoopReads : 0.0;
+  m_TrackingLoopLock.Unlock();
+  return cpuTime;
+}
+
+/** By default, the device cannot signal new data */
+Tracker::NewDataResultType
+Tracker::InternalThreadedWaitForNewData( TimePeriodType itkNotUsed(timeout) )
+{
+  return NEW_DATA_NOT_SUPPORTED;
+}
+
+/** Wait until the device should be read, according to the pacing */
+bool Tracker::WaitForNextRead( void )
+{
+  m_TrackingLoopLock.Lock();
+  TrackingLoopPacingType pacing = m_TrackingLoopPacing;
+  const double frequency = m_TrackingLoopFrequency;
+  const TimePeriodType readDuration = ( m_NumberOfTrackingLoopReads > 0 ) ?
+    m_TrackingLoopReadDuration / m_NumberOfTrackingLoopReads : 0.0;
+  m_TrackingLoopLock.Unlock();
+
+  if( pacing == NewDataTrackingLoop )
+    {
+    // wait for a while only, to check whether tracking is to stop
+    const TimePeriodType timeout = 100.0;
+    const NewDataResultType newData =
+      this->InternalThreadedWaitForNewData( timeout );
+    if( newData == NEW_DATA )
+      {
+      return true;
+      }
+    if( newData == NO_NEW_DATA )
+      {
+      m_TrackingLoopLock.Lock();
+      m_NumberOfAvoidedReads += 1.0;
+      m_TrackingLoopLock.Unlock();
+      return false;
+      }
+    pacing = DeviceRateTrackingLoop;
+    }
+
+  const TimePeriodType now = RealTimeClock::GetTimeStamp();
+  TimePeriodType readTime = now;
+
+  if( pacing == DeviceRateTrackingLoop )
+    {
+    m_DeviceFrameClockLock.Lock();
+    const double framePeriod = m_DeviceFrameClock->GetFramePeriod();
+    const TimePeriodType nextFrameTime =
+      m_DeviceFrameClock->GetNextFrameTime();
+    m_DeviceFrameClockLock.Unlock();
+
+    if( framePeriod > 0.0 )
+      {
+      // if the last read did not get the expected frame, the frame is
+      // late: try again a little later
+      readTime = nextFrameTime;
+      if( readTime <= m_LastReadTime )
+        {
+        readTime = m_LastReadTime + framePeriod / 4.0;
+        }
+      }
+    else
+      {
+      pacing = FixedRateTrackingLoop;
+      }
+    }
+
+  if( pacing == FixedRateTrackingLoop )
+    {
+    // absolute deadlines, so that the rate does not drift with the
+    // duration of the reads, but no burst of reads after a long stall
+    const TimePeriodType period = 1000.0 / frequency;
+    m_NextReadTime += period;
+    if( m_NextReadTime < now - period )
+      {
+      m_NextReadTime = now;
+      }
+    readTime = m_NextReadTime;
+    }
+
+  if( readTime - now >= 1.0 )
+    {
+    const unsigned int milliseconds =
+      static_cast< unsigned int >( readTime - now );
+    PulseGenerator::Sleep( milliseconds );
+
+    if( readDuration > 0.0 )
+      {
+      m_TrackingLoopLock.Lock();
+      m_NumberOfAvoidedReads += milliseconds / readDuration;
+      m_TrackingLoopLock.Unlock();
+      }
+    }
+
+  return true;
+}
+
+/** Account for a read of the device */
+void Tracker::AddTrackingLoopRead( TimePeriodType start,
+                                   TimePeriodType duration,
+                                   TimePeriodType cpuTime )
+{
+  m_LastReadTime = start;
+
+  m_TrackingLoopLock.Lock();
+  m_NumberOfTrackingLoopReads++;
+  m_TrackingLoopReadDuration += duration;
+  m_TrackingLoopCPUTime = cpuTime;
+  m_TrackingLoopLock.Unlock();
+}
+
+/** Policy of the tracking thread */
+void Tracker::SetThreadPolicy( const ThreadPolicy & policy )
+{
+  m_ThreadPolicy = policy;
+}
+
+const ThreadPolicy & Tracker::GetThreadPolicy() const
+{
+  return m_ThreadPolicy;
+}
+
+/** Wait for the tracking thread to apply its policy, and report the
+ *  outcome of each setting */
+void Tracker::WaitForThreadPolicy( void )
+{
+  m_LockForThreadPolicy.Lock();
+  while( !m_ThreadPolicyApplied )
+    {
+    m_ConditionThreadPolicyApplied->Wait( &m_LockForThreadPolicy );
+    }
+  const ThreadPolicy::SettingResultContainerType results =
+    m_ThreadPolicyResults;
+  m_LockForThreadPolicy.Unlock();
+
+  for( unsigned int i = 0; i < results.size(); i++ )
+    {
+    if( results[i].Succeeded )
+      {
+      igstkLogMacro( INFO, "igstk::Tracker: tracking thread "
+                     << results[i].Description << "\n" );
+      ThreadPolicyEvent event;
+      event.Set( results[i].Description );
+      this->InvokeEvent( event );
+      }
+    else
+      {
+      igstkLogMacro( WARNING, "igstk::Tracker: tracking thread "
+                     << results[i].Description << "\n" );
+      ThreadPolicyErrorEvent event;
+      event.Set( results[i].Description );
+      this->InvokeEvent( event );
+      }
+    }
+}
+
 /** The "AttemptToUpdateStatus" method attempts to update status
     during tracking. */
 void Tracker::AttemptToUpdateStatusProcessing( void )
@@ -742,15 +1097,14 @@ void Tracker::AttemptToUpdateStatusProcessing( void )
 
   // Set all tools to "not updated"
   //
-  typedef TrackerToolsContainerType::iterator  InputConstIterator;
-
-  InputConstIterator inputItr = m_TrackerTools.begin();
-  InputConstIterator inputEnd = m_TrackerTools.end();
-
-  while( inputItr != inputEnd )
+  const TrackerToolSlotType numberOfSlots = this->GetNumberOfTrackerToolSlots();
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
-    (inputItr->second)->SetUpdated(false);
-    ++inputItr;
+    m_UpdatedSlots[slot] = 0;
+    if( m_TrackerToolSlots[slot] )
+      {
+      m_TrackerToolSlots[slot]->SetUpdated( false );
+      }
     }
  
   // wait for a new transform to be available, it would be nice if
@@ -779,78 +1133,179 @@ void Tracker::UpdateStatusSuccessProcessing( void )
   igstkLogMacro( DEBUG, "igstk::Tracker::UpdateStatusSuccessProcessing "
                  "called ...\n");
 
-  typedef TrackerToolsContainerType::iterator  InputConstIterator;
+  const bool referenceUpdated = !m_ApplyingReferenceTool || 
+    ( m_ReferenceToolSlot != InvalidTrackerToolSlot &&
+      m_UpdatedSlots[m_ReferenceToolSlot] );
 
-  InputConstIterator inputItr = m_TrackerTools.begin();
-  InputConstIterator inputEnd = m_TrackerTools.end();
+  const TimePeriodType updateTime = RealTimeClock::GetTimeStamp();
 
-  while( inputItr != inputEnd )
+  const TrackerToolSlotType numberOfSlots = this->GetNumberOfTrackerToolSlots();
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
     {
-    if ( (inputItr->second)->GetUpdated() &&
-           ( !m_ApplyingReferenceTool || m_ReferenceTool->GetUpdated() ) ) 
+    TrackerToolType * trackerTool = m_TrackerToolSlots[slot];
+
+    if( !trackerTool || !m_UpdatedSlots[slot] )
       {
-      const TransformType transform = (inputItr->second)->GetRawTransform();
+      continue;
+      }
 
-      const double timeToExpiration = transform.GetExpirationTime() - 
-                                      transform.GetStartTime();
+    const TransformType & transform = m_RawTransformSlots[slot];
 
-      TransformType::VersorType rotationRaw;
-      TransformType::VectorType translationRaw;
+    if( !referenceUpdated )
+      {
+      trackerTool->SetRawTransform( transform );
+      continue;
+      }
 
-      translationRaw = transform.GetTranslation();
-      rotationRaw    = transform.GetRotation();
+    // Keep the time stamp set by the derived class, which may be older
+    // than now, e.g. the acquisition time of the sample
+    TransformType toolRawTransform;
+    toolRawTransform.SetTranslationAndRotation( transform.GetTranslation(),
+                                                transform.GetRotation(),
+                                                transform.GetError(),
+                                                transform.GetStartTime(),
+                                                transform.GetExpirationTime() );
 
-      TransformType toolRawTransform;
-      toolRawTransform.SetTranslationAndRotation( translationRaw, rotationRaw,
-                        transform.GetError(),
-                        timeToExpiration );
+    trackerTool->SetRawTransform( toolRawTransform );
 
-      (inputItr->second)->SetRawTransform( toolRawTransform );
- 
-      TransformType toolCalibrationTransform
-        = (inputItr->second)->GetCalibrationTransform();
-      
+    // smooth the raw transform, the tool keeps the unfiltered one
+    TrackerToolFilter * filter = trackerTool->GetFilter();
+    if( filter )
+      {
+      filter->Filter( toolRawTransform, toolRawTransform );
+      }
+
+    TransformType toolCalibratedTransform =
+      TransformType::TransformCompose( toolRawTransform,
+                                       m_CalibrationTransformSlots[slot] );
 
-      TransformType toolCalibratedTransform;
-      toolCalibratedTransform =
-         toolCalibratedTransform.TransformCompose( 
-            toolRawTransform, toolCalibrationTransform );
+    // extrapolate the tool to the time it will be displayed
+    TrackerToolPredictor * predictor = trackerTool->GetPredictor();
+    if( predictor )
+      {
+      predictor->Predict( toolCalibratedTransform, updateTime,
+                          toolCalibratedTransform );
+      }
 
-      (inputItr->second)->SetCalibratedTransform( toolCalibratedTransform );
+    trackerTool->SetCalibratedTransform( toolCalibratedTransform );
 
-      //throw an event
-      (inputItr->second)->InvokeEvent( TrackerToolTransformUpdateEvent() );
+    //throw an event
+    trackerTool->InvokeEvent( TrackerToolTransformUpdateEvent() );
         
-      // if a reference tracker tool has been specified, then if the tracker
-      // tool that is being updated is the selected reference tracker tool,
-      // then update the transform that is from the tracker to the
-      // reference tracker tool. Otherwise, update the transform from the
-      // tracker tool to the tracker. 
-      if( m_ApplyingReferenceTool )
-        {
-        if ( (inputItr->first) == m_ReferenceTool->GetTrackerToolIdentifier())
-          {
-          this->RequestSetTransformAndParent( 
-            toolCalibratedTransform.GetInverse(), inputItr->second );
-          }
-        else
-          {
-          (inputItr->second)->RequestSetTransformAndParent( 
-            toolCalibratedTransform, this );
-          }
-        }
-      else
-        {
-        (inputItr->second)->RequestSetTransformAndParent( 
-            toolCalibratedTransform, this );
-        }
+    // if a reference tracker tool has been specified, then if the tracker
+    // tool that is being updated is the selected reference tracker tool,
+    // then update the transform that is from the tracker to the
+    // reference tracker tool. Otherwise, update the transform from the
+    // tracker tool to the tracker. 
+    if( m_ApplyingReferenceTool && slot == m_ReferenceToolSlot )
+      {
+      this->RequestSetTransformAndParent( 
+        toolCalibratedTransform.GetInverse(), trackerTool );
+      }
+    else
+      {
+      trackerTool->RequestSetTransformAndParent( 
+          toolCalibratedTransform, this );
       }
-    ++inputItr;
     }
 
+  this->InvokeDeviceFrameEvents();
+
   this->InvokeEvent( TrackerUpdateStatusEvent() );  
 }
 
+/** Report a frame of the device and estimate its acquisition time */
+Tracker::TimePeriodType
+Tracker::ReportDeviceFrame( unsigned long frame, TimePeriodType arrivalTime )
+{
+  m_DeviceFrameClockLock.Lock();
+  m_DeviceFrameClock->AddFrame( frame, arrivalTime );
+  const TimePeriodType frameTime = m_DeviceFrameClock->GetFrameTime( frame );
+  m_DeviceFrameClockLock.Unlock();
+
+  return frameTime;
+}
+
+/** Acquisition time of a frame of the device */
+Tracker::TimePeriodType
+Tracker::GetDeviceFrameTime( unsigned long frame ) const
+{
+  m_DeviceFrameClockLock.Lock();
+  const TimePeriodType frameTime = m_DeviceFrameClock->GetFrameTime( frame );
+  m_DeviceFrameClockLock.Unlock();
+
+  return frameTime;
+}
+
+/** Counters of the frames of the device */
+unsigned long Tracker::GetNumberOfDroppedFrames() const
+{
+  m_DeviceFrameClockLock.Lock();
+  const unsigned long number = m_DeviceFrameClock->GetNumberOfDroppedFrames();
+  m_DeviceFrameClockLock.Unlock();
+  return number;
+}
+
+unsigned long Tracker::GetNumberOfDuplicatedFrames() const
+{
+  m_DeviceFrameClockLock.Lock();
+  const unsigned long number =
+    m_DeviceFrameClock->GetNumberOfDuplicatedFrames();
+  m_DeviceFrameClockLock.Unlock();
+  return number;
+}
+
+unsigned long Tracker::GetNumberOfOutOfOrderFrames() const
+{
+  m_DeviceFrameClockLock.Lock();
+  const unsigned long number =
+    m_DeviceFrameClock->GetNumberOfOutOfOrderFrames();
+  m_DeviceFrameClockLock.Unlock();
+  return number;
+}
+
+/** Invoke the events of the frames counted since the last update */
+void Tracker::InvokeDeviceFrameEvents( void )
+{
+  const unsigned long dropped = this->GetNumberOfDroppedFrames();
+  const unsigned long duplicated = this->GetNumberOfDuplicatedFrames();
+  const unsigned long outOfOrder = this->GetNumberOfOutOfOrderFrames();
+
+  if( dropped > m_ReportedDroppedFrames )
+    {
+    std::ostringstream message;
+    message << dropped - m_ReportedDroppedFrames << " frames dropped";
+    igstkLogMacro( WARNING, "igstk::Tracker: " << message.str() << "\n" );
+    TrackerFrameDroppedEvent event;
+    event.Set( message.str() );
+    m_ReportedDroppedFrames = dropped;
+    this->InvokeEvent( event );
+    }
+
+  if( duplicated > m_ReportedDuplicatedFrames )
+    {
+    std::ostringstream message;
+    message << duplicated - m_ReportedDuplicatedFrames
+            << " frames duplicated";
+    TrackerFrameDuplicatedEvent event;
+    event.Set( message.str() );
+    m_ReportedDuplicatedFrames = duplicated;
+    this->InvokeEvent( event );
+    }
+
+  if( outOfOrder > m_ReportedOutOfOrderFrames )
+    {
+    std::ostringstream message;
+    message << outOfOrder - m_ReportedOutOfOrderFrames
+            << " frames out of order";
+    igstkLogMacro( WARNING, "igstk::Tracker: " << message.str() << "\n" );
+    TrackerFrameOutOfOrderEvent event;
+    event.Set( message.str() );
+    m_ReportedOutOfOrderFrames = outOfOrder;
+    this->InvokeEvent( event );
+    }
+}
+
 /** This method is called when a UpdateStatus failed */
 void Tracker::UpdateStatusFailureProcessing( void )
 {
@@ -910,6 +1365,77 @@ void Tracker::DetachAllTrackerToolsFromTracker()
     }
 
   m_TrackerTools.clear();
+
+  m_TrackerToolSlots.clear();
+  m_RawTransformSlots.clear();
+  m_CalibrationTransformSlots.clear();
+  m_UpdatedSlots.clear();
+  m_ReferenceToolSlot = InvalidTrackerToolSlot;
+}
+
+/** Assign the first free slot to a tracker tool */
+Tracker::TrackerToolSlotType 
+Tracker::AddTrackerToolToSlots( TrackerToolType * trackerTool )
+{
+  TrackerToolSlotType slot = 
+    this->GetTrackerToolSlot( trackerTool->GetTrackerToolIdentifier() );
+
+  // otherwise, the first free slot is the one holding a NULL tool
+  if( slot == InvalidTrackerToolSlot )
+    {
+    slot = this->GetTrackerToolSlot( 
+                             static_cast< const TrackerToolType * >( NULL ) );
+    }
+
+  if( slot == InvalidTrackerToolSlot )
+    {
+    slot = this->GetNumberOfTrackerToolSlots();
+    m_TrackerToolSlots.push_back( NULL );
+    m_RawTransformSlots.push_back( TransformType() );
+    m_CalibrationTransformSlots.push_back( TransformType() );
+    m_UpdatedSlots.push_back( 0 );
+    }
+
+  m_TrackerToolSlots[slot] = trackerTool;
+  m_RawTransformSlots[slot] = trackerTool->GetRawTransform();
+  m_CalibrationTransformSlots[slot] = trackerTool->GetCalibrationTransform();
+  m_UpdatedSlots[slot] = 0;
+
+  // a reference tool attached again keeps being the reference
+  if( m_ApplyingReferenceTool && m_ReferenceTool.GetPointer() == trackerTool )
+    {
+    m_ReferenceToolSlot = slot;
+    }
+
+  return slot;
+}
+
+/** Release the slot of a tracker tool */
+void Tracker::RemoveTrackerToolFromSlots( const TrackerToolType * trackerTool )
+{
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if( slot == InvalidTrackerToolSlot )
+    {
+    return;
+    }
+
+  m_TrackerToolSlots[slot] = NULL;
+  m_UpdatedSlots[slot] = 0;
+
+  if( slot == m_ReferenceToolSlot )
+    {
+    m_ReferenceToolSlot = InvalidTrackerToolSlot;
+    }
+
+  // trim the free slots at the end, so that the update loops stay short
+  while( !m_TrackerToolSlots.empty() && m_TrackerToolSlots.back() == NULL )
+    {
+    m_TrackerToolSlots.pop_back();
+    m_RawTransformSlots.pop_back();
+    m_CalibrationTransformSlots.pop_back();
+    m_UpdatedSlots.pop_back();
+    }
 }
  
 /** The "CloseFromCommunicatingStateProcessing" method closes
@@ -972,6 +1498,25 @@ void Tracker::PrintSelf( std::ostream& os, itk::Indent indent ) const
     }
 
   os << indent << "ValidityTime: " << this->m_ValidityTime << std::endl;
+  os << indent << "ThreadPolicy: " << m_ThreadPolicy << std::endl;
+  os << indent << "TrackingThroughReactor: "
+     << this->GetTrackingThroughReactor() << std::endl;
+  os << indent << "TrackingLoopPacing: " << this->GetTrackingLoopPacing()
+     << std::endl;
+  os << indent << "TrackingLoopFrequency: "
+     << this->GetTrackingLoopFrequency() << std::endl;
+  os << indent << "NumberOfTrackingLoopReads: "
+     << this->GetNumberOfTrackingLoopReads() << std::endl;
+  os << indent << "NumberOfAvoidedReads: "
+     << this->GetNumberOfAvoidedReads() << std::endl;
+  os << indent << "CPUTimePerRead: " << this->GetCPUTimePerRead()
+     << std::endl;
+  os << indent << "NumberOfDroppedFrames: "
+     << this->GetNumberOfDroppedFrames() << std::endl;
+  os << indent << "NumberOfDuplicatedFrames: "
+     << this->GetNumberOfDuplicatedFrames() << std::endl;
+  os << indent << "NumberOfOutOfOrderFrames: "
+     << this->GetNumberOfOutOfOrderFrames() << std::endl;
   os << indent << "CoordinateSystemDelegator: ";
   this->m_CoordinateSystemDelegator->PrintSelf( os, indent );
 }
@@ -1033,8 +1578,10 @@ Tracker::ResultType
 Tracker::
 RequestRemoveTool( TrackerToolType * trackerTool )
 {
-  this->m_TrackerTools.erase( trackerTool->GetTrackerToolIdentifier() );
+  // the derived class may still need the slot of the tool
   this->RemoveTrackerToolFromInternalDataContainers( trackerTool ); 
+  this->RemoveTrackerToolFromSlots( trackerTool );
+  this->m_TrackerTools.erase( trackerTool->GetTrackerToolIdentifier() );
   return SUCCESS;
 }
 
@@ -1044,6 +1591,63 @@ Tracker::GetTrackerToolContainer() const
   return m_TrackerTools;
 }
 
+Tracker::TrackerToolSlotType 
+Tracker::GetTrackerToolSlot( const std::string & trackerToolIdentifier ) const
+{
+  TrackerToolsContainerType::const_iterator toolItr = 
+                                  m_TrackerTools.find( trackerToolIdentifier );
+
+  if( toolItr == m_TrackerTools.end() )
+    {
+    return InvalidTrackerToolSlot;
+    }
+
+  return this->GetTrackerToolSlot( toolItr->second );
+}
+
+Tracker::TrackerToolSlotType 
+Tracker::GetTrackerToolSlot( const TrackerToolType * trackerTool ) const
+{
+  const TrackerToolSlotType numberOfSlots = this->GetNumberOfTrackerToolSlots();
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
+    {
+    if( m_TrackerToolSlots[slot] == trackerTool )
+      {
+      return slot;
+      }
+    }
+  return InvalidTrackerToolSlot;
+}
+
+Tracker::TrackerToolSlotType 
+Tracker::GetNumberOfTrackerToolSlots() const
+{
+  return static_cast< TrackerToolSlotType >( m_TrackerToolSlots.size() );
+}
+
+Tracker::TrackerToolType * 
+Tracker::GetTrackerToolInSlot( TrackerToolSlotType slot ) const
+{
+  if( slot >= m_TrackerToolSlots.size() )
+    {
+    return NULL;
+    }
+  return m_TrackerToolSlots[slot];
+}
+
+/** Keep the calibration transform of an attached tool */
+void 
+Tracker::SetTrackerToolCalibrationTransform( 
+  const TrackerToolType * trackerTool, const TransformType & transform )
+{
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+
+  if( slot != InvalidTrackerToolSlot )
+    {
+    m_CalibrationTransformSlots[slot] = transform;
+    }
+}
+
 /** Thread function for tracking */
 ITK_THREAD_RETURN_TYPE Tracker::TrackingThreadFunction(void* pInfoStruct)
 {
@@ -1062,22 +1666,43 @@ ITK_THREAD_RETURN_TYPE Tracker::TrackingThreadFunction(void* pInfoStruct)
 
   Tracker *pTracker = (Tracker*)pInfo->UserData;
 
+  // the thread that starts tracking waits for the policy to be applied
+  const ThreadPolicy::SettingResultContainerType policyResults =
+    pTracker->m_ThreadPolicy.ApplyToCurrentThread();
+  pTracker->m_LockForThreadPolicy.Lock();
+  pTracker->m_ThreadPolicyResults = policyResults;
+  pTracker->m_ThreadPolicyApplied = true;
+  pTracker->m_ConditionThreadPolicyApplied->Signal();
+  pTracker->m_LockForThreadPolicy.Unlock();
+
   // counters for error rates
   unsigned long errorCount = 0;
   unsigned long totalCount = 0;
 
+  // start of the pacing, and of the processor time of the thread
+  pTracker->m_NextReadTime = RealTimeClock::GetTimeStamp();
+  pTracker->m_LastReadTime = 0.0;
+  const TimePeriodType startCPUTime = RealTimeClock::GetThreadCPUTime();
+
   int activeFlag = 1;
   while ( activeFlag )
     {
-    ResultType result = pTracker->InternalThreadedUpdateStatus();
-    pTracker->m_ConditionNextTransformReceived->Signal();
-    
-    totalCount++;
-    if (result != SUCCESS)
+    if( pTracker->WaitForNextRead() )
       {
-      errorCount++;
+      const TimePeriodType readStart = RealTimeClock::GetTimeStamp();
+      ResultType result = pTracker->InternalThreadedUpdateStatus();
+      pTracker->m_ConditionNextTransformReceived->Signal();
+      pTracker->AddTrackingLoopRead( readStart,
+                            RealTimeClock::GetTimeStamp() - readStart,
+                            RealTimeClock::GetThreadCPUTime() - startCPUTime );
+
+      totalCount++;
+      if (result != SUCCESS)
+        {
+        errorCount++;
+        }
       }
-      
+
     // check to see if we are being told to quit 
     pInfo->ActiveFlagLock->Lock();
     activeFlag = *pInfo->ActiveFlag;
@@ -1109,24 +1734,64 @@ Tracker::ReportTrackingToolVisible( TrackerToolType * trackerTool ) const
   trackerTool->RequestReportTrackingToolVisible();
 }
 
+/** Report to the tracker tool in a slot that the tool is not available */
+void 
+Tracker::ReportTrackingToolNotAvailable( TrackerToolSlotType slot ) const
+{
+  m_TrackerToolSlots[slot]->RequestReportTrackingToolNotAvailable();
+}
+
+/** Report to the tracker tool in a slot that the tool is Visible */
+void 
+Tracker::ReportTrackingToolVisible( TrackerToolSlotType slot ) const
+{
+  m_TrackerToolSlots[slot]->RequestReportTrackingToolVisible();
+}
+
 /** Set raw transform */
 void 
 Tracker::SetTrackerToolRawTransform( 
-  TrackerToolType * trackerTool, const TransformType transform )
+  TrackerToolType * trackerTool, const TransformType & transform )
 {
   igstkLogMacro( DEBUG, 
     "igstk::Tracker::SetTrackerToolRawTransform called...\n");
-  trackerTool->SetRawTransform( transform );
+
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+  if( slot != InvalidTrackerToolSlot )
+    {
+    this->SetTrackerToolRawTransform( slot, transform );
+    }
+}
+
+/** Set raw transform of the tracker tool in a slot */
+void 
+Tracker::SetTrackerToolRawTransform( 
+  TrackerToolSlotType slot, const TransformType & transform )
+{
+  m_RawTransformSlots[slot] = transform;
 }
 
 /** Turn on/off update flag of the tracker tool */
 void 
 Tracker::SetTrackerToolTransformUpdate( 
-  TrackerToolType * trackerTool, bool flag ) const
+  TrackerToolType * trackerTool, bool flag )
 {
   igstkLogMacro( DEBUG, 
      "igstk::Tracker::SetTrackerToolTransformUpdate called...\n");
-  trackerTool->SetUpdated( flag ); 
+
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+  if( slot != InvalidTrackerToolSlot )
+    {
+    this->SetTrackerToolTransformUpdate( slot, flag );
+    }
+}
+
+/** Turn on/off update flag of the tracker tool in a slot */
+void 
+Tracker::SetTrackerToolTransformUpdate( TrackerToolSlotType slot, bool flag )
+{
+  m_UpdatedSlots[slot] = flag;
+  m_TrackerToolSlots[slot]->SetUpdated( flag ); 
 }
 
 /** Report invalid request */
@@ -30,6 +30,9 @@
 #include "igstkTransform.h"
 #include "igstkPulseGenerator.h"
 #include "igstkTrackerTool.h"
+#include "igstkDeviceFrameClock.h"
+#include "igstkThreadPolicy.h"
+#include "igstkCommunicationReactor.h"
 
 #include "igstkCoordinateSystemInterfaceMacros.h"
 
@@ -60,6 +63,10 @@ igstkEventMacro( TrackerUpdateStatusErrorEvent,            TrackerErrorEvent);
 
 igstkEventMacro( TrackerToolTransformUpdateEvent,          TrackerEvent);
 
+igstkEventMacro( TrackerFrameDroppedEvent,                 TrackerEvent);
+igstkEventMacro( TrackerFrameDuplicatedEvent,              TrackerEvent);
+igstkEventMacro( TrackerFrameOutOfOrderEvent,              TrackerEvent);
+
 
 /** \class Tracker
  *  \brief Abstract superclass for concrete IGSTK Tracker classes.
@@ -144,6 +151,69 @@ public:
   /** GetThreadingEnabled(bool) : get m_ThreadingEnabled value  */
   igstkGetMacro( ThreadingEnabled, bool );
 
+  /** Scheduling, placement and memory settings of the tracking thread.
+   *  The policy is applied by the thread when it is spawned, as tracking
+   *  starts, and a ThreadPolicyEvent or ThreadPolicyErrorEvent is invoked
+   *  for each of its settings. It has no effect when threading is not
+   *  enabled. */
+  void SetThreadPolicy( const ThreadPolicy & policy );
+  const ThreadPolicy & GetThreadPolicy() const;
+
+  /** Receive the replies of the device through a CommunicationReactor,
+   *  which serves many devices from a single thread, instead of through
+   *  a tracking thread of its own. This takes effect when tracking
+   *  starts, if threading is enabled and the tracker supports it: see
+   *  GetReactorCommunication(). Otherwise, the tracking thread is used.
+   *  Set a NULL reactor to use the tracking thread again. */
+  void SetCommunicationReactor( CommunicationReactor * reactor );
+
+  /** Whether the tracker receives its replies through the reactor */
+  bool GetTrackingThroughReactor() const;
+
+  /** Pacing of the tracking thread between two reads of the device.
+   *  Unpaced reads again as soon as a read returns, which is the default
+   *  and suits the devices whose read blocks until new data arrive.
+   *  FixedRate reads at the tracking loop frequency, on absolute deadlines.
+   *  DeviceRate reads when the next frame of the device is expected, from
+   *  the frame numbers reported by the tracker, and falls back to the
+   *  fixed rate until the frame period is known. NewData waits for the
+   *  device to signal new data, and falls back to the device rate when
+   *  the tracker cannot wait. The pacing has no effect when threading is
+   *  not enabled. */
+  typedef enum
+    {
+    UnpacedTrackingLoop,
+    FixedRateTrackingLoop,
+    DeviceRateTrackingLoop,
+    NewDataTrackingLoop
+    } TrackingLoopPacingType;
+
+  void SetTrackingLoopPacing( TrackingLoopPacingType pacing );
+  TrackingLoopPacingType GetTrackingLoopPacing() const;
+
+  /** Frequency of the fixed rate pacing, 100 Hz by default */
+  void SetTrackingLoopFrequency( double frequencyInHz );
+  double GetTrackingLoopFrequency() const;
+
+  /** Counters of the tracking thread since tracking started: the reads of
+   *  the device, the reads avoided by the pacing, and the processor time
+   *  of the thread per read, in milliseconds. The avoided reads are counted
+   *  when the device reports that it has no new data, and estimated from
+   *  the time spent waiting and the average duration of a read otherwise. */
+  unsigned long GetNumberOfTrackingLoopReads() const;
+  unsigned long GetNumberOfAvoidedReads() const;
+  double GetCPUTimePerRead() const;
+
+  /** Counters of the frames numbered by the device since tracking started:
+   *  the frames skipped, received twice, or received after a newer one.
+   *  A TrackerFrameDroppedEvent, TrackerFrameDuplicatedEvent or
+   *  TrackerFrameOutOfOrderEvent is invoked at the update of the status
+   *  after the counter increased. The counters stay at zero for the
+   *  trackers that do not report the frame numbers of the device. */
+  unsigned long GetNumberOfDroppedFrames() const;
+  unsigned long GetNumberOfDuplicatedFrames() const;
+  unsigned long GetNumberOfOutOfOrderFrames() const;
+
 protected:
 
   Tracker(void);
@@ -202,6 +272,32 @@ protected:
       and responsible for device-specific processing */
   virtual ResultType InternalThreadedUpdateStatus( void ) = 0;
 
+  /** Outcome of waiting for new data in the tracking thread */
+  typedef enum
+    {
+    NEW_DATA,
+    NO_NEW_DATA,
+    NEW_DATA_NOT_SUPPORTED
+    } NewDataResultType;
+
+  /** The "InternalThreadedWaitForNewData" method waits until the device
+      has new data, or the timeout in milliseconds expires. It is called
+      in the tracking thread with the NewData pacing, before
+      InternalThreadedUpdateStatus. It is to be overridden by the
+      descendant classes whose device can signal new data: by default,
+      it is not supported. */
+  virtual NewDataResultType InternalThreadedWaitForNewData(
+                                              TimePeriodType timeout );
+
+  /** The "GetReactorCommunication" method returns the communication
+      whose replies are to be processed by InternalThreadedUpdateStatus,
+      called in the thread of a CommunicationReactor each time a complete
+      reply has been received. This suits the devices that send their
+      data without being asked, e.g. in a streaming mode, and that read
+      it with the Read() of their communication. By default, it returns
+      NULL: the tracker needs a tracking thread of its own. */
+  virtual Communication * GetReactorCommunication( void );
+
   /** Print the object information in a stream. */
   virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const; 
 
@@ -242,22 +338,52 @@ protected:
 
   /** Access method for the tracker tool container. This method 
     * is useful in the derived classes to access the unique identifiers 
-    * of the tracker tools */
+    * of the tracker tools. It is meant for configuration: the update
+    * loops should iterate over the tracker tool slots instead. */
   const TrackerToolsContainerType & GetTrackerToolContainer() const;
 
+  /** Index of an attached tracker tool. Every tracker tool is assigned a
+    * slot when it is attached, and keeps it until it is detached. The slots
+    * are dense, starting at zero, and the slots of detached tools are
+    * reused, so that the derived classes can keep their per tool data in
+    * arrays indexed by slot. */
+  typedef unsigned int     TrackerToolSlotType;
+
+  /** Slot returned for a tracker tool that is not attached */
+  static const TrackerToolSlotType InvalidTrackerToolSlot;
+
+  /** Slot of an attached tracker tool, from its identifier or pointer. These
+    * lookups are meant for configuration, e.g. in 
+    * AddTrackerToolToInternalDataContainers(). */
+  TrackerToolSlotType GetTrackerToolSlot( 
+                       const std::string & trackerToolIdentifier ) const;
+  TrackerToolSlotType GetTrackerToolSlot( 
+                       const TrackerToolType * trackerTool ) const;
+
+  /** Number of slots, including the free slots of detached tools. */
+  TrackerToolSlotType GetNumberOfTrackerToolSlots() const;
+
+  /** Tracker tool attached in a slot, or NULL if the slot is free */
+  TrackerToolType * GetTrackerToolInSlot( TrackerToolSlotType slot ) const;
+
   /** Report to tracker tool that it is not available for tracking */
   void ReportTrackingToolNotAvailable( TrackerToolType * trackerTool ) const;
+  void ReportTrackingToolNotAvailable( TrackerToolSlotType slot ) const;
 
   /** Report to tracker tool that it is visible */
   void ReportTrackingToolVisible( TrackerToolType * trackerTool ) const;
+  void ReportTrackingToolVisible( TrackerToolSlotType slot ) const;
 
   /** Set tracker tool raw transform */
   void SetTrackerToolRawTransform( TrackerToolType * trackerTool, 
-                                   const TransformType transform );
+                                   const TransformType & transform );
+  void SetTrackerToolRawTransform( TrackerToolSlotType slot,
+                                   const TransformType & transform );
 
   /** Turn on/off update flag of the tracker tool */
   void SetTrackerToolTransformUpdate( TrackerToolType * trackerTool,
-                                      bool flag ) const;
+                                      bool flag );
+  void SetTrackerToolTransformUpdate( TrackerToolSlotType slot, bool flag );
 
   /** Depending on the tracker type, the tracking thread should be 
     * terminated or left untouched when we stop tracking. For example,
@@ -276,6 +402,19 @@ protected:
   /** Exit tracking after terminating tracking thread */
   void ExitTrackingTerminatingTrackingThread();
 
+  /** Report the number of a frame read from the device, and the host time
+    * at which it arrived. Returns the acquisition time of the frame,
+    * estimated by a DeviceFrameClock, to be used as the start time of
+    * the transforms measured in the frame. Meant to be called once per
+    * reply of the device in InternalThreadedUpdateStatus(). */
+  TimePeriodType ReportDeviceFrame( unsigned long frame,
+                                    TimePeriodType arrivalTime );
+
+  /** Acquisition time of a frame, estimated from the frames reported so
+    * far, e.g. for the tools of a reply that were measured in an older
+    * frame than the one reported. */
+  TimePeriodType GetDeviceFrameTime( unsigned long frame ) const;
+
 
 private:
   Tracker(const Self&);           //purposely not implemented
@@ -291,6 +430,17 @@ private:
   // An associative container of TrackerTool Pointer with 
   // TrackerTool identifier used as a Key
   TrackerToolsContainerType           m_TrackerTools;
+
+  /** Per slot storage of the attached tracker tools. All the vectors have
+   *  GetNumberOfTrackerToolSlots() elements. */
+  typedef std::vector< TrackerToolType * >   TrackerToolSlotContainerType;
+  typedef std::vector< TransformType >       TransformSlotContainerType;
+  typedef std::vector< unsigned char >       FlagSlotContainerType;
+
+  TrackerToolSlotContainerType        m_TrackerToolSlots;
+  TransformSlotContainerType          m_RawTransformSlots;
+  TransformSlotContainerType          m_CalibrationTransformSlots;
+  FlagSlotContainerType               m_UpdatedSlots;
   
   /** typedefs from TrackerTool class */
   typedef TrackerToolType::Pointer                   TrackerToolPointer;
@@ -298,6 +448,7 @@ private:
   /** The reference tool */
   bool                                m_ApplyingReferenceTool;
   TrackerToolPointer                  m_ReferenceTool;
+  TrackerToolSlotType                 m_ReferenceToolSlot;
 
   /** Validity time, and its default value [milliseconds] */
   TimePeriodType                      m_ValidityTime;
@@ -316,6 +467,64 @@ private:
   /** Tracking ThreadID */
   int                             m_ThreadID;
 
+  /** Mapping of the frames of the device to the host clock, updated by
+   *  the tracking thread, and the counters already reported by events */
+  DeviceFrameClock::Pointer       m_DeviceFrameClock;
+  mutable itk::SimpleMutexLock    m_DeviceFrameClockLock;
+  unsigned long                   m_ReportedDroppedFrames;
+  unsigned long                   m_ReportedDuplicatedFrames;
+  unsigned long                   m_ReportedOutOfOrderFrames;
+
+  /** Invoke the events of the frames dropped, duplicated or out of order
+   *  since the last update */
+  void InvokeDeviceFrameEvents( void );
+
+  /** Pacing of the tracking loop. The settings and counters are shared
+   *  with the tracking thread under the lock, the times of the reads are
+   *  only used by the tracking thread. */
+  TrackingLoopPacingType          m_TrackingLoopPacing;
+  double                          m_TrackingLoopFrequency;
+  unsigned long                   m_NumberOfTrackingLoopReads;
+  double                          m_NumberOfAvoidedReads;
+  TimePeriodType                  m_TrackingLoopReadDuration;
+  TimePeriodType                  m_TrackingLoopCPUTime;
+  mutable itk::SimpleMutexLock    m_TrackingLoopLock;
+  TimePeriodType                  m_NextReadTime;
+  TimePeriodType                  m_LastReadTime;
+
+  /** Wait, in the tracking thread, until the device should be read.
+   *  Returns false if the device has no new data. */
+  bool WaitForNextRead( void );
+
+  /** Account, in the tracking thread, for a read of the device */
+  void AddTrackingLoopRead( TimePeriodType start, TimePeriodType duration,
+                            TimePeriodType cpuTime );
+
+  /** Reactor used instead of the tracking thread, the communication
+   *  that was added to it while tracking, and the handler that updates
+   *  the status when a reply was received */
+  class ReactorHandler;
+  friend class ReactorHandler;
+  CommunicationReactor::Pointer   m_CommunicationReactor;
+  Communication *                 m_ReactorCommunication;
+  ReactorHandler *                m_ReactorHandler;
+
+  /** Add the communication to the reactor, and remove it */
+  bool AttachToCommunicationReactor( void );
+  void DetachFromCommunicationReactor( void );
+
+  /** Policy of the tracking thread, and the outcome of its settings,
+   *  handed over by the thread when it starts */
+  ThreadPolicy                                m_ThreadPolicy;
+  ThreadPolicy::SettingResultContainerType    m_ThreadPolicyResults;
+  bool                                        m_ThreadPolicyApplied;
+  itk::ConditionVariable::Pointer             m_ConditionThreadPolicyApplied;
+  itk::SimpleMutexLock                        m_LockForThreadPolicy;
+
+  /** Wait until the tracking thread applied its policy, and invoke the
+   *  events of the settings */
+  void WaitForThreadPolicy( void );
+
   /** itk::ConditionVariable object pointer to signal for the next
    *  transform */
   itk::ConditionVariable::Pointer m_ConditionNextTransformReceived;
@@ -455,6 +664,16 @@ private:
   /** Detach all tracker tools from the tracker */
   void DetachAllTrackerToolsFromTracker();
 
+  /** Assign a slot to a tracker tool that is being attached, and release
+   *  the slot of a tracker tool that is being removed */
+  TrackerToolSlotType AddTrackerToolToSlots( TrackerToolType * trackerTool );
+  void RemoveTrackerToolFromSlots( const TrackerToolType * trackerTool );
+
+  /** Keep the calibration transform of an attached tracker tool. This
+   *  method is called by the tracker tool. */
+  void SetTrackerToolCalibrationTransform( const TrackerToolType * trackerTool,
+                                           const TransformType & transform );
+
   /** Report invalid request */ 
   void ReportInvalidRequestProcessing( void );
 
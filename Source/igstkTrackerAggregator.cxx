@@ -0,0 +1,888 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerAggregator.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkTrackerAggregator.h"
+#include "igstkRealTimeClock.h"
+
+#include <math.h>
+
+namespace igstk
+{
+
+namespace
+{
+
+/** Number of samples kept for every source tool */
+const unsigned int NumberOfSamplesPerTool = 16;
+
+/** Rate at which the clock offset is allowed to increase, to follow the
+ *  drift between the clock of a device and the RealTimeClock [ms/ms] */
+const double ClockDriftRate = 1e-4;
+
+/** Weight of a new sample in the mean transport delay */
+const double TransportDelayWeight = 0.05;
+
+/** Number of positions kept for the latency estimation of every source
+ *  tracker */
+const unsigned int NumberOfMotionSamplesPerTracker = 256;
+
+/** Period of the latency estimation [ms] */
+const double LatencyEstimationPeriod = 500.0;
+
+/** Largest latency difference searched between a source tracker and the
+ *  latency reference tracker [ms] */
+const int MaximumLatencyDifference = 200;
+
+/** Interval over which the speed of a tool is measured [ms] */
+const double SpeedInterval = 20.0;
+
+/** Interval between the correlated speeds of the reference tracker [ms] */
+const unsigned int CorrelationStep = 5;
+
+/** Smallest correlation between the speeds for a latency estimate to be
+ *  accepted */
+const double MinimumLatencyCorrelation = 0.9;
+
+/** Weight of a new estimate in the latency */
+const double LatencyEstimateWeight = 0.5;
+
+}
+
+
+TrackerAggregator::TrackerAggregator():m_StateMachine(this)
+{
+  // The aggregator only processes the samples delivered by the source
+  // trackers, in the thread of the pulse generators.
+  this->SetThreadingEnabled( false );
+
+  m_MaximumSampleAge = 250.0;
+  m_LastAlignmentTime = 0.0;
+
+  m_HasLatencyReference = false;
+  m_LatencyReferenceIndex = 0;
+  m_LastLatencyEstimationTime = 0.0;
+}
+
+TrackerAggregator::~TrackerAggregator()
+{
+  for( unsigned int slot = 0; slot < m_SourceToolSlots.size(); slot++ )
+    {
+    SourceToolType * sourceTool = m_SourceToolSlots[slot];
+    if( sourceTool )
+      {
+      sourceTool->m_SourceTrackerTool->GetCalibratedTransformChannel()
+                                 .RemoveObserver( sourceTool->m_ObserverTag );
+      delete sourceTool;
+      }
+    }
+}
+
+void TrackerAggregator::AddTracker( Tracker * tracker )
+{
+  igstkLogMacro( DEBUG, "igstk::TrackerAggregator::AddTracker called ...\n");
+
+  if( !tracker || tracker == this ||
+      this->FindSourceTracker( tracker ) < m_SourceTrackers.size() )
+    {
+    igstkLogMacro( WARNING, "igstk::TrackerAggregator::AddTracker: "
+                   "invalid or already added tracker\n" );
+    return;
+    }
+
+  SourceTrackerType sourceTracker;
+  sourceTracker.m_Tracker = tracker;
+  sourceTracker.m_RegistrationTransform.SetToIdentity(
+                                  TimeStamp::GetLongestPossibleTime() );
+  sourceTracker.m_Latency = 0.0;
+  sourceTracker.m_LatencySetByUser = false;
+  sourceTracker.m_LatencyEstimated = false;
+  sourceTracker.m_UsesDeviceClock = false;
+  sourceTracker.m_ClockOffsetInitialized = false;
+  sourceTracker.m_ClockOffset = 0.0;
+  sourceTracker.m_TransportDelay = 0.0;
+  sourceTracker.m_LastArrivalTime = 0.0;
+  sourceTracker.m_LatestSampleTime = 0.0;
+  sourceTracker.m_MotionTool = NULL;
+  sourceTracker.m_Motion.resize( NumberOfMotionSamplesPerTracker );
+  sourceTracker.m_NextMotionSample = 0;
+  sourceTracker.m_NumberOfMotionSamples = 0;
+
+  m_SourceTrackers.push_back( sourceTracker );
+}
+
+void TrackerAggregator::SetTrackerRegistrationTransform(
+                                          const Tracker * tracker,
+                                          const TransformType & transform )
+{
+  const unsigned int index = this->FindSourceTracker( tracker );
+  if( index == m_SourceTrackers.size() )
+    {
+    igstkLogMacro( WARNING, "igstk::TrackerAggregator::"
+                   "SetTrackerRegistrationTransform: unknown tracker\n" );
+    return;
+    }
+  m_SourceTrackers[index].m_RegistrationTransform.ImportTransform(
+                                                                 transform );
+}
+
+void TrackerAggregator::SetTrackerLatency( const Tracker * tracker,
+                                           TimePeriodType latency )
+{
+  const unsigned int index = this->FindSourceTracker( tracker );
+  if( index == m_SourceTrackers.size() )
+    {
+    igstkLogMacro( WARNING, "igstk::TrackerAggregator::"
+                   "SetTrackerLatency: unknown tracker\n" );
+    return;
+    }
+  m_SourceTrackers[index].m_Latency = latency;
+  m_SourceTrackers[index].m_LatencySetByUser = true;
+}
+
+TrackerAggregator::TimePeriodType
+TrackerAggregator::GetTrackerLatency( const Tracker * tracker ) const
+{
+  const unsigned int index = this->FindSourceTracker( tracker );
+  if( index == m_SourceTrackers.size() )
+    {
+    return 0.0;
+    }
+  return m_SourceTrackers[index].m_Latency;
+}
+
+void TrackerAggregator::SetLatencyReferenceTracker( const Tracker * tracker )
+{
+  const unsigned int index = this->FindSourceTracker( tracker );
+  if( index == m_SourceTrackers.size() )
+    {
+    igstkLogMacro( WARNING, "igstk::TrackerAggregator::"
+                   "SetLatencyReferenceTracker: unknown tracker\n" );
+    return;
+    }
+  m_HasLatencyReference = true;
+  m_LatencyReferenceIndex = index;
+}
+
+void TrackerAggregator::SetTrackerUsesDeviceClock( const Tracker * tracker,
+                                                   bool deviceClock )
+{
+  const unsigned int index = this->FindSourceTracker( tracker );
+  if( index == m_SourceTrackers.size() )
+    {
+    igstkLogMacro( WARNING, "igstk::TrackerAggregator::"
+                   "SetTrackerUsesDeviceClock: unknown tracker\n" );
+    return;
+    }
+  m_SourceTrackers[index].m_UsesDeviceClock = deviceClock;
+  m_SourceTrackers[index].m_ClockOffsetInitialized = false;
+  m_SourceTrackers[index].m_ClockOffset = 0.0;
+}
+
+TrackerAggregator::TimePeriodType
+TrackerAggregator::GetTrackerClockOffset( const Tracker * tracker ) const
+{
+  const unsigned int index = this->FindSourceTracker( tracker );
+  if( index == m_SourceTrackers.size() )
+    {
+    return 0.0;
+    }
+  return m_SourceTrackers[index].m_ClockOffset;
+}
+
+TrackerAggregator::TimePeriodType
+TrackerAggregator::GetTrackerTransportDelay( const Tracker * tracker ) const
+{
+  const unsigned int index = this->FindSourceTracker( tracker );
+  if( index == m_SourceTrackers.size() )
+    {
+    return 0.0;
+    }
+  return m_SourceTrackers[index].m_TransportDelay;
+}
+
+unsigned int
+TrackerAggregator::FindSourceTracker( const Tracker * tracker ) const
+{
+  unsigned int index = 0;
+  while( index < m_SourceTrackers.size() &&
+         m_SourceTrackers[index].m_Tracker.GetPointer() != tracker )
+    {
+    index++;
+    }
+  return index;
+}
+
+TrackerAggregator::ResultType TrackerAggregator::InternalOpen( void )
+{
+  igstkLogMacro( DEBUG, "igstk::TrackerAggregator::InternalOpen called ...\n");
+
+  if( m_SourceTrackers.empty() )
+    {
+    igstkLogMacro( CRITICAL, "igstk::TrackerAggregator::InternalOpen: "
+                   "no tracker has been added\n" );
+    return FAILURE;
+    }
+  return SUCCESS;
+}
+
+TrackerAggregator::ResultType TrackerAggregator::InternalStartTracking( void )
+{
+  igstkLogMacro( DEBUG,
+    "igstk::TrackerAggregator::InternalStartTracking called ...\n");
+
+  this->ClearSamples();
+
+  for( unsigned int i = 0; i < m_SourceTrackers.size(); i++ )
+    {
+    m_SourceTrackers[i].m_Tracker->RequestStartTracking();
+    }
+  return SUCCESS;
+}
+
+TrackerAggregator::ResultType TrackerAggregator::InternalReset( void )
+{
+  igstkLogMacro( DEBUG,
+    "igstk::TrackerAggregator::InternalReset called ...\n");
+
+  this->ClearSamples();
+
+  for( unsigned int i = 0; i < m_SourceTrackers.size(); i++ )
+    {
+    m_SourceTrackers[i].m_ClockOffsetInitialized = false;
+    }
+  return SUCCESS;
+}
+
+TrackerAggregator::ResultType TrackerAggregator::InternalStopTracking( void )
+{
+  igstkLogMacro( DEBUG,
+    "igstk::TrackerAggregator::InternalStopTracking called ...\n");
+
+  for( unsigned int i = 0; i < m_SourceTrackers.size(); i++ )
+    {
+    m_SourceTrackers[i].m_Tracker->RequestStopTracking();
+    }
+  return SUCCESS;
+}
+
+TrackerAggregator::ResultType TrackerAggregator::InternalClose( void )
+{
+  igstkLogMacro( DEBUG,
+    "igstk::TrackerAggregator::InternalClose called ...\n");
+
+  // The source trackers are opened and closed by the application
+  return SUCCESS;
+}
+
+TrackerAggregator::ResultType TrackerAggregator
+::VerifyTrackerToolInformation( const TrackerToolType * trackerTool )
+{
+  igstkLogMacro( DEBUG, "igstk::TrackerAggregator::"
+                 "VerifyTrackerToolInformation called ...\n");
+
+  const AggregatedTrackerTool * aggregatedTrackerTool =
+              dynamic_cast< const AggregatedTrackerTool * >( trackerTool );
+
+  if( !aggregatedTrackerTool )
+    {
+    igstkLogMacro( CRITICAL, "igstk::TrackerAggregator::"
+                   "VerifyTrackerToolInformation: only AggregatedTrackerTool "
+                   "objects can be attached\n" );
+    return FAILURE;
+    }
+
+  if( this->FindSourceTracker( aggregatedTrackerTool->GetSourceTracker() ) ==
+      m_SourceTrackers.size() )
+    {
+    igstkLogMacro( CRITICAL, "igstk::TrackerAggregator::"
+                   "VerifyTrackerToolInformation: the source tracker of "
+                   << aggregatedTrackerTool->GetToolName()
+                   << " has not been added\n" );
+    return FAILURE;
+    }
+
+  return SUCCESS;
+}
+
+TrackerAggregator::ResultType TrackerAggregator
+::AddTrackerToolToInternalDataContainers( const TrackerToolType * trackerTool )
+{
+  igstkLogMacro( DEBUG, "igstk::TrackerAggregator::"
+                 "AddTrackerToolToInternalDataContainers called ...\n");
+
+  const AggregatedTrackerTool * aggregatedTrackerTool =
+              dynamic_cast< const AggregatedTrackerTool * >( trackerTool );
+
+  if( !aggregatedTrackerTool )
+    {
+    return FAILURE;
+    }
+
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+  if( slot >= m_SourceToolSlots.size() )
+    {
+    m_SourceToolSlots.resize( slot + 1, NULL );
+    }
+
+  SourceToolType * sourceTool = new SourceToolType;
+  sourceTool->m_Aggregator = this;
+  sourceTool->m_SourceTrackerIndex =
+    this->FindSourceTracker( aggregatedTrackerTool->GetSourceTracker() );
+  sourceTool->m_SourceTrackerTool =
+                               aggregatedTrackerTool->GetSourceTrackerTool();
+  sourceTool->m_Samples.resize( NumberOfSamplesPerTool );
+  sourceTool->m_NextSample = 0;
+  sourceTool->m_NumberOfSamples = 0;
+  sourceTool->m_ObserverTag =
+    sourceTool->m_SourceTrackerTool->GetCalibratedTransformChannel()
+      .AddObserver( sourceTool, &TrackerAggregator::SourceTransformCallback );
+
+  m_SourceToolSlots[slot] = sourceTool;
+
+  return SUCCESS;
+}
+
+TrackerAggregator::ResultType TrackerAggregator
+::RemoveTrackerToolFromInternalDataContainers(
+                                         const TrackerToolType * trackerTool )
+{
+  igstkLogMacro( DEBUG, "igstk::TrackerAggregator::"
+                 "RemoveTrackerToolFromInternalDataContainers called ...\n");
+
+  const TrackerToolSlotType slot = this->GetTrackerToolSlot( trackerTool );
+  if( slot >= m_SourceToolSlots.size() || !m_SourceToolSlots[slot] )
+    {
+    return FAILURE;
+    }
+
+  SourceToolType * sourceTool = m_SourceToolSlots[slot];
+  sourceTool->m_SourceTrackerTool->GetCalibratedTransformChannel()
+                                 .RemoveObserver( sourceTool->m_ObserverTag );
+
+  SourceTrackerType & sourceTracker =
+                        m_SourceTrackers[sourceTool->m_SourceTrackerIndex];
+  if( sourceTracker.m_MotionTool == sourceTool )
+    {
+    sourceTracker.m_MotionTool = NULL;
+    sourceTracker.m_NextMotionSample = 0;
+    sourceTracker.m_NumberOfMotionSamples = 0;
+    }
+
+  delete sourceTool;
+  m_SourceToolSlots[slot] = NULL;
+
+  return SUCCESS;
+}
+
+void TrackerAggregator::SourceTransformCallback( void * sourceTool,
+                             const CoordinateSystemTransformToResult & result )
+{
+  SourceToolType * tool = static_cast< SourceToolType * >( sourceTool );
+  tool->m_Aggregator->AddSample( *tool, result.GetTransform() );
+}
+
+void TrackerAggregator::AddSample( SourceToolType & sourceTool,
+                                   const TransformType & transform )
+{
+  SourceTrackerType & sourceTracker =
+                        m_SourceTrackers[sourceTool.m_SourceTrackerIndex];
+
+  // Clock model. The time stamps of the trackers are in RealTimeClock
+  // time, unless the tracker uses the clock of the device: the smallest
+  // delay between the time stamp of a sample and its arrival is then the
+  // offset between the two clocks. The excess is transport delay.
+  const TimePeriodType arrivalTime = RealTimeClock::GetTimeStamp();
+  const TimePeriodType delay = arrivalTime - transform.GetStartTime();
+
+  if( !sourceTracker.m_ClockOffsetInitialized )
+    {
+    sourceTracker.m_ClockOffset =
+                             sourceTracker.m_UsesDeviceClock ? delay : 0.0;
+    sourceTracker.m_TransportDelay = delay - sourceTracker.m_ClockOffset;
+    sourceTracker.m_ClockOffsetInitialized = true;
+    }
+  else
+    {
+    if( sourceTracker.m_UsesDeviceClock )
+      {
+      sourceTracker.m_ClockOffset += ClockDriftRate *
+                        ( arrivalTime - sourceTracker.m_LastArrivalTime );
+      if( delay < sourceTracker.m_ClockOffset )
+        {
+        sourceTracker.m_ClockOffset = delay;
+        }
+      }
+    sourceTracker.m_TransportDelay += TransportDelayWeight *
+      ( delay - sourceTracker.m_ClockOffset - sourceTracker.m_TransportDelay );
+    }
+  sourceTracker.m_LastArrivalTime = arrivalTime;
+
+  // The latency is corrected when the samples are used, since its
+  // estimate changes over time
+  TimePeriodType sampleTime = transform.GetStartTime() +
+                              sourceTracker.m_ClockOffset;
+
+  // Keep the history ordered when the clock offset decreases
+  const unsigned int numberOfSamples = sourceTool.m_Samples.size();
+  if( sourceTool.m_NumberOfSamples > 0 )
+    {
+    const unsigned int latest = ( sourceTool.m_NextSample +
+                                  numberOfSamples - 1 ) % numberOfSamples;
+    if( sampleTime < sourceTool.m_Samples[latest].m_StartTime )
+      {
+      sampleTime = sourceTool.m_Samples[latest].m_StartTime;
+      }
+    }
+
+  RigidTransform & sample = sourceTool.m_Samples[sourceTool.m_NextSample];
+  sample.ImportTransform( transform );
+  sample.m_StartTime = sampleTime;
+
+  sourceTool.m_NextSample = ( sourceTool.m_NextSample + 1 ) % numberOfSamples;
+  if( sourceTool.m_NumberOfSamples < numberOfSamples )
+    {
+    sourceTool.m_NumberOfSamples++;
+    }
+
+  if( sampleTime > sourceTracker.m_LatestSampleTime )
+    {
+    sourceTracker.m_LatestSampleTime = sampleTime;
+    }
+
+  // The first tool of the tracker drives the latency estimation
+  if( sourceTracker.m_MotionTool == NULL )
+    {
+    sourceTracker.m_MotionTool = &sourceTool;
+    }
+  if( sourceTracker.m_MotionTool == &sourceTool )
+    {
+    const unsigned int numberOfMotionSamples = sourceTracker.m_Motion.size();
+    MotionSampleType & motionSample =
+                  sourceTracker.m_Motion[sourceTracker.m_NextMotionSample];
+    motionSample.m_Time = sampleTime;
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      motionSample.m_Position[i] = sample.m_Translation[i];
+      }
+    sourceTracker.m_NextMotionSample =
+      ( sourceTracker.m_NextMotionSample + 1 ) % numberOfMotionSamples;
+    if( sourceTracker.m_NumberOfMotionSamples < numberOfMotionSamples )
+      {
+      sourceTracker.m_NumberOfMotionSamples++;
+      }
+    }
+}
+
+bool TrackerAggregator::InterpolateSample( const SourceToolType & sourceTool,
+                                           TimePeriodType time,
+                                           TimePeriodType oldestValidTime,
+                                           RigidTransform & sample ) const
+{
+  const unsigned int numberOfSamples = sourceTool.m_Samples.size();
+  unsigned int later = ( sourceTool.m_NextSample +
+                         numberOfSamples - 1 ) % numberOfSamples;
+
+  if( sourceTool.m_NumberOfSamples == 0 ||
+      sourceTool.m_Samples[later].m_StartTime < oldestValidTime )
+    {
+    return false;
+    }
+
+  // The tool was not seen since the alignment time: hold its latest sample
+  if( sourceTool.m_Samples[later].m_StartTime <= time )
+    {
+    sample = sourceTool.m_Samples[later];
+    return true;
+    }
+
+  for( unsigned int i = 1; i < sourceTool.m_NumberOfSamples; i++ )
+    {
+    const unsigned int earlier = ( later + numberOfSamples - 1 ) %
+                                 numberOfSamples;
+    const RigidTransform & first = sourceTool.m_Samples[earlier];
+    const RigidTransform & second = sourceTool.m_Samples[later];
+
+    if( first.m_StartTime <= time )
+      {
+      const TimePeriodType period = second.m_StartTime - first.m_StartTime;
+      const double weight = ( period > 0.0 ) ?
+                            ( time - first.m_StartTime ) / period : 1.0;
+      RigidTransform::Interpolate( first, second, weight, sample );
+      return true;
+      }
+    later = earlier;
+    }
+
+  // The alignment time is older than the history: use the oldest sample
+  sample = sourceTool.m_Samples[later];
+  return true;
+}
+
+void TrackerAggregator::ClearSamples()
+{
+  for( unsigned int slot = 0; slot < m_SourceToolSlots.size(); slot++ )
+    {
+    if( m_SourceToolSlots[slot] )
+      {
+      m_SourceToolSlots[slot]->m_NextSample = 0;
+      m_SourceToolSlots[slot]->m_NumberOfSamples = 0;
+      }
+    }
+
+  for( unsigned int i = 0; i < m_SourceTrackers.size(); i++ )
+    {
+    m_SourceTrackers[i].m_LatestSampleTime = 0.0;
+    m_SourceTrackers[i].m_NextMotionSample = 0;
+    m_SourceTrackers[i].m_NumberOfMotionSamples = 0;
+    }
+
+  m_LastAlignmentTime = 0.0;
+}
+
+void TrackerAggregator::GetMotion( const SourceTrackerType & sourceTracker,
+                                   MotionContainerType & motion ) const
+{
+  const unsigned int numberOfMotionSamples = sourceTracker.m_Motion.size();
+  const unsigned int oldest = ( sourceTracker.m_NextMotionSample +
+                                numberOfMotionSamples -
+                                sourceTracker.m_NumberOfMotionSamples ) %
+                              numberOfMotionSamples;
+
+  motion.resize( sourceTracker.m_NumberOfMotionSamples );
+  for( unsigned int i = 0; i < sourceTracker.m_NumberOfMotionSamples; i++ )
+    {
+    motion[i] =
+      sourceTracker.m_Motion[( oldest + i ) % numberOfMotionSamples];
+    }
+}
+
+void TrackerAggregator::InterpolatePosition(
+                                           const MotionContainerType & motion,
+                                           TimePeriodType time,
+                                           unsigned int & index,
+                                           double position[3] )
+{
+  while( index + 2 < motion.size() && motion[index + 1].m_Time <= time )
+    {
+    index++;
+    }
+
+  const MotionSampleType & first = motion[index];
+  const MotionSampleType & second = motion[index + 1];
+
+  double weight = 0.0;
+  if( second.m_Time > first.m_Time )
+    {
+    weight = ( time - first.m_Time ) / ( second.m_Time - first.m_Time );
+    weight = ( weight < 0.0 ) ? 0.0 : ( weight > 1.0 ? 1.0 : weight );
+    }
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    position[i] = ( 1.0 - weight ) * first.m_Position[i] +
+                  weight * second.m_Position[i];
+    }
+}
+
+bool TrackerAggregator::ResampleSpeed( const MotionContainerType & motion,
+                                       TimePeriodType & origin,
+                                       std::vector< double > & speeds )
+{
+  if( motion.size() < 2 )
+    {
+    return false;
+    }
+
+  const TimePeriodType first = motion.front().m_Time + 0.5 * SpeedInterval;
+  const TimePeriodType last = motion.back().m_Time - 0.5 * SpeedInterval;
+  origin = ceil( first );
+  if( last < origin )
+    {
+    return false;
+    }
+
+  speeds.resize( static_cast< unsigned int >( floor( last - origin ) ) + 1 );
+
+  unsigned int before = 0;
+  unsigned int after = 0;
+  double positionBefore[3];
+  double positionAfter[3];
+  for( unsigned int i = 0; i < speeds.size(); i++ )
+    {
+    const TimePeriodType time = origin + i;
+    InterpolatePosition( motion, time - 0.5 * SpeedInterval, before,
+                         positionBefore );
+    InterpolatePosition( motion, time + 0.5 * SpeedInterval, after,
+                         positionAfter );
+    double distance = 0.0;
+    for( unsigned int d = 0; d < 3; d++ )
+      {
+      const double difference = positionAfter[d] - positionBefore[d];
+      distance += difference * difference;
+      }
+    speeds[i] = sqrt( distance ) / SpeedInterval;
+    }
+  return true;
+}
+
+void TrackerAggregator::EstimateLatencies()
+{
+  const SourceTrackerType & reference =
+                                  m_SourceTrackers[m_LatencyReferenceIndex];
+
+  MotionContainerType motion;
+  TimePeriodType referenceOrigin;
+  std::vector< double > referenceSpeeds;
+  this->GetMotion( reference, motion );
+  if( !ResampleSpeed( motion, referenceOrigin, referenceSpeeds ) )
+    {
+    return;
+    }
+  const unsigned int numberOfReferenceSpeeds =
+                       ( referenceSpeeds.size() + CorrelationStep - 1 ) /
+                       CorrelationStep;
+
+  TimePeriodType origin;
+  std::vector< double > speeds;
+
+  for( unsigned int t = 0; t < m_SourceTrackers.size(); t++ )
+    {
+    SourceTrackerType & sourceTracker = m_SourceTrackers[t];
+    if( t == m_LatencyReferenceIndex || sourceTracker.m_LatencySetByUser )
+      {
+      continue;
+      }
+
+    this->GetMotion( sourceTracker, motion );
+    if( !ResampleSpeed( motion, origin, speeds ) )
+      {
+      continue;
+      }
+
+    // A tracker whose latency exceeds the one of the reference by lag
+    // reports at time t + lag the motion that the reference reports at
+    // time t. The origins are whole milliseconds.
+    const long shift = static_cast< long >(
+                                 floor( referenceOrigin - origin + 0.5 ) );
+
+    double bestCorrelation = -1.0;
+    int bestLag = 0;
+    for( int lag = -MaximumLatencyDifference;
+         lag <= MaximumLatencyDifference; lag++ )
+      {
+      double sumReference = 0.0;
+      double sumTracker = 0.0;
+      double sumReference2 = 0.0;
+      double sumTracker2 = 0.0;
+      double sumProduct = 0.0;
+      unsigned int n = 0;
+      for( unsigned int j = 0; j < referenceSpeeds.size();
+           j += CorrelationStep )
+        {
+        const long k = static_cast< long >( j ) + shift + lag;
+        if( k < 0 || k >= static_cast< long >( speeds.size() ) )
+          {
+          continue;
+          }
+        const double r = referenceSpeeds[j];
+        const double s = speeds[k];
+        sumReference += r;
+        sumTracker += s;
+        sumReference2 += r * r;
+        sumTracker2 += s * s;
+        sumProduct += r * s;
+        n++;
+        }
+
+      // The speeds must overlap over half of the reference motion at least
+      if( n < 2 || 2 * n < numberOfReferenceSpeeds )
+        {
+        continue;
+        }
+
+      const double covariance = sumProduct - sumReference * sumTracker / n;
+      const double varianceReference =
+                             sumReference2 - sumReference * sumReference / n;
+      const double varianceTracker = sumTracker2 - sumTracker * sumTracker / n;
+      if( varianceReference <= 0.0 || varianceTracker <= 0.0 )
+        {
+        continue;
+        }
+
+      const double correlation =
+                  covariance / sqrt( varianceReference * varianceTracker );
+      if( correlation > bestCorrelation )
+        {
+        bestCorrelation = correlation;
+        bestLag = lag;
+        }
+      }
+
+    // Without a distinct motion, the previous estimate is kept
+    if( bestCorrelation < MinimumLatencyCorrelation )
+      {
+      continue;
+      }
+
+    const TimePeriodType estimate = reference.m_Latency + bestLag;
+    if( sourceTracker.m_LatencyEstimated )
+      {
+      sourceTracker.m_Latency += LatencyEstimateWeight *
+                                 ( estimate - sourceTracker.m_Latency );
+      }
+    else
+      {
+      sourceTracker.m_Latency = estimate;
+      sourceTracker.m_LatencyEstimated = true;
+      }
+    }
+}
+
+TrackerAggregator::ResultType TrackerAggregator::InternalUpdateStatus( void )
+{
+  igstkLogMacro( DEBUG,
+    "igstk::TrackerAggregator::InternalUpdateStatus called ...\n");
+
+  const TimePeriodType now = RealTimeClock::GetTimeStamp();
+  const TimePeriodType oldestValidTime = now - m_MaximumSampleAge;
+
+  if( m_HasLatencyReference &&
+      now - m_LastLatencyEstimationTime >= LatencyEstimationPeriod )
+    {
+    this->EstimateLatencies();
+    m_LastLatencyEstimationTime = now;
+    }
+
+  // Latest time for which all the active source trackers have a sample
+  bool active = false;
+  TimePeriodType alignmentTime = now;
+  for( unsigned int i = 0; i < m_SourceTrackers.size(); i++ )
+    {
+    const TimePeriodType latest = m_SourceTrackers[i].m_LatestSampleTime -
+                                  m_SourceTrackers[i].m_Latency;
+    if( latest >= oldestValidTime )
+      {
+      active = true;
+      if( latest < alignmentTime )
+        {
+        alignmentTime = latest;
+        }
+      }
+    }
+
+  // A tracker that becomes active may be late: the aligned time stamps of
+  // the tools never go backwards
+  if( alignmentTime < m_LastAlignmentTime )
+    {
+    alignmentTime = m_LastAlignmentTime;
+    }
+  if( active )
+    {
+    m_LastAlignmentTime = alignmentTime;
+    }
+
+  const TimePeriodType expirationTime = now + this->GetValidityTime();
+
+  const TrackerToolSlotType numberOfSlots = this->GetNumberOfTrackerToolSlots();
+
+  RigidTransform sample;
+  RigidTransform registeredSample;
+  TransformType transform;
+
+  for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
+    {
+    const SourceToolType * sourceTool =
+      ( slot < m_SourceToolSlots.size() ) ? m_SourceToolSlots[slot] : NULL;
+
+    if( !sourceTool )
+      {
+      continue;
+      }
+
+    const SourceTrackerType & sourceTracker =
+                         m_SourceTrackers[sourceTool->m_SourceTrackerIndex];
+
+    // The samples are stamped with their acquisition time plus the latency
+    if( !active ||
+        !this->InterpolateSample( *sourceTool,
+                                  alignmentTime + sourceTracker.m_Latency,
+                                  oldestValidTime + sourceTracker.m_Latency,
+                                  sample ) )
+      {
+      this->ReportTrackingToolNotAvailable( slot );
+      continue;
+      }
+
+    RigidTransform::Compose( sourceTracker.m_RegistrationTransform, sample,
+                             registeredSample );
+    registeredSample.m_StartTime = alignmentTime;
+    registeredSample.m_ExpirationTime = expirationTime;
+    registeredSample.ExportTransform( transform );
+
+    this->ReportTrackingToolVisible( slot );
+    this->SetTrackerToolRawTransform( slot, transform );
+    this->SetTrackerToolTransformUpdate( slot, true );
+    }
+
+  return SUCCESS;
+}
+
+TrackerAggregator::ResultType
+TrackerAggregator::InternalThreadedUpdateStatus( void )
+{
+  igstkLogMacro( DEBUG, "igstk::TrackerAggregator::"
+                 "InternalThreadedUpdateStatus called ...\n");
+  return SUCCESS;
+}
+
+/** Print Self function */
+void TrackerAggregator::PrintSelf( std::ostream& os,
+                                   itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Maximum sample age: " << m_MaximumSampleAge << std::endl;
+  os << indent << "Number of trackers: " << m_SourceTrackers.size()
+     << std::endl;
+
+  for( unsigned int i = 0; i < m_SourceTrackers.size(); i++ )
+    {
+    const SourceTrackerType & sourceTracker = m_SourceTrackers[i];
+    os << indent << "Tracker " << i << ": "
+       << sourceTracker.m_Tracker.GetPointer() << std::endl;
+    os << indent.GetNextIndent() << "Registration: "
+       << sourceTracker.m_RegistrationTransform << std::endl;
+    os << indent.GetNextIndent() << "Latency: "
+       << sourceTracker.m_Latency
+       << ( sourceTracker.m_LatencyEstimated ? " (estimated)" : "" )
+       << std::endl;
+    os << indent.GetNextIndent() << "Uses device clock: "
+       << sourceTracker.m_UsesDeviceClock << std::endl;
+    os << indent.GetNextIndent() << "Clock offset: "
+       << sourceTracker.m_ClockOffset << std::endl;
+    os << indent.GetNextIndent() << "Transport delay: "
+       << sourceTracker.m_TransportDelay << std::endl;
+    }
+}
+
+}
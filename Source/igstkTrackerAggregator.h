@@ -0,0 +1,279 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerAggregator.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkTrackerAggregator_h
+#define __igstkTrackerAggregator_h
+
+#include "igstkTracker.h"
+#include "igstkAggregatedTrackerTool.h"
+#include "igstkRigidTransform.h"
+#include "igstkCoordinateSystemTransformToResult.h"
+
+namespace igstk
+{
+
+/** \class TrackerAggregator
+ *  \brief Tracker merging the tools of several trackers into a single,
+ *  time aligned, set of tools.
+ *
+ *  The aggregator is used as any other tracker: AggregatedTrackerTool
+ *  objects are attached to it, and the application observes these tools
+ *  only, e.g. the optical and the electromagnetic tools of a hybrid
+ *  navigation system. The source trackers keep running their own device
+ *  threads. They must be opened, and their tools attached, before the
+ *  aggregator starts tracking; the aggregator starts and stops their
+ *  tracking along with its own.
+ *
+ *  The aggregator receives the calibrated transforms of the source tools
+ *  through their calibrated transform channel, and keeps a short history of
+ *  them. The trackers stamp their samples with the RealTimeClock, so the
+ *  time stamps of all the source trackers are comparable. A tracker whose
+ *  samples are stamped by the clock of the device is declared with
+ *  SetTrackerUsesDeviceClock(): the aggregator then estimates the offset
+ *  between the two clocks as the smallest delay observed between the time
+ *  stamp of a sample and its arrival, allowed to drift slowly upwards.
+ *
+ *  The acquisition latency of a tracker, i.e. the delay between the
+ *  acquisition of a sample and its time stamp, can not be observed from the
+ *  time stamps. It is either set by the application with
+ *  SetTrackerLatency(), or estimated relative to a reference tracker given
+ *  to SetLatencyReferenceTracker(): the speed of the first tool of every
+ *  tracker is cross-correlated with the speed of the first tool of the
+ *  reference tracker, and the lag of the best correlation is added to the
+ *  latency of the reference tracker. This assumes that the first tools of
+ *  the trackers follow the same motion, e.g. the optical and the
+ *  electromagnetic sensors of a hybrid tool.
+ *
+ *  At every update, the aggregator selects the latest time for which all
+ *  the active source trackers have delivered a sample, interpolates every
+ *  tool at that time, maps it to the aggregator coordinate system with the
+ *  registration transform of its tracker, and reports it with that time as
+ *  start time. A source tracker that delivered no sample for longer than
+ *  the maximum sample age is considered inactive, and its tools are
+ *  reported as not available.
+ *
+ *  All the processing happens in the thread that drives the pulse
+ *  generators, so the aggregator does not use a tracking thread.
+ *
+ *  \sa AggregatedTrackerTool
+ *
+ *  \ingroup Tracker
+ */
+class TrackerAggregator : public Tracker
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( TrackerAggregator, Tracker )
+
+  typedef Superclass::TransformType           TransformType;
+  typedef Transform::TimePeriodType           TimePeriodType;
+
+  /** Add a source tracker. The source trackers must be added before the
+   *  tools that refer to them are attached to the aggregator. */
+  void AddTracker( Tracker * tracker );
+
+  /** Set the transform from the coordinate system of a source tracker to
+   *  the coordinate system of the aggregator. It is the identity by
+   *  default. */
+  void SetTrackerRegistrationTransform( const Tracker * tracker,
+                                        const TransformType & transform );
+
+  /** Set the acquisition latency of a source tracker, in milliseconds, i.e.
+   *  the delay between the acquisition of a sample and its time stamp. It
+   *  is zero by default. A latency set by the application is not
+   *  estimated. */
+  void SetTrackerLatency( const Tracker * tracker, TimePeriodType latency );
+
+  /** Acquisition latency of a source tracker, set or estimated, in
+   *  milliseconds. */
+  TimePeriodType GetTrackerLatency( const Tracker * tracker ) const;
+
+  /** Estimate the latency of the source trackers relative to this one. */
+  void SetLatencyReferenceTracker( const Tracker * tracker );
+
+  /** Declare that the samples of a source tracker are stamped with the
+   *  clock of the device instead of the RealTimeClock. Off by default. */
+  void SetTrackerUsesDeviceClock( const Tracker * tracker, bool deviceClock );
+
+  /** Estimated offset between the time stamps of a source tracker and the
+   *  RealTimeClock, in milliseconds. It is zero for the trackers that do
+   *  not use a device clock. */
+  TimePeriodType GetTrackerClockOffset( const Tracker * tracker ) const;
+
+  /** Estimated mean delay, in addition to the clock offset, between the
+   *  time stamp of a sample of a source tracker and its arrival, in
+   *  milliseconds. */
+  TimePeriodType GetTrackerTransportDelay( const Tracker * tracker ) const;
+
+  /** Maximum age, in milliseconds, of the latest sample of a source
+   *  tracker or of a source tool for it to be used. */
+  igstkSetMacro( MaximumSampleAge, TimePeriodType );
+  igstkGetMacro( MaximumSampleAge, TimePeriodType );
+
+protected:
+
+  TrackerAggregator();
+
+  virtual ~TrackerAggregator();
+
+  typedef Tracker::ResultType                 ResultType;
+
+  virtual ResultType InternalOpen( void );
+
+  virtual ResultType InternalStartTracking( void );
+
+  virtual ResultType InternalReset( void );
+
+  virtual ResultType InternalStopTracking( void );
+
+  virtual ResultType InternalClose( void );
+
+  /** Verify tracker tool information */
+  virtual ResultType VerifyTrackerToolInformation( const TrackerToolType * );
+
+  virtual ResultType RemoveTrackerToolFromInternalDataContainers(
+                                                   const TrackerToolType * );
+
+  virtual ResultType AddTrackerToolToInternalDataContainers(
+                                                   const TrackerToolType * );
+
+  /** Align the samples of the source tools and set the transforms of the
+   *  aggregated tools. */
+  virtual ResultType InternalUpdateStatus( void );
+  virtual ResultType InternalThreadedUpdateStatus( void );
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  TrackerAggregator(const Self&);  //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  struct SourceToolType;
+
+  /** Position of the first tool of a source tracker, used to estimate the
+   *  latency of the tracker */
+  struct MotionSampleType
+    {
+    TimePeriodType        m_Time;
+    double                m_Position[3];
+    };
+
+  typedef std::vector< MotionSampleType >    MotionContainerType;
+
+  /** Source tracker along with its registration and its clock model */
+  struct SourceTrackerType
+    {
+    Tracker::Pointer      m_Tracker;
+    RigidTransform        m_RegistrationTransform;
+    TimePeriodType        m_Latency;
+    bool                  m_LatencySetByUser;
+    bool                  m_LatencyEstimated;
+    bool                  m_UsesDeviceClock;
+    bool                  m_ClockOffsetInitialized;
+    TimePeriodType        m_ClockOffset;
+    TimePeriodType        m_TransportDelay;
+    TimePeriodType        m_LastArrivalTime;
+    TimePeriodType        m_LatestSampleTime;
+    const SourceToolType * m_MotionTool;
+    MotionContainerType   m_Motion;
+    unsigned int          m_NextMotionSample;
+    unsigned int          m_NumberOfMotionSamples;
+    };
+
+  typedef std::vector< SourceTrackerType >   SourceTrackerContainerType;
+
+  /** Source tool of an aggregated tool, along with the history of its
+   *  samples. The start time of the samples is in RealTimeClock time,
+   *  before the correction of the latency of the tracker. */
+  struct SourceToolType
+    {
+    Self *                          m_Aggregator;
+    unsigned int                    m_SourceTrackerIndex;
+    TrackerTool::ConstPointer       m_SourceTrackerTool;
+    unsigned long                   m_ObserverTag;
+    std::vector< RigidTransform >   m_Samples;
+    unsigned int                    m_NextSample;
+    unsigned int                    m_NumberOfSamples;
+    };
+
+  /** One source tool per tracker tool slot, NULL in the free slots */
+  typedef std::vector< SourceToolType * >    SourceToolSlotContainerType;
+
+  /** Index of a source tracker, or the number of source trackers if the
+   *  tracker has not been added */
+  unsigned int FindSourceTracker( const Tracker * tracker ) const;
+
+  /** Callback of the calibrated transform channel of the source tools */
+  static void SourceTransformCallback( void * sourceTool,
+                             const CoordinateSystemTransformToResult & result );
+
+  /** Update the clock model of the source tracker and store the sample */
+  void AddSample( SourceToolType & sourceTool,
+                  const TransformType & transform );
+
+  /** Sample of a source tool at the given time, interpolated between the
+   *  samples of its history. Returns false if the tool has no sample more
+   *  recent than oldestValidTime. */
+  bool InterpolateSample( const SourceToolType & sourceTool,
+                          TimePeriodType time,
+                          TimePeriodType oldestValidTime,
+                          RigidTransform & sample ) const;
+
+  /** Remove the samples of all the source tools */
+  void ClearSamples();
+
+  /** Estimate the latency of the source trackers relative to the latency
+   *  reference tracker */
+  void EstimateLatencies();
+
+  /** Samples of the motion history of a source tracker, oldest first */
+  void GetMotion( const SourceTrackerType & sourceTracker,
+                  MotionContainerType & motion ) const;
+
+  /** Speed of a motion, sampled every millisecond: speeds[i] is the speed
+   *  at origin + i. Returns false if the motion is too short. */
+  static bool ResampleSpeed( const MotionContainerType & motion,
+                             TimePeriodType & origin,
+                             std::vector< double > & speeds );
+
+  /** Position of a motion at the given time. The search starts at the
+   *  sample index, which is updated for the next, later, time. */
+  static void InterpolatePosition( const MotionContainerType & motion,
+                                   TimePeriodType time,
+                                   unsigned int & index,
+                                   double position[3] );
+
+  SourceTrackerContainerType    m_SourceTrackers;
+  SourceToolSlotContainerType   m_SourceToolSlots;
+
+  TimePeriodType                m_MaximumSampleAge;
+
+  /** Latency estimation */
+  bool                          m_HasLatencyReference;
+  unsigned int                  m_LatencyReferenceIndex;
+  TimePeriodType                m_LastLatencyEstimationTime;
+
+  /** Time stamp of the last aligned transforms */
+  TimePeriodType                m_LastAlignmentTime;
+};
+
+}
+
+#endif //__igstk_TrackerAggregator_h_
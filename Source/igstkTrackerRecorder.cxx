@@ -0,0 +1,391 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerRecorder.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkTrackerRecorder.h"
+#include "igstkRealTimeClock.h"
+
+#include <string.h>
+
+namespace igstk
+{
+
+const char * TrackerRecorder::GetFileSignature()
+{
+  return "IGSTKTRK";
+}
+
+std::string TrackerRecorder::GetIndexFileName( const std::string & fileName )
+{
+  return fileName + ".index";
+}
+
+TrackerRecorder::TrackerRecorder():m_StateMachine(this)
+{
+  m_IndexInterval = 1024;
+  m_BufferSize = 65536;
+
+  m_DataFile = NULL;
+  m_IndexFile = NULL;
+
+  m_FirstBufferedRecord = 0;
+  m_NumberOfBufferedRecords = 0;
+  m_LastRecordTime = 0.0;
+  m_NumberOfDroppedRecords = 0;
+  m_NumberOfRecords = 0;
+  m_StopRecording = false;
+  m_BufferCondition = itk::ConditionVariable::New();
+
+  m_Recording = false;
+  m_Threader = itk::MultiThreader::New();
+  m_ThreadID = -1;
+
+  m_NotAvailableCommand = NotAvailableCommandType::New();
+  m_NotAvailableCommand->SetCallbackFunction( this,
+                                    &TrackerRecorder::NotAvailableCallback );
+}
+
+TrackerRecorder::~TrackerRecorder()
+{
+  this->StopRecording();
+
+  for( unsigned int i = 0; i < m_ToolObservers.size(); i++ )
+    {
+    ToolObserverType * observer = m_ToolObservers[i];
+    observer->m_TrackerTool->GetCalibratedTransformChannel()
+                                    .RemoveObserver( observer->m_ChannelTag );
+    observer->m_TrackerTool->RemoveObserver( observer->m_NotAvailableTag );
+    delete observer;
+    }
+}
+
+void TrackerRecorder::AddTrackerTool( TrackerTool * trackerTool )
+{
+  if( m_Recording || !trackerTool )
+    {
+    igstkLogMacro( WARNING, "igstk::TrackerRecorder::AddTrackerTool: "
+                   "tools can only be added before the recording starts\n" );
+    return;
+    }
+
+  ToolObserverType * observer = new ToolObserverType;
+  observer->m_Recorder = this;
+  observer->m_ToolIndex = m_ToolObservers.size();
+  observer->m_TrackerTool = trackerTool;
+  observer->m_ChannelTag =
+    trackerTool->GetCalibratedTransformChannel().AddObserver( observer,
+                                        &TrackerRecorder::TransformCallback );
+  observer->m_NotAvailableTag = trackerTool->AddObserver(
+    TrackerToolNotAvailableToBeTrackedEvent(), m_NotAvailableCommand );
+
+  m_ToolObservers.push_back( observer );
+}
+
+bool TrackerRecorder::StartRecording( const std::string & fileName )
+{
+  if( m_Recording )
+    {
+    this->StopRecording();
+    }
+
+  m_DataFile = fopen( fileName.c_str(), "wb" );
+  if( !m_DataFile )
+    {
+    igstkLogMacro( CRITICAL, "igstk::TrackerRecorder::StartRecording: "
+                   "can not create " << fileName << "\n" );
+    return false;
+    }
+
+  const std::string indexFileName = GetIndexFileName( fileName );
+  m_IndexFile = fopen( indexFileName.c_str(), "wb" );
+  if( !m_IndexFile )
+    {
+    igstkLogMacro( CRITICAL, "igstk::TrackerRecorder::StartRecording: "
+                   "can not create " << indexFileName << "\n" );
+    fclose( m_DataFile );
+    m_DataFile = NULL;
+    return false;
+    }
+
+  if( m_IndexInterval == 0 )
+    {
+    m_IndexInterval = 1;
+    }
+
+  // Header and names of the tools
+  FileHeaderType header;
+  memset( &header, 0, sizeof( header ) );
+  memcpy( header.m_Signature, GetFileSignature(),
+          sizeof( header.m_Signature ) );
+  header.m_Version = FileVersion;
+  header.m_RecordSize = sizeof( RecordType );
+  header.m_NumberOfTools = m_ToolObservers.size();
+  header.m_IndexInterval = m_IndexInterval;
+  fwrite( &header, sizeof( header ), 1, m_DataFile );
+
+  for( unsigned int i = 0; i < m_ToolObservers.size(); i++ )
+    {
+    char name[NameLength];
+    memset( name, 0, NameLength );
+    strncpy( name,
+             m_ToolObservers[i]->m_TrackerTool->GetTrackerToolIdentifier()
+                                                                  .c_str(),
+             NameLength - 1 );
+    fwrite( name, NameLength, 1, m_DataFile );
+    }
+  fflush( m_DataFile );
+
+  m_Buffer.resize( m_BufferSize > 0 ? m_BufferSize : 1 );
+  m_WriteBuffer.resize( m_Buffer.size() );
+
+  m_BufferLock.Lock();
+  m_FirstBufferedRecord = 0;
+  m_NumberOfBufferedRecords = 0;
+  m_LastRecordTime = 0.0;
+  m_NumberOfDroppedRecords = 0;
+  m_NumberOfRecords = 0;
+  m_StopRecording = false;
+  m_Recording = true;
+  m_BufferLock.Unlock();
+
+  m_ThreadID = m_Threader->SpawnThread( RecordingThreadFunction, this );
+
+  return true;
+}
+
+void TrackerRecorder::StopRecording()
+{
+  if( !m_Recording )
+    {
+    return;
+    }
+
+  // The recording thread writes the buffered records before exiting
+  m_BufferLock.Lock();
+  m_StopRecording = true;
+  m_Recording = false;
+  m_BufferCondition->Signal();
+  m_BufferLock.Unlock();
+
+  m_Threader->TerminateThread( m_ThreadID );
+  m_ThreadID = -1;
+
+  fclose( m_DataFile );
+  fclose( m_IndexFile );
+  m_DataFile = NULL;
+  m_IndexFile = NULL;
+}
+
+bool TrackerRecorder::IsRecording() const
+{
+  m_BufferLock.Lock();
+  const bool recording = m_Recording;
+  m_BufferLock.Unlock();
+  return recording;
+}
+
+unsigned long TrackerRecorder::GetNumberOfRecords() const
+{
+  m_BufferLock.Lock();
+  const unsigned long numberOfRecords = m_NumberOfRecords;
+  m_BufferLock.Unlock();
+  return numberOfRecords;
+}
+
+unsigned long TrackerRecorder::GetNumberOfDroppedRecords() const
+{
+  m_BufferLock.Lock();
+  const unsigned long numberOfDroppedRecords = m_NumberOfDroppedRecords;
+  m_BufferLock.Unlock();
+  return numberOfDroppedRecords;
+}
+
+void TrackerRecorder::TransformCallback( void * toolObserver,
+                             const CoordinateSystemTransformToResult & result )
+{
+  ToolObserverType * observer = static_cast< ToolObserverType * >(
+                                                              toolObserver );
+  const Transform & transform = result.GetTransform();
+  const Transform::VectorType translation = transform.GetTranslation();
+  const Transform::VersorType rotation = transform.GetRotation();
+
+  RecordType record;
+  record.m_Time = transform.GetStartTime();
+  record.m_Rotation[0] = rotation.GetX();
+  record.m_Rotation[1] = rotation.GetY();
+  record.m_Rotation[2] = rotation.GetZ();
+  record.m_Rotation[3] = rotation.GetW();
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    record.m_Translation[i] = translation[i];
+    }
+  record.m_Error = transform.GetError();
+  record.m_ToolIndex = observer->m_ToolIndex;
+  record.m_Status = ToolVisible;
+
+  observer->m_Recorder->PushRecord( record );
+}
+
+void TrackerRecorder::NotAvailableCallback( const itk::Object * caller,
+                                            const itk::EventObject & )
+{
+  for( unsigned int i = 0; i < m_ToolObservers.size(); i++ )
+    {
+    if( m_ToolObservers[i]->m_TrackerTool.GetPointer() == caller )
+      {
+      RecordType record;
+      memset( &record, 0, sizeof( record ) );
+      record.m_Time = RealTimeClock::GetTimeStamp();
+      record.m_Rotation[3] = 1.0;
+      record.m_ToolIndex = i;
+      record.m_Status = ToolNotAvailable;
+
+      this->PushRecord( record );
+      return;
+      }
+    }
+}
+
+void TrackerRecorder::PushRecord( RecordType & record )
+{
+  m_BufferLock.Lock();
+
+  if( !m_Recording )
+    {
+    m_BufferLock.Unlock();
+    return;
+    }
+
+  const unsigned int bufferSize = m_Buffer.size();
+  if( m_NumberOfBufferedRecords == bufferSize )
+    {
+    m_NumberOfDroppedRecords++;
+    m_BufferLock.Unlock();
+    return;
+    }
+
+  // Tools of different trackers may report slightly out of order, the
+  // times of the records must not decrease for the searches by time
+  if( record.m_Time < m_LastRecordTime )
+    {
+    record.m_Time = m_LastRecordTime;
+    }
+  m_LastRecordTime = record.m_Time;
+
+  m_Buffer[( m_FirstBufferedRecord + m_NumberOfBufferedRecords ) %
+           bufferSize] = record;
+  m_NumberOfBufferedRecords++;
+
+  m_BufferCondition->Signal();
+  m_BufferLock.Unlock();
+}
+
+ITK_THREAD_RETURN_TYPE
+TrackerRecorder::RecordingThreadFunction( void * info )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)info;
+
+  if( pInfo == NULL || pInfo->UserData == NULL )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  TrackerRecorder * recorder =
+    static_cast< TrackerRecorder * >( pInfo->UserData );
+
+  while( true )
+    {
+    recorder->m_BufferLock.Lock();
+    while( !recorder->m_StopRecording &&
+           recorder->m_NumberOfBufferedRecords == 0 )
+      {
+      recorder->m_BufferCondition->Wait( &recorder->m_BufferLock );
+      }
+
+    if( recorder->m_NumberOfBufferedRecords == 0 )
+      {
+      recorder->m_BufferLock.Unlock();
+      break;
+      }
+
+    // Take all the buffered records, and write them without the lock
+    const unsigned int bufferSize = recorder->m_Buffer.size();
+    const unsigned int count = recorder->m_NumberOfBufferedRecords;
+    for( unsigned int i = 0; i < count; i++ )
+      {
+      recorder->m_WriteBuffer[i] = recorder->m_Buffer[
+                        ( recorder->m_FirstBufferedRecord + i ) % bufferSize ];
+      }
+    recorder->m_FirstBufferedRecord =
+                  ( recorder->m_FirstBufferedRecord + count ) % bufferSize;
+    recorder->m_NumberOfBufferedRecords = 0;
+    recorder->m_BufferLock.Unlock();
+
+    recorder->WriteRecords( &recorder->m_WriteBuffer[0], count );
+
+    recorder->m_BufferLock.Lock();
+    recorder->m_NumberOfRecords += count;
+    recorder->m_BufferLock.Unlock();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void TrackerRecorder::WriteRecords( const RecordType * records,
+                                    unsigned int count )
+{
+  fwrite( records, sizeof( RecordType ), count, m_DataFile );
+
+  // m_NumberOfRecords is only modified by this thread
+  const unsigned long firstRecord = m_NumberOfRecords;
+  unsigned long record = firstRecord +
+    ( m_IndexInterval - firstRecord % m_IndexInterval ) % m_IndexInterval;
+  for( ; record < firstRecord + count; record += m_IndexInterval )
+    {
+    IndexEntryType entry;
+    entry.m_Time = records[record - firstRecord].m_Time;
+    entry.m_Record = record;
+    entry.m_Reserved = 0;
+    fwrite( &entry, sizeof( entry ), 1, m_IndexFile );
+    }
+
+  fflush( m_DataFile );
+  fflush( m_IndexFile );
+}
+
+/** Print Self function */
+void TrackerRecorder::PrintSelf( std::ostream& os, itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of tools: " << m_ToolObservers.size() << std::endl;
+  os << indent << "Index interval: " << m_IndexInterval << std::endl;
+  os << indent << "Buffer size: " << m_BufferSize << std::endl;
+  os << indent << "Recording: " << this->IsRecording() << std::endl;
+  os << indent << "Number of records: " << this->GetNumberOfRecords()
+     << std::endl;
+  os << indent << "Number of dropped records: "
+     << this->GetNumberOfDroppedRecords() << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,219 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerRecorder.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkTrackerRecorder_h
+#define __igstkTrackerRecorder_h
+
+#include "igstkObject.h"
+#include "igstkTrackerTool.h"
+#include "igstkCoordinateSystemTransformToResult.h"
+
+#include "itkMutexLock.h"
+#include "itkConditionVariable.h"
+#include "itkMultiThreader.h"
+#include "itkCommand.h"
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+
+namespace igstk
+{
+
+/** \class TrackerRecorder
+ *  \brief Records the transforms of tracker tools in an indexed binary file.
+ *
+ *  The recorder observes a set of tracker tools and appends a fixed size
+ *  record to the file for every calibrated transform of a tool, and every
+ *  time a tool becomes not available. The file can be replayed with a
+ *  PlaybackTracker.
+ *
+ *  The observers only copy the record in a buffer. A recording thread
+ *  writes the buffered records to the file, so that the disk does not delay
+ *  the tracking. If the disk can not keep up and the buffer is full, the
+ *  new records are dropped and counted.
+ *
+ *  Every IndexInterval records, the recording thread appends the time and
+ *  the number of the record to an index file, named after the data file
+ *  with the ".index" extension. The times of the records never decrease,
+ *  so that a time can be found in the recording with a binary search in
+ *  the index followed by a binary search between two index entries.
+ *
+ *  The data file starts with a FileHeaderType, followed by the names of the
+ *  tools, NameLength characters each, and by the records. The numbers are
+ *  written in the byte order of the host.
+ *
+ *  \sa PlaybackTracker
+ *
+ *  \ingroup Tracker
+ */
+class TrackerRecorder : public Object
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( TrackerRecorder, Object )
+
+  typedef Transform::TimePeriodType         TimePeriodType;
+
+  /** Status of a tool in a record */
+  enum
+    {
+    ToolNotAvailable = 0,
+    ToolVisible = 1
+    };
+
+  /** Record of a tool sample. The rotation is a unit quaternion in the
+   *  order x, y, z, w. The time is the start time of the transform, in
+   *  milliseconds. */
+  struct RecordType
+    {
+    double          m_Time;
+    double          m_Rotation[4];
+    double          m_Translation[3];
+    double          m_Error;
+    unsigned int    m_ToolIndex;
+    unsigned int    m_Status;
+    };
+
+  /** Header of the data file */
+  struct FileHeaderType
+    {
+    char            m_Signature[8];
+    unsigned int    m_Version;
+    unsigned int    m_RecordSize;
+    unsigned int    m_NumberOfTools;
+    unsigned int    m_IndexInterval;
+    };
+
+  /** Entry of the index file */
+  struct IndexEntryType
+    {
+    double          m_Time;
+    unsigned int    m_Record;
+    unsigned int    m_Reserved;
+    };
+
+  /** Length of the tool names in the data file, including the final
+   *  null character */
+  itkStaticConstMacro( NameLength, unsigned int, 64 );
+
+  /** Signature and version of the data files */
+  static const char * GetFileSignature();
+  itkStaticConstMacro( FileVersion, unsigned int, 1 );
+
+  /** Name of the index file of a data file */
+  static std::string GetIndexFileName( const std::string & fileName );
+
+  /** Add a tool to the recording. The index of the tool in the records is
+   *  the order in which the tools are added. The tools must be added before
+   *  the recording starts. */
+  void AddTrackerTool( TrackerTool * trackerTool );
+
+  /** Number of records between two index entries, 1024 by default */
+  igstkSetMacro( IndexInterval, unsigned int );
+  igstkGetMacro( IndexInterval, unsigned int );
+
+  /** Number of records that can be buffered, 65536 by default */
+  igstkSetMacro( BufferSize, unsigned int );
+  igstkGetMacro( BufferSize, unsigned int );
+
+  /** Create the data and index files, and start recording. Returns false
+   *  if a file can not be created. */
+  bool StartRecording( const std::string & fileName );
+
+  /** Write the buffered records and close the files */
+  void StopRecording();
+
+  /** Whether the recorder is recording */
+  bool IsRecording() const;
+
+  /** Number of records written, and dropped because the buffer was full */
+  unsigned long GetNumberOfRecords() const;
+  unsigned long GetNumberOfDroppedRecords() const;
+
+protected:
+
+  TrackerRecorder();
+  virtual ~TrackerRecorder();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  TrackerRecorder(const Self&);   //purposely not implemented
+  void operator=(const Self&);    //purposely not implemented
+
+  /** Observer of the calibrated transform channel of a tool */
+  struct ToolObserverType
+    {
+    Self *                  m_Recorder;
+    unsigned int            m_ToolIndex;
+    TrackerTool::Pointer    m_TrackerTool;
+    unsigned long           m_ChannelTag;
+    unsigned long           m_NotAvailableTag;
+    };
+
+  static void TransformCallback( void * toolObserver,
+                           const CoordinateSystemTransformToResult & result );
+
+  void NotAvailableCallback( const itk::Object * caller,
+                             const itk::EventObject & event );
+
+  /** Copy a record in the buffer, called in the thread of the tools */
+  void PushRecord( RecordType & record );
+
+  /** Thread writing the buffered records */
+  static ITK_THREAD_RETURN_TYPE RecordingThreadFunction( void * info );
+
+  /** Write records to the files, called in the recording thread */
+  void WriteRecords( const RecordType * records, unsigned int count );
+
+  std::vector< ToolObserverType * >   m_ToolObservers;
+
+  typedef itk::MemberCommand< Self >  NotAvailableCommandType;
+  NotAvailableCommandType::Pointer    m_NotAvailableCommand;
+
+  unsigned int                        m_IndexInterval;
+  unsigned int                        m_BufferSize;
+
+  FILE *                              m_DataFile;
+  FILE *                              m_IndexFile;
+
+  /** Ring buffer of the records, protected by m_BufferLock */
+  std::vector< RecordType >           m_Buffer;
+  unsigned int                        m_FirstBufferedRecord;
+  unsigned int                        m_NumberOfBufferedRecords;
+  TimePeriodType                      m_LastRecordTime;
+  unsigned long                       m_NumberOfDroppedRecords;
+  bool                                m_StopRecording;
+  unsigned long                       m_NumberOfRecords;
+  mutable itk::SimpleMutexLock        m_BufferLock;
+  itk::ConditionVariable::Pointer     m_BufferCondition;
+
+  /** Record buffer of the recording thread */
+  std::vector< RecordType >           m_WriteBuffer;
+
+  bool                                m_Recording;
+  itk::MultiThreader::Pointer         m_Threader;
+  int                                 m_ThreadID;
+};
+
+} // end namespace igstk
+
+#endif // __igstkTrackerRecorder_h
@@ -483,6 +483,41 @@ void
 TrackerTool::SetCalibrationTransform( const TransformType & transform )
 {
   this->m_CalibrationTransform = transform;
+
+  // the tracker keeps a copy for its update loop
+  if( this->m_TrackerToAttachTo != NULL )
+    {
+    this->m_TrackerToAttachTo->SetTrackerToolCalibrationTransform( this, 
+                                                                 transform );
+    }
+}
+
+/** Set the filter of the raw transform */
+void 
+TrackerTool::SetFilter( TrackerToolFilter * filter )
+{
+  this->m_Filter = filter;
+}
+
+/** Get the filter of the raw transform */
+TrackerToolFilter * 
+TrackerTool::GetFilter() const
+{
+  return this->m_Filter;
+}
+
+/** Set the predictor of the calibrated transform */
+void 
+TrackerTool::SetPredictor( TrackerToolPredictor * predictor )
+{
+  this->m_Predictor = predictor;
+}
+
+/** Get the predictor of the calibrated transform */
+TrackerToolPredictor * 
+TrackerTool::GetPredictor() const
+{
+  return this->m_Predictor;
 }
 
 /** Method to set the raw transform for the tracker tool
@@ -507,12 +542,21 @@ TrackerTool::SetCalibratedTransform( const TransformType & transform )
     this->GetCoordinateSystem(),
     this->m_TrackerToAttachTo);
 
+  this->m_CalibratedTransformChannel.Invoke( transformCarrier );
+
   CoordinateSystemTransformToEvent  transformEvent;
   transformEvent.Set( transformCarrier );
 
   this->InvokeEvent( transformEvent );
 }
 
+/** Channel notifying the calibrated transforms */
+const TrackerTool::CalibratedTransformChannelType &
+TrackerTool::GetCalibratedTransformChannel() const
+{
+  return this->m_CalibratedTransformChannel;
+}
+
 /** Print object information */
 void TrackerTool::PrintSelf( std::ostream& os, itk::Indent indent ) const
 {
@@ -523,6 +567,9 @@ void TrackerTool::PrintSelf( std::ostream& os, itk::Indent indent ) const
                << this->m_CalibrationTransform << std::endl;
   os << indent << "Calibrated raw transform: "
                << this->m_CalibratedTransform << std::endl;
+  os << indent << "Filter: " << this->m_Filter.GetPointer() << std::endl;
+  os << indent << "Predictor: " << this->m_Predictor.GetPointer() 
+               << std::endl;
   os << indent << "CoordinateSystemDelegator: ";
   this->m_CoordinateSystemDelegator->PrintSelf( os, indent );
 
@@ -22,6 +22,8 @@
 #include "igstkTransform.h"
 #include "igstkMacros.h"
 #include "igstkStateMachine.h"
+#include "igstkTrackerToolFilter.h"
+#include "igstkTrackerToolPredictor.h"
 #include "igstkCoordinateSystemInterfaceMacros.h"
 
 
@@ -89,6 +91,23 @@ public:
   /**  Set the calibration transform for this tool. */
   void SetCalibrationTransform( const TransformType & );
 
+  /** Set a filter smoothing the raw transforms of the tool before they are
+   *  composed with the calibration transform. Set it to NULL to use the
+   *  raw transforms as they are. */
+  void SetFilter( TrackerToolFilter * filter );
+
+  /** Get the filter, NULL if the raw transforms are not filtered */
+  TrackerToolFilter * GetFilter() const;
+
+  /** Set a predictor extrapolating the calibrated transform of the tool
+   *  to the time it will be displayed. The tracker then reports the
+   *  predicted transform instead of the measured one. Set it to NULL to
+   *  report the measured transforms. */
+  void SetPredictor( TrackerToolPredictor * predictor );
+
+  /** Get the predictor, NULL if the measured transforms are reported */
+  TrackerToolPredictor * GetPredictor() const;
+
   /** Get whether the tool was updated during tracker UpdateStatus() */
   igstkGetMacro( Updated, bool );
  
@@ -106,6 +125,15 @@ public:
    * tracker. */
   virtual void RequestAttachToTracker( TrackerType * );
 
+  /** Channel invoked with the calibrated transform of every new tracking
+   * sample, along with the CoordinateSystemTransformToEvent. Observers that
+   * run at the tracking rate should use it, since it is dispatched without
+   * run time type identification and without copying the payload. */
+  typedef CoordinateSystem::TransformToChannelType 
+                                            CalibratedTransformChannelType;
+  const CalibratedTransformChannelType & 
+                                      GetCalibratedTransformChannel() const;
+
 protected:
 
   TrackerTool(void);
@@ -241,6 +269,15 @@ private:
   /** Calibrated raw transform for the tool */
   TransformType                 m_CalibratedTransform; 
 
+  /** Channel notifying the calibrated transforms */
+  CalibratedTransformChannelType  m_CalibratedTransformChannel;
+
+  /** Optional filter of the raw transform */
+  TrackerToolFilter::Pointer      m_Filter;
+
+  /** Optional predictor of the calibrated transform */
+  TrackerToolPredictor::Pointer   m_Predictor;
+
   /** raw transform for the tool */
   TransformType                 m_RawTransform; 
 
@@ -0,0 +1,95 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolExponentialFilter.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkTrackerToolExponentialFilter.h"
+#include "igstkRigidTransform.h"
+
+#include <math.h>
+
+namespace igstk
+{
+
+TrackerToolExponentialFilter::TrackerToolExponentialFilter():
+  m_StateMachine(this)
+{
+  m_TimeConstant = 50.0;
+  this->InternalReset();
+}
+
+TrackerToolExponentialFilter::~TrackerToolExponentialFilter()
+{
+}
+
+void TrackerToolExponentialFilter::InternalReset()
+{
+  m_Initialized = false;
+}
+
+void TrackerToolExponentialFilter::InternalFilter( TimePeriodType interval,
+                                                   double translation[3],
+                                                   double rotation[4] )
+{
+  if( m_Initialized && m_TimeConstant > 0.0 )
+    {
+    const double weight = 1.0 - exp( -interval / m_TimeConstant );
+
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      m_Translation[i] += weight * ( translation[i] - m_Translation[i] );
+      }
+    RigidTransform::InterpolateRotation( m_Rotation, rotation, weight,
+                                         m_Rotation );
+    }
+  else
+    {
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      m_Translation[i] = translation[i];
+      }
+    for( unsigned int i = 0; i < 4; i++ )
+      {
+      m_Rotation[i] = rotation[i];
+      }
+    m_Initialized = true;
+    }
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    translation[i] = m_Translation[i];
+    }
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    rotation[i] = m_Rotation[i];
+    }
+}
+
+/** Print Self function */
+void TrackerToolExponentialFilter::PrintSelf( std::ostream& os,
+                                              itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Time constant: " << m_TimeConstant << std::endl;
+}
+
+} // end namespace igstk
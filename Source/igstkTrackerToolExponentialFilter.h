@@ -0,0 +1,78 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolExponentialFilter.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkTrackerToolExponentialFilter_h
+#define __igstkTrackerToolExponentialFilter_h
+
+#include "igstkTrackerToolFilter.h"
+
+namespace igstk
+{
+
+/** \class TrackerToolExponentialFilter
+ *  \brief Exponential smoothing of the poses of a tracker tool.
+ *
+ *  Every sample moves the filtered pose towards the sample by a fraction
+ *  1 - exp(-interval / TimeConstant): linearly for the translation, and
+ *  along the shortest arc for the rotation. The fraction depends on the
+ *  interval between the samples, so that the smoothing is the same for
+ *  trackers running at different rates.
+ *
+ *  \ingroup Tracker
+ */
+class TrackerToolExponentialFilter : public TrackerToolFilter
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( TrackerToolExponentialFilter,
+                                 TrackerToolFilter )
+
+  /** Time constant of the smoothing, in milliseconds, 50 by default. A
+   *  time constant of zero disables the smoothing. */
+  igstkSetMacro( TimeConstant, TimePeriodType );
+  igstkGetMacro( TimeConstant, TimePeriodType );
+
+protected:
+
+  TrackerToolExponentialFilter();
+  virtual ~TrackerToolExponentialFilter();
+
+  virtual void InternalFilter( TimePeriodType interval,
+                               double translation[3],
+                               double rotation[4] );
+
+  virtual void InternalReset();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  TrackerToolExponentialFilter(const Self&);  //purposely not implemented
+  void operator=(const Self&);                //purposely not implemented
+
+  TimePeriodType    m_TimeConstant;
+
+  bool              m_Initialized;
+  double            m_Translation[3];
+  double            m_Rotation[4];
+};
+
+} // end namespace igstk
+
+#endif // __igstkTrackerToolExponentialFilter_h
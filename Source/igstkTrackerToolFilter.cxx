@@ -0,0 +1,140 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolFilter.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkTrackerToolFilter.h"
+
+#include <math.h>
+
+namespace igstk
+{
+
+TrackerToolFilter::TrackerToolFilter():m_StateMachine(this)
+{
+  m_MaximumSampleInterval = 500.0;
+  m_Initialized = false;
+  m_SampleTime = 0.0;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    m_Translation[i] = 0.0;
+    m_Rotation[i] = 0.0;
+    }
+  m_Rotation[3] = 1.0;
+}
+
+TrackerToolFilter::~TrackerToolFilter()
+{
+}
+
+void TrackerToolFilter::Reset()
+{
+  m_Initialized = false;
+}
+
+void TrackerToolFilter::Filter( const TransformType & input,
+                                TransformType & output )
+{
+  const TimePeriodType sampleTime = input.GetStartTime();
+  TimePeriodType interval = sampleTime - m_SampleTime;
+
+  // A repeated sample repeats the last output
+  if( !m_Initialized || interval != 0.0 )
+    {
+    if( !m_Initialized || interval < 0.0 ||
+        interval > m_MaximumSampleInterval )
+      {
+      this->InternalReset();
+      interval = 0.0;
+      }
+
+    const TransformType::VectorType & translation = input.GetTranslation();
+    const TransformType::VersorType & rotation = input.GetRotation();
+
+    m_Translation[0] = translation[0];
+    m_Translation[1] = translation[1];
+    m_Translation[2] = translation[2];
+    m_Rotation[0] = rotation.GetX();
+    m_Rotation[1] = rotation.GetY();
+    m_Rotation[2] = rotation.GetZ();
+    m_Rotation[3] = rotation.GetW();
+
+    this->InternalFilter( interval, m_Translation, m_Rotation );
+
+    m_SampleTime = sampleTime;
+    m_Initialized = true;
+    }
+
+  TransformType::VectorType filteredTranslation;
+  filteredTranslation[0] = m_Translation[0];
+  filteredTranslation[1] = m_Translation[1];
+  filteredTranslation[2] = m_Translation[2];
+
+  TransformType::VersorType filteredRotation;
+  filteredRotation.Set( m_Rotation[0], m_Rotation[1],
+                        m_Rotation[2], m_Rotation[3] );
+
+  output.SetTranslationAndRotation( filteredTranslation,
+                                    filteredRotation,
+                                    input.GetError(),
+                                    input.GetStartTime(),
+                                    input.GetExpirationTime() );
+}
+
+void TrackerToolFilter::AlignRotation( const double reference[4],
+                                       double rotation[4] )
+{
+  const double cosine = reference[0] * rotation[0] +
+                        reference[1] * rotation[1] +
+                        reference[2] * rotation[2] +
+                        reference[3] * rotation[3];
+  if( cosine < 0.0 )
+    {
+    for( unsigned int i = 0; i < 4; i++ )
+      {
+      rotation[i] = -rotation[i];
+      }
+    }
+}
+
+double TrackerToolFilter::GetRotationAngle( const double first[4],
+                                            const double second[4] )
+{
+  double cosine = fabs( first[0] * second[0] + first[1] * second[1] +
+                        first[2] * second[2] + first[3] * second[3] );
+  if( cosine > 1.0 )
+    {
+    cosine = 1.0;
+    }
+  return 2.0 * acos( cosine );
+}
+
+/** Print Self function */
+void TrackerToolFilter::PrintSelf( std::ostream& os,
+                                   itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Maximum sample interval: "
+     << m_MaximumSampleInterval << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,118 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolFilter.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkTrackerToolFilter_h
+#define __igstkTrackerToolFilter_h
+
+#include "igstkObject.h"
+#include "igstkTransform.h"
+#include "igstkMacros.h"
+
+namespace igstk
+{
+
+/** \class TrackerToolFilter
+ *  \brief Abstract superclass of the filters smoothing the raw transforms
+ *  of a tracker tool.
+ *
+ *  A filter is set on a TrackerTool with TrackerTool::SetFilter(). The
+ *  tracker then filters every raw transform of the tool before composing it
+ *  with the calibration transform. The raw transform of the tool, as
+ *  returned by the tracker tool, is not filtered.
+ *
+ *  This class converts the transforms to plain arrays, skips the samples
+ *  that are repeated with the same time stamp, and restarts the filter
+ *  after a gap in the samples, e.g. when the tool was not visible. The
+ *  derived classes implement the filtering itself in InternalFilter(),
+ *  without allocating memory.
+ *
+ *  The filters are run by the tracker in the thread that drives the pulse
+ *  generators. Their parameters can be changed while tracking, from the
+ *  same thread.
+ *
+ *  \sa TrackerTool
+ *
+ *  \ingroup Tracker
+ */
+class TrackerToolFilter : public Object
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardAbstractClassTraitsMacro( TrackerToolFilter, Object )
+
+  typedef Transform                         TransformType;
+  typedef Transform::TimePeriodType         TimePeriodType;
+
+  /** Filter a new sample. The output keeps the error and the validity
+   *  period of the input. The output may be the input. */
+  void Filter( const TransformType & input, TransformType & output );
+
+  /** Restart the filter at the next sample */
+  void Reset();
+
+  /** Longest interval, in milliseconds, between two samples. After a longer
+   *  interval the filter restarts. */
+  igstkSetMacro( MaximumSampleInterval, TimePeriodType );
+  igstkGetMacro( MaximumSampleInterval, TimePeriodType );
+
+protected:
+
+  TrackerToolFilter();
+  virtual ~TrackerToolFilter();
+
+  /** Filter a sample in place. The rotation is a unit quaternion in the
+   *  order x, y, z, w. The interval is the time, in milliseconds, elapsed
+   *  since the previous sample; it is zero for the first sample after a
+   *  restart. */
+  virtual void InternalFilter( TimePeriodType interval,
+                               double translation[3],
+                               double rotation[4] ) = 0;
+
+  /** Forget the previous samples */
+  virtual void InternalReset() = 0;
+
+  /** Change the sign of a quaternion, if needed, so that it lies in the
+   *  same hemisphere as the reference: q and -q are the same rotation, but
+   *  only the representatives of the same hemisphere can be averaged. */
+  static void AlignRotation( const double reference[4], double rotation[4] );
+
+  /** Angle, in radians, of the rotation from first to second */
+  static double GetRotationAngle( const double first[4],
+                                  const double second[4] );
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  TrackerToolFilter(const Self&);   //purposely not implemented
+  void operator=(const Self&);      //purposely not implemented
+
+  TimePeriodType    m_MaximumSampleInterval;
+
+  /** Time of the last sample, and last output, used for the repeated
+   *  samples */
+  bool              m_Initialized;
+  TimePeriodType    m_SampleTime;
+  double            m_Translation[3];
+  double            m_Rotation[4];
+};
+
+} // end namespace igstk
+
+#endif // __igstkTrackerToolFilter_h
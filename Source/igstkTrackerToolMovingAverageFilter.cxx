@@ -0,0 +1,137 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolMovingAverageFilter.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkTrackerToolMovingAverageFilter.h"
+
+#include <math.h>
+
+namespace igstk
+{
+
+TrackerToolMovingAverageFilter::TrackerToolMovingAverageFilter():
+  m_StateMachine(this)
+{
+  m_WindowSize = 0;
+  this->SetWindowSize( 5 );
+}
+
+TrackerToolMovingAverageFilter::~TrackerToolMovingAverageFilter()
+{
+}
+
+void TrackerToolMovingAverageFilter::SetWindowSize( unsigned int windowSize )
+{
+  if( windowSize == 0 )
+    {
+    windowSize = 1;
+    }
+
+  if( windowSize != m_WindowSize )
+    {
+    m_WindowSize = windowSize;
+    m_Translations.resize( 3 * windowSize );
+    m_Rotations.resize( 4 * windowSize );
+    this->InternalReset();
+    }
+}
+
+void TrackerToolMovingAverageFilter::InternalReset()
+{
+  m_NextSample = 0;
+  m_NumberOfSamples = 0;
+}
+
+void TrackerToolMovingAverageFilter::InternalFilter(
+                                           TimePeriodType itkNotUsed(interval),
+                                           double translation[3],
+                                           double rotation[4] )
+{
+  // Store the sample
+  double * storedTranslation = &m_Translations[3 * m_NextSample];
+  double * storedRotation = &m_Rotations[4 * m_NextSample];
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    storedTranslation[i] = translation[i];
+    }
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    storedRotation[i] = rotation[i];
+    }
+
+  m_NextSample = ( m_NextSample + 1 ) % m_WindowSize;
+  if( m_NumberOfSamples < m_WindowSize )
+    {
+    m_NumberOfSamples++;
+    }
+
+  // Average the samples, with the quaternions in the hemisphere of the
+  // latest one
+  const double reference[4] =
+    { rotation[0], rotation[1], rotation[2], rotation[3] };
+
+  double translationSum[3] = { 0.0, 0.0, 0.0 };
+  double rotationSum[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+  for( unsigned int sample = 0; sample < m_NumberOfSamples; sample++ )
+    {
+    const double * t = &m_Translations[3 * sample];
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      translationSum[i] += t[i];
+      }
+
+    const double * r = &m_Rotations[4 * sample];
+    double q[4] = { r[0], r[1], r[2], r[3] };
+    AlignRotation( reference, q );
+    for( unsigned int i = 0; i < 4; i++ )
+      {
+      rotationSum[i] += q[i];
+      }
+    }
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    translation[i] = translationSum[i] / m_NumberOfSamples;
+    }
+
+  const double norm = sqrt( rotationSum[0] * rotationSum[0] +
+                            rotationSum[1] * rotationSum[1] +
+                            rotationSum[2] * rotationSum[2] +
+                            rotationSum[3] * rotationSum[3] );
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    rotation[i] = rotationSum[i] / norm;
+    }
+}
+
+/** Print Self function */
+void TrackerToolMovingAverageFilter::PrintSelf( std::ostream& os,
+                                                itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Window size: " << m_WindowSize << std::endl;
+  os << indent << "Number of samples: " << m_NumberOfSamples << std::endl;
+}
+
+} // end namespace igstk
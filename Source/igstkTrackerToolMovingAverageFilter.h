@@ -0,0 +1,84 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolMovingAverageFilter.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkTrackerToolMovingAverageFilter_h
+#define __igstkTrackerToolMovingAverageFilter_h
+
+#include "igstkTrackerToolFilter.h"
+
+#include <vector>
+
+namespace igstk
+{
+
+/** \class TrackerToolMovingAverageFilter
+ *  \brief Average of the last samples of a tracker tool.
+ *
+ *  The translation is the mean of the translations of the last WindowSize
+ *  samples. The rotation is the normalized mean of their quaternions, taken
+ *  in the same hemisphere, which is a close approximation of the mean
+ *  rotation for the small spreads due to the jitter of a tracker.
+ *
+ *  The filter delays the motion of the tool by half the window. The
+ *  samples are kept in buffers that are only allocated when the window
+ *  size is set.
+ *
+ *  \ingroup Tracker
+ */
+class TrackerToolMovingAverageFilter : public TrackerToolFilter
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( TrackerToolMovingAverageFilter,
+                                 TrackerToolFilter )
+
+  /** Number of samples averaged, 5 by default */
+  void SetWindowSize( unsigned int windowSize );
+  igstkGetMacro( WindowSize, unsigned int );
+
+protected:
+
+  TrackerToolMovingAverageFilter();
+  virtual ~TrackerToolMovingAverageFilter();
+
+  virtual void InternalFilter( TimePeriodType interval,
+                               double translation[3],
+                               double rotation[4] );
+
+  virtual void InternalReset();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  TrackerToolMovingAverageFilter(const Self&);  //purposely not implemented
+  void operator=(const Self&);                  //purposely not implemented
+
+  unsigned int            m_WindowSize;
+
+  /** Ring buffers of the last samples */
+  std::vector< double >   m_Translations;
+  std::vector< double >   m_Rotations;
+  unsigned int            m_NextSample;
+  unsigned int            m_NumberOfSamples;
+};
+
+} // end namespace igstk
+
+#endif // __igstkTrackerToolMovingAverageFilter_h
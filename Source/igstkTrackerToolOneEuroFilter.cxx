@@ -0,0 +1,133 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolOneEuroFilter.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkTrackerToolOneEuroFilter.h"
+#include "igstkRigidTransform.h"
+
+#include <math.h>
+
+namespace igstk
+{
+
+TrackerToolOneEuroFilter::TrackerToolOneEuroFilter():m_StateMachine(this)
+{
+  m_MinimumCutoffFrequency = 1.0;
+  m_Beta = 0.05;
+  m_RotationBeta = 2.0;
+  m_DerivativeCutoffFrequency = 1.0;
+
+  this->InternalReset();
+}
+
+TrackerToolOneEuroFilter::~TrackerToolOneEuroFilter()
+{
+}
+
+void TrackerToolOneEuroFilter::InternalReset()
+{
+  m_Initialized = false;
+}
+
+double TrackerToolOneEuroFilter::GetSmoothingFactor( double cutoffFrequency,
+                                                   double intervalInSeconds )
+{
+  const double pi = 4.0 * atan( 1.0 );
+  const double timeConstant = 1.0 / ( 2.0 * pi * cutoffFrequency );
+  return 1.0 / ( 1.0 + timeConstant / intervalInSeconds );
+}
+
+void TrackerToolOneEuroFilter::InternalFilter( TimePeriodType interval,
+                                               double translation[3],
+                                               double rotation[4] )
+{
+  if( !m_Initialized || interval <= 0.0 )
+    {
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      m_Translation[i] = translation[i];
+      m_Velocity[i] = 0.0;
+      }
+    for( unsigned int i = 0; i < 4; i++ )
+      {
+      m_Rotation[i] = rotation[i];
+      }
+    m_AngularSpeed = 0.0;
+    m_Initialized = true;
+    return;
+    }
+
+  const double seconds = interval / 1000.0;
+  const double derivativeFactor =
+    GetSmoothingFactor( m_DerivativeCutoffFrequency, seconds );
+
+  // Translation
+  double squaredSpeed = 0.0;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    const double velocity = ( translation[i] - m_Translation[i] ) / seconds;
+    m_Velocity[i] += derivativeFactor * ( velocity - m_Velocity[i] );
+    squaredSpeed += m_Velocity[i] * m_Velocity[i];
+    }
+
+  const double translationFactor = GetSmoothingFactor(
+    m_MinimumCutoffFrequency + m_Beta * sqrt( squaredSpeed ), seconds );
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    m_Translation[i] += translationFactor *
+                        ( translation[i] - m_Translation[i] );
+    translation[i] = m_Translation[i];
+    }
+
+  // Rotation
+  const double angularSpeed =
+    GetRotationAngle( m_Rotation, rotation ) / seconds;
+  m_AngularSpeed += derivativeFactor * ( angularSpeed - m_AngularSpeed );
+
+  const double rotationFactor = GetSmoothingFactor(
+    m_MinimumCutoffFrequency + m_RotationBeta * m_AngularSpeed, seconds );
+
+  RigidTransform::InterpolateRotation( m_Rotation, rotation, rotationFactor,
+                                       m_Rotation );
+
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    rotation[i] = m_Rotation[i];
+    }
+}
+
+/** Print Self function */
+void TrackerToolOneEuroFilter::PrintSelf( std::ostream& os,
+                                          itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Minimum cutoff frequency: "
+     << m_MinimumCutoffFrequency << std::endl;
+  os << indent << "Beta: " << m_Beta << std::endl;
+  os << indent << "Rotation beta: " << m_RotationBeta << std::endl;
+  os << indent << "Derivative cutoff frequency: "
+     << m_DerivativeCutoffFrequency << std::endl;
+}
+
+} // end namespace igstk
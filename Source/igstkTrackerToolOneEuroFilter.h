@@ -0,0 +1,105 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolOneEuroFilter.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkTrackerToolOneEuroFilter_h
+#define __igstkTrackerToolOneEuroFilter_h
+
+#include "igstkTrackerToolFilter.h"
+
+namespace igstk
+{
+
+/** \class TrackerToolOneEuroFilter
+ *  \brief One Euro filter of the poses of a tracker tool.
+ *
+ *  The One Euro filter (Casiez, Roussel and Vogel, CHI 2012) is a first
+ *  order low-pass filter whose cutoff frequency increases with the speed of
+ *  the tool: a tool at rest is smoothed strongly, which removes the jitter,
+ *  while a moving tool is followed with little lag.
+ *
+ *  The cutoff frequency is MinimumCutoffFrequency + Beta * speed, where the
+ *  speed is itself low-pass filtered at DerivativeCutoffFrequency. The
+ *  translation and the rotation are filtered separately: the translation
+ *  with its linear speed, in millimeters per second, and the rotation,
+ *  along the shortest arc, with its angular speed, in radians per second.
+ *
+ *  \ingroup Tracker
+ */
+class TrackerToolOneEuroFilter : public TrackerToolFilter
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( TrackerToolOneEuroFilter,
+                                 TrackerToolFilter )
+
+  /** Cutoff frequency, in Hertz, of a tool at rest. 1 Hz by default. */
+  igstkSetMacro( MinimumCutoffFrequency, double );
+  igstkGetMacro( MinimumCutoffFrequency, double );
+
+  /** Increase of the cutoff frequency of the translation with the linear
+   *  speed, in Hertz per millimeter per second. 0.05 by default. */
+  igstkSetMacro( Beta, double );
+  igstkGetMacro( Beta, double );
+
+  /** Increase of the cutoff frequency of the rotation with the angular
+   *  speed, in Hertz per radian per second. 2 by default. */
+  igstkSetMacro( RotationBeta, double );
+  igstkGetMacro( RotationBeta, double );
+
+  /** Cutoff frequency, in Hertz, of the speeds. 1 Hz by default. */
+  igstkSetMacro( DerivativeCutoffFrequency, double );
+  igstkGetMacro( DerivativeCutoffFrequency, double );
+
+protected:
+
+  TrackerToolOneEuroFilter();
+  virtual ~TrackerToolOneEuroFilter();
+
+  virtual void InternalFilter( TimePeriodType interval,
+                               double translation[3],
+                               double rotation[4] );
+
+  virtual void InternalReset();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  TrackerToolOneEuroFilter(const Self&);  //purposely not implemented
+  void operator=(const Self&);            //purposely not implemented
+
+  /** Weight of a new sample in a first order low-pass filter */
+  static double GetSmoothingFactor( double cutoffFrequency,
+                                    double intervalInSeconds );
+
+  double            m_MinimumCutoffFrequency;
+  double            m_Beta;
+  double            m_RotationBeta;
+  double            m_DerivativeCutoffFrequency;
+
+  bool              m_Initialized;
+  double            m_Translation[3];
+  double            m_Velocity[3];
+  double            m_Rotation[4];
+  double            m_AngularSpeed;
+};
+
+} // end namespace igstk
+
+#endif // __igstkTrackerToolOneEuroFilter_h
@@ -0,0 +1,275 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolPredictor.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkTrackerToolPredictor.h"
+
+#include <math.h>
+
+namespace igstk
+{
+
+namespace
+{
+
+/** Weight of a new residual in the mean square residuals */
+const double ResidualWeight = 0.1;
+
+/** Product a * b of quaternions stored in the order x, y, z, w. The
+ *  result may be one of the operands. */
+void MultiplyQuaternions( const double a[4], const double b[4],
+                          double result[4] )
+{
+  const double x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+  const double y = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+  const double z = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+  const double w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+  result[0] = x;
+  result[1] = y;
+  result[2] = z;
+  result[3] = w;
+}
+
+/** Unit quaternion of the rotation vector v scaled by factor */
+void QuaternionFromRotationVector( const double v[3], double factor,
+                                   double q[4] )
+{
+  const double angle = factor *
+                       sqrt( v[0] * v[0] + v[1] * v[1] + v[2] * v[2] );
+  // sin(angle/2)/angle, with its limit for small angles
+  const double scale = ( angle > 1e-9 ) ?
+                       sin( 0.5 * angle ) / angle : 0.5;
+  q[0] = factor * v[0] * scale;
+  q[1] = factor * v[1] * scale;
+  q[2] = factor * v[2] * scale;
+  q[3] = cos( 0.5 * angle );
+}
+
+/** Rotation vector of the shortest rotation equivalent to q */
+void RotationVectorFromQuaternion( const double q[4], double v[3] )
+{
+  const double sign = ( q[3] < 0.0 ) ? -1.0 : 1.0;
+  const double s = sqrt( q[0] * q[0] + q[1] * q[1] + q[2] * q[2] );
+  const double angle = 2.0 * atan2( s, sign * q[3] );
+  const double scale = ( s > 1e-9 ) ? sign * angle / s : 2.0 * sign;
+  v[0] = q[0] * scale;
+  v[1] = q[1] * scale;
+  v[2] = q[2] * scale;
+}
+
+void NormalizeQuaternion( double q[4] )
+{
+  const double norm = sqrt( q[0] * q[0] + q[1] * q[1] +
+                            q[2] * q[2] + q[3] * q[3] );
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    q[i] /= norm;
+    }
+}
+
+}
+
+
+TrackerToolPredictor::TrackerToolPredictor():m_StateMachine(this)
+{
+  m_Alpha = 0.5;
+  m_Beta = 0.2;
+  m_PredictionHorizon = 0.0;
+  m_MaximumPredictionInterval = 200.0;
+  m_MaximumSampleInterval = 500.0;
+
+  this->Reset();
+}
+
+TrackerToolPredictor::~TrackerToolPredictor()
+{
+}
+
+void TrackerToolPredictor::Reset()
+{
+  m_NumberOfSamples = 0;
+  m_SampleTime = 0.0;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    m_Position[i] = 0.0;
+    m_Velocity[i] = 0.0;
+    m_Orientation[i] = 0.0;
+    m_AngularVelocity[i] = 0.0;
+    }
+  m_Orientation[3] = 1.0;
+
+  m_TranslationResidual = 0.0;
+  m_RotationResidual = 0.0;
+  m_TranslationResidualMeanSquare = 0.0;
+  m_RotationResidualMeanSquare = 0.0;
+}
+
+void TrackerToolPredictor::Predict( const TransformType & sample,
+                                    TimePeriodType currentTime,
+                                    TransformType & prediction )
+{
+  const TransformType::VectorType & translation = sample.GetTranslation();
+  const TransformType::VersorType & rotation = sample.GetRotation();
+
+  const double measuredPosition[3] =
+    { translation[0], translation[1], translation[2] };
+  const double measuredOrientation[4] =
+    { rotation.GetX(), rotation.GetY(), rotation.GetZ(), rotation.GetW() };
+
+  const TimePeriodType sampleTime = sample.GetStartTime();
+  const TimePeriodType interval = sampleTime - m_SampleTime;
+
+  if( m_NumberOfSamples == 0 || interval > m_MaximumSampleInterval ||
+      interval < 0.0 )
+    {
+    // Start with the sample, at rest
+    this->Reset();
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      m_Position[i] = measuredPosition[i];
+      }
+    for( unsigned int i = 0; i < 4; i++ )
+      {
+      m_Orientation[i] = measuredOrientation[i];
+      }
+    m_SampleTime = sampleTime;
+    m_NumberOfSamples = 1;
+    }
+  else if( interval > 0.0 )
+    {
+    // Position: predict, then correct with the residual
+    double residual[3];
+    double squaredNorm = 0.0;
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      const double predicted = m_Position[i] + m_Velocity[i] * interval;
+      residual[i] = measuredPosition[i] - predicted;
+      squaredNorm += residual[i] * residual[i];
+      m_Position[i] = predicted + m_Alpha * residual[i];
+      m_Velocity[i] += ( m_Beta / interval ) * residual[i];
+      }
+    m_TranslationResidual = sqrt( squaredNorm );
+
+    // Orientation: the same in the tangent space of the rotations
+    double increment[4];
+    double predicted[4];
+    QuaternionFromRotationVector( m_AngularVelocity, interval, increment );
+    MultiplyQuaternions( increment, m_Orientation, predicted );
+
+    const double inversePredicted[4] =
+      { -predicted[0], -predicted[1], -predicted[2], predicted[3] };
+    double residualRotation[4];
+    MultiplyQuaternions( measuredOrientation, inversePredicted,
+                         residualRotation );
+
+    double rotationResidual[3];
+    RotationVectorFromQuaternion( residualRotation, rotationResidual );
+
+    double correction[4];
+    QuaternionFromRotationVector( rotationResidual, m_Alpha, correction );
+    MultiplyQuaternions( correction, predicted, m_Orientation );
+    NormalizeQuaternion( m_Orientation );
+
+    squaredNorm = 0.0;
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      m_AngularVelocity[i] += ( m_Beta / interval ) * rotationResidual[i];
+      squaredNorm += rotationResidual[i] * rotationResidual[i];
+      }
+    m_RotationResidual = sqrt( squaredNorm );
+
+    m_TranslationResidualMeanSquare += ResidualWeight *
+      ( m_TranslationResidual * m_TranslationResidual -
+        m_TranslationResidualMeanSquare );
+    m_RotationResidualMeanSquare += ResidualWeight *
+      ( m_RotationResidual * m_RotationResidual -
+        m_RotationResidualMeanSquare );
+
+    m_SampleTime = sampleTime;
+    m_NumberOfSamples++;
+    }
+
+  // Extrapolate to the display time
+  TimePeriodType horizon = currentTime + m_PredictionHorizon - m_SampleTime;
+  if( horizon < 0.0 )
+    {
+    horizon = 0.0;
+    }
+  if( horizon > m_MaximumPredictionInterval )
+    {
+    horizon = m_MaximumPredictionInterval;
+    }
+
+  TransformType::VectorType predictedTranslation;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    predictedTranslation[i] = m_Position[i] + m_Velocity[i] * horizon;
+    }
+
+  double increment[4];
+  double predictedOrientation[4];
+  QuaternionFromRotationVector( m_AngularVelocity, horizon, increment );
+  MultiplyQuaternions( increment, m_Orientation, predictedOrientation );
+  NormalizeQuaternion( predictedOrientation );
+
+  TransformType::VersorType predictedRotation;
+  predictedRotation.Set( predictedOrientation[0], predictedOrientation[1],
+                         predictedOrientation[2], predictedOrientation[3] );
+
+  prediction.SetTranslationAndRotation( predictedTranslation,
+                                        predictedRotation,
+                                        sample.GetError(),
+                                        sample.GetStartTime(),
+                                        sample.GetExpirationTime() );
+}
+
+double TrackerToolPredictor::GetTranslationResidualRMS() const
+{
+  return sqrt( m_TranslationResidualMeanSquare );
+}
+
+double TrackerToolPredictor::GetRotationResidualRMS() const
+{
+  return sqrt( m_RotationResidualMeanSquare );
+}
+
+/** Print Self function */
+void TrackerToolPredictor::PrintSelf( std::ostream& os,
+                                      itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Alpha: " << m_Alpha << std::endl;
+  os << indent << "Beta: " << m_Beta << std::endl;
+  os << indent << "Prediction horizon: " << m_PredictionHorizon << std::endl;
+  os << indent << "Maximum prediction interval: "
+     << m_MaximumPredictionInterval << std::endl;
+  os << indent << "Maximum sample interval: "
+     << m_MaximumSampleInterval << std::endl;
+  os << indent << "Number of samples: " << m_NumberOfSamples << std::endl;
+  os << indent << "Translation residual RMS: "
+     << this->GetTranslationResidualRMS() << std::endl;
+  os << indent << "Rotation residual RMS: "
+     << this->GetRotationResidualRMS() << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,148 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolPredictor.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkTrackerToolPredictor_h
+#define __igstkTrackerToolPredictor_h
+
+#include "igstkObject.h"
+#include "igstkTransform.h"
+#include "igstkMacros.h"
+
+namespace igstk
+{
+
+/** \class TrackerToolPredictor
+ *  \brief Alpha-beta filter extrapolating the pose of a tracker tool.
+ *
+ *  The predictor compensates the latency between the acquisition of a
+ *  tracking sample and the display of the frame that shows it. It keeps a
+ *  position, an orientation and their velocities, corrects them with every
+ *  new sample as an alpha-beta filter, and extrapolates them at constant
+ *  velocity to the estimated display time: the current time plus the
+ *  prediction horizon. The horizon should be set to the measured delay
+ *  between the update of the tracker and the display, i.e. the glass to
+ *  glass latency minus the age of the samples.
+ *
+ *  With Alpha and Beta set to one, the filter extrapolates the line going
+ *  through the last two samples. Smaller values smooth the velocity, at the
+ *  cost of a slower response to accelerations.
+ *
+ *  The residuals, i.e. the difference between every new sample and its
+ *  prediction from the previous samples, are available for monitoring the
+ *  quality of the prediction.
+ *
+ *  A predictor is set on a TrackerTool, and is then updated by the tracker
+ *  for every sample of the tool, in the thread that drives the pulse
+ *  generators.
+ *
+ *  \sa TrackerTool
+ *
+ *  \ingroup Tracker
+ */
+class TrackerToolPredictor : public Object
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( TrackerToolPredictor, Object )
+
+  typedef Transform                         TransformType;
+  typedef Transform::TimePeriodType         TimePeriodType;
+
+  /** Gain of the position and orientation correction, in ]0,1] */
+  igstkSetMacro( Alpha, double );
+  igstkGetMacro( Alpha, double );
+
+  /** Gain of the velocity correction, in ]0,2[ */
+  igstkSetMacro( Beta, double );
+  igstkGetMacro( Beta, double );
+
+  /** Delay, in milliseconds, between the update of the tracker and the
+   *  display of the tool */
+  igstkSetMacro( PredictionHorizon, TimePeriodType );
+  igstkGetMacro( PredictionHorizon, TimePeriodType );
+
+  /** Longest extrapolation, in milliseconds, after the last sample */
+  igstkSetMacro( MaximumPredictionInterval, TimePeriodType );
+  igstkGetMacro( MaximumPredictionInterval, TimePeriodType );
+
+  /** Longest interval, in milliseconds, between two samples. After a longer
+   *  interval, e.g. when the tool was not visible, the filter restarts. */
+  igstkSetMacro( MaximumSampleInterval, TimePeriodType );
+  igstkGetMacro( MaximumSampleInterval, TimePeriodType );
+
+  /** Update the filter with a new sample, and compute the transform
+   *  extrapolated to currentTime plus the prediction horizon. The time of
+   *  the sample is its start time. The prediction keeps the error and the
+   *  validity period of the sample. */
+  void Predict( const TransformType & sample,
+                TimePeriodType currentTime,
+                TransformType & prediction );
+
+  /** Restart the filter at the next sample */
+  void Reset();
+
+  /** Distance, in millimeters, and angle, in radians, between the last
+   *  sample and its prediction from the previous samples */
+  igstkGetMacro( TranslationResidual, double );
+  igstkGetMacro( RotationResidual, double );
+
+  /** Root mean square of the residuals, averaged exponentially over the
+   *  recent samples */
+  double GetTranslationResidualRMS() const;
+  double GetRotationResidualRMS() const;
+
+  /** Number of samples since the filter started */
+  igstkGetMacro( NumberOfSamples, unsigned long );
+
+protected:
+
+  TrackerToolPredictor();
+  virtual ~TrackerToolPredictor();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  TrackerToolPredictor(const Self&);   //purposely not implemented
+  void operator=(const Self&);         //purposely not implemented
+
+  double            m_Alpha;
+  double            m_Beta;
+  TimePeriodType    m_PredictionHorizon;
+  TimePeriodType    m_MaximumPredictionInterval;
+  TimePeriodType    m_MaximumSampleInterval;
+
+  /** State of the filter at the time of the last sample. The velocities
+   *  are per millisecond, the angular velocity is a rotation vector. */
+  TimePeriodType    m_SampleTime;
+  double            m_Position[3];
+  double            m_Velocity[3];
+  double            m_Orientation[4];
+  double            m_AngularVelocity[3];
+
+  unsigned long     m_NumberOfSamples;
+  double            m_TranslationResidual;
+  double            m_RotationResidual;
+  double            m_TranslationResidualMeanSquare;
+  double            m_RotationResidualMeanSquare;
+};
+
+} // end namespace igstk
+
+#endif // __igstkTrackerToolPredictor_h
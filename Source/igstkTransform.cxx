@@ -44,7 +44,8 @@ Transform
 
 Transform 
 Transform
-::TransformCompose( Transform leftTransform, Transform rightTransform )
+::TransformCompose( const Transform & leftTransform, 
+                    const Transform & rightTransform )
 {
   VersorType rotation;
   VectorType translation;
@@ -99,6 +100,22 @@ Transform
 }
 
 
+void 
+Transform
+::SetTranslationAndRotation(
+          const  VectorType & translation,
+          const  VersorType & rotation,
+          TransformBase::ErrorType errorValue,
+          TimeStamp::TimePeriodType startTime,
+          TimeStamp::TimePeriodType expirationTime )
+{
+  m_TimeStamp.SetStartTimeAndExpirationTime( startTime, expirationTime );
+  m_Translation = translation;
+  m_Rotation    = rotation;
+  m_Error       = errorValue;
+}
+
+
 void 
 Transform
 ::SetTranslation(
@@ -70,8 +70,8 @@ public:
   virtual ~Transform();
 
   /** Transform composition method */
-  static Transform TransformCompose( Transform leftTransform, 
-                                     Transform rightTransform );
+  static Transform TransformCompose( const Transform & leftTransform, 
+                                     const Transform & rightTransform );
 
   /** Assign the values of one transform to another */
   const Transform & operator=( const Transform & inputTransform );
@@ -86,6 +86,16 @@ public:
           TransformBase::ErrorType errorValue,
           TimeStamp::TimePeriodType millisecondsToExpiration );
 
+  /** Set Translation and Rotation simultaneously, along with an explicit
+   * validity period. This is used to restore transforms whose time stamp was
+   * recorded earlier, such as the ones stored in a RigidTransform. */
+  void SetTranslationAndRotation(
+          const  VectorType & translation,
+          const  VersorType & rotation,
+          TransformBase::ErrorType errorValue,
+          TimeStamp::TimePeriodType startTime,
+          TimeStamp::TimePeriodType expirationTime );
+
 
   /** Set only Rotation. This method should be used when the transform
    * represents only a rotation. Internally the translational part of the
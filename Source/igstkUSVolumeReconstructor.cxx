@@ -0,0 +1,490 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkUSVolumeReconstructor.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkUSVolumeReconstructor.h"
+
+#include <math.h>
+#include <algorithm>
+
+namespace igstk
+{
+
+/** Constructor */
+USVolumeReconstructor::USVolumeReconstructor():m_StateMachine(this)
+{
+  m_ImageSpacing[0] = 1.0;
+  m_ImageSpacing[1] = 1.0;
+  m_ImageToProbeTransform.SetToIdentity(
+                                  TimeStamp::GetLongestPossibleTime() );
+  m_Interpolation = LinearInterpolation;
+  m_Incremental = true;
+  m_HoleFillingRadius = 1;
+  m_NumberOfInsertedFrames = 0;
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    m_Origin[i] = 0.0;
+    m_Spacing[i] = 1.0;
+    m_Size[i] = 0;
+    }
+
+  m_USImage = USImageObject::New();
+  m_Threader = itk::MultiThreader::New();
+}
+
+/** Destructor */
+USVolumeReconstructor::~USVolumeReconstructor()
+{
+}
+
+void USVolumeReconstructor::SetOutputGeometry( const double origin[3],
+                                               const double spacing[3],
+                                               const unsigned int size[3] )
+{
+  ImageType::SizeType imageSize;
+  ImageType::IndexType imageStart;
+  ImageType::SpacingType imageSpacing;
+  ImageType::PointType imageOrigin;
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    m_Origin[i] = origin[i];
+    m_Spacing[i] = spacing[i];
+    m_Size[i] = size[i];
+    imageSize[i] = size[i];
+    imageStart[i] = 0;
+    imageSpacing[i] = spacing[i];
+    imageOrigin[i] = origin[i];
+    }
+
+  ImageType::RegionType region;
+  region.SetSize( imageSize );
+  region.SetIndex( imageStart );
+
+  m_Image = ImageType::New();
+  m_Image->SetRegions( region );
+  m_Image->SetSpacing( imageSpacing );
+  m_Image->SetOrigin( imageOrigin );
+  m_Image->Allocate();
+
+  const unsigned long numberOfVoxels =
+    static_cast< unsigned long >( size[0] ) * size[1] * size[2];
+  m_Accumulator.resize( numberOfVoxels );
+  m_Weights.resize( numberOfVoxels );
+
+  this->Reset();
+
+  typedef Friends::USVolumeReconstructorToImageSpatialObject  HelperType;
+  HelperType::SetITKImage( this, m_USImage.GetPointer() );
+}
+
+void USVolumeReconstructor::SetImageSpacing( const double spacing[2] )
+{
+  m_ImageSpacing[0] = spacing[0];
+  m_ImageSpacing[1] = spacing[1];
+}
+
+void USVolumeReconstructor::SetImageToProbeTransform(
+                                           const TransformType & transform )
+{
+  m_ImageToProbeTransform = transform;
+}
+
+void USVolumeReconstructor::Reset()
+{
+  std::fill( m_Accumulator.begin(), m_Accumulator.end(), 0.0f );
+  std::fill( m_Weights.begin(), m_Weights.end(), 0.0f );
+  if( m_Image.IsNotNull() )
+    {
+    m_Image->FillBuffer( 0 );
+    m_Image->Modified();
+    }
+  m_NumberOfInsertedFrames = 0;
+}
+
+bool
+USVolumeReconstructor::InsertFrame( Frame * frame,
+                                    const TransformType & probeToReference )
+{
+  if( !frame || m_Image.IsNull() || m_Accumulator.empty() )
+    {
+    return false;
+    }
+
+  InsertionJobType job;
+  job.m_Reconstructor = this;
+  job.m_Pixels = static_cast< const unsigned char * >( frame->GetImagePtr() );
+  job.m_Width = frame->GetWidth();
+  job.m_Height = frame->GetHeight();
+  job.m_NumberOfChannels = frame->GetNumberOfChannels();
+  if( !job.m_Pixels || job.m_Width == 0 || job.m_Height == 0 )
+    {
+    return false;
+    }
+  if( job.m_NumberOfChannels == 0 )
+    {
+    job.m_NumberOfChannels = 1;
+    }
+
+  // Geometry of the frame in the continuous index space of the volume
+  const TransformType imageToReference =
+    TransformType::TransformCompose( probeToReference,
+                                     m_ImageToProbeTransform );
+  const TransformType::VersorType::MatrixType rotation =
+                                   imageToReference.GetRotation().GetMatrix();
+  const TransformType::VectorType translation =
+                                   imageToReference.GetTranslation();
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    job.m_IndexOrigin[i] = ( translation[i] - m_Origin[i] ) / m_Spacing[i];
+    job.m_IndexStepX[i] = m_ImageSpacing[0] * rotation[i][0] / m_Spacing[i];
+    job.m_IndexStepY[i] = m_ImageSpacing[1] * rotation[i][1] / m_Spacing[i];
+    }
+
+  // Pixels further apart than two voxel diagonals never reach the same
+  // voxel, even with the trilinear splatting. Rows that are at least that
+  // many rows apart can be splatted by different threads.
+  const double voxelDiagonal = sqrt( m_Spacing[0] * m_Spacing[0] +
+                                     m_Spacing[1] * m_Spacing[1] +
+                                     m_Spacing[2] * m_Spacing[2] );
+  const unsigned int numberOfThreads = m_Threader->GetNumberOfThreads();
+  const unsigned int conflictRows = static_cast< unsigned int >(
+                 ceil( 2.0 * voxelDiagonal / fabs( m_ImageSpacing[1] ) ) );
+  const unsigned int threadRows =
+                 ( job.m_Height + 2 * numberOfThreads - 1 ) /
+                 ( 2 * numberOfThreads );
+  job.m_BlockSize = ( conflictRows > threadRows ) ? conflictRows : threadRows;
+  if( job.m_BlockSize == 0 )
+    {
+    job.m_BlockSize = 1;
+    }
+
+  if( numberOfThreads < 2 || job.m_BlockSize >= job.m_Height )
+    {
+    this->InsertRows( job, 0, job.m_Height );
+    }
+  else
+    {
+    for( job.m_Parity = 0; job.m_Parity < 2; job.m_Parity++ )
+      {
+      m_Threader->SetSingleMethod( InsertionThreadFunction, &job );
+      m_Threader->SingleMethodExecute();
+      }
+    }
+
+  m_NumberOfInsertedFrames++;
+  if( m_Incremental )
+    {
+    m_Image->Modified();
+    }
+
+  return true;
+}
+
+ITK_THREAD_RETURN_TYPE
+USVolumeReconstructor::InsertionThreadFunction( void * info )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)info;
+
+  const InsertionJobType * job =
+    static_cast< const InsertionJobType * >( pInfo->UserData );
+
+  const unsigned int numberOfBlocks =
+    ( job->m_Height + job->m_BlockSize - 1 ) / job->m_BlockSize;
+  const unsigned int threadId = pInfo->ThreadID;
+  const unsigned int numberOfThreads = pInfo->NumberOfThreads;
+
+  // Blocks of the current parity are dealt among the threads
+  for( unsigned int block = job->m_Parity + 2 * threadId;
+       block < numberOfBlocks; block += 2 * numberOfThreads )
+    {
+    const unsigned int firstRow = block * job->m_BlockSize;
+    unsigned int lastRow = firstRow + job->m_BlockSize;
+    if( lastRow > job->m_Height )
+      {
+      lastRow = job->m_Height;
+      }
+    job->m_Reconstructor->InsertRows( *job, firstRow, lastRow );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void USVolumeReconstructor::InsertRows( const InsertionJobType & job,
+                                        unsigned int firstRow,
+                                        unsigned int lastRow )
+{
+  const long sizeX = m_Size[0];
+  const long sizeY = m_Size[1];
+  const long sizeZ = m_Size[2];
+  const long strideY = sizeX;
+  const long strideZ = sizeX * sizeY;
+
+  float * accumulator = &m_Accumulator[0];
+  float * weights = &m_Weights[0];
+  ImageType::PixelType * output = m_Image->GetBufferPointer();
+  const bool incremental = m_Incremental;
+
+  for( unsigned int j = firstRow; j < lastRow; j++ )
+    {
+    const unsigned char * pixel =
+      job.m_Pixels + static_cast< unsigned long >( j ) * job.m_Width *
+                     job.m_NumberOfChannels;
+
+    double index[3];
+    for( unsigned int k = 0; k < 3; k++ )
+      {
+      index[k] = job.m_IndexOrigin[k] + j * job.m_IndexStepY[k];
+      }
+
+    for( unsigned int i = 0; i < job.m_Width; i++ )
+      {
+      const float value = *pixel;
+      pixel += job.m_NumberOfChannels;
+
+      if( m_Interpolation == NearestNeighborInterpolation )
+        {
+        const long x = static_cast< long >( floor( index[0] + 0.5 ) );
+        const long y = static_cast< long >( floor( index[1] + 0.5 ) );
+        const long z = static_cast< long >( floor( index[2] + 0.5 ) );
+        if( x >= 0 && x < sizeX && y >= 0 && y < sizeY &&
+            z >= 0 && z < sizeZ )
+          {
+          const long voxel = x + y * strideY + z * strideZ;
+          accumulator[voxel] += value;
+          weights[voxel] += 1.0f;
+          if( incremental )
+            {
+            output[voxel] = static_cast< ImageType::PixelType >(
+                              accumulator[voxel] / weights[voxel] + 0.5f );
+            }
+          }
+        }
+      else
+        {
+        const double fx = floor( index[0] );
+        const double fy = floor( index[1] );
+        const double fz = floor( index[2] );
+        const long x = static_cast< long >( fx );
+        const long y = static_cast< long >( fy );
+        const long z = static_cast< long >( fz );
+        const double tx = index[0] - fx;
+        const double ty = index[1] - fy;
+        const double tz = index[2] - fz;
+
+        if( x >= -1 && x < sizeX && y >= -1 && y < sizeY &&
+            z >= -1 && z < sizeZ )
+          {
+          for( unsigned int corner = 0; corner < 8; corner++ )
+            {
+            const long cx = x + ( corner & 1 );
+            const long cy = y + ( ( corner >> 1 ) & 1 );
+            const long cz = z + ( ( corner >> 2 ) & 1 );
+            if( cx < 0 || cx >= sizeX || cy < 0 || cy >= sizeY ||
+                cz < 0 || cz >= sizeZ )
+              {
+              continue;
+              }
+            const float weight = static_cast< float >(
+              ( ( corner & 1 ) ? tx : 1.0 - tx ) *
+              ( ( corner & 2 ) ? ty : 1.0 - ty ) *
+              ( ( corner & 4 ) ? tz : 1.0 - tz ) );
+            if( weight <= 0.0f )
+              {
+              continue;
+              }
+            const long voxel = cx + cy * strideY + cz * strideZ;
+            accumulator[voxel] += weight * value;
+            weights[voxel] += weight;
+            if( incremental )
+              {
+              output[voxel] = static_cast< ImageType::PixelType >(
+                                accumulator[voxel] / weights[voxel] + 0.5f );
+              }
+            }
+          }
+        }
+
+      index[0] += job.m_IndexStepX[0];
+      index[1] += job.m_IndexStepX[1];
+      index[2] += job.m_IndexStepX[2];
+      }
+    }
+}
+
+void USVolumeReconstructor::Finalize()
+{
+  if( m_Image.IsNull() )
+    {
+    return;
+    }
+
+  // In incremental mode the non empty voxels are up to date
+  const bool fillHoles = ( m_HoleFillingRadius > 0 );
+  if( m_Incremental && !fillHoles )
+    {
+    return;
+    }
+
+  FinalizeJobType job;
+  job.m_Reconstructor = this;
+  job.m_FillHoles = fillHoles;
+
+  if( m_Threader->GetNumberOfThreads() < 2 )
+    {
+    this->ComputeSlices( 0, m_Size[2], fillHoles );
+    }
+  else
+    {
+    m_Threader->SetSingleMethod( FinalizeThreadFunction, &job );
+    m_Threader->SingleMethodExecute();
+    }
+
+  m_Image->Modified();
+}
+
+ITK_THREAD_RETURN_TYPE
+USVolumeReconstructor::FinalizeThreadFunction( void * info )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)info;
+
+  const FinalizeJobType * job =
+    static_cast< const FinalizeJobType * >( pInfo->UserData );
+
+  const unsigned long numberOfSlices = job->m_Reconstructor->m_Size[2];
+  const unsigned long threadId = pInfo->ThreadID;
+  const unsigned long numberOfThreads = pInfo->NumberOfThreads;
+
+  const unsigned int firstSlice = static_cast< unsigned int >(
+                        ( numberOfSlices * threadId ) / numberOfThreads );
+  const unsigned int lastSlice = static_cast< unsigned int >(
+                  ( numberOfSlices * ( threadId + 1 ) ) / numberOfThreads );
+
+  job->m_Reconstructor->ComputeSlices( firstSlice, lastSlice,
+                                       job->m_FillHoles );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void USVolumeReconstructor::ComputeSlices( unsigned int firstSlice,
+                                           unsigned int lastSlice,
+                                           bool fillHoles )
+{
+  const long sizeX = m_Size[0];
+  const long sizeY = m_Size[1];
+  const long sizeZ = m_Size[2];
+  const long strideY = sizeX;
+  const long strideZ = sizeX * sizeY;
+  const long radius = m_HoleFillingRadius;
+
+  const float * accumulator = &m_Accumulator[0];
+  const float * weights = &m_Weights[0];
+  ImageType::PixelType * output = m_Image->GetBufferPointer();
+
+  // Only the buffers are read, so the slices are independent
+  for( long z = firstSlice; z < static_cast< long >( lastSlice ); z++ )
+    {
+    for( long y = 0; y < sizeY; y++ )
+      {
+      for( long x = 0; x < sizeX; x++ )
+        {
+        const long voxel = x + y * strideY + z * strideZ;
+        float sum = accumulator[voxel];
+        float weight = weights[voxel];
+
+        if( weight <= 0.0f && fillHoles )
+          {
+          for( long nz = z - radius; nz <= z + radius; nz++ )
+            {
+            for( long ny = y - radius; ny <= y + radius; ny++ )
+              {
+              for( long nx = x - radius; nx <= x + radius; nx++ )
+                {
+                if( nx < 0 || nx >= sizeX || ny < 0 || ny >= sizeY ||
+                    nz < 0 || nz >= sizeZ )
+                  {
+                  continue;
+                  }
+                const long neighbor = nx + ny * strideY + nz * strideZ;
+                sum += accumulator[neighbor];
+                weight += weights[neighbor];
+                }
+              }
+            }
+          }
+
+        output[voxel] = ( weight > 0.0f ) ?
+          static_cast< ImageType::PixelType >( sum / weight + 0.5f ) : 0;
+        }
+      }
+    }
+}
+
+const USVolumeReconstructor::ImageType *
+USVolumeReconstructor::GetITKImage() const
+{
+  return m_Image;
+}
+
+void USVolumeReconstructor::RequestGetImage()
+{
+  if( m_Image.IsNull() )
+    {
+    return;
+    }
+
+  typedef Friends::USVolumeReconstructorToImageSpatialObject  HelperType;
+  HelperType::SetITKImage( this, m_USImage.GetPointer() );
+
+  ImageModifiedEvent  event;
+  event.Set( this->m_USImage );
+  this->InvokeEvent( event );
+}
+
+/** Print Self function */
+void USVolumeReconstructor::PrintSelf( std::ostream& os,
+                                       itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Origin: " << m_Origin[0] << " " << m_Origin[1] << " "
+     << m_Origin[2] << std::endl;
+  os << indent << "Spacing: " << m_Spacing[0] << " " << m_Spacing[1] << " "
+     << m_Spacing[2] << std::endl;
+  os << indent << "Size: " << m_Size[0] << " " << m_Size[1] << " "
+     << m_Size[2] << std::endl;
+  os << indent << "Image spacing: " << m_ImageSpacing[0] << " "
+     << m_ImageSpacing[1] << std::endl;
+  os << indent << "Interpolation: " << m_Interpolation << std::endl;
+  os << indent << "Incremental: " << m_Incremental << std::endl;
+  os << indent << "Hole filling radius: " << m_HoleFillingRadius
+     << std::endl;
+  os << indent << "Number of inserted frames: " << m_NumberOfInsertedFrames
+     << std::endl;
+  os << indent << "USImage: " << m_USImage.GetPointer() << std::endl;
+}
+
+} // end namespace igstk
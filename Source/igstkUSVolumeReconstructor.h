@@ -0,0 +1,243 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkUSVolumeReconstructor.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkUSVolumeReconstructor_h
+#define __igstkUSVolumeReconstructor_h
+
+#include "igstkObject.h"
+#include "igstkMacros.h"
+#include "igstkTransform.h"
+#include "igstkFrame.h"
+#include "igstkUSImageObject.h"
+
+#include "itkMultiThreader.h"
+
+#include <vector>
+
+namespace igstk
+{
+
+namespace Friends
+{
+
+/** \class USVolumeReconstructorToImageSpatialObject
+ *
+ * \brief This class is intended to make the connection between the
+ * USVolumeReconstructor and its output, the USImageObject.
+ *
+ */
+class USVolumeReconstructorToImageSpatialObject
+{
+
+public:
+  template < class TReconstructor, class TImageSpatialObject >
+  static void
+  SetITKImage( const TReconstructor * reconstructor,
+               TImageSpatialObject * imageSpatialObject )
+    {
+    imageSpatialObject->RequestSetImage( reconstructor->GetITKImage() );
+    }
+
+}; // end of USVolumeReconstructorToImageSpatialObject class
+
+} // end of Friend namespace
+
+
+/** \class USVolumeReconstructor
+ *
+ * \brief Reconstructs a 3D ultrasound volume from tracked 2D frames.
+ *
+ * The volume is an axis aligned grid in the reference coordinate system of
+ * the tracker, set with SetOutputGeometry(). Every frame is inserted with
+ * the transform from the probe to the reference at the time the frame was
+ * acquired. The transform from the image to the probe is the calibration
+ * of the probe, and the image spacing gives the size of the pixels in
+ * millimeters. Pixel (i,j) of a frame is at (i * spacing[0], j * spacing[1],
+ * 0) in the image coordinate system. Only the first channel of the frames
+ * is used.
+ *
+ * The pixels are splatted in an accumulation buffer and a weight buffer,
+ * either in the nearest voxel or in the eight surrounding voxels with
+ * trilinear weights. A voxel of the volume is the weighted mean of the
+ * pixels splatted in it. In incremental mode the voxels are updated as the
+ * frames are inserted, so the volume can be displayed during the sweep.
+ * Otherwise they are computed by Finalize().
+ *
+ * Finalize() also fills the holes left between the frames: an empty voxel
+ * takes the mean of the non empty voxels within HoleFillingRadius voxels.
+ *
+ * The rows of a frame are splatted by the threads of an itk::MultiThreader.
+ * The rows are grouped in blocks far enough apart in space that two blocks
+ * of the same parity never reach the same voxel. The even blocks, then the
+ * odd blocks, are splatted in parallel without locks.
+ *
+ * The buffers are allocated once by SetOutputGeometry(). The volume is
+ * reported as a USImageObject with RequestGetImage().
+ *
+ * \sa USImageObject
+ * \sa VideoImagerTool
+ *
+ * \ingroup Object
+ */
+class USVolumeReconstructor : public Object
+{
+
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( USVolumeReconstructor, Object )
+
+public:
+
+  typedef Transform                          TransformType;
+  typedef USImageObject::ImageType           ImageType;
+
+  /** Splatting of the pixels in the volume */
+  typedef enum
+    {
+    NearestNeighborInterpolation,
+    LinearInterpolation
+    } InterpolationType;
+
+  /** Set the grid of the volume, in the reference coordinate system, and
+   *  allocate the buffers. The volume is cleared. */
+  void SetOutputGeometry( const double origin[3],
+                          const double spacing[3],
+                          const unsigned int size[3] );
+
+  /** Size of the pixels of the frames, in millimeters */
+  void SetImageSpacing( const double spacing[2] );
+
+  /** Calibration of the probe: transform from the image to the probe */
+  void SetImageToProbeTransform( const TransformType & transform );
+  igstkGetMacro( ImageToProbeTransform, TransformType );
+
+  /** Splatting of the pixels. Linear by default. */
+  igstkSetMacro( Interpolation, InterpolationType );
+  igstkGetMacro( Interpolation, InterpolationType );
+
+  /** Update the volume as the frames are inserted. True by default. */
+  igstkSetMacro( Incremental, bool );
+  igstkGetMacro( Incremental, bool );
+
+  /** Radius, in voxels, of the hole filling done by Finalize(). 1 by
+   *  default, 0 disables the hole filling. */
+  igstkSetMacro( HoleFillingRadius, unsigned int );
+  igstkGetMacro( HoleFillingRadius, unsigned int );
+
+  /** Insert a frame with the transform from the probe to the reference at
+   *  its acquisition time. Returns false if the output geometry is not
+   *  set. */
+  bool InsertFrame( Frame * frame, const TransformType & probeToReference );
+
+  /** Compute the voxels that are not up to date and fill the holes */
+  void Finalize();
+
+  /** Clear the volume */
+  void Reset();
+
+  /** Number of frames inserted since the last reset */
+  igstkGetMacro( NumberOfInsertedFrames, unsigned long );
+
+  /** Declare the USVolumeReconstructor class to be a friend
+   *  in order to give it access to the private method GetITKImage(). */
+  igstkFriendClassMacro(
+                 igstk::Friends::USVolumeReconstructorToImageSpatialObject );
+
+  /** Request to get the volume as an event */
+  void RequestGetImage();
+
+  /** Event type */
+  igstkLoadedObjectEventMacro( ImageModifiedEvent, IGSTKEvent, USImageObject);
+
+protected:
+
+  USVolumeReconstructor();
+  virtual ~USVolumeReconstructor();
+
+  /** Print the object information in a stream. */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  USVolumeReconstructor(const Self&);    //purposely not implemented
+  void operator=(const Self&);           //purposely not implemented
+
+  /** Frame to be splatted by the threads */
+  struct InsertionJobType
+    {
+    USVolumeReconstructor *  m_Reconstructor;
+    const unsigned char *    m_Pixels;
+    unsigned int             m_Width;
+    unsigned int             m_Height;
+    unsigned int             m_NumberOfChannels;
+    double                   m_IndexOrigin[3];
+    double                   m_IndexStepX[3];
+    double                   m_IndexStepY[3];
+    unsigned int             m_BlockSize;
+    unsigned int             m_Parity;
+    };
+
+  /** Voxels to be computed by the threads */
+  struct FinalizeJobType
+    {
+    USVolumeReconstructor *  m_Reconstructor;
+    bool                     m_FillHoles;
+    };
+
+  /** Splat the rows [firstRow,lastRow) of a frame */
+  void InsertRows( const InsertionJobType & job,
+                   unsigned int firstRow, unsigned int lastRow );
+
+  /** Compute the voxels of the slices [firstSlice,lastSlice) from the
+   *  buffers, filling the holes if requested */
+  void ComputeSlices( unsigned int firstSlice, unsigned int lastSlice,
+                      bool fillHoles );
+
+  /** Thread functions */
+  static ITK_THREAD_RETURN_TYPE InsertionThreadFunction( void * info );
+  static ITK_THREAD_RETURN_TYPE FinalizeThreadFunction( void * info );
+
+  /** Volume given to the USImageObject. This method MUST be private in
+   *  order to prevent unsafe access from the ITK image layer. */
+  const ImageType * GetITKImage() const;
+
+  double                         m_ImageSpacing[2];
+  TransformType                  m_ImageToProbeTransform;
+  InterpolationType              m_Interpolation;
+  bool                           m_Incremental;
+  unsigned int                   m_HoleFillingRadius;
+  unsigned long                  m_NumberOfInsertedFrames;
+
+  /** Output grid */
+  double                         m_Origin[3];
+  double                         m_Spacing[3];
+  unsigned int                   m_Size[3];
+
+  /** Weighted sum of the pixels and sum of the weights of every voxel */
+  std::vector< float >           m_Accumulator;
+  std::vector< float >           m_Weights;
+
+  ImageType::Pointer             m_Image;
+  USImageObject::Pointer         m_USImage;
+
+  itk::MultiThreader::Pointer    m_Threader;
+};
+
+} // end namespace igstk
+
+#endif // __igstkUSVolumeReconstructor_h
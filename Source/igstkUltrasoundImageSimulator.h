@@ -21,11 +21,11 @@
 #include "igstkImageSpatialObject.h"
 #include "igstkUSImageObject.h"
 #include "igstkStateMachine.h"
+#include "igstkObliqueResliceKernel.h"
 
+#include "itkMultiThreader.h"
 
-#include "vtkImageReslice.h"
-#include "itkVTKImageImport.h"
-#include "vtkImageExport.h"
+#include <vector>
 
 namespace igstk
 {
@@ -79,6 +79,12 @@ public:
  * provide a simulation of Ultrasound images by reading a CT or MR image and
  * extracting an slice from it. 
  *
+ * The slice is computed by a multithreaded ObliqueResliceKernel, which
+ * also records the intensity range of every row. The slice is then
+ * rescaled to [0,255] with its own range and cast to unsigned char in a
+ * second pass over the pixels, which does not need to read the volume.
+ * The buffers are allocated once and reused by subsequent reslicing.
+ *
  * \warning This class should ONLY be used for testing purposes, and not as
  * part of a final application.
  *
@@ -139,6 +145,8 @@ protected:
   typedef typename ImageGeometricModelType::PointType  PointType;
   typedef typename USImageObject::ImageType            USImageType;
   typedef typename ImageGeometricModelType::ImageType  MRImageType;
+  typedef typename MRImageType::PixelType              MRPixelType;
+  typedef typename USImageType::PixelType              USPixelType;
  
 private:
 
@@ -149,21 +157,23 @@ private:
   ImageGeometricModelConstPointer       m_ImageGeometricModel;
   ImageGeometricModelConstPointer       m_ImageGeometricModelToAdd;
     
-  /** VTK classes that support display of an image */
+  /** VTK image of the geometric model */
   vtkImageData                         * m_ImageData;
-  vtkImageData                         * m_ReslicedImageData;
-  vtkImageReslice                      * m_ImageReslice;
 
-  typedef itk::VTKImageImport<MRImageType> VTKImageImporterType;
+  /** Multithreaded reslice kernel */
+  ObliqueResliceKernel                    m_ResliceKernel;
+  itk::MultiThreader::Pointer             m_Threader;
 
-  typename VTKImageImporterType::Pointer  m_VTKImageImporter;
+  /** Slice in the pixel type of the volume, and range of each of its rows,
+   *  before the rescaling */
+  std::vector< MRPixelType >              m_ReslicedPixels;
+  std::vector< MRPixelType >              m_RowRanges;
 
   TransformType                           m_Transform;
   TransformType                           m_TransformToBeSet;
 
   USImageObject::Pointer                  m_USImage;
   USImageType::Pointer                    m_RescaledUSImage;
-  vtkImageExport*                         m_VTKExporter;
 
   /** Null operation for State Machine transition */
   void NoProcessing();
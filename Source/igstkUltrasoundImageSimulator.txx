@@ -20,8 +20,6 @@
 #include "igstkUltrasoundImageSimulator.h"
 
 #include "vtkImageData.h"
-#include "itkRescaleIntensityImageFilter.h"
-#include "itkCastImageFilter.h"
 
 namespace igstk
 {
@@ -36,21 +34,16 @@ UltrasoundImageSimulator< TImageGeometricModel >
   m_ImageGeometricModel = NULL;
   m_RescaledUSImage = NULL;
 
-  // Create classes for displaying images
   m_ImageData  = NULL;
-  m_ReslicedImageData  = NULL;
-  m_VTKImageImporter = VTKImageImporterType::New();
 
-  // Image reslice
-  m_ImageReslice = vtkImageReslice::New();
-  
+  // Rows of the simulated image are computed in parallel
+  m_Threader = itk::MultiThreader::New();
+  m_ResliceKernel.SetLinearInterpolation( true );
+
   m_VTKImageObserver = VTKImageObserver::New();
 
   m_USImage = USImageObject::New();
 
-  m_VTKExporter = vtkImageExport::New();
-
-
   igstkAddInputMacro( ValidImageSpatialObject );
   igstkAddInputMacro( NullImageSpatialObject  );
 
@@ -107,13 +100,6 @@ template < class TImageGeometricModel >
 UltrasoundImageSimulator< TImageGeometricModel >
 ::~UltrasoundImageSimulator()  
 {
-  if( m_ImageReslice )
-    {
-    m_ImageReslice->Delete();
-    m_ImageReslice = NULL;
-    }
-
-  m_VTKExporter->Delete();
 }
  
 /** Set the Image Spatial Object */
@@ -242,16 +228,15 @@ UltrasoundImageSimulator< TImageGeometricModel >
   v2[1] = 1;
   v2[2] = 0;
   v2 = m_Transform.GetRotation().Transform(v2);
- 
-  m_ImageReslice->SetInput(m_ImageData);
+
+  if( !m_ImageData )
+    {
+    return;
+    }
 
   double origin[3];
   m_ImageData->GetOrigin( origin );
 
-  // Set the reslice axes origin
-  m_ImageReslice->SetResliceAxesOrigin(position[0],
-                                       position[1],
-                                       position[2]);
   VectorType v3;  
    
   // Check if vector v1 and v2 are orthogonal
@@ -274,70 +259,106 @@ UltrasoundImageSimulator< TImageGeometricModel >
   v2Normalized = v2/v2.GetNorm();
   v3Normalized = v3/v3.GetNorm();
 
-  // set the reslice axes 
-  m_ImageReslice->SetResliceAxesDirectionCosines( 
-                 v1Normalized[0], v1Normalized[1], v1Normalized[2],
-                 v2Normalized[0], v2Normalized[1], v2Normalized[2],
-                 v3Normalized[0], v3Normalized[1], v3Normalized[2]);
-
-  // set the output dimensionality to 3
-  m_ImageReslice->SetOutputDimensionality(3);
-
-  // Set the output spacing 
+  // The simulated image has the in-plane spacing and extent of the
+  // volume. Its pixels are expressed in the frame of the probe, whose
+  // origin is the position of the transform and whose axes are the
+  // rotated x and y axes.
   double spacing[3];
   m_ImageData->GetSpacing( spacing );
-  m_ImageReslice->SetOutputSpacing( spacing[0],spacing[1], 1 );
 
-  // Set the output extent
   int ext[6];
   m_ImageData->GetExtent( ext );
-  m_ImageReslice->SetOutputExtent( ext[0], ext[1], ext[2], 
-                                   ext[3], 0, 0);
 
-  m_ImageReslice->SetOutputOrigin(origin);
-  m_ImageReslice->SetInterpolationModeToLinear();
-  m_ImageReslice->Update();
-  
-  m_VTKExporter->SetInput(m_ReslicedImageData);
-
-  m_VTKImageImporter->SetUpdateInformationCallback( 
-                               m_VTKExporter->GetUpdateInformationCallback());
-  m_VTKImageImporter->SetPipelineModifiedCallback(
-                                m_VTKExporter->GetPipelineModifiedCallback());
-  m_VTKImageImporter->SetWholeExtentCallback( 
-                                     m_VTKExporter->GetWholeExtentCallback());
-  m_VTKImageImporter->SetSpacingCallback(m_VTKExporter->GetSpacingCallback());
-  m_VTKImageImporter->SetOriginCallback( m_VTKExporter->GetOriginCallback() );
-  m_VTKImageImporter->SetScalarTypeCallback( 
-                                      m_VTKExporter->GetScalarTypeCallback());
-  m_VTKImageImporter->SetNumberOfComponentsCallback( 
-                              m_VTKExporter->GetNumberOfComponentsCallback());
-  m_VTKImageImporter->SetPropagateUpdateExtentCallback( 
-                           m_VTKExporter->GetPropagateUpdateExtentCallback());
-  m_VTKImageImporter->SetUpdateDataCallback( 
-                                      m_VTKExporter->GetUpdateDataCallback());
-  m_VTKImageImporter->SetDataExtentCallback( 
-                                      m_VTKExporter->GetDataExtentCallback());
-  m_VTKImageImporter->SetBufferPointerCallback( 
-                                   m_VTKExporter->GetBufferPointerCallback());
-  m_VTKImageImporter->SetCallbackUserData( 
-                                        m_VTKExporter->GetCallbackUserData());
-
-  // Do the actual rescaling and casting of the US image
-  typedef itk::RescaleIntensityImageFilter<MRImageType> RescaleFilterType;
-  typename RescaleFilterType::Pointer rescaler = RescaleFilterType::New();
-  rescaler->SetInput(m_VTKImageImporter->GetOutput());
-  rescaler->SetOutputMinimum(0);
-  rescaler->SetOutputMaximum(255);
-  rescaler->Update();
-
-  typedef itk::CastImageFilter<MRImageType,USImageType> CastFilterType;
-  typename CastFilterType::Pointer caster = CastFilterType::New();
-  caster->SetInput(rescaler->GetOutput());
-  caster->Update();
-  
-  m_RescaledUSImage = caster->GetOutput();
+  const double outputSpacing[2] = { spacing[0], spacing[1] };
+  const unsigned int outputSize[2] =
+    { static_cast< unsigned int >( ext[1] - ext[0] + 1 ),
+      static_cast< unsigned int >( ext[3] - ext[2] + 1 ) };
+
+  double outputOrigin[3];
+  double axis1[3];
+  double axis2[3];
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    outputOrigin[i] = position[i] +
+      v1Normalized[i] * ( origin[0] + ext[0] * spacing[0] ) +
+      v2Normalized[i] * ( origin[1] + ext[2] * spacing[1] ) +
+      v3Normalized[i] * origin[2];
+    axis1[i] = v1Normalized[i];
+    axis2[i] = v2Normalized[i];
+    }
 
+  m_ResliceKernel.SetOutputGeometry( outputOrigin, axis1, axis2,
+                                     outputSpacing, outputSize );
+
+  // Allocate the output image only when its geometry changes
+  typename USImageType::RegionType::IndexType index;
+  index[0] = ext[0];
+  index[1] = ext[2];
+  index[2] = 0;
+
+  typename USImageType::RegionType::SizeType size;
+  size[0] = outputSize[0];
+  size[1] = outputSize[1];
+  size[2] = 1;
+
+  typename USImageType::RegionType region( index, size );
+
+  if( m_RescaledUSImage.IsNull() ||
+      m_RescaledUSImage->GetBufferedRegion() != region )
+    {
+    m_RescaledUSImage = USImageType::New();
+    m_RescaledUSImage->SetRegions( region );
+    m_RescaledUSImage->Allocate();
+    }
+
+  typename USImageType::SpacingType usSpacing;
+  usSpacing[0] = spacing[0];
+  usSpacing[1] = spacing[1];
+  usSpacing[2] = 1.0;
+  m_RescaledUSImage->SetSpacing( usSpacing );
+  m_RescaledUSImage->SetOrigin( origin );
+
+  const size_t numberOfPixels =
+    static_cast< size_t >( outputSize[0] ) * outputSize[1];
+  m_ReslicedPixels.resize( numberOfPixels );
+  m_RowRanges.resize( 2 * outputSize[1] );
+
+  m_ResliceKernel.Reslice( &m_ReslicedPixels[0], m_Threader,
+                           &m_RowRanges[0] );
+
+  // Rescale the slice to [0,255] with its own intensity range, the way
+  // itk::RescaleIntensityImageFilter does
+  MRPixelType minimum = m_RowRanges[0];
+  MRPixelType maximum = m_RowRanges[1];
+  for( unsigned int row = 1; row < outputSize[1]; row++ )
+    {
+    minimum = ( m_RowRanges[2 * row] < minimum ) ?
+                                             m_RowRanges[2 * row] : minimum;
+    maximum = ( m_RowRanges[2 * row + 1] > maximum ) ?
+                                         m_RowRanges[2 * row + 1] : maximum;
+    }
+
+  double scale = 0.0;
+  if( minimum != maximum )
+    {
+    scale = 255.0 / ( static_cast< double >( maximum ) -
+                      static_cast< double >( minimum ) );
+    }
+  else if( maximum != 0 )
+    {
+    scale = 255.0 / static_cast< double >( maximum );
+    }
+  const double shift = - static_cast< double >( minimum ) * scale;
+
+  const MRPixelType * resliced = &m_ReslicedPixels[0];
+  USPixelType * output = m_RescaledUSImage->GetBufferPointer();
+  for( size_t i = 0; i < numberOfPixels; i++ )
+    {
+    output[i] = static_cast< USPixelType >( static_cast< MRPixelType >(
+                                              resliced[i] * scale + shift ) );
+    }
+
+  m_RescaledUSImage->Modified();
 
   typedef Friends::UltrasoundImageSimulatorToImageSpatialObject  HelperType;
   HelperType::SetITKImage( this, m_USImage.GetPointer() );
@@ -388,9 +409,36 @@ UltrasoundImageSimulator< TImageGeometricModel >
       }
     }
 
+  if( !m_ImageData )
+    {
+    return;
+    }
 
-  m_ImageReslice->SetInput ( m_ImageData );
-  m_ReslicedImageData = m_ImageReslice->GetOutput();
+  // The kernel reads the voxels of the VTK image directly. The origin
+  // given to the kernel is the position of the first voxel of the buffer.
+  int dimensions[3];
+  double spacing[3];
+  double origin[3];
+  int extent[6];
+  m_ImageData->GetDimensions( dimensions );
+  m_ImageData->GetSpacing( spacing );
+  m_ImageData->GetOrigin( origin );
+  m_ImageData->GetExtent( extent );
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    origin[i] += extent[2*i] * spacing[i];
+    }
+
+  if( !m_ResliceKernel.SetInputVolume( m_ImageData->GetScalarPointer(),
+                                       m_ImageData->GetScalarType(),
+                                       dimensions, spacing, origin ) )
+    {
+    igstkLogMacro( WARNING, "igstk::UltrasoundImageSimulator\
+                   ::SetImageSpatialObjectProcessing: unsupported pixel\
+                   type\n");
+    m_ImageData = NULL;
+    return;
+    }
 }
 
 
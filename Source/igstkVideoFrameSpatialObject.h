@@ -22,6 +22,7 @@
 #include "igstkFrame.h"
 #include "igstkTimeStamp.h"
 #include "igstkVideoImagerTool.h"
+#include "igstkTrackerTool.h"
 
 #include "itkVTKImageExport.h"
 #include "itkImage.h"
@@ -103,6 +104,12 @@ public:
   void RequestGetVTKImage()const;
   void SetVideoImagerTool(igstk::VideoImagerTool::Pointer);
 
+  /** Tracker tool holding the imager. Once the VideoImagerTool has a
+   *  temporal offset, the frame shown is the one acquired at the time of
+   *  the latest transform of this tool. Without a tracker tool, the frame
+   *  acquired at the current time is shown. */
+  void SetTrackerTool(const igstk::TrackerTool *);
+
 
   void UpdateImages();
   TPixelType* GetImagePtr();
@@ -129,6 +136,11 @@ private:
   VTKImageModifiedEvent  m_VtkImageLoadedEvent;
 
   igstk::VideoImagerTool::Pointer m_VideoImagerTool;
+
+  igstk::TrackerTool::ConstPointer m_TrackerTool;
+
+  /** Frame matching the latest transform of the tracker tool */
+  FrameType * GetCalibratedFrame() const;
   /** raw frame for the spatial object */
   FrameType                       m_Frame;
 
@@ -18,6 +18,7 @@
 #define __igstkVideoFrameSpatialObject_txx
 
 #include "igstkVideoFrameSpatialObject.h"
+#include "igstkRealTimeClock.h"
 
 namespace igstk
 {
@@ -37,6 +38,7 @@ VideoFrameSpatialObject< TPixelType, TChannels >
   m_Height=0;
 
   this->m_VideoImagerTool=NULL;
+  this->m_TrackerTool=NULL;
   m_PixelSizeX = 0;
   m_PixelSizeY = 0;
   m_NumberOfScalarComponents = 0;
@@ -295,7 +297,7 @@ VideoFrameSpatialObject< TPixelType, TChannels >
 {
   if(this->m_VideoImagerTool.IsNotNull())
     {
-    return (m_VideoImagerTool->GetInternalFrame())->GetExpirationTime();
+    return this->GetCalibratedFrame()->GetExpirationTime();
     }
   else
   return igstk::TimeStamp::GetZeroValue();
@@ -308,7 +310,7 @@ VideoFrameSpatialObject< TPixelType, TChannels >
 {
   if(this->m_VideoImagerTool.IsNotNull())
     {
-    return (m_VideoImagerTool->GetInternalFrame())->GetStartTime();
+    return this->GetCalibratedFrame()->GetStartTime();
     }
   else
   return igstk::TimeStamp::GetLongestPossibleTime();
@@ -322,6 +324,25 @@ VideoFrameSpatialObject< TPixelType, TChannels >
   this->m_VideoImagerTool = VideoImagerTool;
 }
 
+template< class TPixelType, unsigned int TChannels >
+void
+VideoFrameSpatialObject< TPixelType, TChannels >
+::SetTrackerTool(const igstk::TrackerTool * trackerTool)
+{
+  this->m_TrackerTool = trackerTool;
+}
+
+template< class TPixelType, unsigned int TChannels >
+typename VideoFrameSpatialObject< TPixelType, TChannels >::FrameType *
+VideoFrameSpatialObject< TPixelType, TChannels >
+::GetCalibratedFrame() const
+{
+  const TimePeriodType trackerTime = this->m_TrackerTool.IsNotNull() ?
+    this->m_TrackerTool->GetRawTransform().GetStartTime() :
+    RealTimeClock::GetTimeStamp();
+  return m_VideoImagerTool->GetTemporalCalibratedFrame( trackerTime );
+}
+
 template< class TPixelType, unsigned int TChannels >
 void
 VideoFrameSpatialObject< TPixelType, TChannels >
@@ -375,8 +396,7 @@ VideoFrameSpatialObject< TPixelType, TChannels>
 {
   if(this->m_VideoImagerTool.IsNotNull())
     {
-    m_RawBuffer=(unsigned char*)
-               (m_VideoImagerTool->GetTemporalCalibratedFrame())->GetImagePtr();
+    m_RawBuffer=(unsigned char*)this->GetCalibratedFrame()->GetImagePtr();
     }
   else
     {
@@ -313,6 +313,9 @@ VideoImager::VideoImager(void) :  m_StateMachine( this )
   m_ThreadingEnabled = false;
   m_ImagingThreadStarted = false;
 
+  m_ThreadPolicyApplied = false;
+  m_ConditionThreadPolicyApplied = itk::ConditionVariable::New();
+
   std::ofstream ofile;
   ofile.open("VideoImagerStateMachineDiagram.dot");
   const bool skipLoops = false;
@@ -636,8 +639,14 @@ void VideoImager::EnterImagingStateProcessing( void )
 
   if ( ! m_ImagingThreadStarted && this->GetThreadingEnabled() )
     {
+    m_LockForThreadPolicy.Lock();
+    m_ThreadPolicyApplied = false;
+    m_LockForThreadPolicy.Unlock();
+
     m_ThreadID = m_Threader->SpawnThread( ImagingThreadFunction, this );
     m_ImagingThreadStarted= true;
+
+    this->WaitForThreadPolicy();
     }
 
   m_PulseGenerator->RequestStart();
@@ -679,6 +688,51 @@ void VideoImager::ExitImagingTerminatingImagingThread( void )
     }
 }
 
+/** Policy of the imaging thread */
+void VideoImager::SetThreadPolicy( const ThreadPolicy & policy )
+{
+  m_ThreadPolicy = policy;
+}
+
+const ThreadPolicy & VideoImager::GetThreadPolicy() const
+{
+  return m_ThreadPolicy;
+}
+
+/** Wait for the imaging thread to apply its policy, and report the
+ *  outcome of each setting */
+void VideoImager::WaitForThreadPolicy( void )
+{
+  m_LockForThreadPolicy.Lock();
+  while( !m_ThreadPolicyApplied )
+    {
+    m_ConditionThreadPolicyApplied->Wait( &m_LockForThreadPolicy );
+    }
+  const ThreadPolicy::SettingResultContainerType results =
+    m_ThreadPolicyResults;
+  m_LockForThreadPolicy.Unlock();
+
+  for( unsigned int i = 0; i < results.size(); i++ )
+    {
+    if( results[i].Succeeded )
+      {
+      igstkLogMacro( INFO, "igstk::VideoImager: imaging thread "
+                     << results[i].Description << "\n" );
+      ThreadPolicyEvent event;
+      event.Set( results[i].Description );
+      this->InvokeEvent( event );
+      }
+    else
+      {
+      igstkLogMacro( WARNING, "igstk::VideoImager: imaging thread "
+                     << results[i].Description << "\n" );
+      ThreadPolicyErrorEvent event;
+      event.Set( results[i].Description );
+      this->InvokeEvent( event );
+      }
+    }
+}
+
 /** The "AttemptToUpdateStatus" method attempts to update status
     during imaging. */
 void VideoImager::AttemptToUpdateStatusProcessing( void )
@@ -728,19 +782,10 @@ void VideoImager::UpdateStatusSuccessProcessing( void )
 
   while( inputItr != inputEnd )
     {
+    // The latest frame keeps the time stamp given by the imager when the
+    // image was acquired, so that it can be paired with tracker samples.
     if ( (inputItr->second)->GetUpdated() )
-        {
-
-       FrameType* frame = (inputItr->second)->GetInternalFrame();
-
-      const double timeToExpiration = frame->GetExpirationTime() -
-                                      frame->GetStartTime();
-
-      FrameType* updatedFrame = new FrameType();
-      updatedFrame->SetImagePtr(frame->GetImagePtr(), timeToExpiration);
-
-      (inputItr->second)->SetInternalFrame( updatedFrame );
-
+      {
       (inputItr->second)->InvokeEvent( FrameModifiedEvent() );
       }
     ++inputItr;
@@ -865,6 +910,7 @@ void VideoImager::PrintSelf( std::ostream& os, itk::Indent indent ) const
     }
 
   os << indent << "ValidityTime: " << this->m_ValidityTime << std::endl;
+  os << indent << "ThreadPolicy: " << this->m_ThreadPolicy << std::endl;
   os << indent << "CoordinateSystemDelegator: ";
   this->m_CoordinateSystemDelegator->PrintSelf( os, indent );
 }
@@ -953,6 +999,15 @@ ITK_THREAD_RETURN_TYPE VideoImager::ImagingThreadFunction(void* pInfoStruct)
 
   VideoImager *pVideoImager = (VideoImager*)pInfo->UserData;
 
+  // the thread that starts imaging waits for the policy to be applied
+  const ThreadPolicy::SettingResultContainerType policyResults =
+    pVideoImager->m_ThreadPolicy.ApplyToCurrentThread();
+  pVideoImager->m_LockForThreadPolicy.Lock();
+  pVideoImager->m_ThreadPolicyResults = policyResults;
+  pVideoImager->m_ThreadPolicyApplied = true;
+  pVideoImager->m_ConditionThreadPolicyApplied->Signal();
+  pVideoImager->m_LockForThreadPolicy.Unlock();
+
   // counters for error rates
   unsigned long errorCount = 0;
   unsigned long totalCount = 0;
@@ -31,6 +31,7 @@
 #include "igstkFrame.h"
 #include "igstkPulseGenerator.h"
 #include "igstkVideoImagerTool.h"
+#include "igstkThreadPolicy.h"
 
 #include "igstkCoordinateSystemInterfaceMacros.h"
 
@@ -123,6 +124,14 @@ public:
    * to follow, then you will start receiving similar frames. */
   void RequestSetFrequency( double frequencyInHz );
 
+  /** Scheduling, placement and memory settings of the imaging thread.
+   *  The policy is applied by the thread when it is spawned, as imaging
+   *  starts, and a ThreadPolicyEvent or ThreadPolicyErrorEvent is invoked
+   *  for each of its settings. It has no effect when threading is not
+   *  enabled. */
+  void SetThreadPolicy( const ThreadPolicy & policy );
+  const ThreadPolicy & GetThreadPolicy() const;
+
 protected:
 
   VideoImager(void);
@@ -287,6 +296,18 @@ private:
   /** Imaging ThreadID */
   int                             m_ThreadID;
 
+  /** Policy of the imaging thread, and the outcome of its settings,
+   *  handed over by the thread when it starts */
+  ThreadPolicy                                m_ThreadPolicy;
+  ThreadPolicy::SettingResultContainerType    m_ThreadPolicyResults;
+  bool                                        m_ThreadPolicyApplied;
+  itk::ConditionVariable::Pointer             m_ConditionThreadPolicyApplied;
+  itk::SimpleMutexLock                        m_LockForThreadPolicy;
+
+  /** Wait until the imaging thread applied its policy, and invoke the
+   *  events of the settings */
+  void WaitForThreadPolicy( void );
+
   /** itk::ConditionVariable object pointer to signal for the next
    *  frame */
   itk::ConditionVariable::Pointer m_ConditionNextFrameReceived;
@@ -38,6 +38,8 @@ VideoImagerTool::VideoImagerTool(void):m_StateMachine(this)
 
   /** shownFrameIndex = currentlyCapturedFrameIndex - m_Delay */
   m_Delay = 6;
+  m_TemporalOffset = 0.0;
+  m_TemporalOffsetSet = false;
 
   // States
   igstkAddStateMacro( Idle );
@@ -559,16 +561,66 @@ igstk::Frame* VideoImagerTool::GetFrameFromBuffer(const unsigned int index)
     }
 }
 
+igstk::Frame* VideoImagerTool::GetLatestFrame()
+{
+  return GetFrameFromBuffer( ( m_Index + MAX_FRAMES - 1 ) % MAX_FRAMES );
+}
+
+void VideoImagerTool::SetTemporalOffset( TimePeriodType offset )
+{
+  m_TemporalOffset = offset;
+  m_TemporalOffsetSet = true;
+}
+
+igstk::Frame* VideoImagerTool::GetFrameAtTime( TimePeriodType trackerTime )
+{
+  // Walk back from the latest frame, the frames are in the order of their
+  // time stamps
+  const TimePeriodType frameTime = trackerTime + m_TemporalOffset;
+  igstk::Frame* frame = NULL;
+  for( unsigned int age = 0; age < m_NumberOfFramesInBuffer; age++ )
+    {
+    frame = GetFrameFromBuffer(
+                      ( m_Index + 2 * MAX_FRAMES - 1 - age ) % MAX_FRAMES );
+    if( !frame || frame->GetStartTime() <= frameTime )
+      {
+      break;
+      }
+    }
+  return frame;
+}
+
 igstk::Frame* VideoImagerTool::GetTemporalCalibratedFrame()
+{
+  if( m_TemporalOffsetSet )
+    {
+    return this->GetLatestFrame();
+    }
+  return this->GetDelayedFrame();
+}
+
+igstk::Frame*
+VideoImagerTool::GetTemporalCalibratedFrame( TimePeriodType trackerTime )
+{
+  if( m_TemporalOffsetSet )
+    {
+    return this->GetFrameAtTime( trackerTime );
+    }
+  return this->GetDelayedFrame();
+}
+
+igstk::Frame* VideoImagerTool::GetDelayedFrame()
 {
   try
     {
-    return m_FrameRingBuffer->at((MAX_FRAMES + (m_Index - m_Delay))%MAX_FRAMES);
+    return m_FrameRingBuffer->at(
+                  ( 2 * MAX_FRAMES + m_Index - 1 - m_Delay % MAX_FRAMES ) %
+                  MAX_FRAMES );
     }
   catch( std::exception& e )
     {
     igstkLogMacro( FATAL,
-              "Exception in GetTemporalCalibratedFrame (igstkVideoImagerTool): "
+              "Exception in GetDelayedFrame (igstkVideoImagerTool): "
                                                                    << e.what());
     return NULL;
     }
@@ -598,6 +650,9 @@ void VideoImagerTool::AddFrameToBuffer(igstk::Frame* frame)
 void VideoImagerTool::PrintSelf( std::ostream& os, itk::Indent indent ) const
 {
   Superclass::PrintSelf(os, indent);
+
+  os << indent << "Delay: " << m_Delay << std::endl;
+  os << indent << "TemporalOffset: " << m_TemporalOffset << std::endl;
 }
 
 std::ostream& operator<<(std::ostream& os, const VideoImagerTool& o)
@@ -84,6 +84,7 @@ public:
   typedef VideoImager       VideoImagerType;
   typedef Transform         TransformType;
   typedef Frame             FrameType;
+  typedef Transform::TimePeriodType  TimePeriodType;
 
   /** Get whether the tool was updated during VideoImager UpdateStatus() */
   igstkGetMacro( Updated, bool );
@@ -121,8 +122,33 @@ public:
   igstkGetMacro( Delay, unsigned int );
 
   igstk::Frame* GetFrameFromBuffer(const unsigned int index);
+
+  /** Get the frame most recently set by the VideoImager */
+  igstk::Frame* GetLatestFrame();
+
+  /** Temporal offset, in milliseconds, between the time stamps of the
+   *  frames and the time stamps of the trackers for the same instant, as
+   *  estimated by a VideoTemporalCalibration. A frame stamped t shows the
+   *  scene at tracker time t - offset. Setting the offset makes the frames
+   *  be looked up by time instead of by Delay. */
+  void SetTemporalOffset( TimePeriodType offset );
+  igstkGetMacro( TemporalOffset, TimePeriodType );
+
+  /** Get the latest frame showing the scene at or before a tracker time.
+   *  The oldest frame is returned if they are all more recent. */
+  igstk::Frame* GetFrameAtTime( TimePeriodType trackerTime );
+
+  /** Get the frame set Delay updates before the latest one. Once a
+   *  temporal offset is set, the latest frame is returned, as no tracker
+   *  time is given to look it up. */
   igstk::Frame* GetTemporalCalibratedFrame();
 
+  /** Get the frame showing the scene at the time of a tracker sample,
+   *  e.g. the start time of the transform of the tool holding the imager,
+   *  once a temporal offset is set. Without an offset, the frame set Delay
+   *  updates before the latest one is returned. */
+  igstk::Frame* GetTemporalCalibratedFrame( TimePeriodType trackerTime );
+
 protected:
 
   VideoImagerTool(void);
@@ -249,6 +275,9 @@ private:
   /** Ring buffer for the tool */
   void AddFrameToBuffer( igstk::Frame* frame);
 
+  /** Frame set Delay updates before the latest one */
+  igstk::Frame* GetDelayedFrame();
+
   /** Ring buffer with frames */
   std::vector< igstk::Frame* > *m_FrameRingBuffer;
 
@@ -257,6 +286,8 @@ private:
   unsigned int                  m_NumberOfFramesInBuffer;
   unsigned int                  m_MaxBufferSize;
   unsigned int                  m_Delay;
+  TimePeriodType                m_TemporalOffset;
+  bool                          m_TemporalOffsetSet;
   unsigned int                  m_FrameDimensions[3];
   unsigned int                  m_PixelDepth;
 
@@ -0,0 +1,375 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkVideoTemporalCalibration.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkVideoTemporalCalibration.h"
+
+#include "itkMatrix.h"
+#include "vnl/algo/vnl_symmetric_eigensystem.h"
+
+#include <math.h>
+#include <algorithm>
+
+namespace igstk
+{
+
+namespace
+{
+/** Orders the samples of a signal by time */
+struct SampleTimeLess
+{
+  template < class TSample >
+  bool operator()( const TSample & a, const TSample & b ) const
+    {
+    return a.m_Time < b.m_Time;
+    }
+};
+}
+
+/** Constructor */
+VideoTemporalCalibration::VideoTemporalCalibration():m_StateMachine(this)
+{
+  m_ImageAxis = 1;
+  m_IntensityThreshold = 128;
+  m_MaximumOffset = 500.0;
+  m_ResamplingInterval = 2.0;
+  m_TemporalOffset = 0.0;
+  m_Correlation = 0.0;
+}
+
+/** Destructor */
+VideoTemporalCalibration::~VideoTemporalCalibration()
+{
+}
+
+void VideoTemporalCalibration::AddTrackerTransform(
+                                           const TransformType & transform )
+{
+  this->AddTrackerPosition( transform.GetStartTime(),
+                            transform.GetTranslation() );
+}
+
+void VideoTemporalCalibration::AddTrackerPosition( TimePeriodType time,
+                                               const VectorType & position )
+{
+  m_TrackerTimes.push_back( time );
+  m_TrackerPositions.push_back( position );
+}
+
+void VideoTemporalCalibration::AddImagePosition( TimePeriodType time,
+                                                 double position )
+{
+  SampleType sample;
+  sample.m_Time = time;
+  sample.m_Value = position;
+  m_ImageSignal.push_back( sample );
+}
+
+bool VideoTemporalCalibration::AddFrame( Frame * frame )
+{
+  if( !frame || !frame->GetImagePtr() )
+    {
+    return false;
+    }
+
+  const unsigned char * pixels =
+    static_cast< const unsigned char * >( frame->GetImagePtr() );
+  const unsigned int width = frame->GetWidth();
+  const unsigned int height = frame->GetHeight();
+  const unsigned int channels =
+    frame->GetNumberOfChannels() > 0 ? frame->GetNumberOfChannels() : 1;
+
+  // Intensity weighted centroid of the bright pixels, along the axis
+  double sum = 0.0;
+  double weight = 0.0;
+  for( unsigned int j = 0; j < height; j++ )
+    {
+    const unsigned char * pixel = pixels + j * width * channels;
+    for( unsigned int i = 0; i < width; i++, pixel += channels )
+      {
+      if( *pixel > m_IntensityThreshold )
+        {
+        sum += *pixel * ( m_ImageAxis == 0 ? i : j );
+        weight += *pixel;
+        }
+      }
+    }
+
+  if( weight <= 0.0 )
+    {
+    return false;
+    }
+
+  this->AddImagePosition( frame->GetStartTime(), sum / weight );
+  return true;
+}
+
+unsigned long VideoTemporalCalibration::GetNumberOfTrackerSamples() const
+{
+  return m_TrackerTimes.size();
+}
+
+unsigned long VideoTemporalCalibration::GetNumberOfImageSamples() const
+{
+  return m_ImageSignal.size();
+}
+
+void VideoTemporalCalibration::Reset()
+{
+  m_TrackerTimes.clear();
+  m_TrackerPositions.clear();
+  m_ImageSignal.clear();
+  m_TemporalOffset = 0.0;
+  m_Correlation = 0.0;
+}
+
+bool VideoTemporalCalibration::ComputeTrackerSignal( SignalType & signal ) const
+{
+  const unsigned int numberOfSamples = m_TrackerPositions.size();
+  if( numberOfSamples < 2 )
+    {
+    return false;
+    }
+
+  VectorType mean;
+  mean.Fill( 0.0 );
+  for( unsigned int i = 0; i < numberOfSamples; i++ )
+    {
+    mean += m_TrackerPositions[i];
+    }
+  mean /= numberOfSamples;
+
+  itk::Matrix< double, 3, 3 > covariance;
+  covariance.Fill( 0.0 );
+  for( unsigned int i = 0; i < numberOfSamples; i++ )
+    {
+    const VectorType d = m_TrackerPositions[i] - mean;
+    for( unsigned int r = 0; r < 3; r++ )
+      {
+      for( unsigned int c = 0; c < 3; c++ )
+        {
+        covariance[r][c] += d[r] * d[c];
+        }
+      }
+    }
+
+  // The eigenvalues are in increasing order
+  vnl_symmetric_eigensystem< double > eigen( covariance.GetVnlMatrix() );
+  if( eigen.get_eigenvalue( 2 ) <= 0.0 )
+    {
+    return false;
+    }
+  const vnl_vector< double > direction = eigen.get_eigenvector( 2 );
+
+  signal.resize( numberOfSamples );
+  for( unsigned int i = 0; i < numberOfSamples; i++ )
+    {
+    const VectorType d = m_TrackerPositions[i] - mean;
+    signal[i].m_Time = m_TrackerTimes[i];
+    signal[i].m_Value = d[0] * direction[0] + d[1] * direction[1] +
+                        d[2] * direction[2];
+    }
+  return true;
+}
+
+bool VideoTemporalCalibration::Resample( const SignalType & signal,
+                                         TimePeriodType startTime,
+                                         unsigned int numberOfSamples,
+                                         std::vector< double > & resampled )
+                                         const
+{
+  if( signal.empty() )
+    {
+    return false;
+    }
+
+  resampled.resize( numberOfSamples );
+  unsigned int next = 0;
+  for( unsigned int i = 0; i < numberOfSamples; i++ )
+    {
+    const TimePeriodType time = startTime + i * m_ResamplingInterval;
+    while( next < signal.size() && signal[next].m_Time < time )
+      {
+      next++;
+      }
+
+    if( next == 0 )
+      {
+      resampled[i] = signal.front().m_Value;
+      }
+    else if( next == signal.size() )
+      {
+      resampled[i] = signal.back().m_Value;
+      }
+    else
+      {
+      const SampleType & before = signal[next - 1];
+      const SampleType & after = signal[next];
+      const TimePeriodType span = after.m_Time - before.m_Time;
+      const double t = span > 0.0 ? ( time - before.m_Time ) / span : 0.0;
+      resampled[i] = before.m_Value + t * ( after.m_Value - before.m_Value );
+      }
+    }
+  return true;
+}
+
+bool VideoTemporalCalibration::Estimate()
+{
+  SignalType trackerSignal;
+  if( m_ResamplingInterval <= 0.0 || m_MaximumOffset < 0.0 ||
+      m_ImageSignal.size() < 2 || !this->ComputeTrackerSignal( trackerSignal ) )
+    {
+    return false;
+    }
+
+  SignalType imageSignal = m_ImageSignal;
+  std::sort( imageSignal.begin(), imageSignal.end(), SampleTimeLess() );
+  std::sort( trackerSignal.begin(), trackerSignal.end(), SampleTimeLess() );
+
+  const TimePeriodType startTime =
+    std::max( imageSignal.front().m_Time, trackerSignal.front().m_Time );
+  const TimePeriodType endTime =
+    std::min( imageSignal.back().m_Time, trackerSignal.back().m_Time );
+
+  // The image signal is compared with the tracker signal shifted by up to
+  // maxLag samples on both sides
+  const int maxLag =
+    static_cast< int >( ceil( m_MaximumOffset / m_ResamplingInterval ) );
+  const int numberOfTrackerSamples =
+    static_cast< int >( ( endTime - startTime ) / m_ResamplingInterval ) + 1;
+  const int numberOfImageSamples = numberOfTrackerSamples - 2 * maxLag;
+  if( numberOfImageSamples < 3 )
+    {
+    return false;
+    }
+
+  std::vector< double > tracker;
+  std::vector< double > image;
+  this->Resample( trackerSignal, startTime, numberOfTrackerSamples, tracker );
+  this->Resample( imageSignal, startTime + maxLag * m_ResamplingInterval,
+                  numberOfImageSamples, image );
+
+  // Zero mean and unit norm image signal
+  double mean = 0.0;
+  for( int i = 0; i < numberOfImageSamples; i++ )
+    {
+    mean += image[i];
+    }
+  mean /= numberOfImageSamples;
+  double norm = 0.0;
+  for( int i = 0; i < numberOfImageSamples; i++ )
+    {
+    image[i] -= mean;
+    norm += image[i] * image[i];
+    }
+  if( norm <= 0.0 )
+    {
+    return false;
+    }
+  norm = sqrt( norm );
+  for( int i = 0; i < numberOfImageSamples; i++ )
+    {
+    image[i] /= norm;
+    }
+
+  // Normalized correlation for every lag. With a lag k, the image sample i
+  // is compared with the tracker sample k samples earlier.
+  std::vector< double > correlation( 2 * maxLag + 1, 0.0 );
+  for( int k = -maxLag; k <= maxLag; k++ )
+    {
+    const double * window = &tracker[maxLag - k];
+
+    double windowMean = 0.0;
+    for( int i = 0; i < numberOfImageSamples; i++ )
+      {
+      windowMean += window[i];
+      }
+    windowMean /= numberOfImageSamples;
+
+    double product = 0.0;
+    double windowNorm = 0.0;
+    for( int i = 0; i < numberOfImageSamples; i++ )
+      {
+      const double value = window[i] - windowMean;
+      product += image[i] * value;
+      windowNorm += value * value;
+      }
+
+    correlation[k + maxLag] =
+      windowNorm > 0.0 ? fabs( product ) / sqrt( windowNorm ) : 0.0;
+    }
+
+  unsigned int peak = 0;
+  for( unsigned int k = 1; k < correlation.size(); k++ )
+    {
+    if( correlation[k] > correlation[peak] )
+      {
+      peak = k;
+      }
+    }
+
+  // Sub-sample refinement with a parabola through the peak and its
+  // neighbors
+  double refinement = 0.0;
+  if( peak > 0 && peak + 1 < correlation.size() )
+    {
+    const double before = correlation[peak - 1];
+    const double after = correlation[peak + 1];
+    const double curvature = before - 2.0 * correlation[peak] + after;
+    if( curvature < 0.0 )
+      {
+      refinement = 0.5 * ( before - after ) / curvature;
+      }
+    }
+
+  m_TemporalOffset = ( static_cast< int >( peak ) - maxLag + refinement ) *
+                     m_ResamplingInterval;
+  m_Correlation = correlation[peak];
+
+  igstkLogMacro( INFO, "igstk::VideoTemporalCalibration::Estimate: offset "
+                 << m_TemporalOffset << " ms, correlation " << m_Correlation
+                 << "\n" );
+
+  return true;
+}
+
+/** Print Self function */
+void VideoTemporalCalibration::PrintSelf( std::ostream& os,
+                                          itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of tracker samples: "
+     << this->GetNumberOfTrackerSamples() << std::endl;
+  os << indent << "Number of image samples: "
+     << this->GetNumberOfImageSamples() << std::endl;
+  os << indent << "Image axis: " << m_ImageAxis << std::endl;
+  os << indent << "Intensity threshold: " << m_IntensityThreshold
+     << std::endl;
+  os << indent << "Maximum offset: " << m_MaximumOffset << std::endl;
+  os << indent << "Resampling interval: " << m_ResamplingInterval
+     << std::endl;
+  os << indent << "Temporal offset: " << m_TemporalOffset << std::endl;
+  os << indent << "Correlation: " << m_Correlation << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkVideoTemporalCalibration.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkVideoTemporalCalibration_h
+#define __igstkVideoTemporalCalibration_h
+
+#include "igstkObject.h"
+#include "igstkMacros.h"
+#include "igstkTransform.h"
+#include "igstkFrame.h"
+
+#include <vector>
+
+namespace igstk
+{
+
+/** \class VideoTemporalCalibration
+ *
+ * \brief Estimates the temporal offset between a video stream and a
+ * tracker stream.
+ *
+ * While a tracked probe or marker is moved back and forth, the positions
+ * of the tracker tool and a position measured in the frames are added with
+ * their time stamps. The position in a frame is the centroid, along one
+ * axis of the image, of the pixels brighter than a threshold: e.g. the
+ * depth of the bottom of a water bath in ultrasound frames, or the row of
+ * a bright marker in a camera image. Positions computed otherwise by the
+ * application can be added directly.
+ *
+ * The tracker positions are projected on their principal direction of
+ * motion. Both signals are resampled on a regular grid over their common
+ * time span, normalized, and cross-correlated for every offset up to
+ * MaximumOffset. The peak of the correlation is refined with a parabola
+ * through its neighbors, so the resolution of the estimate is finer than
+ * the resampling interval. The sign of the motion is irrelevant, the peak
+ * of the absolute correlation is used.
+ *
+ * The offset is the time stamp of a frame minus the time stamp of the
+ * tracker for the same instant. It is given to the imager tool with
+ * VideoImagerTool::SetTemporalOffset().
+ *
+ * \sa VideoImagerTool
+ *
+ * \ingroup VideoImager
+ */
+class VideoTemporalCalibration : public Object
+{
+
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( VideoTemporalCalibration, Object )
+
+public:
+
+  typedef Transform                          TransformType;
+  typedef Transform::TimePeriodType          TimePeriodType;
+  typedef Transform::VectorType              VectorType;
+
+  /** Add the position of the tracker tool, stamped with the start time of
+   *  the transform */
+  void AddTrackerTransform( const TransformType & transform );
+  void AddTrackerPosition( TimePeriodType time, const VectorType & position );
+
+  /** Add the position measured in a frame, stamped with the start time of
+   *  the frame. Returns false if no pixel is above the threshold. */
+  bool AddFrame( Frame * frame );
+  void AddImagePosition( TimePeriodType time, double position );
+
+  /** Axis of the images along which the centroid is computed: 0 for the
+   *  columns, 1 for the rows. 1 by default. */
+  igstkSetMacro( ImageAxis, unsigned int );
+  igstkGetMacro( ImageAxis, unsigned int );
+
+  /** Intensity above which the pixels are used for the centroid. 128 by
+   *  default. */
+  igstkSetMacro( IntensityThreshold, unsigned int );
+  igstkGetMacro( IntensityThreshold, unsigned int );
+
+  /** Largest offset searched, in milliseconds. 500 by default. */
+  igstkSetMacro( MaximumOffset, TimePeriodType );
+  igstkGetMacro( MaximumOffset, TimePeriodType );
+
+  /** Interval of the resampled signals, in milliseconds. 2 by default. */
+  igstkSetMacro( ResamplingInterval, TimePeriodType );
+  igstkGetMacro( ResamplingInterval, TimePeriodType );
+
+  /** Estimate the offset. Returns false if the signals do not overlap for
+   *  longer than twice the maximum offset, or do not move. */
+  bool Estimate();
+
+  /** Estimated offset in milliseconds, and the normalized correlation of
+   *  the signals at that offset, between 0 and 1 */
+  igstkGetMacro( TemporalOffset, TimePeriodType );
+  igstkGetMacro( Correlation, double );
+
+  /** Number of samples of each signal */
+  unsigned long GetNumberOfTrackerSamples() const;
+  unsigned long GetNumberOfImageSamples() const;
+
+  /** Remove the samples */
+  void Reset();
+
+protected:
+
+  VideoTemporalCalibration();
+  virtual ~VideoTemporalCalibration();
+
+  /** Print the object information in a stream. */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  VideoTemporalCalibration(const Self&);   //purposely not implemented
+  void operator=(const Self&);             //purposely not implemented
+
+  /** Sample of a scalar signal */
+  struct SampleType
+    {
+    TimePeriodType  m_Time;
+    double          m_Value;
+    };
+
+  typedef std::vector< SampleType >   SignalType;
+
+  /** Project the tracker positions on their principal direction */
+  bool ComputeTrackerSignal( SignalType & signal ) const;
+
+  /** Resample a signal every ResamplingInterval from a start time, with a
+   *  linear interpolation */
+  bool Resample( const SignalType & signal, TimePeriodType startTime,
+                 unsigned int numberOfSamples,
+                 std::vector< double > & resampled ) const;
+
+  /** Samples, in the order in which they were added */
+  std::vector< TimePeriodType >   m_TrackerTimes;
+  std::vector< VectorType >       m_TrackerPositions;
+  SignalType                      m_ImageSignal;
+
+  unsigned int                    m_ImageAxis;
+  unsigned int                    m_IntensityThreshold;
+  TimePeriodType                  m_MaximumOffset;
+  TimePeriodType                  m_ResamplingInterval;
+
+  TimePeriodType                  m_TemporalOffset;
+  double                          m_Correlation;
+};
+
+} // end namespace igstk
+
+#endif // __igstkVideoTemporalCalibration_h
@@ -0,0 +1,488 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkVideoTrackingRecorder.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkVideoTrackingRecorder.h"
+
+#include <itksys/SystemTools.hxx>
+#include "itk_zlib.h"
+
+#include <string.h>
+
+namespace igstk
+{
+
+const char * VideoTrackingRecorder::GetFrameIndexSignature()
+{
+  return "IGSTKVID";
+}
+
+std::string
+VideoTrackingRecorder::GetTrackingFileName( const std::string & directory )
+{
+  return directory + "/tracking.trk";
+}
+
+std::string
+VideoTrackingRecorder::GetFrameIndexFileName( const std::string & directory,
+                                              const std::string & toolName )
+{
+  return directory + "/" + toolName + ".frameindex";
+}
+
+std::string
+VideoTrackingRecorder::GetChunkFileName( const std::string & directory,
+                                         const std::string & toolName,
+                                         unsigned int chunk )
+{
+  char number[16];
+  sprintf( number, "_%05u", chunk );
+  return directory + "/" + toolName + number + ".frames";
+}
+
+VideoTrackingRecorder::VideoTrackingRecorder():m_StateMachine(this)
+{
+  m_TrackerRecorder = TrackerRecorder::New();
+
+  m_Compression = true;
+  m_FramesPerChunk = 300;
+  m_FrameBufferSize = 120;
+
+  m_FirstBufferedFrame = 0;
+  m_NumberOfBufferedFrames = 0;
+  m_NumberOfFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_StopRecording = false;
+  m_BufferCondition = itk::ConditionVariable::New();
+
+  m_Recording = false;
+  m_Threader = itk::MultiThreader::New();
+  m_ThreadID = -1;
+
+  m_FrameCommand = FrameCommandType::New();
+  m_FrameCommand->SetCallbackFunction( this,
+                               &VideoTrackingRecorder::FrameModifiedCallback );
+}
+
+VideoTrackingRecorder::~VideoTrackingRecorder()
+{
+  this->StopRecording();
+
+  for( unsigned int i = 0; i < m_VideoTools.size(); i++ )
+    {
+    m_VideoTools[i].m_VideoImagerTool->RemoveObserver(
+                                              m_VideoTools[i].m_ObserverTag );
+    }
+}
+
+TrackerRecorder * VideoTrackingRecorder::GetTrackerRecorder()
+{
+  return m_TrackerRecorder;
+}
+
+void VideoTrackingRecorder::AddTrackerTool( TrackerTool * trackerTool )
+{
+  m_TrackerRecorder->AddTrackerTool( trackerTool );
+}
+
+void
+VideoTrackingRecorder::AddVideoImagerTool( VideoImagerTool * videoImagerTool )
+{
+  if( m_Recording || !videoImagerTool )
+    {
+    igstkLogMacro( WARNING, "igstk::VideoTrackingRecorder::"
+                   "AddVideoImagerTool: tools can only be added before "
+                   "the recording starts\n" );
+    return;
+    }
+
+  VideoToolType videoTool;
+  videoTool.m_VideoImagerTool = videoImagerTool;
+  videoTool.m_Name = videoImagerTool->GetVideoImagerToolIdentifier();
+  videoTool.m_ObserverTag = videoImagerTool->AddObserver(
+                                      FrameModifiedEvent(), m_FrameCommand );
+  videoTool.m_FrameSize = 0;
+  videoTool.m_IndexFile = NULL;
+  videoTool.m_ChunkFile = NULL;
+  videoTool.m_Chunk = 0;
+  videoTool.m_FramesInChunk = 0;
+  videoTool.m_ChunkOffset = 0;
+  videoTool.m_LastFrameTime = 0.0;
+
+  m_VideoTools.push_back( videoTool );
+}
+
+bool VideoTrackingRecorder::StartRecording( const std::string & directory )
+{
+  if( m_Recording )
+    {
+    this->StopRecording();
+    }
+
+  if( !itksys::SystemTools::MakeDirectory( directory.c_str() ) )
+    {
+    igstkLogMacro( CRITICAL, "igstk::VideoTrackingRecorder::StartRecording: "
+                   "can not create " << directory << "\n" );
+    return false;
+    }
+  m_Directory = directory;
+
+  if( m_FramesPerChunk == 0 )
+    {
+    m_FramesPerChunk = 1;
+    }
+
+  // One frame index per video tool
+  unsigned int largestFrameSize = 0;
+  for( unsigned int i = 0; i < m_VideoTools.size(); i++ )
+    {
+    VideoToolType & videoTool = m_VideoTools[i];
+
+    FrameIndexHeaderType header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.m_Signature, GetFrameIndexSignature(),
+            sizeof( header.m_Signature ) );
+    header.m_Version = FrameIndexVersion;
+    videoTool.m_VideoImagerTool->GetFrameDimensions(
+                                                   header.m_FrameDimensions );
+    header.m_FramesPerChunk = m_FramesPerChunk;
+
+    videoTool.m_FrameSize = header.m_FrameDimensions[0] *
+                            header.m_FrameDimensions[1] *
+                            header.m_FrameDimensions[2];
+    if( videoTool.m_FrameSize > largestFrameSize )
+      {
+      largestFrameSize = videoTool.m_FrameSize;
+      }
+    videoTool.m_Chunk = 0;
+    videoTool.m_FramesInChunk = 0;
+    videoTool.m_ChunkOffset = 0;
+    videoTool.m_LastFrameTime = 0.0;
+
+    const std::string indexFileName =
+                       GetFrameIndexFileName( directory, videoTool.m_Name );
+    videoTool.m_IndexFile = fopen( indexFileName.c_str(), "wb" );
+    if( !videoTool.m_IndexFile )
+      {
+      igstkLogMacro( CRITICAL, "igstk::VideoTrackingRecorder::"
+                     "StartRecording: can not create " << indexFileName
+                     << "\n" );
+      this->CloseFiles();
+      return false;
+      }
+    fwrite( &header, sizeof( header ), 1, videoTool.m_IndexFile );
+    fflush( videoTool.m_IndexFile );
+    }
+
+  if( !m_TrackerRecorder->StartRecording( GetTrackingFileName( directory ) ) )
+    {
+    this->CloseFiles();
+    return false;
+    }
+
+  // The images are allocated once, before the recording starts
+  m_Buffer.resize( m_FrameBufferSize > 0 ? m_FrameBufferSize : 1 );
+  for( unsigned int i = 0; i < m_Buffer.size(); i++ )
+    {
+    m_Buffer[i].m_Image.reserve( largestFrameSize );
+    }
+  m_CompressedImage.resize( compressBound( largestFrameSize ) );
+
+  m_BufferLock.Lock();
+  m_FirstBufferedFrame = 0;
+  m_NumberOfBufferedFrames = 0;
+  m_NumberOfFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_StopRecording = false;
+  m_Recording = true;
+  m_BufferLock.Unlock();
+
+  m_ThreadID = m_Threader->SpawnThread( RecordingThreadFunction, this );
+
+  return true;
+}
+
+void VideoTrackingRecorder::StopRecording()
+{
+  if( !m_Recording )
+    {
+    return;
+    }
+
+  m_TrackerRecorder->StopRecording();
+
+  // The recording thread writes the buffered frames before exiting
+  m_BufferLock.Lock();
+  m_StopRecording = true;
+  m_Recording = false;
+  m_BufferCondition->Signal();
+  m_BufferLock.Unlock();
+
+  m_Threader->TerminateThread( m_ThreadID );
+  m_ThreadID = -1;
+
+  this->CloseFiles();
+}
+
+void VideoTrackingRecorder::CloseFiles()
+{
+  for( unsigned int i = 0; i < m_VideoTools.size(); i++ )
+    {
+    VideoToolType & videoTool = m_VideoTools[i];
+    if( videoTool.m_IndexFile )
+      {
+      fclose( videoTool.m_IndexFile );
+      videoTool.m_IndexFile = NULL;
+      }
+    if( videoTool.m_ChunkFile )
+      {
+      fclose( videoTool.m_ChunkFile );
+      videoTool.m_ChunkFile = NULL;
+      }
+    }
+}
+
+bool VideoTrackingRecorder::IsRecording() const
+{
+  m_BufferLock.Lock();
+  const bool recording = m_Recording;
+  m_BufferLock.Unlock();
+  return recording;
+}
+
+unsigned long VideoTrackingRecorder::GetNumberOfFrames() const
+{
+  m_BufferLock.Lock();
+  const unsigned long numberOfFrames = m_NumberOfFrames;
+  m_BufferLock.Unlock();
+  return numberOfFrames;
+}
+
+unsigned long VideoTrackingRecorder::GetNumberOfDroppedFrames() const
+{
+  m_BufferLock.Lock();
+  const unsigned long numberOfDroppedFrames = m_NumberOfDroppedFrames;
+  m_BufferLock.Unlock();
+  return numberOfDroppedFrames;
+}
+
+void VideoTrackingRecorder::FrameModifiedCallback( const itk::Object * caller,
+                                                   const itk::EventObject & )
+{
+  unsigned int index = 0;
+  while( index < m_VideoTools.size() &&
+         m_VideoTools[index].m_VideoImagerTool.GetPointer() != caller )
+    {
+    index++;
+    }
+  if( index == m_VideoTools.size() )
+    {
+    return;
+    }
+
+  // Imagers may report the same frame again when the device has not
+  // delivered a new one
+  VideoToolType & videoTool = m_VideoTools[index];
+  Frame * frame = videoTool.m_VideoImagerTool->GetLatestFrame();
+  if( !frame || !frame->GetImagePtr() || videoTool.m_FrameSize == 0 ||
+      frame->GetStartTime() <= videoTool.m_LastFrameTime )
+    {
+    return;
+    }
+
+  m_BufferLock.Lock();
+
+  if( !m_Recording )
+    {
+    m_BufferLock.Unlock();
+    return;
+    }
+
+  const unsigned int bufferSize = m_Buffer.size();
+  if( m_NumberOfBufferedFrames == bufferSize )
+    {
+    m_NumberOfDroppedFrames++;
+    m_BufferLock.Unlock();
+    return;
+    }
+
+  // The recording thread only accesses the frames counted in the buffer,
+  // this one can be filled without the lock
+  BufferedFrameType & bufferedFrame = m_Buffer[
+           ( m_FirstBufferedFrame + m_NumberOfBufferedFrames ) % bufferSize ];
+  m_BufferLock.Unlock();
+
+  const unsigned char * image =
+                 static_cast< const unsigned char * >( frame->GetImagePtr() );
+  bufferedFrame.m_VideoTool = index;
+  bufferedFrame.m_Time = frame->GetStartTime();
+  bufferedFrame.m_Image.assign( image, image + videoTool.m_FrameSize );
+  videoTool.m_LastFrameTime = bufferedFrame.m_Time;
+
+  m_BufferLock.Lock();
+  m_NumberOfBufferedFrames++;
+  m_BufferCondition->Signal();
+  m_BufferLock.Unlock();
+}
+
+ITK_THREAD_RETURN_TYPE
+VideoTrackingRecorder::RecordingThreadFunction( void * info )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)info;
+
+  if( pInfo == NULL || pInfo->UserData == NULL )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  VideoTrackingRecorder * recorder =
+    static_cast< VideoTrackingRecorder * >( pInfo->UserData );
+
+  while( true )
+    {
+    recorder->m_BufferLock.Lock();
+    while( !recorder->m_StopRecording &&
+           recorder->m_NumberOfBufferedFrames == 0 )
+      {
+      recorder->m_BufferCondition->Wait( &recorder->m_BufferLock );
+      }
+
+    if( recorder->m_NumberOfBufferedFrames == 0 )
+      {
+      recorder->m_BufferLock.Unlock();
+      break;
+      }
+
+    // The frame stays in the buffer while it is written, so that the
+    // callback does not reuse it
+    const BufferedFrameType & frame =
+                       recorder->m_Buffer[recorder->m_FirstBufferedFrame];
+    recorder->m_BufferLock.Unlock();
+
+    const bool written = recorder->WriteFrame( frame );
+
+    recorder->m_BufferLock.Lock();
+    recorder->m_FirstBufferedFrame =
+      ( recorder->m_FirstBufferedFrame + 1 ) % recorder->m_Buffer.size();
+    recorder->m_NumberOfBufferedFrames--;
+    if( written )
+      {
+      recorder->m_NumberOfFrames++;
+      }
+    else
+      {
+      recorder->m_NumberOfDroppedFrames++;
+      }
+    recorder->m_BufferLock.Unlock();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool VideoTrackingRecorder::WriteFrame( const BufferedFrameType & frame )
+{
+  VideoToolType & videoTool = m_VideoTools[frame.m_VideoTool];
+
+  FrameIndexEntryType entry;
+  entry.m_Time = frame.m_Time;
+  entry.m_Encoding = RawEncoding;
+  entry.m_DataSize = frame.m_Image.size();
+
+  const unsigned char * data = &frame.m_Image[0];
+
+  if( m_Compression )
+    {
+    uLongf compressedSize = m_CompressedImage.size();
+    if( compress2( &m_CompressedImage[0], &compressedSize,
+                   data, frame.m_Image.size(), Z_BEST_SPEED ) == Z_OK &&
+        compressedSize < frame.m_Image.size() )
+      {
+      entry.m_Encoding = ZlibEncoding;
+      entry.m_DataSize = compressedSize;
+      data = &m_CompressedImage[0];
+      }
+    }
+
+  // Start a new chunk when the current one is full
+  if( !videoTool.m_ChunkFile ||
+      videoTool.m_FramesInChunk == m_FramesPerChunk ||
+      videoTool.m_ChunkOffset > 0xFFFFFFFFU - entry.m_DataSize )
+    {
+    if( videoTool.m_ChunkFile )
+      {
+      fclose( videoTool.m_ChunkFile );
+      videoTool.m_Chunk++;
+      }
+    const std::string chunkFileName =
+      GetChunkFileName( m_Directory, videoTool.m_Name, videoTool.m_Chunk );
+    videoTool.m_ChunkFile = fopen( chunkFileName.c_str(), "wb" );
+    videoTool.m_FramesInChunk = 0;
+    videoTool.m_ChunkOffset = 0;
+    if( !videoTool.m_ChunkFile )
+      {
+      igstkLogMacro( CRITICAL, "igstk::VideoTrackingRecorder::WriteFrame: "
+                     "can not create " << chunkFileName << "\n" );
+      return false;
+      }
+    }
+
+  if( fwrite( data, 1, entry.m_DataSize, videoTool.m_ChunkFile ) !=
+      entry.m_DataSize )
+    {
+    return false;
+    }
+  fflush( videoTool.m_ChunkFile );
+
+  // The frame is indexed once it is in its chunk
+  entry.m_Chunk = videoTool.m_Chunk;
+  entry.m_Offset = videoTool.m_ChunkOffset;
+  fwrite( &entry, sizeof( entry ), 1, videoTool.m_IndexFile );
+  fflush( videoTool.m_IndexFile );
+
+  videoTool.m_FramesInChunk++;
+  videoTool.m_ChunkOffset += entry.m_DataSize;
+
+  return true;
+}
+
+/** Print Self function */
+void VideoTrackingRecorder::PrintSelf( std::ostream& os,
+                                       itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of video tools: " << m_VideoTools.size()
+     << std::endl;
+  os << indent << "Compression: " << m_Compression << std::endl;
+  os << indent << "Frames per chunk: " << m_FramesPerChunk << std::endl;
+  os << indent << "Frame buffer size: " << m_FrameBufferSize << std::endl;
+  os << indent << "Recording: " << this->IsRecording() << std::endl;
+  os << indent << "Number of frames: " << this->GetNumberOfFrames()
+     << std::endl;
+  os << indent << "Number of dropped frames: "
+     << this->GetNumberOfDroppedFrames() << std::endl;
+  os << indent << "Tracker recorder: " << std::endl;
+  m_TrackerRecorder->Print( os, indent.GetNextIndent() );
+}
+
+} // end namespace igstk
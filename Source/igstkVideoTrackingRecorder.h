@@ -0,0 +1,229 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkVideoTrackingRecorder.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkVideoTrackingRecorder_h
+#define __igstkVideoTrackingRecorder_h
+
+#include "igstkObject.h"
+#include "igstkTrackerRecorder.h"
+#include "igstkVideoImagerTool.h"
+
+#include "itkMutexLock.h"
+#include "itkConditionVariable.h"
+#include "itkMultiThreader.h"
+#include "itkCommand.h"
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+
+namespace igstk
+{
+
+/** \class VideoTrackingRecorder
+ *  \brief Records video frames and tracker tools on a common timeline.
+ *
+ *  A recording is a directory. The transforms of the tracker tools are
+ *  recorded with a TrackerRecorder in the tracking file of the directory.
+ *  The frames of every video imager tool are written in chunk files of
+ *  FramesPerChunk frames, named after the tool, and listed in a frame
+ *  index file. Both streams use the time stamps of the RealTimeClock: the
+ *  start time of the transforms and of the frames, i.e. the time at which
+ *  the tracker and the imager acquired them.
+ *
+ *  The frame index file starts with a FrameIndexHeaderType, followed by a
+ *  FrameIndexEntryType for every frame, in the order of their times. The
+ *  frames are stored raw, or compressed without loss with zlib when
+ *  Compression is on and it makes them smaller.
+ *
+ *  When a tool reports a new frame, the recorder only copies the image in
+ *  a buffer of FrameBufferSize frames. A recording thread compresses and
+ *  writes the buffered frames. If the buffer is full, the new frames are
+ *  dropped and counted.
+ *
+ *  The recording is replayed with a PlaybackTracker and a
+ *  PlaybackVideoImager sharing a PlaybackClock.
+ *
+ *  \sa TrackerRecorder
+ *  \sa PlaybackVideoImager
+ *
+ *  \ingroup VideoImager
+ */
+class VideoTrackingRecorder : public Object
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( VideoTrackingRecorder, Object )
+
+  typedef Transform::TimePeriodType         TimePeriodType;
+
+  /** Encoding of a frame */
+  enum
+    {
+    RawEncoding = 0,
+    ZlibEncoding = 1
+    };
+
+  /** Header of a frame index file */
+  struct FrameIndexHeaderType
+    {
+    char            m_Signature[8];
+    unsigned int    m_Version;
+    unsigned int    m_FrameDimensions[3];
+    unsigned int    m_FramesPerChunk;
+    unsigned int    m_Reserved;
+    };
+
+  /** Frame of a frame index file: its time, its position in the chunk
+   *  files, and its encoding */
+  struct FrameIndexEntryType
+    {
+    double          m_Time;
+    unsigned int    m_Chunk;
+    unsigned int    m_Offset;
+    unsigned int    m_Encoding;
+    unsigned int    m_DataSize;
+    };
+
+  /** Signature and version of the frame index files */
+  static const char * GetFrameIndexSignature();
+  itkStaticConstMacro( FrameIndexVersion, unsigned int, 1 );
+
+  /** Names of the files of a recording */
+  static std::string GetTrackingFileName( const std::string & directory );
+  static std::string GetFrameIndexFileName( const std::string & directory,
+                                            const std::string & toolName );
+  static std::string GetChunkFileName( const std::string & directory,
+                                       const std::string & toolName,
+                                       unsigned int chunk );
+
+  /** Add a tracker tool to the recording */
+  void AddTrackerTool( TrackerTool * trackerTool );
+
+  /** Add a video imager tool to the recording. Its frame dimensions must be
+   *  set before the recording starts. */
+  void AddVideoImagerTool( VideoImagerTool * videoImagerTool );
+
+  /** Compress the frames without loss. True by default. */
+  igstkSetMacro( Compression, bool );
+  igstkGetMacro( Compression, bool );
+
+  /** Number of frames per chunk file, 300 by default */
+  igstkSetMacro( FramesPerChunk, unsigned int );
+  igstkGetMacro( FramesPerChunk, unsigned int );
+
+  /** Number of frames that can be buffered, 120 by default */
+  igstkSetMacro( FrameBufferSize, unsigned int );
+  igstkGetMacro( FrameBufferSize, unsigned int );
+
+  /** Create the recording directory and start recording. Returns false if
+   *  a file can not be created. */
+  bool StartRecording( const std::string & directory );
+
+  /** Write the buffered frames and records and close the files */
+  void StopRecording();
+
+  /** Whether the recorder is recording */
+  bool IsRecording() const;
+
+  /** Number of frames written, and dropped because the buffer was full */
+  unsigned long GetNumberOfFrames() const;
+  unsigned long GetNumberOfDroppedFrames() const;
+
+  /** Recorder of the tracker tools */
+  TrackerRecorder * GetTrackerRecorder();
+
+protected:
+
+  VideoTrackingRecorder();
+  virtual ~VideoTrackingRecorder();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  VideoTrackingRecorder(const Self&);   //purposely not implemented
+  void operator=(const Self&);          //purposely not implemented
+
+  /** Recorded video imager tool, with its files */
+  struct VideoToolType
+    {
+    VideoImagerTool::Pointer  m_VideoImagerTool;
+    std::string               m_Name;
+    unsigned long             m_ObserverTag;
+    unsigned int              m_FrameSize;
+    FILE *                    m_IndexFile;
+    FILE *                    m_ChunkFile;
+    unsigned int              m_Chunk;
+    unsigned int              m_FramesInChunk;
+    unsigned int              m_ChunkOffset;
+    TimePeriodType            m_LastFrameTime;
+    };
+
+  /** Buffered frame */
+  struct BufferedFrameType
+    {
+    unsigned int                  m_VideoTool;
+    TimePeriodType                m_Time;
+    std::vector< unsigned char >  m_Image;
+    };
+
+  void FrameModifiedCallback( const itk::Object * caller,
+                              const itk::EventObject & event );
+
+  /** Thread writing the buffered frames */
+  static ITK_THREAD_RETURN_TYPE RecordingThreadFunction( void * info );
+
+  /** Compress and write a frame, called in the recording thread */
+  bool WriteFrame( const BufferedFrameType & frame );
+
+  void CloseFiles();
+
+  TrackerRecorder::Pointer            m_TrackerRecorder;
+  std::vector< VideoToolType >        m_VideoTools;
+
+  typedef itk::MemberCommand< Self >  FrameCommandType;
+  FrameCommandType::Pointer           m_FrameCommand;
+
+  bool                                m_Compression;
+  unsigned int                        m_FramesPerChunk;
+  unsigned int                        m_FrameBufferSize;
+  std::string                         m_Directory;
+
+  /** Ring buffer of the frames, protected by m_BufferLock */
+  std::vector< BufferedFrameType >    m_Buffer;
+  unsigned int                        m_FirstBufferedFrame;
+  unsigned int                        m_NumberOfBufferedFrames;
+  unsigned long                       m_NumberOfFrames;
+  unsigned long                       m_NumberOfDroppedFrames;
+  bool                                m_StopRecording;
+  mutable itk::SimpleMutexLock        m_BufferLock;
+  itk::ConditionVariable::Pointer     m_BufferCondition;
+
+  /** Compression buffer of the recording thread */
+  std::vector< unsigned char >        m_CompressedImage;
+
+  bool                                m_Recording;
+  itk::MultiThreader::Pointer         m_Threader;
+  int                                 m_ThreadID;
+};
+
+} // end namespace igstk
+
+#endif // __igstkVideoTrackingRecorder_h
@@ -252,6 +252,9 @@ m_StateMachine(this)
 
   this->SetRefreshRate( 30 ); // 30 Hz is rather low frequency for video.
 
+  this->m_FrameScheduled = false;
+  this->m_Refreshing = false;
+
   this->m_PickerCoordinateSystem = CoordinateSystem::New();
 }
 
@@ -471,8 +474,13 @@ void View::ResetCameraProcessing()
 void View::StartProcessing()
 {
   igstkLogMacro( DEBUG, "igstkView::StartProcessing() called ...\n");
-  // the internal pulse generator will control the redraws
-  this->m_PulseGenerator->RequestStart();
+  // the internal pulse generator will control the redraws, unless a
+  // frame scheduler does
+  this->m_Refreshing = true;
+  if( !this->m_FrameScheduled )
+    {
+    this->m_PulseGenerator->RequestStart();
+    }
 }
 
 /** */
@@ -480,6 +488,7 @@ void View::StopProcessing()
 {
   igstkLogMacro( DEBUG, "igstkView::StopProcessing() called ...\n");
   // the internal pulse generator will control the redraws
+  this->m_Refreshing = false;
   this->m_PulseGenerator->RequestStop();
 }
 
@@ -626,7 +635,13 @@ void View::RefreshRender()
     ++itr;
     }
 
-  //Third, trigger VTK rendering
+  this->RenderScene();
+}
+
+/** Render the scene whose representations were updated */
+void View::RenderScene()
+{
+  // Trigger VTK rendering
   this->m_RenderWindowInteractor->Render();
 
   // Last, report to observers that a refresh event took place.
@@ -869,7 +884,10 @@ void View::SaveScreenShotWhileRefreshingProcessing()
   
   this->SaveScreenShot();
 
-  this->m_PulseGenerator->RequestStart();
+  if( !this->m_FrameScheduled )
+    {
+    this->m_PulseGenerator->RequestStart();
+    }
 }
 
 /** Save current screenshot in idle state */
@@ -973,6 +991,8 @@ void View::PrintSelf( std::ostream& os, itk::Indent indent ) const
     this->m_PulseObserver->Print(os);
     }
 
+  os << indent << "FrameScheduled: " << this->m_FrameScheduled << std::endl;
+
   ObjectListConstIterator itr;
 
   for( itr = this->m_Objects.begin(); itr != this->m_Objects.end(); ++itr )
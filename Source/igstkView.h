@@ -51,6 +51,9 @@ class vtkWorldPointPicker;
 
 namespace igstk {
 
+class FrameScheduler;
+class ViewRecorder;
+
 /** \class View
  *  
  *  \brief Display graphical representations of surgical scenes.
@@ -97,6 +100,8 @@ public:
   /** Request to save a screen shot into a file. The file format MUST be PNG
    * in order to have lossless compression. This method will trigger an extra
    * rendering of the scene in order to ensure that the image is fresh.
+   * The view is blocked until the file is written: use a ViewRecorder to
+   * save screen shots while the view is refreshing.
    * */
   void RequestSaveScreenShot( const std::string & filename );
 
@@ -138,6 +143,8 @@ public:
   void SetCameraZoomFactor( double rate );
 
   friend class ViewProxyBase;
+  friend class FrameScheduler;
+  friend class ViewRecorder;
 
 protected:
 
@@ -188,6 +195,10 @@ private:
   /** Method that will refresh the view.. and the GUI */
   void RefreshRender();
 
+  /** Render the scene and report the refresh. The representations must
+   *  have been updated for the render time. */
+  void RenderScene();
+
   /** Request add actor */
   void RequestAddActor( vtkProp * actor );
 
@@ -253,6 +264,11 @@ private:
   PulseGenerator::Pointer   m_PulseGenerator;
   ObserverType::Pointer     m_PulseObserver;
 
+  /** Whether the refreshes are driven by a FrameScheduler instead of the
+   *  internal pulse generator, and whether the view is refreshing */
+  bool                      m_FrameScheduled;
+  bool                      m_Refreshing;
+
   /** Object representation types */
   typedef ObjectRepresentation::Pointer     ObjectPointer;
   typedef std::list< ObjectPointer >        ObjectListType; 
@@ -44,6 +44,12 @@ ViewProxyBase::SetRenderWindowSize( View * view, int width, int height )
   view->RequestSetRenderWindowSize( width, height );
 }
 
+void 
+ViewProxyBase::RefreshRender( View * view )
+{
+  view->RefreshRender();
+}
+
 void 
 ViewProxyBase
 ::SetPickedPointCoordinates( View * view, 
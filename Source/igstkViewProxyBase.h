@@ -53,6 +53,9 @@ protected:
   /** Set VTK RenderWindow Size */
   void SetRenderWindowSize( View * view, int width, int height );
 
+  /** Refresh the view immediately, as a pulse of its generator would */
+  void RefreshRender( View * view );
+
   /** Set PickedPoint coordinates */
   void SetPickedPointCoordinates( View * view, 
                                   double xPickedPoint ,
@@ -0,0 +1,683 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkViewRecorder.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkViewRecorder.h"
+#include "igstkVideoTrackingRecorder.h"
+#include "igstkRealTimeClock.h"
+
+#include "vtkRenderWindow.h"
+
+#include <itksys/SystemTools.hxx>
+#include "itk_zlib.h"
+
+#include <string.h>
+
+namespace igstk
+{
+
+namespace
+{
+
+/** Numbers are big endian in the PNG files */
+void PutUnsigned32( unsigned char * bytes, unsigned long value )
+{
+  bytes[0] = static_cast< unsigned char >( ( value >> 24 ) & 0xFF );
+  bytes[1] = static_cast< unsigned char >( ( value >> 16 ) & 0xFF );
+  bytes[2] = static_cast< unsigned char >( ( value >> 8 ) & 0xFF );
+  bytes[3] = static_cast< unsigned char >( value & 0xFF );
+}
+
+bool WritePNGChunk( FILE * file, const char * type,
+                    const unsigned char * data, unsigned int size )
+{
+  unsigned char length[4];
+  PutUnsigned32( length, size );
+
+  uLong crc = crc32( 0L, Z_NULL, 0 );
+  crc = crc32( crc, reinterpret_cast< const Bytef * >( type ), 4 );
+  if( size > 0 )
+    {
+    crc = crc32( crc, data, size );
+    }
+  unsigned char crcBytes[4];
+  PutUnsigned32( crcBytes, crc );
+
+  return fwrite( length, 1, 4, file ) == 4 &&
+         fwrite( type, 1, 4, file ) == 4 &&
+         ( size == 0 || fwrite( data, 1, size, file ) == size ) &&
+         fwrite( crcBytes, 1, 4, file ) == 4;
+}
+
+}
+
+ViewRecorder::ViewRecorder():m_StateMachine(this)
+{
+  m_RefreshObserverTag = 0;
+
+  m_RefreshCommand = RefreshCommandType::New();
+  m_RefreshCommand->SetCallbackFunction( this,
+                                         &ViewRecorder::RefreshCallback );
+
+  m_NumberOfBuffers = 8;
+  m_NumberOfThreads = 2;
+  m_Compression = true;
+  m_FramesPerChunk = 300;
+  m_ToolName = "view";
+
+  m_NumberOfBusyThreads = 0;
+  m_StopThreads = false;
+  m_QueueCondition = itk::ConditionVariable::New();
+  m_IdleCondition = itk::ConditionVariable::New();
+
+  m_NextSequence = 0;
+  m_NextSequenceToWrite = 0;
+  m_SequenceCondition = itk::ConditionVariable::New();
+
+  m_RecordingWidth = 0;
+  m_RecordingHeight = 0;
+  m_IndexFile = NULL;
+  m_ChunkFile = NULL;
+  m_Chunk = 0;
+  m_FramesInChunk = 0;
+  m_ChunkOffset = 0;
+
+  m_Recording = false;
+  m_NumberOfScreenShots = 0;
+  m_NumberOfFailedScreenShots = 0;
+  m_NumberOfFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_LastCaptureTime = 0.0;
+
+  m_Threader = itk::MultiThreader::New();
+}
+
+ViewRecorder::~ViewRecorder()
+{
+  this->StopRecording();
+  this->StopThreads();
+
+  if( m_View.IsNotNull() )
+    {
+    m_View->RemoveObserver( m_RefreshObserverTag );
+    }
+}
+
+void ViewRecorder::RequestSetView( View * view )
+{
+  if( m_Recording )
+    {
+    igstkLogMacro( WARNING, "igstk::ViewRecorder::RequestSetView: "
+                   "the view can not be changed while recording\n" );
+    return;
+    }
+
+  if( m_View.IsNotNull() )
+    {
+    m_View->RemoveObserver( m_RefreshObserverTag );
+    }
+
+  m_View = view;
+  m_PendingScreenShots.clear();
+
+  if( m_View.IsNotNull() )
+    {
+    m_RefreshObserverTag =
+      m_View->AddObserver( RefreshEvent(), m_RefreshCommand );
+    }
+}
+
+bool ViewRecorder::RequestSaveScreenShot( const std::string & fileName )
+{
+  if( ::itksys::SystemTools::GetFilenameLastExtension( fileName ) != ".png" )
+    {
+    igstkLogMacro( WARNING, "igstk::ViewRecorder::RequestSaveScreenShot: "
+                   "the file format must be PNG\n" );
+    return false;
+    }
+
+  m_PendingScreenShots.push_back( fileName );
+  return true;
+}
+
+bool ViewRecorder::StartRecording( const std::string & directory )
+{
+  if( m_Recording )
+    {
+    this->StopRecording();
+    }
+
+  if( m_View.IsNull() )
+    {
+    igstkLogMacro( CRITICAL, "igstk::ViewRecorder::StartRecording: "
+                   "no view was set\n" );
+    return false;
+    }
+
+  int * size = m_View->m_RenderWindow->GetSize();
+  if( size[0] <= 0 || size[1] <= 0 )
+    {
+    igstkLogMacro( CRITICAL, "igstk::ViewRecorder::StartRecording: "
+                   "the render window has no size\n" );
+    return false;
+    }
+
+  if( !itksys::SystemTools::MakeDirectory( directory.c_str() ) )
+    {
+    igstkLogMacro( CRITICAL, "igstk::ViewRecorder::StartRecording: "
+                   "can not create " << directory << "\n" );
+    return false;
+    }
+
+  if( m_FramesPerChunk == 0 )
+    {
+    m_FramesPerChunk = 1;
+    }
+
+  typedef VideoTrackingRecorder::FrameIndexHeaderType  HeaderType;
+
+  HeaderType header;
+  memset( &header, 0, sizeof( header ) );
+  memcpy( header.m_Signature,
+          VideoTrackingRecorder::GetFrameIndexSignature(),
+          sizeof( header.m_Signature ) );
+  header.m_Version = VideoTrackingRecorder::FrameIndexVersion;
+  header.m_FrameDimensions[0] = size[0];
+  header.m_FrameDimensions[1] = size[1];
+  header.m_FrameDimensions[2] = 3;
+  header.m_FramesPerChunk = m_FramesPerChunk;
+
+  const std::string indexFileName =
+    VideoTrackingRecorder::GetFrameIndexFileName( directory, m_ToolName );
+  m_IndexFile = fopen( indexFileName.c_str(), "wb" );
+  if( !m_IndexFile )
+    {
+    igstkLogMacro( CRITICAL, "igstk::ViewRecorder::StartRecording: "
+                   "can not create " << indexFileName << "\n" );
+    return false;
+    }
+  fwrite( &header, sizeof( header ), 1, m_IndexFile );
+  fflush( m_IndexFile );
+
+  m_Directory = directory;
+  m_RecordingWidth = size[0];
+  m_RecordingHeight = size[1];
+  m_ChunkFile = NULL;
+  m_Chunk = 0;
+  m_FramesInChunk = 0;
+  m_ChunkOffset = 0;
+
+  m_Lock.Lock();
+  m_NumberOfFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_NextSequence = 0;
+  m_NextSequenceToWrite = 0;
+  m_Recording = true;
+  m_Lock.Unlock();
+
+  return true;
+}
+
+void ViewRecorder::StopRecording()
+{
+  if( !m_Recording )
+    {
+    return;
+    }
+
+  m_Lock.Lock();
+  m_Recording = false;
+  m_Lock.Unlock();
+
+  // The frames already captured are written before the files are closed
+  this->WaitForPendingWrites();
+  this->CloseFiles();
+}
+
+void ViewRecorder::CloseFiles()
+{
+  if( m_IndexFile )
+    {
+    fclose( m_IndexFile );
+    m_IndexFile = NULL;
+    }
+  if( m_ChunkFile )
+    {
+    fclose( m_ChunkFile );
+    m_ChunkFile = NULL;
+    }
+}
+
+bool ViewRecorder::IsRecording() const
+{
+  m_Lock.Lock();
+  const bool recording = m_Recording;
+  m_Lock.Unlock();
+  return recording;
+}
+
+void ViewRecorder::WaitForPendingWrites()
+{
+  m_Lock.Lock();
+  while( !m_QueuedBuffers.empty() || m_NumberOfBusyThreads > 0 )
+    {
+    m_IdleCondition->Wait( &m_Lock );
+    }
+  m_Lock.Unlock();
+}
+
+unsigned long ViewRecorder::GetNumberOfScreenShots() const
+{
+  m_Lock.Lock();
+  const unsigned long numberOfScreenShots = m_NumberOfScreenShots;
+  m_Lock.Unlock();
+  return numberOfScreenShots;
+}
+
+unsigned long ViewRecorder::GetNumberOfFailedScreenShots() const
+{
+  m_Lock.Lock();
+  const unsigned long numberOfFailedScreenShots = m_NumberOfFailedScreenShots;
+  m_Lock.Unlock();
+  return numberOfFailedScreenShots;
+}
+
+unsigned long ViewRecorder::GetNumberOfFrames() const
+{
+  m_Lock.Lock();
+  const unsigned long numberOfFrames = m_NumberOfFrames;
+  m_Lock.Unlock();
+  return numberOfFrames;
+}
+
+unsigned long ViewRecorder::GetNumberOfDroppedFrames() const
+{
+  m_Lock.Lock();
+  const unsigned long numberOfDroppedFrames = m_NumberOfDroppedFrames;
+  m_Lock.Unlock();
+  return numberOfDroppedFrames;
+}
+
+double ViewRecorder::GetLastCaptureTime() const
+{
+  return m_LastCaptureTime;
+}
+
+/** Called in the main thread, right after the view rendered its scene */
+void ViewRecorder::RefreshCallback()
+{
+  if( m_PendingScreenShots.empty() && !m_Recording )
+    {
+    return;
+    }
+
+  this->StartThreads();
+
+  const double captureStart = RealTimeClock::GetTimeStamp();
+
+  if( !m_PendingScreenShots.empty() &&
+      this->Capture( true, m_PendingScreenShots.front() ) )
+    {
+    m_PendingScreenShots.pop_front();
+    }
+
+  if( m_Recording )
+    {
+    this->Capture( false, "" );
+    }
+
+  m_LastCaptureTime = RealTimeClock::GetTimeStamp() - captureStart;
+}
+
+bool ViewRecorder::Capture( bool screenShot, const std::string & fileName )
+{
+  vtkRenderWindow * renderWindow = m_View->m_RenderWindow;
+  int * size = renderWindow->GetSize();
+
+  const bool validSize = screenShot ?
+    ( size[0] > 0 && size[1] > 0 ) :
+    ( static_cast< unsigned int >( size[0] ) == m_RecordingWidth &&
+      static_cast< unsigned int >( size[1] ) == m_RecordingHeight );
+
+  m_Lock.Lock();
+  if( !validSize || m_FreeBuffers.empty() )
+    {
+    if( !screenShot )
+      {
+      m_NumberOfDroppedFrames++;
+      }
+    m_Lock.Unlock();
+    return false;
+    }
+  const unsigned int index = m_FreeBuffers.back();
+  m_FreeBuffers.pop_back();
+  m_Lock.Unlock();
+
+  // A free buffer is only accessed by the main thread, and its pixels are
+  // only reallocated when the size of the view changes
+  CaptureBufferType & buffer = m_Buffers[index];
+  buffer.m_Width = size[0];
+  buffer.m_Height = size[1];
+  buffer.m_Pixels.resize( buffer.m_Width * buffer.m_Height * 3 );
+  renderWindow->GetPixelData( 0, 0, size[0] - 1, size[1] - 1, 1,
+                              &buffer.m_Pixels[0] );
+  buffer.m_Time = RealTimeClock::GetTimeStamp();
+  buffer.m_ScreenShot = screenShot;
+  buffer.m_FileName = fileName;
+  buffer.m_Sequence = screenShot ? 0 : m_NextSequence++;
+
+  m_Lock.Lock();
+  m_QueuedBuffers.push_back( index );
+  m_QueueCondition->Signal();
+  m_Lock.Unlock();
+
+  return true;
+}
+
+void ViewRecorder::StartThreads()
+{
+  if( !m_ThreadIDs.empty() )
+    {
+    return;
+    }
+
+  m_Buffers.resize( m_NumberOfBuffers > 0 ? m_NumberOfBuffers : 1 );
+  m_FreeBuffers.clear();
+  for( unsigned int i = 0; i < m_Buffers.size(); i++ )
+    {
+    m_FreeBuffers.push_back( i );
+    }
+
+  m_StopThreads = false;
+  m_NumberOfBusyThreads = 0;
+
+  const unsigned int numberOfThreads =
+                               m_NumberOfThreads > 0 ? m_NumberOfThreads : 1;
+  for( unsigned int i = 0; i < numberOfThreads; i++ )
+    {
+    m_ThreadIDs.push_back(
+      m_Threader->SpawnThread( EncodingThreadFunction, this ) );
+    }
+}
+
+void ViewRecorder::StopThreads()
+{
+  if( m_ThreadIDs.empty() )
+    {
+    return;
+    }
+
+  m_Lock.Lock();
+  m_StopThreads = true;
+  m_QueueCondition->Broadcast();
+  m_Lock.Unlock();
+
+  // The threads write the queued buffers before exiting
+  for( unsigned int i = 0; i < m_ThreadIDs.size(); i++ )
+    {
+    m_Threader->TerminateThread( m_ThreadIDs[i] );
+    }
+  m_ThreadIDs.clear();
+}
+
+ITK_THREAD_RETURN_TYPE ViewRecorder::EncodingThreadFunction( void * info )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)info;
+
+  if( pInfo == NULL || pInfo->UserData == NULL )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  ViewRecorder * recorder = static_cast< ViewRecorder * >( pInfo->UserData );
+
+  while( true )
+    {
+    recorder->m_Lock.Lock();
+    while( !recorder->m_StopThreads && recorder->m_QueuedBuffers.empty() )
+      {
+      recorder->m_QueueCondition->Wait( &recorder->m_Lock );
+      }
+
+    if( recorder->m_QueuedBuffers.empty() )
+      {
+      recorder->m_Lock.Unlock();
+      break;
+      }
+
+    const unsigned int index = recorder->m_QueuedBuffers.front();
+    recorder->m_QueuedBuffers.pop_front();
+    recorder->m_NumberOfBusyThreads++;
+    recorder->m_Lock.Unlock();
+
+    CaptureBufferType & buffer = recorder->m_Buffers[index];
+    const bool written = buffer.m_ScreenShot ?
+                         recorder->WriteScreenShot( buffer ) :
+                         recorder->WriteFrame( buffer );
+
+    recorder->m_Lock.Lock();
+    if( buffer.m_ScreenShot )
+      {
+      if( written )
+        {
+        recorder->m_NumberOfScreenShots++;
+        }
+      else
+        {
+        recorder->m_NumberOfFailedScreenShots++;
+        }
+      }
+    else
+      {
+      if( written )
+        {
+        recorder->m_NumberOfFrames++;
+        }
+      else
+        {
+        recorder->m_NumberOfDroppedFrames++;
+        }
+      }
+    recorder->m_FreeBuffers.push_back( index );
+    recorder->m_NumberOfBusyThreads--;
+    if( recorder->m_QueuedBuffers.empty() &&
+        recorder->m_NumberOfBusyThreads == 0 )
+      {
+      recorder->m_IdleCondition->Broadcast();
+      }
+    recorder->m_Lock.Unlock();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/** The rows of the render window go from the bottom to the top, and the
+ *  rows of a PNG file from the top to the bottom. Each row starts with
+ *  its filter type, none here. */
+bool ViewRecorder::WriteScreenShot( CaptureBufferType & buffer )
+{
+  const unsigned int rowSize = buffer.m_Width * 3;
+  buffer.m_Rows.resize( ( rowSize + 1 ) * buffer.m_Height );
+  for( unsigned int row = 0; row < buffer.m_Height; row++ )
+    {
+    unsigned char * out = &buffer.m_Rows[row * ( rowSize + 1 )];
+    out[0] = 0;
+    memcpy( out + 1,
+            &buffer.m_Pixels[( buffer.m_Height - 1 - row ) * rowSize],
+            rowSize );
+    }
+
+  buffer.m_Encoded.resize( compressBound( buffer.m_Rows.size() ) );
+  uLongf encodedSize = buffer.m_Encoded.size();
+  if( compress2( &buffer.m_Encoded[0], &encodedSize,
+                 &buffer.m_Rows[0], buffer.m_Rows.size(),
+                 Z_BEST_SPEED ) != Z_OK )
+    {
+    return false;
+    }
+
+  FILE * file = fopen( buffer.m_FileName.c_str(), "wb" );
+  if( !file )
+    {
+    igstkLogMacro( WARNING, "igstk::ViewRecorder::WriteScreenShot: "
+                   "can not create " << buffer.m_FileName << "\n" );
+    return false;
+    }
+
+  static const unsigned char signature[8] =
+    { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+  unsigned char header[13];
+  PutUnsigned32( header, buffer.m_Width );
+  PutUnsigned32( header + 4, buffer.m_Height );
+  header[8] = 8;     // bits per sample
+  header[9] = 2;     // RGB
+  header[10] = 0;    // deflate
+  header[11] = 0;    // filtering by row
+  header[12] = 0;    // no interlace
+
+  bool written = fwrite( signature, 1, 8, file ) == 8 &&
+                 WritePNGChunk( file, "IHDR", header, 13 ) &&
+                 WritePNGChunk( file, "IDAT", &buffer.m_Encoded[0],
+                                encodedSize ) &&
+                 WritePNGChunk( file, "IEND", NULL, 0 );
+  if( fclose( file ) != 0 )
+    {
+    written = false;
+    }
+  return written;
+}
+
+/** The frames are compressed in parallel, then written one after the
+ *  other in the order they were captured */
+bool ViewRecorder::WriteFrame( CaptureBufferType & buffer )
+{
+  typedef VideoTrackingRecorder::FrameIndexEntryType  EntryType;
+
+  EntryType entry;
+  entry.m_Time = buffer.m_Time;
+  entry.m_Encoding = VideoTrackingRecorder::RawEncoding;
+  entry.m_DataSize = buffer.m_Pixels.size();
+
+  const unsigned char * data = &buffer.m_Pixels[0];
+
+  if( m_Compression )
+    {
+    buffer.m_Encoded.resize( compressBound( buffer.m_Pixels.size() ) );
+    uLongf encodedSize = buffer.m_Encoded.size();
+    if( compress2( &buffer.m_Encoded[0], &encodedSize,
+                   data, buffer.m_Pixels.size(), Z_BEST_SPEED ) == Z_OK &&
+        encodedSize < buffer.m_Pixels.size() )
+      {
+      entry.m_Encoding = VideoTrackingRecorder::ZlibEncoding;
+      entry.m_DataSize = encodedSize;
+      data = &buffer.m_Encoded[0];
+      }
+    }
+
+  m_Lock.Lock();
+  while( buffer.m_Sequence != m_NextSequenceToWrite )
+    {
+    m_SequenceCondition->Wait( &m_Lock );
+    }
+  m_Lock.Unlock();
+
+  bool written = true;
+
+  // Start a new chunk when the current one is full
+  if( !m_ChunkFile ||
+      m_FramesInChunk == m_FramesPerChunk ||
+      m_ChunkOffset > 0xFFFFFFFFU - entry.m_DataSize )
+    {
+    if( m_ChunkFile )
+      {
+      fclose( m_ChunkFile );
+      m_Chunk++;
+      }
+    const std::string chunkFileName =
+      VideoTrackingRecorder::GetChunkFileName( m_Directory, m_ToolName,
+                                               m_Chunk );
+    m_ChunkFile = fopen( chunkFileName.c_str(), "wb" );
+    m_FramesInChunk = 0;
+    m_ChunkOffset = 0;
+    if( !m_ChunkFile )
+      {
+      igstkLogMacro( CRITICAL, "igstk::ViewRecorder::WriteFrame: "
+                     "can not create " << chunkFileName << "\n" );
+      written = false;
+      }
+    }
+
+  if( written &&
+      fwrite( data, 1, entry.m_DataSize, m_ChunkFile ) != entry.m_DataSize )
+    {
+    written = false;
+    }
+
+  // The frame is indexed once it is in its chunk
+  if( written )
+    {
+    fflush( m_ChunkFile );
+    entry.m_Chunk = m_Chunk;
+    entry.m_Offset = m_ChunkOffset;
+    fwrite( &entry, sizeof( entry ), 1, m_IndexFile );
+    fflush( m_IndexFile );
+
+    m_FramesInChunk++;
+    m_ChunkOffset += entry.m_DataSize;
+    }
+
+  m_Lock.Lock();
+  m_NextSequenceToWrite++;
+  m_SequenceCondition->Broadcast();
+  m_Lock.Unlock();
+
+  return written;
+}
+
+/** Print Self function */
+void ViewRecorder::PrintSelf( std::ostream& os, itk::Indent indent ) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "View: " << m_View.GetPointer() << std::endl;
+  os << indent << "Number of buffers: " << m_NumberOfBuffers << std::endl;
+  os << indent << "Number of threads: " << m_NumberOfThreads << std::endl;
+  os << indent << "Compression: " << m_Compression << std::endl;
+  os << indent << "Frames per chunk: " << m_FramesPerChunk << std::endl;
+  os << indent << "Tool name: " << m_ToolName << std::endl;
+  os << indent << "Pending screen shots: " << m_PendingScreenShots.size()
+     << std::endl;
+  os << indent << "Number of screen shots: "
+     << this->GetNumberOfScreenShots() << std::endl;
+  os << indent << "Number of failed screen shots: "
+     << this->GetNumberOfFailedScreenShots() << std::endl;
+  os << indent << "Recording: " << this->IsRecording() << std::endl;
+  os << indent << "Number of frames: " << this->GetNumberOfFrames()
+     << std::endl;
+  os << indent << "Number of dropped frames: "
+     << this->GetNumberOfDroppedFrames() << std::endl;
+  os << indent << "Last capture time: " << m_LastCaptureTime << std::endl;
+}
+
+} // end namespace igstk
@@ -0,0 +1,233 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkViewRecorder.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef __igstkViewRecorder_h
+#define __igstkViewRecorder_h
+
+#include "igstkObject.h"
+#include "igstkView.h"
+
+#include "itkMutexLock.h"
+#include "itkConditionVariable.h"
+#include "itkMultiThreader.h"
+#include "itkCommand.h"
+
+#include <stdio.h>
+#include <vector>
+#include <deque>
+#include <list>
+#include <string>
+
+namespace igstk
+{
+
+/** \class ViewRecorder
+ *  \brief Saves screen shots and records a view without stalling it.
+ *
+ *  The recorder observes the refreshes of a view. After a refresh, it
+ *  copies the pixels of the render window in one of NumberOfBuffers
+ *  preallocated buffers, and returns. A pool of NumberOfThreads encoding
+ *  threads compresses the buffers and writes them, so that the rendering
+ *  never waits for the compression or the disk.
+ *
+ *  RequestSaveScreenShot() captures the next frame rendered by the view
+ *  and saves it as a PNG file. If no buffer is free, the capture waits for
+ *  the next refresh.
+ *
+ *  StartRecording() captures every frame rendered by the view until
+ *  StopRecording(). The recording uses the frame index and chunk files of
+ *  the VideoTrackingRecorder, with ToolName as the name of the tool, so
+ *  that it can be replayed with a PlaybackVideoImager. The frames are RGB,
+ *  from the bottom row to the top one, compressed without loss with zlib
+ *  when Compression is on. The frames are compressed in parallel and
+ *  written in order. When no buffer is free, because the threads can not
+ *  keep up, the frame is dropped and counted. Frames whose size differs
+ *  from the size of the view when the recording started are dropped too.
+ *
+ *  The view must be refreshing, on its own pulses or from a
+ *  FrameScheduler, for frames to be captured. The recorder is built with
+ *  the video imagers, whose file format it shares.
+ *
+ *  \sa View
+ *  \sa VideoTrackingRecorder
+ *
+ *  \ingroup View
+ */
+class ViewRecorder : public Object
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( ViewRecorder, Object )
+
+  /** Set the view whose frames are captured */
+  void RequestSetView( View * view );
+
+  /** Number of capture buffers, 8 by default. Used when the first frame
+   *  is captured. */
+  igstkSetMacro( NumberOfBuffers, unsigned int );
+  igstkGetMacro( NumberOfBuffers, unsigned int );
+
+  /** Number of encoding threads, 2 by default. Used when the first frame
+   *  is captured. */
+  igstkSetMacro( NumberOfThreads, unsigned int );
+  igstkGetMacro( NumberOfThreads, unsigned int );
+
+  /** Compress the recorded frames without loss. True by default. */
+  igstkSetMacro( Compression, bool );
+  igstkGetMacro( Compression, bool );
+
+  /** Number of frames per chunk file, 300 by default */
+  igstkSetMacro( FramesPerChunk, unsigned int );
+  igstkGetMacro( FramesPerChunk, unsigned int );
+
+  /** Name of the tool of the recordings, "view" by default */
+  igstkSetMacro( ToolName, std::string );
+  igstkGetMacro( ToolName, std::string );
+
+  /** Save the next frame rendered by the view in a PNG file. Returns
+   *  false if the file name does not have the ".png" extension. */
+  bool RequestSaveScreenShot( const std::string & fileName );
+
+  /** Create the recording directory and start recording. Returns false if
+   *  there is no view or a file can not be created. */
+  bool StartRecording( const std::string & directory );
+
+  /** Write the captured frames and close the files */
+  void StopRecording();
+
+  /** Whether the recorder is recording */
+  bool IsRecording() const;
+
+  /** Wait until the captured frames and screen shots are written */
+  void WaitForPendingWrites();
+
+  /** Number of screen shots saved, and that could not be written */
+  unsigned long GetNumberOfScreenShots() const;
+  unsigned long GetNumberOfFailedScreenShots() const;
+
+  /** Number of frames recorded, and dropped */
+  unsigned long GetNumberOfFrames() const;
+  unsigned long GetNumberOfDroppedFrames() const;
+
+  /** Time spent copying the last frame out of the render window, in
+   *  milliseconds. This is what the capture costs to the view. */
+  double GetLastCaptureTime() const;
+
+protected:
+
+  ViewRecorder();
+  virtual ~ViewRecorder();
+
+  /** Print object information */
+  virtual void PrintSelf( std::ostream& os, itk::Indent indent ) const;
+
+private:
+
+  ViewRecorder(const Self&);   //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  /** Captured frame. The pixels and the encoding buffers are reused from
+   *  one frame to the next. */
+  struct CaptureBufferType
+    {
+    std::vector< unsigned char >  m_Pixels;
+    std::vector< unsigned char >  m_Rows;
+    std::vector< unsigned char >  m_Encoded;
+    unsigned int                  m_Width;
+    unsigned int                  m_Height;
+    double                        m_Time;
+    bool                          m_ScreenShot;
+    std::string                   m_FileName;
+    unsigned long                 m_Sequence;
+    };
+
+  /** Copy the pixels of the view after a refresh */
+  void RefreshCallback();
+
+  /** Copy the render window in a free buffer and queue it. Returns false
+   *  if no buffer is free. */
+  bool Capture( bool screenShot, const std::string & fileName );
+
+  /** Allocate the buffers and spawn the encoding threads */
+  void StartThreads();
+  void StopThreads();
+
+  /** Encoding threads */
+  static ITK_THREAD_RETURN_TYPE EncodingThreadFunction( void * info );
+
+  /** Encode and write a buffer, called in an encoding thread */
+  bool WriteScreenShot( CaptureBufferType & buffer );
+  bool WriteFrame( CaptureBufferType & buffer );
+
+  void CloseFiles();
+
+  View::Pointer                       m_View;
+  unsigned long                       m_RefreshObserverTag;
+
+  typedef itk::SimpleMemberCommand< Self >  RefreshCommandType;
+  RefreshCommandType::Pointer         m_RefreshCommand;
+
+  unsigned int                        m_NumberOfBuffers;
+  unsigned int                        m_NumberOfThreads;
+  bool                                m_Compression;
+  unsigned int                        m_FramesPerChunk;
+  std::string                         m_ToolName;
+
+  /** Screen shots waiting for a refresh, accessed by the main thread */
+  std::list< std::string >            m_PendingScreenShots;
+
+  /** Buffers, free and queued for encoding, protected by m_Lock */
+  std::vector< CaptureBufferType >    m_Buffers;
+  std::vector< unsigned int >         m_FreeBuffers;
+  std::deque< unsigned int >          m_QueuedBuffers;
+  unsigned int                        m_NumberOfBusyThreads;
+  bool                                m_StopThreads;
+  mutable itk::SimpleMutexLock        m_Lock;
+  itk::ConditionVariable::Pointer     m_QueueCondition;
+  itk::ConditionVariable::Pointer     m_IdleCondition;
+
+  /** The recorded frames are written in the order of their sequence */
+  unsigned long                       m_NextSequence;
+  unsigned long                       m_NextSequenceToWrite;
+  itk::ConditionVariable::Pointer     m_SequenceCondition;
+
+  /** Files of the recording, accessed by the thread writing the next
+   *  frame in the sequence */
+  std::string                         m_Directory;
+  unsigned int                        m_RecordingWidth;
+  unsigned int                        m_RecordingHeight;
+  FILE *                              m_IndexFile;
+  FILE *                              m_ChunkFile;
+  unsigned int                        m_Chunk;
+  unsigned int                        m_FramesInChunk;
+  unsigned int                        m_ChunkOffset;
+
+  bool                                m_Recording;
+  unsigned long                       m_NumberOfScreenShots;
+  unsigned long                       m_NumberOfFailedScreenShots;
+  unsigned long                       m_NumberOfFrames;
+  unsigned long                       m_NumberOfDroppedFrames;
+  double                              m_LastCaptureTime;
+
+  itk::MultiThreader::Pointer         m_Threader;
+  std::vector< int >                  m_ThreadIDs;
+};
+
+} // end namespace igstk
+
+#endif // __igstkViewRecorder_h
@@ -0,0 +1,377 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkBenchmark.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkBenchmark.h"
+#include "igstkConfigure.h"
+#include "igstkRealTimeClock.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include <algorithm>
+
+namespace igstk
+{
+
+namespace Benchmarks
+{
+
+std::string Benchmark::m_DataRoot;
+
+Benchmark::Benchmark( const std::string & name, const std::string & kind,
+                      unsigned long iterations )
+{
+  m_Name = name;
+  m_Kind = kind;
+  m_Iterations = iterations;
+}
+
+
+Benchmark::~Benchmark()
+{
+}
+
+
+bool Benchmark::Setup( std::string & )
+{
+  return true;
+}
+
+
+void Benchmark::TearDown()
+{
+}
+
+
+double Benchmark::GetItemsPerIteration() const
+{
+  return 1.0;
+}
+
+
+const std::string & Benchmark::GetName() const
+{
+  return m_Name;
+}
+
+
+const std::string & Benchmark::GetKind() const
+{
+  return m_Kind;
+}
+
+
+unsigned long Benchmark::GetIterations() const
+{
+  return m_Iterations;
+}
+
+
+void Benchmark::SetDataRoot( const std::string & directory )
+{
+  m_DataRoot = directory;
+}
+
+
+const std::string & Benchmark::GetDataRoot()
+{
+  return m_DataRoot;
+}
+
+
+BenchmarkRunner::BenchmarkRunner()
+{
+  m_NumberOfRepetitions = 5;
+  m_IterationScale = 1.0;
+}
+
+
+BenchmarkRunner::~BenchmarkRunner()
+{
+  BenchmarkListType::iterator it = m_Benchmarks.begin();
+  while( it != m_Benchmarks.end() )
+    {
+    delete *it;
+    ++it;
+    }
+}
+
+
+void BenchmarkRunner::Register( Benchmark * benchmark )
+{
+  m_Benchmarks.push_back( benchmark );
+}
+
+
+void BenchmarkRunner::SetFilter( const std::string & filter )
+{
+  m_Filter = filter;
+}
+
+
+void BenchmarkRunner::SetExclusion( const std::string & exclusion )
+{
+  m_Exclusion = exclusion;
+}
+
+
+void BenchmarkRunner::SetNumberOfRepetitions( unsigned int repetitions )
+{
+  m_NumberOfRepetitions = ( repetitions > 0 ) ? repetitions : 1;
+}
+
+
+void BenchmarkRunner::SetIterationScale( double scale )
+{
+  m_IterationScale = ( scale > 0.0 ) ? scale : 1.0;
+}
+
+
+unsigned int BenchmarkRunner::Run( std::ostream & json, std::ostream & log )
+{
+  std::vector< ResultType > results;
+
+  BenchmarkListType::iterator it = m_Benchmarks.begin();
+  while( it != m_Benchmarks.end() )
+    {
+    Benchmark * benchmark = *it;
+    ++it;
+
+    if( ( !m_Filter.empty() &&
+          benchmark->GetName().find( m_Filter ) == std::string::npos ) ||
+        ( !m_Exclusion.empty() &&
+          benchmark->GetName().find( m_Exclusion ) != std::string::npos ) )
+      {
+      continue;
+      }
+
+    ResultType result;
+    this->RunBenchmark( benchmark, result );
+    results.push_back( result );
+
+    log << result.m_Name << ": ";
+    if( result.m_Skipped )
+      {
+      log << "skipped (" << result.m_ReasonForSkipping << ")" << std::endl;
+      }
+    else
+      {
+      log << result.m_MedianTime << " ns per iteration, "
+          << result.m_ItemsPerSecond << " items per second" << std::endl;
+      }
+    }
+
+  this->WriteJSON( json, results );
+
+  unsigned int numberOfRuns = 0;
+  for( unsigned int i = 0; i < results.size(); i++ )
+    {
+    if( !results[i].m_Skipped )
+      {
+      numberOfRuns++;
+      }
+    }
+  return numberOfRuns;
+}
+
+
+void BenchmarkRunner::RunBenchmark( Benchmark * benchmark,
+                                    ResultType & result )
+{
+  result.m_Name = benchmark->GetName();
+  result.m_Kind = benchmark->GetKind();
+  result.m_Skipped = false;
+  result.m_Repetitions = m_NumberOfRepetitions;
+  result.m_MinimumTime = 0.0;
+  result.m_MedianTime = 0.0;
+  result.m_MeanTime = 0.0;
+  result.m_StandardDeviation = 0.0;
+  result.m_ItemsPerSecond = 0.0;
+
+  unsigned long iterations = static_cast< unsigned long >(
+                            benchmark->GetIterations() * m_IterationScale );
+  if( iterations == 0 )
+    {
+    iterations = 1;
+    }
+  result.m_Iterations = iterations;
+
+  if( !benchmark->Setup( result.m_ReasonForSkipping ) )
+    {
+    result.m_Skipped = true;
+    benchmark->TearDown();
+    return;
+    }
+
+  // Warm up the caches and the lazily allocated buffers
+  benchmark->Run( ( iterations + 9 ) / 10 );
+
+  std::vector< double > times;
+  for( unsigned int r = 0; r < m_NumberOfRepetitions; r++ )
+    {
+    const double start = RealTimeClock::GetTimeStamp();
+    benchmark->Run( iterations );
+    const double stop = RealTimeClock::GetTimeStamp();
+
+    // Milliseconds for the repetition to nanoseconds per iteration
+    times.push_back( ( stop - start ) * 1e6 / iterations );
+    }
+
+  benchmark->TearDown();
+
+  std::sort( times.begin(), times.end() );
+
+  const unsigned int n = static_cast< unsigned int >( times.size() );
+  double sum = 0.0;
+  for( unsigned int i = 0; i < n; i++ )
+    {
+    sum += times[i];
+    }
+  const double mean = sum / n;
+
+  double sumOfSquares = 0.0;
+  for( unsigned int i = 0; i < n; i++ )
+    {
+    sumOfSquares += ( times[i] - mean ) * ( times[i] - mean );
+    }
+
+  result.m_MinimumTime = times[0];
+  result.m_MedianTime = ( n % 2 ) ? times[ n / 2 ] :
+                          0.5 * ( times[ n / 2 - 1 ] + times[ n / 2 ] );
+  result.m_MeanTime = mean;
+  result.m_StandardDeviation = ( n > 1 ) ? sqrt( sumOfSquares / ( n - 1 ) )
+                                         : 0.0;
+  if( result.m_MedianTime > 0.0 )
+    {
+    result.m_ItemsPerSecond = benchmark->GetItemsPerIteration() * 1e9 /
+                              result.m_MedianTime;
+    }
+}
+
+
+std::string BenchmarkRunner::EscapeJSON( const std::string & text )
+{
+  std::string escaped;
+  for( unsigned int i = 0; i < text.size(); i++ )
+    {
+    const char c = text[i];
+    if( c == '"' || c == '\\' )
+      {
+      escaped += '\\';
+      escaped += c;
+      }
+    else if( static_cast< unsigned char >( c ) < 0x20 )
+      {
+      char code[8];
+      sprintf( code, "\\u%04x", static_cast< unsigned int >( c ) );
+      escaped += code;
+      }
+    else
+      {
+      escaped += c;
+      }
+    }
+  return escaped;
+}
+
+
+void BenchmarkRunner::WriteJSON( std::ostream & json,
+                          const std::vector< ResultType > & results ) const
+{
+  char date[64];
+  const time_t now = time( NULL );
+  strftime( date, sizeof( date ), "%Y-%m-%dT%H:%M:%SZ", gmtime( &now ) );
+
+  std::string compiler;
+#if defined(_MSC_VER)
+  char version[32];
+  sprintf( version, "MSVC %d", _MSC_VER );
+  compiler = version;
+#elif defined(__VERSION__)
+  compiler = __VERSION__;
+#else
+  compiler = "unknown";
+#endif
+
+  const std::streamsize precision = json.precision();
+  json.precision( 10 );
+
+  json << "{" << std::endl;
+  json << "  \"context\": {" << std::endl;
+  json << "    \"date\": \"" << date << "\"," << std::endl;
+  json << "    \"igstk_version\": \"" << IGSTK_VERSION_STRING << "\","
+       << std::endl;
+  json << "    \"compiler\": \"" << EscapeJSON( compiler ) << "\","
+       << std::endl;
+  json << "    \"repetitions\": " << m_NumberOfRepetitions << ","
+       << std::endl;
+  json << "    \"iteration_scale\": " << m_IterationScale << std::endl;
+  json << "  }," << std::endl;
+  json << "  \"benchmarks\": [" << std::endl;
+
+  for( unsigned int i = 0; i < results.size(); i++ )
+    {
+    const ResultType & result = results[i];
+    json << "    {" << std::endl;
+    json << "      \"name\": \"" << EscapeJSON( result.m_Name ) << "\","
+         << std::endl;
+    json << "      \"kind\": \"" << EscapeJSON( result.m_Kind ) << "\","
+         << std::endl;
+    if( result.m_Skipped )
+      {
+      json << "      \"skipped\": true," << std::endl;
+      json << "      \"reason\": \""
+           << EscapeJSON( result.m_ReasonForSkipping ) << "\"" << std::endl;
+      }
+    else
+      {
+      json << "      \"skipped\": false," << std::endl;
+      json << "      \"iterations\": " << result.m_Iterations << ","
+           << std::endl;
+      json << "      \"repetitions\": " << result.m_Repetitions << ","
+           << std::endl;
+      json << "      \"time_unit\": \"ns\"," << std::endl;
+      json << "      \"min_time\": " << result.m_MinimumTime << ","
+           << std::endl;
+      json << "      \"median_time\": " << result.m_MedianTime << ","
+           << std::endl;
+      json << "      \"mean_time\": " << result.m_MeanTime << ","
+           << std::endl;
+      json << "      \"stddev_time\": " << result.m_StandardDeviation << ","
+           << std::endl;
+      json << "      \"items_per_second\": " << result.m_ItemsPerSecond
+           << std::endl;
+      }
+    json << "    }" << ( ( i + 1 < results.size() ) ? "," : "" )
+         << std::endl;
+    }
+
+  json << "  ]" << std::endl;
+  json << "}" << std::endl;
+
+  json.precision( precision );
+}
+
+} // end namespace Benchmarks
+
+} // end namespace igstk
@@ -0,0 +1,172 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkBenchmark.h
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __igstkBenchmark_h
+#define __igstkBenchmark_h
+
+#include "igstkConfigure.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace igstk
+{
+
+namespace Benchmarks
+{
+
+/** \class Benchmark
+ *
+ * \brief Base class of the benchmarks run by the igstkBenchmarks executable.
+ *
+ * A benchmark prepares its data in Setup(), then Run() is timed for a fixed
+ * number of iterations, for several repetitions. The number of iterations is
+ * fixed by the benchmark, and only scaled from the command line, so that two
+ * runs of the same build execute exactly the same work.
+ *
+ * Micro benchmarks time a single operation of the toolkit. Scenario
+ * benchmarks time a complete pipeline, such as a view rendering a scene.
+ */
+class Benchmark
+{
+public:
+
+  Benchmark( const std::string & name, const std::string & kind,
+             unsigned long iterations );
+  virtual ~Benchmark();
+
+  /** Prepare the data. Returns false, with a reason, if the benchmark can
+   *  not run in this configuration. */
+  virtual bool Setup( std::string & reasonForSkipping );
+
+  /** Execute the timed operation the given number of times */
+  virtual void Run( unsigned long iterations ) = 0;
+
+  /** Release the data */
+  virtual void TearDown();
+
+  /** Number of items processed by one iteration, e.g. points, events or
+   *  frames. Used to report a throughput. */
+  virtual double GetItemsPerIteration() const;
+
+  const std::string & GetName() const;
+  const std::string & GetKind() const;
+  unsigned long GetIterations() const;
+
+  /** Directory holding the IGSTK data, for the benchmarks replaying
+   *  captured streams. Empty if it was not given. */
+  static void SetDataRoot( const std::string & directory );
+  static const std::string & GetDataRoot();
+
+private:
+
+  Benchmark( const Benchmark & );     //purposely not implemented
+  void operator=( const Benchmark & ); //purposely not implemented
+
+  std::string     m_Name;
+  std::string     m_Kind;
+  unsigned long   m_Iterations;
+
+  static std::string  m_DataRoot;
+};
+
+
+/** \class BenchmarkRunner
+ *
+ * \brief Runs the registered benchmarks and writes their results as JSON.
+ *
+ * The runner owns the registered benchmarks. The output contains one
+ * record per benchmark with the per iteration time in nanoseconds (minimum,
+ * median, mean and standard deviation over the repetitions) and the
+ * throughput in items per second.
+ */
+class BenchmarkRunner
+{
+public:
+
+  BenchmarkRunner();
+  ~BenchmarkRunner();
+
+  /** Take ownership of a benchmark */
+  void Register( Benchmark * benchmark );
+
+  /** Only run the benchmarks whose name contains the filter */
+  void SetFilter( const std::string & filter );
+
+  /** Skip the benchmarks whose name contains the exclusion */
+  void SetExclusion( const std::string & exclusion );
+
+  /** Number of timed repetitions of each benchmark */
+  void SetNumberOfRepetitions( unsigned int repetitions );
+
+  /** Factor applied to the number of iterations of every benchmark */
+  void SetIterationScale( double scale );
+
+  /** Run the benchmarks and write the JSON report. Returns the number of
+   *  benchmarks that were run. */
+  unsigned int Run( std::ostream & json, std::ostream & log );
+
+private:
+
+  BenchmarkRunner( const BenchmarkRunner & );  //purposely not implemented
+  void operator=( const BenchmarkRunner & );   //purposely not implemented
+
+  struct ResultType
+    {
+    std::string     m_Name;
+    std::string     m_Kind;
+    bool            m_Skipped;
+    std::string     m_ReasonForSkipping;
+    unsigned long   m_Iterations;
+    unsigned int    m_Repetitions;
+    double          m_MinimumTime;
+    double          m_MedianTime;
+    double          m_MeanTime;
+    double          m_StandardDeviation;
+    double          m_ItemsPerSecond;
+    };
+
+  void RunBenchmark( Benchmark * benchmark, ResultType & result );
+
+  void WriteJSON( std::ostream & json,
+                  const std::vector< ResultType > & results ) const;
+
+  static std::string EscapeJSON( const std::string & text );
+
+  typedef std::vector< Benchmark * >  BenchmarkListType;
+
+  BenchmarkListType   m_Benchmarks;
+  std::string         m_Filter;
+  std::string         m_Exclusion;
+  unsigned int        m_NumberOfRepetitions;
+  double              m_IterationScale;
+};
+
+
+/** Functions registering the benchmarks of each module */
+void RegisterCoreBenchmarks( BenchmarkRunner & runner );
+void RegisterTrackerBenchmarks( BenchmarkRunner & runner );
+void RegisterViewBenchmarks( BenchmarkRunner & runner );
+#ifdef IGSTK_USE_VideoImager
+void RegisterVideoBenchmarks( BenchmarkRunner & runner );
+#endif
+
+} // end namespace Benchmarks
+
+} // end namespace igstk
+
+#endif
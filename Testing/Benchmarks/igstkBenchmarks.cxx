@@ -0,0 +1,124 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkBenchmarks.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkBenchmark.h"
+#include "igstkRealTimeClock.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+
+namespace
+{
+
+void PrintUsage( const char * program )
+{
+  std::cerr << "Usage: " << program << " [options]" << std::endl
+            << "  --output file.json   write the results to a file "
+            << "instead of the standard output" << std::endl
+            << "  --data-root dir      IGSTK data directory" << std::endl
+            << "  --filter text        only run the benchmarks whose name "
+            << "contains text" << std::endl
+            << "  --exclude text       skip the benchmarks whose name "
+            << "contains text" << std::endl
+            << "  --repetitions n      number of timed repetitions "
+            << "(default 5)" << std::endl
+            << "  --scale s            factor applied to the number of "
+            << "iterations (default 1)" << std::endl;
+}
+
+}
+
+int main( int argc, char * argv[] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  typedef igstk::Benchmarks::Benchmark        BenchmarkType;
+  typedef igstk::Benchmarks::BenchmarkRunner  RunnerType;
+
+  RunnerType runner;
+  std::string outputFileName;
+
+  for( int i = 1; i < argc; i++ )
+    {
+    const bool hasValue = ( i + 1 < argc );
+
+    if( !strcmp( argv[i], "--output" ) && hasValue )
+      {
+      outputFileName = argv[++i];
+      }
+    else if( !strcmp( argv[i], "--data-root" ) && hasValue )
+      {
+      BenchmarkType::SetDataRoot( argv[++i] );
+      }
+    else if( !strcmp( argv[i], "--filter" ) && hasValue )
+      {
+      runner.SetFilter( argv[++i] );
+      }
+    else if( !strcmp( argv[i], "--exclude" ) && hasValue )
+      {
+      runner.SetExclusion( argv[++i] );
+      }
+    else if( !strcmp( argv[i], "--repetitions" ) && hasValue )
+      {
+      runner.SetNumberOfRepetitions( atoi( argv[++i] ) );
+      }
+    else if( !strcmp( argv[i], "--scale" ) && hasValue )
+      {
+      runner.SetIterationScale( atof( argv[++i] ) );
+      }
+    else
+      {
+      PrintUsage( argv[0] );
+      return EXIT_FAILURE;
+      }
+    }
+
+  igstk::Benchmarks::RegisterCoreBenchmarks( runner );
+  igstk::Benchmarks::RegisterTrackerBenchmarks( runner );
+#ifdef IGSTK_USE_VideoImager
+  igstk::Benchmarks::RegisterVideoBenchmarks( runner );
+#endif
+  igstk::Benchmarks::RegisterViewBenchmarks( runner );
+
+  if( outputFileName.empty() )
+    {
+    // The JSON report goes to the standard output, the progress to the error
+    runner.Run( std::cout, std::cerr );
+    return EXIT_SUCCESS;
+    }
+
+  std::ofstream outputFile( outputFileName.c_str() );
+  if( !outputFile.is_open() )
+    {
+    std::cerr << "Can not open " << outputFileName << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  runner.Run( outputFile, std::cout );
+  outputFile.close();
+
+  std::cout << "Results written to " << outputFileName << std::endl;
+
+  return EXIT_SUCCESS;
+}
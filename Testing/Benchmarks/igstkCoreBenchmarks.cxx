@@ -0,0 +1,312 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkCoreBenchmarks.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+// Warning about: constructor of the state machine receiving a pointer to this
+// from a constructor.
+#pragma warning( disable : 4355 )
+#endif
+
+#include "igstkBenchmark.h"
+
+#include "igstkMacros.h"
+#include "igstkStateMachine.h"
+#include "igstkCoordinateSystem.h"
+#include "igstkCoordinateSystemTransformToResult.h"
+#include "igstkRigidTransform.h"
+
+#include <vector>
+
+namespace igstk
+{
+
+namespace Benchmarks
+{
+
+/** State machine toggling between two states, with an action on each
+ *  transition, as most IGSTK components do on every request. */
+class StateMachineToggle
+{
+public:
+
+  typedef StateMachine< StateMachineToggle >   StateMachineType;
+
+  igstkFriendClassMacro( StateMachine< StateMachineToggle > );
+  igstkTypeMacro( StateMachineToggle, None );
+
+  StateMachineToggle() : m_StateMachine( this )
+    {
+    m_Counter = 0;
+    m_StateMachine.AddState( m_OffState, "OffState" );
+    m_StateMachine.AddState( m_OnState, "OnState" );
+    m_StateMachine.AddInput( m_ToggleInput, "ToggleInput" );
+    m_StateMachine.AddTransition( m_OffState, m_ToggleInput, m_OnState,
+                                  &StateMachineToggle::CountProcessing );
+    m_StateMachine.AddTransition( m_OnState, m_ToggleInput, m_OffState,
+                                  &StateMachineToggle::CountProcessing );
+    m_StateMachine.SelectInitialState( m_OffState );
+    m_StateMachine.SetReadyToRun();
+    }
+
+  void RequestToggle()
+    {
+    m_StateMachine.PushInput( m_ToggleInput );
+    m_StateMachine.ProcessInputs();
+    }
+
+  unsigned long GetCounter() const
+    {
+    return m_Counter;
+    }
+
+private:
+
+  void CountProcessing()
+    {
+    m_Counter++;
+    }
+
+  StateMachineType                  m_StateMachine;
+  StateMachineType::StateType       m_OffState;
+  StateMachineType::StateType       m_OnState;
+  StateMachineType::InputType       m_ToggleInput;
+  unsigned long                     m_Counter;
+};
+
+
+class StateMachineDispatchBenchmark : public Benchmark
+{
+public:
+  StateMachineDispatchBenchmark()
+    : Benchmark( "StateMachine/Dispatch", "micro", 1000000 ) {}
+
+  virtual void Run( unsigned long iterations )
+    {
+    for( unsigned long i = 0; i < iterations; i++ )
+      {
+      m_Toggle.RequestToggle();
+      }
+    }
+
+private:
+  StateMachineToggle   m_Toggle;
+};
+
+
+/** Tracker -> tool -> reference -> view graph. Every iteration sets a new
+ *  tool transform and resolves the transform from the tool to the view. */
+class CoordinateSystemResolutionBenchmark : public Benchmark
+{
+public:
+  CoordinateSystemResolutionBenchmark()
+    : Benchmark( "CoordinateSystem/ResolveToolToView", "micro", 100000 ) {}
+
+  virtual bool Setup( std::string & )
+    {
+    m_Tracker = CoordinateSystem::New();
+    m_Reference = CoordinateSystem::New();
+    m_Tool = CoordinateSystem::New();
+    m_View = CoordinateSystem::New();
+
+    Transform::VectorType translation;
+    translation[0] = 10.0;
+    translation[1] = 20.0;
+    translation[2] = -30.0;
+    Transform::VersorType rotation;
+    rotation.Set( 0.1, 0.2, 0.3, 0.927 );
+
+    m_Transform.SetTranslationAndRotation( translation, rotation, 0.1,
+                                      TimeStamp::GetLongestPossibleTime() );
+
+    m_Reference->RequestSetTransformAndParent( m_Transform, m_Tracker );
+    m_View->RequestSetTransformAndParent( m_Transform.GetInverse(),
+                                          m_Reference );
+    m_Tool->RequestSetTransformAndParent( m_Transform, m_Tracker );
+
+    m_Observer.m_Count = 0;
+    m_ObserverTag = m_Tool->GetTransformToChannel().AddMemberObserver<
+             TransformCounter, &TransformCounter::Callback >( &m_Observer );
+    return true;
+    }
+
+  virtual void Run( unsigned long iterations )
+    {
+    for( unsigned long i = 0; i < iterations; i++ )
+      {
+      m_Tool->RequestSetTransformAndParent( m_Transform, m_Tracker );
+      m_Tool->RequestComputeTransformTo( m_View );
+      }
+    }
+
+  virtual void TearDown()
+    {
+    if( m_Tool.IsNotNull() )
+      {
+      m_Tool->GetTransformToChannel().RemoveObserver( m_ObserverTag );
+      }
+    m_Tool = NULL;
+    m_View = NULL;
+    m_Reference = NULL;
+    m_Tracker = NULL;
+    }
+
+private:
+
+  struct TransformCounter
+    {
+    void Callback( const CoordinateSystemTransformToResult & )
+      {
+      m_Count++;
+      }
+    unsigned long m_Count;
+    };
+
+  CoordinateSystem::Pointer   m_Tracker;
+  CoordinateSystem::Pointer   m_Reference;
+  CoordinateSystem::Pointer   m_Tool;
+  CoordinateSystem::Pointer   m_View;
+  Transform                   m_Transform;
+  TransformCounter            m_Observer;
+  unsigned long               m_ObserverTag;
+};
+
+
+/** Shared operands of the transform benchmarks */
+class TransformBenchmarkBase : public Benchmark
+{
+public:
+  TransformBenchmarkBase( const std::string & name,
+                          unsigned long iterations )
+    : Benchmark( name, "micro", iterations )
+    {
+    Transform::VectorType translation;
+    translation[0] = 1.0;
+    translation[1] = -2.0;
+    translation[2] = 3.0;
+    Transform::VersorType rotation;
+    Transform::VersorType::VectorType axis;
+    axis[0] = 0.3;
+    axis[1] = -0.4;
+    axis[2] = 0.5;
+    rotation.Set( axis, 0.8 );
+
+    m_Left.SetTranslationAndRotation( translation, rotation, 0.1, 1e6 );
+    m_Right = m_Left.GetInverse();
+    m_RigidLeft.ImportTransform( m_Left );
+    m_RigidRight.ImportTransform( m_Right );
+    }
+
+protected:
+  Transform        m_Left;
+  Transform        m_Right;
+  RigidTransform   m_RigidLeft;
+  RigidTransform   m_RigidRight;
+};
+
+
+class TransformComposeBenchmark : public TransformBenchmarkBase
+{
+public:
+  TransformComposeBenchmark()
+    : TransformBenchmarkBase( "Transform/Compose", 1000000 ) {}
+
+  virtual void Run( unsigned long iterations )
+    {
+    Transform result = m_Right;
+    for( unsigned long i = 0; i < iterations; i++ )
+      {
+      result = Transform::TransformCompose( m_Left, result );
+      }
+    m_Right = result;
+    }
+};
+
+
+class RigidTransformComposeBenchmark : public TransformBenchmarkBase
+{
+public:
+  RigidTransformComposeBenchmark()
+    : TransformBenchmarkBase( "RigidTransform/Compose", 1000000 ) {}
+
+  virtual void Run( unsigned long iterations )
+    {
+    RigidTransform result = m_RigidRight;
+    for( unsigned long i = 0; i < iterations; i++ )
+      {
+      RigidTransform::Compose( m_RigidLeft, result, result );
+      }
+    m_RigidRight = result;
+    }
+};
+
+
+class RigidTransformPointsBenchmark : public TransformBenchmarkBase
+{
+public:
+  RigidTransformPointsBenchmark()
+    : TransformBenchmarkBase( "RigidTransform/TransformPoints", 1000 ) {}
+
+  virtual bool Setup( std::string & )
+    {
+    m_Points.resize( 3 * NumberOfPoints );
+    for( unsigned int i = 0; i < m_Points.size(); i++ )
+      {
+      m_Points[i] = 0.5f * ( i % 97 );
+      }
+    return true;
+    }
+
+  virtual void Run( unsigned long iterations )
+    {
+    for( unsigned long i = 0; i < iterations; i++ )
+      {
+      m_RigidLeft.TransformPoints( &m_Points[0], &m_Points[0],
+                                   NumberOfPoints );
+      }
+    }
+
+  virtual void TearDown()
+    {
+    m_Points.clear();
+    }
+
+  virtual double GetItemsPerIteration() const
+    {
+    return NumberOfPoints;
+    }
+
+private:
+  enum { NumberOfPoints = 10000 };
+  std::vector< float >  m_Points;
+};
+
+
+void RegisterCoreBenchmarks( BenchmarkRunner & runner )
+{
+  runner.Register( new StateMachineDispatchBenchmark );
+  runner.Register( new CoordinateSystemResolutionBenchmark );
+  runner.Register( new TransformComposeBenchmark );
+  runner.Register( new RigidTransformComposeBenchmark );
+  runner.Register( new RigidTransformPointsBenchmark );
+}
+
+} // end namespace Benchmarks
+
+} // end namespace igstk
@@ -0,0 +1,116 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerBenchmarks.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkBenchmark.h"
+
+#include "igstkSerialCommunicationSimulator.h"
+#include "igstkNDICommandInterpreter.h"
+
+#include <fstream>
+
+namespace igstk
+{
+
+namespace Benchmarks
+{
+
+/** Replays the Polaris stream captured for the NDICommandInterpreter stress
+ *  test, without the recorded device latency, and parses the TX replies. */
+class NDIReplyParsingBenchmark : public Benchmark
+{
+public:
+  NDIReplyParsingBenchmark()
+    : Benchmark( "NDICommandInterpreter/TXReplyParsing", "micro", 20000 ) {}
+
+  virtual bool Setup( std::string & reasonForSkipping )
+    {
+    if( GetDataRoot().empty() )
+      {
+      reasonForSkipping = "no data root given";
+      return false;
+      }
+
+    const std::string simulationFile = GetDataRoot() +
+      "/Input/polaris_stream_NDICommandInterpreterStress.txt";
+
+    std::ifstream stream( simulationFile.c_str() );
+    if( !stream.is_open() )
+      {
+      reasonForSkipping = "can not open " + simulationFile;
+      return false;
+      }
+    stream.close();
+
+    m_Communication = SerialCommunicationSimulator::New();
+    m_Communication->SetFileName( simulationFile.c_str() );
+    m_Communication->SetSimulateResponseTime( false );
+    m_Communication->SetPortNumber( SerialCommunication::PortNumber0 );
+    m_Communication->OpenCommunication();
+
+    m_Interpreter = NDICommandInterpreter::New();
+    m_Interpreter->SetCommunication( m_Communication );
+
+    // Same port request as the stress test, to get the handle of the tool
+    m_Interpreter->PHRQ( "********", "*", "*", "0A", "**" );
+    m_PortHandle = m_Interpreter->GetPHRQHandle();
+
+    return true;
+    }
+
+  virtual void Run( unsigned long iterations )
+    {
+    double transform[8];
+    for( unsigned long i = 0; i < iterations; i++ )
+      {
+      m_Interpreter->TX( NDICommandInterpreter::NDI_XFORMS_AND_STATUS );
+      m_Interpreter->GetTXTransform( m_PortHandle, transform );
+      m_Interpreter->GetTXPortStatus( m_PortHandle );
+      m_Interpreter->GetTXFrame( m_PortHandle );
+      }
+    }
+
+  virtual void TearDown()
+    {
+    if( m_Communication.IsNotNull() )
+      {
+      m_Communication->CloseCommunication();
+      }
+    m_Interpreter = NULL;
+    m_Communication = NULL;
+    }
+
+private:
+  SerialCommunicationSimulator::Pointer   m_Communication;
+  NDICommandInterpreter::Pointer          m_Interpreter;
+  int                                     m_PortHandle;
+};
+
+
+void RegisterTrackerBenchmarks( BenchmarkRunner & runner )
+{
+  runner.Register( new NDIReplyParsingBenchmark );
+}
+
+} // end namespace Benchmarks
+
+} // end namespace igstk
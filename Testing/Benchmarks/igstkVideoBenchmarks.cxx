@@ -0,0 +1,107 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkVideoBenchmarks.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkBenchmark.h"
+
+#include "igstkVideoFrameSpatialObject.h"
+
+#include <stdio.h>
+
+namespace igstk
+{
+
+namespace Benchmarks
+{
+
+/** Conversion of an RGB frame to the ITK and VTK images of a
+ *  VideoFrameSpatialObject, as done for every frame displayed in a view.
+ *  No VideoImagerTool is attached, so the object converts the frame buffer
+ *  it allocated in Initialize(). */
+class VideoFrameUpdateImagesBenchmark : public Benchmark
+{
+public:
+  typedef VideoFrameSpatialObject< unsigned char, 3 >  VideoFrameType;
+
+  VideoFrameUpdateImagesBenchmark( unsigned int width, unsigned int height )
+    : Benchmark( MakeName( width, height ), "micro", 200 )
+    {
+    m_Width = width;
+    m_Height = height;
+    }
+
+  virtual bool Setup( std::string & )
+    {
+    m_VideoFrame = VideoFrameType::New();
+    m_VideoFrame->SetWidth( m_Width );
+    m_VideoFrame->SetHeight( m_Height );
+    m_VideoFrame->SetPixelSizeX( 1 );
+    m_VideoFrame->SetPixelSizeY( 1 );
+    m_VideoFrame->SetNumberOfScalarComponents( 3 );
+    m_VideoFrame->Initialize();
+    return true;
+    }
+
+  virtual void Run( unsigned long iterations )
+    {
+    for( unsigned long i = 0; i < iterations; i++ )
+      {
+      m_VideoFrame->UpdateImages();
+      }
+    }
+
+  virtual void TearDown()
+    {
+    m_VideoFrame = NULL;
+    }
+
+  /** Throughput in pixels */
+  virtual double GetItemsPerIteration() const
+    {
+    return static_cast< double >( m_Width ) * m_Height;
+    }
+
+private:
+
+  static std::string MakeName( unsigned int width, unsigned int height )
+    {
+    char name[64];
+    sprintf( name, "VideoFrameSpatialObject/UpdateImages/RGB%ux%u",
+             width, height );
+    return name;
+    }
+
+  VideoFrameType::Pointer   m_VideoFrame;
+  unsigned int              m_Width;
+  unsigned int              m_Height;
+};
+
+
+void RegisterVideoBenchmarks( BenchmarkRunner & runner )
+{
+  runner.Register( new VideoFrameUpdateImagesBenchmark( 640, 480 ) );
+  runner.Register( new VideoFrameUpdateImagesBenchmark( 1920, 1080 ) );
+}
+
+} // end namespace Benchmarks
+
+} // end namespace igstk
@@ -0,0 +1,181 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkViewBenchmarks.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkBenchmark.h"
+
+#include "igstkView3D.h"
+#include "igstkViewProxyBase.h"
+#include "igstkAxesObject.h"
+#include "igstkEllipsoidObject.h"
+#include "igstkEllipsoidObjectRepresentation.h"
+
+#include "vtkRenderer.h"
+#include "vtkRenderWindow.h"
+
+#include <stdio.h>
+#include <vector>
+
+namespace igstk
+{
+
+namespace Benchmarks
+{
+
+/** Proxy giving the benchmark the access to the view that a GUI widget
+ *  has, without creating a window on the screen. */
+class OffScreenViewProxy : public ViewProxyBase
+{
+public:
+  void Connect( View * view, int width, int height )
+    {
+    this->GetRenderer( view )->GetRenderWindow()->SetOffScreenRendering( 1 );
+    this->SetRenderWindowSize( view, width, height );
+    this->InitializeInteractor( view );
+    }
+
+  void Render( View * view )
+    {
+    this->RefreshRender( view );
+    }
+};
+
+
+/** A 3D view rendering a scene of ellipsoids that all move at every frame,
+ *  as the tools of a tracker do. Each iteration sets the transforms and then
+ *  does what one pulse of the view does: update all the representations and
+ *  render the scene. */
+class ViewRefreshRenderBenchmark : public Benchmark
+{
+public:
+  ViewRefreshRenderBenchmark( unsigned int numberOfObjects )
+    : Benchmark( MakeName( numberOfObjects ), "scenario", 100 )
+    {
+    m_NumberOfObjects = numberOfObjects;
+    }
+
+  virtual bool Setup( std::string & )
+    {
+    m_WorldReference = AxesObject::New();
+
+    Transform identity;
+    identity.SetToIdentity( TimeStamp::GetLongestPossibleTime() );
+
+    m_View = View3D::New();
+    m_View->RequestSetTransformAndParent( identity, m_WorldReference );
+
+    m_Objects.resize( m_NumberOfObjects );
+    m_Representations.resize( m_NumberOfObjects );
+    for( unsigned int i = 0; i < m_NumberOfObjects; i++ )
+      {
+      m_Objects[i] = EllipsoidObject::New();
+      m_Objects[i]->SetRadius( 5.0, 5.0, 5.0 );
+
+      m_Representations[i] = EllipsoidObjectRepresentation::New();
+      m_Representations[i]->RequestSetEllipsoidObject( m_Objects[i] );
+      m_Representations[i]->SetColor( 0.0, 1.0, 0.0 );
+
+      m_Objects[i]->RequestSetTransformAndParent( this->GetTransform( i, 0 ),
+                                                  m_WorldReference );
+      m_View->RequestAddObject( m_Representations[i] );
+      }
+
+    m_Proxy.Connect( m_View, 320, 240 );
+    m_View->RequestResetCamera();
+    m_Frame = 0;
+
+    return true;
+    }
+
+  virtual void Run( unsigned long iterations )
+    {
+    for( unsigned long i = 0; i < iterations; i++ )
+      {
+      m_Frame++;
+      for( unsigned int j = 0; j < m_NumberOfObjects; j++ )
+        {
+        m_Objects[j]->RequestSetTransformAndParent(
+                         this->GetTransform( j, m_Frame ), m_WorldReference );
+        }
+      m_Proxy.Render( m_View );
+      }
+    }
+
+  virtual void TearDown()
+    {
+    m_View = NULL;
+    m_Representations.clear();
+    m_Objects.clear();
+    m_WorldReference = NULL;
+    }
+
+  /** Throughput in objects rendered */
+  virtual double GetItemsPerIteration() const
+    {
+    return m_NumberOfObjects;
+    }
+
+private:
+
+  static std::string MakeName( unsigned int numberOfObjects )
+    {
+    char name[64];
+    sprintf( name, "View3D/RefreshRender/%uObjects", numberOfObjects );
+    return name;
+    }
+
+  /** Objects on a grid, shifted a little at every frame */
+  static Transform GetTransform( unsigned int object, unsigned long frame )
+    {
+    Transform::VectorType translation;
+    translation[0] = 20.0 * ( object % 10 ) + 0.1 * ( frame % 100 );
+    translation[1] = 20.0 * ( object / 10 );
+    translation[2] = 0.0;
+    Transform::VersorType rotation;
+    rotation.SetIdentity();
+
+    Transform transform;
+    transform.SetTranslationAndRotation( translation, rotation, 0.1,
+                                         TimeStamp::GetLongestPossibleTime() );
+    return transform;
+    }
+
+  unsigned int                                      m_NumberOfObjects;
+  unsigned long                                     m_Frame;
+  AxesObject::Pointer                               m_WorldReference;
+  View3D::Pointer                                   m_View;
+  OffScreenViewProxy                                m_Proxy;
+  std::vector< EllipsoidObject::Pointer >           m_Objects;
+  std::vector< EllipsoidObjectRepresentation::Pointer >
+                                                    m_Representations;
+};
+
+
+void RegisterViewBenchmarks( BenchmarkRunner & runner )
+{
+  runner.Register( new ViewRefreshRenderBenchmark( 10 ) );
+  runner.Register( new ViewRefreshRenderBenchmark( 100 ) );
+}
+
+} // end namespace Benchmarks
+
+} // end namespace igstk
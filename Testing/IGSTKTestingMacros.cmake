@@ -166,6 +166,37 @@ ADD_TEST( igstkPivotCalibrationAlgorithmTest ${IGSTK_TESTS} igstkPivotCalibratio
 
 ADD_TEST( igstkPETImageSpatialObjectTest ${IGSTK_TESTS} igstkPETImageSpatialObjectTest)
 ADD_TEST( igstkPETImageSpatialObjectRepresentationTest ${IGSTK_TESTS} igstkPETImageSpatialObjectRepresentationTest)
+ADD_TEST(igstkImageResliceEngineTest ${IGSTK_TESTS} igstkImageResliceEngineTest)
+ADD_TEST(igstkObliqueResliceKernelTest ${IGSTK_TESTS} igstkObliqueResliceKernelTest)
+ADD_TEST(igstkEventChannelTest ${IGSTK_TESTS} igstkEventChannelTest)
+ADD_TEST(igstkRigidTransformTest ${IGSTK_TESTS} igstkRigidTransformTest)
+ADD_TEST(igstkTrackerAggregatorTest ${IGSTK_TESTS} igstkTrackerAggregatorTest)
+ADD_TEST(igstkTrackerAggregatorLatencyTest ${IGSTK_TESTS} igstkTrackerAggregatorLatencyTest)
+ADD_TEST(igstkTrackerToolPredictorTest ${IGSTK_TESTS} igstkTrackerToolPredictorTest)
+ADD_TEST(igstkTrackerToolFilterTest ${IGSTK_TESTS} igstkTrackerToolFilterTest)
+ADD_TEST(igstkTrackerRecorderTest ${IGSTK_TESTS} igstkTrackerRecorderTest
+              ${IGSTK_TEST_OUTPUT_DIR}/igstkTrackerRecorderTest.trk)
+ADD_TEST(igstkColorMappedSliceCacheTest ${IGSTK_TESTS} igstkColorMappedSliceCacheTest)
+ADD_TEST(igstkSliceColorMapperTest ${IGSTK_TESTS} igstkSliceColorMapperTest)
+ADD_TEST(igstkDeviceFrameClockTest ${IGSTK_TESTS} igstkDeviceFrameClockTest)
+ADD_TEST(igstkThreadPolicyTest ${IGSTK_TESTS} igstkThreadPolicyTest)
+ADD_TEST(igstkCommunicationReactorTest ${IGSTK_TESTS} igstkCommunicationReactorTest)
+ADD_TEST(igstkSceneSnapshotTest ${IGSTK_TESTS} igstkSceneSnapshotTest)
+ADD_TEST(igstkAscensionCommandInterpreterStreamTest ${IGSTK_TESTS} igstkAscensionCommandInterpreterStreamTest
+         ${IGSTK_TEST_OUTPUT_DIR})
+
+# The offscreen tests render without a display, which VTK only supports when
+# it is built with OSMesa or offscreen rendering.
+IF(VTK_OPENGL_HAS_OSMESA OR VTK_USE_OFFSCREEN)
+  SET(IGSTK_TEST_OFFSCREEN_RENDERING ON)
+ELSE(VTK_OPENGL_HAS_OSMESA OR VTK_USE_OFFSCREEN)
+  SET(IGSTK_TEST_OFFSCREEN_RENDERING OFF)
+ENDIF(VTK_OPENGL_HAS_OSMESA OR VTK_USE_OFFSCREEN)
+
+IF(IGSTK_TEST_OFFSCREEN_RENDERING)
+  ADD_TEST(igstkOffscreenWidgetTest ${IGSTK_TESTS} igstkOffscreenWidgetTest)
+  ADD_TEST(igstkFrameSchedulerTest ${IGSTK_TESTS} igstkFrameSchedulerTest)
+ENDIF(IGSTK_TEST_OFFSCREEN_RENDERING)
 
 #-----------------------------------------------------------------------------
 # Simulation test
@@ -262,6 +293,10 @@ igstkSerialCommunicationSimulatorTest ${IGSTK_TEST_OUTPUT_DIR}
           igstkReslicerPlaneSpatialObjectTest
           ${IGSTK_DATA_ROOT}/Input/E000192
         )
+  ADD_TEST( igstkImageResliceEngineRepresentationTest ${IGSTK_TESTS}
+          igstkImageResliceEngineRepresentationTest
+          ${IGSTK_DATA_ROOT}/Input/E000192
+        )
 
   ADD_TEST( igstkPETImageReaderTest ${IGSTK_TESTS} igstkPETImageReaderTest
    ${IGSTK_DATA_ROOT}/Input/PET
@@ -826,6 +861,31 @@ IF(${IGSTK_USE_VideoImager})
       igstkVideoFrameRepresentationTest
       )
 
+  ADD_TEST( igstkVideoTrackingRecorderTest
+      ${IGSTK_TESTS}
+      igstkVideoTrackingRecorderTest
+      ${IGSTK_TEST_OUTPUT_DIR}/igstkVideoTrackingRecorderTest
+      )
+
+  ADD_TEST( igstkUSVolumeReconstructorTest
+      ${IGSTK_TESTS}
+      igstkUSVolumeReconstructorTest
+      )
+
+  ADD_TEST( igstkVideoTemporalCalibrationTest
+      ${IGSTK_TESTS}
+      igstkVideoTemporalCalibrationTest
+      )
+
+  IF(IGSTK_TEST_OFFSCREEN_RENDERING)
+    ADD_TEST( igstkViewRecorderTest
+        ${IGSTK_TESTS}
+        igstkViewRecorderTest
+        ${IGSTK_TEST_OUTPUT_DIR}/igstkViewRecorderTest
+        ${IGSTK_TEST_OUTPUT_DIR}/igstkViewRecorderTest.png
+        )
+  ENDIF(IGSTK_TEST_OFFSCREEN_RENDERING)
+
 ENDIF(${IGSTK_USE_VideoImager})
  
 
@@ -884,6 +944,25 @@ SET(BasicTests_SRCS
   
   igstkPETImageSpatialObjectTest.cxx
   igstkPETImageSpatialObjectRepresentationTest.cxx
+  igstkImageResliceEngineTest.cxx
+  igstkImageResliceEngineRepresentationTest.cxx
+  igstkObliqueResliceKernelTest.cxx
+  igstkEventChannelTest.cxx
+  igstkRigidTransformTest.cxx
+  igstkTrackerAggregatorTest.cxx
+  igstkTrackerAggregatorLatencyTest.cxx
+  igstkTrackerToolPredictorTest.cxx
+  igstkTrackerToolFilterTest.cxx
+  igstkTrackerRecorderTest.cxx
+  igstkColorMappedSliceCacheTest.cxx
+  igstkSliceColorMapperTest.cxx
+  igstkDeviceFrameClockTest.cxx
+  igstkThreadPolicyTest.cxx
+  igstkCommunicationReactorTest.cxx
+  igstkSceneSnapshotTest.cxx
+  igstkOffscreenWidgetTest.cxx
+  igstkFrameSchedulerTest.cxx
+  igstkAscensionCommandInterpreterStreamTest.cxx
 
   )  
 #-----------------------------------------------------------------------------
@@ -1118,6 +1197,22 @@ IF(${IGSTK_USE_VideoImager})
       ${BasicTests_SRCS}
       igstkVideoFrameRepresentationTest.cxx
       )
+    SET(BasicTests_SRCS
+      ${BasicTests_SRCS}
+      igstkVideoTrackingRecorderTest.cxx
+      )
+    SET(BasicTests_SRCS
+      ${BasicTests_SRCS}
+      igstkUSVolumeReconstructorTest.cxx
+      )
+    SET(BasicTests_SRCS
+      ${BasicTests_SRCS}
+      igstkVideoTemporalCalibrationTest.cxx
+      )
+    SET(BasicTests_SRCS
+      ${BasicTests_SRCS}
+      igstkViewRecorderTest.cxx
+      )
 ENDIF(${IGSTK_USE_VideoImager})
  
 IF(${SANDBOX_BUILD})
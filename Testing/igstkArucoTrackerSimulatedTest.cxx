@@ -190,7 +190,21 @@ int igstkArucoTrackerSimulatedTest( int argc, char * argv[] )
       }
     }
   }
-  
+
+  // the frames go through the capture and detection stages, and the
+  // first detection searches the whole frame
+  std::cout << "Captured frames: " << tracker->GetNumberOfCapturedFrames()
+            << " dropped: " << tracker->GetNumberOfDroppedFrames()
+            << " processed: " << tracker->GetNumberOfProcessedFrames()
+            << " full frame searches: "
+            << tracker->GetNumberOfFullFrameSearches() << std::endl;
+  if( tracker->GetNumberOfProcessedFrames() == 0 ||
+      tracker->GetNumberOfFullFrameSearches() == 0 )
+  {
+    std::cerr << "No frame was processed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
   std::cout << "RequestStopTracking()" << std::endl;
   tracker->RequestStopTracking();
 
@@ -0,0 +1,158 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkAscensionCommandInterpreterStreamTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+//  in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <iostream>
+#include <fstream>
+#include <math.h>
+
+#include "igstkRealTimeClock.h"
+#include "igstkBinaryData.h"
+#include "igstkSerialCommunicationSimulator.h"
+#include "igstkAscensionCommandInterpreter.h"
+
+namespace AscensionCommandInterpreterStreamTest
+{
+
+/** Position and quaternion record of a single bird, with the x position
+ *  given as a raw word. The first byte carries the phasing bit. */
+void MakeRecord( unsigned char record[14], int x )
+{
+  const int words[7] = { x, 0, 0, 0x7ffc, 0, 0, 0 };
+  for( unsigned int i = 0; i < 7; i++ )
+    {
+    record[2*i] = ( words[i] >> 2 ) & 0x7f;
+    record[2*i+1] = ( words[i] >> 9 ) & 0x7f;
+    }
+  record[0] |= 0x80;
+}
+
+/** Write the bytes received after the stream command, in the format of
+ *  the files captured by SerialCommunication */
+void WriteReceived( std::ofstream & file, const unsigned char * data,
+                    unsigned int size )
+{
+  std::string encoded;
+  igstk::BinaryData::Encode( encoded, data, size );
+  file << "0.0 : (INFO) 1. receive[" << size << "] " << encoded << "\n";
+}
+
+}
+
+int igstkAscensionCommandInterpreterStreamTest( int argc, char * argv[] )
+{
+  using AscensionCommandInterpreterStreamTest::MakeRecord;
+  using AscensionCommandInterpreterStreamTest::WriteReceived;
+
+  igstk::RealTimeClock::Initialize();
+
+  if( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " Test_Output_Directory"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A stream with a complete record, a record cut short by the next one
+  // which arrives in two parts, a few bytes out of phase, and a last record
+  unsigned char first[14];
+  unsigned char cut[14];
+  unsigned char split[14];
+  unsigned char last[14];
+  MakeRecord( first, 0x0400 );
+  MakeRecord( cut, 0x0c00 );
+  MakeRecord( split, 0x0800 );
+  MakeRecord( last, 0x1000 );
+  const unsigned char noise[3] = { 0x12, 0x34, 0x56 };
+
+  std::string filename = argv[1];
+  filename += "/igstkAscensionCommandInterpreterStreamTest.txt";
+  std::ofstream file( filename.c_str() );
+  file << "0.0 : (INFO) 1. command[1] @\n";
+  WriteReceived( file, first, 14 );
+  WriteReceived( file, cut, 6 );
+  WriteReceived( file, split, 8 );
+  WriteReceived( file, split + 8, 6 );
+  WriteReceived( file, noise, 3 );
+  WriteReceived( file, last, 14 );
+  file.close();
+
+  igstk::SerialCommunicationSimulator::Pointer serialComm =
+    igstk::SerialCommunicationSimulator::New();
+  serialComm->SetFileName( filename.c_str() );
+  serialComm->SetSimulateResponseTime( false );
+  serialComm->OpenCommunication();
+
+  igstk::AscensionCommandInterpreter::Pointer interpreter =
+    igstk::AscensionCommandInterpreter::New();
+  interpreter->SetCommunication( serialComm );
+  interpreter->Stream();
+
+  // The records that UpdateStream() must complete, in x millimeters
+  const bool complete[6] = { true, false, false, true, false, true };
+  const float expected[6] = { 28.575f, 0.0f, 0.0f, 57.15f, 0.0f, 114.3f };
+
+  int result = EXIT_SUCCESS;
+  double previousTimeStamp = 0.0;
+  for( unsigned int i = 0; i < 6; i++ )
+    {
+    const bool updated = interpreter->UpdateStream();
+    interpreter->GetError();
+    if( updated != complete[i] )
+      {
+      std::cerr << "Read " << i << ": record completed " << updated
+                << " instead of " << complete[i] << std::endl;
+      result = EXIT_FAILURE;
+      continue;
+      }
+    if( !updated )
+      {
+      continue;
+      }
+
+    float xyz[3];
+    interpreter->GetPosition( xyz );
+    std::cout << "Bird " << interpreter->GetBird() << " position ("
+              << xyz[0] << "," << xyz[1] << "," << xyz[2] << ") at "
+              << interpreter->GetRecordTimeStamp() << std::endl;
+    if( fabs( xyz[0] - expected[i] ) > 1e-3 ||
+        interpreter->GetBird() != 1 ||
+        interpreter->GetRecordTimeStamp() < previousTimeStamp )
+      {
+      std::cerr << "Wrong record after read " << i << std::endl;
+      result = EXIT_FAILURE;
+      }
+    previousTimeStamp = interpreter->GetRecordTimeStamp();
+    }
+
+  // the cut record and the noise were discarded
+  if( interpreter->GetNumberOfPhaseErrors() != 2 )
+    {
+    std::cerr << "Expected 2 phase errors, got "
+              << interpreter->GetNumberOfPhaseErrors() << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  interpreter->EndStream();
+  serialComm->CloseCommunication();
+
+  return result;
+}
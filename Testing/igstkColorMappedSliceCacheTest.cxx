@@ -0,0 +1,98 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkColorMappedSliceCacheTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+//  in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <iostream>
+
+#include "igstkColorMappedSliceCache.h"
+
+#include "vtkImageData.h"
+
+int igstkColorMappedSliceCacheTest( int, char * [] )
+{
+  typedef igstk::ColorMappedSliceCache    CacheType;
+
+  int result = EXIT_SUCCESS;
+
+  vtkImageData * image = vtkImageData::New();
+  image->SetDimensions( 16, 16, 8 );
+  image->SetScalarTypeToShort();
+  image->SetNumberOfScalarComponents( 1 );
+  image->AllocateScalars();
+
+  // Two representations showing the same axial slice
+  CacheType::KeyType axial;
+  axial.m_Image = image;
+  axial.m_Extent[1] = 15;
+  axial.m_Extent[3] = 15;
+  axial.m_Extent[4] = 3;
+  axial.m_Extent[5] = 3;
+  axial.m_Window = 400.0;
+  axial.m_Level = 40.0;
+  axial.m_Value = 1.0;
+  axial.m_Opacity = 1.0;
+
+  vtkImageData * first = CacheType::Acquire( axial );
+  vtkImageData * second = CacheType::Acquire( axial );
+  if( !first || first != second || CacheType::GetNumberOfSlices() != 1 )
+    {
+    std::cerr << "The slice is not shared" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // A different window gets its own slice
+  CacheType::KeyType windowed = axial;
+  windowed.m_Window = 2000.0;
+  vtkImageData * third = CacheType::Acquire( windowed );
+  if( third == first || CacheType::GetNumberOfSlices() != 2 )
+    {
+    std::cerr << "Different windows share a slice" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  CacheType::Print( std::cout );
+
+  CacheType::Release( windowed );
+  CacheType::Release( axial );
+  if( CacheType::GetNumberOfSlices() != 1 )
+    {
+    std::cerr << "A slice in use was released" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  CacheType::Release( axial );
+  if( CacheType::GetNumberOfSlices() != 0 )
+    {
+    std::cerr << "An unused slice was kept" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  CacheType::KeyType empty;
+  if( CacheType::Acquire( empty ) != NULL )
+    {
+    std::cerr << "A slice was made without an image" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  image->Delete();
+
+  return result;
+}
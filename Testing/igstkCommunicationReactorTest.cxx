@@ -0,0 +1,274 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkCommunicationReactorTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+//  in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+#include "itkMutexLock.h"
+
+#include "igstkCommunicationReactor.h"
+#include "igstkPulseGenerator.h"
+
+#if !defined(WIN32) && !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace CommunicationReactorTest
+{
+
+/** Communication reading from the read end of a pipe */
+class PipeCommunication : public igstk::Communication
+{
+public:
+
+  igstkStandardClassTraitsMacro( PipeCommunication, igstk::Communication )
+
+  int Descriptor;
+
+  virtual int GetReactorDescriptor( void ) const
+    {
+    return this->Descriptor;
+    }
+
+  virtual ResultType Read( char * data, unsigned int numberOfBytes,
+                           unsigned int & bytesRead )
+    {
+    if( this->GetReactorMode() )
+      {
+      return this->ReadFromReactor( data, numberOfBytes, bytesRead );
+      }
+    bytesRead = 0;
+    return FAILURE;
+    }
+
+protected:
+
+  PipeCommunication():m_StateMachine(this)
+    {
+    this->Descriptor = -1;
+    }
+};
+
+/** Handler reading the replies one at a time. Like a device Read(), a
+ *  read that times out returns the bytes received so far, which are
+ *  kept until the rest of the reply arrives. */
+class Handler : public igstk::CommunicationReactor::ReplyHandler
+{
+public:
+  std::vector< std::string >    Replies;
+  std::string                   Pending;
+  unsigned int                  ReplySize;
+  itk::SimpleMutexLock          Lock;
+
+  virtual void ProcessReply( igstk::Communication * communication )
+    {
+    char data[64];
+    unsigned int bytesRead = 0;
+    const igstk::Communication::ResultType result =
+      communication->Read( data, this->ReplySize - this->Pending.size(),
+                           bytesRead );
+    this->Pending.append( data, bytesRead );
+    if( result == igstk::Communication::SUCCESS )
+      {
+      this->Lock.Lock();
+      this->Replies.push_back( this->Pending );
+      this->Lock.Unlock();
+      this->Pending.clear();
+      }
+    }
+
+  unsigned int GetNumberOfReplies()
+    {
+    this->Lock.Lock();
+    const unsigned int n = static_cast< unsigned int >( this->Replies.size() );
+    this->Lock.Unlock();
+    return n;
+    }
+};
+
+bool WaitForReplies( Handler & handler, unsigned int n )
+{
+  for( unsigned int i = 0; i < 200 && handler.GetNumberOfReplies() < n; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 10 );
+    }
+  return ( handler.GetNumberOfReplies() == n );
+}
+
+}
+
+/** Adds two pipes to a reactor: one of replies ended by a carriage
+ *  return and one of fixed size records. The data is written in pieces
+ *  that split the replies, and the handlers must receive whole replies,
+ *  in order. On Windows, the communications cannot be added. */
+int igstkCommunicationReactorTest( int, char * [] )
+{
+  using CommunicationReactorTest::PipeCommunication;
+  using CommunicationReactorTest::Handler;
+  using CommunicationReactorTest::WaitForReplies;
+
+  typedef igstk::CommunicationReactor      ReactorType;
+  typedef igstk::Communication             CommunicationType;
+
+  ReactorType::Pointer reactor = ReactorType::New();
+
+#if defined(WIN32) || defined(_WIN32)
+
+  PipeCommunication::Pointer communication = PipeCommunication::New();
+  Handler handler;
+  if( reactor->AddCommunication( communication, &handler ) !=
+      CommunicationType::FAILURE )
+    {
+    std::cerr << "A communication was added on Windows" << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+
+#else
+
+  int result = EXIT_SUCCESS;
+
+  int textPipe[2];
+  int binaryPipe[2];
+  if( pipe( textPipe ) == -1 || pipe( binaryPipe ) == -1 )
+    {
+    std::cerr << "Cannot create the pipes" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  PipeCommunication::Pointer text = PipeCommunication::New();
+  text->Descriptor = textPipe[0];
+  text->SetUseReadTerminationCharacter( true );
+  text->SetReadTerminationCharacter( '\r' );
+  Handler textHandler;
+  textHandler.ReplySize = 63;
+
+  PipeCommunication::Pointer binary = PipeCommunication::New();
+  binary->Descriptor = binaryPipe[0];
+  Handler binaryHandler;
+  binaryHandler.ReplySize = 4;
+
+  if( reactor->AddCommunication( text, &textHandler ) !=
+      CommunicationType::SUCCESS ||
+      reactor->AddCommunication( binary, &binaryHandler ) !=
+      CommunicationType::SUCCESS )
+    {
+    std::cerr << "The communications could not be added" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if( reactor->AddCommunication( text, &textHandler ) !=
+      CommunicationType::FAILURE )
+    {
+    std::cerr << "A communication was added twice" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  const char * textPieces[] = { "VER 4", ".0\rTX 1\rTX", " 2\r" };
+  const char * binaryPieces[] = { "ab", "cdefg", "h" };
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    const std::string textPiece = textPieces[i];
+    const std::string binaryPiece = binaryPieces[i];
+    if( write( textPipe[1], textPiece.c_str(), textPiece.size() ) == -1 ||
+        write( binaryPipe[1], binaryPiece.c_str(), binaryPiece.size() ) ==
+        -1 )
+      {
+      std::cerr << "Cannot write to the pipes" << std::endl;
+      return EXIT_FAILURE;
+      }
+    igstk::PulseGenerator::Sleep( 20 );
+    }
+
+  if( !WaitForReplies( textHandler, 3 ) ||
+      textHandler.Replies[0] != "VER 4.0\r" ||
+      textHandler.Replies[1] != "TX 1\r" ||
+      textHandler.Replies[2] != "TX 2\r" )
+    {
+    std::cerr << "Wrong text replies:";
+    for( unsigned int i = 0; i < textHandler.Replies.size(); i++ )
+      {
+      std::cerr << " [" << textHandler.Replies[i] << "]";
+      }
+    std::cerr << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( !WaitForReplies( binaryHandler, 2 ) ||
+      binaryHandler.Replies[0] != "abcd" ||
+      binaryHandler.Replies[1] != "efgh" )
+    {
+    std::cerr << "Wrong binary replies" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  reactor->Print( std::cout );
+
+  if( reactor->GetNumberOfBytesRead() != 26 )
+    {
+    std::cerr << "Wrong number of bytes read" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( reactor->RemoveCommunication( text ) != CommunicationType::SUCCESS ||
+      text->GetReactorMode() ||
+      reactor->RemoveCommunication( text ) != CommunicationType::FAILURE ||
+      reactor->GetNumberOfCommunications() != 1 )
+    {
+    std::cerr << "The communication was not removed" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // the data that arrives after the removal stays in the pipe
+  const char more[] = "TX 3\r";
+  if( write( textPipe[1], more, 5 ) == -1 )
+    {
+    return EXIT_FAILURE;
+    }
+  igstk::PulseGenerator::Sleep( 50 );
+  char data[8];
+  if( textHandler.GetNumberOfReplies() != 3 ||
+      read( textPipe[0], data, sizeof( data ) ) != 5 )
+    {
+    std::cerr << "The reactor read a removed communication" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // the reactor gives the remaining communication back when destroyed
+  reactor = NULL;
+  if( binary->GetReactorMode() )
+    {
+    std::cerr << "The communication is still in reactor mode" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  close( textPipe[0] );
+  close( textPipe[1] );
+  close( binaryPipe[0] );
+  close( binaryPipe[1] );
+
+  return result;
+
+#endif
+}
@@ -0,0 +1,108 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkDeviceFrameClockTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <math.h>
+#include <iostream>
+
+#include "igstkDeviceFrameClock.h"
+#include "igstkRealTimeClock.h"
+
+int igstkDeviceFrameClockTest( int, char * [] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  typedef igstk::DeviceFrameClock   ClockType;
+
+  ClockType::Pointer clock = ClockType::New();
+
+  int result = EXIT_SUCCESS;
+
+  // A 60 Hz device whose clock runs 0.1% fast, with a counter about to
+  // wrap around, and replies that arrive 5 to 12 ms after the acquisition
+  const double period = 1000.0 / 60.0 * 1.001;
+  const double start = 250000.0;
+  const unsigned long firstFrame = 0xffffff00UL;
+
+  unsigned long frame = firstFrame;
+  for( unsigned int i = 0; i < 420; i++ )
+    {
+    // every 50th frame is not received
+    frame = ( firstFrame + i ) & 0xffffffffUL;
+    if( i % 50 == 49 )
+      {
+      continue;
+      }
+    const double acquisitionTime = start + i * period;
+    const double delay = 5.0 + ( ( i * 7 ) % 8 );
+    if( clock->AddFrame( frame, acquisitionTime + delay ) !=
+        ClockType::NewFrame )
+      {
+      std::cerr << "Frame " << i << " not classified as new" << std::endl;
+      result = EXIT_FAILURE;
+      }
+    }
+
+  // the mapping follows the period of the device, and is 5 ms late
+  const double frameTime = clock->GetFrameTime( frame );
+  const double expected = start + 419 * period + 5.0;
+  std::cout << "Frame period: " << clock->GetFramePeriod()
+            << " frame time error: " << frameTime - expected << std::endl;
+  if( fabs( clock->GetFramePeriod() - period ) > 0.01 ||
+      fabs( frameTime - expected ) > 1.0 )
+    {
+    std::cerr << "Wrong mapping of the frames" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // duplicated and out of order frames do not change the mapping
+  if( clock->AddFrame( frame, start + 420 * period ) !=
+        ClockType::DuplicatedFrame ||
+      clock->AddFrame( frame - 3, start + 420 * period ) !=
+        ClockType::OutOfOrderFrame ||
+      clock->GetFrameTime( frame ) != frameTime )
+    {
+    std::cerr << "Wrong classification of old frames" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( clock->GetNumberOfDroppedFrames() != 8 ||
+      clock->GetNumberOfDuplicatedFrames() != 1 ||
+      clock->GetNumberOfOutOfOrderFrames() != 1 ||
+      clock->GetNumberOfFrames() != 414 )
+    {
+    std::cerr << "Wrong frame counters" << std::endl;
+    clock->Print( std::cerr );
+    result = EXIT_FAILURE;
+    }
+
+  clock->Reset();
+  if( clock->GetNumberOfFrames() != 0 ||
+      clock->AddFrame( 10, start ) != ClockType::NewFrame ||
+      clock->GetFrameTime( 10 ) != start )
+    {
+    std::cerr << "Reset failed" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  return result;
+}
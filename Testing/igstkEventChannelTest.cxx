@@ -0,0 +1,310 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkEventChannelTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <iostream>
+
+#include "igstkEventChannel.h"
+#include "igstkCoordinateSystem.h"
+#include "igstkCoordinateSystemTransformToResult.h"
+#include "igstkRealTimeClock.h"
+#include "itkCommand.h"
+
+namespace EventChannelTest
+{
+
+/** Receiver counting the notifications, optionally removing itself or
+ *  another observer from within the callback */
+class Counter
+{
+public:
+  typedef igstk::EventChannel< int >  ChannelType;
+
+  Counter()
+    {
+    m_Count = 0;
+    m_Sum = 0;
+    m_Channel = NULL;
+    m_TagToRemove = 0;
+    m_RemoveOnCall = false;
+    }
+
+  void Callback( const int & value )
+    {
+    m_Count++;
+    m_Sum += value;
+    if( m_RemoveOnCall )
+      {
+      m_Channel->RemoveObserver( m_TagToRemove );
+      m_RemoveOnCall = false;
+      }
+    }
+
+  unsigned int          m_Count;
+  int                   m_Sum;
+  const ChannelType *   m_Channel;
+  unsigned long         m_TagToRemove;
+  bool                  m_RemoveOnCall;
+};
+
+void FunctionCallback( void * receiver, const int & value )
+{
+  *static_cast< int * >( receiver ) += value;
+}
+
+/** Receiver of the transforms computed by a coordinate system, either
+ *  through the itk event or through the channel */
+class TransformObserver
+{
+public:
+  typedef itk::ReceptorMemberCommand< TransformObserver >  CommandType;
+
+  TransformObserver()
+    {
+    m_Count = 0;
+    }
+
+  void EventCallback( const itk::EventObject & event )
+    {
+    const igstk::CoordinateSystemTransformToEvent * transformEvent =
+      dynamic_cast< const igstk::CoordinateSystemTransformToEvent * >(
+                                                                   &event );
+    if( transformEvent )
+      {
+      m_Transform = transformEvent->Get().GetTransform();
+      m_Count++;
+      }
+    }
+
+  void ChannelCallback(
+                    const igstk::CoordinateSystemTransformToResult & result )
+    {
+    m_Transform = result.GetTransform();
+    m_Count++;
+    }
+
+  unsigned long         m_Count;
+  igstk::Transform      m_Transform;
+};
+
+}
+
+int igstkEventChannelTest( int, char * [] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  typedef EventChannelTest::Counter      CounterType;
+  typedef CounterType::ChannelType       ChannelType;
+
+  ChannelType channel;
+
+  if( channel.HasObservers() )
+    {
+    std::cerr << "A new channel has observers" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Invoking a channel without observers does nothing
+  channel.Invoke( 1 );
+
+  CounterType first;
+  CounterType second;
+  int functionSum = 0;
+
+  const unsigned long firstTag =
+    channel.AddMemberObserver< CounterType, &CounterType::Callback >( &first );
+  const unsigned long secondTag =
+    channel.AddMemberObserver< CounterType, &CounterType::Callback >( &second );
+  channel.AddObserver( &functionSum, &EventChannelTest::FunctionCallback );
+
+  channel.Invoke( 2 );
+
+  if( first.m_Sum != 2 || second.m_Sum != 2 || functionSum != 2 ||
+      channel.GetNumberOfObservers() != 3 )
+    {
+    std::cerr << "Observers were not notified" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The first observer removes the second one during the invocation
+  first.m_Channel = &channel;
+  first.m_TagToRemove = secondTag;
+  first.m_RemoveOnCall = true;
+
+  channel.Invoke( 3 );
+
+  if( second.m_Count != 1 || first.m_Count != 2 || functionSum != 5 ||
+      channel.GetNumberOfObservers() != 2 )
+    {
+    std::cerr << "Removal during the invocation failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // An observer removing itself
+  first.m_TagToRemove = firstTag;
+  first.m_RemoveOnCall = true;
+  channel.Invoke( 4 );
+  channel.Invoke( 5 );
+
+  if( first.m_Count != 3 || functionSum != 14 ||
+      channel.GetNumberOfObservers() != 1 )
+    {
+    std::cerr << "Self removal failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  channel.RemoveAllObservers();
+  channel.Invoke( 6 );
+
+  if( channel.HasObservers() || functionSum != 14 )
+    {
+    std::cerr << "RemoveAllObservers failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Tracker -> TrackerTool -> View chain of coordinate systems. At every
+  // sample the tool receives a new transform to the tracker and the view
+  // requests the transform of the tool.
+  typedef igstk::CoordinateSystem                      CoordinateSystemType;
+  typedef EventChannelTest::TransformObserver          ObserverType;
+
+  CoordinateSystemType::Pointer tracker = CoordinateSystemType::New();
+  CoordinateSystemType::Pointer tool = CoordinateSystemType::New();
+  CoordinateSystemType::Pointer view = CoordinateSystemType::New();
+
+  igstk::Transform identity;
+  identity.SetToIdentity( igstk::TimeStamp::GetLongestPossibleTime() );
+  view->RequestSetTransformAndParent( identity, tracker );
+
+  ObserverType eventObserver;
+  ObserverType::CommandType::Pointer command =
+                                          ObserverType::CommandType::New();
+  command->SetCallbackFunction( &eventObserver,
+                                &ObserverType::EventCallback );
+
+  ObserverType channelObserver;
+
+  const unsigned int numberOfSamples = 100000;
+
+  igstk::Transform::VectorType translation;
+  igstk::Transform::VersorType rotation;
+  rotation.SetIdentity();
+
+  for( unsigned int useChannel = 0; useChannel < 2; useChannel++ )
+    {
+    unsigned long observerTag;
+    if( useChannel )
+      {
+      observerTag = tool->GetTransformToChannel().AddMemberObserver<
+        ObserverType, &ObserverType::ChannelCallback >( &channelObserver );
+      }
+    else
+      {
+      observerTag = tool->AddObserver(
+                          igstk::CoordinateSystemTransformToEvent(), command );
+      }
+
+    const double start = igstk::RealTimeClock::GetTimeStamp();
+
+    for( unsigned int i = 0; i < numberOfSamples; i++ )
+      {
+      translation[0] = i;
+      translation[1] = 0.0;
+      translation[2] = 0.0;
+      igstk::Transform sample;
+      sample.SetTranslationAndRotation( translation, rotation, 0.1, 1000.0 );
+      tool->RequestSetTransformAndParent( sample, tracker );
+      tool->RequestComputeTransformTo( view );
+      }
+
+    const double elapsed = igstk::RealTimeClock::GetTimeStamp() - start;
+
+    const ObserverType & observer =
+                               useChannel ? channelObserver : eventObserver;
+
+    if( observer.m_Count != numberOfSamples ||
+        observer.m_Transform.GetTranslation()[0] != numberOfSamples - 1 )
+      {
+      std::cerr << "The transforms were not received" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    std::cout << ( useChannel ? "Channel" : "itk event" ) << " observer: "
+              << numberOfSamples / ( elapsed / 1000.0 )
+              << " samples per second" << std::endl;
+
+    if( useChannel )
+      {
+      tool->GetTransformToChannel().RemoveObserver( observerTag );
+      }
+    else
+      {
+      tool->RemoveObserver( observerTag );
+      }
+    }
+
+  // Dispatch alone, on the same payload
+  igstk::CoordinateSystemTransformToResult payload;
+  payload.Initialize( identity, tool, view );
+
+  igstk::CoordinateSystemTransformToEvent event;
+  event.Set( payload );
+
+  eventObserver.m_Count = 0;
+  channelObserver.m_Count = 0;
+
+  tool->AddObserver( igstk::CoordinateSystemTransformToEvent(), command );
+  tool->GetTransformToChannel().AddMemberObserver<
+        ObserverType, &ObserverType::ChannelCallback >( &channelObserver );
+
+  double start = igstk::RealTimeClock::GetTimeStamp();
+  for( unsigned int i = 0; i < numberOfSamples; i++ )
+    {
+    tool->InvokeEvent( event );
+    }
+  const double eventTime = igstk::RealTimeClock::GetTimeStamp() - start;
+
+  start = igstk::RealTimeClock::GetTimeStamp();
+  for( unsigned int i = 0; i < numberOfSamples; i++ )
+    {
+    tool->GetTransformToChannel().Invoke( payload );
+    }
+  const double channelTime = igstk::RealTimeClock::GetTimeStamp() - start;
+
+  if( eventObserver.m_Count != numberOfSamples ||
+      channelObserver.m_Count != numberOfSamples )
+    {
+    std::cerr << "Dispatch benchmark lost notifications" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "itk event dispatch: "
+            << numberOfSamples / ( eventTime / 1000.0 )
+            << " events per second" << std::endl;
+  std::cout << "Channel dispatch: "
+            << numberOfSamples / ( channelTime / 1000.0 )
+            << " events per second" << std::endl;
+
+  std::cout << "Test [DONE]" << std::endl;
+
+  return EXIT_SUCCESS;
+}
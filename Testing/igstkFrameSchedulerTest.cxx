@@ -0,0 +1,306 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkFrameSchedulerTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <iostream>
+
+#include "igstkEllipsoidObject.h"
+#include "igstkEllipsoidObjectRepresentation.h"
+#include "igstkView3D.h"
+#include "igstkOffscreenWidget.h"
+#include "igstkFrameScheduler.h"
+#include "igstkRealTimeClock.h"
+
+namespace FrameSchedulerTest
+{
+
+/** Transform that never expires */
+igstk::Transform GetTranslation( double x, double y, double z )
+{
+  igstk::Transform::VectorType translation;
+  translation[0] = x;
+  translation[1] = y;
+  translation[2] = z;
+
+  igstk::Transform transform;
+  transform.SetTranslation( translation, 0.1,
+                            igstk::TimeStamp::GetLongestPossibleTime() );
+  return transform;
+}
+
+/** Pulse for a while */
+void Pulse( int milliseconds )
+{
+  for( int i = 0; i < milliseconds / 10; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 10 );
+    igstk::PulseGenerator::CheckTimeouts();
+    }
+}
+
+/** Refresh the views until the transforms of a number of representations
+ *  are taken from a prepared frame */
+bool WaitForPreparedTransforms( igstk::FrameScheduler * scheduler,
+                                unsigned int numberOfTransforms )
+{
+  for( int i = 0; i < 100; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 10 );
+    scheduler->RefreshFrame();
+    if( scheduler->GetNumberOfPreparedTransforms() == numberOfTransforms )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+}
+
+/** Refresh two offscreen views showing the same object with a
+ *  FrameScheduler, and check which transforms are computed from the scene
+ *  graph and which are shared between the views. */
+int igstkFrameSchedulerTest( int, char * [] )
+{
+  typedef igstk::EllipsoidObjectRepresentation  ObjectRepresentationType;
+  typedef igstk::EllipsoidObject                ObjectType;
+  typedef igstk::View3D                         View3DType;
+  typedef igstk::OffscreenWidget                WidgetType;
+  typedef igstk::FrameScheduler                 SchedulerType;
+
+  std::cout << "Testing igstk::FrameScheduler" << std::endl;
+
+  igstk::RealTimeClock::Initialize();
+
+  View3DType::Pointer firstView = View3DType::New();
+  View3DType::Pointer secondView = View3DType::New();
+  firstView->SetRefreshRate( 50 );
+  secondView->SetRefreshRate( 50 );
+
+  WidgetType::Pointer firstWidget = WidgetType::New();
+  firstWidget->RequestSetSize( 64, 48 );
+  firstWidget->RequestSetView( firstView );
+
+  WidgetType::Pointer secondWidget = WidgetType::New();
+  secondWidget->RequestSetSize( 64, 48 );
+  secondWidget->RequestSetView( secondView );
+
+  // The object and the second view hang from the first view
+  ObjectType::Pointer ellipsoid = ObjectType::New();
+  ellipsoid->RequestSetTransformAndParent(
+    FrameSchedulerTest::GetTranslation( 5.0, 0.0, 0.0 ), firstView );
+  secondView->RequestSetTransformAndParent(
+    FrameSchedulerTest::GetTranslation( 0.0, 0.0, 100.0 ), firstView );
+
+  ObjectRepresentationType::Pointer firstRepresentation =
+                                             ObjectRepresentationType::New();
+  firstRepresentation->RequestSetEllipsoidObject( ellipsoid );
+  firstView->RequestAddObject( firstRepresentation );
+
+  ObjectRepresentationType::Pointer secondRepresentation =
+                                             ObjectRepresentationType::New();
+  secondRepresentation->RequestSetEllipsoidObject( ellipsoid );
+  secondView->RequestAddObject( secondRepresentation );
+
+  firstView->RequestResetCamera();
+  secondView->RequestResetCamera();
+  firstView->RequestStart();
+  secondView->RequestStart();
+
+  SchedulerType::Pointer scheduler = SchedulerType::New();
+  scheduler->RequestAddView( firstView );
+  scheduler->RequestAddView( secondView );
+  if( scheduler->GetNumberOfViews() != 2 )
+    {
+    std::cerr << "The views were not added" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The views do not refresh on their own pulses anymore
+  unsigned long firstFrames = firstWidget->GetNumberOfFrames();
+  unsigned long secondFrames = secondWidget->GetNumberOfFrames();
+  FrameSchedulerTest::Pulse( 100 );
+  if( firstWidget->GetNumberOfFrames() != firstFrames ||
+      secondWidget->GetNumberOfFrames() != secondFrames )
+    {
+    std::cerr << "The views refreshed on their own pulses" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // One transform of the object and one of the second view are computed,
+  // and shared by the two representations
+  scheduler->RefreshFrame();
+  if( scheduler->GetNumberOfComputedTransforms() != 2 ||
+      scheduler->GetNumberOfSharedTransforms() != 2 )
+    {
+    std::cerr << "Computed " << scheduler->GetNumberOfComputedTransforms()
+              << " and shared " << scheduler->GetNumberOfSharedTransforms()
+              << " transforms instead of 2 and 2" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( firstWidget->GetNumberOfFrames() != firstFrames + 1 ||
+      secondWidget->GetNumberOfFrames() != secondFrames + 1 )
+    {
+    std::cerr << "The views were not rendered once each" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A view that is not connected to the first view updates its
+  // representations as the View does
+  secondView->RequestDetachFromParent();
+  scheduler->RefreshFrame();
+  if( scheduler->GetNumberOfComputedTransforms() != 2 ||
+      scheduler->GetNumberOfSharedTransforms() != 1 )
+    {
+    std::cerr << "Without a connection, computed "
+              << scheduler->GetNumberOfComputedTransforms() << " and shared "
+              << scheduler->GetNumberOfSharedTransforms()
+              << " transforms instead of 2 and 1" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( secondWidget->GetNumberOfFrames() != secondFrames + 2 )
+    {
+    std::cerr << "The view without connection was not rendered"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  secondView->RequestSetTransformAndParent(
+    FrameSchedulerTest::GetTranslation( 0.0, 0.0, 100.0 ), firstView );
+
+  // Frame statistics
+  scheduler->ResetFrameStatistics();
+  if( scheduler->GetNumberOfFrames() != 0 ||
+      scheduler->GetMeanFrameTime() != 0.0 ||
+      scheduler->GetMaximumFrameTime() != 0.0 )
+    {
+    std::cerr << "The frame statistics were not reset" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const unsigned long numberOfFrames = 5;
+  for( unsigned long i = 0; i < numberOfFrames; i++ )
+    {
+    scheduler->RefreshFrame();
+    }
+  if( scheduler->GetNumberOfFrames() != numberOfFrames ||
+      scheduler->GetLastFrameTime() < 0.0 ||
+      scheduler->GetMaximumFrameTime() < scheduler->GetLastFrameTime() ||
+      scheduler->GetMaximumFrameTime() < scheduler->GetMeanFrameTime() ||
+      scheduler->GetMaximumFrameTime() <= 0.0 )
+    {
+    std::cerr << "Wrong frame statistics" << std::endl;
+    scheduler->Print( std::cerr );
+    return EXIT_FAILURE;
+    }
+
+  // The frames follow the pulses of the scheduler
+  scheduler->SetRefreshRate( 50 );
+  scheduler->RequestStart();
+  FrameSchedulerTest::Pulse( 200 );
+  scheduler->RequestStop();
+  if( scheduler->GetNumberOfFrames() <= numberOfFrames )
+    {
+    std::cerr << "The scheduler did not refresh on its pulses" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Mean frame time: " << scheduler->GetMeanFrameTime()
+            << " ms, maximum: " << scheduler->GetMaximumFrameTime() << " ms"
+            << std::endl;
+
+  // With the threaded preparation, the transforms of both representations
+  // come from the frame prepared from the latest snapshot
+  scheduler->SetThreadedFramePreparation( true );
+  if( !FrameSchedulerTest::WaitForPreparedTransforms( scheduler, 2 ) ||
+      scheduler->GetNumberOfSharedTransforms() != 0 )
+    {
+    std::cerr << "The prepared transforms were not used" << std::endl;
+    scheduler->Print( std::cerr );
+    return EXIT_FAILURE;
+    }
+
+  // Once the object moved, the frame prepared before is not used
+  ellipsoid->RequestSetTransformAndParent(
+    FrameSchedulerTest::GetTranslation( 7.0, 0.0, 0.0 ), firstView );
+  scheduler->RefreshFrame();
+  if( scheduler->GetNumberOfPreparedTransforms() != 0 ||
+      scheduler->GetNumberOfSharedTransforms() != 2 )
+    {
+    std::cerr << "A frame prepared before the object moved was used"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( !FrameSchedulerTest::WaitForPreparedTransforms( scheduler, 2 ) )
+    {
+    std::cerr << "The moved object was not prepared" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Nor once a representation moved to another view
+  secondView->RequestRemoveObject( secondRepresentation );
+  firstView->RequestAddObject( secondRepresentation );
+  scheduler->RefreshFrame();
+  if( scheduler->GetNumberOfPreparedTransforms() != 0 ||
+      scheduler->GetNumberOfSharedTransforms() != 2 )
+    {
+    std::cerr << "A frame prepared for another view was used" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( !FrameSchedulerTest::WaitForPreparedTransforms( scheduler, 2 ) )
+    {
+    std::cerr << "The moved representation was not prepared" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Prepared frames: " << scheduler->GetNumberOfPreparedFrames()
+            << ", last preparation time: "
+            << scheduler->GetLastPreparationTime() << " ms" << std::endl;
+
+  scheduler->SetThreadedFramePreparation( false );
+  scheduler->RefreshFrame();
+  if( scheduler->GetNumberOfPreparedTransforms() != 0 )
+    {
+    std::cerr << "Prepared transforms were used without the preparation"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A removed view refreshes on its own pulses again
+  scheduler->RequestRemoveView( secondView );
+  secondFrames = secondWidget->GetNumberOfFrames();
+  FrameSchedulerTest::Pulse( 200 );
+  if( scheduler->GetNumberOfViews() != 1 ||
+      secondWidget->GetNumberOfFrames() == secondFrames )
+    {
+    std::cerr << "The removed view did not refresh on its own" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  firstView->RequestStop();
+  secondView->RequestStop();
+
+  scheduler->Print( std::cout );
+
+  std::cout << "[PASSED]" << std::endl;
+
+  return EXIT_SUCCESS;
+}
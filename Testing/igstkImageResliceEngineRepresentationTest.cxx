@@ -0,0 +1,220 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkImageResliceEngineRepresentationTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+//  in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <math.h>
+
+#include "igstkImageResliceObjectRepresentation.h"
+#include "igstkReslicerPlaneSpatialObject.h"
+#include "igstkCTImageReader.h"
+#include "igstkAxesObject.h"
+#include "igstkEvents.h"
+
+#include "vtkProp3D.h"
+#include "vtkMatrix4x4.h"
+
+namespace ImageResliceEngineRepresentationTest
+{
+igstkObserverObjectMacro(CTImage,
+    ::igstk::CTImageReader::ImageModifiedEvent,::igstk::CTImageSpatialObject)
+
+/** Copy the matrix of the slice actor */
+bool GetSliceMatrix( igstk::ObjectRepresentation * representation,
+                     vtkMatrix4x4 * matrix )
+{
+  igstk::ObjectRepresentation::ActorsListType actors =
+    representation->GetActors();
+  if( actors.size() != 1 )
+    {
+    std::cerr << "Expected one actor, found " << actors.size() << std::endl;
+    return false;
+    }
+  matrix->DeepCopy( vtkProp3D::SafeDownCast( actors.front() )->GetMatrix() );
+  return true;
+}
+
+/** Check that b is the matrix a translated by t */
+bool IsTranslated( vtkMatrix4x4 * a, vtkMatrix4x4 * b, const double t[3] )
+{
+  const double tolerance = 1e-6;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    for( unsigned int j = 0; j < 4; j++ )
+      {
+      const double expected = a->GetElement( i, j ) + ( j == 3 ? t[i] : 0.0 );
+      if( fabs( b->GetElement( i, j ) - expected ) > tolerance )
+        {
+        std::cerr << "Wrong element (" << i << "," << j << "): "
+                  << b->GetElement( i, j ) << " instead of " << expected
+                  << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+}
+
+/** The slice computed by the reslice engine must move with the image
+ *  spatial object, whether the slice comes from the cache or not. */
+int igstkImageResliceEngineRepresentationTest( int argc, char * argv [] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  if( argc < 2 )
+    {
+    std::cerr << " Missing arguments: " << argv[0]
+              << "\t Input image" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef igstk::CTImageReader                              ReaderType;
+  typedef igstk::CTImageSpatialObject                       ImageType;
+  typedef igstk::ReslicerPlaneSpatialObject                 ReslicerPlaneType;
+  typedef igstk::ImageResliceObjectRepresentation< ImageType >
+                                                        RepresentationType;
+
+  ReaderType::Pointer reader = ReaderType::New();
+  ImageResliceEngineRepresentationTest::CTImageObserver::Pointer
+    imageObserver =
+      ImageResliceEngineRepresentationTest::CTImageObserver::New();
+  reader->AddObserver( ReaderType::ImageModifiedEvent(), imageObserver );
+
+  reader->RequestSetDirectory( argv[1] );
+  reader->RequestReadImage();
+  reader->RequestGetImage();
+
+  if( !imageObserver->GotCTImage() )
+    {
+    std::cerr << "No CTImage!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  ImageType::Pointer image = imageObserver->GetCTImage();
+
+  igstk::AxesObject::Pointer world = igstk::AxesObject::New();
+
+  igstk::Transform identity;
+  identity.SetToIdentity( igstk::TimeStamp::GetLongestPossibleTime() );
+  image->RequestSetTransformAndParent( identity, world );
+
+  // Without a tool, the plane stays at the center of the image
+  ReslicerPlaneType::Pointer plane = ReslicerPlaneType::New();
+  plane->RequestSetReslicingMode( ReslicerPlaneType::Orthogonal );
+  plane->RequestSetOrientationType( ReslicerPlaneType::Axial );
+  plane->RequestSetBoundingBoxProviderSpatialObject( image );
+
+  RepresentationType::Pointer representation = RepresentationType::New();
+  representation->SetUseResliceEngine( true );
+  representation->RequestSetImageSpatialObject( image );
+  representation->RequestSetReslicePlaneSpatialObject( plane );
+
+  igstk::ObjectRepresentation * baseRepresentation =
+                                                representation.GetPointer();
+  baseRepresentation->CreateActors();
+
+  if( !representation->GetUseResliceEngine() )
+    {
+    std::cerr << "The image is not supported by the engine" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const igstk::CoordinateSystem * worldCoordinateSystem =
+    igstk::Friends::CoordinateSystemHelper::GetCoordinateSystem(
+                                                         world.GetPointer() );
+
+  igstk::TimeStamp renderTime;
+  vtkMatrix4x4 * initialMatrix = vtkMatrix4x4::New();
+  vtkMatrix4x4 * movedMatrix = vtkMatrix4x4::New();
+  int result = EXIT_SUCCESS;
+
+  renderTime.SetStartTimeNowAndExpireAfter( 100 );
+  representation->RequestUpdateRepresentation( renderTime,
+                                               worldCoordinateSystem );
+  if( !ImageResliceEngineRepresentationTest::GetSliceMatrix(
+                                        baseRepresentation, initialMatrix ) )
+    {
+    result = EXIT_FAILURE;
+    }
+
+  // Move the image. The plane does not move in the image, so the slice
+  // comes from the cache, and must follow the image.
+  const double translation[3] = { 10.0, -20.0, 30.0 };
+  igstk::Transform::VectorType translationVector;
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    translationVector[i] = translation[i];
+    }
+  igstk::Transform moved;
+  moved.SetTranslation( translationVector, 0.1,
+                        igstk::TimeStamp::GetLongestPossibleTime() );
+  image->RequestSetTransformAndParent( moved, world );
+
+  const unsigned long cacheHits =
+    representation->GetResliceEngine()->GetNumberOfCacheHits();
+  renderTime.SetStartTimeNowAndExpireAfter( 100 );
+  representation->RequestUpdateRepresentation( renderTime,
+                                               worldCoordinateSystem );
+
+  if( representation->GetResliceEngine()->GetNumberOfCacheHits() ==
+      cacheHits )
+    {
+    std::cerr << "The slice did not come from the cache" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( result == EXIT_SUCCESS &&
+      ( !ImageResliceEngineRepresentationTest::GetSliceMatrix(
+                                          baseRepresentation, movedMatrix ) ||
+        !ImageResliceEngineRepresentationTest::IsTranslated(
+                                initialMatrix, movedMatrix, translation ) ) )
+    {
+    std::cerr << "The cached slice did not follow the image" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // Compute the same slice again, it must be placed the same way
+  representation->GetResliceEngine()->FlushCache();
+  renderTime.SetStartTimeNowAndExpireAfter( 100 );
+  representation->RequestUpdateRepresentation( renderTime,
+                                               worldCoordinateSystem );
+
+  if( result == EXIT_SUCCESS &&
+      ( !ImageResliceEngineRepresentationTest::GetSliceMatrix(
+                                          baseRepresentation, movedMatrix ) ||
+        !ImageResliceEngineRepresentationTest::IsTranslated(
+                                initialMatrix, movedMatrix, translation ) ) )
+    {
+    std::cerr << "The computed slice did not follow the image" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  initialMatrix->Delete();
+  movedMatrix->Delete();
+
+  if( result == EXIT_SUCCESS )
+    {
+    std::cout << "[PASSED]" << std::endl;
+    }
+  return result;
+}
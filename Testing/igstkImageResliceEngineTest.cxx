@@ -0,0 +1,302 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkImageResliceEngineTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+//  in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+#include "igstkImageResliceEngine.h"
+#include "igstkRealTimeClock.h"
+#include "igstkPulseGenerator.h"
+
+#include "vtkType.h"
+
+namespace ImageResliceEngineTest
+{
+
+/** Intensity of the synthetic volume. Trilinear interpolation is exact on
+ *  a linear ramp, which makes the expected values easy to compute. */
+double Ramp( double x, double y, double z )
+{
+  return 2.0 * x + 3.0 * y + 5.0 * z + 7.0;
+}
+
+/** Compare every pixel of a slice, located inside the volume, with the
+ *  ramp. Returns the number of pixels compared, or -1 on error. */
+int CheckSlice( const igstk::ImageResliceEngine::Slice * slice,
+                const double extent[3] )
+{
+  int numberOfPixels = 0;
+  for( unsigned int j = 0; j < slice->m_Size[1]; j++ )
+    {
+    for( unsigned int i = 0; i < slice->m_Size[0]; i++ )
+      {
+      double p[3];
+      bool inside = true;
+      for( unsigned int d = 0; d < 3; d++ )
+        {
+        p[d] = slice->m_Origin[d] +
+               i * slice->m_Spacing[0] * slice->m_Axis1[d] +
+               j * slice->m_Spacing[1] * slice->m_Axis2[d];
+        // Stay away from the border to avoid rounding issues
+        inside = inside && p[d] > 0.01 && p[d] < extent[d] - 0.01;
+        }
+      if( !inside )
+        {
+        continue;
+        }
+      const float value = slice->m_Buffer[ j * slice->m_Size[0] + i ];
+      if( fabs( value - Ramp( p[0], p[1], p[2] ) ) > 1e-3 )
+        {
+        std::cerr << "Wrong value at " << p[0] << " " << p[1] << " "
+                  << p[2] << " : " << value << " instead of "
+                  << Ramp( p[0], p[1], p[2] ) << std::endl;
+        return -1;
+        }
+      numberOfPixels++;
+      }
+    }
+  return numberOfPixels;
+}
+
+}
+
+int igstkImageResliceEngineTest( int, char * [] )
+{
+
+  igstk::RealTimeClock::Initialize();
+
+  typedef igstk::ImageResliceEngine      EngineType;
+  typedef EngineType::VectorType         VectorType;
+  typedef EngineType::SlicePointer       SlicePointer;
+
+  try
+    {
+    // Synthetic volume with anisotropic spacing
+    const int dimensions[3] = { 20, 16, 12 };
+    const double spacing[3] = { 1.0, 1.0, 2.0 };
+    const double origin[3]  = { 0.0, 0.0, 0.0 };
+    double extent[3];
+
+    std::vector< float > volume( dimensions[0] * dimensions[1] *
+                                 dimensions[2] );
+    for( int z = 0; z < dimensions[2]; z++ )
+      {
+      for( int y = 0; y < dimensions[1]; y++ )
+        {
+        for( int x = 0; x < dimensions[0]; x++ )
+          {
+          volume[ x + dimensions[0] * ( y + dimensions[1] * z ) ] =
+            static_cast< float >( ImageResliceEngineTest::Ramp(
+                                  x * spacing[0],
+                                  y * spacing[1],
+                                  z * spacing[2] ) );
+          }
+        }
+      }
+    for( unsigned int d = 0; d < 3; d++ )
+      {
+      extent[d] = ( dimensions[d] - 1 ) * spacing[d];
+      }
+
+    EngineType engine;
+
+    // No volume yet
+    VectorType center;
+    VectorType normal;
+    center.Fill( 0.0 );
+    normal.Fill( 0.0 );
+    normal[2] = 1.0;
+    if( engine.RequestSlice( center, normal,
+                             EngineType::Linear ).IsNotNull() )
+      {
+      std::cerr << "A slice was returned without input volume" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    if( !engine.SetInputVolume( &volume[0], VTK_FLOAT,
+                                dimensions, spacing, origin ) )
+      {
+      std::cerr << "SetInputVolume failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    engine.SetNumberOfThreads( 2 );
+
+    // Oblique plane through the center of the volume
+    center[0] = 9.3;
+    center[1] = 7.1;
+    center[2] = 10.4;
+    normal[0] = 0.3;
+    normal[1] = -0.4;
+    normal[2] = 0.8;
+
+    SlicePointer slice1 = engine.RequestSlice( center, normal,
+                                               EngineType::Linear );
+    if( slice1.IsNull() )
+      {
+      std::cerr << "RequestSlice failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    const int numberOfPixels =
+                   ImageResliceEngineTest::CheckSlice( slice1, extent );
+    if( numberOfPixels <= 0 )
+      {
+      std::cerr << "Linear reslicing failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    std::cout << "Checked " << numberOfPixels << " pixels in "
+              << engine.GetLastComputationTime() << " ms" << std::endl;
+
+    // A motion smaller than the quantization step must hit the cache
+    VectorType shifted = center;
+    shifted[0] += 0.01;
+    SlicePointer slice2 = engine.RequestSlice( shifted, normal,
+                                               EngineType::Linear );
+    if( slice2.GetPointer() != slice1.GetPointer() ||
+        engine.GetNumberOfCacheHits() != 1 ||
+        engine.GetNumberOfCacheMisses() != 1 )
+      {
+      std::cerr << "Cache was not used for a sub-quantum motion"
+                << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Nearest neighbor slices are cached separately
+    SlicePointer slice3 = engine.RequestSlice( center, normal,
+                                            EngineType::NearestNeighbor );
+    if( slice3.GetPointer() == slice1.GetPointer() )
+      {
+      std::cerr << "Interpolation mode is not part of the cache key"
+                << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Axis aligned plane, nearest neighbor is exact on the voxel grid
+    normal.Fill( 0.0 );
+    normal[2] = 1.0;
+    center[2] = 6.0;
+    SlicePointer slice4 = engine.RequestSlice( center, normal,
+                                            EngineType::NearestNeighbor );
+    if( ImageResliceEngineTest::CheckSlice( slice4, extent ) <= 0 )
+      {
+      std::cerr << "Nearest neighbor reslicing failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Least recently used eviction
+    engine.SetCacheCapacity( 2 );
+    engine.FlushCache();
+    VectorType c1 = center;
+    VectorType c2 = center;
+    VectorType c3 = center;
+    c2[2] = 8.0;
+    c3[2] = 10.0;
+    SlicePointer s1 = engine.RequestSlice( c1, normal, EngineType::Linear );
+    SlicePointer s2 = engine.RequestSlice( c2, normal, EngineType::Linear );
+    engine.RequestSlice( c1, normal, EngineType::Linear );
+    engine.RequestSlice( c3, normal, EngineType::Linear );
+    // c2 was the least recently used plane, it must be recomputed
+    if( engine.RequestSlice( c2, normal,
+                             EngineType::Linear ).GetPointer() ==
+                                                       s2.GetPointer() )
+      {
+      std::cerr << "Least recently used slice was not evicted"
+                << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Speculative precomputation along the motion direction
+    engine.SetCacheCapacity( 16 );
+    engine.FlushCache();
+    engine.SetNumberOfPrefetchSlices( 2 );
+    engine.RequestSlice( c1, normal, EngineType::Linear );
+    engine.RequestSlice( c2, normal, EngineType::Linear );
+
+    const igstk::RealTimeClock::TimeStampType startTime =
+                                    igstk::RealTimeClock::GetTimeStamp();
+    while( engine.GetNumberOfPrefetchedSlices() < 2 &&
+           igstk::RealTimeClock::GetTimeStamp() - startTime < 5000.0 )
+      {
+      igstk::PulseGenerator::Sleep( 10 );
+      }
+    if( engine.GetNumberOfPrefetchedSlices() < 2 )
+      {
+      std::cerr << "Slices were not prefetched" << std::endl;
+      return EXIT_FAILURE;
+      }
+    const unsigned long misses = engine.GetNumberOfCacheMisses();
+    engine.RequestSlice( c3, normal, EngineType::Linear );
+    if( engine.GetNumberOfCacheMisses() != misses )
+      {
+      std::cerr << "Prefetched slice was not used" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // A change of the parameters while slices are being prefetched must
+    // not leave slices computed with the old parameters in the cache
+    const float background = -100.0;
+    normal[0] = 0.3;
+    normal[1] = -0.4;
+    normal[2] = 0.8;
+    engine.FlushCache();
+    engine.SetNumberOfPrefetchSlices( 4 );
+    engine.RequestSlice( c1, normal, EngineType::Linear );
+    engine.RequestSlice( c2, normal, EngineType::Linear );
+    engine.SetBackgroundValue( background );
+    igstk::PulseGenerator::Sleep( 100 );
+    SlicePointer slice5 = engine.RequestSlice( c3, normal,
+                                               EngineType::Linear );
+    unsigned int numberOfBackgroundPixels = 0;
+    for( unsigned int i = 0; i < slice5->m_Buffer.size(); i++ )
+      {
+      if( slice5->m_Buffer[i] == background )
+        {
+        numberOfBackgroundPixels++;
+        }
+      else if( slice5->m_Buffer[i] == 0.0 )
+        {
+        std::cerr << "Slice computed with the previous background value"
+                  << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    if( numberOfBackgroundPixels == 0 )
+      {
+      std::cerr << "The slice has no background pixel" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    engine.Print( std::cout );
+    }
+  catch(...)
+    {
+    std::cerr << "Exception caught !!!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test [DONE]" << std::endl;
+
+  return EXIT_SUCCESS;
+}
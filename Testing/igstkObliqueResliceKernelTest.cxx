@@ -0,0 +1,176 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkObliqueResliceKernelTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+//  in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <algorithm>
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+#include "igstkObliqueResliceKernel.h"
+
+#include "vtkType.h"
+
+int igstkObliqueResliceKernelTest( int, char * [] )
+{
+  // Linear ramp, on which trilinear interpolation is exact
+  const int dimensions[3] = { 20, 16, 12 };
+  const double spacing[3] = { 1.0, 1.0, 2.0 };
+  const double origin[3]  = { 0.0, 0.0, 0.0 };
+
+  std::vector< short > volume( dimensions[0] * dimensions[1] *
+                               dimensions[2] );
+  for( int z = 0; z < dimensions[2]; z++ )
+    {
+    for( int y = 0; y < dimensions[1]; y++ )
+      {
+      for( int x = 0; x < dimensions[0]; x++ )
+        {
+        volume[ x + dimensions[0] * ( y + dimensions[1] * z ) ] =
+                                   static_cast< short >( x + 2 * y + 3 * z );
+        }
+      }
+    }
+
+  igstk::ObliqueResliceKernel kernel;
+
+  if( kernel.SetInputVolume( &volume[0], VTK_VOID,
+                             dimensions, spacing, origin ) )
+    {
+    std::cerr << "Unsupported scalar type was accepted" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if( !kernel.SetInputVolume( &volume[0], VTK_SHORT,
+                              dimensions, spacing, origin ) )
+    {
+    std::cerr << "SetInputVolume failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Oblique vertical plane, partially outside of the volume
+  const double sliceOrigin[3] = { -1.0, 2.0, 5.5 };
+  const double axis1[3] = { 0.8, 0.6, 0.0 };
+  const double axis2[3] = { 0.0, 0.0, 1.0 };
+  const double sliceSpacing[2] = { 0.5, 0.5 };
+  const unsigned int size[2] = { 60, 40 };
+
+  kernel.SetOutputGeometry( sliceOrigin, axis1, axis2, sliceSpacing, size );
+
+  // Rescale and cast to unsigned char in the same pass
+  const double scale = 2.0;
+  const double shift = 1.0;
+  kernel.SetIntensityMapping( scale, shift );
+  kernel.SetOutputRange( 0.0, 255.0 );
+  kernel.SetBackgroundValue( 0.0 );
+
+  std::vector< unsigned char > output( kernel.GetNumberOfOutputPixels() );
+  std::vector< unsigned char > rowRanges( 2 * size[1] );
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( 4 );
+
+  // The output buffer is reused between calls
+  for( unsigned int run = 0; run < 2; run++ )
+    {
+    kernel.Reslice( &output[0], threader, &rowRanges[0] );
+
+    unsigned int numberOfInsidePixels = 0;
+    for( unsigned int j = 0; j < size[1]; j++ )
+      {
+      for( unsigned int i = 0; i < size[0]; i++ )
+        {
+        double p[3];
+        for( unsigned int d = 0; d < 3; d++ )
+          {
+          p[d] = sliceOrigin[d] + i * sliceSpacing[0] * axis1[d] +
+                                  j * sliceSpacing[1] * axis2[d];
+          }
+        const bool inside = p[0] >= 0.0 && p[0] <= 19.0 &&
+                            p[1] >= 0.0 && p[1] <= 15.0 &&
+                            p[2] >= 0.0 && p[2] <= 22.0;
+        double expected = 0.0;
+        if( inside )
+          {
+          expected = ( p[0] + 2.0 * p[1] + 1.5 * p[2] ) * scale + shift;
+          expected = ( expected > 255.0 ) ? 255.0 : expected;
+          numberOfInsidePixels++;
+          }
+        if( fabs( output[ j * size[0] + i ] - expected ) > 0.51 )
+          {
+          std::cerr << "Wrong value at pixel " << i << " " << j << " : "
+                    << static_cast< int >( output[ j * size[0] + i ] )
+                    << " instead of " << expected << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+
+    // Range of each row
+    for( unsigned int j = 0; j < size[1]; j++ )
+      {
+      const unsigned char * rowBegin = &output[ j * size[0] ];
+      const unsigned char * rowEnd = rowBegin + size[0];
+      if( rowRanges[2 * j] != *std::min_element( rowBegin, rowEnd ) ||
+          rowRanges[2 * j + 1] != *std::max_element( rowBegin, rowEnd ) )
+        {
+        std::cerr << "Wrong range for row " << j << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    if( numberOfInsidePixels == 0 )
+      {
+      std::cerr << "The slice does not intersect the volume" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Single threaded nearest neighbor with float output
+  std::vector< float > floatOutput( kernel.GetNumberOfOutputPixels() );
+  kernel.SetIntensityMapping( 1.0, 0.0 );
+  kernel.SetOutputRange( -1e30, 1e30 );
+  kernel.SetLinearInterpolation( false );
+  kernel.Reslice( &floatOutput[0], NULL );
+
+  const unsigned int i = 10;
+  const unsigned int j = 30;
+  int index[3];
+  for( unsigned int d = 0; d < 3; d++ )
+    {
+    const double p = sliceOrigin[d] + i * sliceSpacing[0] * axis1[d] +
+                                      j * sliceSpacing[1] * axis2[d];
+    index[d] = static_cast< int >( floor( p / spacing[d] + 0.5 ) );
+    }
+  const float expected = volume[ index[0] + dimensions[0] *
+                               ( index[1] + dimensions[1] * index[2] ) ];
+  if( floatOutput[ j * size[0] + i ] != expected )
+    {
+    std::cerr << "Nearest neighbor failed: " << floatOutput[ j * size[0] + i ]
+              << " instead of " << expected << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test [DONE]" << std::endl;
+
+  return EXIT_SUCCESS;
+}
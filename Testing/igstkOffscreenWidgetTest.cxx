@@ -0,0 +1,108 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkOffscreenWidgetTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkEllipsoidObject.h"
+#include "igstkEllipsoidObjectRepresentation.h"
+#include "igstkView3D.h"
+#include "igstkOffscreenWidget.h"
+#include "igstkRealTimeClock.h"
+
+int igstkOffscreenWidgetTest( int, char * [] )
+{
+  typedef igstk::EllipsoidObjectRepresentation  ObjectRepresentationType;
+  typedef igstk::EllipsoidObject                ObjectType;
+  typedef igstk::View3D                         View3DType;
+  typedef igstk::OffscreenWidget                WidgetType;
+
+  std::cout << "Testing igstk::OffscreenWidget" << std::endl;
+
+  igstk::RealTimeClock::Initialize();
+
+  ObjectType::Pointer ellipsoid = ObjectType::New();
+
+  ObjectRepresentationType::Pointer representation =
+                                             ObjectRepresentationType::New();
+  representation->RequestSetEllipsoidObject( ellipsoid );
+  representation->SetColor( 0.0, 0.0, 1.0 );
+
+  View3DType::Pointer view3D = View3DType::New();
+  view3D->SetRefreshRate( 50 );
+
+  // A view rendered without a display
+  WidgetType::Pointer widget = WidgetType::New();
+  widget->RequestSetSize( 64, 48 );
+  widget->RequestSetView( view3D );
+  widget->Print( std::cout );
+
+  view3D->RequestAddObject( representation );
+
+  igstk::Transform identityTransform;
+  identityTransform.SetToIdentity( igstk::TimeStamp::GetLongestPossibleTime() );
+  ellipsoid->RequestSetTransformAndParent( identityTransform, view3D );
+
+  view3D->RequestResetCamera();
+  view3D->RequestStart();
+
+  for( int i = 0; i < 20; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 20 );
+    igstk::PulseGenerator::CheckTimeouts();
+    }
+
+  if( widget->GetNumberOfFrames() == 0 ||
+      widget->GetFramePixels() == NULL )
+    {
+    std::cerr << "No frame was rendered" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if( widget->GetFrameWidth() != 64 || widget->GetFrameHeight() != 48 )
+    {
+    std::cerr << "Wrong frame size " << widget->GetFrameWidth() << " x "
+              << widget->GetFrameHeight() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Without capture, the frames are still counted
+  widget->SetCaptureFrames( false );
+  const unsigned long numberOfFrames = widget->GetNumberOfFrames();
+  for( int i = 0; i < 10; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 20 );
+    igstk::PulseGenerator::CheckTimeouts();
+    }
+
+  if( widget->GetNumberOfFrames() == numberOfFrames )
+    {
+    std::cerr << "The view stopped rendering" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  view3D->RequestStop();
+
+  widget->Print( std::cout );
+
+  std::cout << "[PASSED]" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,288 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkRigidTransformTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+#include "igstkRigidTransform.h"
+#include "igstkRealTimeClock.h"
+
+namespace RigidTransformTest
+{
+
+bool AreEquivalent( const igstk::RigidTransform & rigid,
+                    const igstk::Transform & transform, double tolerance )
+{
+  igstk::Transform converted;
+  rigid.ExportTransform( converted );
+
+  if( !converted.IsNumericallyEquivalent( transform, tolerance ) )
+    {
+    std::cerr << "Transforms differ: " << std::endl << rigid
+              << transform << std::endl;
+    return false;
+    }
+  if( fabs( rigid.m_Error - transform.GetError() ) > tolerance ||
+      rigid.m_StartTime != transform.GetStartTime() ||
+      rigid.m_ExpirationTime != transform.GetExpirationTime() )
+    {
+    std::cerr << "Error or time stamp differ: " << std::endl << rigid
+              << transform << std::endl;
+    return false;
+    }
+  return true;
+}
+
+}
+
+int igstkRigidTransformTest( int, char * [] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  typedef igstk::Transform        TransformType;
+  typedef igstk::RigidTransform   RigidTransformType;
+
+  const double tolerance = 1e-9;
+
+  TransformType::VersorType rotation1;
+  TransformType::VersorType::VectorType axis;
+  axis[0] = 1.0;
+  axis[1] = 2.0;
+  axis[2] = -0.5;
+  rotation1.Set( axis, 0.7 );
+
+  TransformType::VectorType translation1;
+  translation1[0] = 10.0;
+  translation1[1] = -3.0;
+  translation1[2] = 4.5;
+
+  TransformType::VersorType rotation2;
+  axis[0] = -0.3;
+  axis[1] = 0.1;
+  axis[2] = 1.0;
+  rotation2.Set( axis, -1.2 );
+
+  TransformType::VectorType translation2;
+  translation2[0] = -1.0;
+  translation2[1] = 7.0;
+  translation2[2] = 0.25;
+
+  TransformType transform1;
+  transform1.SetTranslationAndRotation( translation1, rotation1, 0.1, 1000 );
+
+  TransformType transform2;
+  transform2.SetTranslationAndRotation( translation2, rotation2, 0.2, 500 );
+
+  // Conversions
+  RigidTransformType rigid1;
+  rigid1.ImportTransform( transform1 );
+
+  RigidTransformType rigid2;
+  rigid2.ImportTransform( transform2 );
+
+  if( !RigidTransformTest::AreEquivalent( rigid1, transform1, tolerance ) ||
+      !RigidTransformTest::AreEquivalent( rigid2, transform2, tolerance ) )
+    {
+    std::cerr << "Conversion failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Composition, including in place
+  RigidTransformType composed;
+  RigidTransformType::Compose( rigid1, rigid2, composed );
+
+  TransformType expected =
+                      TransformType::TransformCompose( transform1, transform2 );
+
+  if( !RigidTransformTest::AreEquivalent( composed, expected, tolerance ) )
+    {
+    std::cerr << "Compose failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  RigidTransformType inPlace = rigid2;
+  RigidTransformType::Compose( rigid1, inPlace, inPlace );
+  if( !RigidTransformTest::AreEquivalent( inPlace, expected, tolerance ) )
+    {
+    std::cerr << "In place compose failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Inversion
+  RigidTransformType inverse;
+  RigidTransformType::Invert( composed, inverse );
+  if( !RigidTransformTest::AreEquivalent( inverse, expected.GetInverse(),
+                                          tolerance ) )
+    {
+    std::cerr << "Invert failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Interpolation, halfway along the shortest path whatever the sign of
+  // the quaternions
+  RigidTransformType negated = rigid2;
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    negated.m_Rotation[i] = -negated.m_Rotation[i];
+    }
+
+  RigidTransformType halfway;
+  RigidTransformType::Interpolate( rigid1, rigid2, 0.5, halfway );
+  RigidTransformType negatedHalfway;
+  RigidTransformType::Interpolate( rigid1, negated, 0.5, negatedHalfway );
+
+  RigidTransformType firstHalf;
+  RigidTransformType::Invert( rigid1, firstHalf );
+  RigidTransformType::Compose( halfway, firstHalf, firstHalf );
+  RigidTransformType secondHalf;
+  RigidTransformType::Invert( halfway, secondHalf );
+  RigidTransformType::Compose( rigid2, secondHalf, secondHalf );
+
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    if( fabs( halfway.m_Rotation[i] - negatedHalfway.m_Rotation[i] ) >
+                                                                tolerance ||
+        fabs( fabs( firstHalf.m_Rotation[i] ) -
+              fabs( secondHalf.m_Rotation[i] ) ) > tolerance )
+      {
+      std::cerr << "Interpolate failed for the rotation" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    if( fabs( halfway.m_Translation[i] -
+              0.5 * ( translation1[i] + translation2[i] ) ) > tolerance )
+      {
+      std::cerr << "Interpolate failed for the translation" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Points, one by one and in batch
+  const unsigned long numberOfPoints = 1001;
+  std::vector< double > points( 3 * numberOfPoints );
+  std::vector< float > floatPoints( 3 * numberOfPoints );
+  for( unsigned long i = 0; i < points.size(); i++ )
+    {
+    points[i] = 0.37 * i - 50.0;
+    floatPoints[i] = static_cast< float >( points[i] );
+    }
+
+  std::vector< double > transformedPoints( points.size() );
+  composed.TransformPoints( &points[0], &transformedPoints[0],
+                            numberOfPoints );
+  composed.TransformPoints( &floatPoints[0], &floatPoints[0],
+                            numberOfPoints );
+
+  for( unsigned long i = 0; i < numberOfPoints; i++ )
+    {
+    TransformType::VectorType point;
+    point[0] = points[ 3 * i ];
+    point[1] = points[ 3 * i + 1 ];
+    point[2] = points[ 3 * i + 2 ];
+    const TransformType::VectorType reference =
+      expected.GetRotation().Transform( point ) + expected.GetTranslation();
+
+    double single[3];
+    composed.TransformPoint( &points[ 3 * i ], single );
+
+    for( unsigned int d = 0; d < 3; d++ )
+      {
+      if( fabs( transformedPoints[ 3 * i + d ] - reference[d] ) > 1e-6 ||
+          fabs( single[d] - reference[d] ) > 1e-6 ||
+          fabs( floatPoints[ 3 * i + d ] - reference[d] ) > 1e-2 )
+        {
+        std::cerr << "Point " << i << " was not transformed correctly"
+                  << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // 4x4 matrix, as exported to VTK
+  double matrix[16];
+  composed.GetMatrix( matrix );
+  vtkMatrix4x4 * vtkMatrix = vtkMatrix4x4::New();
+  expected.ExportTransform( *vtkMatrix );
+  for( unsigned int i = 0; i < 16; i++ )
+    {
+    if( fabs( matrix[i] - vtkMatrix->GetElement( i / 4, i % 4 ) ) > 1e-9 )
+      {
+      std::cerr << "GetMatrix failed at element " << i << std::endl;
+      vtkMatrix->Delete();
+      return EXIT_FAILURE;
+      }
+    }
+  vtkMatrix->Delete();
+
+  // Validity
+  RigidTransformType identity;
+  identity.SetToIdentity( 100.0 );
+  if( !identity.IsValidAtTime( identity.m_StartTime + 50.0 ) ||
+      identity.IsValidAtTime( identity.m_StartTime + 150.0 ) )
+    {
+    std::cerr << "IsValidAtTime failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Tracker -> tool -> calibration -> reference composition rate
+  const unsigned int numberOfCompositions = 100000;
+
+  double start = igstk::RealTimeClock::GetTimeStamp();
+  TransformType chain = transform1;
+  for( unsigned int i = 0; i < numberOfCompositions; i++ )
+    {
+    chain = TransformType::TransformCompose(
+                 transform1,
+                 TransformType::TransformCompose( transform2,
+                                                  transform1.GetInverse() ) );
+    }
+  const double transformTime = igstk::RealTimeClock::GetTimeStamp() - start;
+
+  start = igstk::RealTimeClock::GetTimeStamp();
+  RigidTransformType rigidChain;
+  for( unsigned int i = 0; i < numberOfCompositions; i++ )
+    {
+    RigidTransformType::Invert( rigid1, rigidChain );
+    RigidTransformType::Compose( rigid2, rigidChain, rigidChain );
+    RigidTransformType::Compose( rigid1, rigidChain, rigidChain );
+    }
+  const double rigidTime = igstk::RealTimeClock::GetTimeStamp() - start;
+
+  if( !RigidTransformTest::AreEquivalent( rigidChain, chain, tolerance ) )
+    {
+    std::cerr << "Composition chains differ" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Transform chains per second: "
+            << numberOfCompositions / ( transformTime / 1000.0 ) << std::endl;
+  std::cout << "RigidTransform chains per second: "
+            << numberOfCompositions / ( rigidTime / 1000.0 ) << std::endl;
+
+  std::cout << "Test [DONE]" << std::endl;
+
+  return EXIT_SUCCESS;
+}
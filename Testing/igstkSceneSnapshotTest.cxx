@@ -0,0 +1,207 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkSceneSnapshotTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include "igstkSceneSnapshotPublisher.h"
+
+#include <math.h>
+
+namespace SceneSnapshotTest
+{
+
+igstk::Transform Translation( double x, double y, double z )
+{
+  igstk::Transform::VectorType translation;
+  translation[0] = x;
+  translation[1] = y;
+  translation[2] = z;
+
+  igstk::Transform transform;
+  transform.SetTranslation( translation, 0.1,
+                            igstk::TimeStamp::GetLongestPossibleTime() );
+  return transform;
+}
+
+bool HasTranslation( const igstk::SceneSnapshot * snapshot,
+                     const igstk::CoordinateSystem * source,
+                     const igstk::CoordinateSystem * destination,
+                     double x, double y, double z )
+{
+  igstk::RigidTransform rigidTransform;
+  if( !snapshot->ComputeTransform( source, destination, rigidTransform ) )
+    {
+    std::cerr << "The coordinate systems are not connected" << std::endl;
+    return false;
+    }
+
+  igstk::Transform transform;
+  rigidTransform.ExportTransform( transform );
+  igstk::Transform::VectorType translation = transform.GetTranslation();
+
+  const double tolerance = 1e-6;
+  if( fabs( translation[0] - x ) > tolerance ||
+      fabs( translation[1] - y ) > tolerance ||
+      fabs( translation[2] - z ) > tolerance )
+    {
+    std::cerr << "Wrong translation " << translation << " instead of "
+              << x << " " << y << " " << z << std::endl;
+    return false;
+    }
+  return true;
+}
+
+}
+
+int igstkSceneSnapshotTest( int, char * [] )
+{
+  typedef igstk::CoordinateSystem             CoordinateSystemType;
+  typedef igstk::SceneSnapshotPublisher       PublisherType;
+  typedef igstk::SceneSnapshot                SnapshotType;
+
+  std::cout << "Testing igstk::SceneSnapshot" << std::endl;
+
+  // world -> tracker -> tool, and world -> view
+  CoordinateSystemType::Pointer world = CoordinateSystemType::New();
+  CoordinateSystemType::Pointer tracker = CoordinateSystemType::New();
+  CoordinateSystemType::Pointer tool = CoordinateSystemType::New();
+  CoordinateSystemType::Pointer view = CoordinateSystemType::New();
+  CoordinateSystemType::Pointer alone = CoordinateSystemType::New();
+
+  tracker->RequestSetTransformAndParent(
+    SceneSnapshotTest::Translation( 1.0, 0.0, 0.0 ), world );
+  tool->RequestSetTransformAndParent(
+    SceneSnapshotTest::Translation( 0.0, 2.0, 0.0 ), tracker );
+  view->RequestSetTransformAndParent(
+    SceneSnapshotTest::Translation( 0.0, 0.0, 3.0 ), world );
+
+  PublisherType::Pointer publisher = PublisherType::New();
+  publisher->Print( std::cout );
+
+  SnapshotType::RepresentationType representation;
+  representation.Representation = NULL;
+  representation.Object = tool;
+  representation.View = view;
+  representation.Color[0] = 1.0;
+  representation.Color[1] = 0.5;
+  representation.Color[2] = 0.0;
+  representation.Opacity = 1.0;
+  representation.Visible = true;
+
+  PublisherType::RepresentationContainerType representations;
+  representations.push_back( representation );
+
+  publisher->RequestSetRepresentations( representations );
+
+  SnapshotType::ConstPointer first = publisher->GetSnapshot();
+  if( first->GetVersion() != 1 ||
+      publisher->GetNumberOfCoordinateSystems() != 4 ||
+      first->GetRepresentations().size() != 1 )
+    {
+    std::cerr << "The scene was not published" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if( !SceneSnapshotTest::HasTranslation( first, tool, view,
+                                          1.0, 2.0, -3.0 ) ||
+      !SceneSnapshotTest::HasTranslation( first, view, tool,
+                                          -1.0, -2.0, 3.0 ) ||
+      !SceneSnapshotTest::HasTranslation( first, tool, tool,
+                                          0.0, 0.0, 0.0 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  igstk::RigidTransform unused;
+  if( first->ComputeTransform( tool, alone, unused ) )
+    {
+    std::cerr << "Disconnected coordinate systems were connected"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the same representations do not publish a snapshot
+  publisher->RequestSetRepresentations( representations );
+  if( publisher->GetNumberOfPublishedSnapshots() != 1 )
+    {
+    std::cerr << "Unchanged representations were published" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // tracker updates publish a single new snapshot at the next pulse, and
+  // leave the previous one as it was
+  tracker->RequestUpdateTransformToParent(
+    SceneSnapshotTest::Translation( 4.0, 0.0, 0.0 ) );
+  tracker->RequestUpdateTransformToParent(
+    SceneSnapshotTest::Translation( 5.0, 0.0, 0.0 ) );
+  if( publisher->GetNumberOfPublishedSnapshots() != 1 )
+    {
+    std::cerr << "The tracker updates were published before the pulse"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  publisher->RequestPublish();
+  publisher->RequestPublish();
+
+  SnapshotType::ConstPointer second = publisher->GetSnapshot();
+  if( second->GetVersion() != 2 ||
+      publisher->GetNumberOfPublishedSnapshots() != 2 )
+    {
+    std::cerr << "The tracker updates were not published once"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if( !SceneSnapshotTest::HasTranslation( second, tool, view,
+                                          5.0, 2.0, -3.0 ) ||
+      !SceneSnapshotTest::HasTranslation( first, tool, view,
+                                          1.0, 2.0, -3.0 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // the coordinate systems are not followed anymore without
+  // representations
+  publisher->RequestSetRepresentations(
+                               PublisherType::RepresentationContainerType() );
+  if( publisher->GetNumberOfCoordinateSystems() != 0 )
+    {
+    std::cerr << "The coordinate systems are still followed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  tracker->RequestUpdateTransformToParent(
+    SceneSnapshotTest::Translation( 6.0, 0.0, 0.0 ) );
+  publisher->RequestPublish();
+  if( publisher->GetNumberOfPublishedSnapshots() != 3 )
+    {
+    std::cerr << "A snapshot was published for a removed scene"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  publisher->Print( std::cout );
+
+  std::cout << "[PASSED]" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkSliceColorMapperTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+//  in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <iostream>
+#include <string.h>
+
+#include "igstkSliceColorMapper.h"
+
+#include "vtkImageData.h"
+#include "vtkLookupTable.h"
+#include "vtkImageMapToColors.h"
+
+namespace SliceColorMapperTest
+{
+
+/** Volume with a ramp of values around the window */
+vtkImageData * CreateVolume( int scalarType )
+{
+  vtkImageData * image = vtkImageData::New();
+  image->SetDimensions( 64, 32, 4 );
+  image->SetScalarType( scalarType );
+  image->SetNumberOfScalarComponents( 1 );
+  image->AllocateScalars();
+
+  for( int z = 0; z < 4; z++ )
+    {
+    for( int y = 0; y < 32; y++ )
+      {
+      for( int x = 0; x < 64; x++ )
+        {
+        image->SetScalarComponentFromDouble( x, y, z, 0,
+                                       -400.0 + 13.0 * x + 7.0 * y + z );
+        }
+      }
+    }
+  return image;
+}
+
+/** Compare the slice with the output of vtkImageMapToColors */
+bool CompareWithVTK( vtkImageData * image, const int extent[6],
+                     vtkImageData * slice, double window, double level )
+{
+  vtkLookupTable * lut = vtkLookupTable::New();
+  lut->SetTableRange( level - window / 2.0, level + window / 2.0 );
+  lut->SetSaturationRange( 1.0, 1.0 );
+  lut->SetAlphaRange( 0.5, 0.5 );
+  lut->SetHueRange( 0.3, 0.3 );
+  lut->SetValueRange( 0, 1.0 );
+  lut->SetRampToLinear();
+
+  vtkImageMapToColors * mapColors = vtkImageMapToColors::New();
+  mapColors->SetLookupTable( lut );
+  mapColors->SetInput( image );
+  mapColors->Update();
+
+  bool same = true;
+  for( int z = extent[4]; z <= extent[5]; z++ )
+    {
+    for( int y = extent[2]; y <= extent[3]; y++ )
+      {
+      const int length = 4 * ( extent[1] - extent[0] + 1 );
+      vtkImageData * expected = mapColors->GetOutput();
+      if( memcmp( expected->GetScalarPointer( extent[0], y, z ),
+                  slice->GetScalarPointer( extent[0], y, z ), length ) != 0 )
+        {
+        same = false;
+        }
+      }
+    }
+
+  mapColors->Delete();
+  lut->Delete();
+  return same;
+}
+
+}
+
+int igstkSliceColorMapperTest( int, char * [] )
+{
+  using SliceColorMapperTest::CreateVolume;
+  using SliceColorMapperTest::CompareWithVTK;
+
+  int result = EXIT_SUCCESS;
+
+  igstk::SliceColorMapper mapper;
+  mapper.SetColor( 0.3, 1.0, 1.0, 0.5 );
+  mapper.SetWindowLevel( 400.0, 40.0 );
+
+  const int axial[6] = { 0, 63, 0, 31, 2, 2 };
+  const int sagittal[6] = { 10, 10, 0, 31, 0, 3 };
+
+  // 16 bit image, mapped with the table of every value
+  vtkImageData * image = CreateVolume( VTK_SHORT );
+  vtkImageData * slice = vtkImageData::New();
+
+  if( !mapper.MapSlice( image, axial, slice ) ||
+      !CompareWithVTK( image, axial, slice, 400.0, 40.0 ) )
+    {
+    std::cerr << "Wrong colours on an axial slice" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // Moving the slice and changing the window reuse the buffer
+  void * buffer = slice->GetScalarPointer();
+  const int nextAxial[6] = { 0, 63, 0, 31, 3, 3 };
+  mapper.SetWindowLevel( 100.0, -20.0 );
+  if( !mapper.MapSlice( image, nextAxial, slice ) ||
+      !CompareWithVTK( image, nextAxial, slice, 100.0, -20.0 ) ||
+      slice->GetScalarPointer() != buffer ||
+      mapper.GetNumberOfTableBuilds() != 2 )
+    {
+    std::cerr << "Wrong colours after a window change" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( !mapper.MapSlice( image, sagittal, slice ) ||
+      !CompareWithVTK( image, sagittal, slice, 100.0, -20.0 ) )
+    {
+    std::cerr << "Wrong colours on a sagittal slice" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  const int outside[6] = { 0, 63, 0, 31, 4, 4 };
+  if( mapper.MapSlice( image, outside, slice ) )
+    {
+    std::cerr << "A slice outside of the image was mapped" << std::endl;
+    result = EXIT_FAILURE;
+    }
+  image->Delete();
+
+  // Floating point image, mapped through the 256 colours
+  image = CreateVolume( VTK_FLOAT );
+  if( !mapper.MapSlice( image, axial, slice ) ||
+      !CompareWithVTK( image, axial, slice, 100.0, -20.0 ) )
+    {
+    std::cerr << "Wrong colours on a floating point slice" << std::endl;
+    result = EXIT_FAILURE;
+    }
+  image->Delete();
+
+  slice->Delete();
+
+  return result;
+}
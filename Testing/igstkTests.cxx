@@ -81,6 +81,25 @@ void RegisterTests()
 
   REGISTER_TEST(igstkPETImageSpatialObjectTest);
   REGISTER_TEST(igstkPETImageSpatialObjectRepresentationTest);
+  REGISTER_TEST(igstkImageResliceEngineTest);
+  REGISTER_TEST(igstkImageResliceEngineRepresentationTest);
+  REGISTER_TEST(igstkObliqueResliceKernelTest);
+  REGISTER_TEST(igstkEventChannelTest);
+  REGISTER_TEST(igstkRigidTransformTest);
+  REGISTER_TEST(igstkTrackerAggregatorTest);
+  REGISTER_TEST(igstkTrackerAggregatorLatencyTest);
+  REGISTER_TEST(igstkTrackerToolPredictorTest);
+  REGISTER_TEST(igstkTrackerToolFilterTest);
+  REGISTER_TEST(igstkTrackerRecorderTest);
+  REGISTER_TEST(igstkColorMappedSliceCacheTest);
+  REGISTER_TEST(igstkSliceColorMapperTest);
+  REGISTER_TEST(igstkDeviceFrameClockTest);
+  REGISTER_TEST(igstkThreadPolicyTest);
+  REGISTER_TEST(igstkCommunicationReactorTest);
+  REGISTER_TEST(igstkSceneSnapshotTest);
+  REGISTER_TEST(igstkOffscreenWidgetTest);
+  REGISTER_TEST(igstkFrameSchedulerTest);
+  REGISTER_TEST(igstkAscensionCommandInterpreterStreamTest);
 
   // Tests depend on device 
 #ifdef IGSTK_TEST_AURORA_ATTACHED 
@@ -237,6 +256,10 @@ void RegisterTests()
   REGISTER_TEST( igstkFrameTest );
   REGISTER_TEST( igstkVideoFrameSpatialObjectTest );
   REGISTER_TEST( igstkVideoFrameRepresentationTest );
+  REGISTER_TEST( igstkVideoTrackingRecorderTest );
+  REGISTER_TEST( igstkUSVolumeReconstructorTest );
+  REGISTER_TEST( igstkVideoTemporalCalibrationTest );
+  REGISTER_TEST( igstkViewRecorderTest );
 #endif
   
 }
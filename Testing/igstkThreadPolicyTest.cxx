@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkThreadPolicyTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if defined(_MSC_VER)
+//  Warning about: identifier was truncated to '255' characters
+//  in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <iostream>
+#include <vector>
+#include <math.h>
+#include <stdlib.h>
+
+#include "itkMultiThreader.h"
+#include "itkMutexLock.h"
+
+#include "igstkThreadPolicy.h"
+#include "igstkRealTimeClock.h"
+#include "igstkPulseGenerator.h"
+
+namespace ThreadPolicyTest
+{
+
+/** Sampling thread: applies a policy, then wakes up every millisecond
+ *  like an acquisition thread polling its device */
+class Sampler
+{
+public:
+  igstk::ThreadPolicy                                 Policy;
+  igstk::ThreadPolicy::SettingResultContainerType     Results;
+  std::vector< double >                               TimeStamps;
+  bool                                                Done;
+  itk::SimpleMutexLock                                Lock;
+};
+
+ITK_THREAD_RETURN_TYPE SamplingThread( void * pInfoStruct )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)pInfoStruct;
+  Sampler * sampler = (Sampler*)pInfo->UserData;
+
+  sampler->Results = sampler->Policy.ApplyToCurrentThread();
+  for( unsigned int i = 0; i < sampler->TimeStamps.size(); i++ )
+    {
+    igstk::PulseGenerator::Sleep( 1 );
+    sampler->TimeStamps[i] = igstk::RealTimeClock::GetTimeStamp();
+    }
+
+  sampler->Lock.Lock();
+  sampler->Done = true;
+  sampler->Lock.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/** Load thread: spins until it is terminated */
+ITK_THREAD_RETURN_TYPE LoadThread( void * pInfoStruct )
+{
+  struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+    (struct itk::MultiThreader::ThreadInfoStruct*)pInfoStruct;
+
+  volatile double x = 0.0;
+  int activeFlag = 1;
+  while( activeFlag )
+    {
+    for( unsigned int i = 0; i < 100000; i++ )
+      {
+      x = x * 0.5 + 1.0;
+      }
+    pInfo->ActiveFlagLock->Lock();
+    activeFlag = *pInfo->ActiveFlag;
+    pInfo->ActiveFlagLock->Unlock();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+typedef igstk::ThreadPolicy::SettingResultContainerType   ResultsType;
+
+/** Sample under load with the policy, print the intervals, and return
+ *  the largest one */
+double MeasureJitter( const igstk::ThreadPolicy & policy,
+                      ResultsType & results )
+{
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+
+  // one busy thread per processor, plus one
+  std::vector< int > loadThreads;
+  const int numberOfLoadThreads = threader->GetNumberOfThreads() + 1;
+  for( int i = 0; i < numberOfLoadThreads; i++ )
+    {
+    loadThreads.push_back( threader->SpawnThread( LoadThread, NULL ) );
+    }
+
+  Sampler sampler;
+  sampler.Policy = policy;
+  sampler.TimeStamps.resize( 1000 );
+  sampler.Done = false;
+  const int samplingThread = threader->SpawnThread( SamplingThread, &sampler );
+
+  bool done = false;
+  while( !done )
+    {
+    igstk::PulseGenerator::Sleep( 10 );
+    sampler.Lock.Lock();
+    done = sampler.Done;
+    sampler.Lock.Unlock();
+    }
+
+  threader->TerminateThread( samplingThread );
+  for( unsigned int i = 0; i < loadThreads.size(); i++ )
+    {
+    threader->TerminateThread( loadThreads[i] );
+    }
+
+  double sum = 0.0;
+  double sumOfSquares = 0.0;
+  double largest = 0.0;
+  const unsigned int n = sampler.TimeStamps.size() - 1;
+  for( unsigned int i = 0; i < n; i++ )
+    {
+    const double interval =
+      sampler.TimeStamps[i+1] - sampler.TimeStamps[i];
+    sum += interval;
+    sumOfSquares += interval * interval;
+    if( interval > largest )
+      {
+      largest = interval;
+      }
+    }
+  const double mean = sum / n;
+  const double deviation = sqrt( fabs( sumOfSquares / n - mean * mean ) );
+
+  std::cout << "  " << policy << std::endl;
+  for( unsigned int i = 0; i < sampler.Results.size(); i++ )
+    {
+    std::cout << "  " << sampler.Results[i].Description << std::endl;
+    }
+  std::cout << "  interval: mean " << mean << " ms, deviation "
+            << deviation << " ms, largest " << largest << " ms" << std::endl;
+
+  results = sampler.Results;
+  return largest;
+}
+
+}
+
+/** Measures the intervals between the samples of a thread that wakes up
+ *  every millisecond while all the processors are busy, with the default
+ *  policy and with a real time policy. Without privileges the real time
+ *  settings fail, which is reported but not an error. When a maximum
+ *  interval is given and the real time scheduling could be applied, the
+ *  largest interval must not exceed it. */
+int igstkThreadPolicyTest( int argc, char * argv[] )
+{
+  using ThreadPolicyTest::MeasureJitter;
+
+  igstk::RealTimeClock::Initialize();
+
+  int result = EXIT_SUCCESS;
+
+  igstk::ThreadPolicy::SettingResultContainerType results;
+
+  std::cout << "Default policy" << std::endl;
+  igstk::ThreadPolicy defaultPolicy;
+  MeasureJitter( defaultPolicy, results );
+  if( !results.empty() )
+    {
+    std::cerr << "The default policy changed settings" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  std::cout << "Real time policy" << std::endl;
+  igstk::ThreadPolicy realTimePolicy;
+  realTimePolicy.SetScheduling( igstk::ThreadPolicy::FifoScheduling, 80 );
+  realTimePolicy.SetCPUAffinityMask( 1 );
+  realTimePolicy.SetLockMemory( true );
+  realTimePolicy.SetPrefaultStackSize( 64 * 1024 );
+  const double largest = MeasureJitter( realTimePolicy, results );
+
+  // scheduling, affinity, memory and stack, in this order
+  if( results.size() != 4 || !results[3].Succeeded )
+    {
+    std::cerr << "Wrong outcome of the real time settings" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( argc > 1 && results.size() == 4 && results[0].Succeeded &&
+      largest > atof( argv[1] ) )
+    {
+    std::cerr << "Largest interval " << largest << " ms exceeds "
+              << argv[1] << " ms" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  return result;
+}
@@ -0,0 +1,275 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerAggregatorLatencyTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <math.h>
+#include <iostream>
+#include <map>
+
+#include "igstkRealTimeClock.h"
+#include "igstkPulseGenerator.h"
+#include "igstkSimulatedTracker.h"
+#include "igstkSimulatedTrackerTool.h"
+#include "igstkTrackerAggregator.h"
+#include "igstkAggregatedTrackerTool.h"
+
+namespace igstk
+{
+
+/** Simulated tracker following an oscillation along X. The samples are
+ *  stamped when they are reported, a known latency after their
+ *  acquisition. */
+class DelayedOscillationTracker : public SimulatedTracker
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( DelayedOscillationTracker, SimulatedTracker )
+
+  /** Delay between the acquisition and the time stamp of the samples */
+  igstkSetMacro( Latency, double );
+
+  /** Time origin of the oscillation, common to all the trackers */
+  igstkSetMacro( StartTime, double );
+
+protected:
+
+  DelayedOscillationTracker():m_StateMachine(this)
+    {
+    m_Latency = 0.0;
+    m_StartTime = 0.0;
+    }
+
+  ~DelayedOscillationTracker()
+    {
+    }
+
+  virtual ResultType InternalUpdateStatus( void )
+    {
+    const double amplitude = 50.0;
+    const double period = 1000.0;
+    const double acquisitionTime =
+                  RealTimeClock::GetTimeStamp() - m_Latency - m_StartTime;
+
+    TransformType::VectorType position;
+    position[0] = amplitude *
+                  sin( 8.0 * atan( 1.0 ) * acquisitionTime / period );
+    position[1] = 0.0;
+    position[2] = 0.0;
+
+    // The transform is stamped now
+    TransformType transform;
+    transform.SetTranslation( position, 0.1, this->GetValidityTime() );
+
+    const TrackerToolSlotType numberOfSlots =
+                                           this->GetNumberOfTrackerToolSlots();
+    for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
+      {
+      if( this->GetTrackerToolInSlot( slot ) )
+        {
+        this->SetTrackerToolRawTransform( slot, transform );
+        this->SetTrackerToolTransformUpdate( slot, true );
+        }
+      }
+    return SUCCESS;
+    }
+
+private:
+
+  double    m_Latency;
+  double    m_StartTime;
+};
+
+}
+
+namespace TrackerAggregatorLatencyTest
+{
+
+/** Records the X position of an aggregated tool at every time stamp */
+class PositionRecorder
+{
+public:
+  void Callback( const igstk::CoordinateSystemTransformToResult & result )
+    {
+    const igstk::Transform & transform = result.GetTransform();
+    m_Positions[ transform.GetStartTime() ] = transform.GetTranslation()[0];
+    }
+
+  std::map< double, double >    m_Positions;
+};
+
+}
+
+/** Two trackers report the same motion with latencies of 10 and 40 ms. The
+ *  latency of the first one is known, the latency of the second one must be
+ *  estimated, and the aligned tools must then report the same positions. */
+int igstkTrackerAggregatorLatencyTest( int, char * [] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  typedef igstk::DelayedOscillationTracker    SourceTrackerType;
+  typedef igstk::SimulatedTrackerTool         SourceTrackerToolType;
+  typedef igstk::TrackerAggregator            AggregatorType;
+  typedef igstk::AggregatedTrackerTool        AggregatedToolType;
+  typedef TrackerAggregatorLatencyTest::PositionRecorder  RecorderType;
+
+  const double opticalLatency = 10.0;
+  const double emLatency = 40.0;
+  const double startTime = igstk::RealTimeClock::GetTimeStamp();
+
+  SourceTrackerType::Pointer opticalTracker = SourceTrackerType::New();
+  SourceTrackerType::Pointer emTracker = SourceTrackerType::New();
+
+  opticalTracker->SetLatency( opticalLatency );
+  opticalTracker->SetStartTime( startTime );
+  opticalTracker->RequestOpen();
+  opticalTracker->RequestSetFrequency( 60.0 );
+
+  emTracker->SetLatency( emLatency );
+  emTracker->SetStartTime( startTime );
+  emTracker->RequestOpen();
+  emTracker->RequestSetFrequency( 40.0 );
+
+  SourceTrackerToolType::Pointer opticalTool = SourceTrackerToolType::New();
+  opticalTool->RequestSetName( "Sensor" );
+  opticalTool->RequestConfigure();
+  opticalTool->RequestAttachToTracker( opticalTracker );
+
+  SourceTrackerToolType::Pointer emTool = SourceTrackerToolType::New();
+  emTool->RequestSetName( "Sensor" );
+  emTool->RequestConfigure();
+  emTool->RequestAttachToTracker( emTracker );
+
+  AggregatorType::Pointer aggregator = AggregatorType::New();
+  aggregator->AddTracker( opticalTracker );
+  aggregator->AddTracker( emTracker );
+  aggregator->SetTrackerLatency( opticalTracker, opticalLatency );
+  aggregator->SetLatencyReferenceTracker( opticalTracker );
+
+  aggregator->RequestOpen();
+  aggregator->RequestSetFrequency( 60.0 );
+
+  AggregatedToolType::Pointer aggregatedOpticalTool =
+                                                 AggregatedToolType::New();
+  aggregatedOpticalTool->RequestSetSourceTrackerTool( opticalTracker,
+                                                      opticalTool );
+  aggregatedOpticalTool->RequestSetToolName( "OpticalSensor" );
+  aggregatedOpticalTool->RequestConfigure();
+  aggregatedOpticalTool->RequestAttachToTracker( aggregator );
+
+  AggregatedToolType::Pointer aggregatedEMTool = AggregatedToolType::New();
+  aggregatedEMTool->RequestSetSourceTrackerTool( emTracker, emTool );
+  aggregatedEMTool->RequestSetToolName( "EMSensor" );
+  aggregatedEMTool->RequestConfigure();
+  aggregatedEMTool->RequestAttachToTracker( aggregator );
+
+  RecorderType opticalRecorder;
+  RecorderType emRecorder;
+
+  aggregatedOpticalTool->GetCalibratedTransformChannel().AddMemberObserver<
+                    RecorderType, &RecorderType::Callback >( &opticalRecorder );
+  aggregatedEMTool->GetCalibratedTransformChannel().AddMemberObserver<
+                    RecorderType, &RecorderType::Callback >( &emRecorder );
+
+  aggregator->RequestStartTracking();
+
+  const double trackingDuration = 3000.0;
+  const double measureStartTime = startTime + trackingDuration - 1000.0;
+  while( igstk::RealTimeClock::GetTimeStamp() - startTime < trackingDuration )
+    {
+    igstk::PulseGenerator::Sleep( 5 );
+    igstk::PulseGenerator::CheckTimeouts();
+    }
+
+  aggregator->RequestStopTracking();
+
+  aggregator->Print( std::cout );
+
+  int result = EXIT_SUCCESS;
+
+  const double estimatedLatency = aggregator->GetTrackerLatency( emTracker );
+  std::cout << "Estimated latency: " << estimatedLatency << std::endl;
+  if( fabs( estimatedLatency - emLatency ) > 5.0 )
+    {
+    std::cerr << "Wrong latency estimate " << estimatedLatency
+              << " instead of " << emLatency << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( aggregator->GetTrackerLatency( opticalTracker ) != opticalLatency )
+    {
+    std::cerr << "The latency set by the application changed" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // The trackers share the RealTimeClock
+  if( aggregator->GetTrackerClockOffset( opticalTracker ) != 0.0 ||
+      aggregator->GetTrackerClockOffset( emTracker ) != 0.0 )
+    {
+    std::cerr << "Unexpected clock offset" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // Once the latencies are compensated, both tools report the same motion
+  unsigned int numberOfPairs = 0;
+  double sumOfDifferences = 0.0;
+  std::map< double, double >::const_iterator opticalPosition =
+                              opticalRecorder.m_Positions.lower_bound(
+                                                            measureStartTime );
+  for( ; opticalPosition != opticalRecorder.m_Positions.end();
+       ++opticalPosition )
+    {
+    std::map< double, double >::const_iterator emPosition =
+                      emRecorder.m_Positions.find( opticalPosition->first );
+    if( emPosition != emRecorder.m_Positions.end() )
+      {
+      sumOfDifferences += fabs( emPosition->second - opticalPosition->second );
+      numberOfPairs++;
+      }
+    }
+
+  if( numberOfPairs == 0 )
+    {
+    std::cerr << "No aligned transforms" << std::endl;
+    result = EXIT_FAILURE;
+    }
+  else
+    {
+    const double meanDifference = sumOfDifferences / numberOfPairs;
+    std::cout << "Mean difference: " << meanDifference << " mm over "
+              << numberOfPairs << " transforms" << std::endl;
+    if( meanDifference > 2.0 )
+      {
+      std::cerr << "The aligned tools disagree" << std::endl;
+      result = EXIT_FAILURE;
+      }
+    }
+
+  aggregatedOpticalTool->RequestDetachFromTracker();
+  aggregatedEMTool->RequestDetachFromTracker();
+
+  aggregator->RequestClose();
+  opticalTracker->RequestClose();
+  emTracker->RequestClose();
+
+  return result;
+}
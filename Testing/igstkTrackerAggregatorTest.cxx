@@ -0,0 +1,214 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerAggregatorTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <math.h>
+#include <iostream>
+
+#include "igstkRealTimeClock.h"
+#include "igstkPulseGenerator.h"
+#include "igstkCircularSimulatedTracker.h"
+#include "igstkSimulatedTrackerTool.h"
+#include "igstkTrackerAggregator.h"
+#include "igstkAggregatedTrackerTool.h"
+
+namespace TrackerAggregatorTest
+{
+
+/** Checks the transforms received from an aggregated tool against a circle
+ *  centered at the given position. */
+class TransformChecker
+{
+public:
+  TransformChecker( double centerX, double radius )
+    {
+    m_CenterX = centerX;
+    m_Radius = radius;
+    m_NumberOfTransforms = 0;
+    m_NumberOfErrors = 0;
+    m_PreviousStartTime = 0.0;
+    }
+
+  void Callback( const igstk::CoordinateSystemTransformToResult & result )
+    {
+    const igstk::Transform & transform = result.GetTransform();
+    const igstk::Transform::VectorType & translation =
+                                           transform.GetTranslation();
+
+    const double dx = translation[0] - m_CenterX;
+    const double dy = translation[1];
+    const double distance = sqrt( dx * dx + dy * dy );
+
+    // Interpolated positions lie on a chord of the circle
+    if( distance > m_Radius + 1e-6 || distance < 0.9 * m_Radius )
+      {
+      std::cerr << "Transform off the circle: " << transform << std::endl;
+      m_NumberOfErrors++;
+      }
+
+    if( transform.GetStartTime() < m_PreviousStartTime )
+      {
+      std::cerr << "Time stamps are not increasing" << std::endl;
+      m_NumberOfErrors++;
+      }
+    m_PreviousStartTime = transform.GetStartTime();
+    m_NumberOfTransforms++;
+    }
+
+  double          m_CenterX;
+  double          m_Radius;
+  unsigned long   m_NumberOfTransforms;
+  unsigned long   m_NumberOfErrors;
+  double          m_PreviousStartTime;
+};
+
+}
+
+int igstkTrackerAggregatorTest( int, char * [] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  typedef igstk::CircularSimulatedTracker     SourceTrackerType;
+  typedef igstk::SimulatedTrackerTool         SourceTrackerToolType;
+  typedef igstk::TrackerAggregator            AggregatorType;
+  typedef igstk::AggregatedTrackerTool        AggregatedToolType;
+  typedef TrackerAggregatorTest::TransformChecker  CheckerType;
+
+  const double radius = 10.0;
+
+  // Two trackers running at different rates, standing for an optical and an
+  // electromagnetic tracker
+  SourceTrackerType::Pointer opticalTracker = SourceTrackerType::New();
+  SourceTrackerType::Pointer emTracker = SourceTrackerType::New();
+
+  opticalTracker->SetRadius( radius );
+  opticalTracker->SetAngularSpeed( 90.0 );
+  opticalTracker->RequestOpen();
+  opticalTracker->RequestSetFrequency( 60.0 );
+
+  emTracker->SetRadius( radius );
+  emTracker->SetAngularSpeed( 45.0 );
+  emTracker->RequestOpen();
+  emTracker->RequestSetFrequency( 40.0 );
+
+  SourceTrackerToolType::Pointer opticalTool = SourceTrackerToolType::New();
+  opticalTool->RequestSetName( "Pointer" );
+  opticalTool->RequestConfigure();
+  opticalTool->RequestAttachToTracker( opticalTracker );
+
+  SourceTrackerToolType::Pointer emTool = SourceTrackerToolType::New();
+  emTool->RequestSetName( "Pointer" );
+  emTool->RequestConfigure();
+  emTool->RequestAttachToTracker( emTracker );
+
+  // The electromagnetic tracker is 100 mm away along X in the aggregator
+  // coordinate system
+  AggregatorType::Pointer aggregator = AggregatorType::New();
+  aggregator->AddTracker( opticalTracker );
+  aggregator->AddTracker( emTracker );
+
+  igstk::Transform registration;
+  igstk::Transform::VectorType translation;
+  translation[0] = 100.0;
+  translation[1] = 0.0;
+  translation[2] = 0.0;
+  registration.SetTranslation( translation, 0.1,
+                               igstk::TimeStamp::GetLongestPossibleTime() );
+  aggregator->SetTrackerRegistrationTransform( emTracker, registration );
+  aggregator->SetTrackerLatency( emTracker, 5.0 );
+
+  aggregator->RequestOpen();
+  aggregator->RequestSetFrequency( 60.0 );
+
+  AggregatedToolType::Pointer aggregatedOpticalTool =
+                                                 AggregatedToolType::New();
+  aggregatedOpticalTool->RequestSetSourceTrackerTool( opticalTracker,
+                                                      opticalTool );
+  aggregatedOpticalTool->RequestSetToolName( "OpticalPointer" );
+  aggregatedOpticalTool->RequestConfigure();
+  aggregatedOpticalTool->RequestAttachToTracker( aggregator );
+
+  AggregatedToolType::Pointer aggregatedEMTool = AggregatedToolType::New();
+  aggregatedEMTool->RequestSetSourceTrackerTool( emTracker, emTool );
+  aggregatedEMTool->RequestSetToolName( "EMPointer" );
+  aggregatedEMTool->RequestConfigure();
+  aggregatedEMTool->RequestAttachToTracker( aggregator );
+
+  CheckerType opticalChecker( 0.0, radius );
+  CheckerType emChecker( 100.0, radius );
+
+  aggregatedOpticalTool->GetCalibratedTransformChannel().AddMemberObserver<
+                     CheckerType, &CheckerType::Callback >( &opticalChecker );
+  aggregatedEMTool->GetCalibratedTransformChannel().AddMemberObserver<
+                     CheckerType, &CheckerType::Callback >( &emChecker );
+
+  // Starting the aggregator starts the source trackers
+  aggregator->RequestStartTracking();
+
+  for( unsigned int i = 0; i < 200; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 5 );
+    igstk::PulseGenerator::CheckTimeouts();
+    }
+
+  aggregator->RequestStopTracking();
+
+  aggregator->Print( std::cout );
+
+  std::cout << "Optical tool transforms: "
+            << opticalChecker.m_NumberOfTransforms << std::endl;
+  std::cout << "EM tool transforms: "
+            << emChecker.m_NumberOfTransforms << std::endl;
+
+  int result = EXIT_SUCCESS;
+
+  if( opticalChecker.m_NumberOfTransforms == 0 ||
+      emChecker.m_NumberOfTransforms == 0 )
+    {
+    std::cerr << "No transform received from the aggregator" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( opticalChecker.m_NumberOfErrors > 0 ||
+      emChecker.m_NumberOfErrors > 0 )
+    {
+    result = EXIT_FAILURE;
+    }
+
+  // The source trackers stamp the samples with the RealTimeClock, so the
+  // estimated clock offsets are small
+  if( fabs( aggregator->GetTrackerClockOffset( opticalTracker ) ) > 50.0 ||
+      fabs( aggregator->GetTrackerClockOffset( emTracker ) ) > 50.0 )
+    {
+    std::cerr << "Unexpected clock offset" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  aggregatedOpticalTool->RequestDetachFromTracker();
+  aggregatedEMTool->RequestDetachFromTracker();
+
+  aggregator->RequestClose();
+  opticalTracker->RequestClose();
+  emTracker->RequestClose();
+
+  return result;
+}
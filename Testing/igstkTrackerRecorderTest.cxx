@@ -0,0 +1,224 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerRecorderTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <math.h>
+#include <iostream>
+
+#include "igstkRealTimeClock.h"
+#include "igstkPulseGenerator.h"
+#include "igstkCircularSimulatedTracker.h"
+#include "igstkSimulatedTrackerTool.h"
+#include "igstkTrackerRecorder.h"
+#include "igstkPlaybackTracker.h"
+
+namespace TrackerRecorderTest
+{
+
+/** Checks that the replayed tool is on the circle of the recorded
+ *  tracker */
+class CircleChecker
+{
+public:
+  CircleChecker( double radius )
+    {
+    m_Radius = radius;
+    m_NumberOfTransforms = 0;
+    m_NumberOfErrors = 0;
+    }
+
+  void Callback( const igstk::CoordinateSystemTransformToResult & result )
+    {
+    const igstk::Transform::VectorType & translation =
+                                       result.GetTransform().GetTranslation();
+    const double distance = sqrt( translation[0] * translation[0] +
+                                  translation[1] * translation[1] );
+
+    if( fabs( distance - m_Radius ) > 1e-6 )
+      {
+      std::cerr << "Replayed position off the circle: " << translation
+                << std::endl;
+      m_NumberOfErrors++;
+      }
+    m_NumberOfTransforms++;
+    }
+
+  double          m_Radius;
+  unsigned long   m_NumberOfTransforms;
+  unsigned long   m_NumberOfErrors;
+};
+
+}
+
+int igstkTrackerRecorderTest( int argc, char * argv[] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  if( argc < 2 )
+    {
+    std::cerr << "Error missing argument " << std::endl;
+    std::cerr << "Usage:  " << argv[0]
+              << " Output_Recording_File" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef igstk::CircularSimulatedTracker         TrackerType;
+  typedef igstk::SimulatedTrackerTool             TrackerToolType;
+  typedef igstk::TrackerRecorder                  RecorderType;
+  typedef igstk::PlaybackTracker                  PlaybackTrackerType;
+  typedef igstk::PlaybackTrackerTool              PlaybackTrackerToolType;
+  typedef TrackerRecorderTest::CircleChecker      CheckerType;
+
+  int result = EXIT_SUCCESS;
+
+  const double radius = 10.0;
+
+  // Record a simulated tracker
+  TrackerType::Pointer tracker = TrackerType::New();
+  tracker->SetRadius( radius );
+  tracker->SetAngularSpeed( 36.0 );
+  tracker->RequestOpen();
+  tracker->RequestSetFrequency( 100.0 );
+
+  TrackerToolType::Pointer trackerTool = TrackerToolType::New();
+  trackerTool->RequestSetName( "circle" );
+  trackerTool->RequestConfigure();
+  trackerTool->RequestAttachToTracker( tracker );
+
+  RecorderType::Pointer recorder = RecorderType::New();
+  recorder->SetIndexInterval( 16 );
+  recorder->AddTrackerTool( trackerTool );
+
+  if( !recorder->StartRecording( argv[1] ) )
+    {
+    std::cerr << "Could not create " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  tracker->RequestStartTracking();
+  for( unsigned int i = 0; i < 200; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 5 );
+    igstk::PulseGenerator::CheckTimeouts();
+    }
+  tracker->RequestStopTracking();
+
+  recorder->StopRecording();
+  recorder->Print( std::cout );
+
+  trackerTool->RequestDetachFromTracker();
+  tracker->RequestClose();
+
+  const unsigned long numberOfRecords = recorder->GetNumberOfRecords();
+  if( numberOfRecords < 32 || recorder->GetNumberOfDroppedRecords() > 0 )
+    {
+    std::cerr << "Unexpected number of records" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // Replay the recording
+  PlaybackTrackerType::Pointer player = PlaybackTrackerType::New();
+  player->SetFileName( argv[1] );
+  player->SetPlaybackSpeed( 0.0 );
+  player->RequestOpen();
+  player->RequestSetFrequency( 200.0 );
+  player->Print( std::cout );
+
+  if( player->GetNumberOfRecords() != numberOfRecords ||
+      player->GetNumberOfRecordedTools() != 1 ||
+      player->GetRecordedToolName( 0 ) != "circle" )
+    {
+    std::cerr << "The recording was not read back" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  PlaybackTrackerToolType::Pointer playbackTool =
+                                             PlaybackTrackerToolType::New();
+  playbackTool->RequestSetToolName( "circle" );
+  playbackTool->RequestConfigure();
+  playbackTool->RequestAttachToTracker( player );
+
+  CheckerType checker( radius );
+  playbackTool->GetCalibratedTransformChannel().AddMemberObserver<
+                              CheckerType, &CheckerType::Callback >( &checker );
+
+  // Seek to the middle of the recording: the first replayed record is the
+  // first one at or after that time
+  const double startTime = player->GetRecordingStartTime();
+  const double endTime = player->GetRecordingEndTime();
+  const double middleTime = 0.5 * ( startTime + endTime );
+
+  player->RequestStartTracking();
+  player->SeekToTime( middleTime );
+
+  for( unsigned int i = 0; i < 400 && !player->IsAtEnd(); i++ )
+    {
+    igstk::PulseGenerator::Sleep( 5 );
+    igstk::PulseGenerator::CheckTimeouts();
+
+    if( checker.m_NumberOfTransforms == 1 &&
+        ( player->GetPlaybackTime() < middleTime ||
+          player->GetPlaybackTime() > middleTime + 100.0 ) )
+      {
+      std::cerr << "Seek to " << middleTime << " replayed "
+                << player->GetPlaybackTime() << std::endl;
+      result = EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Replayed " << checker.m_NumberOfTransforms
+            << " transforms from the middle of the recording" << std::endl;
+
+  if( !player->IsAtEnd() || checker.m_NumberOfTransforms == 0 ||
+      checker.m_NumberOfTransforms >= numberOfRecords ||
+      checker.m_NumberOfErrors > 0 )
+    {
+    std::cerr << "The second half of the recording was not replayed"
+              << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // Seeking before the start rewinds the recording
+  player->SeekToTime( startTime - 1000.0 );
+  igstk::PulseGenerator::Sleep( 10 );
+  igstk::PulseGenerator::CheckTimeouts();
+  if( player->GetPlaybackTime() != startTime )
+    {
+    std::cerr << "Rewind replayed " << player->GetPlaybackTime()
+              << " instead of " << startTime << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // Seeking after the end stops the playback
+  player->SeekToTime( endTime + 1000.0 );
+  if( !player->IsAtEnd() )
+    {
+    std::cerr << "Seek after the end did not stop the playback" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  player->RequestStopTracking();
+  playbackTool->RequestDetachFromTracker();
+  player->RequestClose();
+
+  return result;
+}
@@ -26,6 +26,9 @@
 
 #include "igstkTracker.h"
 #include "igstkTrackerTool.h"
+#include "igstkSimulatedTracker.h"
+#include "igstkSimulatedTrackerTool.h"
+#include "igstkTransformObserver.h"
 
 #define igstkEventOccurredMacro( name, EventType ) \
   class name##EventOccurredObserver : public ::itk::Command \
@@ -245,6 +248,130 @@ void DummyTrackerTool::RequestAttachToTracker( DummyTracker *  tracker )
 }
 
 
+/** Simulated tracker that places the tool named "A" at x = 10, "B" at
+ *  x = 20, and so on, writing the transforms through the tool slots. */
+class SlotTestingTracker : public SimulatedTracker
+{
+public:
+
+  /** Macro with standard traits declarations. */
+  igstkStandardClassTraitsMacro( SlotTestingTracker, SimulatedTracker )
+
+  typedef Superclass::TrackerToolSlotType     TrackerToolSlotType;
+
+  static TrackerToolSlotType GetInvalidSlot()
+    {
+    return InvalidTrackerToolSlot;
+    }
+
+  TrackerToolSlotType GetSlot( const TrackerToolType * trackerTool ) const
+    {
+    return this->GetTrackerToolSlot( trackerTool );
+    }
+
+  TrackerToolSlotType GetNumberOfSlots() const
+    {
+    return this->GetNumberOfTrackerToolSlots();
+    }
+
+  const TrackerToolType * GetToolInSlot( TrackerToolSlotType slot ) const
+    {
+    return this->GetTrackerToolInSlot( slot );
+    }
+
+  /** Position of a tool along x, from its name */
+  static double GetToolPosition( const TrackerToolType * trackerTool )
+    {
+    return 10.0 * ( trackerTool->GetTrackerToolIdentifier()[0] - 'A' + 1 );
+    }
+
+protected:
+
+  SlotTestingTracker():m_StateMachine(this)
+    {
+    }
+
+  ~SlotTestingTracker()
+    {
+    }
+
+  ResultType
+  VerifyTrackerToolInformation(
+    const TrackerToolType * itkNotUsed(trackerTool) )
+    {
+    return SUCCESS;
+    }
+
+  ResultType
+  AddTrackerToolToInternalDataContainers(
+    const TrackerToolType * itkNotUsed(trackerTool) )
+    {
+    return SUCCESS;
+    }
+
+  ResultType
+  RemoveTrackerToolFromInternalDataContainers(
+    const TrackerToolType * itkNotUsed(trackerTool) )
+    {
+    return SUCCESS;
+    }
+
+  ResultType InternalUpdateStatus( void )
+    {
+    const TrackerToolSlotType numberOfSlots =
+                                        this->GetNumberOfTrackerToolSlots();
+    for( TrackerToolSlotType slot = 0; slot < numberOfSlots; slot++ )
+      {
+      const TrackerToolType * trackerTool = this->GetTrackerToolInSlot( slot );
+      if( !trackerTool )
+        {
+        continue;
+        }
+
+      TransformType::VectorType position;
+      position[0] = GetToolPosition( trackerTool );
+      position[1] = 0.0;
+      position[2] = 0.0;
+
+      TransformType transform;
+      transform.SetTranslation( position, 0.1, this->GetValidityTime() );
+
+      this->SetTrackerToolRawTransform( slot, transform );
+      this->SetTrackerToolTransformUpdate( slot, true );
+      }
+
+    return SUCCESS;
+    }
+
+  ResultType InternalThreadedUpdateStatus( void )
+    {
+    return SUCCESS;
+    }
+};
+
+/** Translation along x from a tool to another, once the tracker has
+ *  updated them, or a huge value if it is not available */
+double GetTranslationTo( TrackerTool * trackerTool, TrackerTool * target )
+{
+  TransformObserver::Pointer observer = TransformObserver::New();
+  observer->ObserveTransformEventsFrom( trackerTool );
+
+  for( int i = 0; i < 20; i++ )
+    {
+    PulseGenerator::Sleep( 10 );
+    PulseGenerator::CheckTimeouts();
+    }
+
+  observer->Clear();
+  trackerTool->RequestComputeTransformTo( target );
+  if( !observer->GotTransform() || !observer->GetTransform().IsValidNow() )
+    {
+    return 1e9;
+    }
+  return observer->GetTransform().GetTranslation()[0];
+}
+
+
 }
 
 }
@@ -306,9 +433,149 @@ int igstkTrackerTest( int, char * [] )
 
   tracker->RequestStartTracking();
   tracker->RequestStopTracking();
+
+  // The tracking thread paced at 50 Hz reads about 25 times in 500 ms
+  tracker->SetThreadingEnabled( true );
+  tracker->SetTrackingLoopPacing( TrackerType::FixedRateTrackingLoop );
+  tracker->SetTrackingLoopFrequency( 50 );
+  tracker->RequestStartTracking();
+  igstk::PulseGenerator::Sleep( 500 );
+  tracker->RequestStopTracking();
+
+  const unsigned long reads = tracker->GetNumberOfTrackingLoopReads();
+  std::cout << "Paced reads: " << reads << ", avoided reads: "
+            << tracker->GetNumberOfAvoidedReads() << ", CPU time per read: "
+            << tracker->GetCPUTimePerRead() << " ms" << std::endl;
+  if( reads < 10 || reads > 40 || tracker->GetNumberOfAvoidedReads() == 0 )
+    {
+    std::cerr << "Error in the pacing of the tracking thread" << std::endl;
+    return EXIT_FAILURE;
+    }
+
   tracker->RequestClose();
 
   std::cout << tracker << std::endl;
 
+  // Tracker tool slots
+  typedef igstk::TrackerTest::SlotTestingTracker  SlotTrackerType;
+  typedef igstk::SimulatedTrackerTool             SimulatedToolType;
+
+  SlotTrackerType::Pointer slotTracker = SlotTrackerType::New();
+  slotTracker->SetThreadingEnabled( false );
+  slotTracker->RequestOpen();
+  slotTracker->RequestSetFrequency( 50 );
+
+  const char * toolNames[] = { "A", "B", "C", "D" };
+  SimulatedToolType::Pointer tools[4];
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    tools[i] = SimulatedToolType::New();
+    tools[i]->RequestSetName( toolNames[i] );
+    tools[i]->RequestConfigure();
+    }
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    tools[i]->RequestAttachToTracker( slotTracker );
+    if( slotTracker->GetSlot( tools[i] ) != i )
+      {
+      std::cerr << "Tool " << toolNames[i] << " got slot "
+                << slotTracker->GetSlot( tools[i] ) << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // the slot of a detached tool stays free until another tool takes it
+  tools[1]->RequestDetachFromTracker();
+  if( slotTracker->GetSlot( tools[1] ) != SlotTrackerType::GetInvalidSlot() ||
+      slotTracker->GetNumberOfSlots() != 3 ||
+      slotTracker->GetToolInSlot( 1 ) != NULL )
+    {
+    std::cerr << "The slot of a detached tool was not freed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  tools[3]->RequestAttachToTracker( slotTracker );
+  if( slotTracker->GetSlot( tools[3] ) != 1 ||
+      slotTracker->GetNumberOfSlots() != 3 )
+    {
+    std::cerr << "The free slot was not reused" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the free slots at the end are trimmed
+  tools[2]->RequestDetachFromTracker();
+  if( slotTracker->GetNumberOfSlots() != 2 )
+    {
+    std::cerr << "The last slot was not trimmed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  tools[3]->RequestDetachFromTracker();
+  tools[0]->RequestDetachFromTracker();
+  if( slotTracker->GetNumberOfSlots() != 0 )
+    {
+    std::cerr << "The free slots were not trimmed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a reattached tool gets a valid slot
+  tools[0]->RequestAttachToTracker( slotTracker );
+  tools[1]->RequestAttachToTracker( slotTracker );
+  tools[2]->RequestAttachToTracker( slotTracker );
+  if( slotTracker->GetSlot( tools[0] ) != 0 ||
+      slotTracker->GetSlot( tools[1] ) != 1 ||
+      slotTracker->GetSlot( tools[2] ) != 2 )
+    {
+    std::cerr << "Reattached tools did not get valid slots" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the tools are tracked relative to the reference tool
+  slotTracker->RequestSetReferenceTool( tools[0] );
+  slotTracker->RequestStartTracking();
+  const double referencePosition =
+                         SlotTrackerType::GetToolPosition( tools[0] );
+  double translation =
+    igstk::TrackerTest::GetTranslationTo( tools[2], tools[0] );
+  if( fabs( translation - ( SlotTrackerType::GetToolPosition( tools[2] ) -
+                            referencePosition ) ) > 1e-6 )
+    {
+    std::cerr << "Wrong translation to the reference tool: "
+              << translation << std::endl;
+    return EXIT_FAILURE;
+    }
+  slotTracker->RequestStopTracking();
+
+  // moving the other tools to other slots keeps the reference
+  tools[1]->RequestDetachFromTracker();
+  tools[3]->RequestAttachToTracker( slotTracker );
+  tools[2]->RequestDetachFromTracker();
+  slotTracker->RequestStartTracking();
+  translation = igstk::TrackerTest::GetTranslationTo( tools[3], tools[0] );
+  if( fabs( translation - ( SlotTrackerType::GetToolPosition( tools[3] ) -
+                            referencePosition ) ) > 1e-6 )
+    {
+    std::cerr << "The reference tool was lost when the slots changed"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  slotTracker->RequestStopTracking();
+
+  // as well as detaching and reattaching the reference tool itself
+  tools[0]->RequestDetachFromTracker();
+  tools[0]->RequestAttachToTracker( slotTracker );
+  slotTracker->RequestStartTracking();
+  translation = igstk::TrackerTest::GetTranslationTo( tools[3], tools[0] );
+  if( fabs( translation - ( SlotTrackerType::GetToolPosition( tools[3] ) -
+                            referencePosition ) ) > 1e-6 )
+    {
+    std::cerr << "The reattached reference tool was not applied"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  slotTracker->RequestStopTracking();
+  slotTracker->RequestClose();
+
    return EXIT_SUCCESS;
 }
@@ -0,0 +1,277 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolFilterTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <math.h>
+#include <iostream>
+
+#include "igstkRealTimeClock.h"
+#include "igstkPulseGenerator.h"
+#include "igstkCircularSimulatedTracker.h"
+#include "igstkSimulatedTrackerTool.h"
+#include "igstkTrackerToolMovingAverageFilter.h"
+#include "igstkTrackerToolOneEuroFilter.h"
+#include "igstkTrackerToolExponentialFilter.h"
+
+namespace TrackerToolFilterTest
+{
+
+/** Deterministic noise uniformly distributed in [-1,1] */
+class NoiseGenerator
+{
+public:
+  NoiseGenerator() : m_State( 12345 ) {}
+
+  double GetValue()
+    {
+    m_State = m_State * 1103515245UL + 12345UL;
+    return ( ( m_State >> 8 ) & 0xFFFF ) / 32767.5 - 1.0;
+    }
+
+private:
+  unsigned long m_State;
+};
+
+igstk::Transform GetPose( double x, double angle, double time )
+{
+  igstk::Transform::VectorType translation;
+  translation[0] = x;
+  translation[1] = 20.0;
+  translation[2] = -50.0;
+
+  igstk::Transform::VersorType rotation;
+  rotation.Set( 0.0, sin( 0.5 * angle ), 0.0, cos( 0.5 * angle ) );
+
+  igstk::Transform pose;
+  pose.SetTranslationAndRotation( translation, rotation, 0.1,
+                                  time, time + 100.0 );
+  return pose;
+}
+
+/** Feeds a tool at rest with jitter, then a step. Checks that the jitter
+ *  is reduced and that the filter converges to the new position. */
+int TestFilter( igstk::TrackerToolFilter * filter, const char * name )
+{
+  NoiseGenerator noise;
+  igstk::Transform output;
+
+  double inputSquaredError = 0.0;
+  double outputSquaredError = 0.0;
+  double time = 0.0;
+
+  for( unsigned int i = 0; i < 300; i++ )
+    {
+    time = 10.0 * i;
+    const double jitter = noise.GetValue();
+    filter->Filter( GetPose( jitter, 0.01 * jitter, time ), output );
+
+    // Skip the first samples, where the filter has little history
+    if( i >= 20 )
+      {
+      const double x = output.GetTranslation()[0];
+      inputSquaredError += jitter * jitter;
+      outputSquaredError += x * x;
+      }
+    }
+
+  int result = EXIT_SUCCESS;
+
+  const double ratio = sqrt( outputSquaredError / inputSquaredError );
+  std::cout << name << ": jitter reduced by a factor "
+            << 1.0 / ratio << std::endl;
+  if( ratio > 0.6 )
+    {
+    std::cerr << name << " does not reduce the jitter" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  for( unsigned int i = 0; i < 200; i++ )
+    {
+    time += 10.0;
+    filter->Filter( GetPose( 10.0, 0.5, time ), output );
+    }
+
+  if( !output.IsNumericallyEquivalent( GetPose( 10.0, 0.5, time ), 0.01 ) )
+    {
+    std::cerr << name << " does not converge: " << output << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( output.GetStartTime() != time ||
+      output.GetExpirationTime() != time + 100.0 )
+    {
+    std::cerr << name << " changes the validity period" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // After a gap, the filter restarts from the new sample
+  time += 1000.0;
+  filter->Filter( GetPose( -10.0, 0.0, time ), output );
+  if( !output.IsNumericallyEquivalent( GetPose( -10.0, 0.0, time ), 1e-6 ) )
+    {
+    std::cerr << name << " did not restart after a gap" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  return result;
+}
+
+/** Checks that the filtered tool stays close to the circle of the
+ *  simulated tracker */
+class CircleChecker
+{
+public:
+  CircleChecker( double radius )
+    {
+    m_Radius = radius;
+    m_NumberOfTransforms = 0;
+    m_NumberOfErrors = 0;
+    }
+
+  void Callback( const igstk::CoordinateSystemTransformToResult & result )
+    {
+    const igstk::Transform::VectorType & translation =
+                                       result.GetTransform().GetTranslation();
+    const double distance = sqrt( translation[0] * translation[0] +
+                                  translation[1] * translation[1] );
+
+    // Smoothed positions lag behind, inside the circle
+    if( distance > m_Radius + 1e-6 || distance < 0.8 * m_Radius )
+      {
+      std::cerr << "Filtered position off the circle: " << translation
+                << std::endl;
+      m_NumberOfErrors++;
+      }
+    m_NumberOfTransforms++;
+    }
+
+  double          m_Radius;
+  unsigned long   m_NumberOfTransforms;
+  unsigned long   m_NumberOfErrors;
+};
+
+}
+
+int igstkTrackerToolFilterTest( int, char * [] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  typedef igstk::TrackerToolMovingAverageFilter   MovingAverageFilterType;
+  typedef igstk::TrackerToolOneEuroFilter         OneEuroFilterType;
+  typedef igstk::TrackerToolExponentialFilter     ExponentialFilterType;
+  typedef TrackerToolFilterTest::CircleChecker    CheckerType;
+
+  int result = EXIT_SUCCESS;
+
+  MovingAverageFilterType::Pointer movingAverage =
+                                            MovingAverageFilterType::New();
+  movingAverage->SetWindowSize( 9 );
+  movingAverage->Print( std::cout );
+
+  OneEuroFilterType::Pointer oneEuro = OneEuroFilterType::New();
+  oneEuro->Print( std::cout );
+
+  ExponentialFilterType::Pointer exponential = ExponentialFilterType::New();
+  exponential->SetTimeConstant( 40.0 );
+  exponential->Print( std::cout );
+
+  if( TrackerToolFilterTest::TestFilter( movingAverage,
+                                   "MovingAverage" ) != EXIT_SUCCESS ||
+      TrackerToolFilterTest::TestFilter( oneEuro,
+                                   "OneEuro" ) != EXIT_SUCCESS ||
+      TrackerToolFilterTest::TestFilter( exponential,
+                                   "Exponential" ) != EXIT_SUCCESS )
+    {
+    result = EXIT_FAILURE;
+    }
+
+  // The same filters in the pipeline of a tracker
+  typedef igstk::CircularSimulatedTracker     TrackerType;
+  typedef igstk::SimulatedTrackerTool         TrackerToolType;
+
+  const double radius = 10.0;
+
+  TrackerType::Pointer tracker = TrackerType::New();
+  tracker->SetRadius( radius );
+  tracker->SetAngularSpeed( 36.0 );
+  tracker->RequestOpen();
+  tracker->RequestSetFrequency( 60.0 );
+
+  igstk::TrackerToolFilter * filters[3] =
+    { movingAverage, oneEuro, exponential };
+  TrackerToolType::Pointer tools[3];
+  CheckerType checker0( radius );
+  CheckerType checker1( radius );
+  CheckerType checker2( radius );
+  CheckerType * checkers[3] = { &checker0, &checker1, &checker2 };
+  const char * names[3] = { "MovingAverage", "OneEuro", "Exponential" };
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    filters[i]->Reset();
+
+    tools[i] = TrackerToolType::New();
+    tools[i]->RequestSetName( names[i] );
+    tools[i]->SetFilter( filters[i] );
+    tools[i]->RequestConfigure();
+    tools[i]->RequestAttachToTracker( tracker );
+    tools[i]->GetCalibratedTransformChannel().AddMemberObserver<
+                          CheckerType, &CheckerType::Callback >( checkers[i] );
+    }
+
+  tracker->RequestStartTracking();
+
+  for( unsigned int i = 0; i < 200; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 5 );
+    igstk::PulseGenerator::CheckTimeouts();
+
+    // The parameters can be changed while tracking
+    if( i == 100 )
+      {
+      movingAverage->SetWindowSize( 4 );
+      oneEuro->SetBeta( 0.1 );
+      exponential->SetTimeConstant( 20.0 );
+      }
+    }
+
+  tracker->RequestStopTracking();
+
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    std::cout << names[i] << " in the tracker: "
+              << checkers[i]->m_NumberOfTransforms << " transforms"
+              << std::endl;
+
+    if( checkers[i]->m_NumberOfTransforms == 0 ||
+        checkers[i]->m_NumberOfErrors > 0 )
+      {
+      result = EXIT_FAILURE;
+      }
+
+    tools[i]->RequestDetachFromTracker();
+    }
+
+  tracker->RequestClose();
+
+  return result;
+}
@@ -0,0 +1,143 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkTrackerToolPredictorTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <math.h>
+#include <iostream>
+
+#include "igstkTrackerToolPredictor.h"
+#include "igstkRealTimeClock.h"
+
+namespace TrackerToolPredictorTest
+{
+
+/** Tool moving at constant linear and angular velocity */
+igstk::Transform GetPose( double time )
+{
+  const double angularSpeed = 0.002; // radians per millisecond
+
+  igstk::Transform::VectorType translation;
+  translation[0] = 10.0 + 0.05 * time;
+  translation[1] = -20.0 - 0.02 * time;
+  translation[2] = 5.0;
+
+  igstk::Transform::VersorType rotation;
+  rotation.Set( 0.0, 0.0, sin( 0.5 * angularSpeed * time ),
+                cos( 0.5 * angularSpeed * time ) );
+
+  igstk::Transform pose;
+  pose.SetTranslationAndRotation( translation, rotation, 0.1,
+                                  time, time + 100.0 );
+  return pose;
+}
+
+}
+
+int igstkTrackerToolPredictorTest( int, char * [] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  typedef igstk::TrackerToolPredictor   PredictorType;
+
+  PredictorType::Pointer predictor = PredictorType::New();
+  predictor->SetPredictionHorizon( 60.0 );
+  predictor->GetPredictionHorizon(); // coverage
+
+  const double samplingPeriod = 10.0;
+  const double tolerance = 1e-3;
+
+  int result = EXIT_SUCCESS;
+
+  igstk::Transform prediction;
+
+  // Constant velocities: the residuals vanish and the prediction is exact
+  double time = 0.0;
+  for( unsigned int i = 0; i < 200; i++ )
+    {
+    time = i * samplingPeriod;
+    predictor->Predict( TrackerToolPredictorTest::GetPose( time ),
+                        time, prediction );
+    }
+
+  const igstk::Transform expected =
+                  TrackerToolPredictorTest::GetPose( time + 60.0 );
+
+  if( !prediction.IsNumericallyEquivalent( expected, tolerance ) )
+    {
+    std::cerr << "Wrong prediction: " << prediction
+              << "instead of " << expected << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( prediction.GetStartTime() != time ||
+      prediction.GetExpirationTime() != time + 100.0 )
+    {
+    std::cerr << "The prediction must keep the validity of the sample"
+              << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( predictor->GetTranslationResidual() > tolerance ||
+      predictor->GetRotationResidual() > tolerance )
+    {
+    std::cerr << "Residuals should vanish: "
+              << predictor->GetTranslationResidual() << " "
+              << predictor->GetRotationResidual() << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( predictor->GetNumberOfSamples() != 200 )
+    {
+    std::cerr << "Wrong number of samples: "
+              << predictor->GetNumberOfSamples() << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // Extrapolation is limited to the maximum prediction interval
+  predictor->SetMaximumPredictionInterval( 20.0 );
+  predictor->Predict( TrackerToolPredictorTest::GetPose( time ),
+                      time + 500.0, prediction );
+
+  if( !prediction.IsNumericallyEquivalent(
+         TrackerToolPredictorTest::GetPose( time + 20.0 ), tolerance ) )
+    {
+    std::cerr << "The prediction interval is not limited" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // After a long interruption, the filter restarts from the sample
+  time += 2000.0;
+  predictor->Predict( TrackerToolPredictorTest::GetPose( time ),
+                      time, prediction );
+
+  if( predictor->GetNumberOfSamples() != 1 ||
+      !prediction.IsNumericallyEquivalent(
+         TrackerToolPredictorTest::GetPose( time ), tolerance ) )
+    {
+    std::cerr << "The filter did not restart" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  predictor->Print( std::cout );
+
+  return result;
+}
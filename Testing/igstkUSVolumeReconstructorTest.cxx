@@ -0,0 +1,164 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkUSVolumeReconstructorTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <iostream>
+#include <string.h>
+
+#include "igstkUSVolumeReconstructor.h"
+#include "igstkPlaybackVideoImagerTool.h"
+
+namespace USVolumeReconstructorTest
+{
+
+igstkObserverObjectMacro( USImage,
+                          igstk::USVolumeReconstructor::ImageModifiedEvent,
+                          igstk::USImageObject )
+
+igstkObserverConstObjectMacro( ITKImage,
+                               igstk::USImageObject::ITKImageModifiedEvent,
+                               igstk::USImageObject::ImageType )
+
+/** Value of a voxel of the reconstructed volume */
+int GetVoxel( igstk::USVolumeReconstructor * reconstructor,
+              long x, long y, long z )
+{
+  USImageObserver::Pointer usImageObserver = USImageObserver::New();
+  reconstructor->AddObserver(
+    igstk::USVolumeReconstructor::ImageModifiedEvent(), usImageObserver );
+  reconstructor->RequestGetImage();
+  if( !usImageObserver->GotUSImage() )
+    {
+    return -1;
+    }
+
+  ITKImageObserver::Pointer itkImageObserver = ITKImageObserver::New();
+  usImageObserver->GetUSImage()->AddObserver(
+    igstk::USImageObject::ITKImageModifiedEvent(), itkImageObserver );
+  usImageObserver->GetUSImage()->RequestGetITKImage();
+  if( !itkImageObserver->GotITKImage() )
+    {
+    return -1;
+    }
+
+  igstk::USImageObject::ImageType::IndexType index;
+  index[0] = x;
+  index[1] = y;
+  index[2] = z;
+  return itkImageObserver->GetITKImage()->GetPixel( index );
+}
+
+/** Insert frames parallel to the xy plane every two millimeters along z */
+void Sweep( igstk::USVolumeReconstructor * reconstructor,
+            igstk::Frame * frame, double firstZ )
+{
+  igstk::Transform::VectorType translation;
+  igstk::Transform::VersorType rotation;
+  rotation.SetIdentity();
+
+  for( double z = firstZ; z < 30.0; z += 2.0 )
+    {
+    translation[0] = 4.0;
+    translation[1] = 4.0;
+    translation[2] = z;
+    igstk::Transform probeToReference;
+    probeToReference.SetTranslationAndRotation( translation, rotation, 0.0,
+                          igstk::TimeStamp::GetLongestPossibleTime() );
+    reconstructor->InsertFrame( frame, probeToReference );
+    }
+}
+
+}
+
+int igstkUSVolumeReconstructorTest( int, char * [] )
+{
+  typedef igstk::USVolumeReconstructor    ReconstructorType;
+  using USVolumeReconstructorTest::GetVoxel;
+  using USVolumeReconstructorTest::Sweep;
+
+  int result = EXIT_SUCCESS;
+
+  // Frames of constant intensity, allocated by a video imager tool
+  unsigned int dimensions[3] = { 32, 32, 1 };
+  igstk::PlaybackVideoImagerTool::Pointer tool =
+                                        igstk::PlaybackVideoImagerTool::New();
+  tool->SetFrameDimensions( dimensions );
+  igstk::Frame * frame = tool->GetLatestFrame();
+  memset( frame->GetImagePtr(), 100, 32 * 32 );
+
+  const double origin[3] = { 0.0, 0.0, 0.0 };
+  const double spacing[3] = { 1.0, 1.0, 1.0 };
+  const unsigned int size[3] = { 40, 40, 40 };
+  const double imageSpacing[2] = { 1.0, 1.0 };
+
+  ReconstructorType::Pointer reconstructor = ReconstructorType::New();
+  reconstructor->SetImageSpacing( imageSpacing );
+  reconstructor->SetOutputGeometry( origin, spacing, size );
+
+  // Nearest neighbor splatting leaves a hole between the frames, filled
+  // by Finalize()
+  reconstructor->SetInterpolation(
+                             ReconstructorType::NearestNeighborInterpolation );
+  Sweep( reconstructor, frame, 4.0 );
+
+  if( reconstructor->GetNumberOfInsertedFrames() != 13 ||
+      GetVoxel( reconstructor, 10, 10, 4 ) != 100 ||
+      GetVoxel( reconstructor, 10, 10, 5 ) != 0 )
+    {
+    std::cerr << "Incremental nearest neighbor splatting failed" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  reconstructor->Finalize();
+  if( GetVoxel( reconstructor, 10, 10, 5 ) != 100 ||
+      GetVoxel( reconstructor, 1, 1, 1 ) != 0 )
+    {
+    std::cerr << "Hole filling failed" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // Linear splatting between two voxels keeps the intensity, and the
+  // volume is only computed by Finalize() when not incremental
+  reconstructor->Reset();
+  reconstructor->SetInterpolation( ReconstructorType::LinearInterpolation );
+  reconstructor->SetIncremental( false );
+  reconstructor->SetHoleFillingRadius( 0 );
+  Sweep( reconstructor, frame, 4.5 );
+
+  if( GetVoxel( reconstructor, 10, 10, 5 ) != 0 )
+    {
+    std::cerr << "The volume was updated before Finalize()" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  reconstructor->Finalize();
+  if( GetVoxel( reconstructor, 10, 10, 4 ) != 100 ||
+      GetVoxel( reconstructor, 10, 10, 5 ) != 100 ||
+      GetVoxel( reconstructor, 38, 38, 5 ) != 0 )
+    {
+    std::cerr << "Linear splatting failed" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  reconstructor->Print( std::cout );
+
+  return result;
+}
@@ -22,6 +22,7 @@
 #endif
 
 #include <iostream>
+#include <vector>
 #include "igstkLandmark3DRegistration.h"
 #include "igstkLogger.h"
 #include "itkStdStreamLogOutput.h"
@@ -31,6 +32,8 @@
 #include "igstkEvents.h"
 #include "igstkVideoImager.h"
 #include "igstkVideoImagerTool.h"
+#include "igstkPulseGenerator.h"
+#include "igstkRealTimeClock.h"
 
 namespace igstk
 {
@@ -140,6 +143,78 @@ void DummyVideoImagerTool::RequestAttachToVideoImager(DummyVideoImager*  imager
 {
   this->VideoImagerTool::RequestAttachToVideoImager( imager );
 }
+
+/** Imager stamping its frames when they are acquired, and writing the
+ *  number of the frame in their first pixel */
+class StampingVideoImager : public igstk::VideoImager
+{
+public:
+
+  igstkStandardClassTraitsMacro( StampingVideoImager, igstk::VideoImager )
+
+  typedef VideoImager::ResultType   ResultType;
+
+  /** Acquisition times of the frames */
+  const std::vector< double > & GetFrameTimes() const
+    {
+    return m_FrameTimes;
+    }
+
+protected:
+
+  StampingVideoImager():m_StateMachine(this)
+    {
+    this->SetThreadingEnabled( false );
+    }
+  ~StampingVideoImager() {}
+
+  virtual ResultType InternalOpen( void ) { return SUCCESS; }
+  virtual ResultType InternalClose( void ) { return SUCCESS; }
+  virtual ResultType InternalStartImaging( void ) { return SUCCESS; }
+  virtual ResultType InternalStopImaging( void ) { return SUCCESS; }
+  virtual ResultType InternalReset( void ) { return SUCCESS; }
+  virtual ResultType InternalThreadedUpdateStatus( void ) { return SUCCESS; }
+
+  virtual ResultType InternalUpdateStatus( void )
+    {
+    VideoImagerToolsContainerType::const_iterator it =
+                                   this->GetVideoImagerToolContainer().begin();
+    for( ; it != this->GetVideoImagerToolContainer().end(); ++it )
+      {
+      FrameType * frame = this->GetVideoImagerToolFrame( it->second );
+      unsigned char * image =
+                       static_cast< unsigned char * >( frame->GetImagePtr() );
+      image[0] = static_cast< unsigned char >( m_FrameTimes.size() );
+      frame->SetTimeToExpiration( this->GetValidityTime() );
+
+      this->ReportImagingToolStreaming( it->second );
+      this->SetVideoImagerToolFrame( it->second, frame );
+      this->SetVideoImagerToolUpdate( it->second, true );
+      }
+    m_FrameTimes.push_back( RealTimeClock::GetTimeStamp() );
+    return SUCCESS;
+    }
+
+  virtual ResultType VerifyVideoImagerToolInformation(
+                                                 const VideoImagerToolType * )
+    {
+    return SUCCESS;
+    }
+  virtual ResultType RemoveVideoImagerToolFromInternalDataContainers(
+                                                 const VideoImagerToolType * )
+    {
+    return SUCCESS;
+    }
+  virtual ResultType AddVideoImagerToolToInternalDataContainers(
+                                                 const VideoImagerToolType * )
+    {
+    return SUCCESS;
+    }
+
+private:
+
+  std::vector< double >   m_FrameTimes;
+};
    
 }
 }
@@ -186,5 +261,74 @@ int igstkVideoImagerTest( int , char * [] )
   videoImager->RemoveVideoImagerToolFromInternalDataContainers(videoImagerTool);
   videoImager->RequestClose();
 
+  // The frames keep the time stamp given by the imager, and the delay
+  // counts back from the latest frame
+  typedef igstk::VideoImagerTest::StampingVideoImager  StampingImagerType;
+
+  igstk::RealTimeClock::Initialize();
+
+  StampingImagerType::Pointer stampingImager = StampingImagerType::New();
+  stampingImager->RequestOpen();
+  stampingImager->RequestSetFrequency( 100 );
+
+  VideoImagerToolType::Pointer stampedTool = VideoImagerToolType::New();
+  unsigned int dims[3] = { 4, 4, 1 };
+  stampedTool->SetFrameDimensions( dims );
+  stampedTool->RequestConfigure();
+  stampedTool->VideoImagerTool::RequestAttachToVideoImager( stampingImager );
+
+  const unsigned int numberOfFrames = 10;
+  stampingImager->RequestStartImaging();
+  for( unsigned int i = 0; i < 200 &&
+       stampingImager->GetFrameTimes().size() < numberOfFrames; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 5 );
+    igstk::PulseGenerator::CheckTimeouts();
+    }
+  stampingImager->RequestStopImaging();
+
+  const std::vector< double > & frameTimes = stampingImager->GetFrameTimes();
+  if( frameTimes.size() < numberOfFrames )
+    {
+    std::cerr << "Only " << frameTimes.size() << " frames were acquired"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const unsigned int latest = frameTimes.size() - 1;
+  for( unsigned int delay = 0; delay < numberOfFrames; delay++ )
+    {
+    stampedTool->SetDelay( delay );
+    igstk::Frame * frame = stampedTool->GetTemporalCalibratedFrame();
+    const unsigned int frameNumber =
+                    static_cast< unsigned char * >( frame->GetImagePtr() )[0];
+    if( frameNumber != latest - delay )
+      {
+      std::cerr << "Delay " << delay << " gave frame " << frameNumber
+                << " instead of " << latest - delay << std::endl;
+      return EXIT_FAILURE;
+      }
+    if( frame->GetStartTime() > frameTimes[ latest - delay ] ||
+        ( latest - delay > 0 &&
+          frame->GetStartTime() <= frameTimes[ latest - delay - 1 ] ) )
+      {
+      std::cerr << "Frame " << frameNumber << " was stamped at "
+                << frame->GetStartTime() << " instead of its acquisition"
+                << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  stampedTool->SetDelay( 0 );
+  if( stampedTool->GetLatestFrame() !=
+      stampedTool->GetTemporalCalibratedFrame() )
+    {
+    std::cerr << "GetLatestFrame is not the newest frame" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  stampedTool->RequestDetachFromVideoImager();
+  stampingImager->RequestClose();
+
   return EXIT_SUCCESS;
 }
@@ -31,6 +31,8 @@
 #include "igstkEvents.h"
 #include "igstkVideoImager.h"
 #include "igstkVideoImagerTool.h"
+#include "igstkPulseGenerator.h"
+#include "igstkRealTimeClock.h"
 
 namespace igstk
 {
@@ -153,8 +155,65 @@ int igstkVideoImagerToolTest( int , char * [] )
 
   VideoImagerToolType::Pointer videoImagerTool = VideoImagerToolType::New();
 
+  igstk::RealTimeClock::Initialize();
+
   videoImagerTool->RequestConfigure();
   videoImagerTool->RequestAttachToVideoImager( videoImager );
 
+  // Frames acquired 10 ms apart, as an imager sets them
+  unsigned int dims[3] = { 4, 4, 1 };
+  videoImagerTool->SetFrameDimensions( dims );
+
+  const unsigned int numberOfFrames = 10;
+  igstk::Frame * frames[ numberOfFrames ];
+  double frameTimes[ numberOfFrames ];
+  for( unsigned int i = 0; i < numberOfFrames; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 10 );
+    frames[i] = videoImagerTool->GetInternalFrame();
+    frames[i]->SetTimeToExpiration( 100 );
+    frameTimes[i] = frames[i]->GetStartTime();
+    videoImagerTool->SetInternalFrame( frames[i] );
+    }
+
+  // Without a temporal offset, the frames are looked up by Delay whatever
+  // the time of the tracker sample
+  const unsigned int delay = 3;
+  videoImagerTool->SetDelay( delay );
+  if( videoImagerTool->GetTemporalCalibratedFrame( frameTimes[0] ) !=
+      frames[ numberOfFrames - 1 - delay ] ||
+      videoImagerTool->GetTemporalCalibratedFrame() !=
+      frames[ numberOfFrames - 1 - delay ] )
+    {
+    std::cerr << "GetTemporalCalibratedFrame did not use the delay"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A frame stamped t shows the scene at tracker time t - offset
+  const double offset = 25.0;
+  videoImagerTool->SetTemporalOffset( offset );
+  for( unsigned int i = 0; i < numberOfFrames; i++ )
+    {
+    const double trackerTime = frameTimes[i] - offset;
+    if( videoImagerTool->GetFrameAtTime( trackerTime ) != frames[i] ||
+        videoImagerTool->GetFrameAtTime( trackerTime + 5.0 ) != frames[i] ||
+        videoImagerTool->GetTemporalCalibratedFrame( trackerTime ) !=
+                                                                  frames[i] )
+      {
+      std::cerr << "Wrong frame at the time of frame " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Without a tracker time, the latest frame is used once the offset is set
+  if( videoImagerTool->GetTemporalCalibratedFrame() !=
+      frames[ numberOfFrames - 1 ] )
+    {
+    std::cerr << "GetTemporalCalibratedFrame did not return the latest frame"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,101 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkVideoTemporalCalibrationTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <iostream>
+#include <math.h>
+
+#include "igstkVideoTemporalCalibration.h"
+
+namespace VideoTemporalCalibrationTest
+{
+
+/** Motion of the probe along its principal direction, in millimeters */
+double Motion( double time )
+{
+  const double pi = 3.14159265358979;
+  return 20.0 * sin( 2.0 * pi * time / 1700.0 ) +
+         5.0 * sin( 2.0 * pi * time / 610.0 );
+}
+
+}
+
+int igstkVideoTemporalCalibrationTest( int, char * [] )
+{
+  typedef igstk::VideoTemporalCalibration   CalibrationType;
+  using VideoTemporalCalibrationTest::Motion;
+
+  int result = EXIT_SUCCESS;
+
+  CalibrationType::Pointer calibration = CalibrationType::New();
+  calibration->SetMaximumOffset( 200.0 );
+
+  if( calibration->Estimate() )
+    {
+    std::cerr << "Estimate() succeeded without samples" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // The tracker reports every 10 ms a motion along the diagonal of the
+  // xy plane
+  const double diagonal = sqrt( 0.5 );
+  for( unsigned int i = 0; i < 600; i++ )
+    {
+    const double time = i * 10.0;
+    CalibrationType::VectorType position;
+    position[0] = 100.0 + diagonal * Motion( time );
+    position[1] = -50.0 + diagonal * Motion( time );
+    position[2] = 30.0;
+    calibration->AddTrackerPosition( time, position );
+    }
+
+  // The frames arrive every 33 ms, stamped 37.3 ms late, and the motion is
+  // reversed and scaled to pixels in the images
+  const double offset = 37.3;
+  for( unsigned int i = 0; i < 180; i++ )
+    {
+    const double time = i * 33.0;
+    calibration->AddImagePosition( time + offset,
+                                   200.0 - 3.0 * Motion( time ) );
+    }
+
+  if( !calibration->Estimate() ||
+      fabs( calibration->GetTemporalOffset() - offset ) > 1.0 ||
+      calibration->GetCorrelation() < 0.99 )
+    {
+    std::cerr << "Wrong temporal offset: "
+              << calibration->GetTemporalOffset() << " instead of "
+              << offset << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  calibration->Print( std::cout );
+
+  calibration->Reset();
+  if( calibration->GetNumberOfTrackerSamples() != 0 ||
+      calibration->GetNumberOfImageSamples() != 0 )
+    {
+    std::cerr << "Reset() failed" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  return result;
+}
@@ -0,0 +1,299 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkVideoTrackingRecorderTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters
+// in the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <math.h>
+#include <iostream>
+
+#include "igstkRealTimeClock.h"
+#include "igstkPulseGenerator.h"
+#include "igstkCircularSimulatedTracker.h"
+#include "igstkSimulatedTrackerTool.h"
+#include "igstkPlaybackTracker.h"
+#include "igstkVideoTrackingRecorder.h"
+#include "igstkPlaybackVideoImager.h"
+
+namespace VideoTrackingRecorderTest
+{
+
+const unsigned int FrameWidth = 64;
+const unsigned int FrameHeight = 48;
+
+/** Imager producing frames whose pixels are a ramp starting at the number
+ *  of the frame */
+class PatternVideoImager : public igstk::VideoImager
+{
+public:
+
+  igstkStandardClassTraitsMacro( PatternVideoImager, igstk::VideoImager )
+
+protected:
+
+  PatternVideoImager():m_StateMachine(this)
+    {
+    this->SetThreadingEnabled( false );
+    m_FrameNumber = 0;
+    }
+  ~PatternVideoImager() {}
+
+  typedef igstk::VideoImager::ResultType  ResultType;
+
+  virtual ResultType InternalOpen( void ) { return SUCCESS; }
+  virtual ResultType InternalClose( void ) { return SUCCESS; }
+  virtual ResultType InternalStartImaging( void ) { return SUCCESS; }
+  virtual ResultType InternalStopImaging( void ) { return SUCCESS; }
+  virtual ResultType InternalReset( void ) { return SUCCESS; }
+  virtual ResultType InternalThreadedUpdateStatus( void ) { return SUCCESS; }
+
+  virtual ResultType InternalUpdateStatus( void )
+    {
+    VideoImagerToolsContainerType::const_iterator it =
+                                   this->GetVideoImagerToolContainer().begin();
+    for( ; it != this->GetVideoImagerToolContainer().end(); ++it )
+      {
+      FrameType * frame = this->GetVideoImagerToolFrame( it->second );
+      unsigned char * image =
+                       static_cast< unsigned char * >( frame->GetImagePtr() );
+      for( unsigned int i = 0; i < FrameWidth * FrameHeight; i++ )
+        {
+        image[i] =
+          static_cast< unsigned char >( m_FrameNumber + i / FrameWidth );
+        }
+      frame->SetTimeToExpiration( this->GetValidityTime() );
+
+      this->ReportImagingToolStreaming( it->second );
+      this->SetVideoImagerToolFrame( it->second, frame );
+      this->SetVideoImagerToolUpdate( it->second, true );
+      }
+    m_FrameNumber++;
+    return SUCCESS;
+    }
+
+  virtual ResultType VerifyVideoImagerToolInformation(
+                                                 const VideoImagerToolType * )
+    {
+    return SUCCESS;
+    }
+  virtual ResultType RemoveVideoImagerToolFromInternalDataContainers(
+                                                 const VideoImagerToolType * )
+    {
+    return SUCCESS;
+    }
+  virtual ResultType AddVideoImagerToolToInternalDataContainers(
+                                                 const VideoImagerToolType * )
+    {
+    return SUCCESS;
+    }
+
+private:
+
+  unsigned int  m_FrameNumber;
+};
+
+/** Whether a frame holds a ramp of PatternVideoImager */
+bool IsPatternFrame( igstk::Frame * frame )
+{
+  const unsigned char * image =
+                       static_cast< unsigned char * >( frame->GetImagePtr() );
+  for( unsigned int i = 0; i < FrameWidth * FrameHeight; i++ )
+    {
+    if( image[i] !=
+        static_cast< unsigned char >( image[0] + i / FrameWidth ) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+int igstkVideoTrackingRecorderTest( int argc, char * argv[] )
+{
+  igstk::RealTimeClock::Initialize();
+
+  if( argc < 2 )
+    {
+    std::cerr << "Error missing argument " << std::endl;
+    std::cerr << "Usage:  " << argv[0]
+              << " Output_Recording_Directory" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef VideoTrackingRecorderTest::PatternVideoImager  ImagerType;
+  typedef igstk::PlaybackVideoImagerTool                 ImagerToolType;
+  typedef igstk::PlaybackVideoImager                     PlaybackImagerType;
+  typedef igstk::CircularSimulatedTracker                TrackerType;
+  typedef igstk::SimulatedTrackerTool                    TrackerToolType;
+  typedef igstk::PlaybackTracker                         PlaybackTrackerType;
+  typedef igstk::PlaybackTrackerTool                 PlaybackTrackerToolType;
+  typedef igstk::VideoTrackingRecorder                   RecorderType;
+
+  int result = EXIT_SUCCESS;
+
+  unsigned int dimensions[3] = { VideoTrackingRecorderTest::FrameWidth,
+                                 VideoTrackingRecorderTest::FrameHeight, 1 };
+
+  // Record a simulated tracker and an imager together
+  TrackerType::Pointer tracker = TrackerType::New();
+  tracker->RequestOpen();
+  tracker->RequestSetFrequency( 100.0 );
+
+  TrackerToolType::Pointer trackerTool = TrackerToolType::New();
+  trackerTool->RequestSetName( "circle" );
+  trackerTool->RequestConfigure();
+  trackerTool->RequestAttachToTracker( tracker );
+
+  ImagerType::Pointer imager = ImagerType::New();
+  imager->RequestOpen();
+  imager->RequestSetFrequency( 30.0 );
+
+  ImagerToolType::Pointer imagerTool = ImagerToolType::New();
+  imagerTool->SetFrameDimensions( dimensions );
+  imagerTool->RequestSetToolName( "pattern" );
+  imagerTool->RequestConfigure();
+  imagerTool->RequestAttachToVideoImager( imager );
+
+  RecorderType::Pointer recorder = RecorderType::New();
+  recorder->SetFramesPerChunk( 8 );
+  recorder->AddTrackerTool( trackerTool );
+  recorder->AddVideoImagerTool( imagerTool );
+
+  if( !recorder->StartRecording( argv[1] ) )
+    {
+    std::cerr << "Could not create " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  tracker->RequestStartTracking();
+  imager->RequestStartImaging();
+  for( unsigned int i = 0; i < 200; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 5 );
+    igstk::PulseGenerator::CheckTimeouts();
+    }
+  imager->RequestStopImaging();
+  tracker->RequestStopTracking();
+
+  recorder->StopRecording();
+  recorder->Print( std::cout );
+
+  imagerTool->RequestDetachFromVideoImager();
+  imager->RequestClose();
+  trackerTool->RequestDetachFromTracker();
+  tracker->RequestClose();
+
+  if( recorder->GetNumberOfFrames() < 10 ||
+      recorder->GetNumberOfDroppedFrames() > 0 ||
+      recorder->GetTrackerRecorder()->GetNumberOfRecords() < 32 )
+    {
+    std::cerr << "Unexpected number of frames or records" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // Replay both streams on a shared clock
+  igstk::PlaybackClock::Pointer clock = igstk::PlaybackClock::New();
+
+  PlaybackTrackerType::Pointer trackerPlayer = PlaybackTrackerType::New();
+  trackerPlayer->SetFileName(
+    RecorderType::GetTrackingFileName( argv[1] ).c_str() );
+  trackerPlayer->SetPlaybackClock( clock );
+  trackerPlayer->RequestOpen();
+  trackerPlayer->RequestSetFrequency( 100.0 );
+
+  PlaybackTrackerToolType::Pointer playbackTrackerTool =
+                                             PlaybackTrackerToolType::New();
+  playbackTrackerTool->RequestSetToolName( "circle" );
+  playbackTrackerTool->RequestConfigure();
+  playbackTrackerTool->RequestAttachToTracker( trackerPlayer );
+
+  PlaybackImagerType::Pointer imagerPlayer = PlaybackImagerType::New();
+  imagerPlayer->SetDirectoryName( argv[1] );
+  imagerPlayer->SetPlaybackClock( clock );
+  imagerPlayer->RequestOpen();
+  imagerPlayer->RequestSetFrequency( 30.0 );
+
+  unsigned int recordedDimensions[3];
+  if( !imagerPlayer->GetRecordedFrameDimensions( "pattern",
+                                                 recordedDimensions ) ||
+      recordedDimensions[0] != dimensions[0] ||
+      recordedDimensions[1] != dimensions[1] ||
+      recordedDimensions[2] != dimensions[2] )
+    {
+    std::cerr << "The frame dimensions were not recorded" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  ImagerToolType::Pointer playbackImagerTool = ImagerToolType::New();
+  playbackImagerTool->SetFrameDimensions( dimensions );
+  playbackImagerTool->RequestSetToolName( "pattern" );
+  playbackImagerTool->RequestConfigure();
+  playbackImagerTool->RequestAttachToVideoImager( imagerPlayer );
+
+  clock->SeekToTime( trackerPlayer->GetRecordingStartTime() );
+  trackerPlayer->RequestStartTracking();
+  imagerPlayer->RequestStartImaging();
+
+  unsigned int numberOfFrames = 0;
+  double lastFrameTime = 0.0;
+  for( unsigned int i = 0; i < 200 && !trackerPlayer->IsAtEnd(); i++ )
+    {
+    igstk::PulseGenerator::Sleep( 5 );
+    igstk::PulseGenerator::CheckTimeouts();
+
+    igstk::Frame * frame = playbackImagerTool->GetLatestFrame();
+    if( frame && frame->GetStartTime() != lastFrameTime )
+      {
+      lastFrameTime = frame->GetStartTime();
+      numberOfFrames++;
+      if( !VideoTrackingRecorderTest::IsPatternFrame( frame ) )
+        {
+        std::cerr << "Replayed frame differs from the recorded ones"
+                  << std::endl;
+        result = EXIT_FAILURE;
+        }
+      }
+
+    // Both players follow the clock
+    if( trackerPlayer->GetPlaybackTime() > clock->GetRecordingTime() )
+      {
+      std::cerr << "The tracker is ahead of the clock" << std::endl;
+      result = EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Replayed " << numberOfFrames << " frames" << std::endl;
+
+  if( numberOfFrames < 5 )
+    {
+    std::cerr << "The frames were not replayed" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  imagerPlayer->RequestStopImaging();
+  playbackImagerTool->RequestDetachFromVideoImager();
+  imagerPlayer->RequestClose();
+  trackerPlayer->RequestStopTracking();
+  playbackTrackerTool->RequestDetachFromTracker();
+  trackerPlayer->RequestClose();
+
+  return result;
+}
@@ -0,0 +1,345 @@
+/*=========================================================================
+
+  Program:   Image Guided Surgery Software Toolkit
+  Module:    igstkViewRecorderTest.cxx
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+  Copyright (c) ISC  Insight Software Consortium.  All rights reserved.
+  See IGSTKCopyright.txt or http://www.igstk.org/copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#if defined(_MSC_VER)
+// Warning about: identifier was truncated to '255' characters in
+// the debug information (MVC6.0 Debug)
+#pragma warning( disable : 4786 )
+#endif
+
+#include <stdio.h>
+#include <iostream>
+#include <vector>
+
+#include "igstkView3D.h"
+#include "igstkOffscreenWidget.h"
+#include "igstkViewRecorder.h"
+#include "igstkVideoTrackingRecorder.h"
+#include "igstkPlaybackVideoImager.h"
+#include "igstkPlaybackClock.h"
+#include "igstkRealTimeClock.h"
+
+#include "vtkPNGReader.h"
+#include "vtkImageData.h"
+
+namespace ViewRecorderTest
+{
+
+const int FrameWidth = 64;
+const int FrameHeight = 48;
+
+/** The background of the n-th refresh is the gray level 10 n */
+void SetFrameNumber( igstk::View * view, unsigned int frameNumber )
+{
+  const double gray = frameNumber * 10.0 / 255.0;
+  view->SetRendererBackgroundColor( gray, gray, gray );
+}
+
+/** Frame number encoded in the first pixel of a frame */
+unsigned int GetFrameNumber( const unsigned char * pixels )
+{
+  return ( pixels[0] + 5 ) / 10;
+}
+
+/** Pulse until the view has rendered a new frame */
+bool WaitForFrame( igstk::OffscreenWidget * widget )
+{
+  const unsigned long numberOfFrames = widget->GetNumberOfFrames();
+  for( int i = 0; i < 100; i++ )
+    {
+    igstk::PulseGenerator::Sleep( 5 );
+    igstk::PulseGenerator::CheckTimeouts();
+    if( widget->GetNumberOfFrames() != numberOfFrames )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+}
+
+/** Record the refreshes of an offscreen view whose background changes
+ *  with every frame, replay the recording with a PlaybackVideoImager, and
+ *  check that all the frames come back, in order. */
+int igstkViewRecorderTest( int argc, char * argv[] )
+{
+  typedef igstk::View3D                        View3DType;
+  typedef igstk::OffscreenWidget               WidgetType;
+  typedef igstk::ViewRecorder                  RecorderType;
+  typedef igstk::VideoTrackingRecorder         VideoRecorderType;
+  typedef igstk::PlaybackVideoImager           PlaybackImagerType;
+  typedef igstk::PlaybackVideoImagerTool       PlaybackToolType;
+
+  std::cout << "Testing igstk::ViewRecorder" << std::endl;
+
+  if( argc < 3 )
+    {
+    std::cerr << "Error missing argument " << std::endl;
+    std::cerr << "Usage:  " << argv[0]
+              << " Output_Recording_Directory Output_Screen_Shot"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  igstk::RealTimeClock::Initialize();
+
+  int result = EXIT_SUCCESS;
+
+  View3DType::Pointer view3D = View3DType::New();
+  view3D->SetRefreshRate( 50 );
+
+  WidgetType::Pointer widget = WidgetType::New();
+  widget->RequestSetSize( ViewRecorderTest::FrameWidth,
+                          ViewRecorderTest::FrameHeight );
+  widget->RequestSetView( view3D );
+
+  RecorderType::Pointer recorder = RecorderType::New();
+  recorder->SetFramesPerChunk( 8 );
+  recorder->RequestSetView( view3D );
+
+  ViewRecorderTest::SetFrameNumber( view3D, 0 );
+  view3D->RequestResetCamera();
+  view3D->RequestStart();
+
+  if( !ViewRecorderTest::WaitForFrame( widget ) )
+    {
+    std::cerr << "No frame was rendered" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Record one background per refresh
+  const unsigned int numberOfBackgrounds = 20;
+  if( !recorder->StartRecording( argv[1] ) )
+    {
+    std::cerr << "Could not create " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for( unsigned int n = 0; n < numberOfBackgrounds; n++ )
+    {
+    ViewRecorderTest::SetFrameNumber( view3D, n );
+    if( !ViewRecorderTest::WaitForFrame( widget ) )
+      {
+      std::cerr << "The view stopped rendering" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  recorder->StopRecording();
+
+  // The last background is saved as a screen shot
+  if( !recorder->RequestSaveScreenShot( argv[2] ) )
+    {
+    std::cerr << "Could not request a screen shot" << std::endl;
+    result = EXIT_FAILURE;
+    }
+  ViewRecorderTest::WaitForFrame( widget );
+  recorder->WaitForPendingWrites();
+
+  view3D->RequestStop();
+
+  recorder->Print( std::cout );
+
+  if( recorder->GetNumberOfDroppedFrames() != 0 ||
+      recorder->GetNumberOfFrames() < numberOfBackgrounds )
+    {
+    std::cerr << "Recorded " << recorder->GetNumberOfFrames()
+              << " frames and dropped "
+              << recorder->GetNumberOfDroppedFrames() << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( recorder->GetNumberOfScreenShots() != 1 ||
+      recorder->GetNumberOfFailedScreenShots() != 0 )
+    {
+    std::cerr << "The screen shot was not saved" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // The screen shot is a valid PNG file of the last background
+  vtkPNGReader * pngReader = vtkPNGReader::New();
+  if( !pngReader->CanReadFile( argv[2] ) )
+    {
+    std::cerr << "Can not read " << argv[2] << std::endl;
+    result = EXIT_FAILURE;
+    }
+  else
+    {
+    pngReader->SetFileName( argv[2] );
+    pngReader->Update();
+    vtkImageData * screenShot = pngReader->GetOutput();
+    int dimensions[3];
+    screenShot->GetDimensions( dimensions );
+    if( dimensions[0] != ViewRecorderTest::FrameWidth ||
+        dimensions[1] != ViewRecorderTest::FrameHeight ||
+        screenShot->GetNumberOfScalarComponents() != 3 )
+      {
+      std::cerr << "Wrong screen shot size " << dimensions[0] << " x "
+                << dimensions[1] << " x "
+                << screenShot->GetNumberOfScalarComponents() << std::endl;
+      result = EXIT_FAILURE;
+      }
+    else if( ViewRecorderTest::GetFrameNumber( static_cast< unsigned char * >(
+               screenShot->GetScalarPointer() ) ) != numberOfBackgrounds - 1 )
+      {
+      std::cerr << "Wrong screen shot pixels" << std::endl;
+      result = EXIT_FAILURE;
+      }
+    }
+  pngReader->Delete();
+
+  // The frame index lists every recorded frame, in order
+  typedef VideoRecorderType::FrameIndexHeaderType  HeaderType;
+  typedef VideoRecorderType::FrameIndexEntryType   EntryType;
+
+  const std::string indexFileName =
+    VideoRecorderType::GetFrameIndexFileName( argv[1],
+                                              recorder->GetToolName() );
+  std::vector< EntryType > entries;
+  FILE * indexFile = fopen( indexFileName.c_str(), "rb" );
+  HeaderType header;
+  if( !indexFile || fread( &header, sizeof( header ), 1, indexFile ) != 1 )
+    {
+    std::cerr << "Can not read " << indexFileName << std::endl;
+    if( indexFile )
+      {
+      fclose( indexFile );
+      }
+    return EXIT_FAILURE;
+    }
+  EntryType entry;
+  while( fread( &entry, sizeof( entry ), 1, indexFile ) == 1 )
+    {
+    entries.push_back( entry );
+    }
+  fclose( indexFile );
+
+  if( entries.size() != recorder->GetNumberOfFrames() )
+    {
+    std::cerr << "The index lists " << entries.size() << " frames instead of "
+              << recorder->GetNumberOfFrames() << std::endl;
+    result = EXIT_FAILURE;
+    }
+  for( unsigned int i = 1; i < entries.size(); i++ )
+    {
+    if( entries[i].m_Time <= entries[i-1].m_Time )
+      {
+      std::cerr << "The frames are not in order" << std::endl;
+      result = EXIT_FAILURE;
+      break;
+      }
+    }
+
+  // Replay the frames one by one on a frozen clock
+  igstk::PlaybackClock::Pointer clock = igstk::PlaybackClock::New();
+  clock->SetPlaybackSpeed( 0.0 );
+
+  PlaybackImagerType::Pointer player = PlaybackImagerType::New();
+  player->SetDirectoryName( argv[1] );
+  player->SetPlaybackClock( clock );
+  player->RequestOpen();
+  player->RequestSetFrequency( 100.0 );
+
+  unsigned int dimensions[3];
+  if( !player->GetRecordedFrameDimensions( recorder->GetToolName(),
+                                           dimensions ) ||
+      dimensions[0] != static_cast< unsigned int >(
+                                       ViewRecorderTest::FrameWidth ) ||
+      dimensions[1] != static_cast< unsigned int >(
+                                       ViewRecorderTest::FrameHeight ) ||
+      dimensions[2] != 3 )
+    {
+    std::cerr << "The frame dimensions were not recorded" << std::endl;
+    player->RequestClose();
+    return EXIT_FAILURE;
+    }
+
+  PlaybackToolType::Pointer playbackTool = PlaybackToolType::New();
+  playbackTool->SetFrameDimensions( dimensions );
+  playbackTool->RequestSetToolName( recorder->GetToolName() );
+  playbackTool->RequestConfigure();
+  playbackTool->RequestAttachToVideoImager( player );
+
+  player->RequestStartImaging();
+
+  unsigned int numberOfReplayedFrames = 0;
+  unsigned int expectedFrameNumber = 0;
+  double lastFrameTime = 0.0;
+  if( playbackTool->GetLatestFrame() )
+    {
+    lastFrameTime = playbackTool->GetLatestFrame()->GetStartTime();
+    }
+  for( unsigned int i = 0; i < entries.size(); i++ )
+    {
+    clock->SeekToTime( entries[i].m_Time );
+
+    igstk::Frame * frame = NULL;
+    for( int j = 0; j < 100; j++ )
+      {
+      igstk::PulseGenerator::Sleep( 5 );
+      igstk::PulseGenerator::CheckTimeouts();
+      frame = playbackTool->GetLatestFrame();
+      if( frame && frame->GetStartTime() != lastFrameTime )
+        {
+        break;
+        }
+      frame = NULL;
+      }
+
+    if( !frame )
+      {
+      std::cerr << "Frame " << i << " was not replayed" << std::endl;
+      result = EXIT_FAILURE;
+      break;
+      }
+    lastFrameTime = frame->GetStartTime();
+    numberOfReplayedFrames++;
+
+    // The backgrounds come back in the order they were rendered
+    const unsigned int frameNumber = ViewRecorderTest::GetFrameNumber(
+                  static_cast< unsigned char * >( frame->GetImagePtr() ) );
+    if( frameNumber != expectedFrameNumber &&
+        ( i == 0 || frameNumber != expectedFrameNumber + 1 ) )
+      {
+      std::cerr << "Replayed background " << frameNumber << " after "
+                << expectedFrameNumber << std::endl;
+      result = EXIT_FAILURE;
+      }
+    expectedFrameNumber = frameNumber;
+    }
+
+  player->RequestStopImaging();
+  playbackTool->RequestDetachFromVideoImager();
+  player->RequestClose();
+
+  std::cout << "Replayed " << numberOfReplayedFrames << " frames"
+            << std::endl;
+
+  if( expectedFrameNumber != numberOfBackgrounds - 1 )
+    {
+    std::cerr << "The replay ended on background " << expectedFrameNumber
+              << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if( result == EXIT_SUCCESS )
+    {
+    std::cout << "[PASSED]" << std::endl;
+    }
+  return result;
+}